@@ -64,6 +64,9 @@ struct evt_options {
 	uint32_t deq_tmo_nsec;
 	uint32_t q_priority:1;
 	uint32_t fwd_latency:1;
+	uint32_t ena_vector:1;
+	uint16_t vector_size;
+	uint64_t vector_tmo_nsec;
 	uint64_t nb_pkts;
 	uint64_t nb_timers;
 	uint64_t expiry_nsec;
@@ -42,6 +42,9 @@
 #define EVT_EXPIRY_NSEC          ("expiry_nsec")
 #define EVT_MBUF_SZ              ("mbuf_sz")
 #define EVT_MAX_PKT_SZ           ("max_pkt_sz")
+#define EVT_ENA_VECTOR           ("enable_vector")
+#define EVT_VECTOR_SZ            ("vector_size")
+#define EVT_VECTOR_TMO           ("vector_tmo_ns")
 #define EVT_HELP                 ("help")
 
 void evt_options_default(struct evt_options *opt);
@@ -206,6 +209,16 @@ evt_dump_queue_priority(struct evt_options *opt)
 	evt_dump("queue_priority", "%s", EVT_BOOL_FMT(opt->q_priority));
 }
 
+static inline void
+evt_dump_vector(struct evt_options *opt)
+{
+	evt_dump("enable_vector", "%s", EVT_BOOL_FMT(opt->ena_vector));
+	if (opt->ena_vector) {
+		evt_dump("vector_size", "%d", opt->vector_size);
+		evt_dump("vector_tmo_ns", "%"PRIu64"", opt->vector_tmo_nsec);
+	}
+}
+
 static inline const char*
 evt_sched_type_2_str(uint8_t sched_type)
 {
@@ -36,6 +36,7 @@ pipeline_opt_dump(struct evt_options *opt, uint8_t nb_queues)
 	evt_dump_queue_priority(opt);
 	evt_dump_sched_type_list(opt);
 	evt_dump_producer_type(opt);
+	evt_dump_vector(opt);
 }
 
 static inline uint64_t
@@ -150,6 +151,11 @@ pipeline_opt_check(struct evt_options *opt, uint64_t nb_queues)
 	if (evt_has_invalid_sched_type(opt))
 		return -1;
 
+	if (opt->ena_vector && !opt->vector_size) {
+		evt_err("vector_size must be non zero");
+		return -1;
+	}
+
 	return 0;
 }
 
@@ -204,6 +210,12 @@ pipeline_ethdev_setup(struct evt_test *test, struct evt_options *opt)
 
 		if (!(caps & RTE_EVENT_ETH_TX_ADAPTER_CAP_INTERNAL_PORT))
 			t->internal_port = 0;
+		else if (opt->ena_vector &&
+			!(caps & RTE_EVENT_ETH_TX_ADAPTER_CAP_EVENT_VECTOR)) {
+			evt_err("event vectors not supported by tx adapter[%d]",
+					i);
+			return -ENOTSUP;
+		}
 
 		ret = rte_eth_dev_info_get(i, &dev_info);
 		if (ret != 0) {
@@ -294,9 +306,53 @@ pipeline_event_port_setup(struct evt_test *test, struct evt_options *opt,
 	return -EINVAL;
 }
 
+static int
+pipeline_event_vector_setup(struct evt_options *opt, uint16_t prod,
+		struct rte_mempool *vector_pool)
+{
+	struct rte_event_eth_rx_adapter_event_vector_config vec_conf;
+	struct rte_event_eth_rx_adapter_vector_limits limits;
+	int ret;
+
+	ret = rte_event_eth_rx_adapter_vector_limits_get(opt->dev_id, prod,
+			&limits);
+	if (ret) {
+		evt_err("failed to get vector limits of rx adapter[%d]", prod);
+		return ret;
+	}
+
+	if (opt->vector_size < limits.min_sz ||
+			opt->vector_size > limits.max_sz) {
+		evt_err("vector_size %d not within [%d, %d]",
+				opt->vector_size, limits.min_sz,
+				limits.max_sz);
+		return -EINVAL;
+	}
+
+	if (opt->vector_tmo_nsec < limits.min_timeout_ns ||
+			opt->vector_tmo_nsec > limits.max_timeout_ns) {
+		evt_err("vector_tmo_ns %"PRIu64" not within [%"PRIu64
+				", %"PRIu64"]", opt->vector_tmo_nsec,
+				limits.min_timeout_ns, limits.max_timeout_ns);
+		return -EINVAL;
+	}
+
+	memset(&vec_conf, 0, sizeof(vec_conf));
+	vec_conf.vector_sz = opt->vector_size;
+	vec_conf.vector_timeout_ns = opt->vector_tmo_nsec;
+	vec_conf.vector_mp = vector_pool;
+	ret = rte_event_eth_rx_adapter_queue_event_vector_config(prod, prod,
+			-1, &vec_conf);
+	if (ret)
+		evt_err("failed to configure vectors of rx adapter[%d]", prod);
+
+	return ret;
+}
+
 int
 pipeline_event_rx_adapter_setup(struct evt_options *opt, uint8_t stride,
-		struct rte_event_port_conf prod_conf)
+		struct rte_event_port_conf prod_conf,
+		struct rte_mempool *vector_pool)
 {
 	int ret = 0;
 	uint16_t prod;
@@ -330,6 +386,13 @@ pipeline_event_rx_adapter_setup(struct evt_options *opt, uint8_t stride,
 			return ret;
 		}
 
+		if (opt->ena_vector) {
+			ret = pipeline_event_vector_setup(opt, prod,
+					vector_pool);
+			if (ret)
+				return ret;
+		}
+
 		if (!(cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_INTERNAL_PORT)) {
 			uint32_t service_id = -1U;
 
@@ -472,6 +535,23 @@ pipeline_mempool_setup(struct evt_test *test, struct evt_options *opt)
 		return -ENOMEM;
 	}
 
+	if (opt->ena_vector) {
+		/* Vectors may be filled partially when flows are short, and
+		 * stay in the per-lcore caches.
+		 */
+		unsigned int nb_elem = RTE_MAX(512U,
+			(unsigned int)opt->pool_sz / opt->vector_size * 2);
+
+		nb_elem += rte_lcore_count() * 32 * 3 / 2;
+		t->vector_pool = rte_event_vector_pool_create("vector_pool",
+				nb_elem, 32, opt->vector_size, opt->socket_id);
+		if (t->vector_pool == NULL) {
+			evt_err("failed to create vector mempool");
+			rte_mempool_free(t->pool);
+			return -ENOMEM;
+		}
+	}
+
 	return 0;
 }
 
@@ -482,6 +562,7 @@ pipeline_mempool_destroy(struct evt_test *test, struct evt_options *opt)
 	struct test_pipeline *t = evt_test_priv(test);
 
 	rte_mempool_free(t->pool);
+	rte_mempool_free(t->vector_pool);
 }
 
 int
@@ -92,6 +92,7 @@ static struct {
 	const char	*lookup_ips_file;
 	const char	*routes_file_s;
 	const char	*lookup_ips_file_s;
+	const char	*lookup_fn;
 	void		*rt;
 	void		*lookup_tbl;
 	uint32_t	nb_routes;
@@ -106,6 +107,7 @@ static struct {
 } config = {
 	.routes_file = NULL,
 	.lookup_ips_file = NULL,
+	.lookup_fn = NULL,
 	.nb_routes = DEF_ROUTES_NUM,
 	.nb_lookup_ips = DEF_LOOKUP_IPS_NUM,
 	.nb_lookup_ips_rnd = 0,
@@ -169,6 +171,43 @@ get_fib_type(void)
 	return -1;
 }
 
+static const struct {
+	const char			*name;
+	enum rte_fib_lookup_type	type;
+} fib_lookup_types[] = {
+	{ "s1", RTE_FIB_LOOKUP_DIR24_8_SCALAR_MACRO },
+	{ "s2", RTE_FIB_LOOKUP_DIR24_8_SCALAR_INLINE },
+	{ "s3", RTE_FIB_LOOKUP_DIR24_8_SCALAR_UNI },
+	{ "v", RTE_FIB_LOOKUP_DIR24_8_VECTOR_AVX512 },
+};
+
+static const struct {
+	const char			*name;
+	enum rte_fib6_lookup_type	type;
+} fib6_lookup_types[] = {
+	{ "s", RTE_FIB6_LOOKUP_TRIE_SCALAR },
+	{ "v", RTE_FIB6_LOOKUP_TRIE_VECTOR_AVX512 },
+};
+
+static int
+get_lookup_fn_idx(void)
+{
+	unsigned int i;
+
+	if (config.flags & IPV6_FLAG) {
+		for (i = 0; i < RTE_DIM(fib6_lookup_types); i++)
+			if (strcmp(config.lookup_fn,
+					fib6_lookup_types[i].name) == 0)
+				return i;
+	} else {
+		for (i = 0; i < RTE_DIM(fib_lookup_types); i++)
+			if (strcmp(config.lookup_fn,
+					fib_lookup_types[i].name) == 0)
+				return i;
+	}
+	return -1;
+}
+
 static int
 complete_distrib(uint8_t depth_lim, const uint32_t n, uint8_t rpd[],
 	uint32_t nrpd[])
@@ -638,6 +677,17 @@ print_usage(void)
 		"[-e <entry size (valid only for dir and trie fib types): "
 		"1/2/4/8 (default 4)>]\n"
 		"[-g <number of tbl8's for dir24_8 or trie FIBs>]\n"
+		"[-v <lookup function (valid only for dir and trie fib types)>]"
+		"\n\tavailible options for ipv4:\n"
+		"\t\ts1 - scalar macro based lookup\n"
+		"\t\ts2 - scalar inlined lookup\n"
+		"\t\ts3 - scalar unified lookup\n"
+		"\t\tv - vector AVX512 lookup\n"
+		"\tavailible options for ipv6:\n"
+		"\t\ts - scalar lookup\n"
+		"\t\tv - vector AVX512 lookup\n"
+		"\tall - measure and compare all the available lookups\n"
+		"default is the fastest lookup supported by the CPU\n"
 		"[-w <path to the file to dump routing table>]\n"
 		"[-u <path to the file to dump ip's for lookup>]\n",
 		config.prgname);
@@ -673,6 +723,19 @@ check_config(void)
 		printf("-e 1 is valid only for ipv4\n");
 		return -1;
 	}
+
+	if (config.lookup_fn != NULL) {
+		if ((get_fib_type() != RTE_FIB_DIR24_8) &&
+				(get_fib_type() != RTE_FIB6_TRIE)) {
+			printf("-v is valid only for dir and trie fib types\n");
+			return -1;
+		}
+		if ((strcmp(config.lookup_fn, "all") != 0) &&
+				(get_lookup_fn_idx() < 0)) {
+			printf("wrong -v option %s\n", config.lookup_fn);
+			return -1;
+		}
+	}
 	return 0;
 }
 
@@ -682,7 +745,7 @@ parse_opts(int argc, char **argv)
 	int opt;
 	char *endptr;
 
-	while ((opt = getopt(argc, argv, "f:t:n:d:l:r:c6ab:e:g:w:u:s")) !=
+	while ((opt = getopt(argc, argv, "f:t:n:d:l:r:c6ab:e:g:w:u:sv:")) !=
 			-1) {
 		switch (opt) {
 		case 'f':
@@ -762,6 +825,9 @@ parse_opts(int argc, char **argv)
 				rte_exit(-EINVAL, "Invalid option -e\n");
 			}
 			break;
+		case 'v':
+			config.lookup_fn = optarg;
+			break;
 		case 'g':
 			errno = 0;
 			config.tbl8 = strtoul(optarg, &endptr, 10);
@@ -804,6 +870,78 @@ print_depth_err(void)
 		"-d 0:0 option or remove /0 prefix from routes file\n");
 }
 
+/*
+ * Measure the lookup rate of the current lookup function. If nh_ref is
+ * set, the next hops are stored into it, or compared with it if check
+ * is set.
+ */
+static int
+lookup_v4(struct rte_fib *fib, const char *name, uint64_t *nh_ref, int check)
+{
+	uint64_t start, acc = 0;
+	uint32_t *tbl4 = config.lookup_tbl;
+	uint64_t fib_nh[BURST_SZ];
+	uint32_t i, j;
+	int ret;
+
+	for (i = 0; i < config.nb_lookup_ips; i += BURST_SZ) {
+		start = rte_rdtsc_precise();
+		ret = rte_fib_lookup_bulk(fib, tbl4 + i, fib_nh, BURST_SZ);
+		acc += rte_rdtsc_precise() - start;
+		if (ret != 0) {
+			printf("FIB lookup fails, err %d\n", ret);
+			return -ret;
+		}
+		if (nh_ref == NULL)
+			continue;
+		for (j = 0; j < BURST_SZ; j++) {
+			if (!check)
+				nh_ref[i + j] = fib_nh[j];
+			else if (nh_ref[i + j] != fib_nh[j]) {
+				printf("FIB lookup %s returns wrong nexthop\n",
+					name);
+				return -1;
+			}
+		}
+	}
+	printf("AVG FIB lookup%s%s %.1f\n", (name != NULL) ? " " : "",
+		(name != NULL) ? name : "", (double)acc / (double)i);
+	return 0;
+}
+
+/* Measure all the supported lookup functions and compare their results */
+static int
+lookup_all_v4(struct rte_fib *fib)
+{
+	uint64_t *nh_ref;
+	unsigned int i;
+	int ret = 0, check = 0;
+
+	nh_ref = rte_malloc(NULL, sizeof(uint64_t) *
+		RTE_ALIGN_CEIL(config.nb_lookup_ips, BURST_SZ), 0);
+	if (nh_ref == NULL) {
+		printf("Can not alloc next hops table\n");
+		return -ENOMEM;
+	}
+
+	for (i = 0; i < RTE_DIM(fib_lookup_types); i++) {
+		if (rte_fib_select_lookup(fib, fib_lookup_types[i].type) != 0) {
+			printf("FIB lookup %s is not supported\n",
+				fib_lookup_types[i].name);
+			continue;
+		}
+		ret = lookup_v4(fib, fib_lookup_types[i].name, nh_ref, check);
+		if (ret != 0)
+			break;
+		check = 1;
+	}
+	if (ret == 0)
+		printf("All FIB lookup functions return same values\n");
+
+	rte_free(nh_ref);
+	return ret;
+}
+
 static int
 run_v4(void)
 {
@@ -847,6 +985,16 @@ run_v4(void)
 		return -rte_errno;
 	}
 
+	if ((config.lookup_fn != NULL) &&
+			(strcmp(config.lookup_fn, "all") != 0)) {
+		ret = rte_fib_select_lookup(fib,
+			fib_lookup_types[get_lookup_fn_idx()].type);
+		if (ret != 0) {
+			printf("Lookup function is not supported\n");
+			return -ret;
+		}
+	}
+
 	for (k = config.print_fract, i = 0; k > 0; k--) {
 		start = rte_rdtsc_precise();
 		for (j = 0; j < (config.nb_routes - i) / k; j++) {
@@ -891,17 +1039,13 @@ run_v4(void)
 		}
 	}
 
-	acc = 0;
-	for (i = 0; i < config.nb_lookup_ips; i += BURST_SZ) {
-		start = rte_rdtsc_precise();
-		ret = rte_fib_lookup_bulk(fib, tbl4 + i, fib_nh, BURST_SZ);
-		acc += rte_rdtsc_precise() - start;
-		if (ret != 0) {
-			printf("FIB lookup fails, err %d\n", ret);
-			return -ret;
-		}
-	}
-	printf("AVG FIB lookup %.1f\n", (double)acc / (double)i);
+	if ((config.lookup_fn != NULL) &&
+			(strcmp(config.lookup_fn, "all") == 0))
+		ret = lookup_all_v4(fib);
+	else
+		ret = lookup_v4(fib, NULL, NULL, 0);
+	if (ret != 0)
+		return ret;
 
 	if (config.flags & CMP_FLAG) {
 		acc = 0;
@@ -981,6 +1125,76 @@ dump_rt_6(struct rt_rule_6 *rt)
 	return 0;
 }
 
+static int
+lookup_v6(struct rte_fib6 *fib, const char *name, uint64_t *nh_ref, int check)
+{
+	uint64_t start, acc = 0;
+	uint8_t *tbl6 = config.lookup_tbl;
+	uint64_t fib_nh[BURST_SZ];
+	uint32_t i, j;
+	int ret;
+
+	for (i = 0; i < config.nb_lookup_ips; i += BURST_SZ) {
+		start = rte_rdtsc_precise();
+		ret = rte_fib6_lookup_bulk(fib, (uint8_t (*)[16])(tbl6 + i*16),
+			fib_nh, BURST_SZ);
+		acc += rte_rdtsc_precise() - start;
+		if (ret != 0) {
+			printf("FIB lookup fails, err %d\n", ret);
+			return -ret;
+		}
+		if (nh_ref == NULL)
+			continue;
+		for (j = 0; j < BURST_SZ; j++) {
+			if (!check)
+				nh_ref[i + j] = fib_nh[j];
+			else if (nh_ref[i + j] != fib_nh[j]) {
+				printf("FIB lookup %s returns wrong nexthop\n",
+					name);
+				return -1;
+			}
+		}
+	}
+	printf("AVG FIB lookup%s%s %.1f\n", (name != NULL) ? " " : "",
+		(name != NULL) ? name : "", (double)acc / (double)i);
+	return 0;
+}
+
+/* Measure all the supported lookup functions and compare their results */
+static int
+lookup_all_v6(struct rte_fib6 *fib)
+{
+	uint64_t *nh_ref;
+	unsigned int i;
+	int ret = 0, check = 0;
+
+	nh_ref = rte_malloc(NULL, sizeof(uint64_t) *
+		RTE_ALIGN_CEIL(config.nb_lookup_ips, BURST_SZ), 0);
+	if (nh_ref == NULL) {
+		printf("Can not alloc next hops table\n");
+		return -ENOMEM;
+	}
+
+	for (i = 0; i < RTE_DIM(fib6_lookup_types); i++) {
+		if (rte_fib6_select_lookup(fib,
+				fib6_lookup_types[i].type) != 0) {
+			printf("FIB lookup %s is not supported\n",
+				fib6_lookup_types[i].name);
+			continue;
+		}
+		ret = lookup_v6(fib, fib6_lookup_types[i].name, nh_ref,
+			check);
+		if (ret != 0)
+			break;
+		check = 1;
+	}
+	if (ret == 0)
+		printf("All FIB lookup functions return same values\n");
+
+	rte_free(nh_ref);
+	return ret;
+}
+
 static int
 run_v6(void)
 {
@@ -1025,6 +1239,16 @@ run_v6(void)
 		return -rte_errno;
 	}
 
+	if ((config.lookup_fn != NULL) &&
+			(strcmp(config.lookup_fn, "all") != 0)) {
+		ret = rte_fib6_select_lookup(fib,
+			fib6_lookup_types[get_lookup_fn_idx()].type);
+		if (ret != 0) {
+			printf("Lookup function is not supported\n");
+			return -ret;
+		}
+	}
+
 	for (k = config.print_fract, i = 0; k > 0; k--) {
 		start = rte_rdtsc_precise();
 		for (j = 0; j < (config.nb_routes - i) / k; j++) {
@@ -1044,6 +1268,7 @@ run_v6(void)
 		lpm_conf.max_rules = config.nb_routes * 2;
 		lpm_conf.number_tbl8s = RTE_MAX(conf.trie.num_tbl8,
 			config.tbl8);
+		lpm_conf.flags = 0;
 
 		lpm = rte_lpm6_create("test_lpm", -1, &lpm_conf);
 		if (lpm == NULL) {
@@ -1069,18 +1294,13 @@ run_v6(void)
 		}
 	}
 
-	acc = 0;
-	for (i = 0; i < config.nb_lookup_ips; i += BURST_SZ) {
-		start = rte_rdtsc_precise();
-		ret = rte_fib6_lookup_bulk(fib, (uint8_t (*)[16])(tbl6 + i*16),
-			fib_nh, BURST_SZ);
-		acc += rte_rdtsc_precise() - start;
-		if (ret != 0) {
-			printf("FIB lookup fails, err %d\n", ret);
-			return -ret;
-		}
-	}
-	printf("AVG FIB lookup %.1f\n", (double)acc / (double)i);
+	if ((config.lookup_fn != NULL) &&
+			(strcmp(config.lookup_fn, "all") == 0))
+		ret = lookup_all_v6(fib);
+	else
+		ret = lookup_v6(fib, NULL, NULL, 0);
+	if (ret != 0)
+		return ret;
 
 	if (config.flags & CMP_FLAG) {
 		acc = 0;
@@ -69,6 +69,11 @@ do_recursive_call(void)
 			{ "test_memory_flags", no_action },
 			{ "test_file_prefix", no_action },
 			{ "test_no_huge_flag", no_action },
+			{ "test_warm_restart_flag", no_action },
+			{ "test_warm_restart_prepare",
+				test_warm_restart_prepare },
+			{ "test_warm_restart_check", test_warm_restart_check },
+			{ "test_warm_restart_probe", test_warm_restart_probe },
 #ifdef RTE_LIBRTE_TIMER
 			{ "timer_secondary_spawn_wait", test_timer_secondary },
 #endif
@@ -157,6 +157,9 @@ int commands_init(void);
 
 int test_mp_secondary(void);
 int test_timer_secondary(void);
+int test_warm_restart_prepare(void);
+int test_warm_restart_check(void);
+int test_warm_restart_probe(void);
 
 int test_set_rxtx_conf(cmdline_fixed_string_t mode);
 int test_set_rxtx_anchor(cmdline_fixed_string_t type);
@@ -3,6 +3,7 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
 #include <inttypes.h>
@@ -11,6 +12,9 @@
 #include <rte_debug.h>
 #include <rte_hexdump.h>
 #include <rte_random.h>
+#include <rte_cycles.h>
+#include <rte_lcore.h>
+#include <rte_mbuf.h>
 #include <rte_byteorder.h>
 #include <rte_errno.h>
 #include <rte_bpf.h>
@@ -43,6 +47,15 @@ struct dummy_net {
 	struct rte_ipv4_hdr ip_hdr;
 };
 
+#define TEST_MBUF_HEADROOM	8
+#define TEST_MBUF_SEG_LEN	64
+
+/* packet of two segments, where the byte at offset i holds i */
+struct dummy_mbuf {
+	struct rte_mbuf mb[2];
+	uint8_t buf[2][TEST_MBUF_HEADROOM + TEST_MBUF_SEG_LEN];
+};
+
 #define	TEST_FILL_1	0xDEADBEEF
 
 #define	TEST_MUL_1	21
@@ -2458,6 +2471,284 @@ static const struct rte_bpf_xsym test_call5_xsym[] = {
 	},
 };
 
+/* load packet data, from the first segment, the second one and across */
+static const struct ebpf_insn test_ld_mbuf1_prog[] = {
+
+	{
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_X),
+		.dst_reg = EBPF_REG_6,
+		.src_reg = EBPF_REG_1,
+	},
+	{
+		.code = (BPF_LD | BPF_ABS | BPF_B),
+		.imm = 1,
+	},
+	{
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_X),
+		.dst_reg = EBPF_REG_7,
+		.src_reg = EBPF_REG_0,
+	},
+	{
+		.code = (BPF_LD | BPF_ABS | BPF_H),
+		.imm = 2,
+	},
+	{
+		.code = (EBPF_ALU64 | BPF_ADD | BPF_X),
+		.dst_reg = EBPF_REG_7,
+		.src_reg = EBPF_REG_0,
+	},
+	{
+		.code = (BPF_LD | BPF_ABS | BPF_W),
+		.imm = TEST_MBUF_SEG_LEN - 2,
+	},
+	{
+		.code = (EBPF_ALU64 | BPF_ADD | BPF_X),
+		.dst_reg = EBPF_REG_7,
+		.src_reg = EBPF_REG_0,
+	},
+	{
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_K),
+		.dst_reg = EBPF_REG_8,
+		.imm = 3,
+	},
+	{
+		.code = (BPF_LD | BPF_IND | BPF_W),
+		.src_reg = EBPF_REG_8,
+		.imm = 10,
+	},
+	{
+		.code = (EBPF_ALU64 | BPF_ADD | BPF_X),
+		.dst_reg = EBPF_REG_7,
+		.src_reg = EBPF_REG_0,
+	},
+	{
+		.code = (BPF_LD | BPF_IND | BPF_W),
+		.src_reg = EBPF_REG_8,
+		.imm = TEST_MBUF_SEG_LEN + 4,
+	},
+	{
+		.code = (EBPF_ALU64 | BPF_ADD | BPF_X),
+		.dst_reg = EBPF_REG_7,
+		.src_reg = EBPF_REG_0,
+	},
+	{
+		.code = (BPF_LD | BPF_IND | BPF_H),
+		.src_reg = EBPF_REG_8,
+		.imm = 2 * TEST_MBUF_SEG_LEN - 5,
+	},
+	{
+		.code = (EBPF_ALU64 | BPF_ADD | BPF_X),
+		.dst_reg = EBPF_REG_7,
+		.src_reg = EBPF_REG_0,
+	},
+	{
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_X),
+		.dst_reg = EBPF_REG_0,
+		.src_reg = EBPF_REG_7,
+	},
+	{
+		.code = (BPF_JMP | EBPF_EXIT),
+	},
+};
+
+static void
+test_ld_mbuf1_prepare(void *arg)
+{
+	struct dummy_mbuf *dm;
+	uint32_t i, j;
+
+	dm = arg;
+	memset(dm, 0, sizeof(*dm));
+
+	for (i = 0; i != RTE_DIM(dm->mb); i++) {
+		dm->mb[i].buf_addr = dm->buf[i];
+		dm->mb[i].buf_len = sizeof(dm->buf[i]);
+		dm->mb[i].data_off = TEST_MBUF_HEADROOM;
+		dm->mb[i].data_len = TEST_MBUF_SEG_LEN;
+		dm->mb[i].nb_segs = 1;
+		for (j = 0; j != TEST_MBUF_SEG_LEN; j++)
+			dm->buf[i][TEST_MBUF_HEADROOM + j] =
+				i * TEST_MBUF_SEG_LEN + j;
+	}
+
+	dm->mb[0].next = &dm->mb[1];
+	dm->mb[0].nb_segs = RTE_DIM(dm->mb);
+	dm->mb[0].pkt_len = RTE_DIM(dm->mb) * TEST_MBUF_SEG_LEN;
+}
+
+/* big endian value of len bytes at offset off of the test packet */
+static uint64_t
+test_ld_mbuf_val(uint32_t off, uint32_t len)
+{
+	uint32_t i;
+	uint64_t v;
+
+	v = 0;
+	for (i = 0; i != len; i++)
+		v = v << CHAR_BIT | (uint8_t)(off + i);
+	return v;
+}
+
+static int
+test_ld_mbuf1_check(uint64_t rc, const void *arg)
+{
+	uint64_t v;
+
+	RTE_SET_USED(arg);
+
+	v = test_ld_mbuf_val(1, sizeof(uint8_t)) +
+		test_ld_mbuf_val(2, sizeof(uint16_t)) +
+		test_ld_mbuf_val(TEST_MBUF_SEG_LEN - 2, sizeof(uint32_t)) +
+		test_ld_mbuf_val(13, sizeof(uint32_t)) +
+		test_ld_mbuf_val(TEST_MBUF_SEG_LEN + 7, sizeof(uint32_t)) +
+		test_ld_mbuf_val(2 * TEST_MBUF_SEG_LEN - 2, sizeof(uint16_t));
+
+	return cmp_res(__func__, v, rc, &v, &rc, sizeof(v));
+}
+
+/* load beyond the packet end, which returns 0 */
+static const struct ebpf_insn test_ld_mbuf2_prog[] = {
+
+	{
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_X),
+		.dst_reg = EBPF_REG_6,
+		.src_reg = EBPF_REG_1,
+	},
+	{
+		.code = (BPF_LD | BPF_ABS | BPF_B),
+		.imm = 2 * TEST_MBUF_SEG_LEN - 1,
+	},
+	{
+		.code = (BPF_LD | BPF_ABS | BPF_H),
+		.imm = 2 * TEST_MBUF_SEG_LEN - 1,
+	},
+	{
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_K),
+		.dst_reg = EBPF_REG_0,
+		.imm = 1,
+	},
+	{
+		.code = (BPF_JMP | EBPF_EXIT),
+	},
+};
+
+static int
+test_ld_mbuf2_check(uint64_t rc, const void *arg)
+{
+	uint64_t v;
+
+	RTE_SET_USED(arg);
+
+	v = 0;
+	return cmp_res(__func__, v, rc, &v, &rc, sizeof(v));
+}
+
+/* loop bounded by a value loaded from the input */
+static const struct ebpf_insn test_loop1_prog[] = {
+
+	[0] = {
+		.code = (BPF_LDX | BPF_MEM | BPF_W),
+		.dst_reg = EBPF_REG_2,
+		.src_reg = EBPF_REG_1,
+		.off = offsetof(struct dummy_vect8, in[0].u32),
+	},
+	[1] = {
+		.code = (EBPF_ALU64 | BPF_AND | BPF_K),
+		.dst_reg = EBPF_REG_2,
+		.imm = RTE_DIM(((struct dummy_vect8 *)NULL)->in) - 1,
+	},
+	[2] = {
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_K),
+		.dst_reg = EBPF_REG_0,
+		.imm = 0,
+	},
+	[3] = {
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_K),
+		.dst_reg = EBPF_REG_3,
+		.imm = 0,
+	},
+	[4] = {
+		.code = (BPF_JMP | BPF_JGE | BPF_X),
+		.dst_reg = EBPF_REG_3,
+		.src_reg = EBPF_REG_2,
+		.off = 8,
+	},
+	[5] = {
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_X),
+		.dst_reg = EBPF_REG_4,
+		.src_reg = EBPF_REG_3,
+	},
+	[6] = {
+		.code = (EBPF_ALU64 | BPF_MUL | BPF_K),
+		.dst_reg = EBPF_REG_4,
+		.imm = sizeof(struct dummy_offset),
+	},
+	[7] = {
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_X),
+		.dst_reg = EBPF_REG_5,
+		.src_reg = EBPF_REG_1,
+	},
+	[8] = {
+		.code = (EBPF_ALU64 | BPF_ADD | BPF_X),
+		.dst_reg = EBPF_REG_5,
+		.src_reg = EBPF_REG_4,
+	},
+	[9] = {
+		.code = (BPF_LDX | BPF_MEM | EBPF_DW),
+		.dst_reg = EBPF_REG_5,
+		.src_reg = EBPF_REG_5,
+		.off = offsetof(struct dummy_vect8, in[0].u64),
+	},
+	[10] = {
+		.code = (EBPF_ALU64 | BPF_ADD | BPF_X),
+		.dst_reg = EBPF_REG_0,
+		.src_reg = EBPF_REG_5,
+	},
+	[11] = {
+		.code = (EBPF_ALU64 | BPF_ADD | BPF_K),
+		.dst_reg = EBPF_REG_3,
+		.imm = 1,
+	},
+	[12] = {
+		.code = (BPF_JMP | BPF_JA),
+		.off = -9,
+	},
+	[13] = {
+		.code = (BPF_JMP | EBPF_EXIT),
+	},
+};
+
+static void
+test_loop1_prepare(void *arg)
+{
+	struct dummy_vect8 *dv;
+	uint32_t i;
+
+	dv = arg;
+
+	memset(dv, 0, sizeof(*dv));
+	for (i = 0; i != RTE_DIM(dv->in); i++)
+		dv->in[i].u64 = rte_rand();
+	dv->in[0].u32 = rte_rand();
+}
+
+static int
+test_loop1_check(uint64_t rc, const void *arg)
+{
+	uint32_t i, n;
+	uint64_t v;
+	const struct dummy_vect8 *dv;
+
+	dv = arg;
+
+	n = dv->in[0].u32 & (RTE_DIM(dv->in) - 1);
+	v = 0;
+	for (i = 0; i != n; i++)
+		v += dv->in[i].u64;
+
+	return cmp_res(__func__, v, rc, &v, &rc, sizeof(v));
+}
+
 static const struct bpf_test tests[] = {
 	{
 		.name = "test_store1",
@@ -2717,6 +3008,56 @@ static const struct bpf_test tests[] = {
 		/* for now don't support function calls on 32 bit platform */
 		.allow_fail = (sizeof(uint64_t) != sizeof(uintptr_t)),
 	},
+	{
+		.name = "test_ld_mbuf1",
+		.arg_sz = sizeof(struct dummy_mbuf),
+		.prm = {
+			.ins = test_ld_mbuf1_prog,
+			.nb_ins = RTE_DIM(test_ld_mbuf1_prog),
+			.prog_arg = {
+				.type = RTE_BPF_ARG_PTR_MBUF,
+				.size = sizeof(struct rte_mbuf),
+				.buf_size = TEST_MBUF_HEADROOM +
+					TEST_MBUF_SEG_LEN,
+			},
+		},
+		.prepare = test_ld_mbuf1_prepare,
+		.check_result = test_ld_mbuf1_check,
+		/* mbuf as input argument is not supported on 32 bit platform */
+		.allow_fail = (sizeof(uint64_t) != sizeof(uintptr_t)),
+	},
+	{
+		.name = "test_ld_mbuf2",
+		.arg_sz = sizeof(struct dummy_mbuf),
+		.prm = {
+			.ins = test_ld_mbuf2_prog,
+			.nb_ins = RTE_DIM(test_ld_mbuf2_prog),
+			.prog_arg = {
+				.type = RTE_BPF_ARG_PTR_MBUF,
+				.size = sizeof(struct rte_mbuf),
+				.buf_size = TEST_MBUF_HEADROOM +
+					TEST_MBUF_SEG_LEN,
+			},
+		},
+		.prepare = test_ld_mbuf1_prepare,
+		.check_result = test_ld_mbuf2_check,
+		/* mbuf as input argument is not supported on 32 bit platform */
+		.allow_fail = (sizeof(uint64_t) != sizeof(uintptr_t)),
+	},
+	{
+		.name = "test_loop1",
+		.arg_sz = sizeof(struct dummy_vect8),
+		.prm = {
+			.ins = test_loop1_prog,
+			.nb_ins = RTE_DIM(test_loop1_prog),
+			.prog_arg = {
+				.type = RTE_BPF_ARG_PTR,
+				.size = sizeof(struct dummy_vect8),
+			},
+		},
+		.prepare = test_loop1_prepare,
+		.check_result = test_loop1_check,
+	},
 };
 
 static int
@@ -2724,9 +3065,13 @@ run_test(const struct bpf_test *tst)
 {
 	int32_t ret, rv;
 	int64_t rc;
+	uint32_t n;
 	struct rte_bpf *bpf;
 	struct rte_bpf_jit jit;
 	uint8_t tbuf[tst->arg_sz];
+	uint8_t tbuf2[tst->arg_sz];
+	void *ctx[2];
+	uint64_t brc[RTE_DIM(ctx)];
 
 	printf("%s(%s) start\n", __func__, tst->name);
 
@@ -2759,11 +3104,491 @@ run_test(const struct bpf_test *tst)
 			__func__, __LINE__, tst->name, rv, strerror(ret));
 	}
 
+	if (jit.burst == NULL)
+		goto end;
+
+	/* the burst entry runs the program for each input */
+	tst->prepare(tbuf);
+	tst->prepare(tbuf2);
+	ctx[0] = tbuf;
+	ctx[1] = tbuf2;
+	n = jit.burst(ctx, brc, RTE_DIM(ctx));
+	rv = (n != RTE_DIM(ctx));
+	if (rv == 0)
+		rv = tst->check_result(brc[0], tbuf) |
+			tst->check_result(brc[1], tbuf2);
+	ret |= rv;
+	if (rv != 0) {
+		printf("%s@%d: burst check_result(%s) failed, "
+			"processed: %u;\n", __func__, __LINE__, tst->name, n);
+	}
+
+end:
 	rte_bpf_destroy(bpf);
 	return ret;
 
 }
 
+/*
+ * map test case: count the hits of the u32 key of the input, inserting
+ * the u64 value of the input on the first hit.
+ */
+#define	TEST_MAP_LD_1	3
+#define	TEST_MAP_LOOKUP	7
+#define	TEST_MAP_LD_2	11
+#define	TEST_MAP_UPDATE	17
+
+static const struct ebpf_insn test_map1_prog[] = {
+
+	[0] = {
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_X),
+		.dst_reg = EBPF_REG_6,
+		.src_reg = EBPF_REG_1,
+	},
+	[1] = {
+		.code = (BPF_LDX | BPF_MEM | BPF_W),
+		.dst_reg = EBPF_REG_2,
+		.src_reg = EBPF_REG_6,
+		.off = offsetof(struct dummy_offset, u32),
+	},
+	[2] = {
+		.code = (BPF_STX | BPF_MEM | BPF_W),
+		.dst_reg = EBPF_REG_10,
+		.src_reg = EBPF_REG_2,
+		.off = -8,
+	},
+	[TEST_MAP_LD_1] = {
+		.code = (BPF_LD | BPF_IMM | EBPF_DW),
+		.dst_reg = EBPF_REG_1,
+	},
+	[4] = {
+		.imm = 0,
+	},
+	[5] = {
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_X),
+		.dst_reg = EBPF_REG_2,
+		.src_reg = EBPF_REG_10,
+	},
+	[6] = {
+		.code = (EBPF_ALU64 | BPF_ADD | BPF_K),
+		.dst_reg = EBPF_REG_2,
+		.imm = -8,
+	},
+	[TEST_MAP_LOOKUP] = {
+		.code = (BPF_JMP | EBPF_CALL),
+	},
+	[8] = {
+		.code = (BPF_JMP | EBPF_JNE | BPF_K),
+		.dst_reg = EBPF_REG_0,
+		.off = 10,
+	},
+	[9] = {
+		.code = (BPF_LDX | BPF_MEM | EBPF_DW),
+		.dst_reg = EBPF_REG_1,
+		.src_reg = EBPF_REG_6,
+		.off = offsetof(struct dummy_offset, u64),
+	},
+	[10] = {
+		.code = (BPF_STX | BPF_MEM | EBPF_DW),
+		.dst_reg = EBPF_REG_10,
+		.src_reg = EBPF_REG_1,
+		.off = -16,
+	},
+	[TEST_MAP_LD_2] = {
+		.code = (BPF_LD | BPF_IMM | EBPF_DW),
+		.dst_reg = EBPF_REG_1,
+	},
+	[12] = {
+		.imm = 0,
+	},
+	[13] = {
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_X),
+		.dst_reg = EBPF_REG_2,
+		.src_reg = EBPF_REG_10,
+	},
+	[14] = {
+		.code = (EBPF_ALU64 | BPF_ADD | BPF_K),
+		.dst_reg = EBPF_REG_2,
+		.imm = -8,
+	},
+	[15] = {
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_X),
+		.dst_reg = EBPF_REG_3,
+		.src_reg = EBPF_REG_10,
+	},
+	[16] = {
+		.code = (EBPF_ALU64 | BPF_ADD | BPF_K),
+		.dst_reg = EBPF_REG_3,
+		.imm = -16,
+	},
+	[TEST_MAP_UPDATE] = {
+		.code = (BPF_JMP | EBPF_CALL),
+	},
+	[18] = {
+		.code = (BPF_JMP | EBPF_EXIT),
+	},
+	[19] = {
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_K),
+		.dst_reg = EBPF_REG_1,
+		.imm = 1,
+	},
+	[20] = {
+		.code = (BPF_STX | EBPF_XADD | EBPF_DW),
+		.dst_reg = EBPF_REG_0,
+		.src_reg = EBPF_REG_1,
+	},
+	[21] = {
+		.code = (BPF_LDX | BPF_MEM | EBPF_DW),
+		.dst_reg = EBPF_REG_0,
+		.src_reg = EBPF_REG_0,
+	},
+	[22] = {
+		.code = (BPF_JMP | EBPF_EXIT),
+	},
+};
+
+/* load the map test program, without the NULL check if *unchecked* */
+static struct rte_bpf *
+test_map_load(struct rte_bpf_map *map, int unchecked)
+{
+	struct ebpf_insn ins[RTE_DIM(test_map1_prog)];
+	struct rte_bpf_xsym xsym = {
+		.name = "test_map",
+		.type = RTE_BPF_XTYPE_MAP,
+		.map = {
+			.val = map,
+		},
+	};
+	struct rte_bpf_prm prm = {
+		.ins = ins,
+		.nb_ins = RTE_DIM(ins),
+		.xsym = &xsym,
+		.nb_xsym = 1,
+		.prog_arg = {
+			.type = RTE_BPF_ARG_PTR,
+			.size = sizeof(struct dummy_offset),
+		},
+	};
+
+	memcpy(ins, test_map1_prog, sizeof(ins));
+	ins[TEST_MAP_LD_1].imm = (uintptr_t)map;
+	ins[TEST_MAP_LD_1 + 1].imm = (uint64_t)(uintptr_t)map >> 32;
+	ins[TEST_MAP_LD_2].imm = ins[TEST_MAP_LD_1].imm;
+	ins[TEST_MAP_LD_2 + 1].imm = ins[TEST_MAP_LD_1 + 1].imm;
+	ins[TEST_MAP_LOOKUP].imm =
+		RTE_BPF_MAP_FUNC_IDX(&prm, RTE_BPF_MAP_FUNC_LOOKUP);
+	ins[TEST_MAP_UPDATE].imm =
+		RTE_BPF_MAP_FUNC_IDX(&prm, RTE_BPF_MAP_FUNC_UPDATE);
+
+	/* compare the looked up value with 1 instead of NULL */
+	if (unchecked)
+		ins[TEST_MAP_LOOKUP + 1].imm = 1;
+
+	return rte_bpf_load(&prm);
+}
+
+static uint64_t
+test_map_exec(const struct rte_bpf *bpf, uint32_t key, uint64_t val,
+	int use_jit)
+{
+	struct dummy_offset dv = {
+		.u32 = key,
+		.u64 = val,
+	};
+	struct rte_bpf_jit jit;
+
+	if (!use_jit)
+		return rte_bpf_exec(bpf, &dv);
+
+	rte_bpf_get_jit(bpf, &jit);
+	return jit.func(&dv);
+}
+
+static int
+test_map_type(enum rte_bpf_map_type type, int use_jit)
+{
+	static const char * const names[] = {
+		[RTE_BPF_MAP_TYPE_HASH] = "hash",
+		[RTE_BPF_MAP_TYPE_ARRAY] = "array",
+		[RTE_BPF_MAP_TYPE_LCORE_ARRAY] = "lcore array",
+	};
+	struct rte_bpf_map_prm mprm = {
+		.name = "test_bpf_map",
+		.type = type,
+		.key_size = sizeof(uint32_t),
+		.value_size = sizeof(uint64_t),
+		.max_entries = 16,
+		.socket_id = SOCKET_ID_ANY,
+	};
+	const uint32_t key = 7;
+	const uint32_t bad_key = 100;
+	const uint64_t val = TEST_FILL_1;
+	struct rte_bpf_jit jit;
+	struct rte_bpf_map *map;
+	struct rte_bpf *bpf;
+	uint64_t *pv, exp, rc;
+	int ret = -1;
+
+	printf("%s(%s, jit=%d) start\n", __func__, names[type], use_jit);
+
+	map = rte_bpf_map_create(&mprm);
+	if (map == NULL) {
+		printf("%s@%d: failed to create map, error=%d(%s);\n",
+			__func__, __LINE__, rte_errno, strerror(rte_errno));
+		return -1;
+	}
+
+	bpf = test_map_load(map, 1);
+	if (bpf != NULL || rte_errno != EINVAL) {
+		printf("%s@%d: map value used without NULL check;\n",
+			__func__, __LINE__);
+		goto fail;
+	}
+
+	bpf = test_map_load(map, 0);
+	if (bpf == NULL) {
+		printf("%s@%d: failed to load bpf code, error=%d(%s);\n",
+			__func__, __LINE__, rte_errno, strerror(rte_errno));
+		goto fail;
+	}
+
+	rte_bpf_get_jit(bpf, &jit);
+	if (use_jit && jit.func == NULL) {
+		ret = 0;
+		goto fail;
+	}
+
+	/* the first hit inserts the value in a hash map */
+	exp = (type == RTE_BPF_MAP_TYPE_HASH) ? 0 : 1;
+	rc = test_map_exec(bpf, key, val, use_jit);
+	if (rc != exp) {
+		printf("%s@%d: first hit returned %" PRIu64 ";\n",
+			__func__, __LINE__, rc);
+		goto fail;
+	}
+
+	exp = (type == RTE_BPF_MAP_TYPE_HASH) ? val + 1 : 2;
+	rc = test_map_exec(bpf, key, val, use_jit);
+	pv = rte_bpf_map_lookup(map, &key);
+	if (rc != exp || pv == NULL || *pv != exp) {
+		printf("%s@%d: second hit returned %" PRIu64 ";\n",
+			__func__, __LINE__, rc);
+		goto fail;
+	}
+
+	if (type == RTE_BPF_MAP_TYPE_HASH) {
+		/* a deleted key is inserted again */
+		if (rte_bpf_map_delete(map, &key) != 0 ||
+				rte_bpf_map_lookup(map, &key) != NULL ||
+				test_map_exec(bpf, key, val, use_jit) != 0) {
+			printf("%s@%d: delete failed;\n", __func__, __LINE__);
+			goto fail;
+		}
+	} else {
+		/* out of range keys are not found */
+		rc = test_map_exec(bpf, bad_key, val, use_jit);
+		if (rc != (uint64_t)-ENOENT ||
+				rte_bpf_map_delete(map, &key) != -ENOTSUP) {
+			printf("%s@%d: out of range key returned %" PRIx64
+				";\n", __func__, __LINE__, rc);
+			goto fail;
+		}
+	}
+
+	/* the other lcores have their own values */
+	if (type == RTE_BPF_MAP_TYPE_LCORE_ARRAY) {
+		pv = rte_bpf_map_lookup_lcore(map, &key,
+			(rte_lcore_id() + 1) % RTE_MAX_LCORE);
+		if (pv == NULL || *pv != 0) {
+			printf("%s@%d: value shared by lcores;\n",
+				__func__, __LINE__);
+			goto fail;
+		}
+	}
+
+	ret = 0;
+fail:
+	rte_bpf_destroy(bpf);
+	rte_bpf_map_destroy(map);
+	return ret;
+}
+
+static int
+test_map(void)
+{
+	int32_t rc;
+	uint32_t i;
+
+	/* for now don't support function calls on 32 bit platform */
+	if (sizeof(uint64_t) != sizeof(uintptr_t))
+		return 0;
+
+	rc = 0;
+	for (i = RTE_BPF_MAP_TYPE_HASH; i <= RTE_BPF_MAP_TYPE_LCORE_ARRAY;
+			i++) {
+		rc |= test_map_type(i, 0);
+		rc |= test_map_type(i, 1);
+	}
+
+	return rc;
+}
+
+/* loop waiting for a value, which never changes */
+static const struct ebpf_insn test_loop2_prog[] = {
+	{
+		.code = (BPF_LDX | BPF_MEM | BPF_W),
+		.dst_reg = EBPF_REG_0,
+		.src_reg = EBPF_REG_1,
+		.off = offsetof(struct dummy_offset, u32),
+	},
+	{
+		.code = (BPF_JMP | EBPF_JNE | BPF_K),
+		.dst_reg = EBPF_REG_0,
+		.imm = 0,
+		.off = -1,
+	},
+	{
+		.code = (BPF_JMP | EBPF_EXIT),
+	},
+};
+
+/* loop counting until the counter wraps around */
+static const struct ebpf_insn test_loop3_prog[] = {
+	{
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_K),
+		.dst_reg = EBPF_REG_0,
+		.imm = 0,
+	},
+	{
+		.code = (EBPF_ALU64 | BPF_ADD | BPF_K),
+		.dst_reg = EBPF_REG_0,
+		.imm = 1,
+	},
+	{
+		.code = (BPF_JMP | EBPF_JNE | BPF_K),
+		.dst_reg = EBPF_REG_0,
+		.imm = 0,
+		.off = -2,
+	},
+	{
+		.code = (BPF_JMP | EBPF_EXIT),
+	},
+};
+
+/* number of branches in the long program, 2^N paths through it */
+#define TEST_LOOP_NB_JCC	2048
+
+/*
+ * long program, each branch clears the result when a bit of the input
+ * is not set: the paths join after each of them.
+ */
+static struct ebpf_insn *
+test_loop_long_prog(uint32_t *nb_ins)
+{
+	uint32_t i, n;
+	struct ebpf_insn *ins;
+
+	n = 2 * TEST_LOOP_NB_JCC + 3;
+	ins = calloc(n, sizeof(ins[0]));
+	if (ins == NULL)
+		return NULL;
+
+	ins[0].code = (BPF_LDX | BPF_MEM | BPF_W);
+	ins[0].dst_reg = EBPF_REG_2;
+	ins[0].src_reg = EBPF_REG_1;
+	ins[0].off = offsetof(struct dummy_offset, u32);
+	ins[1].code = (EBPF_ALU64 | EBPF_MOV | BPF_K);
+	ins[1].dst_reg = EBPF_REG_0;
+	ins[1].imm = 1;
+
+	for (i = 0; i != TEST_LOOP_NB_JCC; i++) {
+		ins[2 * i + 2].code = (BPF_JMP | BPF_JSET | BPF_K);
+		ins[2 * i + 2].dst_reg = EBPF_REG_2;
+		ins[2 * i + 2].imm = 1 << (i % 31);
+		ins[2 * i + 2].off = 1;
+		ins[2 * i + 3].code = (EBPF_ALU64 | EBPF_MOV | BPF_K);
+		ins[2 * i + 3].dst_reg = EBPF_REG_0;
+		ins[2 * i + 3].imm = 0;
+	}
+
+	ins[n - 1].code = (BPF_JMP | EBPF_EXIT);
+
+	*nb_ins = n;
+	return ins;
+}
+
+static int
+test_loop(void)
+{
+	struct dummy_offset dv;
+	struct rte_bpf_prm prm = {
+		.prog_arg = {
+			.type = RTE_BPF_ARG_PTR,
+			.size = sizeof(struct dummy_offset),
+		},
+	};
+	struct ebpf_insn *ins;
+	struct rte_bpf *bpf;
+	uint64_t tsc;
+	int ret;
+
+	printf("%s start\n", __func__);
+
+	prm.ins = test_loop2_prog;
+	prm.nb_ins = RTE_DIM(test_loop2_prog);
+	bpf = rte_bpf_load(&prm);
+	if (bpf != NULL || rte_errno != EINVAL) {
+		printf("%s@%d: infinite loop not rejected;\n",
+			__func__, __LINE__);
+		rte_bpf_destroy(bpf);
+		return -1;
+	}
+
+	prm.ins = test_loop3_prog;
+	prm.nb_ins = RTE_DIM(test_loop3_prog);
+	bpf = rte_bpf_load(&prm);
+	if (bpf != NULL || rte_errno != EINVAL) {
+		printf("%s@%d: unbounded loop not rejected;\n",
+			__func__, __LINE__);
+		rte_bpf_destroy(bpf);
+		return -1;
+	}
+
+	ins = test_loop_long_prog(&prm.nb_ins);
+	if (ins == NULL)
+		return -1;
+
+	prm.ins = ins;
+	tsc = rte_rdtsc();
+	bpf = rte_bpf_load(&prm);
+	tsc = rte_rdtsc() - tsc;
+	free(ins);
+
+	if (bpf == NULL) {
+		printf("%s@%d: failed to load bpf code, error=%d(%s);\n",
+			__func__, __LINE__, rte_errno, strerror(rte_errno));
+		return -1;
+	}
+
+	printf("%s: %u instructions loaded in %" PRIu64 " cycles\n",
+		__func__, prm.nb_ins, tsc);
+
+	ret = 0;
+	memset(&dv, 0, sizeof(dv));
+	dv.u32 = INT32_MAX;
+	if (rte_bpf_exec(bpf, &dv) != 1)
+		ret = -1;
+	dv.u32 = INT32_MAX - 1;
+	if (rte_bpf_exec(bpf, &dv) != 0)
+		ret = -1;
+	if (ret != 0)
+		printf("%s@%d: long program returned wrong value;\n",
+			__func__, __LINE__);
+
+	rte_bpf_destroy(bpf);
+	return ret;
+}
+
 static int
 test_bpf(void)
 {
@@ -2777,6 +3602,9 @@ test_bpf(void)
 			rc |= rv;
 	}
 
+	rc |= test_map();
+	rc |= test_loop();
+
 	return rc;
 }
 
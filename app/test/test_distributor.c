@@ -510,6 +510,60 @@ test_flush_with_worker_shutdown(struct worker_params *wp,
 	return 0;
 }
 
+/*
+ * Send the packets of a single flow to a single worker, several times the
+ * size of the return queue of the worker, and check that they all come
+ * back once, in the order they were sent.
+ */
+#define RETURN_ORDER_PKTS 512
+
+static int
+test_return_order(struct worker_params *wp, struct rte_mempool *p)
+{
+	struct rte_distributor *d = wp->dist;
+	struct rte_mbuf *bufs[RETURN_ORDER_PKTS];
+	struct rte_mbuf *returns[RETURN_ORDER_PKTS];
+	unsigned int i, count = 0, retries = 0;
+
+	printf("=== Return order test ===\n");
+	clear_packet_count();
+	if (rte_mempool_get_bulk(p, (void *)bufs, RETURN_ORDER_PKTS) != 0) {
+		printf("line %d: Error getting mbufs from pool\n", __LINE__);
+		return -1;
+	}
+	for (i = 0; i < RETURN_ORDER_PKTS; i++)
+		bufs[i]->hash.usr = 1;
+
+	/* gather the returns as we go not to overflow the returns array */
+	for (i = 0; i < RETURN_ORDER_PKTS; i += BURST) {
+		rte_distributor_process(d, &bufs[i], BURST);
+		count += rte_distributor_returned_pkts(d, &returns[count],
+				RETURN_ORDER_PKTS - count);
+	}
+	while (count < RETURN_ORDER_PKTS && retries++ < 100) {
+		rte_distributor_flush(d);
+		count += rte_distributor_returned_pkts(d, &returns[count],
+				RETURN_ORDER_PKTS - count);
+	}
+	rte_mempool_put_bulk(p, (void *)bufs, RETURN_ORDER_PKTS);
+
+	if (count != RETURN_ORDER_PKTS) {
+		printf("line %d: Error, expected %u returned packets, got %u\n",
+				__LINE__, RETURN_ORDER_PKTS, count);
+		return -1;
+	}
+	for (i = 0; i < RETURN_ORDER_PKTS; i++) {
+		if (returns[i] != bufs[i]) {
+			printf("line %d: Error, packet %u out of order\n",
+					__LINE__, i);
+			return -1;
+		}
+	}
+
+	printf("Return order test passed\n\n");
+	return 0;
+}
+
 static
 int test_error_distributor_create_name(void)
 {
@@ -594,6 +648,7 @@ test_distributor(void)
 	static struct rte_distributor *ds;
 	static struct rte_distributor *db;
 	static struct rte_distributor *dist[2];
+	static struct rte_distributor *dr;
 	static struct rte_mempool *p;
 	int i;
 
@@ -629,6 +684,18 @@ test_distributor(void)
 		rte_distributor_clear_returns(ds);
 	}
 
+	if (dr == NULL) {
+		dr = rte_distributor_create("Test_dist_return",
+				rte_socket_id(), 1, RTE_DIST_ALG_BURST);
+		if (dr == NULL) {
+			printf("Error creating return order distributor\n");
+			return -1;
+		}
+	} else {
+		rte_distributor_flush(dr);
+		rte_distributor_clear_returns(dr);
+	}
+
 	const unsigned nb_bufs = (511 * rte_lcore_count()) < BIG_BATCH ?
 			(BIG_BATCH * 2) - 1 : (511 * rte_lcore_count());
 	if (p == NULL) {
@@ -688,6 +755,15 @@ test_distributor(void)
 
 	}
 
+	/* one burst mode worker, so that the returns keep the flow order */
+	worker_params.dist = dr;
+	strlcpy(worker_params.name, "return", sizeof(worker_params.name));
+	rte_eal_remote_launch(handle_work, &worker_params,
+			rte_get_next_lcore(-1, 1, 0));
+	if (test_return_order(&worker_params, p) < 0)
+		goto err;
+	quit_workers(&worker_params, p);
+
 	if (test_error_distributor_create_numworkers() == -1 ||
 			test_error_distributor_create_name() == -1) {
 		printf("rte_distributor_create parameter check tests failed");
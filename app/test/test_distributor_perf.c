@@ -10,11 +10,14 @@
 #include <rte_cycles.h>
 #include <rte_common.h>
 #include <rte_mbuf.h>
+#include <rte_memzone.h>
 #include <rte_distributor.h>
 #include <rte_pause.h>
 
 #define ITER_POWER_CL 25 /* log 2 of how many iterations  for Cache Line test */
 #define ITER_POWER 21 /* log 2 of how many iterations we do when timing. */
+#define ITER_POWER_SCALE 18 /* log 2 of iterations for each scaling step */
+#define MAX_SCALE_WORKERS 32
 #define BURST 64
 #define BIG_BATCH 1024
 
@@ -135,7 +138,9 @@ handle_work(void *arg)
  * threads and finally how long per packet the processing took.
  */
 static inline int
-perf_test(struct rte_distributor *d, struct rte_mempool *p)
+perf_test(struct rte_distributor *d, struct rte_mempool *p,
+		unsigned int num_workers, unsigned int iter_power,
+		uint64_t *cycles_per_pkt)
 {
 	unsigned int i;
 	uint64_t start, end;
@@ -151,23 +156,25 @@ perf_test(struct rte_distributor *d, struct rte_mempool *p)
 		bufs[i]->hash.usr = i;
 
 	start = rte_rdtsc();
-	for (i = 0; i < (1<<ITER_POWER); i++)
+	for (i = 0; i < (1U << iter_power); i++)
 		rte_distributor_process(d, bufs, BURST);
 	end = rte_rdtsc();
 
 	do {
 		usleep(100);
 		rte_distributor_process(d, NULL, 0);
-	} while (total_packet_count() < (BURST << ITER_POWER));
+	} while (total_packet_count() < ((unsigned int)BURST << iter_power));
 
 	rte_distributor_clear_returns(d);
 
-	printf("Time per burst:  %"PRIu64"\n", (end - start) >> ITER_POWER);
+	printf("Time per burst:  %"PRIu64"\n", (end - start) >> iter_power);
 	printf("Time per packet: %"PRIu64"\n\n",
-			((end - start) >> ITER_POWER)/BURST);
+			((end - start) >> iter_power)/BURST);
+	if (cycles_per_pkt != NULL)
+		*cycles_per_pkt = ((end - start) >> iter_power) / BURST;
 	rte_mempool_put_bulk(p, (void *)bufs, BURST);
 
-	for (i = 0; i < rte_lcore_count() - 1; i++)
+	for (i = 0; i < num_workers; i++)
 		printf("Worker %u handled %u packets\n", i,
 				worker_stats[i].handled_packets);
 	printf("Total packets: %u (%x)\n", total_packet_count(),
@@ -179,9 +186,9 @@ perf_test(struct rte_distributor *d, struct rte_mempool *p)
 
 /* Useful function which ensures that all worker functions terminate */
 static void
-quit_workers(struct rte_distributor *d, struct rte_mempool *p)
+quit_workers(struct rte_distributor *d, struct rte_mempool *p,
+		unsigned int num_workers)
 {
-	const unsigned int num_workers = rte_lcore_count() - 1;
 	unsigned int i;
 	struct rte_mbuf *bufs[RTE_MAX_LCORE];
 
@@ -200,6 +207,73 @@ quit_workers(struct rte_distributor *d, struct rte_mempool *p)
 	worker_idx = 0;
 }
 
+/* Launch the worker function on the first num_workers slave lcores */
+static void
+launch_workers(struct rte_distributor *d, unsigned int num_workers)
+{
+	unsigned int lcore_id, n = 0;
+
+	RTE_LCORE_FOREACH_SLAVE(lcore_id) {
+		if (n++ == num_workers)
+			break;
+		rte_eal_remote_launch(handle_work, d, lcore_id);
+	}
+}
+
+/* Double the number of workers, ending with max_workers */
+static unsigned int
+next_scale_step(unsigned int n, unsigned int max_workers)
+{
+	if (n == max_workers)
+		return max_workers + 1;
+	return RTE_MIN(n * 2, max_workers);
+}
+
+/*
+ * Time the burst mode distributor with 1, 2, 4... workers up to
+ * MAX_SCALE_WORKERS, or as many as there are slave lcores, to check that
+ * the distributor lcore keeps up when workers are added.
+ */
+static int
+perf_test_scaling(struct rte_mempool *p)
+{
+	static struct rte_distributor *ds[MAX_SCALE_WORKERS + 1];
+	uint64_t cycles[MAX_SCALE_WORKERS + 1];
+	const unsigned int max_workers = RTE_MIN(rte_lcore_count() - 1,
+			(unsigned int)MAX_SCALE_WORKERS);
+	char name[RTE_MEMZONE_NAMESIZE];
+	unsigned int n;
+
+	for (n = 1; n <= max_workers; n = next_scale_step(n, max_workers)) {
+		if (ds[n] == NULL) {
+			snprintf(name, sizeof(name), "Test_scale_%u", n);
+			ds[n] = rte_distributor_create(name, rte_socket_id(),
+					n, RTE_DIST_ALG_BURST);
+			if (ds[n] == NULL) {
+				printf("Error creating burst distributor\n");
+				return -1;
+			}
+		} else {
+			rte_distributor_clear_returns(ds[n]);
+		}
+
+		printf("=== Performance test of distributor "
+				"(burst mode, %u workers) ===\n", n);
+		launch_workers(ds[n], n);
+		if (perf_test(ds[n], p, n, ITER_POWER_SCALE, &cycles[n]) < 0)
+			return -1;
+		quit_workers(ds[n], p, n);
+	}
+
+	printf("=== Distributor scaling (burst mode) ===\n");
+	printf("Workers  Time per packet\n");
+	for (n = 1; n <= max_workers; n = next_scale_step(n, max_workers))
+		printf("%-8u %"PRIu64"\n", n, cycles[n]);
+	printf("\n");
+
+	return 0;
+}
+
 static int
 test_distributor_perf(void)
 {
@@ -252,17 +326,17 @@ test_distributor_perf(void)
 
 	printf("=== Performance test of distributor (single mode) ===\n");
 	rte_eal_mp_remote_launch(handle_work, ds, SKIP_MASTER);
-	if (perf_test(ds, p) < 0)
+	if (perf_test(ds, p, rte_lcore_count() - 1, ITER_POWER, NULL) < 0)
 		return -1;
-	quit_workers(ds, p);
+	quit_workers(ds, p, rte_lcore_count() - 1);
 
 	printf("=== Performance test of distributor (burst mode) ===\n");
 	rte_eal_mp_remote_launch(handle_work, db, SKIP_MASTER);
-	if (perf_test(db, p) < 0)
+	if (perf_test(db, p, rte_lcore_count() - 1, ITER_POWER, NULL) < 0)
 		return -1;
-	quit_workers(db, p);
+	quit_workers(db, p, rte_lcore_count() - 1);
 
-	return 0;
+	return perf_test_scaling(p);
 }
 
 REGISTER_TEST_COMMAND(distributor_perf_autotest, test_distributor_perf);
@@ -21,6 +21,8 @@
 
 #include <rte_lcore.h>
 #include <rte_debug.h>
+#include <rte_memzone.h>
+#include <rte_ethdev_driver.h>
 #include <rte_string_fns.h>
 
 #include "process.h"
@@ -35,6 +37,11 @@
 #define memtest "memtest"
 #define memtest1 "memtest1"
 #define memtest2 "memtest2"
+#define warmrestart "warmrestart"
+#define WARM_RESTART_MZ "warm_restart_mz"
+#define WARM_RESTART_PORT "net_warm_restart"
+#define WARM_RESTART_MAGIC 0x5741524d52535452ULL
+#define WARM_RESTART_MTU 1234
 #define SOCKET_MEM_STRLEN (RTE_MAX_NUMA_NODES * 20)
 #define launch_proc(ARGV) process_dup(ARGV, RTE_DIM(ARGV), __func__)
 
@@ -766,6 +773,8 @@ test_no_huge_flag(void)
 	/* With --no-huge, -m and --socket-mem */
 	const char *argv4[] = {prgname, prefix, no_huge,
 			"-m", DEFAULT_MEM_SIZE, "--socket-mem=" DEFAULT_MEM_SIZE};
+	/* With --no-huge and --warm-restart */
+	const char *argv5[] = {prgname, prefix, no_huge, "--warm-restart"};
 	if (launch_proc(argv1) != 0) {
 		printf("Error - process did not run ok with --no-huge flag\n");
 		return -1;
@@ -789,6 +798,11 @@ test_no_huge_flag(void)
 				"--socket-mem flags\n");
 		return -1;
 	}
+	if (launch_proc(argv5) == 0) {
+		printf("Error - process run ok with --no-huge and "
+				"--warm-restart flags\n");
+		return -1;
+	}
 	return 0;
 }
 
@@ -1454,6 +1468,184 @@ test_memory_flags(void)
 	return 0;
 }
 
+/* left in a memzone by the first primary process of the warm restart test */
+struct warm_restart_data {
+	uint64_t magic;
+	uint16_t port_id;
+};
+
+/*
+ * Run in the first primary process of the warm restart test, leave a memzone
+ * and a port behind.
+ */
+int
+test_warm_restart_prepare(void)
+{
+	const struct rte_memzone *mz;
+	struct warm_restart_data *wr;
+	struct rte_eth_dev *eth_dev;
+
+	mz = rte_memzone_reserve(WARM_RESTART_MZ, sizeof(*wr),
+			SOCKET_ID_ANY, 0);
+	if (mz == NULL) {
+		printf("Error - cannot reserve memzone\n");
+		return -1;
+	}
+	wr = mz->addr;
+
+	eth_dev = rte_eth_dev_allocate(WARM_RESTART_PORT);
+	if (eth_dev == NULL) {
+		printf("Error - cannot allocate port\n");
+		return -1;
+	}
+	eth_dev->data->mtu = WARM_RESTART_MTU;
+
+	wr->magic = WARM_RESTART_MAGIC;
+	wr->port_id = eth_dev->data->port_id;
+
+	return 0;
+}
+
+/* Find the memzone of the first process in a warm restarted one */
+static const struct warm_restart_data *
+warm_restart_lookup(void)
+{
+	const struct warm_restart_data *wr;
+	const struct rte_memzone *mz;
+
+	if (!rte_eal_warm_restarted()) {
+		printf("Error - process was not warm restarted\n");
+		return NULL;
+	}
+
+	mz = rte_memzone_lookup(WARM_RESTART_MZ);
+	if (mz == NULL) {
+		printf("Error - memzone not found after warm restart\n");
+		return NULL;
+	}
+	wr = mz->addr;
+	if (wr->magic != WARM_RESTART_MAGIC) {
+		printf("Error - memzone content lost after warm restart\n");
+		return NULL;
+	}
+
+	return wr;
+}
+
+/*
+ * Run in a warm restarted primary process, check the memzone and the port
+ * data left by the first one are found again.
+ */
+int
+test_warm_restart_check(void)
+{
+	const struct warm_restart_data *wr;
+	struct rte_eth_dev *eth_dev;
+
+	wr = warm_restart_lookup();
+	if (wr == NULL)
+		return -1;
+
+	eth_dev = rte_eth_dev_attach_secondary(WARM_RESTART_PORT);
+	if (eth_dev == NULL) {
+		printf("Error - port not found after warm restart\n");
+		return -1;
+	}
+	if (eth_dev->data->port_id != wr->port_id ||
+			eth_dev->data->mtu != WARM_RESTART_MTU) {
+		printf("Error - port data lost after warm restart\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * Run in a warm restarted primary process, check a port allocated again
+ * with the same name, as by a driver probe, gets back its id.
+ */
+int
+test_warm_restart_probe(void)
+{
+	const struct warm_restart_data *wr;
+	struct rte_eth_dev *eth_dev;
+
+	wr = warm_restart_lookup();
+	if (wr == NULL)
+		return -1;
+
+	eth_dev = rte_eth_dev_allocate(WARM_RESTART_PORT);
+	if (eth_dev == NULL || eth_dev->data->port_id != wr->port_id) {
+		printf("Error - port id not kept after warm restart\n");
+		return -1;
+	}
+	if (eth_dev->data->mtu != RTE_ETHER_MTU) {
+		printf("Error - port not reset after warm restart\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * Test that a primary process started with --warm-restart finds the memzones
+ * and the ethdev data of the previous primary process with the same prefix,
+ * and that one started without it does not.
+ */
+static int
+test_warm_restart_flag(void)
+{
+#ifdef RTE_EXEC_ENV_FREEBSD
+	/* BSD target doesn't support prefixes and warm restart */
+	return 0;
+#else
+	const char *argv0[] = {prgname, "-m", DEFAULT_MEM_SIZE,
+			"--file-prefix=" warmrestart};
+	const char *argv1[] = {prgname, "-m", DEFAULT_MEM_SIZE,
+			"--file-prefix=" warmrestart, "--warm-restart"};
+	int ret = 0;
+
+	/* drop what a previous run may have left, then keep the memory */
+	if (launch_proc(argv0) != 0 || process_dup(argv1, RTE_DIM(argv1),
+			"test_warm_restart_prepare") != 0) {
+		printf("Error - first primary process failed\n");
+		return -1;
+	}
+	if (process_hugefiles(warmrestart, HUGEPAGE_CHECK_EXISTS) != 1) {
+		printf("Error - hugepage files of first primary not found\n");
+		return -1;
+	}
+
+	/* restart, twice to check the restored memory can be kept again */
+	if (process_dup(argv1, RTE_DIM(argv1),
+			"test_warm_restart_check") != 0 ||
+			process_dup(argv1, RTE_DIM(argv1),
+			"test_warm_restart_check") != 0) {
+		printf("Error - memory not kept by --warm-restart\n");
+		ret = -1;
+	}
+	if (ret == 0 && process_dup(argv1, RTE_DIM(argv1),
+			"test_warm_restart_probe") != 0) {
+		printf("Error - port not taken back after --warm-restart\n");
+		ret = -1;
+	}
+
+	/* without the option, the memory is not restored */
+	if (ret == 0 && process_dup(argv0, RTE_DIM(argv0),
+			"test_warm_restart_check") == 0) {
+		printf("Error - memory kept without --warm-restart\n");
+		ret = -1;
+	}
+
+	if (process_hugefiles(warmrestart, HUGEPAGE_DELETE) < 0) {
+		printf("Error - cannot delete hugepage files\n");
+		return -1;
+	}
+
+	return ret;
+#endif
+}
+
 static int
 test_eal_flags(void)
 {
@@ -1526,6 +1718,12 @@ test_eal_flags(void)
 		return ret;
 	}
 
+	ret = test_warm_restart_flag();
+	if (ret < 0) {
+		printf("Error in test_warm_restart_flag()\n");
+		return ret;
+	}
+
 	ret = test_misc_flags();
 	if (ret < 0) {
 		printf("Error in test_misc_flags()");
@@ -1550,3 +1748,4 @@ REGISTER_TEST_COMMAND(eal_flags_r_opt_autotest, test_invalid_r_flag);
 REGISTER_TEST_COMMAND(eal_flags_mem_autotest, test_memory_flags);
 REGISTER_TEST_COMMAND(eal_flags_file_prefix_autotest, test_file_prefix);
 REGISTER_TEST_COMMAND(eal_flags_misc_autotest, test_misc_flags);
+REGISTER_TEST_COMMAND(eal_flags_warm_restart_autotest, test_warm_restart_flag);
@@ -9,6 +9,9 @@
 #include <rte_random.h>
 #include <rte_debug.h>
 #include <rte_ip.h>
+#include <rte_lcore.h>
+#include <rte_launch.h>
+#include <rte_pause.h>
 
 #include "test.h"
 
@@ -386,6 +389,262 @@ static int test_average_table_utilization(void)
 	return 0;
 }
 
+#define BULK_NUM_KEYS (1 << 16)
+#define BULK_NUM_SHARDS 4
+
+static uint64_t bulk_keys[BULK_NUM_KEYS];
+static const void *bulk_key_ptrs[BULK_NUM_KEYS];
+static efd_value_t bulk_data[BULK_NUM_KEYS];
+static int bulk_status[BULK_NUM_KEYS];
+
+static int
+check_bulk_keys(const struct rte_efd_table *handle)
+{
+	efd_value_t result[RTE_EFD_BURST_MAX];
+	unsigned int i, j;
+
+	for (i = 0; i < BULK_NUM_KEYS; i += RTE_EFD_BURST_MAX) {
+		rte_efd_lookup_bulk(handle, test_socket_id, RTE_EFD_BURST_MAX,
+				&bulk_key_ptrs[i], result);
+		for (j = 0; j < RTE_EFD_BURST_MAX; j++)
+			TEST_ASSERT_EQUAL(result[j], bulk_data[i + j],
+				"bulk: key %u has value %u instead of %u",
+				i + j, result[j], bulk_data[i + j]);
+		TEST_ASSERT_EQUAL(rte_efd_lookup(handle, test_socket_id,
+				bulk_key_ptrs[i]), bulk_data[i],
+				"key %u has a wrong value", i);
+	}
+	return 0;
+}
+
+/*
+ * Sequence of bulk operations:
+ *      - add keys (bulk)
+ *      - lookup keys: hit
+ *      - update half of the keys, one of them twice (bulk)
+ *      - lookup keys: hit (updated data)
+ *      - delete keys, lookup remaining keys: hit
+ *      - add keys in a new table, one shard at a time
+ *      - lookup keys: hit
+ */
+static int test_bulk_update(void)
+{
+	struct rte_efd_table *handle;
+	efd_value_t prev_value, saved_value;
+	unsigned int i, shard;
+	int ret;
+
+	printf("Entering %s\n", __func__);
+
+	handle = rte_efd_create("test_bulk_update", BULK_NUM_KEYS,
+			sizeof(uint64_t), efd_get_all_sockets_bitmask(),
+			test_socket_id);
+	TEST_ASSERT_NOT_NULL(handle, "Error creating the efd table\n");
+
+	for (i = 0; i < BULK_NUM_KEYS; i++) {
+		bulk_keys[i] = i;
+		bulk_key_ptrs[i] = &bulk_keys[i];
+		bulk_data[i] = rte_rand() & VALUE_BITMASK;
+	}
+
+	ret = rte_efd_update_bulk(handle, test_socket_id, BULK_NUM_KEYS,
+			bulk_key_ptrs, bulk_data, bulk_status);
+	TEST_ASSERT_EQUAL(ret, 0, "bulk update failed for %d keys", ret);
+	for (i = 0; i < BULK_NUM_KEYS; i++)
+		TEST_ASSERT(bulk_status[i] != RTE_EFD_UPDATE_FAILED,
+				"bulk update failed for key %u", i);
+	if (check_bulk_keys(handle) < 0)
+		goto error;
+
+	/* Update the first half, the last new value of key 0 wins */
+	for (i = 0; i < BULK_NUM_KEYS / 2; i++)
+		bulk_data[i] = (bulk_data[i] + 1) & VALUE_BITMASK;
+	saved_value = bulk_data[BULK_NUM_KEYS / 2];
+	bulk_key_ptrs[BULK_NUM_KEYS / 2] = &bulk_keys[0];
+	bulk_data[BULK_NUM_KEYS / 2] = (bulk_data[0] + 1) & VALUE_BITMASK;
+	ret = rte_efd_update_bulk(handle, test_socket_id,
+			BULK_NUM_KEYS / 2 + 1, bulk_key_ptrs, bulk_data, NULL);
+	TEST_ASSERT_EQUAL(ret, 0, "bulk update failed for %d keys", ret);
+	bulk_data[0] = bulk_data[BULK_NUM_KEYS / 2];
+	bulk_key_ptrs[BULK_NUM_KEYS / 2] = &bulk_keys[BULK_NUM_KEYS / 2];
+	bulk_data[BULK_NUM_KEYS / 2] = saved_value;
+	if (check_bulk_keys(handle) < 0)
+		goto error;
+
+	/* Delete every other key, the remaining ones are still found */
+	for (i = 0; i < BULK_NUM_KEYS; i += 2) {
+		TEST_ASSERT_SUCCESS(rte_efd_delete(handle, test_socket_id,
+				&bulk_keys[i], &prev_value),
+				"failed to delete key %u", i);
+		TEST_ASSERT_EQUAL(prev_value, bulk_data[i],
+				"failed to delete the expected value, got %d, "
+				"expected %d", prev_value, bulk_data[i]);
+	}
+	for (i = 1; i < BULK_NUM_KEYS; i += 2)
+		TEST_ASSERT_EQUAL(rte_efd_lookup(handle, test_socket_id,
+				&bulk_keys[i]), bulk_data[i],
+				"key %u has a wrong value after deletes", i);
+	rte_efd_free(handle);
+
+	/* Build a new table one shard at a time */
+	handle = rte_efd_create("test_bulk_update", BULK_NUM_KEYS,
+			sizeof(uint64_t), efd_get_all_sockets_bitmask(),
+			test_socket_id);
+	TEST_ASSERT_NOT_NULL(handle, "Error creating the efd table\n");
+
+	TEST_ASSERT_EQUAL(rte_efd_update_bulk_shard(handle, test_socket_id,
+			BULK_NUM_KEYS, bulk_key_ptrs, bulk_data, NULL,
+			BULK_NUM_SHARDS, BULK_NUM_SHARDS), -EINVAL,
+			"bulk update of an invalid shard should fail");
+	for (shard = 0; shard < BULK_NUM_SHARDS; shard++) {
+		ret = rte_efd_update_bulk_shard(handle, test_socket_id,
+				BULK_NUM_KEYS, bulk_key_ptrs, bulk_data, NULL,
+				shard, BULK_NUM_SHARDS);
+		TEST_ASSERT_EQUAL(ret, 0, "bulk update of shard %u failed "
+				"for %d keys", shard, ret);
+	}
+	if (check_bulk_keys(handle) < 0)
+		goto error;
+
+	rte_efd_free(handle);
+	return 0;
+
+error:
+	rte_efd_free(handle);
+	return -1;
+}
+
+#define CONCURRENT_NUM_ROUNDS 4
+#define CONCURRENT_BATCH_KEYS (1 << 10)
+
+static uint32_t concurrent_stop;
+static uint32_t concurrent_passes;
+static unsigned int concurrent_errors;
+
+/* Looks up the second half of the bulk keys until stopped */
+static int
+test_concurrent_reader(void *arg)
+{
+	const struct rte_efd_table *handle = arg;
+	efd_value_t result[RTE_EFD_BURST_MAX];
+	unsigned int i, j;
+
+	while (__atomic_load_n(&concurrent_stop, __ATOMIC_ACQUIRE) == 0) {
+		for (i = BULK_NUM_KEYS / 2; i < BULK_NUM_KEYS;
+				i += RTE_EFD_BURST_MAX) {
+			rte_efd_lookup_bulk(handle, test_socket_id,
+					RTE_EFD_BURST_MAX, &bulk_key_ptrs[i],
+					result);
+			for (j = 0; j < RTE_EFD_BURST_MAX; j++)
+				if (result[j] != bulk_data[i + j])
+					concurrent_errors++;
+		}
+		__atomic_fetch_add(&concurrent_passes, 1, __ATOMIC_RELEASE);
+	}
+	return 0;
+}
+
+/*
+ * Waits until the reader has looked up all its keys after the last update,
+ * so that no lookup spans two updates.
+ */
+static void
+test_concurrent_wait_reader(void)
+{
+	uint32_t passes = __atomic_load_n(&concurrent_passes,
+			__ATOMIC_ACQUIRE);
+
+	while (__atomic_load_n(&concurrent_passes, __ATOMIC_ACQUIRE) <
+			passes + 2)
+		rte_pause();
+}
+
+/*
+ * Lookups of keys outside of a bulk update, while it runs:
+ *      - add the second half of the keys (bulk)
+ *      - lookup the second half of the keys on another lcore
+ *      - add, then update the first half of the keys (bulk), in batches
+ *      - lookups during each batch never miss
+ *      - lookup all keys: hit
+ */
+static int test_bulk_update_concurrent(void)
+{
+	struct rte_efd_table *handle;
+	unsigned int i, j, round, lcore_id;
+	int ret;
+
+	printf("Entering %s\n", __func__);
+
+	lcore_id = rte_get_next_lcore(-1, 1, 0);
+	if (lcore_id >= RTE_MAX_LCORE) {
+		printf("At least 2 lcores are needed, skipping\n");
+		return 0;
+	}
+
+	handle = rte_efd_create("test_bulk_update_concurrent", BULK_NUM_KEYS,
+			sizeof(uint64_t), efd_get_all_sockets_bitmask(),
+			test_socket_id);
+	TEST_ASSERT_NOT_NULL(handle, "Error creating the efd table\n");
+
+	for (i = 0; i < BULK_NUM_KEYS; i++) {
+		bulk_keys[i] = i;
+		bulk_key_ptrs[i] = &bulk_keys[i];
+		bulk_data[i] = rte_rand() & VALUE_BITMASK;
+	}
+
+	ret = rte_efd_update_bulk(handle, test_socket_id, BULK_NUM_KEYS / 2,
+			&bulk_key_ptrs[BULK_NUM_KEYS / 2],
+			&bulk_data[BULK_NUM_KEYS / 2], NULL);
+	TEST_ASSERT_EQUAL(ret, 0, "bulk update failed for %d keys", ret);
+
+	concurrent_stop = 0;
+	concurrent_passes = 0;
+	concurrent_errors = 0;
+	rte_eal_remote_launch(test_concurrent_reader, handle, lcore_id);
+
+	/* The first round adds the keys, the next ones update them */
+	for (round = 0; round < CONCURRENT_NUM_ROUNDS; round++) {
+		for (i = 0; i < BULK_NUM_KEYS / 2;
+				i += CONCURRENT_BATCH_KEYS) {
+			for (j = i; round != 0 &&
+					j < i + CONCURRENT_BATCH_KEYS; j++)
+				bulk_data[j] = (bulk_data[j] + 1) &
+						VALUE_BITMASK;
+			ret = rte_efd_update_bulk(handle, test_socket_id,
+					CONCURRENT_BATCH_KEYS,
+					&bulk_key_ptrs[i], &bulk_data[i],
+					NULL);
+			if (ret != 0)
+				break;
+			test_concurrent_wait_reader();
+		}
+		if (ret != 0)
+			break;
+	}
+
+	__atomic_store_n(&concurrent_stop, 1, __ATOMIC_RELEASE);
+	rte_eal_wait_lcore(lcore_id);
+
+	if (ret != 0) {
+		printf("bulk update failed for %d keys\n", ret);
+		goto error;
+	}
+	if (concurrent_errors != 0) {
+		printf("%u lookups of keys not being updated failed\n",
+				concurrent_errors);
+		goto error;
+	}
+	if (check_bulk_keys(handle) < 0)
+		goto error;
+
+	rte_efd_free(handle);
+	return 0;
+
+error:
+	rte_efd_free(handle);
+	return -1;
+}
+
 /*
  * Do tests for EFD creation with bad parameters.
  */
@@ -458,6 +717,10 @@ test_efd(void)
 		return -1;
 	if (test_five_keys() < 0)
 		return -1;
+	if (test_bulk_update() < 0)
+		return -1;
+	if (test_bulk_update_concurrent() < 0)
+		return -1;
 	if (test_efd_creation_with_bad_parameters() < 0)
 		return -1;
 	if (test_average_table_utilization() < 0)
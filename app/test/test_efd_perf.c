@@ -48,6 +48,7 @@ enum operations {
 	LOOKUP,
 	LOOKUP_MULTI,
 	DELETE,
+	ADD_BULK,
 	NUM_OPERATIONS
 };
 
@@ -192,6 +193,32 @@ timed_adds(struct efd_perf_params *params)
 	return 0;
 }
 
+static int
+timed_adds_bulk(struct efd_perf_params *params)
+{
+	static const void *key_ptrs[KEYS_TO_ADD];
+	unsigned int i;
+	int ret;
+
+	for (i = 0; i < KEYS_TO_ADD; i++)
+		key_ptrs[i] = keys[i];
+
+	const uint64_t start_tsc = rte_rdtsc();
+
+	ret = rte_efd_update_bulk(params->efd_table, test_socket_id,
+			KEYS_TO_ADD, key_ptrs, data, NULL);
+	if (ret != 0) {
+		printf("Error %d in rte_efd_update_bulk\n", ret);
+		return -1;
+	}
+
+	const uint64_t end_tsc = rte_rdtsc();
+	const uint64_t time_taken = end_tsc - start_tsc;
+
+	cycles[params->cycle][ADD_BULK] = time_taken / KEYS_TO_ADD;
+	return 0;
+}
+
 static int
 timed_lookups(struct efd_perf_params *params)
 {
@@ -352,6 +379,10 @@ run_all_tbl_perf_tests(void)
 		if (timed_deletes(&params) < 0)
 			return exit_with_fail("timed_deletes", &params, i);
 
+		/* The table is empty again, add all the keys at once */
+		if (timed_adds_bulk(&params) < 0)
+			return exit_with_fail("timed_adds_bulk", &params, i);
+
 		/* Print a dot to show progress on operations */
 		printf(".");
 		fflush(stdout);
@@ -361,8 +392,9 @@ run_all_tbl_perf_tests(void)
 
 	printf("\nResults (in CPU cycles/operation)\n");
 	printf("-----------------------------------\n");
-	printf("\n%-18s%-18s%-18s%-18s%-18s\n",
-			"Keysize", "Add", "Lookup", "Lookup_bulk", "Delete");
+	printf("\n%-18s%-18s%-18s%-18s%-18s%-18s\n",
+			"Keysize", "Add", "Lookup", "Lookup_bulk", "Delete",
+			"Add_bulk");
 	for (i = 0; i < NUM_KEYSIZES; i++) {
 		printf("%-18d", hashtest_key_lens[i]);
 		for (j = 0; j < NUM_OPERATIONS; j++)
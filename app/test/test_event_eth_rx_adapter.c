@@ -10,6 +10,8 @@
 #include <rte_bus_vdev.h>
 
 #include <rte_event_eth_rx_adapter.h>
+#include <rte_event_eth_tx_adapter.h>
+#include <rte_service.h>
 
 #include "test.h"
 
@@ -21,6 +23,16 @@
 #define TEST_DEV_ID		0
 #define TEST_ETHDEV_ID		0
 
+/* vector datapath test, looping the packets through a ring port */
+#define VEC_EVDEV_NAME		"event_sw_rxa_vec"
+#define VEC_ETHDEV_NAME		"net_ring_rxa_vec"
+#define VEC_NB_MBUFS		512
+#define VEC_NB_VECTORS		4
+#define VEC_SZ			4
+#define VEC_NB_PKTS		(2 * VEC_SZ + 1)
+#define VEC_TMO_US		10000
+#define VEC_RETRY		0xffff
+
 struct event_eth_rx_adapter_test_params {
 	struct rte_mempool *mp;
 	uint16_t rx_rings, tx_rings;
@@ -658,6 +670,491 @@ adapter_start_stop(void)
 	return TEST_SUCCESS;
 }
 
+static int
+adapter_vector_config(void)
+{
+	int err;
+	uint32_t cap;
+	struct rte_event ev;
+	struct rte_mempool *vector_mp;
+	struct rte_event_eth_rx_adapter_queue_conf queue_config;
+	struct rte_event_eth_rx_adapter_vector_limits limits;
+	struct rte_event_eth_rx_adapter_event_vector_config vector_config;
+
+	err = rte_event_eth_rx_adapter_caps_get(TEST_DEV_ID, TEST_ETHDEV_ID,
+					 &cap);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_rx_adapter_vector_limits_get(TEST_DEV_ID,
+							TEST_ETHDEV_ID, NULL);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	err = rte_event_eth_rx_adapter_vector_limits_get(TEST_DEV_ID,
+							TEST_ETHDEV_ID,
+							&limits);
+	if (!(cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_EVENT_VECTOR) ||
+			(cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_INTERNAL_PORT)) {
+		TEST_ASSERT(err == -ENOTSUP, "Expected -ENOTSUP got %d", err);
+		return TEST_SUCCESS;
+	}
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	TEST_ASSERT(limits.min_sz <= limits.max_sz,
+		"Invalid vector size limits");
+
+	vector_mp = rte_event_vector_pool_create("test_vector_pool", 64, 0,
+						limits.min_sz, rte_socket_id());
+	TEST_ASSERT(vector_mp != NULL, "Failed to create vector pool");
+
+	memset(&ev, 0, sizeof(ev));
+	ev.sched_type = RTE_SCHED_TYPE_ATOMIC;
+	memset(&queue_config, 0, sizeof(queue_config));
+	queue_config.ev = ev;
+	queue_config.servicing_weight = 1;
+
+	vector_config.vector_sz = limits.min_sz;
+	vector_config.vector_timeout_ns = limits.min_timeout_ns;
+	vector_config.vector_mp = vector_mp;
+
+	/* the queue must be added to the adapter first */
+	err = rte_event_eth_rx_adapter_queue_event_vector_config(TEST_INST_ID,
+						TEST_ETHDEV_ID, -1,
+						&vector_config);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	err = rte_event_eth_rx_adapter_queue_add(TEST_INST_ID, TEST_ETHDEV_ID,
+						-1, &queue_config);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	vector_config.vector_sz = limits.max_sz;
+	err = rte_event_eth_rx_adapter_queue_event_vector_config(TEST_INST_ID,
+						TEST_ETHDEV_ID, -1,
+						&vector_config);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	vector_config.vector_sz = limits.min_sz;
+	err = rte_event_eth_rx_adapter_queue_event_vector_config(TEST_INST_ID,
+						TEST_ETHDEV_ID, -1,
+						&vector_config);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	vector_config.vector_sz = 0;
+	err = rte_event_eth_rx_adapter_queue_event_vector_config(TEST_INST_ID,
+						TEST_ETHDEV_ID, -1,
+						&vector_config);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_rx_adapter_queue_del(TEST_INST_ID, TEST_ETHDEV_ID,
+						-1);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	rte_mempool_free(vector_mp);
+
+	return TEST_SUCCESS;
+}
+
+struct vector_test_params {
+	uint8_t evdev;
+	uint16_t port;
+	struct rte_mempool *mp;
+	struct rte_mempool *vector_mp;
+	uint32_t service_id[3];
+	unsigned int nb_services;
+};
+
+static struct vector_test_params vector_params;
+
+static int
+vector_rx_conf_cb(uint8_t id, uint8_t dev_id,
+		struct rte_event_eth_rx_adapter_conf *conf, void *arg)
+{
+	RTE_SET_USED(id);
+	RTE_SET_USED(dev_id);
+	RTE_SET_USED(arg);
+	conf->event_port_id = 1;
+	conf->max_nb_rx = 128;
+	return 0;
+}
+
+static int
+vector_tx_conf_cb(uint8_t id, uint8_t dev_id,
+		struct rte_event_eth_tx_adapter_conf *conf, void *arg)
+{
+	RTE_SET_USED(id);
+	RTE_SET_USED(dev_id);
+	RTE_SET_USED(arg);
+	conf->event_port_id = 2;
+	conf->max_nb_tx = 128;
+	return 0;
+}
+
+static int
+vector_service_add(uint32_t service_id)
+{
+	int err;
+
+	err = rte_service_runstate_set(service_id, 1);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_service_set_runstate_mapped_check(service_id, 0);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	vector_params.service_id[vector_params.nb_services++] = service_id;
+
+	return 0;
+}
+
+static void
+vector_services_run(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < vector_params.nb_services; i++)
+		rte_service_run_iter_on_app_lcore(vector_params.service_id[i],
+						0);
+}
+
+/* inject packets on the Rx queue of the ring port */
+static int
+vector_inject(struct rte_mbuf **pkts, uint16_t nb)
+{
+	int err;
+
+	err = rte_pktmbuf_alloc_bulk(vector_params.mp, pkts, nb);
+	TEST_ASSERT(err == 0, "Failed to allocate mbufs");
+	TEST_ASSERT_EQUAL(nb, rte_eth_tx_burst(vector_params.port, 0, pkts,
+					nb), "Failed to inject mbufs");
+
+	return 0;
+}
+
+static uint16_t
+vector_dequeue(struct rte_event *ev, uint16_t nb)
+{
+	unsigned int l;
+	uint16_t n = 0;
+
+	for (l = 0; l < VEC_RETRY && n < nb; l++) {
+		vector_services_run();
+		n += rte_event_dequeue_burst(vector_params.evdev, 0, &ev[n],
+					nb - n, 0);
+	}
+
+	return n;
+}
+
+static int
+vector_check(struct rte_event *ev, struct rte_mbuf **pkts, uint16_t nb_elem)
+{
+	struct rte_event_vector *vec = ev->vec;
+	uint16_t i;
+
+	TEST_ASSERT_EQUAL(ev->event_type, RTE_EVENT_TYPE_ETH_RX_ADAPTER_VECTOR,
+			"Unexpected event type %u", ev->event_type);
+	TEST_ASSERT_EQUAL(ev->queue_id, 0, "Unexpected event queue");
+	TEST_ASSERT_EQUAL(vec->nb_elem, nb_elem,
+			"Expected %u mbufs got %u", nb_elem, vec->nb_elem);
+	TEST_ASSERT(vec->attr_valid && vec->port == vector_params.port &&
+			vec->queue == 0, "Invalid vector attributes");
+	for (i = 0; i < nb_elem; i++)
+		TEST_ASSERT(vec->mbufs[i] == pkts[i],
+			"Vector mbuf %u out of order", i);
+
+	return 0;
+}
+
+static int
+vector_setup(void)
+{
+	struct rte_event_dev_config dev_conf;
+	struct rte_event_dev_info dev_info;
+	struct rte_event_queue_conf qconf;
+	struct rte_eth_conf port_conf;
+	uint8_t queue_id;
+	uint32_t service_id;
+	int err;
+
+	memset(&vector_params, 0, sizeof(vector_params));
+
+	if (rte_vdev_init(VEC_EVDEV_NAME, NULL) != 0 ||
+			rte_vdev_init(VEC_ETHDEV_NAME, NULL) != 0) {
+		printf("Failed to create the sw event device or the ring port,"
+			" skipping\n");
+		return TEST_SKIPPED;
+	}
+	err = rte_event_dev_get_dev_id(VEC_EVDEV_NAME);
+	TEST_ASSERT(err >= 0, "Failed to find %s", VEC_EVDEV_NAME);
+	vector_params.evdev = err;
+	err = rte_eth_dev_get_port_by_name(VEC_ETHDEV_NAME,
+					&vector_params.port);
+	TEST_ASSERT(err == 0, "Failed to find %s", VEC_ETHDEV_NAME);
+
+	/* no cache, so that the available counts are exact */
+	vector_params.mp = rte_pktmbuf_pool_create("rxa_vec_mbuf_pool",
+					VEC_NB_MBUFS, 0, 0,
+					RTE_MBUF_DEFAULT_BUF_SIZE,
+					rte_socket_id());
+	TEST_ASSERT(vector_params.mp != NULL, "Failed to create mbuf pool");
+	vector_params.vector_mp = rte_event_vector_pool_create(
+					"rxa_vec_vector_pool", VEC_NB_VECTORS,
+					0, VEC_SZ, rte_socket_id());
+	TEST_ASSERT(vector_params.vector_mp != NULL,
+			"Failed to create vector pool");
+
+	memset(&port_conf, 0, sizeof(port_conf));
+	err = rte_eth_dev_configure(vector_params.port, 1, 1, &port_conf);
+	TEST_ASSERT(err == 0, "Failed to configure port %d", err);
+	err = rte_eth_rx_queue_setup(vector_params.port, 0, 512,
+				rte_socket_id(), NULL, vector_params.mp);
+	TEST_ASSERT(err == 0, "Failed to setup Rx queue %d", err);
+	err = rte_eth_tx_queue_setup(vector_params.port, 0, 512,
+				rte_socket_id(), NULL);
+	TEST_ASSERT(err == 0, "Failed to setup Tx queue %d", err);
+	err = rte_eth_dev_start(vector_params.port);
+	TEST_ASSERT(err == 0, "Failed to start port %d", err);
+
+	/* queue 0 for the Rx adapter, queue 1 for the Tx adapter */
+	err = rte_event_dev_info_get(vector_params.evdev, &dev_info);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	memset(&dev_conf, 0, sizeof(dev_conf));
+	dev_conf.nb_event_queues = 2;
+	dev_conf.nb_event_ports = 3;
+	dev_conf.nb_event_queue_flows = dev_info.max_event_queue_flows;
+	dev_conf.nb_event_port_dequeue_depth =
+			dev_info.max_event_port_dequeue_depth;
+	dev_conf.nb_event_port_enqueue_depth =
+			dev_info.max_event_port_enqueue_depth;
+	dev_conf.nb_events_limit = dev_info.max_num_events;
+	err = rte_event_dev_configure(vector_params.evdev, &dev_conf);
+	TEST_ASSERT(err == 0, "Event device initialization failed err %d",
+			err);
+
+	memset(&qconf, 0, sizeof(qconf));
+	qconf.nb_atomic_flows = dev_info.max_event_queue_flows;
+	qconf.nb_atomic_order_sequences = 32;
+	qconf.schedule_type = RTE_SCHED_TYPE_ATOMIC;
+	qconf.priority = RTE_EVENT_DEV_PRIORITY_NORMAL;
+	err = rte_event_queue_setup(vector_params.evdev, 0, &qconf);
+	TEST_ASSERT(err == 0, "Event queue setup failed %d", err);
+	qconf.event_queue_cfg = RTE_EVENT_QUEUE_CFG_SINGLE_LINK;
+	err = rte_event_queue_setup(vector_params.evdev, 1, &qconf);
+	TEST_ASSERT(err == 0, "Event queue setup failed %d", err);
+
+	for (queue_id = 0; queue_id < 3; queue_id++) {
+		err = rte_event_port_setup(vector_params.evdev, queue_id,
+					NULL);
+		TEST_ASSERT(err == 0, "Event port setup failed %d", err);
+	}
+	queue_id = 0;
+	err = rte_event_port_link(vector_params.evdev, 0, &queue_id, NULL, 1);
+	TEST_ASSERT(err == 1, "Failed to link queue 0");
+	queue_id = 1;
+	err = rte_event_port_link(vector_params.evdev, 2, &queue_id, NULL, 1);
+	TEST_ASSERT(err == 1, "Failed to link queue 1");
+
+	if (rte_event_dev_service_id_get(vector_params.evdev,
+					&service_id) == 0)
+		TEST_ASSERT_SUCCESS(vector_service_add(service_id),
+				"Failed to run the event device service");
+
+	err = rte_event_eth_rx_adapter_create_ext(TEST_INST_ID,
+					vector_params.evdev,
+					vector_rx_conf_cb, NULL);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_event_eth_tx_adapter_create_ext(TEST_INST_ID,
+					vector_params.evdev,
+					vector_tx_conf_cb, NULL);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	return 0;
+}
+
+static void
+vector_teardown(void)
+{
+	rte_event_eth_rx_adapter_free(TEST_INST_ID);
+	rte_event_eth_tx_adapter_free(TEST_INST_ID);
+	rte_event_dev_stop(vector_params.evdev);
+	rte_event_dev_close(vector_params.evdev);
+	rte_vdev_uninit(VEC_EVDEV_NAME);
+	rte_eth_dev_stop(vector_params.port);
+	rte_vdev_uninit(VEC_ETHDEV_NAME);
+	rte_mempool_free(vector_params.vector_mp);
+	rte_mempool_free(vector_params.mp);
+}
+
+static int
+adapter_vector_datapath(void)
+{
+	struct rte_event_eth_rx_adapter_event_vector_config vector_config;
+	struct rte_event_eth_rx_adapter_queue_conf queue_config;
+	struct rte_event_eth_rx_adapter_stats rx_stats;
+	struct rte_event_eth_tx_adapter_stats tx_stats;
+	struct rte_mbuf *pkts[VEC_NB_PKTS];
+	struct rte_mbuf *rx_pkts[VEC_NB_PKTS];
+	void *vectors[VEC_NB_VECTORS];
+	struct rte_event ev[VEC_NB_VECTORS];
+	const uint16_t sz = VEC_SZ;
+	uint16_t nb_tx, n;
+	uint64_t dropped;
+	unsigned int l;
+	uint32_t service_id;
+	uint32_t cap;
+	int err;
+
+	err = vector_setup();
+	if (err) {
+		vector_teardown();
+		return err;
+	}
+
+	err = rte_event_eth_rx_adapter_caps_get(vector_params.evdev,
+					vector_params.port, &cap);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	if (!(cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_EVENT_VECTOR) ||
+			(cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_INTERNAL_PORT)) {
+		vector_teardown();
+		return TEST_SKIPPED;
+	}
+
+	/* a single flow, kept in order by the atomic queue */
+	memset(&queue_config, 0, sizeof(queue_config));
+	queue_config.rx_queue_flags =
+		RTE_EVENT_ETH_RX_ADAPTER_QUEUE_FLOW_ID_VALID;
+	queue_config.servicing_weight = 1;
+	queue_config.ev.queue_id = 0;
+	queue_config.ev.sched_type = RTE_SCHED_TYPE_ATOMIC;
+	queue_config.ev.flow_id = 1;
+	err = rte_event_eth_rx_adapter_queue_add(TEST_INST_ID,
+					vector_params.port, 0, &queue_config);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	vector_config.vector_sz = sz;
+	vector_config.vector_timeout_ns = VEC_TMO_US * 1000;
+	vector_config.vector_mp = vector_params.vector_mp;
+	err = rte_event_eth_rx_adapter_queue_event_vector_config(TEST_INST_ID,
+					vector_params.port, 0, &vector_config);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_tx_adapter_queue_add(TEST_INST_ID,
+					vector_params.port, 0);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_rx_adapter_service_id_get(TEST_INST_ID,
+					&service_id);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	TEST_ASSERT_SUCCESS(vector_service_add(service_id),
+			"Failed to run the Rx adapter service");
+	err = rte_event_eth_tx_adapter_service_id_get(TEST_INST_ID,
+					&service_id);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	TEST_ASSERT_SUCCESS(vector_service_add(service_id),
+			"Failed to run the Tx adapter service");
+
+	err = rte_event_dev_start(vector_params.evdev);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_event_eth_rx_adapter_start(TEST_INST_ID);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_event_eth_tx_adapter_start(TEST_INST_ID);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	/* full vectors are enqueued as soon as they are filled */
+	TEST_ASSERT_SUCCESS(vector_inject(pkts, 2 * sz),
+			"Failed to inject packets");
+	TEST_ASSERT_EQUAL(vector_dequeue(ev, 2), 2, "Full vectors not received");
+	TEST_ASSERT_SUCCESS(vector_check(&ev[0], &pkts[0], sz),
+			"Invalid first vector");
+	TEST_ASSERT_SUCCESS(vector_check(&ev[1], &pkts[sz], sz),
+			"Invalid second vector");
+
+	/* a partial vector is enqueued once it times out */
+	TEST_ASSERT_SUCCESS(vector_inject(&pkts[2 * sz], 1),
+			"Failed to inject packets");
+	vector_services_run();
+	TEST_ASSERT_EQUAL(rte_event_dequeue_burst(vector_params.evdev, 0,
+						&ev[2], 1, 0), 0,
+			"Partial vector enqueued before its timeout");
+	rte_delay_us(2 * VEC_TMO_US);
+	TEST_ASSERT_EQUAL(vector_dequeue(&ev[2], 1), 1,
+			"Partial vector not flushed on timeout");
+	TEST_ASSERT_SUCCESS(vector_check(&ev[2], &pkts[2 * sz], 1),
+			"Invalid partial vector");
+
+	/* the packets are dropped while the vector pool is exhausted */
+	n = rte_mempool_avail_count(vector_params.vector_mp);
+	TEST_ASSERT(n == VEC_NB_VECTORS - 3, "Unexpected free vectors %u", n);
+	err = rte_mempool_get_bulk(vector_params.vector_mp, vectors, n);
+	TEST_ASSERT(err == 0, "Failed to get the free vectors");
+	err = rte_event_eth_rx_adapter_stats_get(TEST_INST_ID, &rx_stats);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	dropped = rx_stats.rx_dropped;
+	TEST_ASSERT_SUCCESS(vector_inject(rx_pkts, sz),
+			"Failed to inject packets");
+	TEST_ASSERT_EQUAL(vector_dequeue(&ev[3], 1), 0,
+			"Event enqueued without a vector");
+	err = rte_event_eth_rx_adapter_stats_get(TEST_INST_ID, &rx_stats);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	TEST_ASSERT_EQUAL(rx_stats.rx_dropped - dropped, sz,
+			"Expected %u drops got %" PRIu64, sz,
+			rx_stats.rx_dropped - dropped);
+	rte_mempool_put_bulk(vector_params.vector_mp, vectors, n);
+
+	/* deleting the queue frees its open vectors */
+	TEST_ASSERT_SUCCESS(vector_inject(rx_pkts, 1),
+			"Failed to inject packets");
+	vector_services_run();
+	TEST_ASSERT_EQUAL(rte_mempool_avail_count(vector_params.vector_mp),
+			VEC_NB_VECTORS - 4, "No vector open");
+	err = rte_event_eth_rx_adapter_queue_del(TEST_INST_ID,
+					vector_params.port, 0);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	TEST_ASSERT_EQUAL(rte_mempool_avail_count(vector_params.vector_mp),
+			VEC_NB_VECTORS - 3, "Open vector not freed");
+	err = rte_event_eth_rx_adapter_stats_get(TEST_INST_ID, &rx_stats);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	TEST_ASSERT_EQUAL(rx_stats.rx_dropped - dropped, sz + 1,
+			"Mbuf of the open vector not dropped");
+
+	/* the Tx adapter transmits the vectors, no longer polled for Rx */
+	for (l = 0; l < 3; l++) {
+		ev[l].op = RTE_EVENT_OP_NEW;
+		ev[l].queue_id = 1;
+	}
+	TEST_ASSERT_EQUAL(rte_event_enqueue_burst(vector_params.evdev, 0, ev,
+						3), 3,
+			"Failed to enqueue the vectors");
+	nb_tx = 0;
+	for (l = 0; l < VEC_RETRY && nb_tx < VEC_NB_PKTS; l++) {
+		vector_services_run();
+		nb_tx += rte_eth_rx_burst(vector_params.port, 0,
+					&rx_pkts[nb_tx], VEC_NB_PKTS - nb_tx);
+	}
+	TEST_ASSERT_EQUAL(nb_tx, VEC_NB_PKTS, "Expected %u mbufs got %u",
+			VEC_NB_PKTS, nb_tx);
+	for (n = 0; n < nb_tx; n++)
+		TEST_ASSERT(rx_pkts[n] == pkts[n], "Mbuf %u out of order", n);
+	rte_pktmbuf_free_bulk(rx_pkts, nb_tx);
+	err = rte_event_eth_tx_adapter_stats_get(TEST_INST_ID, &tx_stats);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	TEST_ASSERT_EQUAL(tx_stats.tx_packets, VEC_NB_PKTS,
+			"Expected %u Tx packets got %" PRIu64, VEC_NB_PKTS,
+			tx_stats.tx_packets);
+
+	/* all the vectors and mbufs are back in their pools */
+	TEST_ASSERT_EQUAL(rte_mempool_avail_count(vector_params.vector_mp),
+			VEC_NB_VECTORS, "Vectors not returned to the pool");
+	TEST_ASSERT_EQUAL(rte_mempool_avail_count(vector_params.mp),
+			VEC_NB_MBUFS, "Mbufs not returned to the pool");
+
+	err = rte_event_eth_rx_adapter_stop(TEST_INST_ID);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_event_eth_tx_adapter_stop(TEST_INST_ID);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_event_eth_tx_adapter_queue_del(TEST_INST_ID,
+					vector_params.port, 0);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	vector_teardown();
+
+	return TEST_SUCCESS;
+}
+
 static int
 adapter_stats(void)
 {
@@ -688,6 +1185,9 @@ static struct unit_test_suite event_eth_rx_tests = {
 					adapter_multi_eth_add_del),
 		TEST_CASE_ST(adapter_create, adapter_free, adapter_start_stop),
 		TEST_CASE_ST(adapter_create, adapter_free, adapter_stats),
+		TEST_CASE_ST(adapter_create, adapter_free,
+					adapter_vector_config),
+		TEST_CASE_ST(NULL, NULL, adapter_vector_datapath),
 		TEST_CASES_END() /**< NULL terminate unit test array */
 	}
 };
@@ -9,6 +9,7 @@
 
 #include <rte_ip.h>
 #include <rte_log.h>
+#include <rte_random.h>
 #include <rte_fib.h>
 
 #include "test.h"
@@ -21,9 +22,12 @@ static int32_t test_free_null(void);
 static int32_t test_add_del_invalid(void);
 static int32_t test_get_invalid(void);
 static int32_t test_lookup(void);
+static int32_t test_lookup_types(void);
+static int32_t test_save_restore(void);
 
 #define MAX_ROUTES	(1 << 16)
 #define MAX_TBL8	(1 << 15)
+#define NUM_LOOKUP_IPS	1037
 
 /*
  * Check that rte_fib_create fails gracefully for incorrect user input
@@ -371,6 +375,219 @@ test_lookup(void)
 	return TEST_SUCCESS;
 }
 
+/*
+ * Fill the table with random routes and check that all the lookup
+ * function types return the same next hops as the default one
+ */
+static int
+check_lookup_types(struct rte_fib *fib, uint64_t max_nh)
+{
+	static const enum rte_fib_lookup_type types[] = {
+		RTE_FIB_LOOKUP_DIR24_8_SCALAR_MACRO,
+		RTE_FIB_LOOKUP_DIR24_8_SCALAR_INLINE,
+		RTE_FIB_LOOKUP_DIR24_8_SCALAR_UNI,
+		RTE_FIB_LOOKUP_DIR24_8_VECTOR_AVX512,
+	};
+	static uint32_t ips[NUM_LOOKUP_IPS];
+	static uint64_t nh_ref[NUM_LOOKUP_IPS];
+	static uint64_t nh[NUM_LOOKUP_IPS];
+	uint32_t i, j;
+	int ret;
+
+	for (i = 0; i < MAX_ROUTES / 4; i++) {
+		/* mostly deep routes to use the tbl8 groups */
+		ret = rte_fib_add(fib, rte_rand() & 0xfff00000,
+			12 + rte_rand() % (RTE_FIB_MAXDEPTH - 11),
+			rte_rand() % (max_nh + 1));
+		RTE_TEST_ASSERT((ret == 0) || (ret == -ENOSPC),
+			"Failed to add a route\n");
+	}
+
+	for (i = 0; i < NUM_LOOKUP_IPS; i++)
+		ips[i] = (rte_rand() & 0xfff00000) | (rte_rand() & 0xfffff);
+
+	ret = rte_fib_lookup_bulk(fib, ips, nh_ref, NUM_LOOKUP_IPS);
+	RTE_TEST_ASSERT(ret == 0, "Failed to lookup\n");
+
+	for (i = 0; i < RTE_DIM(types); i++) {
+		ret = rte_fib_select_lookup(fib, types[i]);
+		if ((ret == -EINVAL) &&
+				(types[i] == RTE_FIB_LOOKUP_DIR24_8_VECTOR_AVX512))
+			continue;
+		RTE_TEST_ASSERT(ret == 0, "Failed to select lookup type %d\n",
+			types[i]);
+		ret = rte_fib_lookup_bulk(fib, ips, nh, NUM_LOOKUP_IPS);
+		RTE_TEST_ASSERT(ret == 0, "Failed to lookup\n");
+		for (j = 0; j < NUM_LOOKUP_IPS; j++)
+			RTE_TEST_ASSERT(nh[j] == nh_ref[j],
+				"Lookup type %d returns wrong nexthop\n",
+				types[i]);
+	}
+
+	return TEST_SUCCESS;
+}
+
+int32_t
+test_lookup_types(void)
+{
+	struct rte_fib *fib = NULL;
+	struct rte_fib_conf config;
+	uint64_t def_nh = 100;
+	int ret, nh_sz;
+
+	config.max_routes = MAX_ROUTES;
+	config.default_nh = def_nh;
+	config.type = RTE_FIB_DUMMY;
+
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	ret = rte_fib_select_lookup(fib, RTE_FIB_LOOKUP_DIR24_8_SCALAR_MACRO);
+	RTE_TEST_ASSERT(ret == -EINVAL,
+		"Lookup type selected for DUMMY type\n");
+	rte_fib_free(fib);
+
+	config.type = RTE_FIB_DIR24_8;
+	for (nh_sz = RTE_FIB_DIR24_8_1B; nh_sz <= RTE_FIB_DIR24_8_8B;
+			nh_sz++) {
+		config.dir24_8.nh_sz = nh_sz;
+		config.dir24_8.num_tbl8 = (nh_sz == RTE_FIB_DIR24_8_1B) ?
+			127 : MAX_TBL8 - 1;
+		fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+		RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+		ret = rte_fib_select_lookup(fib,
+			RTE_FIB_LOOKUP_DIR24_8_VECTOR_AVX512 + 1);
+		RTE_TEST_ASSERT(ret == -EINVAL,
+			"Invalid lookup type selected\n");
+		ret = check_lookup_types(fib, def_nh);
+		RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+			"Check_lookup_types fails for nh_sz %d\n", nh_sz);
+		rte_fib_free(fib);
+	}
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Check a FIB restored from a file looks up and updates routes
+ * like the saved one
+ */
+static int
+check_save_restore(struct rte_fib *fib, uint64_t max_nh)
+{
+	static uint32_t ips[NUM_LOOKUP_IPS];
+	static uint64_t nh_ref[NUM_LOOKUP_IPS];
+	static uint64_t nh[NUM_LOOKUP_IPS];
+	struct rte_fib *restored;
+	uint32_t i, ip;
+	uint8_t depth;
+	uint64_t next_hop;
+	int ret, ret_ref;
+	FILE *f;
+
+	for (i = 0; i < MAX_ROUTES / 4; i++) {
+		ret = rte_fib_add(fib, rte_rand() & 0xfff00000,
+			12 + rte_rand() % (RTE_FIB_MAXDEPTH - 11),
+			rte_rand() % (max_nh + 1));
+		RTE_TEST_ASSERT((ret == 0) || (ret == -ENOSPC),
+			"Failed to add a route\n");
+	}
+
+	f = tmpfile();
+	RTE_TEST_ASSERT(f != NULL, "Failed to create a file\n");
+	ret = rte_fib_save(fib, f);
+	RTE_TEST_ASSERT(ret == 0, "Failed to save FIB\n");
+	rewind(f);
+	restored = rte_fib_restore("restored_fib", SOCKET_ID_ANY, f);
+	fclose(f);
+	RTE_TEST_ASSERT(restored != NULL, "Failed to restore FIB\n");
+
+	for (i = 0; i < NUM_LOOKUP_IPS; i++)
+		ips[i] = (rte_rand() & 0xfff00000) | (rte_rand() & 0xfffff);
+	rte_fib_lookup_bulk(fib, ips, nh_ref, NUM_LOOKUP_IPS);
+	rte_fib_lookup_bulk(restored, ips, nh, NUM_LOOKUP_IPS);
+	for (i = 0; i < NUM_LOOKUP_IPS; i++)
+		RTE_TEST_ASSERT(nh[i] == nh_ref[i],
+			"Restored FIB returns wrong nexthop\n");
+
+	/* the routes are restored too, so the FIB can be updated */
+	for (i = 0; i < 1000; i++) {
+		ip = rte_rand() & 0xfff00000;
+		depth = 12 + rte_rand() % (RTE_FIB_MAXDEPTH - 11);
+		next_hop = rte_rand() % (max_nh + 1);
+		if (rte_rand() & 1) {
+			ret_ref = rte_fib_add(fib, ip, depth, next_hop);
+			ret = rte_fib_add(restored, ip, depth, next_hop);
+		} else {
+			ret_ref = rte_fib_delete(fib, ip, depth);
+			ret = rte_fib_delete(restored, ip, depth);
+		}
+		RTE_TEST_ASSERT(ret == ret_ref,
+			"Restored FIB update returns %d instead of %d\n",
+			ret, ret_ref);
+	}
+	rte_fib_lookup_bulk(fib, ips, nh_ref, NUM_LOOKUP_IPS);
+	rte_fib_lookup_bulk(restored, ips, nh, NUM_LOOKUP_IPS);
+	for (i = 0; i < NUM_LOOKUP_IPS; i++)
+		RTE_TEST_ASSERT(nh[i] == nh_ref[i],
+			"Updated restored FIB returns wrong nexthop\n");
+
+	rte_fib_free(restored);
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Save FIBs of every type to a file and restore them
+ */
+int32_t
+test_save_restore(void)
+{
+	struct rte_fib *fib = NULL;
+	struct rte_fib_conf config;
+	uint64_t def_nh = 100;
+	int ret, nh_sz;
+	FILE *f;
+
+	config.max_routes = MAX_ROUTES;
+	config.default_nh = def_nh;
+	config.type = RTE_FIB_DUMMY;
+
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	ret = rte_fib_save(fib, NULL);
+	RTE_TEST_ASSERT(ret == -EINVAL,
+		"Call succeeded with invalid parameters\n");
+	ret = check_save_restore(fib, def_nh);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+		"Check_save_restore fails for DUMMY type\n");
+	rte_fib_free(fib);
+
+	/* a file without a saved FIB */
+	f = tmpfile();
+	RTE_TEST_ASSERT(f != NULL, "Failed to create a file\n");
+	fwrite(&config, sizeof(config), 1, f);
+	rewind(f);
+	fib = rte_fib_restore(__func__, SOCKET_ID_ANY, f);
+	fclose(f);
+	RTE_TEST_ASSERT(fib == NULL, "FIB restored from an invalid file\n");
+
+	config.type = RTE_FIB_DIR24_8;
+	for (nh_sz = RTE_FIB_DIR24_8_1B; nh_sz <= RTE_FIB_DIR24_8_8B;
+			nh_sz++) {
+		config.dir24_8.nh_sz = nh_sz;
+		config.dir24_8.num_tbl8 = (nh_sz == RTE_FIB_DIR24_8_1B) ?
+			127 : MAX_TBL8 - 1;
+		fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+		RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+		ret = check_save_restore(fib, def_nh);
+		RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+			"Check_save_restore fails for nh_sz %d\n", nh_sz);
+		rte_fib_free(fib);
+	}
+
+	return TEST_SUCCESS;
+}
+
 static struct unit_test_suite fib_fast_tests = {
 	.suite_name = "fib autotest",
 	.setup = NULL,
@@ -381,6 +598,8 @@ static struct unit_test_suite fib_fast_tests = {
 	TEST_CASE(test_add_del_invalid),
 	TEST_CASE(test_get_invalid),
 	TEST_CASE(test_lookup),
+	TEST_CASE(test_lookup_types),
+	TEST_CASE(test_save_restore),
 	TEST_CASES_END()
 	}
 };
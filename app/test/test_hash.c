@@ -988,6 +988,553 @@ static int test_extendable_bucket(void)
 	return 0;
 }
 
+/*
+ * Add and delete keys in bursts.
+ *	- add a burst of keys: all added, each one found with its data
+ *	- add a burst mixing existing and new keys: existing keys keep their
+ *	  position and get their data updated
+ *	- delete a burst containing each key twice: the first occurrence is
+ *	  deleted, the second one is not found
+ *	- add a burst larger than the table: the keys which do not fit
+ *	  are reported with -ENOSPC
+ */
+#define BULK_KEYS	RTE_HASH_LOOKUP_BULK_MAX
+static int test_hash_bulk_add_del(uint8_t extra_flag)
+{
+	struct rte_hash_parameters params_bulk = {
+		.name = "test_bulk",
+		.entries = 4 * BULK_KEYS,
+		.key_len = sizeof(struct flow_key), /* 13 */
+		.hash_func = rte_jhash,
+		.hash_func_init_val = 0,
+		.socket_id = 0,
+		.extra_flag = extra_flag,
+	};
+	struct flow_key bulk_keys[2 * BULK_KEYS];
+	const void *key_ptrs[BULK_KEYS];
+	void *data[BULK_KEYS];
+	int32_t positions[BULK_KEYS];
+	int32_t expected_pos[2 * BULK_KEYS];
+	struct rte_hash *handle;
+	void *ret_data;
+	unsigned int i;
+	int ret;
+
+	memset(bulk_keys, 0, sizeof(bulk_keys));
+	for (i = 0; i < 2 * BULK_KEYS; i++) {
+		bulk_keys[i].ip_src = i;
+		bulk_keys[i].port_dst = i + 1;
+	}
+
+	handle = rte_hash_create(&params_bulk);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	for (i = 0; i < BULK_KEYS; i++) {
+		key_ptrs[i] = &bulk_keys[i];
+		data[i] = (void *)(uintptr_t)i;
+	}
+
+	/* Add a burst of new keys */
+	ret = rte_hash_add_key_bulk_data(handle, key_ptrs, BULK_KEYS, data,
+					positions);
+	RETURN_IF_ERROR(ret != BULK_KEYS, "bulk add failed (ret=%d)", ret);
+	for (i = 0; i < BULK_KEYS; i++) {
+		RETURN_IF_ERROR(positions[i] < 0,
+				"failed to add key %u (pos=%d)",
+				i, positions[i]);
+		expected_pos[i] = positions[i];
+		ret = rte_hash_lookup_data(handle, &bulk_keys[i], &ret_data);
+		RETURN_IF_ERROR(ret != expected_pos[i] || ret_data != data[i],
+				"failed to find key %u (pos=%d)", i, ret);
+	}
+
+	/* Update the second half and add new keys */
+	for (i = 0; i < BULK_KEYS; i++) {
+		key_ptrs[i] = &bulk_keys[i + BULK_KEYS / 2];
+		data[i] = (void *)(uintptr_t)(i + 2 * BULK_KEYS);
+	}
+	ret = rte_hash_add_key_bulk_data(handle, key_ptrs, BULK_KEYS, data,
+					positions);
+	RETURN_IF_ERROR(ret != BULK_KEYS, "bulk update failed (ret=%d)", ret);
+	for (i = 0; i < BULK_KEYS; i++) {
+		if (i < BULK_KEYS / 2)
+			RETURN_IF_ERROR(positions[i] !=
+					expected_pos[i + BULK_KEYS / 2],
+					"key %u moved on update (pos=%d)",
+					i + BULK_KEYS / 2, positions[i]);
+		expected_pos[i + BULK_KEYS / 2] = positions[i];
+		ret = rte_hash_lookup_data(handle, key_ptrs[i], &ret_data);
+		RETURN_IF_ERROR(ret != positions[i] || ret_data != data[i],
+				"failed to find key %u (pos=%d)",
+				i + BULK_KEYS / 2, ret);
+	}
+	RETURN_IF_ERROR(rte_hash_count(handle) != BULK_KEYS * 3 / 2,
+			"wrong number of keys after bulk add");
+
+	/* Delete the first half twice in the same burst */
+	for (i = 0; i < BULK_KEYS; i++)
+		key_ptrs[i] = &bulk_keys[i % (BULK_KEYS / 2)];
+	ret = rte_hash_del_key_bulk(handle, key_ptrs, BULK_KEYS, positions);
+	RETURN_IF_ERROR(ret != BULK_KEYS / 2, "bulk delete failed (ret=%d)",
+			ret);
+	for (i = 0; i < BULK_KEYS; i++) {
+		if (i < BULK_KEYS / 2) {
+			RETURN_IF_ERROR(positions[i] != expected_pos[i],
+					"failed to delete key %u (pos=%d)",
+					i, positions[i]);
+			if (extra_flag & RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF)
+				rte_hash_free_key_with_position(handle,
+								positions[i]);
+		} else
+			RETURN_IF_ERROR(positions[i] != -ENOENT,
+					"deleted key %u twice (pos=%d)",
+					i - BULK_KEYS / 2, positions[i]);
+	}
+
+	/* Delete the remaining keys */
+	for (i = 0; i < BULK_KEYS; i++)
+		key_ptrs[i] = &bulk_keys[i + BULK_KEYS / 2];
+	ret = rte_hash_del_key_bulk(handle, key_ptrs, BULK_KEYS, positions);
+	RETURN_IF_ERROR(ret != BULK_KEYS, "bulk delete failed (ret=%d)", ret);
+	for (i = 0; i < BULK_KEYS; i++) {
+		RETURN_IF_ERROR(positions[i] != expected_pos[i + BULK_KEYS / 2],
+				"failed to delete key %u (pos=%d)",
+				i + BULK_KEYS / 2, positions[i]);
+		if (extra_flag & RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF)
+			rte_hash_free_key_with_position(handle, positions[i]);
+		ret = rte_hash_lookup(handle, key_ptrs[i]);
+		RETURN_IF_ERROR(ret != -ENOENT,
+				"found deleted key %u (pos=%d)",
+				i + BULK_KEYS / 2, ret);
+	}
+	RETURN_IF_ERROR(rte_hash_count(handle) != 0,
+			"table not empty after bulk delete");
+	rte_hash_free(handle);
+
+	/* Add more keys than the table can hold */
+	params_bulk.entries = BULK_KEYS / 2;
+	handle = rte_hash_create(&params_bulk);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	for (i = 0; i < BULK_KEYS; i++)
+		key_ptrs[i] = &bulk_keys[i];
+	ret = rte_hash_add_key_bulk_data(handle, key_ptrs, BULK_KEYS, data,
+					positions);
+	RETURN_IF_ERROR(ret <= 0 || ret == BULK_KEYS,
+			"bulk add to a small table should partly fail (ret=%d)",
+			ret);
+	RETURN_IF_ERROR(rte_hash_count(handle) != ret,
+			"wrong number of keys after bulk add");
+	for (i = 0; i < BULK_KEYS; i++) {
+		if (positions[i] < 0) {
+			RETURN_IF_ERROR(positions[i] != -ENOSPC,
+					"unexpected error for key %u (%d)",
+					i, positions[i]);
+			continue;
+		}
+		ret = rte_hash_lookup(handle, key_ptrs[i]);
+		RETURN_IF_ERROR(ret != positions[i],
+				"failed to find key %u (pos=%d)", i, ret);
+	}
+	rte_hash_free(handle);
+
+	return 0;
+}
+
+/*
+ * Sequence of operations for resizing a table online:
+ *  - add keys filling most of the table
+ *  - start growing the table, add keys while migrating
+ *  - check all the keys are found at their position between migration steps
+ *  - delete keys, start shrinking the table and check again
+ *  - try shrinking below the number of keys: fail
+ * Repeat the test case when 'lock free read write concurrency' is enabled.
+ */
+#define RESIZE_ENTRIES_SMALL	64
+#define RESIZE_ENTRIES_LARGE	512
+#define RESIZE_KEYS		400
+static int
+check_resize_keys(struct rte_hash *handle, struct flow_key *rand_keys,
+		const int *expected_pos, unsigned int num_keys)
+{
+	const void *key_ptrs[RTE_HASH_LOOKUP_BULK_MAX];
+	int32_t positions[RTE_HASH_LOOKUP_BULK_MAX];
+	unsigned int i, j, n;
+	int pos;
+
+	for (i = 0; i < num_keys; i++) {
+		pos = rte_hash_lookup(handle, &rand_keys[i]);
+		if (pos != expected_pos[i]) {
+			printf("failed to find key %u (pos=%d)\n", i, pos);
+			return -1;
+		}
+	}
+
+	for (i = 0; i < num_keys; i += n) {
+		n = RTE_MIN(num_keys - i, (unsigned int)RTE_HASH_LOOKUP_BULK_MAX);
+		for (j = 0; j < n; j++)
+			key_ptrs[j] = &rand_keys[i + j];
+		rte_hash_lookup_bulk(handle, key_ptrs, n, positions);
+		for (j = 0; j < n; j++) {
+			if (positions[j] != expected_pos[i + j]) {
+				printf("failed to bulk find key %u (pos=%d)\n",
+					i + j, positions[j]);
+				return -1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+static int test_hash_resize(uint8_t extra_flag)
+{
+	struct rte_hash_parameters params_resize = {
+		.name = "test_resize",
+		.entries = RESIZE_ENTRIES_SMALL,
+		.key_len = sizeof(struct flow_key), /* 13 */
+		.hash_func = rte_jhash,
+		.hash_func_init_val = 0,
+		.socket_id = 0,
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_RESIZABLE | extra_flag,
+	};
+	struct flow_key rand_keys[RESIZE_KEYS];
+	int expected_pos[RESIZE_KEYS];
+	struct rte_hash *handle;
+	unsigned int i, added;
+	int ret;
+
+	memset(rand_keys, 0, sizeof(rand_keys));
+	for (i = 0; i < RESIZE_KEYS; i++) {
+		rand_keys[i].ip_src = i;
+		rand_keys[i].port_dst = i + 1;
+	}
+
+	handle = rte_hash_create(&params_resize);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	for (i = 0; i < RESIZE_ENTRIES_SMALL / 2; i++) {
+		expected_pos[i] = rte_hash_add_key(handle, &rand_keys[i]);
+		RETURN_IF_ERROR(expected_pos[i] < 0,
+			"failed to add key (pos[%u]=%d)", i, expected_pos[i]);
+	}
+	added = i;
+
+	ret = rte_hash_resize_start(handle, RESIZE_ENTRIES_LARGE);
+	RETURN_IF_ERROR(ret != 0, "failed to start growing (ret=%d)", ret);
+	ret = rte_hash_resize_start(handle, RESIZE_ENTRIES_LARGE * 2);
+	RETURN_IF_ERROR(ret != -EBUSY, "resize started twice (ret=%d)", ret);
+
+	/* Migrate one bucket at a time, adding keys meanwhile */
+	do {
+		RETURN_IF_ERROR(check_resize_keys(handle, rand_keys,
+				expected_pos, added) != 0,
+				"lookup failed while growing");
+		if (added < RESIZE_KEYS) {
+			expected_pos[added] = rte_hash_add_key(handle,
+							&rand_keys[added]);
+			RETURN_IF_ERROR(expected_pos[added] < 0,
+				"failed to add key while growing (pos=%d)",
+				expected_pos[added]);
+			added++;
+		}
+		ret = rte_hash_resize_step(handle, 1);
+		RETURN_IF_ERROR(ret < 0, "failed to grow (ret=%d)", ret);
+	} while (ret > 0);
+
+	for (; added < RESIZE_KEYS; added++) {
+		expected_pos[added] = rte_hash_add_key(handle,
+						&rand_keys[added]);
+		RETURN_IF_ERROR(expected_pos[added] < 0,
+			"failed to add key after growing (pos=%d)",
+			expected_pos[added]);
+	}
+	RETURN_IF_ERROR(check_resize_keys(handle, rand_keys, expected_pos,
+			RESIZE_KEYS) != 0, "lookup failed after growing");
+	RETURN_IF_ERROR(rte_hash_count(handle) != RESIZE_KEYS,
+			"wrong count after growing");
+	RETURN_IF_ERROR(rte_hash_resize_reclaim(handle) != 0,
+			"failed to reclaim memory");
+
+	ret = rte_hash_resize_start(handle, RESIZE_ENTRIES_SMALL);
+	RETURN_IF_ERROR(ret != -ENOSPC,
+			"shrinking below the number of keys (ret=%d)", ret);
+
+	/* Keep the keys using the lowest positions */
+	for (i = 0; i < RESIZE_KEYS; i++) {
+		if (expected_pos[i] < RESIZE_ENTRIES_SMALL / 2)
+			continue;
+		ret = rte_hash_del_key(handle, &rand_keys[i]);
+		RETURN_IF_ERROR(ret != expected_pos[i],
+			"failed to delete key (pos=%d)", ret);
+		if (extra_flag & RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF)
+			rte_hash_free_key_with_position(handle, ret);
+		expected_pos[i] = -ENOENT;
+	}
+
+	ret = rte_hash_resize_start(handle, RESIZE_ENTRIES_SMALL);
+	RETURN_IF_ERROR(ret != 0, "failed to start shrinking (ret=%d)", ret);
+	do {
+		RETURN_IF_ERROR(check_resize_keys(handle, rand_keys,
+				expected_pos, RESIZE_KEYS) != 0,
+				"lookup failed while shrinking");
+		ret = rte_hash_resize_step(handle, 4);
+		RETURN_IF_ERROR(ret < 0, "failed to shrink (ret=%d)", ret);
+	} while (ret > 0);
+
+	RETURN_IF_ERROR(check_resize_keys(handle, rand_keys, expected_pos,
+			RESIZE_KEYS) != 0, "lookup failed after shrinking");
+	RETURN_IF_ERROR(rte_hash_count(handle) != RESIZE_ENTRIES_SMALL / 2,
+			"wrong count after shrinking");
+	RETURN_IF_ERROR(rte_hash_max_key_id(handle) != RESIZE_ENTRIES_SMALL,
+			"wrong max key id after shrinking");
+
+	/* Positions are unchanged, deleting all the keys frees the table */
+	for (i = 0; i < RESIZE_KEYS; i++) {
+		if (expected_pos[i] < 0)
+			continue;
+		ret = rte_hash_del_key(handle, &rand_keys[i]);
+		RETURN_IF_ERROR(ret != expected_pos[i],
+			"failed to delete key (pos=%d)", ret);
+		if (extra_flag & RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF)
+			rte_hash_free_key_with_position(handle, ret);
+	}
+	RETURN_IF_ERROR(rte_hash_count(handle) != 0,
+			"wrong count after deleting");
+
+	rte_hash_free(handle);
+
+	return 0;
+}
+
+#define AGING_KEYS	128
+#define AGING_BATCH	8
+#define AGING_SCAN	32
+/* Run a full expiry scan in bounded batches, returning the number of keys
+ * expired, or -1 if a key which is not idle is expired.
+ */
+static int
+aging_expire_all(struct rte_hash *handle, uint32_t max_age,
+		const int32_t *expected_pos, const uint8_t *idle)
+{
+	const void *keys[AGING_BATCH];
+	void *data[AGING_BATCH];
+	int32_t positions[AGING_BATCH];
+	uint32_t next = 0;
+	unsigned int j;
+	int num_expired = 0;
+	int ret;
+
+	do {
+		ret = rte_hash_age_expire(handle, max_age, keys, data,
+				positions, AGING_BATCH, AGING_SCAN, &next);
+		if (ret < 0 || ret > AGING_BATCH) {
+			printf("expiry scan failed (ret=%d)\n", ret);
+			return -1;
+		}
+		for (j = 0; j < (unsigned int)ret; j++) {
+			uintptr_t i = (uintptr_t)data[j];
+
+			if (i >= AGING_KEYS || !idle[i] ||
+					positions[j] != expected_pos[i] ||
+					rte_hash_lookup(handle, keys[j]) !=
+						expected_pos[i]) {
+				printf("wrong key expired (pos=%d)\n",
+					positions[j]);
+				return -1;
+			}
+		}
+		num_expired += ret;
+	} while (next != 0);
+
+	return num_expired;
+}
+
+static int test_hash_aging(uint8_t extra_flag)
+{
+	struct rte_hash_parameters params_aging = {
+		.name = "test_aging",
+		.entries = 2 * AGING_KEYS,
+		.key_len = sizeof(struct flow_key), /* 13 */
+		.hash_func = rte_jhash,
+		.hash_func_init_val = 0,
+		.socket_id = 0,
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_AGING | extra_flag,
+	};
+	struct flow_key aging_keys[AGING_KEYS];
+	const void *key_ptrs[AGING_KEYS / 4];
+	int32_t positions[AGING_KEYS / 4];
+	int32_t expected_pos[AGING_KEYS];
+	uint8_t idle[AGING_KEYS];
+	struct rte_hash *handle;
+	unsigned int i;
+	int ret;
+
+	memset(aging_keys, 0, sizeof(aging_keys));
+	for (i = 0; i < AGING_KEYS; i++) {
+		aging_keys[i].ip_src = i;
+		aging_keys[i].port_dst = i + 1;
+	}
+
+	params_aging.extra_flag |= RTE_HASH_EXTRA_FLAGS_RESIZABLE;
+	handle = rte_hash_create(&params_aging);
+	RETURN_IF_ERROR(handle != NULL,
+			"aging and resizable table should be rejected");
+	params_aging.extra_flag &= ~RTE_HASH_EXTRA_FLAGS_RESIZABLE;
+
+	handle = rte_hash_create(&params_aging);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	for (i = 0; i < AGING_KEYS; i++) {
+		ret = rte_hash_add_key_data(handle, &aging_keys[i],
+						(void *)(uintptr_t)i);
+		RETURN_IF_ERROR(ret != 0, "failed to add key %u", i);
+		expected_pos[i] = rte_hash_lookup(handle, &aging_keys[i]);
+		RETURN_IF_ERROR(expected_pos[i] < 0,
+			"failed to find key (pos[%u]=%d)", i, expected_pos[i]);
+	}
+
+	for (i = 0; i < 3; i++)
+		RETURN_IF_ERROR(rte_hash_age_tick(handle) != 0,
+				"failed to advance age clock");
+
+	/* Access the first quarter with lookups, the second quarter with
+	 * bulk lookups and leave the second half idle.
+	 */
+	for (i = 0; i < AGING_KEYS / 4; i++) {
+		ret = rte_hash_lookup(handle, &aging_keys[i]);
+		RETURN_IF_ERROR(ret != expected_pos[i],
+				"failed to find key (pos=%d)", ret);
+		key_ptrs[i] = &aging_keys[AGING_KEYS / 4 + i];
+	}
+	rte_hash_lookup_bulk(handle, key_ptrs, AGING_KEYS / 4, positions);
+	for (i = 0; i < AGING_KEYS; i++)
+		idle[i] = i >= AGING_KEYS / 2;
+
+	RETURN_IF_ERROR(rte_hash_age_tick(handle) != 0,
+			"failed to advance age clock");
+
+	ret = aging_expire_all(handle, 2, expected_pos, idle);
+	RETURN_IF_ERROR(ret != AGING_KEYS / 2,
+			"wrong number of keys expired (%d)", ret);
+
+	/* Delete the idle keys, the next scan must not report them */
+	for (i = AGING_KEYS / 2; i < AGING_KEYS; i++) {
+		ret = rte_hash_del_key(handle, &aging_keys[i]);
+		RETURN_IF_ERROR(ret != expected_pos[i],
+				"failed to delete key (pos=%d)", ret);
+		if (extra_flag & RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF)
+			rte_hash_free_key_with_position(handle, ret);
+	}
+	ret = aging_expire_all(handle, 2, expected_pos, idle);
+	RETURN_IF_ERROR(ret != 0, "deleted keys expired (%d)", ret);
+
+	/* All the remaining keys are older than 0 ticks */
+	memset(idle, 1, sizeof(idle));
+	ret = aging_expire_all(handle, 0, expected_pos, idle);
+	RETURN_IF_ERROR(ret != AGING_KEYS / 2,
+			"wrong number of keys expired (%d)", ret);
+
+	rte_hash_free(handle);
+
+	return 0;
+}
+
+#define SAVE_ENTRIES	1024
+static int test_hash_save_restore(uint8_t extra_flag)
+{
+	struct rte_hash_parameters params_save = {
+		.name = "test_save",
+		.entries = SAVE_ENTRIES,
+		.key_len = sizeof(struct flow_key), /* 13 */
+		.hash_func = rte_jhash,
+		.hash_func_init_val = 0,
+		.socket_id = 0,
+		.extra_flag = extra_flag,
+	};
+	struct flow_key save_keys[SAVE_ENTRIES];
+	int32_t expected_pos[SAVE_ENTRIES];
+	struct rte_hash *handle, *restored;
+	unsigned int i;
+	void *data;
+	FILE *f;
+	int ret;
+
+	memset(save_keys, 0, sizeof(save_keys));
+	for (i = 0; i < SAVE_ENTRIES; i++) {
+		save_keys[i].ip_src = rte_rand();
+		save_keys[i].ip_dst = i;
+		save_keys[i].port_dst = i + 1;
+	}
+
+	handle = rte_hash_create(&params_save);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	/* Fill half of the table, then delete every other key */
+	for (i = 0; i < SAVE_ENTRIES / 2; i++) {
+		ret = rte_hash_add_key_data(handle, &save_keys[i],
+						(void *)(uintptr_t)i);
+		RETURN_IF_ERROR(ret != 0, "failed to add key %u", i);
+	}
+	for (i = 0; i < SAVE_ENTRIES / 2; i += 2) {
+		ret = rte_hash_del_key(handle, &save_keys[i]);
+		RETURN_IF_ERROR(ret < 0, "failed to delete key %u", i);
+	}
+	for (i = 0; i < SAVE_ENTRIES / 2; i++)
+		expected_pos[i] = rte_hash_lookup(handle, &save_keys[i]);
+
+	f = tmpfile();
+	RETURN_IF_ERROR(f == NULL, "cannot create file");
+	ret = rte_hash_save(handle, f);
+	RETURN_IF_ERROR(ret != 0, "failed to save table (ret=%d)", ret);
+
+	/* The key length must match the saved table */
+	params_save.name = "test_restore";
+	params_save.key_len = sizeof(struct flow_key) + 1;
+	rewind(f);
+	restored = rte_hash_restore(&params_save, f);
+	RETURN_IF_ERROR(restored != NULL,
+			"table restored with a different key length");
+	params_save.key_len = sizeof(struct flow_key);
+
+	rewind(f);
+	restored = rte_hash_restore(&params_save, f);
+	fclose(f);
+	RETURN_IF_ERROR(restored == NULL, "failed to restore table");
+	RETURN_IF_ERROR(rte_hash_count(restored) != rte_hash_count(handle),
+			"wrong count after restore");
+
+	for (i = 0; i < SAVE_ENTRIES / 2; i++) {
+		ret = rte_hash_lookup_data(restored, &save_keys[i], &data);
+		RETURN_IF_ERROR(ret != expected_pos[i],
+			"failed to find key %u (pos=%d)", i, ret);
+		RETURN_IF_ERROR(ret >= 0 && (uintptr_t)data != i,
+			"wrong data for key %u", i);
+	}
+
+	/* The free positions are usable after restore */
+	for (i = SAVE_ENTRIES / 2; i < SAVE_ENTRIES; i++) {
+		ret = rte_hash_add_key_data(restored, &save_keys[i],
+						(void *)(uintptr_t)i);
+		RETURN_IF_ERROR(ret != 0, "failed to add key %u", i);
+	}
+	for (i = 0; i < SAVE_ENTRIES; i++) {
+		ret = rte_hash_lookup_data(restored, &save_keys[i], &data);
+		if (i < SAVE_ENTRIES / 2 && expected_pos[i] < 0) {
+			RETURN_IF_ERROR(ret != -ENOENT,
+					"deleted key %u found", i);
+			continue;
+		}
+		RETURN_IF_ERROR(ret < 0 || (uintptr_t)data != i,
+				"failed to find key %u (pos=%d)", i, ret);
+	}
+
+	rte_hash_free(restored);
+	rte_hash_free(handle);
+
+	return 0;
+}
+
 /******************************************************************************/
 static int
 fbk_hash_unit_test(void)
@@ -1372,6 +1919,17 @@ static int test_hash_creation_with_bad_parameters(void)
 		return -1;
 	}
 
+	memcpy(&params, &ut_params, sizeof(params));
+	params.name = "creation_with_bad_parameters_5";
+	params.extra_flag = RTE_HASH_EXTRA_FLAGS_RESIZABLE |
+				RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD;
+	handle = rte_hash_create(&params);
+	if (handle != NULL) {
+		rte_hash_free(handle);
+		printf("Impossible creating resizable hash successfully with multi writer add\n");
+		return -1;
+	}
+
 	/* test with same name should fail */
 	memcpy(&params, &ut_params, sizeof(params));
 	params.name = "same_name";
@@ -1837,6 +2395,26 @@ test_hash(void)
 		return -1;
 	if (test_extendable_bucket() < 0)
 		return -1;
+	if (test_hash_bulk_add_del(0) < 0)
+		return -1;
+	if (test_hash_bulk_add_del(RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD) < 0)
+		return -1;
+	if (test_hash_bulk_add_del(RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF) < 0)
+		return -1;
+	if (test_hash_bulk_add_del(RTE_HASH_EXTRA_FLAGS_EXT_TABLE) < 0)
+		return -1;
+	if (test_hash_resize(0) < 0)
+		return -1;
+	if (test_hash_resize(RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF) < 0)
+		return -1;
+	if (test_hash_aging(0) < 0)
+		return -1;
+	if (test_hash_aging(RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF) < 0)
+		return -1;
+	if (test_hash_save_restore(0) < 0)
+		return -1;
+	if (test_hash_save_restore(RTE_HASH_EXTRA_FLAGS_EXT_TABLE) < 0)
+		return -1;
 
 	if (test_fbk_hash_find_existing() < 0)
 		return -1;
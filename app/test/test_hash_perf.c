@@ -34,6 +34,8 @@ enum operations {
 	LOOKUP,
 	LOOKUP_MULTI,
 	DELETE,
+	ADD_BULK,
+	DELETE_BULK,
 	NUM_OPERATIONS
 };
 
@@ -505,6 +507,89 @@ timed_deletes(unsigned int with_hash, unsigned int with_data,
 	return 0;
 }
 
+static int
+timed_adds_bulk(unsigned int with_data, unsigned int table_index,
+							unsigned int ext)
+{
+	unsigned int i, j;
+	int32_t positions_burst[BURST_SIZE];
+	const void *keys_burst[BURST_SIZE];
+	void *data_burst[BURST_SIZE];
+	int ret;
+	unsigned int keys_to_add;
+
+	if (!ext)
+		keys_to_add = KEYS_TO_ADD * ADD_PERCENT;
+	else
+		keys_to_add = KEYS_TO_ADD;
+
+	const uint64_t start_tsc = rte_rdtsc();
+
+	for (i = 0; i < keys_to_add/BURST_SIZE; i++) {
+		for (j = 0; j < BURST_SIZE; j++) {
+			keys_burst[j] = keys[i * BURST_SIZE + j];
+			if (with_data)
+				data_burst[j] = (void *) ((uintptr_t)
+						signatures[i * BURST_SIZE + j]);
+			else
+				data_burst[j] = NULL;
+		}
+		ret = rte_hash_add_key_bulk_data(h[table_index],
+				(const void **) keys_burst, BURST_SIZE,
+				data_burst, positions_burst);
+		if (ret != BURST_SIZE) {
+			printf("Expect to add %u keys, but added %d\n",
+				BURST_SIZE, ret);
+			return -1;
+		}
+	}
+
+	const uint64_t end_tsc = rte_rdtsc();
+	const uint64_t time_taken = end_tsc - start_tsc;
+
+	cycles[table_index][ADD_BULK][0][with_data] = time_taken/keys_to_add;
+
+	return 0;
+}
+
+static int
+timed_deletes_bulk(unsigned int with_data, unsigned int table_index,
+							unsigned int ext)
+{
+	unsigned int i, j;
+	int32_t positions_burst[BURST_SIZE];
+	const void *keys_burst[BURST_SIZE];
+	int ret;
+	unsigned int keys_to_add;
+
+	if (!ext)
+		keys_to_add = KEYS_TO_ADD * ADD_PERCENT;
+	else
+		keys_to_add = KEYS_TO_ADD;
+
+	const uint64_t start_tsc = rte_rdtsc();
+
+	for (i = 0; i < keys_to_add/BURST_SIZE; i++) {
+		for (j = 0; j < BURST_SIZE; j++)
+			keys_burst[j] = keys[i * BURST_SIZE + j];
+		ret = rte_hash_del_key_bulk(h[table_index],
+				(const void **) keys_burst, BURST_SIZE,
+				positions_burst);
+		if (ret != BURST_SIZE) {
+			printf("Expect to delete %u keys, but deleted %d\n",
+				BURST_SIZE, ret);
+			return -1;
+		}
+	}
+
+	const uint64_t end_tsc = rte_rdtsc();
+	const uint64_t time_taken = end_tsc - start_tsc;
+
+	cycles[table_index][DELETE_BULK][0][with_data] = time_taken/keys_to_add;
+
+	return 0;
+}
+
 static void
 free_table(unsigned table_index)
 {
@@ -549,6 +634,16 @@ run_all_tbl_perf_tests(unsigned int with_pushes, unsigned int with_locks,
 				if (timed_deletes(with_hash, with_data, i, ext) < 0)
 					return -1;
 
+				if (!with_hash) {
+					if (timed_adds_bulk(with_data, i,
+								ext) < 0)
+						return -1;
+
+					if (timed_deletes_bulk(with_data, i,
+								ext) < 0)
+						return -1;
+				}
+
 				/* Print a dot to show progress on operations */
 				printf(".");
 				fflush(stdout);
@@ -572,8 +667,9 @@ run_all_tbl_perf_tests(unsigned int with_pushes, unsigned int with_locks,
 			else
 				printf("\nWithout pre-computed hash values\n");
 
-			printf("\n%-18s%-18s%-18s%-18s%-18s\n",
-			"Keysize", "Add", "Lookup", "Lookup_bulk", "Delete");
+			printf("\n%-18s%-18s%-18s%-18s%-18s%-18s%-18s\n",
+			"Keysize", "Add", "Lookup", "Lookup_bulk", "Delete",
+			"Add_bulk", "Delete_bulk");
 			for (i = 0; i < NUM_KEYSIZES; i++) {
 				printf("%-18d", hashtest_key_lens[i]);
 				for (j = 0; j < NUM_OPERATIONS; j++)
@@ -585,6 +681,102 @@ run_all_tbl_perf_tests(unsigned int with_pushes, unsigned int with_locks,
 	return 0;
 }
 
+/* Control operation of the bulk lookup test on large tables. */
+#define LARGE_MIN_ENTRIES (1 << 20)	/* Smallest table tested. */
+#define LARGE_MAX_ENTRIES (1 << 25)	/* Largest table tested. */
+#define LARGE_NUM_LOOKUPS (1 << 24)	/* How many lookups to time. */
+
+struct large_key {
+	uint64_t lo;
+	uint64_t hi;
+};
+
+static void
+large_key_from_index(struct large_key *key, uint64_t index)
+{
+	key->lo = index;
+	key->hi = index * 0x9e3779b97f4a7c15ULL;
+}
+
+static int
+large_table_bulk_lookup_perf_test(void)
+{
+	struct rte_hash_parameters params = {
+		.key_len = sizeof(struct large_key),
+		.hash_func = rte_jhash,
+		.hash_func_init_val = 0,
+		.socket_id = rte_socket_id(),
+	};
+	struct large_key keys_burst[BURST_SIZE];
+	const void *keys_ptr[BURST_SIZE];
+	void *data_burst[BURST_SIZE];
+	int32_t positions_burst[BURST_SIZE];
+	struct rte_hash *handle;
+	unsigned int entries, keys_to_add, i, j;
+	uint64_t start_tsc, time_taken;
+	int ret;
+
+	for (j = 0; j < BURST_SIZE; j++) {
+		keys_ptr[j] = &keys_burst[j];
+		data_burst[j] = NULL;
+	}
+
+	printf("\n\n *** Bulk lookup on large tables ***\n");
+	printf("\n%-18s%-18s\n", "Entries", "Cycles/lookup");
+
+	for (entries = LARGE_MIN_ENTRIES; entries <= LARGE_MAX_ENTRIES;
+			entries <<= 1) {
+		params.name = "test_hash_large";
+		params.entries = entries;
+		handle = rte_hash_create(&params);
+		if (handle == NULL) {
+			printf("%-18u%-18s\n", entries, "not enough memory");
+			break;
+		}
+
+		keys_to_add = entries * ADD_PERCENT;
+		for (i = 0; i < keys_to_add; i += BURST_SIZE) {
+			for (j = 0; j < BURST_SIZE; j++)
+				large_key_from_index(&keys_burst[j], i + j);
+			ret = rte_hash_add_key_bulk_data(handle, keys_ptr,
+					BURST_SIZE, data_burst,
+					positions_burst);
+			if (ret != BURST_SIZE) {
+				printf("Failed to add keys %u to %u\n",
+					i, i + BURST_SIZE - 1);
+				rte_hash_free(handle);
+				return -1;
+			}
+		}
+
+		time_taken = 0;
+		for (i = 0; i < LARGE_NUM_LOOKUPS; i += BURST_SIZE) {
+			for (j = 0; j < BURST_SIZE; j++)
+				large_key_from_index(&keys_burst[j],
+						rte_rand() % keys_to_add);
+
+			start_tsc = rte_rdtsc();
+			rte_hash_lookup_bulk(handle, keys_ptr, BURST_SIZE,
+					positions_burst);
+			time_taken += rte_rdtsc() - start_tsc;
+
+			for (j = 0; j < BURST_SIZE; j++) {
+				if (positions_burst[j] < 0) {
+					printf("Key number %u not found\n", j);
+					rte_hash_free(handle);
+					return -1;
+				}
+			}
+		}
+
+		printf("%-18u%-18"PRIu64"\n", entries,
+			time_taken / LARGE_NUM_LOOKUPS);
+		rte_hash_free(handle);
+	}
+
+	return 0;
+}
+
 /* Control operation of performance testing of fbk hash. */
 #define LOAD_FACTOR 0.667	/* How full to make the hash table. */
 #define TEST_SIZE 1000000	/* How many operations to time. */
@@ -692,6 +884,9 @@ test_hash_perf(void)
 	if (run_all_tbl_perf_tests(1, 0, 1) < 0)
 		return -1;
 
+	if (large_table_bulk_lookup_perf_test() < 0)
+		return -1;
+
 	if (fbk_hash_perf_test() < 0)
 		return -1;
 
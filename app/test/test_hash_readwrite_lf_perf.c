@@ -58,6 +58,7 @@ struct rwc_perf {
 	uint32_t w_ks_r_miss[2][NUM_TEST];
 	uint32_t multi_rw[NUM_TEST - 1][2][NUM_TEST];
 	uint32_t w_ks_r_hit_extbkt[2][NUM_TEST];
+	uint32_t w_resize_r_hit[2][NUM_TEST];
 };
 
 static struct rwc_perf rwc_lf_results, rwc_non_lf_results;
@@ -185,6 +186,43 @@ init_params(int rwc_lf, int use_jhash, int htm, int ext_bkt)
 	return 0;
 }
 
+static int
+init_params_resizable(int rwc_lf, int htm)
+{
+	struct rte_hash *handle;
+
+	struct rte_hash_parameters hash_params = {
+		.entries = TOTAL_ENTRY,
+		.key_len = sizeof(uint32_t),
+		.hash_func = rte_hash_crc,
+		.hash_func_init_val = 0,
+		.socket_id = rte_socket_id(),
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_RESIZABLE,
+	};
+
+	if (rwc_lf)
+		hash_params.extra_flag |=
+			RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF;
+	else if (htm)
+		hash_params.extra_flag |=
+			RTE_HASH_EXTRA_FLAGS_TRANS_MEM_SUPPORT |
+			RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY;
+	else
+		hash_params.extra_flag |=
+			RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY;
+
+	hash_params.name = "tests_resize";
+
+	handle = rte_hash_create(&hash_params);
+	if (handle == NULL) {
+		printf("hash creation failed");
+		return -1;
+	}
+
+	tbl_rwc_test_param.h = handle;
+	return 0;
+}
+
 static inline int
 check_bucket(uint32_t bkt_idx, uint32_t key)
 {
@@ -1240,6 +1278,90 @@ test_hash_add_ks_lookup_hit_extbkt(struct rwc_perf *rwc_perf_results,
 	return -1;
 }
 
+/*
+ * Test lookup perf:
+ * Reader(s) lookup keys present in the table while
+ * 'Main' thread grows the table to twice its size.
+ */
+#define RESIZE_STEP_BUCKETS 64
+static int
+test_hash_resize_lookup_hit(struct rwc_perf *rwc_perf_results, int rwc_lf,
+				int htm)
+{
+	unsigned int n, m;
+	uint64_t i;
+	int ret;
+	uint8_t write_type = WRITE_NO_KEY_SHIFT;
+	uint8_t read_type = READ_PASS_NO_KEY_SHIFTS;
+
+	rte_atomic64_init(&greads);
+	rte_atomic64_init(&gread_cycles);
+
+	printf("\nTest: Hash resize - grow, read - hit\n");
+	for (m = 0; m < 2; m++) {
+		if (m == 1) {
+			printf("\n** With bulk-lookup **\n");
+			read_type |= BULK_LOOKUP;
+		}
+		for (n = 0; n < NUM_TEST; n++) {
+			unsigned int tot_lcore = rte_lcore_count();
+			if (tot_lcore < rwc_core_cnt[n] + 1)
+				return 0;
+
+			printf("\nNumber of readers: %u\n", rwc_core_cnt[n]);
+
+			rte_atomic64_clear(&greads);
+			rte_atomic64_clear(&gread_cycles);
+
+			if (init_params_resizable(rwc_lf, htm) != 0)
+				return -1;
+			if (write_keys(write_type) < 0)
+				goto err;
+			writer_done = 0;
+			for (i = 1; i <= rwc_core_cnt[n]; i++)
+				rte_eal_remote_launch(test_rwc_reader,
+						(void *)(uintptr_t)read_type,
+							enabled_core_ids[i]);
+			ret = rte_hash_resize_start(tbl_rwc_test_param.h,
+						TOTAL_ENTRY * 2);
+			if (ret != 0) {
+				printf("Resize start failed: %d\n", ret);
+				writer_done = 1;
+				goto err;
+			}
+			do {
+				ret = rte_hash_resize_step(tbl_rwc_test_param.h,
+						RESIZE_STEP_BUCKETS);
+			} while (ret > 0);
+			writer_done = 1;
+			if (ret < 0) {
+				printf("Resize step failed: %d\n", ret);
+				goto err;
+			}
+
+			for (i = 1; i <= rwc_core_cnt[n]; i++)
+				if (rte_eal_wait_lcore(enabled_core_ids[i]) < 0)
+					goto err;
+
+			unsigned long long cycles_per_lookup =
+				rte_atomic64_read(&gread_cycles) /
+				rte_atomic64_read(&greads);
+			rwc_perf_results->w_resize_r_hit[m][n]
+						= cycles_per_lookup;
+			printf("Cycles per lookup: %llu\n", cycles_per_lookup);
+
+			rte_hash_free(tbl_rwc_test_param.h);
+		}
+	}
+
+	return 0;
+
+err:
+	rte_eal_mp_wait_lcore();
+	rte_hash_free(tbl_rwc_test_param.h);
+	return -1;
+}
+
 static int
 test_hash_readwrite_lf_perf_main(void)
 {
@@ -1299,6 +1421,9 @@ test_hash_readwrite_lf_perf_main(void)
 		if (test_hash_add_ks_lookup_hit_extbkt(&rwc_lf_results, rwc_lf,
 							htm, ext_bkt) < 0)
 			return -1;
+		if (test_hash_resize_lookup_hit(&rwc_lf_results, rwc_lf,
+							htm) < 0)
+			return -1;
 	}
 	printf("\nTest lookup with read-write concurrency lock free support"
 	       " disabled\n");
@@ -1333,6 +1458,8 @@ test_hash_readwrite_lf_perf_main(void)
 	if (test_hash_add_ks_lookup_hit_extbkt(&rwc_non_lf_results, rwc_lf,
 						htm, ext_bkt) < 0)
 		return -1;
+	if (test_hash_resize_lookup_hit(&rwc_non_lf_results, rwc_lf, htm) < 0)
+		return -1;
 results:
 	printf("\n\t\t\t\t\t\t********** Results summary **********\n\n");
 	int i, j, k;
@@ -1366,8 +1493,11 @@ test_hash_readwrite_lf_perf_main(void)
 				"%u\n\t\t\t\t\t\t\t\t",
 				rwc_lf_results.w_ks_r_miss[j][i]);
 			printf("Hash add - key-shifts, Hash lookup hit (ext_bkt)\t\t"
-				"%u\n\n\t\t\t\t",
+				"%u\n\t\t\t\t\t\t\t\t",
 				rwc_lf_results.w_ks_r_hit_extbkt[j][i]);
+			printf("Hash resize - grow, Hash lookup hit\t\t\t\t"
+				"%u\n\n\t\t\t\t",
+				rwc_lf_results.w_resize_r_hit[j][i]);
 
 			printf("Disabled\t");
 			if (htm)
@@ -1390,8 +1520,11 @@ test_hash_readwrite_lf_perf_main(void)
 			       "%u\n\t\t\t\t\t\t\t\t",
 			       rwc_non_lf_results.w_ks_r_miss[j][i]);
 			printf("Hash add - key-shifts, Hash lookup hit (ext_bkt)\t\t"
-				"%u\n",
+				"%u\n\t\t\t\t\t\t\t\t",
 				rwc_non_lf_results.w_ks_r_hit_extbkt[j][i]);
+			printf("Hash resize - grow, Hash lookup hit\t\t\t\t"
+				"%u\n",
+				rwc_non_lf_results.w_resize_r_hit[j][i]);
 
 			printf("_______\t\t_______\t\t_________\t___\t\t"
 			       "_________\t\t\t\t\t\t_________________\n");
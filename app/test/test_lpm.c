@@ -8,6 +8,7 @@
 
 #include <rte_ip.h>
 #include <rte_lpm.h>
+#include <rte_random.h>
 
 #include "test.h"
 #include "test_xmmt_ops.h"
@@ -40,6 +41,7 @@ static int32_t test15(void);
 static int32_t test16(void);
 static int32_t test17(void);
 static int32_t test18(void);
+static int32_t test19(void);
 
 rte_lpm_test tests[] = {
 /* Test Cases */
@@ -61,7 +63,8 @@ rte_lpm_test tests[] = {
 	test15,
 	test16,
 	test17,
-	test18
+	test18,
+	test19
 };
 
 #define MAX_DEPTH 32
@@ -1265,6 +1268,84 @@ test18(void)
 	return PASS;
 }
 
+/*
+ * Save an LPM object to a file and restore it:
+ *  - the restored object looks up the same next hops
+ *  - the restored object is updated like the saved one
+ */
+int32_t
+test19(void)
+{
+	struct rte_lpm *lpm = NULL, *restored = NULL;
+	struct rte_lpm_config config;
+	uint32_t ip, next_hop, nh, nh_ref;
+	uint8_t depth;
+	int ret, ret_ref;
+	unsigned int i;
+	FILE *f;
+
+	config.max_rules = MAX_RULES;
+	config.number_tbl8s = NUMBER_TBL8S;
+	config.flags = 0;
+
+	lpm = rte_lpm_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+
+	for (i = 0; i < 1000; i++) {
+		ip = rte_rand() & 0xfff00000;
+		depth = 12 + rte_rand() % (RTE_LPM_MAX_DEPTH - 11);
+		rte_lpm_add(lpm, ip, depth, rte_rand() & 0xffffff);
+	}
+
+	TEST_LPM_ASSERT(rte_lpm_save(NULL, stdout) == -EINVAL);
+
+	f = tmpfile();
+	TEST_LPM_ASSERT(f != NULL);
+	TEST_LPM_ASSERT(rte_lpm_save(lpm, f) == 0);
+	rewind(f);
+	/* the name is in use */
+	TEST_LPM_ASSERT(rte_lpm_restore(__func__, SOCKET_ID_ANY, f) == NULL);
+	rewind(f);
+	restored = rte_lpm_restore("restored_lpm", SOCKET_ID_ANY, f);
+	fclose(f);
+	TEST_LPM_ASSERT(restored != NULL);
+
+	for (i = 0; i < 10000; i++) {
+		ip = (rte_rand() & 0xfff00000) | (rte_rand() & 0xfffff);
+		ret_ref = rte_lpm_lookup(lpm, ip, &nh_ref);
+		ret = rte_lpm_lookup(restored, ip, &nh);
+		TEST_LPM_ASSERT(ret == ret_ref);
+		TEST_LPM_ASSERT((ret != 0) || (nh == nh_ref));
+	}
+
+	for (i = 0; i < 1000; i++) {
+		ip = rte_rand() & 0xfff00000;
+		depth = 12 + rte_rand() % (RTE_LPM_MAX_DEPTH - 11);
+		next_hop = rte_rand() & 0xffffff;
+		if (rte_rand() & 1) {
+			ret_ref = rte_lpm_add(lpm, ip, depth, next_hop);
+			ret = rte_lpm_add(restored, ip, depth, next_hop);
+		} else {
+			ret_ref = rte_lpm_delete(lpm, ip, depth);
+			ret = rte_lpm_delete(restored, ip, depth);
+		}
+		TEST_LPM_ASSERT(ret == ret_ref);
+	}
+
+	for (i = 0; i < 10000; i++) {
+		ip = (rte_rand() & 0xfff00000) | (rte_rand() & 0xfffff);
+		ret_ref = rte_lpm_lookup(lpm, ip, &nh_ref);
+		ret = rte_lpm_lookup(restored, ip, &nh);
+		TEST_LPM_ASSERT(ret == ret_ref);
+		TEST_LPM_ASSERT((ret != 0) || (nh == nh_ref));
+	}
+
+	rte_lpm_free(restored);
+	rte_lpm_free(lpm);
+
+	return PASS;
+}
+
 /*
  * Do all unit tests.
  */
@@ -8,6 +8,8 @@
 #include <string.h>
 
 #include <rte_memory.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
 #include <rte_lpm6.h>
 
 #include "test.h"
@@ -51,6 +53,8 @@ static int32_t test25(void);
 static int32_t test26(void);
 static int32_t test27(void);
 static int32_t test28(void);
+static int32_t test29(void);
+static int32_t test30(void);
 
 rte_lpm6_test tests6[] = {
 /* Test Cases */
@@ -83,6 +87,8 @@ rte_lpm6_test tests6[] = {
 	test26,
 	test27,
 	test28,
+	test29,
+	test30,
 };
 
 #define MAX_DEPTH                                                    128
@@ -91,6 +97,9 @@ rte_lpm6_test tests6[] = {
 #define MAX_NUM_TBL8S                                          (1 << 21)
 #define PASS 0
 
+/* flags of the tables created by the tests */
+static int lpm6_flags;
+
 static void
 IPv6(uint8_t *ip, uint8_t b1, uint8_t b2, uint8_t b3, uint8_t b4, uint8_t b5,
 		uint8_t b6, uint8_t b7, uint8_t b8, uint8_t b9, uint8_t b10,
@@ -127,7 +136,7 @@ test0(void)
 
 	config.max_rules = MAX_RULES;
 	config.number_tbl8s = NUMBER_TBL8S;
-	config.flags = 0;
+	config.flags = lpm6_flags;
 
 	/* rte_lpm6_create: lpm name == NULL */
 	lpm = rte_lpm6_create(NULL, SOCKET_ID_ANY, &config);
@@ -153,6 +162,13 @@ test0(void)
 	lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, NULL);
 	TEST_LPM_ASSERT(lpm == NULL);
 
+	/* rte_lpm6_create: the unknown flags are ignored */
+	config.number_tbl8s = NUMBER_TBL8S;
+	config.flags = lpm6_flags | 0x100;
+	lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+	rte_lpm6_free(lpm);
+
 	return PASS;
 }
 
@@ -169,7 +185,7 @@ test1(void)
 
 	config.max_rules = MAX_RULES;
 	config.number_tbl8s = NUMBER_TBL8S;
-	config.flags = 0;
+	config.flags = lpm6_flags;
 
 	/* rte_lpm6_create: lpm name == LPM1 */
 	lpm1 = rte_lpm6_create("LPM1", SOCKET_ID_ANY, &config);
@@ -201,7 +217,7 @@ test2(void)
 	int32_t i;
 
 	config.number_tbl8s = NUMBER_TBL8S;
-	config.flags = 0;
+	config.flags = lpm6_flags;
 
 	/* rte_lpm6_free: Free NULL */
 	for (i = 0; i < 20; i++) {
@@ -230,7 +246,7 @@ test3(void)
 
 	config.max_rules = MAX_RULES;
 	config.number_tbl8s = NUMBER_TBL8S;
-	config.flags = 0;
+	config.flags = lpm6_flags;
 
 	lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
 	TEST_LPM_ASSERT(lpm != NULL);
@@ -255,7 +271,7 @@ test4(void)
 
 	config.max_rules = MAX_RULES;
 	config.number_tbl8s = NUMBER_TBL8S;
-	config.flags = 0;
+	config.flags = lpm6_flags;
 
 	/* rte_lpm6_add: lpm == NULL */
 	status = rte_lpm6_add(NULL, ip, depth, next_hop);
@@ -293,7 +309,7 @@ test5(void)
 
 	config.max_rules = MAX_RULES;
 	config.number_tbl8s = NUMBER_TBL8S;
-	config.flags = 0;
+	config.flags = lpm6_flags;
 
 	/* rte_lpm_delete: lpm == NULL */
 	status = rte_lpm6_delete(NULL, ip, depth);
@@ -331,7 +347,7 @@ test6(void)
 
 	config.max_rules = MAX_RULES;
 	config.number_tbl8s = NUMBER_TBL8S;
-	config.flags = 0;
+	config.flags = lpm6_flags;
 
 	/* rte_lpm6_lookup: lpm == NULL */
 	status = rte_lpm6_lookup(NULL, ip, &next_hop_return);
@@ -369,7 +385,7 @@ test7(void)
 
 	config.max_rules = MAX_RULES;
 	config.number_tbl8s = NUMBER_TBL8S;
-	config.flags = 0;
+	config.flags = lpm6_flags;
 
 	/* rte_lpm6_lookup: lpm == NULL */
 	status = rte_lpm6_lookup_bulk_func(NULL, ip, next_hop_return, 10);
@@ -407,7 +423,7 @@ test8(void)
 
 	config.max_rules = MAX_RULES;
 	config.number_tbl8s = NUMBER_TBL8S;
-	config.flags = 0;
+	config.flags = lpm6_flags;
 
 	/* rte_lpm6_delete: lpm == NULL */
 	status = rte_lpm6_delete_bulk_func(NULL, ip, depth, 10);
@@ -448,7 +464,7 @@ test9(void)
 
 	config.max_rules = MAX_RULES;
 	config.number_tbl8s = NUMBER_TBL8S;
-	config.flags = 0;
+	config.flags = lpm6_flags;
 
 	lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
 	TEST_LPM_ASSERT(lpm != NULL);
@@ -493,7 +509,7 @@ test10(void)
 
 	config.max_rules = 127;
 	config.number_tbl8s = NUMBER_TBL8S;
-	config.flags = 0;
+	config.flags = lpm6_flags;
 
 	lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
 	TEST_LPM_ASSERT(lpm != NULL);
@@ -535,9 +551,13 @@ test11(void)
 	uint32_t next_hop_add = 100;
 	int32_t status = 0;
 
+	/* tbl8 groups are only used by the default tables */
+	if (lpm6_flags & RTE_LPM6_F_COMPACT)
+		return PASS;
+
 	config.max_rules = MAX_RULES;
 	config.number_tbl8s = 16;
-	config.flags = 0;
+	config.flags = lpm6_flags;
 
 	lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
 	TEST_LPM_ASSERT(lpm != NULL);
@@ -596,9 +616,13 @@ test12(void)
 	uint32_t next_hop_add = 100;
 	int32_t status = 0;
 
+	/* tbl8 groups are only used by the default tables */
+	if (lpm6_flags & RTE_LPM6_F_COMPACT)
+		return PASS;
+
 	config.max_rules = MAX_RULES;
 	config.number_tbl8s = 16;
-	config.flags = 0;
+	config.flags = lpm6_flags;
 
 	lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
 	TEST_LPM_ASSERT(lpm != NULL);
@@ -637,7 +661,7 @@ test13(void)
 
 	config.max_rules = 2;
 	config.number_tbl8s = NUMBER_TBL8S;
-	config.flags = 0;
+	config.flags = lpm6_flags;
 
 	lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
 	TEST_LPM_ASSERT(lpm != NULL);
@@ -684,9 +708,13 @@ test14(void)
 	int32_t status = 0;
 	int i;
 
+	/* tbl8 groups are only used by the default tables */
+	if (lpm6_flags & RTE_LPM6_F_COMPACT)
+		return PASS;
+
 	config.max_rules = MAX_RULES;
 	config.number_tbl8s = 256;
-	config.flags = 0;
+	config.flags = lpm6_flags;
 
 	lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
 	TEST_LPM_ASSERT(lpm != NULL);
@@ -732,7 +760,7 @@ test15(void)
 
 	config.max_rules = MAX_RULES;
 	config.number_tbl8s = NUMBER_TBL8S;
-	config.flags = 0;
+	config.flags = lpm6_flags;
 
 	lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
 	TEST_LPM_ASSERT(lpm != NULL);
@@ -769,7 +797,7 @@ test16(void)
 
 	config.max_rules = MAX_RULES;
 	config.number_tbl8s = NUMBER_TBL8S;
-	config.flags = 0;
+	config.flags = lpm6_flags;
 
 	lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
 	TEST_LPM_ASSERT(lpm != NULL);
@@ -814,7 +842,7 @@ test17(void)
 
 	config.max_rules = MAX_RULES;
 	config.number_tbl8s = NUMBER_TBL8S;
-	config.flags = 0;
+	config.flags = lpm6_flags;
 
 	lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
 	TEST_LPM_ASSERT(lpm != NULL);
@@ -881,7 +909,7 @@ test18(void)
 
 	config.max_rules = MAX_RULES;
 	config.number_tbl8s = NUMBER_TBL8S;
-	config.flags = 0;
+	config.flags = lpm6_flags;
 
 	/* Add & lookup to hit invalid TBL24 entry */
 	IPv6(ip, 128, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
@@ -1043,7 +1071,7 @@ test19(void)
 
 	config.max_rules = MAX_RULES;
 	config.number_tbl8s = NUMBER_TBL8S;
-	config.flags = 0;
+	config.flags = lpm6_flags;
 
 	/* Add rule that covers a TBL24 range previously invalid & lookup
 	 * (& delete & lookup)
@@ -1242,7 +1270,7 @@ test20(void)
 
 	config.max_rules = MAX_RULES;
 	config.number_tbl8s = NUMBER_TBL8S;
-	config.flags = 0;
+	config.flags = lpm6_flags;
 
 	lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
 	TEST_LPM_ASSERT(lpm != NULL);
@@ -1311,7 +1339,7 @@ test21(void)
 
 	config.max_rules = MAX_RULES;
 	config.number_tbl8s = NUMBER_TBL8S;
-	config.flags = 0;
+	config.flags = lpm6_flags;
 
 	lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
 	TEST_LPM_ASSERT(lpm != NULL);
@@ -1370,7 +1398,7 @@ test22(void)
 
 	config.max_rules = MAX_RULES;
 	config.number_tbl8s = NUMBER_TBL8S;
-	config.flags = 0;
+	config.flags = lpm6_flags;
 
 	lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
 	TEST_LPM_ASSERT(lpm != NULL);
@@ -1487,7 +1515,7 @@ test23(void)
 
 	config.max_rules = MAX_RULES;
 	config.number_tbl8s = NUMBER_TBL8S;
-	config.flags = 0;
+	config.flags = lpm6_flags;
 
 	lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
 	TEST_LPM_ASSERT(lpm != NULL);
@@ -1531,7 +1559,7 @@ test24(void)
 
 	config.max_rules = 256 * 32;
 	config.number_tbl8s = NUMBER_TBL8S;
-	config.flags = 0;
+	config.flags = lpm6_flags;
 
 	/* Create lpm  */
 	lpm = rte_lpm6_create("lpm_find_existing", SOCKET_ID_ANY, &config);
@@ -1572,7 +1600,7 @@ test25(void)
 
 	config.max_rules = MAX_RULES;
 	config.number_tbl8s = NUMBER_TBL8S;
-	config.flags = 0;
+	config.flags = lpm6_flags;
 
 	lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
 	TEST_LPM_ASSERT(lpm != NULL);
@@ -1628,7 +1656,7 @@ test26(void)
 
 	config.max_rules = MAX_RULES;
 	config.number_tbl8s = NUMBER_TBL8S;
-	config.flags = 0;
+	config.flags = lpm6_flags;
 
 	lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
 	TEST_LPM_ASSERT(lpm != NULL);
@@ -1702,7 +1730,7 @@ test27(void)
 
 		config.max_rules = MAX_RULES;
 		config.number_tbl8s = NUMBER_TBL8S;
-		config.flags = 0;
+		config.flags = lpm6_flags;
 
 		lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
 		TEST_LPM_ASSERT(lpm != NULL);
@@ -1752,7 +1780,7 @@ test28(void)
 
 	config.max_rules = MAX_RULES;
 	config.number_tbl8s = NUMBER_TBL8S;
-	config.flags = 0;
+	config.flags = lpm6_flags;
 
 	lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
 	TEST_LPM_ASSERT(lpm != NULL);
@@ -1771,21 +1799,228 @@ test28(void)
 }
 
 /*
- * Do all unit tests.
+ * Add random routes sharing a few prefixes to a default and a compact
+ * table, delete half of them, and check after each step that both tables
+ * give the same results with single and bulk lookups.
+ */
+#define CMP_NB_ROUTES	4000
+#define CMP_NB_IPS	4096
+
+static int
+compare_lookups(struct rte_lpm6 *lpm, struct rte_lpm6 *ct,
+	uint8_t (*ips)[16], int32_t *nh, int32_t *nh_ct)
+{
+	uint32_t next_hop, next_hop_ct;
+	int status, status_ct;
+	unsigned int i;
+
+	/* odd burst size to use the scalar tail of the bulk lookup */
+	for (i = 0; i < CMP_NB_IPS; i += 1000) {
+		rte_lpm6_lookup_bulk_func(lpm, &ips[i], &nh[i],
+			RTE_MIN(1000U, CMP_NB_IPS - i));
+		rte_lpm6_lookup_bulk_func(ct, &ips[i], &nh_ct[i],
+			RTE_MIN(1000U, CMP_NB_IPS - i));
+	}
+
+	for (i = 0; i < CMP_NB_IPS; i++) {
+		TEST_LPM_ASSERT(nh[i] == nh_ct[i]);
+		status = rte_lpm6_lookup(lpm, ips[i], &next_hop);
+		status_ct = rte_lpm6_lookup(ct, ips[i], &next_hop_ct);
+		TEST_LPM_ASSERT(status == status_ct);
+		TEST_LPM_ASSERT(status != 0 || next_hop == next_hop_ct);
+		TEST_LPM_ASSERT(status != 0 || nh[i] == (int32_t)next_hop);
+	}
+
+	return PASS;
+}
+
+int32_t
+test29(void)
+{
+	static uint8_t ips[CMP_NB_IPS][16];
+	static uint8_t routes[CMP_NB_ROUTES][16];
+	static int32_t nh[CMP_NB_IPS], nh_ct[CMP_NB_IPS];
+	uint8_t depths[CMP_NB_ROUTES];
+	struct rte_lpm6 *lpm = NULL, *ct = NULL;
+	struct rte_lpm6_config config;
+	unsigned int i, j;
+	uint32_t next_hop;
+	int status, status_ct;
+
+	config.max_rules = MAX_RULES;
+	config.number_tbl8s = NUMBER_TBL8S;
+	config.flags = 0;
+	lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+
+	config.flags = RTE_LPM6_F_COMPACT;
+	ct = rte_lpm6_create("test29_ct", SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(ct != NULL);
+
+	for (i = 0; i < CMP_NB_ROUTES; i++) {
+		for (j = 0; j < 16; j++)
+			routes[i][j] = lrand48();
+		/* a few common prefixes so that the routes nest */
+		routes[i][0] = 0x20;
+		routes[i][1] = lrand48() % 4;
+		routes[i][2] = lrand48() % 2;
+		depths[i] = 1 + lrand48() % MAX_DEPTH;
+		next_hop = lrand48() & 0xFFFFF;
+
+		status = rte_lpm6_add(lpm, routes[i], depths[i], next_hop);
+		status_ct = rte_lpm6_add(ct, routes[i], depths[i], next_hop);
+		TEST_LPM_ASSERT(status == 0 && status_ct == 0);
+	}
+
+	for (i = 0; i < CMP_NB_IPS; i++) {
+		memcpy(ips[i], routes[lrand48() % CMP_NB_ROUTES], 16);
+		for (j = lrand48() % 16; j < 16; j++)
+			ips[i][j] = lrand48();
+	}
+
+	TEST_LPM_ASSERT(compare_lookups(lpm, ct, ips, nh, nh_ct) == PASS);
+
+	for (i = 0; i < CMP_NB_ROUTES; i += 2) {
+		status = rte_lpm6_delete(lpm, routes[i], depths[i]);
+		status_ct = rte_lpm6_delete(ct, routes[i], depths[i]);
+		TEST_LPM_ASSERT(status == status_ct);
+	}
+
+	TEST_LPM_ASSERT(compare_lookups(lpm, ct, ips, nh, nh_ct) == PASS);
+
+	rte_lpm6_delete_all(ct);
+	rte_lpm6_lookup_bulk_func(ct, ips, nh_ct, CMP_NB_IPS);
+	for (i = 0; i < CMP_NB_IPS; i++)
+		TEST_LPM_ASSERT(nh_ct[i] == -1);
+
+	rte_lpm6_free(lpm);
+	rte_lpm6_free(ct);
+
+	return PASS;
+}
+
+/*
+ * Look up stable routes from another lcore while random routes sharing
+ * their leading bits are added and deleted, on a compact table, and check
+ * that the lookups never return a wrong next hop.
+ */
+#define CONC_NB_STABLE	16
+#define CONC_NB_UPDATES	20000
+
+static struct rte_lpm6 *conc_lpm;
+static uint8_t conc_ips[CONC_NB_STABLE][16];
+static volatile int conc_done;
+static unsigned int conc_errors;
+
+static int
+test30_reader(__rte_unused void *arg)
+{
+	int32_t nh[CONC_NB_STABLE];
+	uint32_t next_hop;
+	unsigned int i;
+
+	while (!conc_done) {
+		for (i = 0; i < CONC_NB_STABLE; i++) {
+			if (rte_lpm6_lookup(conc_lpm, conc_ips[i],
+					&next_hop) != 0 || next_hop != 100 + i)
+				conc_errors++;
+		}
+		rte_lpm6_lookup_bulk_func(conc_lpm, conc_ips, nh,
+			CONC_NB_STABLE);
+		for (i = 0; i < CONC_NB_STABLE; i++) {
+			if (nh[i] != (int32_t)(100 + i))
+				conc_errors++;
+		}
+	}
+
+	return 0;
+}
+
+int32_t
+test30(void)
+{
+	static uint8_t routes[CONC_NB_UPDATES][16];
+	uint8_t depths[CONC_NB_UPDATES];
+	struct rte_lpm6_config config;
+	unsigned int i, j, lcore;
+	int status;
+
+	if ((lpm6_flags & RTE_LPM6_F_COMPACT) == 0)
+		return PASS;
+	lcore = rte_get_next_lcore(-1, 1, 0);
+	if (lcore >= RTE_MAX_LCORE) {
+		printf("Not enough lcores, skipping\n");
+		return PASS;
+	}
+
+	config.max_rules = MAX_RULES;
+	config.number_tbl8s = NUMBER_TBL8S;
+	config.flags = lpm6_flags;
+	conc_lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(conc_lpm != NULL);
+
+	/* 2001:db8:i::/48 -> 100 + i */
+	for (i = 0; i < CONC_NB_STABLE; i++) {
+		IPv6(conc_ips[i], 0x20, 0x01, 0x0d, 0xb8, 0, i, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 1);
+		status = rte_lpm6_add(conc_lpm, conc_ips[i], 48, 100 + i);
+		TEST_LPM_ASSERT(status == 0);
+		conc_ips[i][8] = lrand48();
+	}
+
+	conc_done = 0;
+	conc_errors = 0;
+	rte_eal_remote_launch(test30_reader, NULL, lcore);
+
+	/* random routes under 2001:db8:10::/44, a half of them deleted */
+	for (i = 0; i < CONC_NB_UPDATES && status == 0; i++) {
+		for (j = 0; j < 16; j++)
+			routes[i][j] = lrand48();
+		IPv6(routes[i], 0x20, 0x01, 0x0d, 0xb8, 0, 16 + lrand48() % 16,
+			routes[i][6], routes[i][7], routes[i][8],
+			routes[i][9], 0, 0, 0, 0, 0, 0);
+		depths[i] = 44 + lrand48() % 37;
+		status = rte_lpm6_add(conc_lpm, routes[i], depths[i],
+			lrand48() & 0xFFFFF);
+		if (i % 2 == 1) {
+			j = lrand48() % i;
+			rte_lpm6_delete(conc_lpm, routes[j], depths[j]);
+		}
+	}
+
+	conc_done = 1;
+	rte_eal_wait_lcore(lcore);
+
+	TEST_LPM_ASSERT(status == 0);
+	TEST_LPM_ASSERT(conc_errors == 0);
+	rte_lpm6_free(conc_lpm);
+
+	return PASS;
+}
+
+/*
+ * Do all unit tests, with the default and the compact tables.
  */
 static int
 test_lpm6(void)
 {
-	unsigned i;
+	static const int flags[] = { 0, RTE_LPM6_F_COMPACT };
+	unsigned i, f;
 	int status = -1, global_status = 0;
 
-	for (i = 0; i < RTE_DIM(tests6); i++) {
-		printf("# test %02d\n", i);
-		status = tests6[i]();
+	for (f = 0; f < RTE_DIM(flags); f++) {
+		lpm6_flags = flags[f];
+		printf("# flags 0x%x\n", lpm6_flags);
+
+		for (i = 0; i < RTE_DIM(tests6); i++) {
+			printf("# test %02d\n", i);
+			status = tests6[i]();
 
-		if (status < 0) {
-			printf("ERROR: LPM Test %s: FAIL\n", RTE_STR(tests6[i]));
-			global_status = status;
+			if (status < 0) {
+				printf("ERROR: LPM Test %s: FAIL\n",
+					RTE_STR(tests6[i]));
+				global_status = status;
+			}
 		}
 	}
 
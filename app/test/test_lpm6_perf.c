@@ -10,6 +10,8 @@
 #include <rte_cycles.h>
 #include <rte_random.h>
 #include <rte_memory.h>
+#include <rte_malloc.h>
+#include <rte_lcore.h>
 #include <rte_lpm6.h>
 
 #include "test.h"
@@ -50,8 +52,18 @@ print_route_distribution(const struct rules_tbl_entry *table, uint32_t n)
 	printf("\n");
 }
 
+static size_t
+heap_allocated(void)
+{
+	struct rte_malloc_socket_stats stats;
+
+	if (rte_malloc_get_socket_stats(rte_socket_id(), &stats) < 0)
+		return 0;
+	return stats.heap_allocsz_bytes;
+}
+
 static int
-test_lpm6_perf(void)
+test_lpm6_perf_flags(int flags)
 {
 	struct rte_lpm6 *lpm = NULL;
 	struct rte_lpm6_config config;
@@ -60,23 +72,17 @@ test_lpm6_perf(void)
 	uint32_t next_hop_add = 0xAA, next_hop_return = 0;
 	int status = 0;
 	int64_t count = 0;
+	size_t mem_used;
 
 	config.max_rules = 1000000;
 	config.number_tbl8s = NUMBER_TBL8S;
-	config.flags = 0;
-
-	rte_srand(rte_rdtsc());
-
-	printf("No. routes = %u\n", (unsigned) NUM_ROUTE_ENTRIES);
+	config.flags = flags;
 
-	print_route_distribution(large_route_table, (uint32_t) NUM_ROUTE_ENTRIES);
+	printf("\nLPM6 flags = 0x%x\n", flags);
 
-	/* Only generate IPv6 address of each item in large IPS table,
-	 * here next_hop is not needed.
-	 */
-	generate_large_ips_table(0);
+	mem_used = heap_allocated();
 
-	lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
+	lpm = rte_lpm6_create(__func__, rte_socket_id(), &config);
 	TEST_LPM_ASSERT(lpm != NULL);
 
 	/* Measure add. */
@@ -93,6 +99,7 @@ test_lpm6_perf(void)
 	printf("Unique added entries = %d\n", status);
 	printf("Average LPM Add: %g cycles\n",
 			(double)total_time / NUM_ROUTE_ENTRIES);
+	printf("Memory used: %zu KB\n", (heap_allocated() - mem_used) / 1024);
 
 	/* Measure single Lookup */
 	total_time = 0;
@@ -160,4 +167,24 @@ test_lpm6_perf(void)
 	return 0;
 }
 
+static int
+test_lpm6_perf(void)
+{
+	rte_srand(rte_rdtsc());
+
+	printf("No. routes = %u\n", (unsigned) NUM_ROUTE_ENTRIES);
+
+	print_route_distribution(large_route_table, (uint32_t) NUM_ROUTE_ENTRIES);
+
+	/* Only generate IPv6 address of each item in large IPS table,
+	 * here next_hop is not needed.
+	 */
+	generate_large_ips_table(0);
+
+	if (test_lpm6_perf_flags(0) < 0)
+		return -1;
+
+	return test_lpm6_perf_flags(RTE_LPM6_F_COMPACT);
+}
+
 REGISTER_TEST_COMMAND(lpm6_perf_autotest, test_lpm6_perf);
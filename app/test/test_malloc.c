@@ -371,6 +371,74 @@ test_multi_alloc_statistics(void)
 	return 0;
 }
 
+static int
+test_malloc_cache(void)
+{
+	struct rte_malloc_socket_stats pre_stats, post_stats;
+	void *ptrs[2 * RTE_MALLOC_CACHE_MAX_SIZE];
+	int socket = rte_socket_id();
+	unsigned int i, n = 0;
+	char *ptr, *zptr;
+	int ret = -1;
+
+	if (rte_malloc_cache_enable(0) == 0 || rte_malloc_cache_enable(
+			RTE_MALLOC_CACHE_MAX_SIZE + 1) == 0) {
+		printf("Invalid cache size accepted\n");
+		return -1;
+	}
+
+	rte_malloc_get_socket_stats(socket, &pre_stats);
+
+	if (rte_malloc_cache_enable(16) < 0)
+		return -1;
+
+	/* a freed element is reused by the next allocation of its class */
+	ptr = rte_malloc(NULL, 100, 0);
+	if (ptr == NULL)
+		goto err_return;
+	memset(ptr, 0xa5, 100);
+	rte_free(ptr);
+
+	zptr = rte_zmalloc(NULL, 120, 0);
+	if (zptr == NULL)
+		goto err_return;
+	if (zptr != ptr) {
+		printf("Cached element was not reused\n");
+		rte_free(zptr);
+		goto err_return;
+	}
+	for (i = 0; i < 120; i++) {
+		if (zptr[i] != 0) {
+			printf("Cached element was not zeroed\n");
+			rte_free(zptr);
+			goto err_return;
+		}
+	}
+	rte_free(zptr);
+
+	/* more elements than the cache holds go back to the heap */
+	for (n = 0; n < RTE_DIM(ptrs); n++) {
+		ptrs[n] = rte_malloc(NULL, 1000, 0);
+		if (ptrs[n] == NULL)
+			goto err_return;
+	}
+	ret = 0;
+
+err_return:
+	while (n > 0)
+		rte_free(ptrs[--n]);
+
+	rte_malloc_cache_flush();
+	rte_malloc_get_socket_stats(socket, &post_stats);
+	if (post_stats.alloc_count != pre_stats.alloc_count) {
+		printf("Cached elements were not flushed\n");
+		ret = -1;
+	}
+
+	rte_malloc_cache_disable();
+	return ret;
+}
+
 static int
 test_realloc(void)
 {
@@ -954,6 +1022,14 @@ test_malloc(void)
 	}
 	else printf("test_alloc_socket() passed\n");
 
+	ret = test_malloc_cache();
+	if (ret < 0) {
+		printf("test_malloc_cache() failed\n");
+		return ret;
+	}
+	else
+		printf("test_malloc_cache() passed\n");
+
 	ret = test_multi_alloc_statistics();
 	if (ret < 0) {
 		printf("test_multi_alloc_statistics() failed\n");
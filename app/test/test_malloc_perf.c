@@ -0,0 +1,162 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+
+#include <rte_atomic.h>
+#include <rte_cycles.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_pause.h>
+
+#include "test.h"
+
+/*
+ * Malloc performance
+ * ==================
+ *
+ * Each lcore allocates *MAX_ALLOCS* objects of a given size with
+ * rte_malloc() and frees them with rte_free(), during TIME_MS
+ * milliseconds. This is done on one lcore and on all lcores, with the
+ * per-lcore malloc caches disabled and enabled, and the total number of
+ * alloc/free pairs per second is reported.
+ */
+
+#define MAX_ALLOCS 32
+#define TIME_MS 1000
+#define CACHE_SIZE 32
+
+static const size_t alloc_sizes[] = {64, 512, 4096};
+
+static rte_atomic32_t synchro;
+
+static size_t alloc_size;
+
+struct malloc_perf_stats {
+	uint64_t pairs;
+	int ret;
+} __rte_cache_aligned;
+
+static struct malloc_perf_stats stats[RTE_MAX_LCORE];
+
+static int
+per_lcore_malloc_perf(__attribute__((unused)) void *arg)
+{
+	struct malloc_perf_stats *st = &stats[rte_lcore_id()];
+	uint64_t hz = rte_get_timer_hz();
+	uint64_t end_cycles;
+	void *ptrs[MAX_ALLOCS];
+	unsigned int i;
+
+	st->pairs = 0;
+	st->ret = 0;
+
+	while (rte_atomic32_read(&synchro) == 0)
+		rte_pause();
+
+	end_cycles = rte_get_timer_cycles() + hz * TIME_MS / 1000;
+
+	while (rte_get_timer_cycles() < end_cycles) {
+		for (i = 0; i < MAX_ALLOCS; i++) {
+			ptrs[i] = rte_malloc(NULL, alloc_size, 0);
+			if (ptrs[i] == NULL)
+				break;
+		}
+		st->pairs += i;
+		if (i != MAX_ALLOCS)
+			st->ret = -1;
+		while (i > 0)
+			rte_free(ptrs[--i]);
+		if (st->ret < 0)
+			break;
+	}
+
+	/* return the memory held by this lcore, as an idle lcore would */
+	rte_malloc_cache_flush();
+
+	return 0;
+}
+
+static int
+run_on_lcores(unsigned int cores)
+{
+	unsigned int lcore_id, n;
+	uint64_t pairs = 0;
+	int ret = 0;
+
+	rte_atomic32_set(&synchro, 0);
+
+	n = 1;
+	RTE_LCORE_FOREACH_SLAVE(lcore_id) {
+		if (n++ == cores)
+			break;
+		rte_eal_remote_launch(per_lcore_malloc_perf, NULL, lcore_id);
+	}
+
+	rte_atomic32_set(&synchro, 1);
+	per_lcore_malloc_perf(NULL);
+
+	rte_eal_mp_wait_lcore();
+
+	RTE_LCORE_FOREACH(lcore_id) {
+		pairs += stats[lcore_id].pairs;
+		if (stats[lcore_id].ret < 0)
+			ret = -1;
+		stats[lcore_id].pairs = 0;
+		stats[lcore_id].ret = 0;
+	}
+
+	if (ret < 0) {
+		printf("allocation of %zu bytes failed\n", alloc_size);
+		return -1;
+	}
+
+	printf("  size=%-5zu cores=%-3u alloc/free per sec: %" PRIu64 "\n",
+	       alloc_size, cores, pairs * 1000 / TIME_MS);
+
+	return 0;
+}
+
+static int
+run_all_sizes(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < RTE_DIM(alloc_sizes); i++) {
+		alloc_size = alloc_sizes[i];
+		if (run_on_lcores(1) < 0)
+			return -1;
+		if (rte_lcore_count() > 1 &&
+				run_on_lcores(rte_lcore_count()) < 0)
+			return -1;
+	}
+
+	return 0;
+}
+
+static int
+test_malloc_perf(void)
+{
+	int ret;
+
+	rte_atomic32_init(&synchro);
+
+	printf("### Without per-lcore caches ###\n");
+	if (run_all_sizes() < 0)
+		return -1;
+
+	printf("### With per-lcore caches of %u elements ###\n", CACHE_SIZE);
+	if (rte_malloc_cache_enable(CACHE_SIZE) < 0) {
+		printf("cannot enable per-lcore caches\n");
+		return -1;
+	}
+	ret = run_all_sizes();
+	rte_malloc_cache_disable();
+
+	return ret;
+}
+
+REGISTER_TEST_COMMAND(malloc_perf_autotest, test_malloc_perf);
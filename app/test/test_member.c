@@ -665,6 +665,227 @@ test_member_loadfactor(void)
 	return 0;
 }
 
+/*
+ * Cuckoo filter: lookups, deletes, multiple matches and load factor.
+ */
+static int
+test_member_cf(void)
+{
+	struct rte_member_setsum *setsum_cf;
+	struct rte_member_parameters cf_params = params;
+	member_set_t set_ids[MAX_MATCH];
+	member_set_t set_ids_m[NUM_SAMPLES][MAX_MATCH];
+	member_set_t set_ids_bulk[NUM_SAMPLES];
+	uint32_t match_count[NUM_SAMPLES];
+	const void *key_array[NUM_SAMPLES];
+	unsigned int added_keys, i, j;
+	member_set_t set_id;
+	int ret;
+
+	cf_params.name = "test_member_cf";
+	cf_params.type = RTE_MEMBER_TYPE_CF;
+	cf_params.key_len = sizeof(struct flow_key);
+
+	printf("Expected error section begin...\n");
+	cf_params.num_set = 0;
+	setsum_cf = rte_member_create(&cf_params);
+	TEST_ASSERT(setsum_cf == NULL, "CF created with 0 set");
+	cf_params.num_set = 0x8000;
+	setsum_cf = rte_member_create(&cf_params);
+	TEST_ASSERT(setsum_cf == NULL, "CF created with too many sets");
+	printf("Expected error section end...\n");
+
+	cf_params.num_set = 16;
+	setsum_cf = rte_member_create(&cf_params);
+	TEST_ASSERT(setsum_cf != NULL, "CF creation failed");
+
+	TEST_ASSERT(rte_member_add(setsum_cf, &keys[0], 0) == -EINVAL &&
+			rte_member_add(setsum_cf, &keys[0], 17) == -EINVAL,
+			"CF insert with invalid set id");
+
+	for (i = 0; i < NUM_SAMPLES; i++) {
+		ret = rte_member_add(setsum_cf, &keys[i], test_set[i]);
+		TEST_ASSERT(ret >= 0, "CF insert error");
+		key_array[i] = &keys[i];
+	}
+	for (i = 0; i < NUM_SAMPLES; i++) {
+		ret = rte_member_lookup(setsum_cf, &keys[i], &set_id);
+		TEST_ASSERT(ret == 1 && set_id == test_set[i],
+				"CF single lookup error");
+	}
+	ret = rte_member_lookup_bulk(setsum_cf, key_array, NUM_SAMPLES,
+			set_ids_bulk);
+	TEST_ASSERT(ret == NUM_SAMPLES, "CF bulk lookup error");
+	for (i = 0; i < NUM_SAMPLES; i++)
+		TEST_ASSERT(set_ids_bulk[i] == test_set[i],
+				"CF bulk lookup set value error");
+
+	for (i = 0; i < NUM_SAMPLES; i++) {
+		ret = rte_member_delete(setsum_cf, &keys[i], test_set[i]);
+		TEST_ASSERT(ret == 0, "CF delete error");
+		ret = rte_member_delete(setsum_cf, &keys[i], test_set[i]);
+		TEST_ASSERT(ret == -ENOENT, "CF deleted key deleted again");
+		ret = rte_member_lookup(setsum_cf, &keys[i], &set_id);
+		TEST_ASSERT(ret == 0 && set_id == RTE_MEMBER_NO_MATCH,
+				"CF deleted key found");
+	}
+
+	/* Keys of an empty filter are in their primary bucket in order */
+	for (i = M_MATCH_S; i <= M_MATCH_E; i += M_MATCH_STEP) {
+		for (j = 0; j < NUM_SAMPLES; j++) {
+			ret = rte_member_add(setsum_cf, &keys[j], i);
+			TEST_ASSERT(ret >= 0, "CF insert error");
+		}
+	}
+	for (i = 0; i < NUM_SAMPLES; i++) {
+		ret = rte_member_lookup_multi(setsum_cf, &keys[i], MAX_MATCH,
+				set_ids);
+		TEST_ASSERT(ret == M_MATCH_CNT, "CF lookup_multi error");
+		for (j = 1; j <= M_MATCH_CNT; j++)
+			TEST_ASSERT(set_ids[j - 1] == j * M_MATCH_STEP - 1,
+					"CF lookup_multi set value error");
+	}
+	ret = rte_member_lookup_multi_bulk(setsum_cf, key_array, NUM_SAMPLES,
+			MAX_MATCH, match_count, (member_set_t *)set_ids_m);
+	TEST_ASSERT(ret == NUM_SAMPLES, "CF lookup_multi_bulk error");
+	for (i = 0; i < NUM_SAMPLES; i++) {
+		TEST_ASSERT(match_count[i] == M_MATCH_CNT,
+				"CF lookup_multi_bulk match count error");
+		for (j = 1; j <= M_MATCH_CNT; j++)
+			TEST_ASSERT(set_ids_m[i][j - 1] == j * M_MATCH_STEP - 1,
+				"CF lookup_multi_bulk set value error");
+	}
+	rte_member_free(setsum_cf);
+
+	/* Fill a filter smaller than the generated keys */
+	cf_params.key_len = KEY_SIZE;
+	cf_params.num_keys = MAX_ENTRIES / 4;
+	setsum_cf = rte_member_create(&cf_params);
+	TEST_ASSERT(setsum_cf != NULL, "CF creation failed");
+	ret = add_generated_keys(setsum_cf, &added_keys);
+	TEST_ASSERT(ret == -ENOSPC, "Unexpected error when adding keys");
+	/* The key which did not fit is not counted */
+	added_keys--;
+	for (i = 0; i < added_keys; i++) {
+		ret = rte_member_lookup(setsum_cf, &generated_keys[i],
+				&set_id);
+		TEST_ASSERT(ret == 1, "CF false negative after full");
+	}
+	printf("\nKeys inserted when no space(CF) = %u for %u keys "
+		"requested\n", added_keys, cf_params.num_keys);
+	TEST_ASSERT(added_keys >= cf_params.num_keys,
+			"CF full before the requested number of keys");
+
+	rte_member_free(setsum_cf);
+	return 0;
+}
+
+/*
+ * Sketch: estimated counts and heavy hitters.
+ */
+#define SKETCH_TOPK 4
+#define SKETCH_LIGHT_KEYS 10000
+static int
+test_member_sketch(void)
+{
+	struct rte_member_setsum *setsum_sketch;
+	struct rte_member_parameters sketch_params = params;
+	uint64_t counts[SKETCH_TOPK], count, total = 0;
+	void *hh_keys[SKETCH_TOPK];
+	const void *key_array[SKETCH_TOPK];
+	uint64_t bulk_counts[SKETCH_TOPK];
+	member_set_t set_id;
+	unsigned int i, j;
+	int ret;
+
+	sketch_params.name = "test_member_sketch";
+	sketch_params.type = RTE_MEMBER_TYPE_SKETCH;
+	sketch_params.key_len = KEY_SIZE;
+	sketch_params.false_positive_rate = 0.01;
+	sketch_params.error_rate = 0.001;
+
+	printf("Expected error section begin...\n");
+	sketch_params.top_k = RTE_MEMBER_SKETCH_TOPK_MAX + 1;
+	setsum_sketch = rte_member_create(&sketch_params);
+	TEST_ASSERT(setsum_sketch == NULL, "sketch created with large top_k");
+	sketch_params.top_k = SKETCH_TOPK;
+	sketch_params.error_rate = 0;
+	setsum_sketch = rte_member_create(&sketch_params);
+	TEST_ASSERT(setsum_sketch == NULL, "sketch created with 0 error");
+	printf("Expected error section end...\n");
+
+	sketch_params.error_rate = 0.001;
+	setsum_sketch = rte_member_create(&sketch_params);
+	TEST_ASSERT(setsum_sketch != NULL, "sketch creation failed");
+
+	/* Heavy key i is seen 1000 + 100 * i times, interleaved */
+	for (j = 0; j < 10; j++) {
+		for (i = 0; i < SKETCH_TOPK; i++) {
+			ret = rte_member_add_count(setsum_sketch,
+					generated_keys[i], 100 + 10 * i);
+			TEST_ASSERT(ret == 0, "sketch add count error");
+			total += 100 + 10 * i;
+		}
+		for (i = 0; i < SKETCH_LIGHT_KEYS / 10; i++) {
+			ret = rte_member_add(setsum_sketch, generated_keys[
+				SKETCH_TOPK + j * SKETCH_LIGHT_KEYS / 10 + i],
+				1);
+			TEST_ASSERT(ret == 0, "sketch add error");
+			total++;
+		}
+	}
+
+	for (i = 0; i < SKETCH_TOPK; i++) {
+		ret = rte_member_query_count(setsum_sketch, generated_keys[i],
+				&count);
+		TEST_ASSERT(ret == 0, "sketch query error");
+		TEST_ASSERT(count >= 1000 + 100 * i &&
+				count <= 1000 + 100 * i +
+					sketch_params.error_rate * total,
+				"sketch estimated count out of bounds");
+		key_array[i] = generated_keys[i];
+	}
+	ret = rte_member_query_count_bulk(setsum_sketch, key_array,
+			SKETCH_TOPK, bulk_counts);
+	TEST_ASSERT(ret == 0, "sketch bulk query error");
+	for (i = 0; i < SKETCH_TOPK; i++) {
+		rte_member_query_count(setsum_sketch, generated_keys[i],
+				&count);
+		TEST_ASSERT(bulk_counts[i] == count,
+				"sketch bulk query count error");
+	}
+
+	ret = rte_member_report_heavyhitter(setsum_sketch, hh_keys, counts);
+	TEST_ASSERT(ret == SKETCH_TOPK, "wrong number of heavy hitters");
+	for (i = 0; i < SKETCH_TOPK; i++)
+		TEST_ASSERT(memcmp(hh_keys[i],
+				generated_keys[SKETCH_TOPK - 1 - i],
+				KEY_SIZE) == 0,
+				"wrong heavy hitter");
+
+	ret = rte_member_lookup(setsum_sketch, generated_keys[0], &set_id);
+	TEST_ASSERT(ret == 1 && set_id == 1, "heavy hitter not found");
+	ret = rte_member_lookup(setsum_sketch, generated_keys[SKETCH_TOPK],
+			&set_id);
+	TEST_ASSERT(ret == 0 && set_id == RTE_MEMBER_NO_MATCH,
+			"light key found as heavy hitter");
+
+	TEST_ASSERT(rte_member_delete(setsum_sketch, generated_keys[0], 1) ==
+			-EINVAL, "sketch does not support deletion");
+	TEST_ASSERT(rte_member_add_count(setsum_ht, generated_keys[0], 1) ==
+			-EINVAL, "HT does not support counting");
+
+	rte_member_reset(setsum_sketch);
+	rte_member_query_count(setsum_sketch, generated_keys[0], &count);
+	TEST_ASSERT(count == 0, "count not reset");
+	ret = rte_member_report_heavyhitter(setsum_sketch, hh_keys, counts);
+	TEST_ASSERT(ret == 0, "heavy hitters not reset");
+
+	rte_member_free(setsum_sketch);
+	printf("sketch success\n");
+	return 0;
+}
+
 static void
 perform_free(void)
 {
@@ -707,6 +928,11 @@ test_member(void)
 		rte_member_free(setsum_cache);
 		return -1;
 	}
+	if (test_member_cf() < 0 || test_member_sketch() < 0) {
+		rte_member_free(setsum_ht);
+		rte_member_free(setsum_cache);
+		return -1;
+	}
 
 	perform_free();
 	return 0;
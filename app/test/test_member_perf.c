@@ -24,6 +24,8 @@
 #define VBF_SET_CNT 16
 #define BURST_SIZE 64
 #define VBF_FALSE_RATE 0.03
+#define SKETCH_TOPK 16
+#define SKETCH_ERROR_RATE 0.0001
 
 static unsigned int test_socket_id;
 
@@ -31,9 +33,21 @@ enum sstype {
 	HT = 0,
 	CACHE,
 	VBF,
+	CF,
 	NUM_TYPE
 };
 
+static const char *const sstype_name[NUM_TYPE] = {
+	"HT", "CACHE", "VBF", "CF"
+};
+
+enum sketch_operations {
+	SKETCH_ADD = 0,
+	SKETCH_QUERY,
+	SKETCH_QUERY_BULK,
+	NUM_SKETCH_OPERATIONS
+};
+
 enum operations {
 	ADD = 0,
 	LOOKUP,
@@ -75,6 +89,12 @@ static uint64_t false_hit[NUM_TYPE][NUM_KEYSIZES];
 
 static member_set_t data[NUM_TYPE][/* Array to store the data */KEYS_TO_ADD];
 
+/* Array to store number of cycles per sketch operation */
+static uint64_t sketch_cycles[NUM_KEYSIZES][NUM_SKETCH_OPERATIONS];
+
+/* Index of the key of each packet counted by the sketch */
+static uint32_t sketch_stream[NUM_LOOKUPS];
+
 /* Array to store all input keys */
 static uint8_t keys[KEYS_TO_ADD][MAX_KEYSIZE];
 
@@ -139,7 +159,7 @@ setup_keys_and_data(struct member_perf_params *params, unsigned int cycle,
 			keys[i][j] = rte_rand() & 0xFF;
 
 		data[HT][i] = data[CACHE][i] = (rte_rand() & 0x7FFE) + 1;
-		data[VBF][i] = rte_rand() % VBF_SET_CNT + 1;
+		data[VBF][i] = data[CF][i] = rte_rand() % VBF_SET_CNT + 1;
 	}
 
 	/* Remove duplicates from the keys array */
@@ -197,6 +217,13 @@ setup_keys_and_data(struct member_perf_params *params, unsigned int cycle,
 	params->setsum[VBF] = rte_member_create(&member_params);
 	if (params->setsum[VBF] == NULL)
 		fprintf(stderr, "VBF create fail\n");
+
+	/* Like vBF, CF is sized from the expected number of keys */
+	member_params.name = "test_member_cf";
+	member_params.type = RTE_MEMBER_TYPE_CF;
+	params->setsum[CF] = rte_member_create(&member_params);
+	if (params->setsum[CF] == NULL)
+		fprintf(stderr, "CF create fail\n");
 	for (i = 0; i < NUM_TYPE; i++) {
 		if (params->setsum[i] == NULL)
 			return -1;
@@ -251,8 +278,10 @@ timed_lookups(struct member_perf_params *params, int type)
 				printf("lookup wrong internally");
 				return -1;
 			}
-			if (type == HT && result == RTE_MEMBER_NO_MATCH) {
-				printf("HT mode shouldn't have false negative");
+			if ((type == HT || type == CF) &&
+					result == RTE_MEMBER_NO_MATCH) {
+				printf("HT and CF modes shouldn't have false "
+					"negative");
 				return -1;
 			}
 			if (result != data[type][j])
@@ -295,9 +324,10 @@ timed_lookups_bulk(struct member_perf_params *params, int type)
 			}
 			for (k = 0; k < BURST_SIZE; k++) {
 				uint32_t data_idx = j * BURST_SIZE + k;
-				if (type == HT && result[k] ==
+				if ((type == HT || type == CF) &&
+						result[k] ==
 						RTE_MEMBER_NO_MATCH) {
-					printf("HT mode shouldn't have "
+					printf("HT and CF modes shouldn't have "
 						"false negative");
 					return -1;
 				}
@@ -333,8 +363,9 @@ timed_lookups_multimatch(struct member_perf_params *params, int type)
 				printf("lookup multi has wrong return value %d,"
 					"type %d\n", ret, type);
 			}
-			if (type == HT && ret == 0) {
-				printf("HT mode shouldn't have false negative");
+			if ((type == HT || type == CF) && ret == 0) {
+				printf("HT and CF modes shouldn't have false "
+					"negative");
 				return -1;
 			}
 			/*
@@ -389,8 +420,9 @@ timed_lookups_multimatch_bulk(struct member_perf_params *params, int type)
 						"wrong match count\n");
 					return -1;
 				}
-				if (type == HT && match_count[k] == 0) {
-					printf("HT mode shouldn't have "
+				if ((type == HT || type == CF) &&
+						match_count[k] == 0) {
+					printf("HT and CF modes shouldn't have "
 						"false negative");
 					return -1;
 				}
@@ -482,6 +514,81 @@ timed_miss_lookup(struct member_perf_params *params, int type)
 	return 0;
 }
 
+/*
+ * Count a stream of packets where half of the packets belong to
+ * SKETCH_TOPK heavy flows, check that they are reported as heavy hitters.
+ */
+static int
+timed_sketch(struct member_perf_params *params)
+{
+	struct rte_member_parameters sketch_params = member_params;
+	struct rte_member_setsum *setsum;
+	uint64_t counts[BURST_SIZE];
+	void *hh_keys[SKETCH_TOPK];
+	const void *keys_burst[BURST_SIZE];
+	uint64_t start_tsc;
+	unsigned int i, j, found;
+	int ret;
+
+	sketch_params.name = "test_member_sketch";
+	sketch_params.type = RTE_MEMBER_TYPE_SKETCH;
+	sketch_params.key_len = params->key_size;
+	sketch_params.false_positive_rate = 0.01;
+	sketch_params.error_rate = SKETCH_ERROR_RATE;
+	sketch_params.top_k = SKETCH_TOPK;
+	setsum = rte_member_create(&sketch_params);
+	if (setsum == NULL) {
+		printf("sketch create fail\n");
+		return -1;
+	}
+
+	for (i = 0; i < NUM_LOOKUPS; i++)
+		sketch_stream[i] = (rte_rand() & 1) ?
+			rte_rand() % SKETCH_TOPK : rte_rand() % KEYS_TO_ADD;
+
+	start_tsc = rte_rdtsc();
+	for (i = 0; i < NUM_LOOKUPS; i++)
+		rte_member_add(setsum, &keys[sketch_stream[i]], 1);
+	sketch_cycles[params->cycle][SKETCH_ADD] =
+		(rte_rdtsc() - start_tsc) / NUM_LOOKUPS;
+
+	start_tsc = rte_rdtsc();
+	for (i = 0; i < KEYS_TO_ADD; i++)
+		rte_member_query_count(setsum, &keys[i], &counts[0]);
+	sketch_cycles[params->cycle][SKETCH_QUERY] =
+		(rte_rdtsc() - start_tsc) / KEYS_TO_ADD;
+
+	start_tsc = rte_rdtsc();
+	for (i = 0; i < KEYS_TO_ADD / BURST_SIZE; i++) {
+		for (j = 0; j < BURST_SIZE; j++)
+			keys_burst[j] = keys[i * BURST_SIZE + j];
+		rte_member_query_count_bulk(setsum, keys_burst, BURST_SIZE,
+				counts);
+	}
+	sketch_cycles[params->cycle][SKETCH_QUERY_BULK] =
+		(rte_rdtsc() - start_tsc) / KEYS_TO_ADD;
+
+	ret = rte_member_report_heavyhitter(setsum, hh_keys, counts);
+	found = 0;
+	for (i = 0; i < (unsigned int)RTE_MAX(ret, 0); i++) {
+		for (j = 0; j < SKETCH_TOPK; j++) {
+			if (memcmp(hh_keys[i], keys[j],
+					params->key_size) == 0) {
+				found++;
+				break;
+			}
+		}
+	}
+	rte_member_free(setsum);
+
+	if (found != SKETCH_TOPK) {
+		printf("sketch found %u heavy hitters out of %u\n", found,
+			SKETCH_TOPK);
+		return -1;
+	}
+	return 0;
+}
+
 static void
 perform_frees(struct member_perf_params *params)
 {
@@ -571,6 +678,20 @@ run_all_tbl_perf_tests(void)
 		perform_frees(&params);
 	}
 
+	/* Count-min sketch, heavy hitter detection */
+	for (i = 0; i < NUM_KEYSIZES; i++) {
+		if (setup_keys_and_data(&params, i, 0) < 0) {
+			printf("Could not create keys/data/table\n");
+			return -1;
+		}
+		perform_frees(&params);
+		if (timed_sketch(&params) < 0) {
+			printf("<<<<<Test timed_sketch failed at keysize %d"
+				">>>>>\n", hashtest_key_lens[i]);
+			return -1;
+		}
+	}
+
 	printf("\nResults (in CPU cycles/operation)\n");
 	printf("-----------------------------------\n");
 	printf("\n%-18s%-18s%-18s%-18s%-18s%-18s%-18s%-18s%-18s\n",
@@ -580,7 +701,7 @@ run_all_tbl_perf_tests(void)
 	for (i = 0; i < NUM_KEYSIZES; i++) {
 		for (j = 0; j < NUM_TYPE; j++) {
 			printf("%-18d", hashtest_key_lens[i]);
-			printf("%-18d", j);
+			printf("%-18s", sstype_name[j]);
 			for (k = 0; k < NUM_OPERATIONS; k++)
 				printf("%-18"PRIu64, cycles[j][i][k]);
 			printf("\n");
@@ -596,7 +717,7 @@ run_all_tbl_perf_tests(void)
 	for (i = 0; i < 1; i++) {
 		for (j = 0; j < NUM_TYPE; j++) {
 			printf("%-18d", hashtest_key_lens[i]);
-			printf("%-18d", j);
+			printf("%-18s", sstype_name[j]);
 			printf("%-18f", (float)false_data[j][i] / NUM_LOOKUPS);
 			printf("%-18f", (float)false_data_bulk[j][i] /
 						NUM_LOOKUPS);
@@ -609,6 +730,17 @@ run_all_tbl_perf_tests(void)
 			printf("\n");
 		}
 	}
+
+	printf("\nSketch results (in CPU cycles/operation)\n");
+	printf("-----------------------------------\n");
+	printf("\n%-18s%-18s%-18s%-18s\n",
+			"Keysize", "Add", "Query", "Query_bulk");
+	for (i = 0; i < NUM_KEYSIZES; i++) {
+		printf("%-18d", hashtest_key_lens[i]);
+		for (k = 0; k < NUM_SKETCH_OPERATIONS; k++)
+			printf("%-18"PRIu64, sketch_cycles[i][k]);
+		printf("\n");
+	}
 	return 0;
 }
 
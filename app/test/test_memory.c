@@ -4,6 +4,8 @@
 
 #include <stdio.h>
 #include <stdint.h>
+#include <inttypes.h>
+#include <errno.h>
 
 #include <rte_eal.h>
 #include <rte_memory.h>
@@ -22,6 +24,8 @@
  * - Check that memory size is different than 0.
  *
  * - Try to read all memory; it should not segfault.
+ *
+ * - Check that the EAL init statistics are available.
  */
 
 static int
@@ -72,6 +76,7 @@ check_seg_fds(const struct rte_memseg_list *msl, const struct rte_memseg *ms,
 static int
 test_memory(void)
 {
+	struct rte_eal_init_stats stats;
 	uint64_t s;
 	int ret;
 
@@ -101,6 +106,20 @@ test_memory(void)
 		return -1;
 	}
 
+	/* check init statistics */
+	if (rte_eal_init_stats_get(NULL) != -EINVAL) {
+		printf("Init statistics accepted a NULL pointer\n");
+		return -1;
+	}
+	if (rte_eal_init_stats_get(&stats) != 0 || stats.init_time_us == 0) {
+		printf("Error getting init statistics\n");
+		return -1;
+	}
+	printf("EAL init: %" PRIu64 " us, memory: %" PRIu64 " us, "
+		"%" PRIu64 " pages, %" PRIu64 " threads\n",
+		stats.init_time_us, stats.mem_init_time_us,
+		stats.mem_init_pages, stats.mem_init_threads);
+
 	return 0;
 }
 
@@ -418,6 +418,101 @@ test_mempool_basic_ex(struct rte_mempool *mp)
 	return ret;
 }
 
+#define ADAPT_CACHE_SIZE 32
+#define ADAPT_BURST 48
+#define ADAPT_MAX_OBJS 64
+
+/* check the cache statistics, and the adaptive cache size */
+static int
+test_mempool_cache_stats_adaptive(void)
+{
+	struct rte_mempool *mp;
+	struct rte_mempool_cache_stats stats;
+	void *objs[RTE_MEMPOOL_CACHE_MAX_SIZE];
+	unsigned int lcore_id = rte_lcore_id();
+	uint32_t obj_size, size;
+	unsigned int i;
+	int ret = -1;
+
+	mp = rte_mempool_create("test_cache_adaptive", MEMPOOL_SIZE,
+		MEMPOOL_ELT_SIZE, ADAPT_CACHE_SIZE, 0, NULL, NULL, NULL, NULL,
+		SOCKET_ID_ANY, 0);
+	if (mp == NULL)
+		RET_ERR();
+
+	if (rte_mempool_cache_stats_get(mp, RTE_MAX_LCORE, &stats) !=
+			-EINVAL)
+		GOTO_ERR(ret, out);
+
+	/* refill of the empty cache, then a put and a get from the cache */
+	rte_mempool_cache_stats_reset(mp);
+	if (rte_mempool_get(mp, &objs[0]) < 0)
+		GOTO_ERR(ret, out);
+	rte_mempool_put(mp, objs[0]);
+	if (rte_mempool_get(mp, &objs[0]) < 0)
+		GOTO_ERR(ret, out);
+	rte_mempool_put(mp, objs[0]);
+	if (rte_mempool_cache_stats_get(mp, lcore_id, &stats) < 0)
+		GOTO_ERR(ret, out);
+	if (stats.get_misses != 1 || stats.get_hits != 1 ||
+			stats.put_hits != 2 || stats.put_misses != 0 ||
+			stats.size != ADAPT_CACHE_SIZE)
+		GOTO_ERR(ret, out);
+
+	obj_size = mp->header_size + mp->elt_size + mp->trailer_size;
+	if (rte_mempool_cache_adaptive_enable(mp,
+			ADAPT_MAX_OBJS * obj_size) < 0)
+		GOTO_ERR(ret, out);
+
+	/* bursts larger than the cache miss, it grows up to the cap */
+	for (i = 0; i < 4 * RTE_MEMPOOL_CACHE_ADAPT_PERIOD; i++) {
+		if (rte_mempool_get_bulk(mp, objs, ADAPT_BURST) < 0)
+			GOTO_ERR(ret, out);
+		rte_mempool_put_bulk(mp, objs, ADAPT_BURST);
+	}
+	if (rte_mempool_cache_stats_get(mp, lcore_id, &stats) < 0)
+		GOTO_ERR(ret, out);
+	printf("adaptive cache grown to %u objects\n", stats.size);
+	if (stats.size <= ADAPT_CACHE_SIZE ||
+			stats.size > ADAPT_CACHE_SIZE + ADAPT_MAX_OBJS)
+		GOTO_ERR(ret, out);
+
+	/* only hits, the cache shrinks on the next miss */
+	size = stats.size;
+	for (i = 0; i < RTE_MEMPOOL_CACHE_ADAPT_PERIOD *
+			RTE_MEMPOOL_CACHE_ADAPT_SHRINK_RATIO; i++) {
+		if (rte_mempool_get(mp, &objs[0]) < 0)
+			GOTO_ERR(ret, out);
+		rte_mempool_put(mp, objs[0]);
+	}
+	if (rte_mempool_get_bulk(mp, objs, size) < 0)
+		GOTO_ERR(ret, out);
+	rte_mempool_put_bulk(mp, objs, size);
+	if (rte_mempool_cache_stats_get(mp, lcore_id, &stats) < 0)
+		GOTO_ERR(ret, out);
+	printf("adaptive cache shrunk to %u objects\n", stats.size);
+	if (stats.size != RTE_MAX(size / 2, (uint32_t)ADAPT_CACHE_SIZE))
+		GOTO_ERR(ret, out);
+
+	/* the shrink gave the objects back, the cache grows to the cap again */
+	for (i = 0; i < 4 * RTE_MEMPOOL_CACHE_ADAPT_PERIOD; i++) {
+		if (rte_mempool_get_bulk(mp, objs, ADAPT_BURST) < 0)
+			GOTO_ERR(ret, out);
+		rte_mempool_put_bulk(mp, objs, ADAPT_BURST);
+	}
+	if (rte_mempool_cache_stats_get(mp, lcore_id, &stats) < 0)
+		GOTO_ERR(ret, out);
+	if (stats.size != size)
+		GOTO_ERR(ret, out);
+
+	rte_mempool_dump(stdout, mp);
+	ret = 0;
+
+out:
+	rte_mempool_free(mp);
+	return ret;
+}
+
 static int
 test_mempool_same_name_twice_creation(void)
 {
@@ -485,6 +580,7 @@ test_mempool(void)
 	struct rte_mempool *mp_stack_anon = NULL;
 	struct rte_mempool *mp_stack_mempool_iter = NULL;
 	struct rte_mempool *mp_stack = NULL;
+	struct rte_mempool *mp_numa = NULL;
 	struct rte_mempool *default_pool = NULL;
 	struct mp_data cb_arg = {
 		.ret = -1
@@ -583,6 +679,27 @@ test_mempool(void)
 	}
 	rte_mempool_obj_iter(mp_stack, my_obj_init, NULL);
 
+	/* create a mempool with the per-node stack handler */
+	mp_numa = rte_mempool_create_empty("test_numa",
+		MEMPOOL_SIZE,
+		MEMPOOL_ELT_SIZE,
+		RTE_MEMPOOL_CACHE_MAX_SIZE, 0,
+		SOCKET_ID_ANY, 0);
+
+	if (mp_numa == NULL) {
+		printf("cannot allocate mp_numa mempool\n");
+		GOTO_ERR(ret, err);
+	}
+	if (rte_mempool_set_ops_byname(mp_numa, "numa_stack", NULL) < 0) {
+		printf("cannot set numa_stack handler\n");
+		GOTO_ERR(ret, err);
+	}
+	if (rte_mempool_populate_default(mp_numa) < 0) {
+		printf("cannot populate mp_numa mempool\n");
+		GOTO_ERR(ret, err);
+	}
+	rte_mempool_obj_iter(mp_numa, my_obj_init, NULL);
+
 	/* Create a mempool based on Default handler */
 	printf("Testing %s mempool handler\n", default_pool_ops);
 	default_pool = rte_mempool_create_empty("default_pool",
@@ -643,10 +760,17 @@ test_mempool(void)
 	if (test_mempool_same_name_twice_creation() < 0)
 		GOTO_ERR(ret, err);
 
+	if (test_mempool_cache_stats_adaptive() < 0)
+		GOTO_ERR(ret, err);
+
 	/* test the stack handler */
 	if (test_mempool_basic(mp_stack, 1) < 0)
 		GOTO_ERR(ret, err);
 
+	/* test the per-node stack handler */
+	if (test_mempool_basic(mp_numa, 1) < 0)
+		GOTO_ERR(ret, err);
+
 	if (test_mempool_basic(default_pool, 1) < 0)
 		GOTO_ERR(ret, err);
 
@@ -660,6 +784,7 @@ test_mempool(void)
 	rte_mempool_free(mp_stack_anon);
 	rte_mempool_free(mp_stack_mempool_iter);
 	rte_mempool_free(mp_stack);
+	rte_mempool_free(mp_numa);
 	rte_mempool_free(default_pool);
 
 	return ret;
@@ -26,6 +26,8 @@
 #include <rte_spinlock.h>
 #include <rte_malloc.h>
 #include <rte_mbuf_pool_ops.h>
+#include <rte_pause.h>
+#include <rte_ring.h>
 
 #include "test.h"
 
@@ -61,6 +63,12 @@
  *
  *      - 32
  *      - 128
+ *
+ *    A cross-socket producer/consumer test is also done: the master core
+ *    gets objects from the pool and passes them through a ring to a core
+ *    of another socket if there is one, which puts them back. It is run
+ *    on the default handler and on the per-node "numa_stack" handler,
+ *    without cache, with bulks from 1 to 32.
  */
 
 #define N 65536
@@ -68,6 +76,7 @@
 #define MEMPOOL_ELT_SIZE 2048
 #define MAX_KEEP 128
 #define MEMPOOL_SIZE ((rte_lcore_count()*(MAX_KEEP+RTE_MEMPOOL_CACHE_MAX_SIZE))-1)
+#define XSOCKET_RING_SIZE 512
 
 #define LOG_ERR() printf("test failed at %s():%d\n", __func__, __LINE__)
 #define RET_ERR() do {							\
@@ -99,6 +108,10 @@ struct mempool_test_stats {
 
 static struct mempool_test_stats stats[RTE_MAX_LCORE];
 
+/* objects in flight from the producer to the consumer */
+static struct rte_ring *xsocket_ring;
+static rte_atomic32_t xsocket_stop;
+
 /*
  * save the object number in the first 4 bytes of object data. All
  * other bytes are set to 0.
@@ -279,16 +292,137 @@ do_one_mempool_test(struct rte_mempool *mp, unsigned int cores)
 	return 0;
 }
 
+static int
+xsocket_consumer(void *arg)
+{
+	void *obj_table[MAX_KEEP];
+	struct rte_mempool *mp = arg;
+	unsigned int lcore_id = rte_lcore_id();
+	unsigned int n;
+
+	stats[lcore_id].enq_count = 0;
+
+	while (rte_atomic32_read(&xsocket_stop) == 0) {
+		n = rte_ring_sc_dequeue_burst(xsocket_ring, obj_table,
+				n_put_bulk, NULL);
+		if (n == 0) {
+			rte_pause();
+			continue;
+		}
+		rte_mempool_put_bulk(mp, obj_table, n);
+		stats[lcore_id].enq_count += n;
+	}
+
+	return 0;
+}
+
+static void
+xsocket_producer(struct rte_mempool *mp)
+{
+	void *obj_table[MAX_KEEP];
+	uint64_t start_cycles, hz = rte_get_timer_hz();
+	unsigned int i;
+
+	start_cycles = rte_get_timer_cycles();
+
+	while (rte_get_timer_cycles() - start_cycles < TIME_S * hz) {
+		for (i = 0; i < N / MAX_KEEP; i++) {
+			/* the consumer has not given enough objects back yet */
+			if (rte_mempool_get_bulk(mp, obj_table,
+					n_get_bulk) < 0)
+				continue;
+			while (rte_ring_sp_enqueue_bulk(xsocket_ring,
+					obj_table, n_get_bulk, NULL) == 0)
+				rte_pause();
+		}
+	}
+}
+
+/*
+ * Get objects on the master core and put them back on a core of another
+ * socket, or any other core if all of them are on the same socket.
+ */
+static int
+do_xsocket_mempool_test(struct rte_mempool *mp)
+{
+	unsigned int bulk_tab[] = { 1, 4, 32, 0 };
+	unsigned int master = rte_get_master_lcore();
+	unsigned int lcore_id, consumer = RTE_MAX_LCORE;
+	unsigned int *bulk_ptr;
+	void *obj;
+	int ret = 0;
+
+	RTE_LCORE_FOREACH_SLAVE(lcore_id) {
+		if (consumer == RTE_MAX_LCORE)
+			consumer = lcore_id;
+		if (rte_lcore_to_socket_id(lcore_id) !=
+				rte_lcore_to_socket_id(master)) {
+			consumer = lcore_id;
+			break;
+		}
+	}
+	if (consumer == RTE_MAX_LCORE) {
+		printf("cross-socket test needs at least 2 lcores, skipping\n");
+		return 0;
+	}
+
+	xsocket_ring = rte_ring_create("perf_test_xsocket", XSOCKET_RING_SIZE,
+			rte_lcore_to_socket_id(consumer),
+			RING_F_SP_ENQ | RING_F_SC_DEQ);
+	if (xsocket_ring == NULL)
+		return -1;
+
+	for (bulk_ptr = bulk_tab; *bulk_ptr; bulk_ptr++) {
+		n_get_bulk = *bulk_ptr;
+		n_put_bulk = *bulk_ptr;
+
+		printf("mempool_autotest xsocket ops=%s producer=%u "
+		       "(socket %u) consumer=%u (socket %u) bulk=%u ",
+		       rte_mempool_get_ops(mp->ops_index)->name,
+		       master, rte_lcore_to_socket_id(master),
+		       consumer, rte_lcore_to_socket_id(consumer),
+		       n_get_bulk);
+
+		rte_atomic32_set(&xsocket_stop, 0);
+		rte_eal_remote_launch(xsocket_consumer, mp, consumer);
+		xsocket_producer(mp);
+		rte_atomic32_set(&xsocket_stop, 1);
+		if (rte_eal_wait_lcore(consumer) < 0)
+			ret = -1;
+
+		/* give back what the consumer did not get to */
+		while (rte_ring_sc_dequeue(xsocket_ring, &obj) == 0)
+			rte_mempool_put(mp, obj);
+
+		if (rte_mempool_avail_count(mp) != MEMPOOL_SIZE) {
+			printf("mempool is not full\n");
+			ret = -1;
+		}
+		if (ret < 0)
+			break;
+
+		printf("rate_persec=%" PRIu64 "\n",
+		       stats[consumer].enq_count / TIME_S);
+	}
+
+	rte_ring_free(xsocket_ring);
+	xsocket_ring = NULL;
+
+	return ret;
+}
+
 static int
 test_mempool_perf(void)
 {
 	struct rte_mempool *mp_cache = NULL;
 	struct rte_mempool *mp_nocache = NULL;
 	struct rte_mempool *default_pool = NULL;
+	struct rte_mempool *numa_pool = NULL;
 	const char *default_pool_ops;
 	int ret = -1;
 
 	rte_atomic32_init(&synchro);
+	rte_atomic32_init(&xsocket_stop);
 
 	/* create a mempool (without cache) */
 	mp_nocache = rte_mempool_create("perf_test_nocache", MEMPOOL_SIZE,
@@ -335,6 +469,29 @@ test_mempool_perf(void)
 
 	rte_mempool_obj_iter(default_pool, my_obj_init, NULL);
 
+	/* Create a mempool with one stack per NUMA node */
+	numa_pool = rte_mempool_create_empty("perf_test_numa",
+					     MEMPOOL_SIZE,
+					     MEMPOOL_ELT_SIZE,
+					     0, 0,
+					     SOCKET_ID_ANY, 0);
+	if (numa_pool == NULL) {
+		printf("cannot allocate numa_stack mempool\n");
+		goto err;
+	}
+
+	if (rte_mempool_set_ops_byname(numa_pool, "numa_stack", NULL) < 0) {
+		printf("cannot set numa_stack handler\n");
+		goto err;
+	}
+
+	if (rte_mempool_populate_default(numa_pool) < 0) {
+		printf("cannot populate numa_stack mempool\n");
+		goto err;
+	}
+
+	rte_mempool_obj_iter(numa_pool, my_obj_init, NULL);
+
 	/* performance test with 1, 2 and max cores */
 	printf("start performance test (without cache)\n");
 
@@ -385,6 +542,16 @@ test_mempool_perf(void)
 	if (do_one_mempool_test(mp_nocache, rte_lcore_count()) < 0)
 		goto err;
 
+	/* producer/consumer test across sockets */
+	printf("start cross-socket performance test (without cache)\n");
+	use_external_cache = 0;
+
+	if (do_xsocket_mempool_test(default_pool) < 0)
+		goto err;
+
+	if (do_xsocket_mempool_test(numa_pool) < 0)
+		goto err;
+
 	rte_mempool_list_dump(stdout);
 
 	ret = 0;
@@ -393,6 +560,7 @@ test_mempool_perf(void)
 	rte_mempool_free(mp_cache);
 	rte_mempool_free(mp_nocache);
 	rte_mempool_free(default_pool);
+	rte_mempool_free(numa_pool);
 	return ret;
 }
 
@@ -11,7 +11,9 @@
 #include <rte_mbuf.h>
 #include <rte_reorder.h>
 #include <rte_lcore.h>
+#include <rte_launch.h>
 #include <rte_malloc.h>
+#include <rte_pause.h>
 
 #include "test.h"
 
@@ -19,6 +21,10 @@
 #define REORDER_BUFFER_SIZE 16384
 #define NUM_MBUFS (2*REORDER_BUFFER_SIZE)
 #define REORDER_BUFFER_SIZE_INVALID 2049
+#define MP_BUFFER_SIZE 1024
+#define MP_NUM_PKTS (1 << 16)
+#define INTERLEAVE_BUFFER_SIZE 8
+#define INTERLEAVE_NUM_PKTS (1 << 12)
 
 struct reorder_unittest_params {
 	struct rte_mempool *p;
@@ -268,8 +274,10 @@ test_reorder_drain(void)
 		ret = -1;
 		goto exit;
 	}
-	if (robufs[0] != NULL)
+	if (robufs[0] != NULL) {
 		rte_pktmbuf_free(robufs[0]);
+		robufs[0] = NULL;
+	}
 
 	/* Insert more packets
 	 * RB[] = {NULL, NULL, NULL, NULL}
@@ -303,8 +311,10 @@ test_reorder_drain(void)
 		goto exit;
 	}
 	for (i = 0; i < 3; i++) {
-		if (robufs[i] != NULL)
+		if (robufs[i] != NULL) {
 			rte_pktmbuf_free(robufs[i]);
+			robufs[i] = NULL;
+		}
 	}
 
 	/*
@@ -330,6 +340,337 @@ test_reorder_drain(void)
 	return ret;
 }
 
+static int
+test_reorder_insert_mp(void)
+{
+	struct rte_reorder_buffer *b = NULL;
+	struct rte_mempool *p = test_params->p;
+	const unsigned int size = 4;
+	const uint32_t seqns[] = {0, 2, 1, 5, 8, 6, 7, 100};
+	const unsigned int num_bufs = RTE_DIM(seqns);
+	struct rte_mbuf *bufs[num_bufs];
+	struct rte_mbuf *robufs[num_bufs];
+	unsigned int i, cnt;
+	int ret = -1;
+
+	memset(robufs, 0, sizeof(robufs));
+
+	b = rte_reorder_create("test_insert_mp", rte_socket_id(), size);
+	TEST_ASSERT_NOT_NULL(b, "Failed to create reorder buffer");
+
+	for (i = 0; i < num_bufs; i++) {
+		bufs[i] = rte_pktmbuf_alloc(p);
+		TEST_ASSERT_NOT_NULL(bufs[i], "Packet allocation failed\n");
+		bufs[i]->seqn = seqns[i];
+	}
+
+	/* Nothing to drain before the first insert */
+	cnt = rte_reorder_drain_mp(b, robufs, num_bufs);
+	if (cnt != 0) {
+		printf("%s:%d: drained packets from empty reorder buffer\n",
+				__func__, __LINE__);
+		goto exit;
+	}
+
+	/* Out of order burst, drained in order: 0, 1, 2 */
+	cnt = rte_reorder_insert_bulk_mp(b, bufs, 3);
+	if (cnt != 3) {
+		printf("%s:%d: Error inserting burst\n", __func__, __LINE__);
+		goto exit;
+	}
+	for (i = 0; i < 3; i++)
+		bufs[i] = NULL;
+	cnt = rte_reorder_drain_mp(b, robufs, num_bufs);
+	if (cnt != 3 || robufs[0]->seqn != 0 || robufs[1]->seqn != 1 ||
+			robufs[2]->seqn != 2) {
+		printf("%s:%d: Error draining in order packets\n",
+				__func__, __LINE__);
+		goto exit;
+	}
+	for (i = 0; i < cnt; i++) {
+		rte_pktmbuf_free(robufs[i]);
+		robufs[i] = NULL;
+	}
+
+	/* Gap at 3: 5 is inserted but not drained */
+	if (rte_reorder_insert_mp(b, bufs[3]) != 0) {
+		printf("%s:%d: Error inserting packet\n", __func__, __LINE__);
+		goto exit;
+	}
+	bufs[3] = NULL;
+	cnt = rte_reorder_drain_mp(b, robufs, num_bufs);
+	if (cnt != 0) {
+		printf("%s:%d: drained packet past a gap\n", __func__, __LINE__);
+		goto exit;
+	}
+
+	/* Early packet 8 is refused, but the next drain skips 3 and 4 */
+	ret = rte_reorder_insert_mp(b, bufs[4]);
+	if (!(ret == -1 && rte_errno == ENOSPC)) {
+		printf("%s:%d: No error inserting early packet\n",
+				__func__, __LINE__);
+		ret = -1;
+		goto exit;
+	}
+	ret = -1;
+	cnt = rte_reorder_drain_mp(b, robufs, num_bufs);
+	if (cnt != 1 || robufs[0]->seqn != 5) {
+		printf("%s:%d: Error draining past skipped packets\n",
+				__func__, __LINE__);
+		goto exit;
+	}
+	rte_pktmbuf_free(robufs[0]);
+	robufs[0] = NULL;
+
+	/* 8 fits in the window now, and is drained after 6 and 7 */
+	if (rte_reorder_insert_mp(b, bufs[4]) != 0) {
+		printf("%s:%d: Error inserting early packet again\n",
+				__func__, __LINE__);
+		goto exit;
+	}
+	bufs[4] = NULL;
+	cnt = rte_reorder_insert_bulk_mp(b, &bufs[5], 2);
+	if (cnt != 2) {
+		printf("%s:%d: Error inserting burst\n", __func__, __LINE__);
+		goto exit;
+	}
+	bufs[5] = bufs[6] = NULL;
+
+	/* Packet far out of the window */
+	ret = rte_reorder_insert_mp(b, bufs[7]);
+	if (!(ret == -1 && rte_errno == ERANGE)) {
+		printf("%s:%d: No error inserting packet out of range\n",
+				__func__, __LINE__);
+		ret = -1;
+		goto exit;
+	}
+	ret = -1;
+
+	cnt = rte_reorder_drain_mp(b, robufs, num_bufs);
+	if (cnt != 3 || robufs[0]->seqn != 6 || robufs[1]->seqn != 7 ||
+			robufs[2]->seqn != 8) {
+		printf("%s:%d: Error draining in order packets\n",
+				__func__, __LINE__);
+		goto exit;
+	}
+
+	ret = 0;
+exit:
+	rte_reorder_free(b);
+	for (i = 0; i < num_bufs; i++) {
+		if (bufs[i] != NULL)
+			rte_pktmbuf_free(bufs[i]);
+		if (robufs[i] != NULL)
+			rte_pktmbuf_free(robufs[i]);
+	}
+	return ret;
+}
+
+struct reorder_mp_worker {
+	struct rte_reorder_buffer *b;
+	unsigned int num_workers;
+	unsigned int worker_idx;
+	unsigned int late_pkts;
+};
+
+static struct reorder_mp_worker mp_workers[RTE_MAX_LCORE];
+static unsigned int mp_workers_done;
+
+/*
+ * Insert the packets of seqn worker_idx, worker_idx + num_workers...
+ * in bursts, retrying those which do not fit in the window yet.
+ */
+static int
+reorder_mp_worker(void *arg)
+{
+	struct reorder_mp_worker *w = arg;
+	struct rte_mempool *p = test_params->p;
+	struct rte_mbuf *bufs[BURST];
+	uint32_t seqn = w->worker_idx;
+	unsigned int i, n, cnt;
+
+	while (seqn < MP_NUM_PKTS) {
+		for (n = 0; n < BURST && seqn < MP_NUM_PKTS; n++) {
+			while ((bufs[n] = rte_pktmbuf_alloc(p)) == NULL)
+				rte_pause();
+			bufs[n]->seqn = seqn;
+			seqn += w->num_workers;
+		}
+
+		i = 0;
+		while (i < n) {
+			cnt = rte_reorder_insert_bulk_mp(w->b, &bufs[i],
+					n - i);
+			i += cnt;
+			if (i == n)
+				break;
+			if (rte_errno == ERANGE) {
+				/* Skipped by the drain */
+				rte_pktmbuf_free(bufs[i++]);
+				w->late_pkts++;
+			} else {
+				rte_pause();
+			}
+		}
+	}
+	__atomic_fetch_add(&mp_workers_done, 1, __ATOMIC_RELEASE);
+	return 0;
+}
+
+static int
+test_reorder_mp(void)
+{
+	struct rte_reorder_buffer *b;
+	struct rte_mbuf *robufs[BURST];
+	const unsigned int num_workers = rte_lcore_count() - 1;
+	unsigned int lcore_id, i, cnt, idx = 0;
+	unsigned int drained = 0, late = 0, out_of_order = 0;
+	uint32_t last_seqn = 0;
+	int done, ret = 0;
+
+	if (num_workers == 0) {
+		printf("Not enough cores for multi-producer reorder test\n");
+		return TEST_SKIPPED;
+	}
+
+	b = rte_reorder_create("test_mp", rte_socket_id(), MP_BUFFER_SIZE);
+	TEST_ASSERT_NOT_NULL(b, "Failed to create reorder buffer");
+	mp_workers_done = 0;
+
+	RTE_LCORE_FOREACH_SLAVE(lcore_id) {
+		mp_workers[idx].b = b;
+		mp_workers[idx].num_workers = num_workers;
+		mp_workers[idx].worker_idx = idx;
+		mp_workers[idx].late_pkts = 0;
+		rte_eal_remote_launch(reorder_mp_worker, &mp_workers[idx],
+				lcore_id);
+		idx++;
+	}
+
+	/* Drain until the workers are done and nothing is left */
+	do {
+		done = __atomic_load_n(&mp_workers_done, __ATOMIC_ACQUIRE) ==
+				num_workers;
+		cnt = rte_reorder_drain_mp(b, robufs, BURST);
+		for (i = 0; i < cnt; i++) {
+			if (drained + i != 0 && robufs[i]->seqn <= last_seqn)
+				out_of_order++;
+			last_seqn = robufs[i]->seqn;
+			rte_pktmbuf_free(robufs[i]);
+		}
+		drained += cnt;
+	} while (cnt != 0 || !done);
+	rte_eal_mp_wait_lcore();
+
+	for (i = 0; i < num_workers; i++)
+		late += mp_workers[i].late_pkts;
+	printf("Drained %u packets, %u skipped, %u out of order\n",
+			drained, late, out_of_order);
+	if (drained + late != MP_NUM_PKTS || out_of_order != 0)
+		ret = -1;
+
+	rte_reorder_free(b);
+	return ret;
+}
+
+static volatile int interleave_done;
+static unsigned int interleave_out_of_order;
+
+/* Drain on another lcore until the producer is done and nothing is left */
+static int
+reorder_interleave_drainer(void *arg)
+{
+	struct rte_reorder_buffer *b = arg;
+	struct rte_mbuf *robufs[BURST];
+	unsigned int i, cnt, drained = 0;
+	uint32_t last_seqn = 0;
+	int done;
+
+	do {
+		done = interleave_done;
+		cnt = rte_reorder_drain_mp(b, robufs, BURST);
+		for (i = 0; i < cnt; i++) {
+			if (drained + i != 0 && robufs[i]->seqn <= last_seqn)
+				interleave_out_of_order++;
+			last_seqn = robufs[i]->seqn;
+			rte_pktmbuf_free(robufs[i]);
+		}
+		drained += cnt;
+	} while (cnt != 0 || !done);
+
+	return drained;
+}
+
+/*
+ * Insert packets in order while another lcore drains, except the first one
+ * of each window which is held back. The packet after the window asks the
+ * drain to skip the held one, which is inserted at the same time, so that
+ * the drain and the late insert race. Check the packets are drained in
+ * order and that each one is either drained or reported as skipped.
+ */
+static int
+test_reorder_mp_interleave(void)
+{
+	struct rte_mempool *p = test_params->p;
+	struct rte_mbuf *bufs[INTERLEAVE_BUFFER_SIZE + 1], *held;
+	struct rte_reorder_buffer *b;
+	unsigned int lcore_id, i, n, late = 0;
+	uint32_t seqn;
+	int drained;
+
+	lcore_id = rte_get_next_lcore(-1, 1, 0);
+	if (lcore_id >= RTE_MAX_LCORE) {
+		printf("Not enough cores for reorder interleave test\n");
+		return TEST_SKIPPED;
+	}
+
+	b = rte_reorder_create("test_interleave", rte_socket_id(),
+			INTERLEAVE_BUFFER_SIZE);
+	TEST_ASSERT_NOT_NULL(b, "Failed to create reorder buffer");
+	interleave_done = 0;
+	interleave_out_of_order = 0;
+	rte_eal_remote_launch(reorder_interleave_drainer, b, lcore_id);
+
+	for (seqn = 0; seqn < INTERLEAVE_NUM_PKTS; seqn += n) {
+		n = RTE_MIN(RTE_DIM(bufs), INTERLEAVE_NUM_PKTS - seqn);
+		for (i = 0; i < n; i++) {
+			while ((bufs[i] = rte_pktmbuf_alloc(p)) == NULL)
+				rte_pause();
+			bufs[i]->seqn = seqn + (i + 1) % n;
+		}
+
+		i = 0;
+		while (i < n) {
+			i += rte_reorder_insert_bulk_mp(b, &bufs[i], n - i);
+			if (i == n)
+				break;
+			if (rte_errno == ERANGE) {
+				rte_pktmbuf_free(bufs[i++]);
+				late++;
+			} else if (i < n - 1 && bufs[n - 1]->seqn == seqn) {
+				/* early packet, insert the held one first */
+				held = bufs[n - 1];
+				bufs[n - 1] = bufs[i];
+				bufs[i] = held;
+			} else {
+				rte_pause();
+			}
+		}
+	}
+	interleave_done = 1;
+	drained = rte_eal_wait_lcore(lcore_id);
+
+	printf("Drained %d packets, %u skipped, %u out of order\n",
+			drained, late, interleave_out_of_order);
+	rte_reorder_free(b);
+	TEST_ASSERT_EQUAL(interleave_out_of_order, 0,
+			"Packets drained out of order");
+	TEST_ASSERT_EQUAL(drained + late, INTERLEAVE_NUM_PKTS,
+			"Packets lost in the reorder buffer");
+
+	return 0;
+}
+
 static int
 test_setup(void)
 {
@@ -380,6 +721,9 @@ static struct unit_test_suite reorder_test_suite  = {
 		TEST_CASE(test_reorder_free),
 		TEST_CASE(test_reorder_insert),
 		TEST_CASE(test_reorder_drain),
+		TEST_CASE(test_reorder_insert_mp),
+		TEST_CASE(test_reorder_mp),
+		TEST_CASE(test_reorder_mp_interleave),
 		TEST_CASES_END()
 	}
 };
@@ -3,11 +3,15 @@
  * Copyright(c) 2019 Intel Corporation
  */
 
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
 
+#include <rte_cycles.h>
+#include <rte_errno.h>
 #include <rte_ip.h>
+#include <rte_random.h>
 #include <rte_rib.h>
 
 #include "test.h"
@@ -21,9 +25,105 @@ static int32_t test_insert_invalid(void);
 static int32_t test_get_fn(void);
 static int32_t test_basic(void);
 static int32_t test_tree_traversal(void);
+static int32_t test_bulk_walk(void);
+static int32_t test_bulk_perf(void);
 
 #define MAX_DEPTH 32
 #define MAX_RULES (1 << 22)
+#define NUM_BULK_ROUTES 100000
+#define NUM_PERF_ROUTES 1000000
+#define WALK_BURST 37
+
+struct route {
+	uint32_t ip;
+	uint8_t depth;
+	uint64_t nh;
+};
+
+static int
+route_cmp(const void *a, const void *b)
+{
+	const struct route *r1 = a;
+	const struct route *r2 = b;
+
+	if (r1->ip != r2->ip)
+		return (r1->ip < r2->ip) ? -1 : 1;
+	return (int)r1->depth - (int)r2->depth;
+}
+
+/*
+ * Fill the arrays with random routes sorted in prefix order, without
+ * duplicates. Returns the number of routes.
+ */
+static unsigned int
+gen_routes(struct route *routes, uint32_t *ips, uint8_t *depths,
+	uint64_t *nhs, unsigned int n, uint8_t min_depth)
+{
+	unsigned int i, j;
+
+	for (i = 0; i < n; i++) {
+		routes[i].depth = min_depth +
+			rte_rand_max(MAX_DEPTH - min_depth + 1);
+		routes[i].ip = (uint32_t)rte_rand() &
+			rte_rib_depth_to_mask(routes[i].depth);
+		routes[i].nh = i;
+	}
+	qsort(routes, n, sizeof(routes[0]), route_cmp);
+	for (i = 0, j = 0; i < n; i++) {
+		if ((j != 0) && (route_cmp(&routes[j - 1], &routes[i]) == 0))
+			continue;
+		routes[j] = routes[i];
+		ips[j] = routes[j].ip;
+		depths[j] = routes[j].depth;
+		nhs[j] = routes[j].nh;
+		j++;
+	}
+	return j;
+}
+
+/*
+ * Walk the routes covered by ip/depth and check they are the ones of
+ * the sorted list, in the same order.
+ */
+static int
+check_walk(struct rte_rib *rib, const struct route *routes, unsigned int n,
+	uint32_t ip, uint8_t depth)
+{
+	struct rte_rib_walk walk;
+	uint32_t w_ips[WALK_BURST];
+	uint8_t w_depths[WALK_BURST];
+	uint64_t w_nhs[WALK_BURST];
+	unsigned int i = 0;
+	int j, ret;
+
+	ip &= rte_rib_depth_to_mask(depth);
+	if (rte_rib_walk_init(rib, &walk, ip, depth) != 0)
+		return -1;
+	do {
+		ret = rte_rib_walk_bulk(rib, &walk, w_ips, w_depths, w_nhs,
+			WALK_BURST);
+		if (ret < 0)
+			return -1;
+		for (j = 0; j < ret; j++) {
+			while ((i < n) && ((routes[i].depth < depth) ||
+					((routes[i].ip ^ ip) &
+					rte_rib_depth_to_mask(depth))))
+				i++;
+			if ((i == n) || (w_ips[j] != routes[i].ip) ||
+					(w_depths[j] != routes[i].depth) ||
+					(w_nhs[j] != routes[i].nh))
+				return -1;
+			i++;
+		}
+	} while (ret != 0);
+
+	/* no covered route left */
+	for (; i < n; i++)
+		if ((routes[i].depth >= depth) && (((routes[i].ip ^ ip) &
+				rte_rib_depth_to_mask(depth)) == 0))
+			return -1;
+	return 0;
+}
 
 /*
  * Check that rte_rib_create fails gracefully for incorrect user input
@@ -120,6 +220,9 @@ test_insert_invalid(void)
 	struct rte_rib_conf config;
 	uint32_t ip = RTE_IPV4(0, 0, 0, 0);
 	uint8_t depth = 24;
+	uint8_t bad_depth = MAX_DEPTH + 1;
+	uint64_t nh = 1;
+	int ret;
 
 	config.max_nodes = MAX_RULES;
 	config.ext_sz = 0;
@@ -138,6 +241,27 @@ test_insert_invalid(void)
 	RTE_TEST_ASSERT(node == NULL,
 		"Call succeeded with invalid parameters\n");
 
+	/* rte_rib_insert_bulk: NULL rib or arrays */
+	rte_errno = 0;
+	ret = rte_rib_insert_bulk(NULL, &ip, &depth, &nh, 1);
+	RTE_TEST_ASSERT((ret == -EINVAL) && (rte_errno == EINVAL),
+		"Call succeeded with invalid parameters\n");
+	ret = rte_rib_insert_bulk(rib, NULL, &depth, &nh, 1);
+	RTE_TEST_ASSERT(ret == -EINVAL,
+		"Call succeeded with invalid parameters\n");
+	ret = rte_rib_insert_bulk(rib, &ip, NULL, &nh, 1);
+	RTE_TEST_ASSERT(ret == -EINVAL,
+		"Call succeeded with invalid parameters\n");
+	ret = rte_rib_insert_bulk(rib, &ip, &depth, NULL, 1);
+	RTE_TEST_ASSERT(ret == -EINVAL,
+		"Call succeeded with invalid parameters\n");
+
+	/* rte_rib_insert_bulk: depth > MAX_DEPTH stops the insert */
+	rte_errno = 0;
+	ret = rte_rib_insert_bulk(rib, &ip, &bad_depth, &nh, 1);
+	RTE_TEST_ASSERT((ret == 0) && (rte_errno == EINVAL),
+		"Call succeeded with invalid parameters\n");
+
 	/* insert the same ip/depth twice*/
 	node = rte_rib_insert(rib, ip, depth);
 	RTE_TEST_ASSERT(node != NULL, "Failed to insert rule\n");
@@ -323,6 +447,193 @@ test_tree_traversal(void)
 	return TEST_SUCCESS;
 }
 
+/*
+ * Insert routes in bulk, sorted and unsorted, and check the walk
+ * retrieves all of them in prefix order.
+ */
+int32_t
+test_bulk_walk(void)
+{
+	struct rte_rib *rib = NULL;
+	struct rte_rib_node *node;
+	struct rte_rib_conf config;
+	struct route *routes;
+	uint32_t *ips;
+	uint8_t *depths;
+	uint64_t *nhs;
+	unsigned int i, j, n, nb_nxt, nb_walk;
+	struct rte_rib_walk walk;
+	uint32_t w_ip;
+	uint8_t w_depth;
+	uint64_t w_nh;
+	int ret;
+
+	config.max_nodes = 2 * NUM_BULK_ROUTES;
+	config.ext_sz = 0;
+
+	routes = malloc(NUM_BULK_ROUTES * sizeof(*routes));
+	ips = malloc(NUM_BULK_ROUTES * sizeof(*ips));
+	depths = malloc(NUM_BULK_ROUTES * sizeof(*depths));
+	nhs = malloc(NUM_BULK_ROUTES * sizeof(*nhs));
+	RTE_TEST_ASSERT((routes != NULL) && (ips != NULL) &&
+		(depths != NULL) && (nhs != NULL),
+		"Failed to allocate routes\n");
+
+	n = gen_routes(routes, ips, depths, nhs, NUM_BULK_ROUTES, 0);
+
+	rib = rte_rib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(rib != NULL, "Failed to create RIB\n");
+
+	ret = rte_rib_insert_bulk(rib, ips, depths, nhs, n);
+	RTE_TEST_ASSERT(ret == (int)n, "Failed to insert routes in bulk\n");
+
+	RTE_TEST_ASSERT(check_walk(rib, routes, n, 0, 0) == 0,
+		"Walk of the whole RIB failed\n");
+	for (i = 0; i < 100; i++) {
+		j = rte_rand_max(n);
+		RTE_TEST_ASSERT(check_walk(rib, routes, n, routes[j].ip,
+			routes[j].depth) == 0, "Walk of a subtree failed\n");
+		RTE_TEST_ASSERT(check_walk(rib, routes, n,
+			(uint32_t)rte_rand(), rte_rand_max(MAX_DEPTH + 1)) == 0,
+			"Walk of a random prefix failed\n");
+	}
+
+	/* the walk and rte_rib_get_nxt() agree, except for the prefix */
+	node = NULL;
+	nb_nxt = 0;
+	while ((node = rte_rib_get_nxt(rib, routes[0].ip, 8, node,
+			RTE_RIB_GET_NXT_ALL)) != NULL)
+		nb_nxt++;
+	rte_rib_walk_init(rib, &walk, routes[0].ip, 8);
+	nb_walk = 0;
+	while (rte_rib_walk_bulk(rib, &walk, &w_ip, &w_depth, &w_nh, 1) == 1)
+		nb_walk++;
+	if (rte_rib_lookup_exact(rib, routes[0].ip, 8) != NULL)
+		nb_walk--;
+	RTE_TEST_ASSERT(nb_nxt == nb_walk,
+		"Walk and get_nxt returned different routes\n");
+
+	/* inserting routes again updates their next hops */
+	for (i = 0; i < n; i++)
+		routes[i].nh = nhs[i] = i + 1000;
+	ret = rte_rib_insert_bulk(rib, ips, depths, nhs, n);
+	RTE_TEST_ASSERT(ret == (int)n, "Failed to update routes in bulk\n");
+	RTE_TEST_ASSERT(check_walk(rib, routes, n, 0, 0) == 0,
+		"Walk after update failed\n");
+
+	/* remove every other route */
+	for (i = 0, j = 0; i < n; i++) {
+		if (i & 1)
+			rte_rib_remove(rib, routes[i].ip, routes[i].depth);
+		else
+			routes[j++] = routes[i];
+	}
+	RTE_TEST_ASSERT(check_walk(rib, routes, j, 0, 0) == 0,
+		"Walk after remove failed\n");
+	rte_rib_free(rib);
+
+	/* unsorted insert gives the same RIB */
+	n = j;
+	for (i = 0; i < n; i++) {
+		j = rte_rand_max(i + 1);
+		ips[i] = ips[j];
+		depths[i] = depths[j];
+		nhs[i] = nhs[j];
+		ips[j] = routes[i].ip;
+		depths[j] = routes[i].depth;
+		nhs[j] = routes[i].nh;
+	}
+	rib = rte_rib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(rib != NULL, "Failed to create RIB\n");
+	ret = rte_rib_insert_bulk(rib, ips, depths, nhs, n);
+	RTE_TEST_ASSERT(ret == (int)n, "Failed to insert routes in bulk\n");
+	RTE_TEST_ASSERT(check_walk(rib, routes, n, 0, 0) == 0,
+		"Walk of unsorted routes failed\n");
+	rte_rib_free(rib);
+
+	/* not enough nodes */
+	config.max_nodes = n / 2;
+	rib = rte_rib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(rib != NULL, "Failed to create RIB\n");
+	ret = rte_rib_insert_bulk(rib, ips, depths, nhs, n);
+	RTE_TEST_ASSERT((ret < (int)n) && (rte_errno == ENOMEM),
+		"Bulk insert did not run out of nodes\n");
+	rte_rib_free(rib);
+
+	free(routes);
+	free(ips);
+	free(depths);
+	free(nhs);
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Load a full table in bulk and walk it back
+ */
+int32_t
+test_bulk_perf(void)
+{
+	struct rte_rib *rib = NULL;
+	struct rte_rib_conf config;
+	struct rte_rib_walk walk;
+	struct route *routes;
+	uint32_t *ips;
+	uint8_t *depths;
+	uint64_t *nhs;
+	uint64_t begin, total = 0;
+	unsigned int n;
+	int ret;
+
+	config.max_nodes = 2 * NUM_PERF_ROUTES;
+	config.ext_sz = 0;
+
+	routes = malloc(NUM_PERF_ROUTES * sizeof(*routes));
+	ips = malloc(NUM_PERF_ROUTES * sizeof(*ips));
+	depths = malloc(NUM_PERF_ROUTES * sizeof(*depths));
+	nhs = malloc(NUM_PERF_ROUTES * sizeof(*nhs));
+	RTE_TEST_ASSERT((routes != NULL) && (ips != NULL) &&
+		(depths != NULL) && (nhs != NULL),
+		"Failed to allocate routes\n");
+
+	n = gen_routes(routes, ips, depths, nhs, NUM_PERF_ROUTES, 8);
+
+	rib = rte_rib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(rib != NULL, "Failed to create RIB\n");
+
+	begin = rte_rdtsc();
+	ret = rte_rib_insert_bulk(rib, ips, depths, nhs, n);
+	printf("Bulk insert of %u routes: %.1f ms\n", n,
+		(double)(rte_rdtsc() - begin) * 1000 / rte_get_tsc_hz());
+	RTE_TEST_ASSERT(ret == (int)n, "Failed to insert routes in bulk\n");
+
+	begin = rte_rdtsc();
+	rte_rib_walk_init(rib, &walk, 0, 0);
+	do {
+		ret = rte_rib_walk_bulk(rib, &walk, ips, depths, nhs,
+			NUM_PERF_ROUTES);
+		total += ret;
+	} while (ret > 0);
+	printf("Walk of %u routes: %.1f ms\n", n,
+		(double)(rte_rdtsc() - begin) * 1000 / rte_get_tsc_hz());
+	RTE_TEST_ASSERT(total == n, "Walk returned %"PRIu64" routes\n", total);
+
+	/* resync the same table, only the next hops are written */
+	begin = rte_rdtsc();
+	ret = rte_rib_insert_bulk(rib, ips, depths, nhs, n);
+	printf("Bulk resync of %u routes: %.1f ms\n", n,
+		(double)(rte_rdtsc() - begin) * 1000 / rte_get_tsc_hz());
+	RTE_TEST_ASSERT(ret == (int)n, "Failed to resync routes in bulk\n");
+
+	rte_rib_free(rib);
+	free(routes);
+	free(ips);
+	free(depths);
+	free(nhs);
+
+	return TEST_SUCCESS;
+}
+
 static struct unit_test_suite rib_tests = {
 	.suite_name = "rib autotest",
 	.setup = NULL,
@@ -334,6 +645,7 @@ static struct unit_test_suite rib_tests = {
 		TEST_CASE(test_get_fn),
 		TEST_CASE(test_basic),
 		TEST_CASE(test_tree_traversal),
+		TEST_CASE(test_bulk_walk),
 		TEST_CASES_END()
 	}
 };
@@ -344,6 +656,7 @@ static struct unit_test_suite rib_slow_tests = {
 	.teardown = NULL,
 	.unit_test_cases = {
 		TEST_CASE(test_multiple_create),
+		TEST_CASE(test_bulk_perf),
 		TEST_CASES_END()
 	}
 };
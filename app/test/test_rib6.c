@@ -3,11 +3,15 @@
  * Copyright(c) 2019 Intel Corporation
  */
 
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include <rte_errno.h>
 #include <rte_ip.h>
+#include <rte_random.h>
 #include <rte_rib6.h>
 
 #include "test.h"
@@ -21,9 +25,85 @@ static int32_t test_insert_invalid(void);
 static int32_t test_get_fn(void);
 static int32_t test_basic(void);
 static int32_t test_tree_traversal(void);
+static int32_t test_bulk_walk(void);
 
 #define MAX_DEPTH 128
 #define MAX_RULES (1 << 22)
+#define NUM_BULK_ROUTES 20000
+#define WALK_BURST 37
+
+struct route6 {
+	uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE];
+	uint8_t depth;
+	uint64_t nh;
+};
+
+static int
+route6_cmp(const void *a, const void *b)
+{
+	const struct route6 *r1 = a;
+	const struct route6 *r2 = b;
+	int ret;
+
+	ret = memcmp(r1->ip, r2->ip, RTE_RIB6_IPV6_ADDR_SIZE);
+	if (ret != 0)
+		return ret;
+	return (int)r1->depth - (int)r2->depth;
+}
+
+static bool
+route6_covered(const struct route6 *r, const uint8_t ip[], uint8_t depth)
+{
+	int i;
+
+	if (r->depth < depth)
+		return false;
+	for (i = 0; i < RTE_RIB6_IPV6_ADDR_SIZE; i++)
+		if ((r->ip[i] ^ ip[i]) & get_msk_part(depth, i))
+			return false;
+	return true;
+}
+
+/*
+ * Walk the routes covered by ip/depth and check they are the ones of
+ * the sorted list, in the same order.
+ */
+static int
+check_walk(struct rte_rib6 *rib, struct route6 *routes, unsigned int n,
+	const uint8_t ip[], uint8_t depth)
+{
+	struct rte_rib6_walk walk;
+	uint8_t w_ips[WALK_BURST][RTE_RIB6_IPV6_ADDR_SIZE];
+	uint8_t w_depths[WALK_BURST];
+	uint64_t w_nhs[WALK_BURST];
+	unsigned int i = 0;
+	int j, ret;
+
+	if (rte_rib6_walk_init(rib, &walk, ip, depth) != 0)
+		return -1;
+	do {
+		ret = rte_rib6_walk_bulk(rib, &walk, w_ips, w_depths, w_nhs,
+			WALK_BURST);
+		if (ret < 0)
+			return -1;
+		for (j = 0; j < ret; j++) {
+			while ((i < n) &&
+					!route6_covered(&routes[i], ip, depth))
+				i++;
+			if ((i == n) || !rte_rib6_is_equal(w_ips[j],
+					routes[i].ip) ||
+					(w_depths[j] != routes[i].depth) ||
+					(w_nhs[j] != routes[i].nh))
+				return -1;
+			i++;
+		}
+	} while (ret != 0);
+
+	for (; i < n; i++)
+		if (route6_covered(&routes[i], ip, depth))
+			return -1;
+	return 0;
+}
 
 /*
  * Check that rte_rib6_create fails gracefully for incorrect user input
@@ -120,7 +200,12 @@ test_insert_invalid(void)
 	struct rte_rib6_node *node, *node1;
 	struct rte_rib6_conf config;
 	uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE] = {0};
+	const uint8_t (*ips)[RTE_RIB6_IPV6_ADDR_SIZE] =
+		(const uint8_t (*)[RTE_RIB6_IPV6_ADDR_SIZE])&ip;
 	uint8_t depth = 24;
+	uint8_t bad_depth = MAX_DEPTH + 1;
+	uint64_t nh = 1;
+	int ret;
 
 	config.max_nodes = MAX_RULES;
 	config.ext_sz = 0;
@@ -139,6 +224,27 @@ test_insert_invalid(void)
 	RTE_TEST_ASSERT(node == NULL,
 		"Call succeeded with invalid parameters\n");
 
+	/* rte_rib6_insert_bulk: NULL rib or arrays */
+	rte_errno = 0;
+	ret = rte_rib6_insert_bulk(NULL, ips, &depth, &nh, 1);
+	RTE_TEST_ASSERT((ret == -EINVAL) && (rte_errno == EINVAL),
+		"Call succeeded with invalid parameters\n");
+	ret = rte_rib6_insert_bulk(rib, NULL, &depth, &nh, 1);
+	RTE_TEST_ASSERT(ret == -EINVAL,
+		"Call succeeded with invalid parameters\n");
+	ret = rte_rib6_insert_bulk(rib, ips, NULL, &nh, 1);
+	RTE_TEST_ASSERT(ret == -EINVAL,
+		"Call succeeded with invalid parameters\n");
+	ret = rte_rib6_insert_bulk(rib, ips, &depth, NULL, 1);
+	RTE_TEST_ASSERT(ret == -EINVAL,
+		"Call succeeded with invalid parameters\n");
+
+	/* rte_rib6_insert_bulk: depth > MAX_DEPTH stops the insert */
+	rte_errno = 0;
+	ret = rte_rib6_insert_bulk(rib, ips, &bad_depth, &nh, 1);
+	RTE_TEST_ASSERT((ret == 0) && (rte_errno == EINVAL),
+		"Call succeeded with invalid parameters\n");
+
 	/* insert the same ip/depth twice*/
 	node = rte_rib6_insert(rib, ip, depth);
 	RTE_TEST_ASSERT(node != NULL, "Failed to insert rule\n");
@@ -328,6 +434,105 @@ test_tree_traversal(void)
 	return TEST_SUCCESS;
 }
 
+/*
+ * Insert routes in bulk, sorted and unsorted, and check the walk
+ * retrieves all of them in prefix order.
+ */
+int32_t
+test_bulk_walk(void)
+{
+	struct rte_rib6 *rib = NULL;
+	struct rte_rib6_conf config;
+	struct route6 *routes;
+	uint8_t (*ips)[RTE_RIB6_IPV6_ADDR_SIZE];
+	uint8_t *depths;
+	uint64_t *nhs;
+	uint8_t zero[RTE_RIB6_IPV6_ADDR_SIZE] = {0};
+	unsigned int i, j, n;
+	int k, ret;
+
+	config.max_nodes = 2 * NUM_BULK_ROUTES;
+	config.ext_sz = 0;
+
+	routes = malloc(NUM_BULK_ROUTES * sizeof(*routes));
+	ips = malloc(NUM_BULK_ROUTES * sizeof(*ips));
+	depths = malloc(NUM_BULK_ROUTES * sizeof(*depths));
+	nhs = malloc(NUM_BULK_ROUTES * sizeof(*nhs));
+	RTE_TEST_ASSERT((routes != NULL) && (ips != NULL) &&
+		(depths != NULL) && (nhs != NULL),
+		"Failed to allocate routes\n");
+
+	/* random routes of 2001:db8::/32, sorted in prefix order */
+	for (i = 0; i < NUM_BULK_ROUTES; i++) {
+		routes[i].depth = 32 + rte_rand_max(MAX_DEPTH - 32 + 1);
+		routes[i].ip[0] = 0x20;
+		routes[i].ip[1] = 0x01;
+		routes[i].ip[2] = 0x0d;
+		routes[i].ip[3] = 0xb8;
+		for (k = 4; k < RTE_RIB6_IPV6_ADDR_SIZE; k++)
+			routes[i].ip[k] = rte_rand() &
+				get_msk_part(routes[i].depth, k);
+		routes[i].nh = i;
+	}
+	qsort(routes, NUM_BULK_ROUTES, sizeof(routes[0]), route6_cmp);
+	for (i = 0, n = 0; i < NUM_BULK_ROUTES; i++) {
+		if ((n != 0) && (route6_cmp(&routes[n - 1], &routes[i]) == 0))
+			continue;
+		routes[n] = routes[i];
+		memcpy(ips[n], routes[n].ip, RTE_RIB6_IPV6_ADDR_SIZE);
+		depths[n] = routes[n].depth;
+		nhs[n] = routes[n].nh;
+		n++;
+	}
+
+	rib = rte_rib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(rib != NULL, "Failed to create RIB\n");
+
+	ret = rte_rib6_insert_bulk(rib,
+		(const uint8_t (*)[RTE_RIB6_IPV6_ADDR_SIZE])ips, depths,
+		nhs, n);
+	RTE_TEST_ASSERT(ret == (int)n, "Failed to insert routes in bulk\n");
+
+	RTE_TEST_ASSERT(check_walk(rib, routes, n, zero, 0) == 0,
+		"Walk of the whole RIB failed\n");
+	for (i = 0; i < 100; i++) {
+		j = rte_rand_max(n);
+		RTE_TEST_ASSERT(check_walk(rib, routes, n, routes[j].ip,
+			routes[j].depth) == 0, "Walk of a subtree failed\n");
+		RTE_TEST_ASSERT(check_walk(rib, routes, n, routes[j].ip,
+			rte_rand_max(routes[j].depth + 1)) == 0,
+			"Walk of a shorter prefix failed\n");
+	}
+	rte_rib6_free(rib);
+
+	/* unsorted insert gives the same RIB */
+	for (i = 0; i < n; i++) {
+		j = rte_rand_max(i + 1);
+		memcpy(ips[i], ips[j], RTE_RIB6_IPV6_ADDR_SIZE);
+		depths[i] = depths[j];
+		nhs[i] = nhs[j];
+		memcpy(ips[j], routes[i].ip, RTE_RIB6_IPV6_ADDR_SIZE);
+		depths[j] = routes[i].depth;
+		nhs[j] = routes[i].nh;
+	}
+	rib = rte_rib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(rib != NULL, "Failed to create RIB\n");
+	ret = rte_rib6_insert_bulk(rib,
+		(const uint8_t (*)[RTE_RIB6_IPV6_ADDR_SIZE])ips, depths,
+		nhs, n);
+	RTE_TEST_ASSERT(ret == (int)n, "Failed to insert routes in bulk\n");
+	RTE_TEST_ASSERT(check_walk(rib, routes, n, zero, 0) == 0,
+		"Walk of unsorted routes failed\n");
+	rte_rib6_free(rib);
+
+	free(routes);
+	free(ips);
+	free(depths);
+	free(nhs);
+
+	return TEST_SUCCESS;
+}
+
 static struct unit_test_suite rib6_tests = {
 	.suite_name = "rib6 autotest",
 	.setup = NULL,
@@ -339,6 +544,7 @@ static struct unit_test_suite rib6_tests = {
 		TEST_CASE(test_get_fn),
 		TEST_CASE(test_basic),
 		TEST_CASE(test_tree_traversal),
+		TEST_CASE(test_bulk_walk),
 		TEST_CASES_END()
 	}
 };
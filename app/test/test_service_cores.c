@@ -808,6 +808,205 @@ service_app_lcore_mt_unsafe(void)
 	return service_app_lcore_poll_impl(mt_safe);
 }
 
+static int32_t
+idle_service(void *args)
+{
+	RTE_SET_USED(args);
+	return -EAGAIN;
+}
+
+/* report work, or no work, for a complete busyness period */
+static void
+busyness_report(uint16_t nb_work)
+{
+	uint64_t end = rte_get_timer_cycles() + rte_get_timer_hz() *
+		(2 * RTE_LCORE_BUSYNESS_PERIOD_MS + 20) / MS_PER_S;
+
+	while (rte_get_timer_cycles() < end) {
+		rte_lcore_busyness_update(nb_work);
+		rte_delay_us(100);
+	}
+	rte_lcore_busyness_update(nb_work);
+}
+
+static int
+service_lcore_busyness(void)
+{
+	struct rte_lcore_busyness_stats before, after;
+	unsigned int lcore_id = rte_lcore_id();
+	uint64_t ms_cycles = rte_get_tsc_hz() / MS_PER_S;
+	int busy;
+
+	TEST_ASSERT_EQUAL(-EINVAL, rte_lcore_busyness(RTE_MAX_LCORE),
+			"Busyness of invalid lcore");
+	TEST_ASSERT_EQUAL(-EINVAL,
+			rte_lcore_busyness_stats_get(lcore_id, NULL),
+			"Busyness stats with NULL pointer");
+
+	/* the time after a report is accounted according to the report */
+	TEST_ASSERT_EQUAL(0, rte_lcore_busyness_stats_get(lcore_id, &before),
+			"Busyness stats get failed");
+	rte_lcore_busyness_update(1);
+	rte_delay_ms(2);
+	rte_lcore_busyness_update(0);
+	rte_delay_ms(2);
+	rte_lcore_busyness_update(0);
+	TEST_ASSERT_EQUAL(0, rte_lcore_busyness_stats_get(lcore_id, &after),
+			"Busyness stats get failed");
+	TEST_ASSERT_EQUAL(3, after.polls - before.polls,
+			"Wrong number of polls");
+	TEST_ASSERT_EQUAL(1, after.busy_polls - before.busy_polls,
+			"Wrong number of busy polls");
+	TEST_ASSERT(after.busy_cycles - before.busy_cycles >= 2 * ms_cycles,
+			"Busy cycles not accounted");
+	TEST_ASSERT(after.idle_cycles - before.idle_cycles >= 2 * ms_cycles,
+			"Idle cycles not accounted");
+
+	busyness_report(1);
+	busy = rte_lcore_busyness(lcore_id);
+	TEST_ASSERT(busy >= 90, "Busy lcore reported %d%% busy", busy);
+	busyness_report(0);
+	busy = rte_lcore_busyness(lcore_id);
+	TEST_ASSERT(busy >= 0 && busy <= 10,
+			"Idle lcore reported %d%% busy", busy);
+
+	rte_lcore_busyness_enable(0);
+	TEST_ASSERT_EQUAL(-ENOTSUP, rte_lcore_busyness(lcore_id),
+			"Busyness reported while disabled");
+	rte_lcore_busyness_stats_get(lcore_id, &before);
+	rte_lcore_busyness_update(1);
+	rte_lcore_busyness_stats_get(lcore_id, &after);
+	TEST_ASSERT_EQUAL(before.polls, after.polls,
+			"Poll accounted while disabled");
+	rte_lcore_busyness_enable(1);
+	TEST_ASSERT_EQUAL(-ENODATA, rte_lcore_busyness(lcore_id),
+			"Busyness reported before any poll");
+
+	/* a service without work returns -EAGAIN */
+	struct rte_service_spec service;
+	uint32_t id;
+
+	memset(&service, 0, sizeof(struct rte_service_spec));
+	snprintf(service.name, sizeof(service.name), DUMMY_SERVICE_NAME);
+	service.callback = idle_service;
+	TEST_ASSERT_EQUAL(0, rte_service_component_register(&service, &id),
+			"Register of idle service failed");
+	rte_service_component_runstate_set(id, 1);
+	rte_service_runstate_set(id, 1);
+
+	rte_lcore_busyness_stats_get(lcore_id, &before);
+	TEST_ASSERT_EQUAL(0, rte_service_run_iter_on_app_lcore(id, 1),
+			"Run of idle service failed");
+	rte_lcore_busyness_stats_get(lcore_id, &after);
+	TEST_ASSERT_EQUAL(1, after.polls - before.polls,
+			"Service run not accounted");
+	TEST_ASSERT_EQUAL(before.busy_polls, after.busy_polls,
+			"Idle service run accounted as busy");
+
+	return unregister_all();
+}
+
+/* busy service, flagging the runs concurrent with another one */
+struct rebalance_params {
+	rte_atomic32_t running;
+	uint32_t concurrent;
+};
+
+static int32_t
+rebalance_service(void *args)
+{
+	struct rebalance_params *params = args;
+
+	if (rte_atomic32_add_return(&params->running, 1) > 1)
+		params->concurrent = 1;
+	rte_delay_us(100);
+	rte_atomic32_dec(&params->running);
+
+	return 0;
+}
+
+static int
+service_lcore_rebalance(void)
+{
+	struct rebalance_params params[2];
+	struct rte_service_spec service;
+	uint32_t ids[2];
+	uint32_t i;
+
+	if (!rte_lcore_is_enabled(0) || !rte_lcore_is_enabled(1) ||
+	    !rte_lcore_is_enabled(2))
+		return TEST_SKIPPED;
+
+	unregister_all();
+
+	uint32_t slcore_1 = rte_get_next_lcore(/* start core */ -1,
+					       /* skip master */ 1,
+					       /* wrap */ 0);
+	uint32_t slcore_2 = rte_get_next_lcore(/* start core */ slcore_1,
+					       /* skip master */ 1,
+					       /* wrap */ 0);
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_add(slcore_1),
+			"Service core add failed");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_add(slcore_2),
+			"Service core add failed");
+
+	/* two MT unsafe services, both mapped to the first core */
+	memset(params, 0, sizeof(params));
+	for (i = 0; i < RTE_DIM(ids); i++) {
+		memset(&service, 0, sizeof(struct rte_service_spec));
+		snprintf(service.name, sizeof(service.name),
+				DUMMY_SERVICE_NAME "_%u", i);
+		service.callback = rebalance_service;
+		service.callback_userdata = &params[i];
+		TEST_ASSERT_EQUAL(0,
+			rte_service_component_register(&service, &ids[i]),
+			"Register of busy service failed");
+		rte_service_component_runstate_set(ids[i], 1);
+		rte_service_runstate_set(ids[i], 1);
+		rte_service_set_stats_enable(ids[i], 1);
+		TEST_ASSERT_EQUAL(0,
+			rte_service_map_lcore_set(ids[i], slcore_1, 1),
+			"Mapping of busy service failed");
+	}
+
+	TEST_ASSERT_EQUAL(-EINVAL, rte_service_lcore_rebalance(101),
+			"Rebalance with invalid threshold");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_start(slcore_1),
+			"Service core start failed");
+	TEST_ASSERT_EQUAL(-ENOTSUP, rte_service_lcore_rebalance(50),
+			"Rebalance with a single service core");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_start(slcore_2),
+			"Service core start failed");
+
+	/* one service moves to the idle core */
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_rebalance(50),
+			"First rebalance must only start the accounting");
+	rte_delay_ms(100);
+	TEST_ASSERT_EQUAL(1, rte_service_lcore_rebalance(50),
+			"No service migrated to the idle core");
+	TEST_ASSERT_EQUAL(1, rte_service_lcore_count_services(slcore_1),
+			"Wrong number of services on the busy core");
+	TEST_ASSERT_EQUAL(1, rte_service_lcore_count_services(slcore_2),
+			"Wrong number of services on the idle core");
+
+	/* the load is now balanced */
+	rte_delay_ms(100);
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_rebalance(50),
+			"Service migrated between balanced cores");
+
+	for (i = 0; i < RTE_DIM(ids); i++) {
+		rte_service_runstate_set(ids[i], 0);
+		TEST_ASSERT_EQUAL(0, params[i].concurrent,
+				"MT unsafe service run by two cores at once");
+	}
+	rte_service_lcore_stop(slcore_1);
+	rte_service_lcore_stop(slcore_2);
+	rte_eal_wait_lcore(slcore_1);
+	rte_eal_wait_lcore(slcore_2);
+
+	return unregister_all();
+}
+
 /* start and stop a service core - ensuring it goes back to sleep */
 static int
 service_lcore_start_stop(void)
@@ -920,6 +1119,8 @@ static struct unit_test_suite service_tests  = {
 		TEST_CASE_ST(dummy_register, NULL, service_app_lcore_mt_safe),
 		TEST_CASE_ST(dummy_register, NULL, service_app_lcore_mt_unsafe),
 		TEST_CASE_ST(dummy_register, NULL, service_may_be_active),
+		TEST_CASE_ST(NULL, NULL, service_lcore_busyness),
+		TEST_CASE_ST(NULL, NULL, service_lcore_rebalance),
 		TEST_CASES_END() /**< NULL terminate unit test array */
 	}
 };
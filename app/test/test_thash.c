@@ -5,6 +5,7 @@
 #include <rte_common.h>
 #include <rte_eal.h>
 #include <rte_ip.h>
+#include <rte_random.h>
 
 #include "test.h"
 
@@ -75,7 +76,7 @@ uint8_t default_rss_key[] = {
 };
 
 static int
-test_thash(void)
+test_toeplitz_hash_calc(void)
 {
 	uint32_t i, j;
 	union rte_thash_tuple tuple;
@@ -140,4 +141,198 @@ test_thash(void)
 	return 0;
 }
 
+#define BULK_TUPLES	37
+static int
+test_toeplitz_hash_bulk(void)
+{
+	struct rte_thash_key key;
+	union rte_thash_tuple tuples[BULK_TUPLES];
+	uint32_t *tuple_ptrs[BULK_TUPLES];
+	uint32_t hashes[BULK_TUPLES];
+	struct rte_ipv6_hdr ipv6_hdr;
+	uint32_t i, j, len, num;
+
+	if (rte_thash_key_init(&key, default_rss_key,
+			RTE_DIM(default_rss_key)) != 0)
+		return -1;
+
+	/* Verification suite, as a burst of IPv4 and a burst of IPv6 */
+	for (i = 0; i < RTE_DIM(v4_tbl); i++) {
+		tuples[i].v4.src_addr = v4_tbl[i].src_ip;
+		tuples[i].v4.dst_addr = v4_tbl[i].dst_ip;
+		tuples[i].v4.sport = v4_tbl[i].src_port;
+		tuples[i].v4.dport = v4_tbl[i].dst_port;
+		tuple_ptrs[i] = (uint32_t *)&tuples[i];
+	}
+	rte_softrss_bulk(&key, tuple_ptrs, RTE_THASH_V4_L3_LEN, hashes,
+			RTE_DIM(v4_tbl));
+	for (i = 0; i < RTE_DIM(v4_tbl); i++)
+		if (hashes[i] != v4_tbl[i].hash_l3)
+			return -1;
+	rte_softrss_bulk(&key, tuple_ptrs, RTE_THASH_V4_L4_LEN, hashes,
+			RTE_DIM(v4_tbl));
+	for (i = 0; i < RTE_DIM(v4_tbl); i++)
+		if (hashes[i] != v4_tbl[i].hash_l3l4)
+			return -1;
+
+	for (i = 0; i < RTE_DIM(v6_tbl); i++) {
+		for (j = 0; j < RTE_DIM(ipv6_hdr.src_addr); j++)
+			ipv6_hdr.src_addr[j] = v6_tbl[i].src_ip[j];
+		for (j = 0; j < RTE_DIM(ipv6_hdr.dst_addr); j++)
+			ipv6_hdr.dst_addr[j] = v6_tbl[i].dst_ip[j];
+		rte_thash_load_v6_addrs(&ipv6_hdr, &tuples[i]);
+		tuples[i].v6.sport = v6_tbl[i].src_port;
+		tuples[i].v6.dport = v6_tbl[i].dst_port;
+	}
+	rte_softrss_bulk(&key, tuple_ptrs, RTE_THASH_V6_L3_LEN, hashes,
+			RTE_DIM(v6_tbl));
+	for (i = 0; i < RTE_DIM(v6_tbl); i++)
+		if (hashes[i] != v6_tbl[i].hash_l3)
+			return -1;
+	rte_softrss_bulk(&key, tuple_ptrs, RTE_THASH_V6_L4_LEN, hashes,
+			RTE_DIM(v6_tbl));
+	for (i = 0; i < RTE_DIM(v6_tbl); i++)
+		if (hashes[i] != v6_tbl[i].hash_l3l4)
+			return -1;
+
+	/* Random tuples of all lengths and burst sizes */
+	for (len = 1; len <= RTE_THASH_V6_L4_LEN; len++) {
+		for (num = 1; num <= BULK_TUPLES; num += 6) {
+			for (i = 0; i < num; i++) {
+				for (j = 0; j < len; j++)
+					((uint32_t *)&tuples[i])[j] =
+						rte_rand();
+				tuple_ptrs[i] = (uint32_t *)&tuples[i];
+			}
+			rte_softrss_bulk(&key, tuple_ptrs, len, hashes, num);
+			for (i = 0; i < num; i++) {
+				if (hashes[i] != rte_softrss(tuple_ptrs[i],
+						len, default_rss_key)) {
+					printf("Bulk hash mismatch, len %u "
+						"tuple %u/%u\n", len, i, num);
+					return -1;
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+
+#define RETA_BITS	7
+static int
+test_toeplitz_adjust_tuple(void)
+{
+	struct rte_thash_key key;
+	union rte_thash_tuple tuple, adj;
+	uint32_t reta_idx, reached = 0;
+	int ret;
+
+	if (rte_thash_key_init(&key, default_rss_key,
+			RTE_DIM(default_rss_key)) != 0)
+		return -1;
+
+	tuple.v4.src_addr = rte_rand();
+	tuple.v4.dst_addr = rte_rand();
+	tuple.v4.sport = rte_rand();
+	tuple.v4.dport = rte_rand();
+
+	/* Any queue can be reached by choosing the source port */
+	for (reta_idx = 0; reta_idx < (1 << RETA_BITS); reta_idx++) {
+		adj = tuple;
+		ret = rte_thash_adjust_tuple(&key, (uint32_t *)&adj,
+				RTE_THASH_V4_L4_LEN, 64, 16, RETA_BITS,
+				reta_idx);
+		if (ret != 0)
+			return -1;
+		if ((rte_softrss((uint32_t *)&adj, RTE_THASH_V4_L4_LEN,
+				default_rss_key) & ((1 << RETA_BITS) - 1)) !=
+				reta_idx)
+			return -1;
+		if (adj.v4.src_addr != tuple.v4.src_addr ||
+				adj.v4.dst_addr != tuple.v4.dst_addr ||
+				adj.v4.dport != tuple.v4.dport)
+			return -1;
+	}
+
+	/* Flipping two bits reaches at most four queues */
+	for (reta_idx = 0; reta_idx < (1 << RETA_BITS); reta_idx++) {
+		adj = tuple;
+		ret = rte_thash_adjust_tuple(&key, (uint32_t *)&adj,
+				RTE_THASH_V4_L4_LEN, 64, 2, RETA_BITS,
+				reta_idx);
+		if (ret == -ENOSPC)
+			continue;
+		if (ret != 0 || (rte_softrss((uint32_t *)&adj,
+				RTE_THASH_V4_L4_LEN, default_rss_key) &
+				((1 << RETA_BITS) - 1)) != reta_idx)
+			return -1;
+		reached++;
+	}
+	if (reached == 0 || reached > 4)
+		return -1;
+
+	return 0;
+}
+
+static int
+test_toeplitz_sym_key(void)
+{
+	uint8_t sym_key[RTE_DIM(default_rss_key)];
+	union rte_thash_tuple tuple, rev;
+	uint32_t i, j;
+
+	if (rte_thash_gen_sym_key(sym_key, RTE_DIM(sym_key)) != 0)
+		return -1;
+
+	for (i = 0; i < 64; i++) {
+		tuple.v4.src_addr = rte_rand();
+		tuple.v4.dst_addr = rte_rand();
+		tuple.v4.sport = rte_rand();
+		tuple.v4.dport = rte_rand();
+		rev.v4.src_addr = tuple.v4.dst_addr;
+		rev.v4.dst_addr = tuple.v4.src_addr;
+		rev.v4.sport = tuple.v4.dport;
+		rev.v4.dport = tuple.v4.sport;
+		if (rte_softrss((uint32_t *)&tuple, RTE_THASH_V4_L4_LEN,
+				sym_key) !=
+				rte_softrss((uint32_t *)&rev,
+				RTE_THASH_V4_L4_LEN, sym_key))
+			return -1;
+
+		for (j = 0; j < RTE_DIM(tuple.v6.src_addr); j++) {
+			tuple.v6.src_addr[j] = rte_rand();
+			tuple.v6.dst_addr[j] = rte_rand();
+			rev.v6.src_addr[j] = tuple.v6.dst_addr[j];
+			rev.v6.dst_addr[j] = tuple.v6.src_addr[j];
+		}
+		tuple.v6.sport = rte_rand();
+		tuple.v6.dport = rte_rand();
+		rev.v6.sport = tuple.v6.dport;
+		rev.v6.dport = tuple.v6.sport;
+		if (rte_softrss((uint32_t *)&tuple, RTE_THASH_V6_L4_LEN,
+				sym_key) !=
+				rte_softrss((uint32_t *)&rev,
+				RTE_THASH_V6_L4_LEN, sym_key))
+			return -1;
+	}
+
+	return 0;
+}
+
+static int
+test_thash(void)
+{
+	if (test_toeplitz_hash_calc() < 0)
+		return -1;
+	if (test_toeplitz_hash_bulk() < 0)
+		return -1;
+	if (test_toeplitz_adjust_tuple() < 0)
+		return -1;
+	if (test_toeplitz_sym_key() < 0)
+		return -1;
+
+	return 0;
+}
+
 REGISTER_TEST_COMMAND(thash_autotest, test_thash);
@@ -371,6 +371,15 @@ dsw_close(struct rte_eventdev *dev)
 	return 0;
 }
 
+static int
+dsw_eth_rx_adapter_caps_get(const struct rte_eventdev *dev __rte_unused,
+			    const struct rte_eth_dev *eth_dev __rte_unused,
+			    uint32_t *caps)
+{
+	*caps = RTE_EVENT_ETH_RX_ADAPTER_SW_CAP;
+	return 0;
+}
+
 static struct rte_eventdev_ops dsw_evdev_ops = {
 	.port_setup = dsw_port_setup,
 	.port_def_conf = dsw_port_def_conf,
@@ -385,6 +394,7 @@ static struct rte_eventdev_ops dsw_evdev_ops = {
 	.dev_start = dsw_start,
 	.dev_stop = dsw_stop,
 	.dev_close = dsw_close,
+	.eth_rx_adapter_caps_get = dsw_eth_rx_adapter_caps_get,
 	.xstats_get = dsw_xstats_get,
 	.xstats_get_names = dsw_xstats_get_names,
 	.xstats_get_by_name = dsw_xstats_get_by_name
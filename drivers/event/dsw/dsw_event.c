@@ -502,6 +502,12 @@ dsw_port_buffer_non_paused(struct dsw_evdev *dsw, struct dsw_port *source_port,
 	buffer[*buffer_len] = *event;
 
 	(*buffer_len)++;
+
+	/* A vector event carries many packets, which must not linger
+	 * in the output buffer of a producer that may stop enqueuing.
+	 */
+	if (event->event_type & RTE_EVENT_TYPE_VECTOR)
+		dsw_port_transmit_buffered(dsw, source_port, dest_port_id);
 }
 
 #define DSW_FLOW_ID_BITS (24)
@@ -0,0 +1,301 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_errno.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_memory.h>
+#include <rte_mempool.h>
+#include <rte_stack.h>
+
+/*
+ * The numa mempool driver keeps one lock-free stack of free objects per
+ * NUMA node. The objects are always returned to the stack of the node
+ * their memory belongs to, grouped in bulk pushes, and are taken from
+ * the stack of the node of the calling lcore. Another node is only used
+ * when the local one is exhausted. So an object freed by an lcore of
+ * another node does not end up being reused there, with its cache lines
+ * bouncing across the interconnect.
+ *
+ * The node of an object is found from the memory chunks given to the
+ * populate callback, whose node is recorded as they are added.
+ */
+
+#define NUMA_POOL_CHUNKS_INIT 8
+
+#ifdef RTE_ARCH_64
+#define NUMA_POOL_STACK_FLAGS RTE_STACK_F_LF
+#else
+#define NUMA_POOL_STACK_FLAGS 0
+#endif
+
+/* A virtually contiguous memory chunk of the mempool on one node */
+struct numa_chunk {
+	uintptr_t start;
+	uintptr_t end;
+	unsigned int socket_id;
+};
+
+struct numa_pool {
+	/* Free objects of each node, NULL for nodes without lcores */
+	struct rte_stack *stacks[RTE_MAX_NUMA_NODES];
+	/* Node for lcores and memory outside of the nodes above */
+	unsigned int default_socket;
+	unsigned int nb_chunks;
+	unsigned int max_chunks;
+	struct numa_chunk *chunks;
+};
+
+static struct rte_stack *
+numa_stack_create(const struct rte_mempool *mp, unsigned int socket_id)
+{
+	char name[RTE_STACK_NAMESIZE];
+	struct rte_stack *s;
+	int ret;
+
+	ret = snprintf(name, sizeof(name), "MPN%u_%s", socket_id, mp->name);
+	if (ret < 0 || ret >= (int)sizeof(name)) {
+		rte_errno = ENAMETOOLONG;
+		return NULL;
+	}
+
+	/* Any node can hold all the objects once the others are empty */
+	s = rte_stack_create(name, mp->size, socket_id,
+			NUMA_POOL_STACK_FLAGS);
+	if (s == NULL && rte_errno != ENAMETOOLONG)
+		/* No memory left on this node, fall back on any */
+		s = rte_stack_create(name, mp->size, SOCKET_ID_ANY,
+				NUMA_POOL_STACK_FLAGS);
+
+	return s;
+}
+
+static void
+numa_free(struct rte_mempool *mp)
+{
+	struct numa_pool *np = mp->pool_data;
+	unsigned int i;
+
+	if (np == NULL)
+		return;
+
+	for (i = 0; i < RTE_MAX_NUMA_NODES; i++)
+		rte_stack_free(np->stacks[i]);
+	rte_free(np->chunks);
+	rte_free(np);
+	mp->pool_data = NULL;
+}
+
+static int
+numa_alloc(struct rte_mempool *mp)
+{
+	struct numa_pool *np;
+	unsigned int i;
+	int socket_id;
+
+	np = rte_zmalloc_socket("numa_pool", sizeof(*np),
+			RTE_CACHE_LINE_SIZE, mp->socket_id);
+	if (np == NULL)
+		return -ENOMEM;
+	mp->pool_data = np;
+
+	np->max_chunks = NUMA_POOL_CHUNKS_INIT;
+	np->chunks = rte_zmalloc_socket("numa_pool_chunks",
+			np->max_chunks * sizeof(np->chunks[0]), 0,
+			mp->socket_id);
+	if (np->chunks == NULL) {
+		numa_free(mp);
+		return -ENOMEM;
+	}
+
+	np->default_socket = RTE_MAX_NUMA_NODES;
+	for (i = 0; i < rte_socket_count(); i++) {
+		socket_id = rte_socket_id_by_idx(i);
+		if (socket_id < 0 || socket_id >= RTE_MAX_NUMA_NODES)
+			continue;
+
+		np->stacks[socket_id] = numa_stack_create(mp, socket_id);
+		if (np->stacks[socket_id] == NULL) {
+			numa_free(mp);
+			return -rte_errno;
+		}
+
+		if (np->default_socket == RTE_MAX_NUMA_NODES ||
+				socket_id == mp->socket_id)
+			np->default_socket = socket_id;
+	}
+
+	if (np->default_socket == RTE_MAX_NUMA_NODES) {
+		numa_free(mp);
+		return -ENODEV;
+	}
+
+	return 0;
+}
+
+/* Get the node of an object, checking first the chunk of the previous one */
+static inline unsigned int
+numa_obj_socket(const struct numa_pool *np, const void *obj,
+		unsigned int *last)
+{
+	const uintptr_t addr = (uintptr_t)obj;
+	const struct numa_chunk *c = &np->chunks[*last];
+	unsigned int i;
+
+	if (likely(addr - c->start < c->end - c->start))
+		return c->socket_id;
+
+	for (i = 0; i < np->nb_chunks; i++) {
+		c = &np->chunks[i];
+		if (addr - c->start < c->end - c->start) {
+			*last = i;
+			return c->socket_id;
+		}
+	}
+
+	return np->default_socket;
+}
+
+static int
+numa_enqueue(struct rte_mempool *mp, void * const *obj_table,
+	     unsigned int n)
+{
+	struct numa_pool *np = mp->pool_data;
+	unsigned int i, start, socket_id, run_socket_id, last = 0;
+	int ret = 0;
+
+	if (unlikely(n == 0))
+		return 0;
+
+	/* Push each run of objects of the same node in one go */
+	start = 0;
+	run_socket_id = numa_obj_socket(np, obj_table[0], &last);
+	for (i = 1; i < n; i++) {
+		socket_id = numa_obj_socket(np, obj_table[i], &last);
+		if (likely(socket_id == run_socket_id))
+			continue;
+
+		if (rte_stack_push(np->stacks[run_socket_id],
+				&obj_table[start], i - start) == 0)
+			ret = -ENOBUFS;
+		start = i;
+		run_socket_id = socket_id;
+	}
+	if (rte_stack_push(np->stacks[run_socket_id], &obj_table[start],
+			n - start) == 0)
+		ret = -ENOBUFS;
+
+	return ret;
+}
+
+static int
+numa_dequeue(struct rte_mempool *mp, void **obj_table,
+	     unsigned int n)
+{
+	struct numa_pool *np = mp->pool_data;
+	unsigned int socket_id = rte_socket_id();
+	unsigned int i, cnt, got = 0;
+	struct rte_stack *s;
+
+	if (unlikely(socket_id >= RTE_MAX_NUMA_NODES ||
+			np->stacks[socket_id] == NULL))
+		socket_id = np->default_socket;
+
+	if (likely(rte_stack_pop(np->stacks[socket_id], obj_table, n) == n))
+		return 0;
+
+	/*
+	 * The local node is exhausted: take what it has left, then take
+	 * the rest from the other nodes. A pop takes all or nothing, and
+	 * fails when other lcores took objects since the count was read,
+	 * so retry with a new count until the stack is empty.
+	 */
+	for (i = 0; i < RTE_MAX_NUMA_NODES && got < n; i++) {
+		s = np->stacks[(socket_id + i) % RTE_MAX_NUMA_NODES];
+		if (s == NULL)
+			continue;
+		while (got < n) {
+			cnt = RTE_MIN(rte_stack_count(s), n - got);
+			if (cnt == 0)
+				break;
+			got += rte_stack_pop(s, &obj_table[got], cnt);
+		}
+	}
+
+	if (got < n) {
+		numa_enqueue(mp, obj_table, got);
+		return -ENOBUFS;
+	}
+
+	return 0;
+}
+
+static unsigned int
+numa_get_count(const struct rte_mempool *mp)
+{
+	const struct numa_pool *np = mp->pool_data;
+	unsigned int i, count = 0;
+
+	for (i = 0; i < RTE_MAX_NUMA_NODES; i++)
+		if (np->stacks[i] != NULL)
+			count += rte_stack_count(np->stacks[i]);
+
+	return count;
+}
+
+static int
+numa_populate(struct rte_mempool *mp, unsigned int max_objs,
+	      void *vaddr, rte_iova_t iova, size_t len,
+	      rte_mempool_populate_obj_cb_t *obj_cb, void *obj_cb_arg)
+{
+	struct numa_pool *np = mp->pool_data;
+	unsigned int socket_id = np->default_socket;
+	const struct rte_memseg_list *msl;
+	struct numa_chunk *c;
+
+	/* Memory outside of the DPDK heaps goes to the default node */
+	msl = rte_mem_virt2memseg_list(vaddr);
+	if (msl != NULL && msl->socket_id >= 0 &&
+			msl->socket_id < RTE_MAX_NUMA_NODES &&
+			np->stacks[msl->socket_id] != NULL)
+		socket_id = msl->socket_id;
+
+	c = np->nb_chunks != 0 ? &np->chunks[np->nb_chunks - 1] : NULL;
+	if (c != NULL && c->end == (uintptr_t)vaddr &&
+			c->socket_id == socket_id) {
+		c->end += len;
+	} else {
+		if (np->nb_chunks == np->max_chunks) {
+			c = rte_realloc(np->chunks,
+				2 * np->max_chunks * sizeof(*c), 0);
+			if (c == NULL)
+				return -ENOMEM;
+			np->chunks = c;
+			np->max_chunks *= 2;
+		}
+		c = &np->chunks[np->nb_chunks];
+		c->start = (uintptr_t)vaddr;
+		c->end = (uintptr_t)vaddr + len;
+		c->socket_id = socket_id;
+		np->nb_chunks++;
+	}
+
+	return rte_mempool_op_populate_helper(mp, 0, max_objs, vaddr, iova,
+			len, obj_cb, obj_cb_arg);
+}
+
+static struct rte_mempool_ops ops_numa = {
+	.name = "numa_stack",
+	.alloc = numa_alloc,
+	.free = numa_free,
+	.enqueue = numa_enqueue,
+	.dequeue = numa_dequeue,
+	.get_count = numa_get_count,
+	.populate = numa_populate,
+};
+
+MEMPOOL_REGISTER_OPS(ops_numa);
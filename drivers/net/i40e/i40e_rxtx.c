@@ -2056,6 +2056,24 @@ i40e_dev_rx_descriptor_status(void *rx_queue, uint16_t offset)
 	return RTE_ETH_RX_DESC_AVAIL;
 }
 
+int
+i40e_get_monitor_addr(void *rx_queue, struct rte_power_monitor_cond *pmc)
+{
+	struct i40e_rx_queue *rxq = rx_queue;
+	volatile union i40e_rx_desc *rxdp;
+
+	rxdp = &rxq->rx_ring[rxq->rx_tail];
+
+	/* watch for the DD bit of the next descriptor to be filled */
+	pmc->addr = &rxdp->wb.qword1.status_error_len;
+	pmc->val = rte_cpu_to_le_64((1ULL << I40E_RX_DESC_STATUS_DD_SHIFT)
+		<< I40E_RXD_QW1_STATUS_SHIFT);
+	pmc->mask = pmc->val;
+	pmc->size = sizeof(uint64_t);
+
+	return 0;
+}
+
 int
 i40e_dev_tx_descriptor_status(void *tx_queue, uint16_t offset)
 {
@@ -3264,6 +3264,23 @@ ixgbe_dev_rx_descriptor_status(void *rx_queue, uint16_t offset)
 	return RTE_ETH_RX_DESC_AVAIL;
 }
 
+int
+ixgbe_get_monitor_addr(void *rx_queue, struct rte_power_monitor_cond *pmc)
+{
+	struct ixgbe_rx_queue *rxq = rx_queue;
+	volatile union ixgbe_adv_rx_desc *rxdp;
+
+	rxdp = &rxq->rx_ring[rxq->rx_tail];
+
+	/* watch for the DD bit of the next descriptor to be filled */
+	pmc->addr = &rxdp->wb.upper.status_error;
+	pmc->val = rte_cpu_to_le_32(IXGBE_RXDADV_STAT_DD);
+	pmc->mask = pmc->val;
+	pmc->size = sizeof(uint32_t);
+
+	return 0;
+}
+
 int
 ixgbe_dev_tx_descriptor_status(void *tx_queue, uint16_t offset)
 {
@@ -45,6 +45,7 @@
 #include <rte_power.h>
 #include <rte_spinlock.h>
 #include <rte_power_empty_poll.h>
+#include <rte_power_pmd_mgmt.h>
 #include <rte_metrics.h>
 
 #include "perf_core.h"
@@ -196,11 +197,14 @@ static int parse_ptype; /**< Parse packet type using rx callback, and */
 enum appmode {
 	APP_MODE_LEGACY = 0,
 	APP_MODE_EMPTY_POLL,
-	APP_MODE_TELEMETRY
+	APP_MODE_TELEMETRY,
+	APP_MODE_PMD_MGMT
 };
 
 enum appmode app_mode;
 
+static enum rte_power_pmd_mgmt_type pmgmt_type;
+
 enum freq_scale_hint_t
 {
 	FREQ_LOWER    =      -1,
@@ -401,6 +405,15 @@ static struct lcore_conf lcore_conf[RTE_MAX_LCORE] __rte_cache_aligned;
 static struct lcore_stats stats[RTE_MAX_LCORE] __rte_cache_aligned;
 static struct rte_timer power_timers[RTE_MAX_LCORE];
 
+/* PMD power management statistics at the previous report */
+struct pmd_mgmt_report {
+	struct rte_power_pmd_mgmt_stats stats;
+	uint64_t tsc;
+};
+static struct pmd_mgmt_report
+	pmgmt_report[RTE_MAX_LCORE][MAX_RX_QUEUE_PER_LCORE];
+static struct rte_timer pmgmt_timer;
+
 static inline uint32_t power_idle_heuristic(uint32_t zero_rx_packet_count);
 static inline enum freq_scale_hint_t power_freq_scaleup_heuristic( \
 		unsigned int lcore_id, uint16_t port_id, uint16_t queue_id);
@@ -428,7 +441,8 @@ signal_exit_now(int sigtype)
 
 	if (sigtype == SIGINT) {
 		if (app_mode == APP_MODE_EMPTY_POLL ||
-				app_mode == APP_MODE_TELEMETRY)
+				app_mode == APP_MODE_TELEMETRY ||
+				app_mode == APP_MODE_PMD_MGMT)
 			quit_signal = true;
 
 
@@ -1374,6 +1388,11 @@ check_lcore_params(void)
 				rte_lcore_id());
 			return -1;
 		}
+		if (app_mode == APP_MODE_PMD_MGMT && lcore == rte_lcore_id()) {
+			printf("cannot enable master core %d in config for PMD power management mode\n",
+				rte_lcore_id());
+			return -1;
+		}
 	}
 	return 0;
 }
@@ -1460,7 +1479,9 @@ print_usage(const char *prgname)
 		"  --empty-poll: enable empty poll detection"
 		" follow (training_flag, high_threshold, med_threshold)\n"
 		" --telemetry: enable telemetry mode, to update"
-		" empty polls, full polls, and core busyness to telemetry\n",
+		" empty polls, full polls, and core busyness to telemetry\n"
+		" --pmd-mgmt MODE: enable PMD power management mode,"
+		" MODE is monitor or pause\n",
 		prgname);
 }
 
@@ -1604,6 +1625,7 @@ parse_ep_config(const char *q_arg)
 }
 #define CMD_LINE_OPT_PARSE_PTYPE "parse-ptype"
 #define CMD_LINE_OPT_TELEMETRY "telemetry"
+#define CMD_LINE_OPT_PMD_MGMT "pmd-mgmt"
 
 /* Parse the argument given in the command line of the application */
 static int
@@ -1623,6 +1645,7 @@ parse_args(int argc, char **argv)
 		{"empty-poll", 1, 0, 0},
 		{CMD_LINE_OPT_PARSE_PTYPE, 0, 0, 0},
 		{CMD_LINE_OPT_TELEMETRY, 0, 0, 0},
+		{CMD_LINE_OPT_PMD_MGMT, 1, 0, 0},
 		{NULL, 0, 0, 0}
 	};
 
@@ -1700,6 +1723,10 @@ parse_args(int argc, char **argv)
 					printf(" empty-poll cannot be enabled as telemetry mode is enabled\n");
 					return -1;
 				}
+				if (app_mode == APP_MODE_PMD_MGMT) {
+					printf(" empty-poll cannot be enabled as PMD power management mode is enabled\n");
+					return -1;
+				}
 				app_mode = APP_MODE_EMPTY_POLL;
 				ret = parse_ep_config(optarg);
 
@@ -1718,10 +1745,34 @@ parse_args(int argc, char **argv)
 					printf("telemetry mode cannot be enabled as empty poll mode is enabled\n");
 					return -1;
 				}
+				if (app_mode == APP_MODE_PMD_MGMT) {
+					printf("telemetry mode cannot be enabled as PMD power management mode is enabled\n");
+					return -1;
+				}
 				app_mode = APP_MODE_TELEMETRY;
 				printf("telemetry mode is enabled\n");
 			}
 
+			if (!strncmp(lgopts[option_index].name,
+					CMD_LINE_OPT_PMD_MGMT,
+					sizeof(CMD_LINE_OPT_PMD_MGMT))) {
+				if (app_mode != APP_MODE_LEGACY) {
+					printf("PMD power management mode cannot be enabled with another mode\n");
+					return -1;
+				}
+				if (!strcmp(optarg, "monitor"))
+					pmgmt_type = RTE_POWER_MGMT_TYPE_MONITOR;
+				else if (!strcmp(optarg, "pause"))
+					pmgmt_type = RTE_POWER_MGMT_TYPE_PAUSE;
+				else {
+					printf("invalid PMD power management mode\n");
+					print_usage(prgname);
+					return -1;
+				}
+				app_mode = APP_MODE_PMD_MGMT;
+				printf("PMD power management mode is enabled\n");
+			}
+
 			if (!strncmp(lgopts[option_index].name,
 					"enable-jumbo", 12)) {
 				struct option lenopts =
@@ -2132,6 +2183,60 @@ telemetry_setup_timer(void)
 			NULL);
 }
 static void
+update_pmd_mgmt(__attribute__((unused)) struct rte_timer *tim,
+		__attribute__((unused)) void *arg)
+{
+	struct rte_power_pmd_mgmt_stats cur;
+	struct pmd_mgmt_report *prev;
+	struct lcore_rx_queue *rx_queue;
+	struct lcore_conf *qconf;
+	uint64_t now, sleeps, cycles;
+	unsigned int lcore_id, i;
+
+	RTE_LCORE_FOREACH_SLAVE(lcore_id) {
+		qconf = &lcore_conf[lcore_id];
+		for (i = 0; i < qconf->n_rx_queue; i++) {
+			rx_queue = &qconf->rx_queue_list[i];
+			if (rte_power_pmd_mgmt_queue_stats_get(
+					rx_queue->port_id, rx_queue->queue_id,
+					&cur) < 0)
+				continue;
+			now = rte_rdtsc();
+			prev = &pmgmt_report[lcore_id][i];
+			if (prev->tsc != 0) {
+				sleeps = cur.sleeps - prev->stats.sleeps;
+				cycles = cur.sleep_cycles -
+					prev->stats.sleep_cycles;
+				printf("lcore %u port %u queue %u: "
+					"asleep %.1f%%, %"PRIu64" waits, "
+					"average wait %.2f us\n",
+					lcore_id, rx_queue->port_id,
+					rx_queue->queue_id,
+					100.0 * cycles / (now - prev->tsc),
+					sleeps, sleeps == 0 ? 0.0 :
+					(double)cycles * US_PER_S /
+					rte_get_tsc_hz() / sleeps);
+			}
+			prev->stats = cur;
+			prev->tsc = now;
+		}
+	}
+}
+static void
+pmd_mgmt_setup_timer(void)
+{
+	int lcore_id = rte_lcore_id();
+	uint64_t hz = rte_get_timer_hz();
+
+	rte_timer_init(&pmgmt_timer);
+	rte_timer_reset_sync(&pmgmt_timer,
+			hz,
+			PERIODICAL,
+			lcore_id,
+			update_pmd_mgmt,
+			NULL);
+}
+static void
 empty_poll_setup_timer(void)
 {
 	int lcore_id = rte_lcore_id();
@@ -2167,6 +2272,8 @@ launch_timer(unsigned int lcore_id)
 
 	if (app_mode == APP_MODE_EMPTY_POLL)
 		empty_poll_setup_timer();
+	else if (app_mode == APP_MODE_PMD_MGMT)
+		pmd_mgmt_setup_timer();
 	else
 		telemetry_setup_timer();
 
@@ -2281,6 +2388,9 @@ main(int argc, char **argv)
 		/* If number of Rx queue is 0, no need to enable Rx interrupt */
 		if (nb_rx_queue == 0)
 			local_port_conf.intr_conf.rxq = 0;
+		/* PMD power management waits without Rx interrupts */
+		if (app_mode == APP_MODE_PMD_MGMT)
+			local_port_conf.intr_conf.rxq = 0;
 
 		ret = rte_eth_dev_info_get(portid, &dev_info);
 		if (ret != 0)
@@ -2431,6 +2541,15 @@ main(int argc, char **argv)
 					"rte_eth_rx_queue_setup: err=%d, "
 						"port=%d\n", ret, portid);
 
+			if (app_mode == APP_MODE_PMD_MGMT) {
+				ret = rte_power_pmd_mgmt_queue_enable(lcore_id,
+						portid, queueid, pmgmt_type);
+				if (ret < 0)
+					rte_exit(EXIT_FAILURE,
+						"rte_power_pmd_mgmt_queue_enable: "
+						"err=%d, port=%d\n", ret, portid);
+			}
+
 			if (parse_ptype) {
 				if (add_cb_parse_ptype(portid, queueid) < 0)
 					rte_exit(EXIT_FAILURE,
@@ -2497,6 +2616,9 @@ main(int argc, char **argv)
 		empty_poll_stop = false;
 		rte_eal_mp_remote_launch(main_empty_poll_loop, NULL,
 				SKIP_MASTER);
+	} else if (app_mode == APP_MODE_PMD_MGMT) {
+		rte_eal_mp_remote_launch(main_telemetry_loop, NULL,
+				SKIP_MASTER);
 	} else {
 		unsigned int i;
 
@@ -2520,7 +2642,7 @@ main(int argc, char **argv)
 						SKIP_MASTER);
 	}
 
-	if (app_mode == APP_MODE_EMPTY_POLL || app_mode == APP_MODE_TELEMETRY)
+	if (app_mode != APP_MODE_LEGACY)
 		launch_timer(rte_lcore_id());
 
 	RTE_LCORE_FOREACH_SLAVE(lcore_id) {
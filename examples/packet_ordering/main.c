@@ -41,10 +41,6 @@ static struct rte_eth_conf port_conf_default;
 struct worker_thread_args {
 	struct rte_ring *ring_in;
 	struct rte_ring *ring_out;
-};
-
-struct send_thread_args {
-	struct rte_ring *ring_in;
 	struct rte_reorder_buffer *buffer;
 };
 
@@ -63,10 +59,6 @@ volatile struct app_stats {
 
 	struct {
 		uint64_t dequeue_pkts;
-		/* Too early pkts transmitted directly w/o reordering */
-		uint64_t early_pkts_txtd_woro;
-		/* Too early pkts failed from direct transmit */
-		uint64_t early_pkts_tx_failed_woro;
 		uint64_t ro_tx_pkts;
 		uint64_t ro_tx_failed_pkts;
 	} tx __rte_cache_aligned;
@@ -368,7 +360,7 @@ print_stats(void)
 					lcore_id);
 			printf(" - Pkts deqd from workers ring:		%"PRIu64"\n",
 					wkr_stats[lcore_id].deq_pkts);
-			printf(" - Pkts enqd to tx ring:		%"PRIu64"\n",
+			printf(" - Pkts enqd to tx:			%"PRIu64"\n",
 					wkr_stats[lcore_id].enq_pkts);
 			printf(" - Pkts enq to tx failed:		%"PRIu64"\n",
 					wkr_stats[lcore_id].enq_failed_pkts);
@@ -383,22 +375,18 @@ print_stats(void)
 	printf("\nWorker thread stats:\n");
 	printf(" - Pkts deqd from workers ring:		%"PRIu64"\n",
 						app_stats.wkr.dequeue_pkts);
-	printf(" - Pkts enqd to tx ring:		%"PRIu64"\n",
+	printf(" - Pkts enqd to tx:			%"PRIu64"\n",
 						app_stats.wkr.enqueue_pkts);
 	printf(" - Pkts enq to tx failed:		%"PRIu64"\n",
 						app_stats.wkr.enqueue_failed_pkts);
 
 	printf("\nTX stats:\n");
-	printf(" - Pkts deqd from tx ring:		%"PRIu64"\n",
+	printf(" - Pkts deqd from tx ring/reorder:	%"PRIu64"\n",
 						app_stats.tx.dequeue_pkts);
 	printf(" - Ro Pkts transmitted:			%"PRIu64"\n",
 						app_stats.tx.ro_tx_pkts);
 	printf(" - Ro Pkts tx failed:			%"PRIu64"\n",
 						app_stats.tx.ro_tx_failed_pkts);
-	printf(" - Pkts transmitted w/o reorder:	%"PRIu64"\n",
-						app_stats.tx.early_pkts_txtd_woro);
-	printf(" - Pkts tx failed w/o reorder:		%"PRIu64"\n",
-						app_stats.tx.early_pkts_tx_failed_woro);
 
 	RTE_ETH_FOREACH_DEV(i) {
 		rte_eth_stats_get(i, &eth_stats);
@@ -474,7 +462,7 @@ rx_thread(struct rte_ring *ring_out)
 /**
  * This thread takes bursts of packets from the rx_to_workers ring and
  * Changes the input port value to output port value. And feds it to
- * workers_to_tx
+ * the reorder buffer, or to workers_to_tx when reordering is disabled
  */
 static int
 worker_thread(void *args_ptr)
@@ -485,12 +473,14 @@ worker_thread(void *args_ptr)
 	struct worker_thread_args *args;
 	struct rte_mbuf *burst_buffer[MAX_PKTS_BURST] = { NULL };
 	struct rte_ring *ring_in, *ring_out;
+	struct rte_reorder_buffer *buffer;
 	const unsigned xor_val = (nb_ports > 1);
 	unsigned int core_id = rte_lcore_id();
 
 	args = (struct worker_thread_args *) args_ptr;
 	ring_in  = args->ring_in;
 	ring_out = args->ring_out;
+	buffer = args->buffer;
 
 	RTE_LOG(INFO, REORDERAPP, "%s() started on lcore %u\n", __func__,
 							core_id);
@@ -509,6 +499,35 @@ worker_thread(void *args_ptr)
 		for (i = 0; i < burst_size;)
 			burst_buffer[i++]->port ^= xor_val;
 
+		if (buffer != NULL) {
+			/* insert the modified mbufs in the reorder buffer */
+			i = 0;
+			while (i < burst_size && !quit_signal) {
+				ret = rte_reorder_insert_bulk_mp(buffer,
+						&burst_buffer[i], burst_size - i);
+				wkr_stats[core_id].enq_pkts += ret;
+				i += ret;
+				if (i == burst_size)
+					break;
+				/*
+				 * Early pkts are retried, the send thread
+				 * moves the window for them. Late pkts are
+				 * dropped.
+				 */
+				if (rte_errno == ENOSPC)
+					continue;
+				wkr_stats[core_id].enq_failed_pkts++;
+				rte_pktmbuf_free(burst_buffer[i++]);
+			}
+			if (unlikely(i < burst_size)) {
+				wkr_stats[core_id].enq_failed_pkts +=
+						burst_size - i;
+				pktmbuf_free_bulk(&burst_buffer[i],
+						burst_size - i);
+			}
+			continue;
+		}
+
 		/* enqueue the modified mbufs to workers_to_tx ring */
 		ret = rte_ring_enqueue_burst(ring_out, (void *)burst_buffer,
 				burst_size, NULL);
@@ -523,18 +542,14 @@ worker_thread(void *args_ptr)
 }
 
 /**
- * Dequeue mbufs from the workers_to_tx ring and reorder them before
- * transmitting.
+ * Drain the mbufs inserted by the workers from the reorder buffer and
+ * transmit them in order.
  */
 static int
-send_thread(struct send_thread_args *args)
+send_thread(struct rte_reorder_buffer *buffer)
 {
-	int ret;
 	unsigned int i, dret;
-	uint16_t nb_dq_mbufs;
-	uint8_t outp;
 	unsigned sent;
-	struct rte_mbuf *mbufs[MAX_PKTS_BURST];
 	struct rte_mbuf *rombufs[MAX_PKTS_BURST] = {NULL};
 	static struct rte_eth_dev_tx_buffer *tx_buffer[RTE_MAX_ETHPORTS];
 
@@ -544,47 +559,16 @@ send_thread(struct send_thread_args *args)
 
 	while (!quit_signal) {
 
-		/* deque the mbufs from workers_to_tx ring */
-		nb_dq_mbufs = rte_ring_dequeue_burst(args->ring_in,
-				(void *)mbufs, MAX_PKTS_BURST, NULL);
-
-		if (unlikely(nb_dq_mbufs == 0))
-			continue;
-
-		app_stats.tx.dequeue_pkts += nb_dq_mbufs;
-
-		for (i = 0; i < nb_dq_mbufs; i++) {
-			/* send dequeued mbufs for reordering */
-			ret = rte_reorder_insert(args->buffer, mbufs[i]);
-
-			if (ret == -1 && rte_errno == ERANGE) {
-				/* Too early pkts should be transmitted out directly */
-				RTE_LOG_DP(DEBUG, REORDERAPP,
-						"%s():Cannot reorder early packet "
-						"direct enqueuing to TX\n", __func__);
-				outp = mbufs[i]->port;
-				if ((portmask & (1 << outp)) == 0) {
-					rte_pktmbuf_free(mbufs[i]);
-					continue;
-				}
-				if (rte_eth_tx_burst(outp, 0, (void *)mbufs[i], 1) != 1) {
-					rte_pktmbuf_free(mbufs[i]);
-					app_stats.tx.early_pkts_tx_failed_woro++;
-				} else
-					app_stats.tx.early_pkts_txtd_woro++;
-			} else if (ret == -1 && rte_errno == ENOSPC) {
-				/**
-				 * Early pkts just outside of window should be dropped
-				 */
-				rte_pktmbuf_free(mbufs[i]);
-			}
-		}
-
 		/*
 		 * drain MAX_PKTS_BURST of reordered
 		 * mbufs for transmit
 		 */
-		dret = rte_reorder_drain(args->buffer, rombufs, MAX_PKTS_BURST);
+		dret = rte_reorder_drain_mp(buffer, rombufs, MAX_PKTS_BURST);
+		if (unlikely(dret == 0))
+			continue;
+
+		app_stats.tx.dequeue_pkts += dret;
+
 		for (i = 0; i < dret; i++) {
 
 			struct rte_eth_dev_tx_buffer *outbuf;
@@ -664,10 +648,9 @@ main(int argc, char **argv)
 	unsigned int lcore_id, last_lcore_id, master_lcore_id;
 	uint16_t port_id;
 	uint16_t nb_ports_available;
-	struct worker_thread_args worker_args = {NULL, NULL};
-	struct send_thread_args send_args = {NULL, NULL};
+	struct worker_thread_args worker_args = {NULL, NULL, NULL};
 	struct rte_ring *rx_to_workers;
-	struct rte_ring *workers_to_tx;
+	struct rte_ring *workers_to_tx = NULL;
 
 	/* catch ctrl-c so we can print on exit */
 	signal(SIGINT, int_handler);
@@ -735,15 +718,16 @@ main(int argc, char **argv)
 	if (rx_to_workers == NULL)
 		rte_exit(EXIT_FAILURE, "%s\n", rte_strerror(rte_errno));
 
-	workers_to_tx = rte_ring_create("workers_to_tx", RING_SIZE, rte_socket_id(),
-			RING_F_SC_DEQ);
-	if (workers_to_tx == NULL)
-		rte_exit(EXIT_FAILURE, "%s\n", rte_strerror(rte_errno));
-
-	if (!disable_reorder) {
-		send_args.buffer = rte_reorder_create("PKT_RO", rte_socket_id(),
-				REORDER_BUFFER_SIZE);
-		if (send_args.buffer == NULL)
+	if (disable_reorder) {
+		workers_to_tx = rte_ring_create("workers_to_tx", RING_SIZE,
+				rte_socket_id(), RING_F_SC_DEQ);
+		if (workers_to_tx == NULL)
+			rte_exit(EXIT_FAILURE, "%s\n", rte_strerror(rte_errno));
+	} else {
+		/* Workers insert in the reorder buffer directly */
+		worker_args.buffer = rte_reorder_create("PKT_RO",
+				rte_socket_id(), REORDER_BUFFER_SIZE);
+		if (worker_args.buffer == NULL)
 			rte_exit(EXIT_FAILURE, "%s\n", rte_strerror(rte_errno));
 	}
 
@@ -764,10 +748,9 @@ main(int argc, char **argv)
 		rte_eal_remote_launch((lcore_function_t *)tx_thread, workers_to_tx,
 				last_lcore_id);
 	} else {
-		send_args.ring_in = workers_to_tx;
 		/* Start send_thread() on the last slave core */
 		rte_eal_remote_launch((lcore_function_t *)send_thread,
-				(void *)&send_args, last_lcore_id);
+				worker_args.buffer, last_lcore_id);
 	}
 
 	/* Start rx_thread() on the master core */
@@ -213,27 +213,61 @@ create_efd_table(void)
 		rte_exit(EXIT_FAILURE, "Problem creating the flow table\n");
 }
 
+/* Flows to add in the EFD table, split in shards among all the lcores */
+struct efd_flows {
+	uint32_t *ip_dst;
+	const void **keys;
+	efd_value_t *node_ids;
+};
+
+static int
+populate_efd_shard(void *arg)
+{
+	struct efd_flows *flows = arg;
+
+	return rte_efd_update_bulk_shard(efd_table, rte_socket_id(),
+			num_flows, flows->keys, flows->node_ids, NULL,
+			rte_lcore_index(rte_lcore_id()), rte_lcore_count());
+}
+
 static void
 populate_efd_table(void)
 {
-	unsigned int i;
-	int32_t ret;
-	uint32_t ip_dst;
-	uint8_t socket_id = rte_socket_id();
-	uint64_t node_id;
+	unsigned int i, lcore_id;
+	struct efd_flows flows;
+	int ret;
+
+	flows.ip_dst = rte_malloc(NULL, num_flows * sizeof(uint32_t), 0);
+	flows.keys = rte_malloc(NULL, num_flows * sizeof(void *), 0);
+	flows.node_ids = rte_malloc(NULL, num_flows * sizeof(efd_value_t), 0);
+	if (flows.ip_dst == NULL || flows.keys == NULL ||
+			flows.node_ids == NULL)
+		rte_exit(EXIT_FAILURE, "Cannot allocate the flows\n");
 
-	/* Add flows in table */
 	for (i = 0; i < num_flows; i++) {
-		node_id = i % num_nodes;
-
-		ip_dst = rte_cpu_to_be_32(i);
-		ret = rte_efd_update(efd_table, socket_id,
-				(void *)&ip_dst, (efd_value_t)node_id);
-		if (ret < 0)
-			rte_exit(EXIT_FAILURE, "Unable to add entry %u in "
-					"EFD table\n", i);
+		flows.ip_dst[i] = rte_cpu_to_be_32(i);
+		flows.keys[i] = &flows.ip_dst[i];
+		flows.node_ids[i] = (efd_value_t)(i % num_nodes);
 	}
 
+	/*
+	 * Add flows in table: each lcore builds the chunks of its shard,
+	 * each chunk getting all its flows at once
+	 */
+	rte_eal_mp_remote_launch(populate_efd_shard, &flows, SKIP_MASTER);
+	ret = populate_efd_shard(&flows);
+	RTE_LCORE_FOREACH_SLAVE(lcore_id) {
+		if (rte_eal_wait_lcore(lcore_id) != 0)
+			ret = -1;
+	}
+	if (ret != 0)
+		rte_exit(EXIT_FAILURE, "Unable to add all the entries in "
+				"EFD table\n");
+
+	rte_free(flows.ip_dst);
+	rte_free(flows.keys);
+	rte_free(flows.node_ids);
+
 	printf("EFD table: Adding 0x%x keys\n", num_flows);
 }
 
@@ -122,6 +122,9 @@ rte_bbdev_data_alloc(void)
 		mz = rte_memzone_reserve(MZ_RTE_BBDEV_DATA,
 				RTE_BBDEV_MAX_DEVS * sizeof(*rte_bbdev_data),
 				rte_socket_id(), flags);
+		/* a warm restarted primary takes over the previous one */
+		if (mz == NULL && rte_eal_warm_restarted())
+			mz = rte_memzone_lookup(MZ_RTE_BBDEV_DATA);
 	} else
 		mz = rte_memzone_lookup(MZ_RTE_BBDEV_DATA);
 	if (mz == NULL) {
@@ -15,6 +15,7 @@
 #include <rte_memory.h>
 #include <rte_eal.h>
 #include <rte_byteorder.h>
+#include <rte_mbuf.h>
 
 #include "bpf_impl.h"
 
@@ -112,6 +113,27 @@ bpf_alu_le(uint64_t reg[EBPF_REG_NUM], const struct ebpf_insn *ins)
 	}
 }
 
+uint64_t
+bpf_ld_mbuf(const struct rte_mbuf *mb, uint32_t off, uint32_t len)
+{
+	const void *p;
+	uint32_t buf;
+
+	/* avoid the offset wrapping around in rte_pktmbuf_read() */
+	if ((uint64_t)off + len > rte_pktmbuf_pkt_len(mb))
+		return UINT64_MAX;
+
+	p = rte_pktmbuf_read(mb, off, len, &buf);
+	if (p == NULL)
+		return UINT64_MAX;
+
+	if (len == sizeof(uint8_t))
+		return *(const uint8_t *)p;
+	else if (len == sizeof(uint16_t))
+		return rte_be_to_cpu_16(*(const unaligned_uint16_t *)p);
+	return rte_be_to_cpu_32(*(const unaligned_uint32_t *)p);
+}
+
 static inline uint64_t
 bpf_exec(const struct rte_bpf *bpf, uint64_t reg[EBPF_REG_NUM])
 {
@@ -296,6 +318,28 @@ bpf_exec(const struct rte_bpf *bpf, uint64_t reg[EBPF_REG_NUM])
 				(uint64_t)(uint32_t)ins[1].imm << 32;
 			ins++;
 			break;
+		/* packet data load instructions, R6 holds the mbuf */
+		case (BPF_LD | BPF_ABS | BPF_B):
+		case (BPF_LD | BPF_ABS | BPF_H):
+		case (BPF_LD | BPF_ABS | BPF_W):
+			reg[EBPF_REG_0] = bpf_ld_mbuf(
+				(const struct rte_mbuf *)(uintptr_t)
+				reg[EBPF_REG_6], ins->imm,
+				bpf_size(BPF_SIZE(ins->code)));
+			if (reg[EBPF_REG_0] == UINT64_MAX)
+				return 0;
+			break;
+		case (BPF_LD | BPF_IND | BPF_B):
+		case (BPF_LD | BPF_IND | BPF_H):
+		case (BPF_LD | BPF_IND | BPF_W):
+			reg[EBPF_REG_0] = bpf_ld_mbuf(
+				(const struct rte_mbuf *)(uintptr_t)
+				reg[EBPF_REG_6],
+				(uint32_t)reg[ins->src_reg] + ins->imm,
+				bpf_size(BPF_SIZE(ins->code)));
+			if (reg[EBPF_REG_0] == UINT64_MAX)
+				return 0;
+			break;
 		/* store instructions */
 		case (BPF_STX | BPF_MEM | BPF_B):
 			BPF_ST_REG(reg, ins, uint8_t);
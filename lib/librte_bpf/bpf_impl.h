@@ -21,8 +21,33 @@ struct rte_bpf {
 	uint32_t stack_sz;
 };
 
+struct rte_bpf_map {
+	enum rte_bpf_map_type type;
+	uint32_t key_size;
+	uint32_t value_size;
+	uint32_t max_entries;
+	size_t value_stride; /* distance between two values */
+	size_t lcore_stride; /* distance between the values of two lcores */
+	struct rte_hash *hash;
+	uint8_t *values;
+};
+
+/* map functions, appended to the external symbols of each BPF program */
+extern const struct rte_bpf_xsym bpf_map_xsym[RTE_BPF_MAP_FUNC_NUM];
+
+extern int bpf_map_func(const struct rte_bpf_xsym *xsym);
+
 extern int bpf_validate(struct rte_bpf *bpf);
 
+/*
+ * load of len bytes of packet data at offset off of the mbuf, converted
+ * from network byte order, for BPF_ABS and BPF_IND loads.
+ * returns UINT64_MAX when the data is beyond the packet.
+ */
+struct rte_mbuf;
+extern uint64_t bpf_ld_mbuf(const struct rte_mbuf *mb, uint32_t off,
+	uint32_t len);
+
 extern int bpf_jit(struct rte_bpf *bpf);
 
 extern int bpf_jit_x86(struct rte_bpf *);
@@ -13,6 +13,7 @@
 #include <rte_memory.h>
 #include <rte_eal.h>
 #include <rte_byteorder.h>
+#include <rte_mbuf.h>
 
 #include "bpf_impl.h"
 
@@ -87,6 +88,23 @@ enum {
 	REG_TMP1 = R10,
 };
 
+/*
+ * index of the current input context in the burst entry.
+ */
+enum {
+	REG_BURST_IDX = R12,
+};
+
+/*
+ * burst entry arguments, kept on the stack above the saved registers.
+ */
+enum {
+	BURST_CTX = 0,
+	BURST_RC = sizeof(uint64_t),
+	BURST_NUM = 2 * sizeof(uint64_t),
+	BURST_ARGS_SZ = 3 * sizeof(uint64_t),
+};
+
 /*
  * callee saved registers list.
  * keep RBP as the last one.
@@ -100,6 +118,12 @@ struct bpf_jit_state {
 		uint32_t num;
 		int32_t off;
 	} exit;
+	struct {
+		uint32_t on;   /* generating the burst entry */
+		int32_t args;  /* offset of the burst arguments from %rsp */
+		int32_t loop;  /* offset of the per context loop */
+		int32_t done;  /* offset of the burst epilog */
+	} burst;
 	uint32_t reguse;
 	int32_t *off;
 	uint8_t *ins;
@@ -668,6 +692,37 @@ emit_st_xadd(struct bpf_jit_state *st, uint32_t op, uint32_t sreg,
 	emit_imm(st, ofs, imsz);
 }
 
+/*
+ * emit one of:
+ *   mov (%<base>, %<idx>, 8), %<reg>
+ *   mov %<reg>, (%<base>, %<idx>, 8)
+ */
+static void
+emit_mov_idx(struct bpf_jit_state *st, uint32_t op, uint32_t reg,
+	uint32_t base, uint32_t idx)
+{
+	uint8_t ops, rex;
+
+	USED(st->reguse, reg);
+	USED(st->reguse, base);
+	USED(st->reguse, idx);
+
+	rex = REX_PREFIX | REX_W;
+	if (IS_EXT_REG(reg))
+		rex |= REX_R;
+	if (IS_EXT_REG(idx))
+		rex |= REX_X;
+	if (IS_EXT_REG(base))
+		rex |= REX_B;
+
+	ops = (BPF_CLASS(op) == BPF_LDX) ? 0x8B : 0x89;
+
+	emit_bytes(st, &rex, sizeof(rex));
+	emit_bytes(st, &ops, sizeof(ops));
+	emit_modregrm(st, MOD_INDIRECT, reg, RSP);
+	emit_sib(st, SIB_SCALE_8, idx, base);
+}
+
 /*
  * emit:
  *    mov <imm64>, (%rax)
@@ -703,8 +758,9 @@ emit_abs_jmp(struct bpf_jit_state *st, int32_t ofs)
 	/* max possible jmp instruction size */
 	const int32_t iszm = RTE_MAX(sz8, sz32);
 
+	/* for a backward jump, displacement includes the jump size */
 	joff = ofs - st->sz;
-	imsz = RTE_MAX(imm_size(joff), imm_size(joff + iszm));
+	imsz = RTE_MAX(imm_size(joff - iszm), imm_size(joff + iszm));
 
 	if (imsz == 1) {
 		emit_bytes(st, &op8, sizeof(op8));
@@ -821,8 +877,9 @@ emit_abs_jcc(struct bpf_jit_state *st, uint32_t op, int32_t ofs)
 	/* max possible jcc instruction size */
 	const int32_t iszm = RTE_MAX(sz8, sz32);
 
+	/* for a backward jump, displacement includes the jump size */
 	joff = ofs - st->sz;
-	imsz = RTE_MAX(imm_size(joff), imm_size(joff + iszm));
+	imsz = RTE_MAX(imm_size(joff - iszm), imm_size(joff + iszm));
 
 	bop = GET_BPF_OP(op);
 
@@ -1024,6 +1081,112 @@ emit_div(struct bpf_jit_state *st, uint32_t op, uint32_t sreg, uint32_t dreg,
 		emit_mov_reg(st, EBPF_ALU64 | EBPF_MOV | BPF_X, REG_TMP1, RDX);
 }
 
+/*
+ * direct load of packet data from the first mbuf segment:
+ * mov buf_addr(%rbx), %rax
+ * movzwl data_off(%rbx), %r10d
+ * add %r10, %rax
+ * add %r9, %rax
+ * mov (%rax), %eax
+ * bswap %eax
+ */
+static void
+emit_ld_mbuf_fast(struct bpf_jit_state *st, uint32_t op)
+{
+	uint32_t opsz;
+
+	emit_ld_reg(st, BPF_LDX | BPF_MEM | EBPF_DW, RBX, RAX,
+		offsetof(struct rte_mbuf, buf_addr));
+	emit_ld_reg(st, BPF_LDX | BPF_MEM | BPF_H, RBX, REG_TMP1,
+		offsetof(struct rte_mbuf, data_off));
+	emit_alu_reg(st, EBPF_ALU64 | BPF_ADD | BPF_X, REG_TMP1, RAX);
+	emit_alu_reg(st, EBPF_ALU64 | BPF_ADD | BPF_X, REG_DIV_IMM, RAX);
+
+	opsz = BPF_SIZE(op);
+	emit_ld_reg(st, BPF_LDX | BPF_MEM | opsz, RAX, RAX, 0);
+	if (opsz != BPF_B)
+		emit_be2le(st, RAX, bpf_size(opsz) * CHAR_BIT);
+}
+
+/*
+ * load through bpf_ld_mbuf(), exit with return value zero on failure:
+ * mov %rbx, %rdi
+ * mov %r9d, %esi
+ * mov <len>, %edx
+ * call bpf_ld_mbuf
+ * add $1, %rax
+ * jz <exit>
+ * sub $1, %rax
+ */
+static void
+emit_ld_mbuf_slow(struct bpf_jit_state *st, uint32_t op)
+{
+	emit_mov_reg(st, EBPF_ALU64 | EBPF_MOV | BPF_X, RBX, RDI);
+	emit_mov_reg(st, BPF_ALU | EBPF_MOV | BPF_X, REG_DIV_IMM, RSI);
+	emit_mov_imm(st, BPF_ALU | EBPF_MOV | BPF_K, RDX,
+		bpf_size(BPF_SIZE(op)));
+	emit_call(st, (uintptr_t)bpf_ld_mbuf);
+	emit_alu_imm(st, EBPF_ALU64 | BPF_ADD | BPF_K, RAX, 1);
+	emit_abs_jcc(st, BPF_JMP | BPF_JEQ | BPF_K, st->exit.off);
+	emit_alu_imm(st, EBPF_ALU64 | BPF_SUB | BPF_K, RAX, 1);
+}
+
+/*
+ * BPF_ABS and BPF_IND loads of packet data, R6 (%rbx) holds the mbuf.
+ * The data within the first segment is loaded directly, after a check
+ * against the segment data_len, the rest through bpf_ld_mbuf().
+ * emit:
+ * mov <imm>, %r9d    OR    mov %<sreg>, %r9d; add <imm>, %r9d
+ * mov %r9, %r11
+ * add <len>, %r11
+ * movzwl data_len(%rbx), %r10d
+ * cmp %r10, %r11
+ * ja <slow>
+ * <fast>
+ * jmp <done>
+ * <slow>
+ */
+static void
+emit_ld_mbuf(struct bpf_jit_state *st, uint32_t op, uint32_t sreg,
+	uint32_t imm)
+{
+	uint32_t fsz, ssz;
+	struct bpf_jit_state tst;
+
+	/* the jumps below are short */
+	const uint32_t jsz = 2;
+
+	if (BPF_MODE(op) == BPF_IND) {
+		emit_mov_reg(st, BPF_ALU | EBPF_MOV | BPF_X, sreg,
+			REG_DIV_IMM);
+		emit_alu_imm(st, BPF_ALU | BPF_ADD | BPF_K, REG_DIV_IMM, imm);
+	} else
+		emit_mov_imm(st, BPF_ALU | EBPF_MOV | BPF_K, REG_DIV_IMM, imm);
+
+	emit_mov_reg(st, EBPF_ALU64 | EBPF_MOV | BPF_X, REG_DIV_IMM,
+		REG_TMP0);
+	emit_alu_imm(st, EBPF_ALU64 | BPF_ADD | BPF_K, REG_TMP0,
+		bpf_size(BPF_SIZE(op)));
+	emit_ld_reg(st, BPF_LDX | BPF_MEM | BPF_H, RBX, REG_TMP1,
+		offsetof(struct rte_mbuf, data_len));
+	emit_cmp_reg(st, EBPF_ALU64, REG_TMP1, REG_TMP0);
+
+	/* measure both paths, to know where to jump */
+	tst = *st;
+	tst.ins = NULL;
+	tst.sz = st->sz + jsz;
+	emit_ld_mbuf_fast(&tst, op);
+	fsz = tst.sz - st->sz - jsz;
+	tst.sz += jsz;
+	emit_ld_mbuf_slow(&tst, op);
+	ssz = tst.sz - st->sz - 2 * jsz - fsz;
+
+	emit_abs_jcc(st, BPF_JMP | BPF_JGT | BPF_X, st->sz + jsz + fsz + jsz);
+	emit_ld_mbuf_fast(st, op);
+	emit_abs_jmp(st, st->sz + jsz + ssz);
+	emit_ld_mbuf_slow(st, op);
+}
+
 static void
 emit_prolog(struct bpf_jit_state *st, int32_t stack_size)
 {
@@ -1068,21 +1231,15 @@ emit_ret(struct bpf_jit_state *st)
 	emit_bytes(st, &ops, sizeof(ops));
 }
 
+/*
+ * restore the callee saved registers.
+ */
 static void
-emit_epilog(struct bpf_jit_state *st)
+emit_restore(struct bpf_jit_state *st)
 {
 	uint32_t i;
 	int32_t spil, ofs;
 
-	/* if we allready have an epilog generate a jump to it */
-	if (st->exit.num++ != 0) {
-		emit_abs_jmp(st, st->exit.off);
-		return;
-	}
-
-	/* store offset of epilog block */
-	st->exit.off = st->sz;
-
 	spil = 0;
 	for (i = 0; i != RTE_DIM(save_regs); i++)
 		spil += INUSE(st->reguse, save_regs[i]);
@@ -1105,7 +1262,122 @@ emit_epilog(struct bpf_jit_state *st)
 		emit_alu_imm(st, EBPF_ALU64 | BPF_ADD | BPF_K, RSP,
 			spil * sizeof(uint64_t));
 	}
+}
+
+static void
+emit_epilog(struct bpf_jit_state *st)
+{
+	/* if we allready have an epilog generate a jump to it */
+	if (st->exit.num++ != 0) {
+		emit_abs_jmp(st, st->exit.off);
+		return;
+	}
+
+	/* store offset of epilog block */
+	st->exit.off = st->sz;
+
+	emit_restore(st);
+	emit_ret(st);
+}
+
+/*
+ * burst entry, with the same calling convention as rte_bpf_exec_burst(),
+ * minus the bpf handle. The stack frame and the callee saved registers are
+ * set up once, then the program runs in a loop over the input contexts:
+ * sub $24, %rsp
+ * mov %rdi, 0(%rsp)
+ * mov %rsi, 8(%rsp)
+ * mov %edx, 16(%rsp)
+ * <prolog>
+ * xor %r12, %r12
+ * mov <args>+16(%rsp), %r11d
+ * test %r11, %r11
+ * jz <done>
+ * loop:
+ * mov <args>(%rsp), %r11
+ * mov (%r11, %r12, 8), %rdi
+ */
+static void
+emit_burst_prolog(struct bpf_jit_state *st, int32_t stack_size)
+{
+	uint32_t i;
+	int32_t spil;
+
+	emit_alu_imm(st, EBPF_ALU64 | BPF_SUB | BPF_K, RSP, BURST_ARGS_SZ);
+	emit_st_reg(st, BPF_STX | BPF_MEM | EBPF_DW, RDI, RSP, BURST_CTX);
+	emit_st_reg(st, BPF_STX | BPF_MEM | EBPF_DW, RSI, RSP, BURST_RC);
+	emit_st_reg(st, BPF_STX | BPF_MEM | BPF_W, RDX, RSP, BURST_NUM);
+
+	emit_prolog(st, stack_size);
+
+	spil = 0;
+	for (i = 0; i != RTE_DIM(save_regs); i++)
+		spil += INUSE(st->reguse, save_regs[i]);
+
+	st->burst.args = spil * sizeof(uint64_t);
+	if (INUSE(st->reguse, RBP) != 0)
+		st->burst.args += stack_size;
+
+	emit_mov_imm(st, EBPF_ALU64 | EBPF_MOV | BPF_K, REG_BURST_IDX, 0);
+	emit_ld_reg(st, BPF_LDX | BPF_MEM | BPF_W, RSP, REG_TMP0,
+		st->burst.args + BURST_NUM);
+	emit_tst_reg(st, EBPF_ALU64, REG_TMP0, REG_TMP0);
+	emit_abs_jcc(st, BPF_JMP | BPF_JEQ | BPF_K, st->burst.done);
+
+	st->burst.loop = st->sz;
+	emit_ld_reg(st, BPF_LDX | BPF_MEM | EBPF_DW, RSP, REG_TMP0,
+		st->burst.args + BURST_CTX);
+	emit_mov_idx(st, BPF_LDX, ebpf2x86[EBPF_REG_1], REG_TMP0,
+		REG_BURST_IDX);
+}
+
+/*
+ * end of the program in the burst entry, go to the next context:
+ * mov <args>+8(%rsp), %r11
+ * mov %rax, (%r11, %r12, 8)
+ * add $1, %r12
+ * mov <args>+16(%rsp), %r11d
+ * cmp %r11, %r12
+ * jb <loop>
+ * jmp <done>
+ */
+static void
+emit_burst_next(struct bpf_jit_state *st)
+{
+	/* if we allready have this block generate a jump to it */
+	if (st->exit.num++ != 0) {
+		emit_abs_jmp(st, st->exit.off);
+		return;
+	}
+
+	st->exit.off = st->sz;
+
+	emit_ld_reg(st, BPF_LDX | BPF_MEM | EBPF_DW, RSP, REG_TMP0,
+		st->burst.args + BURST_RC);
+	emit_mov_idx(st, BPF_STX, RAX, REG_TMP0, REG_BURST_IDX);
+	emit_alu_imm(st, EBPF_ALU64 | BPF_ADD | BPF_K, REG_BURST_IDX, 1);
+	emit_ld_reg(st, BPF_LDX | BPF_MEM | BPF_W, RSP, REG_TMP0,
+		st->burst.args + BURST_NUM);
+	emit_cmp_reg(st, EBPF_ALU64, REG_TMP0, REG_BURST_IDX);
+	emit_abs_jcc(st, BPF_JMP | EBPF_JLT | BPF_X, st->burst.loop);
+	emit_abs_jmp(st, st->burst.done);
+}
 
+/*
+ * return the number of processed contexts:
+ * mov %r12d, %eax
+ * <epilog>
+ * add $24, %rsp
+ * ret
+ */
+static void
+emit_burst_epilog(struct bpf_jit_state *st)
+{
+	st->burst.done = st->sz;
+
+	emit_mov_reg(st, BPF_ALU | EBPF_MOV | BPF_X, REG_BURST_IDX, RAX);
+	emit_restore(st);
+	emit_alu_imm(st, EBPF_ALU64 | BPF_ADD | BPF_K, RSP, BURST_ARGS_SZ);
 	emit_ret(st);
 }
 
@@ -1122,7 +1394,10 @@ emit(struct bpf_jit_state *st, const struct rte_bpf *bpf)
 	st->sz = 0;
 	st->exit.num = 0;
 
-	emit_prolog(st, bpf->stack_sz);
+	if (st->burst.on != 0)
+		emit_burst_prolog(st, bpf->stack_sz);
+	else
+		emit_prolog(st, bpf->stack_sz);
 
 	for (i = 0; i != bpf->prm.nb_ins; i++) {
 
@@ -1240,6 +1515,15 @@ emit(struct bpf_jit_state *st, const struct rte_bpf *bpf)
 			emit_ld_imm64(st, dr, ins[0].imm, ins[1].imm);
 			i++;
 			break;
+		/* load packet data instructions */
+		case (BPF_LD | BPF_ABS | BPF_B):
+		case (BPF_LD | BPF_ABS | BPF_H):
+		case (BPF_LD | BPF_ABS | BPF_W):
+		case (BPF_LD | BPF_IND | BPF_B):
+		case (BPF_LD | BPF_IND | BPF_H):
+		case (BPF_LD | BPF_IND | BPF_W):
+			emit_ld_mbuf(st, op, sr, ins->imm);
+			break;
 		/* store instructions */
 		case (BPF_STX | BPF_MEM | BPF_B):
 		case (BPF_STX | BPF_MEM | BPF_H):
@@ -1297,7 +1581,10 @@ emit(struct bpf_jit_state *st, const struct rte_bpf *bpf)
 			break;
 		/* return instruction */
 		case (BPF_JMP | EBPF_EXIT):
-			emit_epilog(st);
+			if (st->burst.on != 0)
+				emit_burst_next(st);
+			else
+				emit_epilog(st);
 			break;
 		default:
 			RTE_BPF_LOG(ERR,
@@ -1307,60 +1594,93 @@ emit(struct bpf_jit_state *st, const struct rte_bpf *bpf)
 		}
 	}
 
+	if (st->burst.on != 0)
+		emit_burst_epilog(st);
+
 	return 0;
 }
 
 /*
- * produce a native ISA version of the given BPF code.
+ * dry runs, used to calculate total code size and valid jump offsets.
+ * stop when we get minimal possible size
+ */
+static int
+emit_dry(struct bpf_jit_state *st, const struct rte_bpf *bpf)
+{
+	int32_t rc;
+	uint32_t i;
+	size_t sz;
+
+	/* fill with fake offsets */
+	st->exit.off = INT32_MAX;
+	st->burst.done = INT32_MAX;
+	for (i = 0; i != bpf->prm.nb_ins; i++)
+		st->off[i] = INT32_MAX;
+
+	do {
+		sz = st->sz;
+		rc = emit(st, bpf);
+	} while (rc == 0 && sz != st->sz);
+
+	return rc;
+}
+
+/*
+ * produce a native ISA version of the given BPF code,
+ * followed by its burst entry.
  */
 int
 bpf_jit_x86(struct rte_bpf *bpf)
 {
 	int32_t rc;
-	uint32_t i;
 	size_t sz;
-	struct bpf_jit_state st;
+	uint8_t *ins;
+	struct bpf_jit_state st, bst;
 
 	/* init state */
 	memset(&st, 0, sizeof(st));
-	st.off = malloc(bpf->prm.nb_ins * sizeof(st.off[0]));
+	memset(&bst, 0, sizeof(bst));
+	st.off = malloc(2 * bpf->prm.nb_ins * sizeof(st.off[0]));
 	if (st.off == NULL)
 		return -ENOMEM;
 
-	/* fill with fake offsets */
-	st.exit.off = INT32_MAX;
-	for (i = 0; i != bpf->prm.nb_ins; i++)
-		st.off[i] = INT32_MAX;
+	bst.off = st.off + bpf->prm.nb_ins;
+	bst.burst.on = 1;
 
-	/*
-	 * dry runs, used to calculate total code size and valid jump offsets.
-	 * stop when we get minimal possible size
-	 */
-	do {
-		sz = st.sz;
-		rc = emit(&st, bpf);
-	} while (rc == 0 && sz != st.sz);
+	rc = emit_dry(&st, bpf);
+	if (rc == 0)
+		rc = emit_dry(&bst, bpf);
+
+	ins = MAP_FAILED;
+	sz = st.sz + bst.sz;
 
 	if (rc == 0) {
 
 		/* allocate memory needed */
-		st.ins = mmap(NULL, st.sz, PROT_READ | PROT_WRITE,
+		ins = mmap(NULL, sz, PROT_READ | PROT_WRITE,
 			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
-		if (st.ins == MAP_FAILED)
+		if (ins == MAP_FAILED)
 			rc = -ENOMEM;
-		else
+		else {
 			/* generate code */
+			st.ins = ins;
+			bst.ins = ins + st.sz;
 			rc = emit(&st, bpf);
+			if (rc == 0)
+				rc = emit(&bst, bpf);
+		}
 	}
 
-	if (rc == 0 && mprotect(st.ins, st.sz, PROT_READ | PROT_EXEC) != 0)
+	if (rc == 0 && mprotect(ins, sz, PROT_READ | PROT_EXEC) != 0)
 		rc = -ENOMEM;
 
-	if (rc != 0)
-		munmap(st.ins, st.sz);
-	else {
+	if (rc != 0) {
+		if (ins != MAP_FAILED)
+			munmap(ins, sz);
+	} else {
 		bpf->jit.func = (void *)st.ins;
-		bpf->jit.sz = st.sz;
+		bpf->jit.burst = (void *)bst.ins;
+		bpf->jit.sz = sz;
 	}
 
 	free(st.off);
@@ -25,12 +25,13 @@ bpf_load(const struct rte_bpf_prm *prm)
 {
 	uint8_t *buf;
 	struct rte_bpf *bpf;
-	size_t sz, bsz, insz, xsz;
+	size_t sz, bsz, insz, xsz, msz;
 
 	xsz =  prm->nb_xsym * sizeof(prm->xsym[0]);
+	msz = sizeof(bpf_map_xsym);
 	insz = prm->nb_ins * sizeof(prm->ins[0]);
 	bsz = sizeof(bpf[0]);
-	sz = insz + xsz + bsz;
+	sz = insz + xsz + msz + bsz;
 
 	buf = mmap(NULL, sz, PROT_READ | PROT_WRITE,
 		MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
@@ -42,11 +43,14 @@ bpf_load(const struct rte_bpf_prm *prm)
 
 	memcpy(&bpf->prm, prm, sizeof(bpf->prm));
 
+	/* map functions follow the external symbols provided by the user */
 	memcpy(buf + bsz, prm->xsym, xsz);
-	memcpy(buf + bsz + xsz, prm->ins, insz);
+	memcpy(buf + bsz + xsz, bpf_map_xsym, msz);
+	memcpy(buf + bsz + xsz + msz, prm->ins, insz);
 
 	bpf->prm.xsym = (void *)(buf + bsz);
-	bpf->prm.ins = (void *)(buf + bsz + xsz);
+	bpf->prm.nb_xsym += RTE_DIM(bpf_map_xsym);
+	bpf->prm.ins = (void *)(buf + bsz + xsz + msz);
 
 	return bpf;
 }
@@ -65,6 +69,9 @@ bpf_check_xsym(const struct rte_bpf_xsym *xsym)
 	if (xsym->type == RTE_BPF_XTYPE_VAR) {
 		if (xsym->var.desc.type == RTE_BPF_ARG_UNDEF)
 			return -EINVAL;
+	} else if (xsym->type == RTE_BPF_XTYPE_MAP) {
+		if (xsym->map.val == NULL)
+			return -EINVAL;
 	} else if (xsym->type == RTE_BPF_XTYPE_FUNC) {
 
 		if (xsym->func.nb_args > EBPF_FUNC_MAX_ARGS)
@@ -0,0 +1,245 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+
+#include <rte_common.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_errno.h>
+#include <rte_hash.h>
+
+#include "bpf_impl.h"
+
+struct rte_bpf_map *
+rte_bpf_map_create(const struct rte_bpf_map_prm *prm)
+{
+	struct rte_hash_parameters hprm;
+	struct rte_bpf_map *map;
+	size_t sz;
+
+	if (prm == NULL || prm->key_size == 0 || prm->value_size == 0 ||
+			prm->max_entries == 0 ||
+			(prm->type == RTE_BPF_MAP_TYPE_HASH &&
+			prm->name == NULL) ||
+			(prm->type != RTE_BPF_MAP_TYPE_HASH &&
+			prm->key_size != sizeof(uint32_t))) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	map = rte_zmalloc_socket("bpf_map", sizeof(*map), RTE_CACHE_LINE_SIZE,
+		prm->socket_id);
+	if (map == NULL) {
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	map->type = prm->type;
+	map->key_size = prm->key_size;
+	map->value_size = prm->value_size;
+	map->max_entries = prm->max_entries;
+	/* keep the values aligned for the atomic adds */
+	map->value_stride = RTE_ALIGN_CEIL(prm->value_size, sizeof(uint64_t));
+
+	switch (prm->type) {
+	case RTE_BPF_MAP_TYPE_HASH:
+		memset(&hprm, 0, sizeof(hprm));
+		hprm.name = prm->name;
+		hprm.entries = prm->max_entries;
+		hprm.key_len = prm->key_size;
+		hprm.socket_id = prm->socket_id;
+		hprm.extra_flag = RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY;
+		map->hash = rte_hash_create(&hprm);
+		if (map->hash == NULL) {
+			rte_free(map);
+			return NULL;
+		}
+		/* the values are indexed by the position of their key */
+		sz = (rte_hash_max_key_id(map->hash) + 1) * map->value_stride;
+		break;
+	case RTE_BPF_MAP_TYPE_ARRAY:
+		sz = (size_t)prm->max_entries * map->value_stride;
+		break;
+	case RTE_BPF_MAP_TYPE_LCORE_ARRAY:
+		/* avoid false sharing between the lcores */
+		map->lcore_stride = RTE_ALIGN_CEIL(
+			(size_t)prm->max_entries * map->value_stride,
+			RTE_CACHE_LINE_SIZE);
+		sz = RTE_MAX_LCORE * map->lcore_stride;
+		break;
+	default:
+		rte_free(map);
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	map->values = rte_zmalloc_socket("bpf_map_values", sz,
+		RTE_CACHE_LINE_SIZE, prm->socket_id);
+	if (map->values == NULL) {
+		rte_hash_free(map->hash);
+		rte_free(map);
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	return map;
+}
+
+void
+rte_bpf_map_destroy(struct rte_bpf_map *map)
+{
+	if (map == NULL)
+		return;
+
+	rte_hash_free(map->hash);
+	rte_free(map->values);
+	rte_free(map);
+}
+
+void *
+rte_bpf_map_lookup_lcore(struct rte_bpf_map *map, const void *key,
+	unsigned int lcore_id)
+{
+	int32_t pos;
+	uint32_t idx;
+
+	switch (map->type) {
+	case RTE_BPF_MAP_TYPE_HASH:
+		pos = rte_hash_lookup(map->hash, key);
+		if (pos < 0)
+			return NULL;
+		return map->values + pos * map->value_stride;
+	case RTE_BPF_MAP_TYPE_ARRAY:
+		idx = *(const uint32_t *)key;
+		if (idx >= map->max_entries)
+			return NULL;
+		return map->values + idx * map->value_stride;
+	case RTE_BPF_MAP_TYPE_LCORE_ARRAY:
+		idx = *(const uint32_t *)key;
+		if (idx >= map->max_entries || lcore_id >= RTE_MAX_LCORE)
+			return NULL;
+		return map->values + lcore_id * map->lcore_stride +
+			idx * map->value_stride;
+	}
+
+	return NULL;
+}
+
+void *
+rte_bpf_map_lookup(struct rte_bpf_map *map, const void *key)
+{
+	return rte_bpf_map_lookup_lcore(map, key, rte_lcore_id());
+}
+
+int
+rte_bpf_map_update(struct rte_bpf_map *map, const void *key,
+	const void *value)
+{
+	int32_t pos;
+	void *v;
+
+	if (map->type == RTE_BPF_MAP_TYPE_HASH) {
+		pos = rte_hash_add_key(map->hash, key);
+		if (pos < 0)
+			return pos;
+		v = map->values + pos * map->value_stride;
+	} else {
+		v = rte_bpf_map_lookup(map, key);
+		if (v == NULL)
+			return -ENOENT;
+	}
+
+	memcpy(v, value, map->value_size);
+	return 0;
+}
+
+int
+rte_bpf_map_delete(struct rte_bpf_map *map, const void *key)
+{
+	int32_t pos;
+
+	if (map->type != RTE_BPF_MAP_TYPE_HASH)
+		return -ENOTSUP;
+
+	pos = rte_hash_del_key(map->hash, key);
+	return (pos < 0) ? pos : 0;
+}
+
+/*
+ * wrappers with the prototype of external functions,
+ * returning the error codes as 64-bit values.
+ */
+static uint64_t
+bpf_map_lookup_func(uint64_t map, uint64_t key, uint64_t a3 __rte_unused,
+	uint64_t a4 __rte_unused, uint64_t a5 __rte_unused)
+{
+	return (uintptr_t)rte_bpf_map_lookup((void *)(uintptr_t)map,
+		(const void *)(uintptr_t)key);
+}
+
+static uint64_t
+bpf_map_update_func(uint64_t map, uint64_t key, uint64_t value,
+	uint64_t a4 __rte_unused, uint64_t a5 __rte_unused)
+{
+	return (int64_t)rte_bpf_map_update((void *)(uintptr_t)map,
+		(const void *)(uintptr_t)key,
+		(const void *)(uintptr_t)value);
+}
+
+static uint64_t
+bpf_map_delete_func(uint64_t map, uint64_t key, uint64_t a3 __rte_unused,
+	uint64_t a4 __rte_unused, uint64_t a5 __rte_unused)
+{
+	return (int64_t)rte_bpf_map_delete((void *)(uintptr_t)map,
+		(const void *)(uintptr_t)key);
+}
+
+/*
+ * The arguments and return values depend on the map, they are checked
+ * by the verifier from the map passed as first argument.
+ */
+const struct rte_bpf_xsym bpf_map_xsym[RTE_BPF_MAP_FUNC_NUM] = {
+	[RTE_BPF_MAP_FUNC_LOOKUP] = {
+		.name = "rte_bpf_map_lookup",
+		.type = RTE_BPF_XTYPE_FUNC,
+		.func = {
+			.val = bpf_map_lookup_func,
+			.nb_args = 2,
+		},
+	},
+	[RTE_BPF_MAP_FUNC_UPDATE] = {
+		.name = "rte_bpf_map_update",
+		.type = RTE_BPF_XTYPE_FUNC,
+		.func = {
+			.val = bpf_map_update_func,
+			.nb_args = 3,
+		},
+	},
+	[RTE_BPF_MAP_FUNC_DELETE] = {
+		.name = "rte_bpf_map_delete",
+		.type = RTE_BPF_XTYPE_FUNC,
+		.func = {
+			.val = bpf_map_delete_func,
+			.nb_args = 2,
+		},
+	},
+};
+
+/* return the map function called through an external symbol, or -1 */
+int
+bpf_map_func(const struct rte_bpf_xsym *xsym)
+{
+	uint32_t i;
+
+	for (i = 0; i != RTE_DIM(bpf_map_xsym); i++) {
+		if (xsym->type == RTE_BPF_XTYPE_FUNC &&
+				xsym->func.val == bpf_map_xsym[i].func.val)
+			return i;
+	}
+
+	return -1;
+}
@@ -222,14 +222,22 @@ pkt_filter_jit(const struct rte_bpf_jit *jit, struct rte_mbuf *mb[],
 	uint32_t num, uint32_t drop)
 {
 	uint32_t i, n;
-	void *dp;
+	void *dp[num];
 	uint64_t rc[num];
 
 	n = 0;
-	for (i = 0; i != num; i++) {
-		dp = rte_pktmbuf_mtod(mb[i], void *);
-		rc[i] = jit->func(dp);
-		n += (rc[i] == 0);
+	if (jit->burst != NULL) {
+		for (i = 0; i != num; i++)
+			dp[i] = rte_pktmbuf_mtod(mb[i], void *);
+		jit->burst(dp, rc, num);
+		for (i = 0; i != num; i++)
+			n += (rc[i] == 0);
+	} else {
+		for (i = 0; i != num; i++) {
+			dp[i] = rte_pktmbuf_mtod(mb[i], void *);
+			rc[i] = jit->func(dp[i]);
+			n += (rc[i] == 0);
+		}
 	}
 
 	if (n != 0)
@@ -256,9 +264,15 @@ pkt_filter_mb_jit(const struct rte_bpf_jit *jit, struct rte_mbuf *mb[],
 	uint64_t rc[num];
 
 	n = 0;
-	for (i = 0; i != num; i++) {
-		rc[i] = jit->func(mb[i]);
-		n += (rc[i] == 0);
+	if (jit->burst != NULL) {
+		jit->burst((void **)mb, rc, num);
+		for (i = 0; i != num; i++)
+			n += (rc[i] == 0);
+	} else {
+		for (i = 0; i != num; i++) {
+			rc[i] = jit->func(mb[i]);
+			n += (rc[i] == 0);
+		}
 	}
 
 	if (n != 0)
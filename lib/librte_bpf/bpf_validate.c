@@ -17,6 +17,13 @@
 
 #define BPF_ARG_PTR_STACK RTE_BPF_ARG_RESERVED
 
+/*
+ * Map, and pointer returned by a map lookup, which must be checked
+ * against NULL to become a pointer to the value: not dereferenceable.
+ */
+#define BPF_ARG_MAP		(RTE_BPF_ARG_RAW + 1)
+#define BPF_ARG_PTR_OR_NULL	(RTE_BPF_ARG_RAW + 2)
+
 struct bpf_reg_val {
 	struct rte_bpf_arg v;
 	uint64_t mask;
@@ -54,6 +61,34 @@ enum {
 
 #define	MAX_EDGES	2
 
+/*
+ * limits of the evaluation: number of evaluated instructions,
+ * which bounds the number of loop iterations, and number of
+ * evaluation states kept for pruning, in total and per node.
+ */
+#define	MAX_EVAL_INS	(1 << 17)
+#define	MAX_EVAL_SEEN	(1 << 13)
+#define	MAX_NODE_SEEN	64
+
+/* evaluation state of a branch, still to be evaluated */
+struct bpf_eval_pend {
+	uint32_t idx;
+	uint32_t nb_walk;
+	struct bpf_eval_state *st;
+};
+
+/*
+ * evaluation state already seen at the prune point,
+ * stack slots below the used stack space are undefined and not kept.
+ */
+struct bpf_eval_seen {
+	struct bpf_eval_seen *next;
+	uint32_t done;
+	uint32_t sv_first;
+	struct bpf_reg_val rv[EBPF_REG_NUM];
+	struct bpf_reg_val sv[];
+};
+
 struct inst_node {
 	uint8_t colour;
 	uint8_t nb_edge:4;
@@ -61,7 +96,10 @@ struct inst_node {
 	uint8_t edge_type[MAX_EDGES];
 	uint32_t edge_dest[MAX_EDGES];
 	uint32_t prev_node;
+	uint32_t nb_in_edge;
+	uint32_t nb_seen;
 	struct bpf_eval_state *evst;
+	struct bpf_eval_seen *seen;
 };
 
 struct bpf_verifier {
@@ -74,11 +112,21 @@ struct bpf_verifier {
 	uint32_t edge_type[MAX_EDGE_TYPE];
 	struct bpf_eval_state *evst;
 	struct inst_node *evin;
+	uint32_t nb_eval_ins;
+	uint32_t nb_seen;
+	uint32_t nb_pruned;
+	/* branches still to evaluate */
 	struct {
 		uint32_t num;
 		uint32_t cur;
-		struct bpf_eval_state *ent;
-	} evst_pool;
+		struct bpf_eval_pend *ent;
+	} pend;
+	/* seen states, whose paths are being evaluated */
+	struct {
+		uint32_t num;
+		uint32_t cur;
+		struct bpf_eval_seen **ent;
+	} walk;
 };
 
 struct bpf_ins_check {
@@ -196,6 +244,13 @@ eval_ld_imm64(struct bpf_verifier *bvf, const struct ebpf_insn *ins)
 			eval_fill_imm64(rd, UINT64_MAX, 0);
 			break;
 		}
+
+		/* load of map, keep its address to check map calls */
+		if (bvf->prm->xsym[i].type == RTE_BPF_XTYPE_MAP &&
+				(uintptr_t)bvf->prm->xsym[i].map.val == val) {
+			rd->v.type = BPF_ARG_MAP;
+			break;
+		}
 	}
 
 	return NULL;
@@ -226,7 +281,7 @@ eval_add(struct bpf_reg_val *rd, const struct bpf_reg_val *rs, uint64_t msk)
 	struct bpf_reg_val rv;
 
 	rv.u.min = (rd->u.min + rs->u.min) & msk;
-	rv.u.max = (rd->u.min + rs->u.max) & msk;
+	rv.u.max = (rd->u.max + rs->u.max) & msk;
 	rv.s.min = (rd->s.min + rs->s.min) & msk;
 	rv.s.max = (rd->s.max + rs->s.max) & msk;
 
@@ -254,10 +309,10 @@ eval_sub(struct bpf_reg_val *rd, const struct bpf_reg_val *rs, uint64_t msk)
 {
 	struct bpf_reg_val rv;
 
-	rv.u.min = (rd->u.min - rs->u.min) & msk;
-	rv.u.max = (rd->u.min - rs->u.max) & msk;
-	rv.s.min = (rd->s.min - rs->s.min) & msk;
-	rv.s.max = (rd->s.max - rs->s.max) & msk;
+	rv.u.min = (rd->u.min - rs->u.max) & msk;
+	rv.u.max = (rd->u.max - rs->u.min) & msk;
+	rv.s.min = (rd->s.min - rs->s.max) & msk;
+	rv.s.max = (rd->s.max - rs->s.min) & msk;
 
 	/*
 	 * if at least one of the operands is not constant,
@@ -268,9 +323,9 @@ eval_sub(struct bpf_reg_val *rd, const struct bpf_reg_val *rs, uint64_t msk)
 		eval_umax_bound(&rv, msk);
 
 	if ((rd->s.min != rd->s.max || rs->s.min != rs->s.max) &&
-			(((rs->s.min < 0 && rv.s.min < rd->s.min) ||
+			(((rs->s.max < 0 && rv.s.min < rd->s.min) ||
 			rv.s.min > rd->s.min) ||
-			((rs->s.max < 0 && rv.s.max < rd->s.max) ||
+			((rs->s.min < 0 && rv.s.max < rd->s.max) ||
 			rv.s.max > rd->s.max)))
 		eval_smax_bound(&rv, msk);
 
@@ -880,6 +935,45 @@ eval_store(struct bpf_verifier *bvf, const struct ebpf_insn *ins)
 	return NULL;
 }
 
+/*
+ * BPF_ABS and BPF_IND loads: R6 is an implicit input holding the mbuf,
+ * R0 an implicit output holding the packet data, R1-R5 are scratched.
+ */
+static const char *
+eval_ld_mbuf(struct bpf_verifier *bvf, const struct ebpf_insn *ins)
+{
+	uint32_t i;
+	struct bpf_reg_val *rv;
+	const char *err;
+
+	/* for now don't support function calls on 32 bit platform */
+	if (sizeof(uint64_t) != sizeof(uintptr_t))
+		return "packet data loads are supported only for 64 bit apps";
+
+	rv = bvf->evst->rv + EBPF_REG_6;
+	if (rv->v.type != RTE_BPF_ARG_PTR_MBUF ||
+			rv->u.min != 0 || rv->u.max != 0)
+		return "R6 is not a pointer to mbuf";
+
+	if (BPF_MODE(ins->code) == BPF_IND) {
+		err = eval_defined(NULL, bvf->evst->rv + ins->src_reg);
+		if (err != NULL)
+			return err;
+		if (bvf->evst->rv[ins->src_reg].v.type != RTE_BPF_ARG_RAW)
+			return "packet data offset is not a scalar";
+	}
+
+	for (i = EBPF_REG_1; i != EBPF_REG_6; i++)
+		bvf->evst->rv[i].v.type = RTE_BPF_ARG_UNDEF;
+
+	rv = bvf->evst->rv + EBPF_REG_0;
+	rv->v.type = RTE_BPF_ARG_RAW;
+	rv->v.size = bpf_size(BPF_SIZE(ins->code));
+	eval_fill_max_bound(rv, RTE_LEN2MASK(rv->v.size * CHAR_BIT, uint64_t));
+
+	return NULL;
+}
+
 static const char *
 eval_func_arg(struct bpf_verifier *bvf, const struct rte_bpf_arg *arg,
 	struct bpf_reg_val *rv)
@@ -924,12 +1018,60 @@ eval_func_arg(struct bpf_verifier *bvf, const struct rte_bpf_arg *arg,
 	return err;
 }
 
+/*
+ * find the map passed as first argument of a map function,
+ * return its arguments and return value descriptions.
+ */
+static const char *
+eval_map_func(struct bpf_verifier *bvf, int func, struct rte_bpf_arg *args,
+	struct rte_bpf_arg *ret)
+{
+	uint32_t i;
+	const struct bpf_reg_val *rv;
+	const struct rte_bpf_map *map;
+
+	rv = bvf->evst->rv + EBPF_REG_1;
+	if (rv->v.type != BPF_ARG_MAP || rv->u.min != rv->u.max)
+		return "map function called without a map";
+
+	map = NULL;
+	for (i = 0; i != bvf->prm->nb_xsym && map == NULL; i++) {
+		if (bvf->prm->xsym[i].type == RTE_BPF_XTYPE_MAP &&
+				(uintptr_t)bvf->prm->xsym[i].map.val ==
+				rv->u.min)
+			map = bvf->prm->xsym[i].map.val;
+	}
+	if (map == NULL)
+		return "invalid map";
+
+	args[0].type = BPF_ARG_MAP;
+	args[1].type = RTE_BPF_ARG_PTR;
+	args[1].size = map->key_size;
+	args[2].type = RTE_BPF_ARG_PTR;
+	args[2].size = map->value_size;
+
+	/* lookup returns a pointer to the value, or NULL */
+	if (func == RTE_BPF_MAP_FUNC_LOOKUP) {
+		ret->type = BPF_ARG_PTR_OR_NULL;
+		ret->size = map->value_size;
+	} else {
+		ret->type = RTE_BPF_ARG_RAW;
+		ret->size = sizeof(uint64_t);
+	}
+
+	return NULL;
+}
+
 static const char *
 eval_call(struct bpf_verifier *bvf, const struct ebpf_insn *ins)
 {
 	uint32_t i, idx;
+	int func;
 	struct bpf_reg_val *rv;
 	const struct rte_bpf_xsym *xsym;
+	const struct rte_bpf_arg *args;
+	struct rte_bpf_arg map_args[EBPF_FUNC_MAX_ARGS];
+	struct rte_bpf_arg ret;
 	const char *err;
 
 	idx = ins->imm;
@@ -943,11 +1085,23 @@ eval_call(struct bpf_verifier *bvf, const struct ebpf_insn *ins)
 		return "function calls are supported only for 64 bit apps";
 
 	xsym = bvf->prm->xsym + idx;
+	args = xsym->func.args;
+	ret = xsym->func.ret;
+
+	/* map function arguments depend on the map */
+	func = bpf_map_func(xsym);
+	if (func >= 0) {
+		memset(map_args, 0, sizeof(map_args));
+		err = eval_map_func(bvf, func, map_args, &ret);
+		if (err != NULL)
+			return err;
+		args = map_args;
+	}
 
 	/* evaluate function arguments */
 	err = NULL;
 	for (i = 0; i != xsym->func.nb_args && err == NULL; i++) {
-		err = eval_func_arg(bvf, xsym->func.args + i,
+		err = eval_func_arg(bvf, args + i,
 			bvf->evst->rv + EBPF_REG_1 + i);
 	}
 
@@ -958,50 +1112,88 @@ eval_call(struct bpf_verifier *bvf, const struct ebpf_insn *ins)
 	/* update return value */
 
 	rv = bvf->evst->rv + EBPF_REG_0;
-	rv->v = xsym->func.ret;
+	rv->v = ret;
 	if (rv->v.type == RTE_BPF_ARG_RAW)
 		eval_fill_max_bound(rv,
 			RTE_LEN2MASK(rv->v.size * CHAR_BIT, uint64_t));
-	else if (RTE_BPF_ARG_PTR_TYPE(rv->v.type) != 0)
+	else if (RTE_BPF_ARG_PTR_TYPE(rv->v.type) != 0 ||
+			rv->v.type == BPF_ARG_PTR_OR_NULL)
 		eval_fill_imm64(rv, UINTPTR_MAX, 0);
 
 	return err;
 }
 
+/*
+ * comparison of the result of a map lookup with NULL:
+ * it is a pointer to the value in the branch where it is not NULL.
+ */
+static void
+eval_jcc_null(struct bpf_reg_val *nrd, struct bpf_reg_val *prd)
+{
+	if (prd->v.type != BPF_ARG_PTR_OR_NULL ||
+			prd->u.min != 0 || prd->u.max != 0)
+		return;
+
+	prd->v.type = RTE_BPF_ARG_PTR;
+	nrd->v.type = RTE_BPF_ARG_RAW;
+	eval_fill_imm(nrd, UINT64_MAX, 0);
+}
+
+/*
+ * on the branch where the registers are equal, both of them are within
+ * the intersection of their ranges.
+ */
 static void
 eval_jeq_jne(struct bpf_reg_val *trd, struct bpf_reg_val *trs)
 {
-	/* sreg is constant */
-	if (trs->u.min == trs->u.max) {
-		trd->u = trs->u;
-	/* dreg is constant */
-	} else if (trd->u.min == trd->u.max) {
-		trs->u = trd->u;
-	} else {
-		trd->u.max = RTE_MIN(trd->u.max, trs->u.max);
-		trd->u.min = RTE_MAX(trd->u.min, trs->u.min);
-		trs->u = trd->u;
+	trd->u.max = RTE_MIN(trd->u.max, trs->u.max);
+	trd->u.min = RTE_MAX(trd->u.min, trs->u.min);
+	trs->u = trd->u;
+
+	trd->s.max = RTE_MIN(trd->s.max, trs->s.max);
+	trd->s.min = RTE_MAX(trd->s.min, trs->s.min);
+	trs->s = trd->s;
+}
+
+/*
+ * on the branch where the registers differ, a constant excludes
+ * the bound of the other register range it is equal to.
+ */
+static void
+eval_jne_bound(struct bpf_reg_val *rd, const struct bpf_reg_val *rs)
+{
+	if (rs->u.min == rs->u.max) {
+		if (rd->u.min == rs->u.min && rd->u.min != UINT64_MAX)
+			rd->u.min++;
+		else if (rd->u.max == rs->u.max && rd->u.max != 0)
+			rd->u.max--;
 	}
 
-	/* sreg is constant */
-	if (trs->s.min == trs->s.max) {
-		trd->s = trs->s;
-	/* dreg is constant */
-	} else if (trd->s.min == trd->s.max) {
-		trs->s = trd->s;
-	} else {
-		trd->s.max = RTE_MIN(trd->s.max, trs->s.max);
-		trd->s.min = RTE_MAX(trd->s.min, trs->s.min);
-		trs->s = trd->s;
+	if (rs->s.min == rs->s.max) {
+		if (rd->s.min == rs->s.min && rd->s.min != INT64_MAX)
+			rd->s.min++;
+		else if (rd->s.max == rs->s.max && rd->s.max != INT64_MIN)
+			rd->s.max--;
 	}
 }
 
+static void
+eval_jne_jeq(struct bpf_reg_val *trd, struct bpf_reg_val *trs)
+{
+	eval_jne_bound(trd, trs);
+	eval_jne_bound(trs, trd);
+}
+
 static void
 eval_jgt_jle(struct bpf_reg_val *trd, struct bpf_reg_val *trs,
 	struct bpf_reg_val *frd, struct bpf_reg_val *frs)
 {
-	frd->u.max = RTE_MIN(frd->u.max, frs->u.min);
-	trd->u.min = RTE_MAX(trd->u.min, trs->u.min + 1);
+	frd->u.max = RTE_MIN(frd->u.max, frs->u.max);
+	frs->u.min = RTE_MAX(frs->u.min, frd->u.min);
+	if (trs->u.min != UINT64_MAX)
+		trd->u.min = RTE_MAX(trd->u.min, trs->u.min + 1);
+	if (trd->u.max != 0)
+		trs->u.max = RTE_MIN(trs->u.max, trd->u.max - 1);
 }
 
 static void
@@ -1009,15 +1201,23 @@ eval_jlt_jge(struct bpf_reg_val *trd, struct bpf_reg_val *trs,
 	struct bpf_reg_val *frd, struct bpf_reg_val *frs)
 {
 	frd->u.min = RTE_MAX(frd->u.min, frs->u.min);
-	trd->u.max = RTE_MIN(trd->u.max, trs->u.max - 1);
+	frs->u.max = RTE_MIN(frs->u.max, frd->u.max);
+	if (trs->u.max != 0)
+		trd->u.max = RTE_MIN(trd->u.max, trs->u.max - 1);
+	if (trd->u.min != UINT64_MAX)
+		trs->u.min = RTE_MAX(trs->u.min, trd->u.min + 1);
 }
 
 static void
 eval_jsgt_jsle(struct bpf_reg_val *trd, struct bpf_reg_val *trs,
 	struct bpf_reg_val *frd, struct bpf_reg_val *frs)
 {
-	frd->s.max = RTE_MIN(frd->s.max, frs->s.min);
-	trd->s.min = RTE_MAX(trd->s.min, trs->s.min + 1);
+	frd->s.max = RTE_MIN(frd->s.max, frs->s.max);
+	frs->s.min = RTE_MAX(frs->s.min, frd->s.min);
+	if (trs->s.min != INT64_MAX)
+		trd->s.min = RTE_MAX(trd->s.min, trs->s.min + 1);
+	if (trd->s.max != INT64_MIN)
+		trs->s.max = RTE_MIN(trs->s.max, trd->s.max - 1);
 }
 
 static void
@@ -1025,7 +1225,60 @@ eval_jslt_jsge(struct bpf_reg_val *trd, struct bpf_reg_val *trs,
 	struct bpf_reg_val *frd, struct bpf_reg_val *frs)
 {
 	frd->s.min = RTE_MAX(frd->s.min, frs->s.min);
-	trd->s.max = RTE_MIN(trd->s.max, trs->s.max - 1);
+	frs->s.max = RTE_MIN(frs->s.max, frd->s.max);
+	if (trs->s.max != INT64_MIN)
+		trd->s.max = RTE_MIN(trd->s.max, trs->s.max - 1);
+	if (trd->s.min != INT64_MAX)
+		trs->s.min = RTE_MAX(trs->s.min, trd->s.min + 1);
+}
+
+/*
+ * jcc compares 64-bit values, while results of 32-bit operations
+ * are zero-extended: their signed range is the unsigned one.
+ */
+static void
+eval_jcc_extend(struct bpf_reg_val *rv)
+{
+	if (rv->mask != UINT64_MAX) {
+		rv->s.min = rv->u.min;
+		rv->s.max = rv->u.max;
+	}
+}
+
+/*
+ * propagate the narrowed unsigned range of a register to its signed
+ * range and vice versa, where both of them cover the same values.
+ */
+static void
+eval_jcc_sync(struct bpf_reg_val *rv)
+{
+	if (rv->u.max <= INT64_MAX) {
+		rv->s.min = RTE_MAX(rv->s.min, (int64_t)rv->u.min);
+		rv->s.max = RTE_MIN(rv->s.max, (int64_t)rv->u.max);
+	}
+
+	if (rv->s.min >= 0) {
+		rv->u.min = RTE_MAX(rv->u.min, (uint64_t)rv->s.min);
+		rv->u.max = RTE_MIN(rv->u.max, (uint64_t)rv->s.max);
+	}
+}
+
+/*
+ * a register with an empty range means that the branch
+ * can't be taken.
+ */
+static int
+eval_reg_empty(const struct bpf_reg_val *rv)
+{
+	return rv->u.min > rv->u.max || rv->s.min > rv->s.max;
+}
+
+static int
+eval_jcc_empty(const struct bpf_eval_state *st, const struct ebpf_insn *ins)
+{
+	return eval_reg_empty(st->rv + ins->dst_reg) ||
+		(BPF_SRC(ins->code) == BPF_X &&
+		eval_reg_empty(st->rv + ins->src_reg));
 }
 
 static const char *
@@ -1059,26 +1312,49 @@ eval_jcc(struct bpf_verifier *bvf, const struct ebpf_insn *ins)
 
 	op = BPF_OP(ins->code);
 
-	if (op == BPF_JEQ)
-		eval_jeq_jne(trd, trs);
-	else if (op == EBPF_JNE)
-		eval_jeq_jne(frd, frs);
-	else if (op == BPF_JGT)
-		eval_jgt_jle(trd, trs, frd, frs);
-	else if (op == EBPF_JLE)
-		eval_jgt_jle(frd, frs, trd, trs);
-	else if (op == EBPF_JLT)
-		eval_jlt_jge(trd, trs, frd, frs);
-	else if (op == BPF_JGE)
-		eval_jlt_jge(frd, frs, trd, trs);
-	else if (op == EBPF_JSGT)
-		eval_jsgt_jsle(trd, trs, frd, frs);
-	else if (op == EBPF_JSLE)
-		eval_jsgt_jsle(frd, frs, trd, trs);
-	else if (op == EBPF_JLT)
-		eval_jslt_jsge(trd, trs, frd, frs);
-	else if (op == EBPF_JSGE)
-		eval_jslt_jsge(frd, frs, trd, trs);
+	/* narrow the ranges of values only, not of pointer offsets */
+	if (trd->v.type == RTE_BPF_ARG_RAW && trs->v.type == RTE_BPF_ARG_RAW) {
+
+		eval_jcc_extend(trd);
+		eval_jcc_extend(trs);
+		eval_jcc_extend(frd);
+		eval_jcc_extend(frs);
+
+		if (op == BPF_JEQ) {
+			eval_jeq_jne(trd, trs);
+			eval_jne_jeq(frd, frs);
+		} else if (op == EBPF_JNE) {
+			eval_jeq_jne(frd, frs);
+			eval_jne_jeq(trd, trs);
+		} else if (op == BPF_JGT)
+			eval_jgt_jle(trd, trs, frd, frs);
+		else if (op == EBPF_JLE)
+			eval_jgt_jle(frd, frs, trd, trs);
+		else if (op == EBPF_JLT)
+			eval_jlt_jge(trd, trs, frd, frs);
+		else if (op == BPF_JGE)
+			eval_jlt_jge(frd, frs, trd, trs);
+		else if (op == EBPF_JSGT)
+			eval_jsgt_jsle(trd, trs, frd, frs);
+		else if (op == EBPF_JSLE)
+			eval_jsgt_jsle(frd, frs, trd, trs);
+		else if (op == EBPF_JSLT)
+			eval_jslt_jsge(trd, trs, frd, frs);
+		else if (op == EBPF_JSGE)
+			eval_jslt_jsge(frd, frs, trd, trs);
+
+		eval_jcc_sync(trd);
+		eval_jcc_sync(trs);
+		eval_jcc_sync(frd);
+		eval_jcc_sync(frs);
+	}
+
+	if (BPF_SRC(ins->code) == BPF_K && ins->imm == 0) {
+		if (op == BPF_JEQ)
+			eval_jcc_null(trd, frd);
+		else if (op == EBPF_JNE)
+			eval_jcc_null(frd, trd);
+	}
 
 	return NULL;
 }
@@ -1425,6 +1701,43 @@ static const struct bpf_ins_check ins_chk[UINT8_MAX + 1] = {
 		.imm = { .min = 0, .max = UINT32_MAX},
 		.eval = eval_ld_imm64,
 	},
+	/* load packet data instructions */
+	[(BPF_LD | BPF_ABS | BPF_B)] = {
+		.mask = { .dreg = ZERO_REG, .sreg = ZERO_REG},
+		.off = { .min = 0, .max = 0},
+		.imm = { .min = 0, .max = INT32_MAX},
+		.eval = eval_ld_mbuf,
+	},
+	[(BPF_LD | BPF_ABS | BPF_H)] = {
+		.mask = { .dreg = ZERO_REG, .sreg = ZERO_REG},
+		.off = { .min = 0, .max = 0},
+		.imm = { .min = 0, .max = INT32_MAX},
+		.eval = eval_ld_mbuf,
+	},
+	[(BPF_LD | BPF_ABS | BPF_W)] = {
+		.mask = { .dreg = ZERO_REG, .sreg = ZERO_REG},
+		.off = { .min = 0, .max = 0},
+		.imm = { .min = 0, .max = INT32_MAX},
+		.eval = eval_ld_mbuf,
+	},
+	[(BPF_LD | BPF_IND | BPF_B)] = {
+		.mask = { .dreg = ZERO_REG, .sreg = ALL_REGS},
+		.off = { .min = 0, .max = 0},
+		.imm = { .min = 0, .max = UINT32_MAX},
+		.eval = eval_ld_mbuf,
+	},
+	[(BPF_LD | BPF_IND | BPF_H)] = {
+		.mask = { .dreg = ZERO_REG, .sreg = ALL_REGS},
+		.off = { .min = 0, .max = 0},
+		.imm = { .min = 0, .max = UINT32_MAX},
+		.eval = eval_ld_mbuf,
+	},
+	[(BPF_LD | BPF_IND | BPF_W)] = {
+		.mask = { .dreg = ZERO_REG, .sreg = ALL_REGS},
+		.off = { .min = 0, .max = 0},
+		.imm = { .min = 0, .max = UINT32_MAX},
+		.eval = eval_ld_mbuf,
+	},
 	/* store REG instructions */
 	[(BPF_STX | BPF_MEM | BPF_B)] = {
 		.mask = { .dreg = ALL_REGS, .sreg = ALL_REGS},
@@ -1728,7 +2041,7 @@ add_edge(struct bpf_verifier *bvf, struct inst_node *node, uint32_t nidx)
 {
 	uint32_t ne;
 
-	if (nidx > bvf->prm->nb_ins) {
+	if (nidx >= bvf->prm->nb_ins) {
 		RTE_BPF_LOG(ERR, "%s: program boundary violation at pc: %u, "
 			"next pc: %u\n",
 			__func__, get_node_idx(bvf, node), nidx);
@@ -1744,6 +2057,7 @@ add_edge(struct bpf_verifier *bvf, struct inst_node *node, uint32_t nidx)
 
 	node->edge_dest[ne] = nidx;
 	node->nb_edge = ne + 1;
+	bvf->in[nidx].nb_in_edge++;
 	return 0;
 }
 
@@ -1865,7 +2179,7 @@ log_loop(const struct bpf_verifier *bvf)
 
 		for (j = 0; j != node->nb_edge; j++) {
 			if (node->edge_type[j] == BACK_EDGE)
-				RTE_BPF_LOG(ERR,
+				RTE_BPF_LOG(DEBUG,
 					"loop at pc:%u --> pc:%u;\n",
 					i, node->edge_dest[j]);
 		}
@@ -1877,7 +2191,8 @@ log_loop(const struct bpf_verifier *bvf)
  * instruction is a valid one (correct syntax, valid field values, etc.)
  * and constructs control flow graph (CFG).
  * Then deapth-first search is performed over the constructed graph.
- * Programs with unreachable instructions and/or loops will be rejected.
+ * Programs with unreachable instructions will be rejected.
+ * Loops are allowed, the evaluation has to prove that they are bounded.
  */
 static int
 validate(struct bpf_verifier *bvf)
@@ -1984,106 +2299,252 @@ validate(struct bpf_verifier *bvf)
 		return -EINVAL;
 	}
 
-	if (bvf->edge_type[BACK_EDGE] != 0) {
-		RTE_BPF_LOG(ERR, "%s(%p) loops detected;\n",
-			__func__, bvf);
+	if (bvf->edge_type[BACK_EDGE] != 0)
 		log_loop(bvf);
-		return -EINVAL;
-	}
 
 	return 0;
 }
 
 /*
- * helper functions get/free eval states.
+ * helper functions to allocate/free eval states.
  */
 static struct bpf_eval_state *
-pull_eval_state(struct bpf_verifier *bvf)
+dup_eval_state(const struct bpf_eval_state *st)
 {
-	uint32_t n;
+	struct bpf_eval_state *nst;
 
-	n = bvf->evst_pool.cur;
-	if (n == bvf->evst_pool.num)
-		return NULL;
-
-	bvf->evst_pool.cur = n + 1;
-	return bvf->evst_pool.ent + n;
+	nst = malloc(sizeof(*nst));
+	if (nst != NULL)
+		memcpy(nst, st, sizeof(*nst));
+	return nst;
 }
 
 static void
-push_eval_state(struct bpf_verifier *bvf)
+evst_fini(struct bpf_verifier *bvf)
 {
-	bvf->evst_pool.cur--;
+	uint32_t i;
+	struct bpf_eval_seen *sn, *next;
+
+	for (i = 0; i != bvf->pend.cur; i++)
+		free(bvf->pend.ent[i].st);
+	free(bvf->pend.ent);
+	free(bvf->walk.ent);
+
+	for (i = 0; i != bvf->prm->nb_ins; i++) {
+		free(bvf->in[i].evst);
+		for (sn = bvf->in[i].seen; sn != NULL; sn = next) {
+			next = sn->next;
+			free(sn);
+		}
+	}
+
+	free(bvf->evst);
+	bvf->evst = NULL;
 }
 
-static void
-evst_pool_fini(struct bpf_verifier *bvf)
+static int
+evst_init(struct bpf_verifier *bvf)
 {
-	bvf->evst = NULL;
-	free(bvf->evst_pool.ent);
-	memset(&bvf->evst_pool, 0, sizeof(bvf->evst_pool));
+	bvf->evst = calloc(1, sizeof(*bvf->evst));
+	if (bvf->evst == NULL)
+		return -ENOMEM;
+	return 0;
 }
 
+/*
+ * Save eval state of the branch to evaluate later.
+ */
 static int
-evst_pool_init(struct bpf_verifier *bvf)
+push_eval_state(struct bpf_verifier *bvf, uint32_t idx,
+	struct bpf_eval_state *st)
 {
 	uint32_t n;
+	struct bpf_eval_pend *ent;
+
+	n = bvf->pend.cur;
+	if (n == bvf->pend.num) {
+		n = RTE_MAX(2 * n, 64U);
+		ent = realloc(bvf->pend.ent, n * sizeof(ent[0]));
+		if (ent == NULL)
+			return -ENOMEM;
+		bvf->pend.ent = ent;
+		bvf->pend.num = n;
+		n = bvf->pend.cur;
+	}
 
-	n = bvf->nb_jcc_nodes + 1;
+	ent = bvf->pend.ent + n;
+	ent->idx = idx;
+	ent->nb_walk = bvf->walk.cur;
+	ent->st = st;
+	bvf->pend.cur = n + 1;
+	return 0;
+}
 
-	bvf->evst_pool.ent = calloc(n, sizeof(bvf->evst_pool.ent[0]));
-	if (bvf->evst_pool.ent == NULL)
-		return -ENOMEM;
+/*
+ * Replace current eval state with the last saved one.
+ * All paths from the states seen since it was saved are evaluated.
+ * Returns 0 when there is no more states to evaluate.
+ */
+static int
+pop_eval_state(struct bpf_verifier *bvf, uint32_t *idx)
+{
+	uint32_t i, n;
+	struct bpf_eval_pend *ent;
 
-	bvf->evst_pool.num = n;
-	bvf->evst_pool.cur = 0;
+	n = bvf->pend.cur;
+	if (n == 0)
+		return 0;
 
-	bvf->evst = pull_eval_state(bvf);
-	return 0;
+	ent = bvf->pend.ent + n - 1;
+	for (i = ent->nb_walk; i != bvf->walk.cur; i++)
+		bvf->walk.ent[i]->done = 1;
+	bvf->walk.cur = ent->nb_walk;
+
+	free(bvf->evst);
+	bvf->evst = ent->st;
+	*idx = ent->idx;
+	bvf->pend.cur = n - 1;
+	return 1;
 }
 
 /*
- * Save current eval state.
+ * check that the value of the register is within the seen one.
  */
 static int
-save_eval_state(struct bpf_verifier *bvf, struct inst_node *node)
+eval_reg_within(const struct bpf_reg_val *rv, const struct bpf_reg_val *sv)
 {
-	struct bpf_eval_state *st;
+	/* evaluation from the seen state didn't depend on it */
+	if (sv->v.type == RTE_BPF_ARG_UNDEF)
+		return 1;
+
+	if (rv->v.type != sv->v.type || rv->mask != sv->mask)
+		return 0;
+
+	if (rv->v.type != RTE_BPF_ARG_RAW && (rv->v.size != sv->v.size ||
+			rv->v.buf_size != sv->v.buf_size))
+		return 0;
+
+	return rv->u.min >= sv->u.min && rv->u.max <= sv->u.max &&
+		rv->s.min >= sv->s.min && rv->s.max <= sv->s.max;
+}
+
+static int
+eval_state_within(const struct bpf_eval_state *st,
+	const struct bpf_eval_seen *sn)
+{
+	uint32_t i;
+
+	for (i = 0; i != RTE_DIM(st->rv); i++) {
+		if (eval_reg_within(st->rv + i, sn->rv + i) == 0)
+			return 0;
+	}
+
+	for (i = sn->sv_first; i != RTE_DIM(st->sv); i++) {
+		if (eval_reg_within(st->sv + i, sn->sv + i - sn->sv_first) == 0)
+			return 0;
+	}
+
+	return 1;
+}
+
+/*
+ * At the node where the paths join, compare current eval state
+ * with the states already seen there:
+ * - state within a seen one, which paths are all evaluated,
+ *   doesn't need to be evaluated again.
+ * - state within a seen one, which paths are being evaluated,
+ *   is reached by a loop that can't be proven to be bounded.
+ * Otherwise current state is saved as a seen one.
+ * Returns 1 when current path is pruned.
+ */
+static int
+prune_eval_state(struct bpf_verifier *bvf, struct inst_node *node)
+{
+	uint32_t first, n;
+	struct bpf_eval_seen *sn, **ent;
+
+	for (sn = node->seen; sn != NULL; sn = sn->next) {
+
+		if (eval_state_within(bvf->evst, sn) == 0)
+			continue;
+
+		if (sn->done != 0) {
+			bvf->nb_pruned++;
+			return 1;
+		}
 
-	/* get new eval_state for this node */
-	st = pull_eval_state(bvf);
-	if (st == NULL) {
-		RTE_BPF_LOG(ERR,
-			"%s: internal error (out of space) at pc: %u\n",
+		RTE_BPF_LOG(ERR, "%s: infinite loop at pc: %u\n",
 			__func__, get_node_idx(bvf, node));
-		return -ENOMEM;
+		return -EINVAL;
 	}
 
-	/* make a copy of current state */
-	memcpy(st, bvf->evst, sizeof(*st));
+	if (bvf->nb_seen == MAX_EVAL_SEEN || node->nb_seen == MAX_NODE_SEEN)
+		return 0;
 
-	/* swap current state with new one */
-	node->evst = bvf->evst;
-	bvf->evst = st;
+	n = bvf->walk.cur;
+	if (n == bvf->walk.num) {
+		n = RTE_MAX(2 * n, 64U);
+		ent = realloc(bvf->walk.ent, n * sizeof(ent[0]));
+		if (ent == NULL)
+			return -ENOMEM;
+		bvf->walk.ent = ent;
+		bvf->walk.num = n;
+		n = bvf->walk.cur;
+	}
 
-	RTE_BPF_LOG(DEBUG, "%s(bvf=%p,node=%u) old/new states: %p/%p;\n",
-		__func__, bvf, get_node_idx(bvf, node), node->evst, bvf->evst);
+	first = (MAX_BPF_STACK_SIZE - bvf->stack_sz) / sizeof(uint64_t);
+	sn = malloc(sizeof(*sn) +
+		(RTE_DIM(bvf->evst->sv) - first) * sizeof(sn->sv[0]));
+	if (sn == NULL)
+		return -ENOMEM;
 
+	memcpy(sn->rv, bvf->evst->rv, sizeof(sn->rv));
+	memcpy(sn->sv, bvf->evst->sv + first,
+		(RTE_DIM(bvf->evst->sv) - first) * sizeof(sn->sv[0]));
+	sn->sv_first = first;
+	sn->done = 0;
+	sn->next = node->seen;
+	node->seen = sn;
+	node->nb_seen++;
+
+	bvf->walk.ent[n] = sn;
+	bvf->walk.cur = n + 1;
+	bvf->nb_seen++;
 	return 0;
 }
 
 /*
- * Restore previous eval state and mark current eval state as free.
+ * Select the branches of jcc node, which can be taken with
+ * the evaluated operand values.
+ * When both can be taken, false one is saved for later evaluation.
  */
-static void
-restore_eval_state(struct bpf_verifier *bvf, struct inst_node *node)
+static int
+eval_jcc_branch(struct bpf_verifier *bvf, struct inst_node *node,
+	const struct ebpf_insn *ins, uint32_t *idx)
 {
-	RTE_BPF_LOG(DEBUG, "%s(bvf=%p,node=%u) old/new states: %p/%p;\n",
-		__func__, bvf, get_node_idx(bvf, node), bvf->evst, node->evst);
+	int32_t rc;
+	struct bpf_eval_state *fst;
 
-	bvf->evst = node->evst;
+	fst = node->evst;
 	node->evst = NULL;
-	push_eval_state(bvf);
+
+	if (eval_jcc_empty(fst, ins)) {
+		free(fst);
+		*idx = node->edge_dest[0];
+	} else if (eval_jcc_empty(bvf->evst, ins)) {
+		free(bvf->evst);
+		bvf->evst = fst;
+		*idx = node->edge_dest[1];
+	} else {
+		rc = push_eval_state(bvf, node->edge_dest[1], fst);
+		if (rc != 0) {
+			free(fst);
+			return rc;
+		}
+		*idx = node->edge_dest[0];
+	}
+
+	return 0;
 }
 
 static void
@@ -2115,6 +2576,9 @@ log_eval_state(const struct bpf_verifier *bvf, const struct ebpf_insn *ins,
 /*
  * Do second pass through CFG and try to evaluate instructions
  * via each possible path.
+ * Branches, which can't be taken with the evaluated values, are skipped,
+ * so a loop is evaluated until its exit condition is met.
+ * Paths joining with an already evaluated state are pruned.
  * Right now evaluation functionality is quite limited.
  * Still need to add extra checks for:
  * - use/return uninitialized registers.
@@ -2128,7 +2592,7 @@ evaluate(struct bpf_verifier *bvf)
 	uint32_t idx, op;
 	const char *err;
 	const struct ebpf_insn *ins;
-	struct inst_node *next, *node;
+	struct inst_node *node;
 
 	/* initial state of frame pointer */
 	static const struct bpf_reg_val rvfp = {
@@ -2149,63 +2613,73 @@ evaluate(struct bpf_verifier *bvf)
 	bvf->evst->rv[EBPF_REG_10] = rvfp;
 
 	ins = bvf->prm->ins;
-	node = bvf->in;
-	next = node;
+	idx = 0;
 	rc = 0;
 
-	while (node != NULL && rc == 0) {
+	do {
+		node = bvf->in + idx;
+		op = ins[idx].code;
 
-		/*
-		 * current node evaluation, make sure we evaluate
-		 * each node only once.
-		 */
-		if (next != NULL) {
+		if (++bvf->nb_eval_ins > MAX_EVAL_INS) {
+			RTE_BPF_LOG(ERR, "%s: too many instructions to evaluate "
+				"at pc: %u, loop may be unbounded\n",
+				__func__, idx);
+			rc = -EINVAL;
+			break;
+		}
 
-			bvf->evin = node;
-			idx = get_node_idx(bvf, node);
-			op = ins[idx].code;
-
-			/* for jcc node make a copy of evaluatoion state */
-			if (node->nb_edge > 1)
-				rc |= save_eval_state(bvf, node);
-
-			if (ins_chk[op].eval != NULL && rc == 0) {
-				err = ins_chk[op].eval(bvf, ins + idx);
-				if (err != NULL) {
-					RTE_BPF_LOG(ERR, "%s: %s at pc: %u\n",
-						__func__, err, idx);
-					rc = -EINVAL;
-				}
+		/* paths join at this node, try to prune current one */
+		if (node->nb_in_edge > 1) {
+			rc = prune_eval_state(bvf, node);
+			if (rc < 0)
+				break;
+			if (rc > 0) {
+				rc = 0;
+				if (pop_eval_state(bvf, &idx) == 0)
+					break;
+				continue;
 			}
+		}
 
-			log_eval_state(bvf, ins + idx, idx, RTE_LOG_DEBUG);
+		/* for jcc node make a copy of evaluation state */
+		if (node->nb_edge > 1) {
+			node->evst = dup_eval_state(bvf->evst);
+			if (node->evst == NULL) {
+				rc = -ENOMEM;
+				break;
+			}
+		}
+
+		if (ins_chk[op].eval != NULL) {
+			bvf->evin = node;
+			err = ins_chk[op].eval(bvf, ins + idx);
 			bvf->evin = NULL;
+			if (err != NULL) {
+				RTE_BPF_LOG(ERR, "%s: %s at pc: %u\n",
+					__func__, err, idx);
+				rc = -EINVAL;
+				break;
+			}
 		}
 
+		log_eval_state(bvf, ins + idx, idx, RTE_LOG_DEBUG);
+
 		/* proceed through CFG */
-		next = get_next_node(bvf, node);
-		if (next != NULL) {
+		if (node->nb_edge > 1)
+			rc = eval_jcc_branch(bvf, node, ins + idx, &idx);
+		else if (node->nb_edge == 1)
+			idx = node->edge_dest[0];
+		else if (pop_eval_state(bvf, &idx) == 0)
+			break;
 
-			/* proceed with next child */
-			if (node->cur_edge == node->nb_edge &&
-					node->evst != NULL)
-				restore_eval_state(bvf, node);
+	} while (rc == 0);
 
-			next->prev_node = get_node_idx(bvf, node);
-			node = next;
-		} else {
-			/*
-			 * finished with current node and all it's kids,
-			 * proceed with parent
-			 */
-			node->cur_edge = 0;
-			node = get_prev_node(bvf, node);
-
-			/* finished */
-			if (node == bvf->in)
-				node = NULL;
-		}
-	}
+	RTE_BPF_LOG(DEBUG, "%s(%p) stats:\n"
+		"nb_eval_ins=%u;\n"
+		"nb_seen=%u;\n"
+		"nb_pruned=%u;\n",
+		__func__, bvf, bvf->nb_eval_ins, bvf->nb_seen,
+		bvf->nb_pruned);
 
 	return rc;
 }
@@ -2234,10 +2708,10 @@ bpf_validate(struct rte_bpf *bpf)
 	rc = validate(&bvf);
 
 	if (rc == 0) {
-		rc = evst_pool_init(&bvf);
+		rc = evst_init(&bvf);
 		if (rc == 0)
 			rc = evaluate(&bvf);
-		evst_pool_fini(&bvf);
+		evst_fini(&bvf);
 	}
 
 	free(bvf.in);
@@ -60,9 +60,12 @@ struct rte_bpf_arg {
 enum rte_bpf_xtype {
 	RTE_BPF_XTYPE_FUNC, /**< function */
 	RTE_BPF_XTYPE_VAR,  /**< variable */
+	RTE_BPF_XTYPE_MAP,  /**< map */
 	RTE_BPF_XTYPE_NUM
 };
 
+struct rte_bpf_map;
+
 /**
  * Definition for external symbols available in the BPF program.
  */
@@ -82,9 +85,56 @@ struct rte_bpf_xsym {
 			void *val; /**< actual memory location */
 			struct rte_bpf_arg desc; /**< type, size, etc. */
 		} var; /**< external variable */
+		struct {
+			struct rte_bpf_map *val; /**< map to reference */
+		} map; /**< map, see rte_bpf_map_create() */
 	};
 };
 
+/**
+ * Possible types of maps.
+ */
+enum rte_bpf_map_type {
+	RTE_BPF_MAP_TYPE_HASH,        /**< hash table of keys */
+	RTE_BPF_MAP_TYPE_ARRAY,       /**< array indexed by a uint32_t key */
+	RTE_BPF_MAP_TYPE_LCORE_ARRAY, /**< array with one copy per lcore */
+};
+
+/**
+ * Input parameters for creating a map.
+ */
+struct rte_bpf_map_prm {
+	const char *name;           /**< name, required for hash maps */
+	enum rte_bpf_map_type type; /**< map type */
+	uint32_t key_size;          /**< key size, 4 for array maps */
+	uint32_t value_size;        /**< value size */
+	uint32_t max_entries;       /**< maximum number of entries */
+	int socket_id;              /**< NUMA socket of the map memory */
+};
+
+/**
+ * Map functions which eBPF code can call.
+ *
+ * They are appended to the external symbols of the BPF program,
+ * see RTE_BPF_MAP_FUNC_IDX(). They are also resolved by name from ELF files,
+ * where the program declares them as the rte_bpf_map_lookup(),
+ * rte_bpf_map_update() and rte_bpf_map_delete() functions of this API.
+ * The map passed as first argument must be an external symbol of the
+ * program, loaded with a 64-bit immediate load.
+ */
+enum rte_bpf_map_func {
+	RTE_BPF_MAP_FUNC_LOOKUP, /**< rte_bpf_map_lookup() */
+	RTE_BPF_MAP_FUNC_UPDATE, /**< rte_bpf_map_update() */
+	RTE_BPF_MAP_FUNC_DELETE, /**< rte_bpf_map_delete() */
+	RTE_BPF_MAP_FUNC_NUM
+};
+
+/**
+ * Index of a map function in the external symbols of a BPF program loaded
+ * with the parameters *prm*, to use as immediate value of EBPF_CALL.
+ */
+#define RTE_BPF_MAP_FUNC_IDX(prm, func)	((prm)->nb_xsym + (func))
+
 /**
  * Input parameters for loading eBPF code.
  */
@@ -103,6 +153,11 @@ struct rte_bpf_prm {
 struct rte_bpf_jit {
 	uint64_t (*func)(void *); /**< JIT-ed native code */
 	size_t sz;                /**< size of JIT-ed code */
+	uint32_t (*burst)(void *ctx[], uint64_t rc[], uint32_t num);
+	/**<
+	 * JIT-ed native code executing the program over a set of input
+	 * contexts, as rte_bpf_exec_burst() does, NULL if not generated.
+	 */
 };
 
 struct rte_bpf;
@@ -205,6 +260,108 @@ __rte_experimental
 int
 rte_bpf_get_jit(const struct rte_bpf *bpf, struct rte_bpf_jit *jit);
 
+/**
+ * Create a new map, which BPF programs reference as external symbol.
+ *
+ * @param prm
+ *  Parameters used to create the map.
+ * @return
+ *   Map handle, or NULL on error, with error code set in rte_errno.
+ *   Possible rte_errno errors include:
+ *   - EINVAL - invalid parameter passed to function
+ *   - ENOMEM - can't reserve enough memory
+ *   - EEXIST - a hash map with the same name already exists
+ */
+__rte_experimental
+struct rte_bpf_map *
+rte_bpf_map_create(const struct rte_bpf_map_prm *prm);
+
+/**
+ * De-allocate all memory used by a map.
+ * The programs referencing it must have been destroyed.
+ *
+ * @param map
+ *   Map to destroy.
+ */
+__rte_experimental
+void
+rte_bpf_map_destroy(struct rte_bpf_map *map);
+
+/**
+ * Look up a value in a map.
+ *
+ * The value of a per-lcore array is the one of the calling lcore.
+ * Hash maps can be looked up from any thread, concurrently with updates
+ * and deletions, however the value of a deleted key can be reused by
+ * another key while it is still accessed.
+ *
+ * @param map
+ *   Map to look up.
+ * @param key
+ *   Pointer to the key.
+ * @return
+ *   Pointer to the value, or NULL if the key is not found, or if the calling
+ *   thread is not an EAL thread for a per-lcore array.
+ */
+__rte_experimental
+void *
+rte_bpf_map_lookup(struct rte_bpf_map *map, const void *key);
+
+/**
+ * Look up the value of an lcore in a per-lcore array, to aggregate the
+ * values of all the lcores. Equivalent to rte_bpf_map_lookup() for the
+ * other maps.
+ *
+ * @param map
+ *   Map to look up.
+ * @param key
+ *   Pointer to the key.
+ * @param lcore_id
+ *   The lcore of the value.
+ * @return
+ *   Pointer to the value, or NULL if the key or lcore is not found.
+ */
+__rte_experimental
+void *
+rte_bpf_map_lookup_lcore(struct rte_bpf_map *map, const void *key,
+		unsigned int lcore_id);
+
+/**
+ * Add or update an entry of a map.
+ * The value of a per-lcore array is the one of the calling lcore.
+ *
+ * @param map
+ *   Map to update.
+ * @param key
+ *   Pointer to the key.
+ * @param value
+ *   Pointer to the value to copy.
+ * @return
+ *   - 0 on success.
+ *   - -ENOENT if the key is out of range of an array.
+ *   - -ENOSPC if the hash map is full.
+ */
+__rte_experimental
+int
+rte_bpf_map_update(struct rte_bpf_map *map, const void *key,
+		const void *value);
+
+/**
+ * Delete an entry of a hash map.
+ *
+ * @param map
+ *   Map to update.
+ * @param key
+ *   Pointer to the key.
+ * @return
+ *   - 0 on success.
+ *   - -ENOENT if the key is not found.
+ *   - -ENOTSUP if the map is an array.
+ */
+__rte_experimental
+int
+rte_bpf_map_delete(struct rte_bpf_map *map, const void *key);
+
 #ifdef __cplusplus
 }
 #endif
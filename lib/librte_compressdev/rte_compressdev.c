@@ -196,6 +196,9 @@ rte_compressdev_data_alloc(uint8_t dev_id, struct rte_compressdev_data **data,
 		mz = rte_memzone_reserve(mz_name,
 				sizeof(struct rte_compressdev_data),
 				socket_id, 0);
+		/* a warm restarted primary takes over the previous one */
+		if (mz == NULL && rte_eal_warm_restarted())
+			mz = rte_memzone_lookup(mz_name);
 	} else
 		mz = rte_memzone_lookup(mz_name);
 
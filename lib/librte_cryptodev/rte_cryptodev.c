@@ -658,6 +658,9 @@ rte_cryptodev_data_alloc(uint8_t dev_id, struct rte_cryptodev_data **data,
 		mz = rte_memzone_reserve(mz_name,
 				sizeof(struct rte_cryptodev_data),
 				socket_id, 0);
+		/* a warm restarted primary takes over the previous one */
+		if (mz == NULL && rte_eal_warm_restarted())
+			mz = rte_memzone_lookup(mz_name);
 	} else
 		mz = rte_memzone_lookup(mz_name);
 
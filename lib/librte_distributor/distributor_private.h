@@ -66,6 +66,19 @@ union rte_distributor_buffer_single {
  */
 #define RTE_DIST_BURST_SIZE 8
 
+/*
+ * Number of bursts whose flows are matched in one pass of
+ * rte_distributor_process(), before any of them is assigned to a worker
+ */
+#define RTE_DIST_MATCH_BURSTS 4
+
+/*
+ * Size of the queue of packets returned by each worker, a worker only
+ * waits for the distributor when it is full
+ */
+#define RTE_DIST_RETURN_QUEUE_SIZE 64
+#define RTE_DIST_RETURN_QUEUE_MASK (RTE_DIST_RETURN_QUEUE_SIZE - 1)
+
 struct rte_distributor_backlog {
 	unsigned int start;
 	unsigned int count;
@@ -105,6 +118,7 @@ struct rte_distributor_single {
 enum rte_distributor_match_function {
 	RTE_DIST_MATCH_SCALAR = 0,
 	RTE_DIST_MATCH_VECTOR,
+	RTE_DIST_MATCH_AVX512,
 	RTE_DIST_NUM_MATCH_FNS
 };
 
@@ -114,7 +128,10 @@ enum rte_distributor_match_function {
  * prefetches of buffers for other workers, e.g. when worker 1's buffer is on
  * the next cache line to worker 0, we pad this out to two cache lines.
  * We can pass up to 8 mbufs at a time in one cacheline.
- * There is a separate cacheline for returns in the burst API.
+ * Returns in the burst API go through a single producer, single consumer
+ * queue: the worker writes the mbufs and moves the head, the distributor
+ * drains them and moves the tail, each index on its own cache line, so
+ * neither side waits for the other unless the queue is full.
  */
 struct rte_distributor_buffer {
 	volatile int64_t bufptr64[RTE_DIST_BURST_SIZE]
@@ -122,12 +139,16 @@ struct rte_distributor_buffer {
 
 	int64_t pad1 __rte_cache_aligned;    /* <= one cache line  */
 
-	volatile int64_t retptr64[RTE_DIST_BURST_SIZE]
-		__rte_cache_aligned; /* <= incoming from worker */
+	uint32_t ret_head __rte_cache_aligned; /* <= written by worker */
+	uint32_t ret_tail_cache;  /* <= last ret_tail seen by worker */
 
 	int64_t pad2 __rte_cache_aligned;    /* <= one cache line  */
 
-	int count __rte_cache_aligned;       /* <= number of current mbufs */
+	uint32_t ret_tail __rte_cache_aligned; /* <= written by distributor */
+	int count;                           /* <= number of current mbufs */
+
+	struct rte_mbuf *ret_mbufs[RTE_DIST_RETURN_QUEUE_SIZE]
+		__rte_cache_aligned; /* <= incoming from worker */
 };
 
 struct rte_distributor {
@@ -167,6 +188,11 @@ find_match_vec(struct rte_distributor *d,
 			uint16_t *data_ptr,
 			uint16_t *output_ptr);
 
+void
+find_match_avx512(struct rte_distributor *d,
+			uint16_t *data_ptr,
+			uint16_t *output_ptr);
+
 #ifdef __cplusplus
 }
 #endif
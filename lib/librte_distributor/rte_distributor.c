@@ -8,6 +8,7 @@
 #include <rte_mbuf.h>
 #include <rte_memory.h>
 #include <rte_cycles.h>
+#include <rte_cpuflags.h>
 #include <rte_memzone.h>
 #include <rte_errno.h>
 #include <rte_string_fns.h>
@@ -30,56 +31,60 @@ EAL_REGISTER_TAILQ(rte_dist_burst_tailq)
 
 /**** Burst Packet APIs called by workers ****/
 
+/*
+ * Queue packets returned by a worker for the distributor. The worker only
+ * waits when the queue is full, until the distributor drains it.
+ */
+static void
+enqueue_returns(struct rte_distributor_buffer *buf,
+		struct rte_mbuf **oldpkt, unsigned int count)
+{
+	uint32_t head = buf->ret_head;
+	unsigned int i, n;
+
+	while (count > 0) {
+		n = RTE_DIST_RETURN_QUEUE_SIZE - (head - buf->ret_tail_cache);
+		if (n < count) {
+			/* Sync with distributor to acquire drained entries */
+			buf->ret_tail_cache = __atomic_load_n(&buf->ret_tail,
+					__ATOMIC_ACQUIRE);
+			n = RTE_DIST_RETURN_QUEUE_SIZE -
+					(head - buf->ret_tail_cache);
+			if (unlikely(n == 0)) {
+				rte_pause();
+				continue;
+			}
+		}
+		n = RTE_MIN(n, count);
+		for (i = 0; i < n; i++)
+			buf->ret_mbufs[(head + i) & RTE_DIST_RETURN_QUEUE_MASK] =
+					oldpkt[i];
+		head += n;
+		oldpkt += n;
+		count -= n;
+
+		/* Sync with distributor. Release the returned mbufs. */
+		__atomic_store_n(&buf->ret_head, head, __ATOMIC_RELEASE);
+	}
+}
+
 void
 rte_distributor_request_pkt(struct rte_distributor *d,
 		unsigned int worker_id, struct rte_mbuf **oldpkt,
 		unsigned int count)
 {
-	struct rte_distributor_buffer *buf = &(d->bufs[worker_id]);
-	unsigned int i;
-
-	volatile int64_t *retptr64;
-
 	if (unlikely(d->alg_type == RTE_DIST_ALG_SINGLE)) {
 		rte_distributor_request_pkt_single(d->d_single,
 			worker_id, oldpkt[0]);
 		return;
 	}
 
-	retptr64 = &(buf->retptr64[0]);
-	/* Spin while handshake bits are set (scheduler clears it).
-	 * Sync with worker on GET_BUF flag.
-	 */
-	while (unlikely(__atomic_load_n(retptr64, __ATOMIC_ACQUIRE)
-			& RTE_DISTRIB_GET_BUF)) {
-		rte_pause();
-		uint64_t t = rte_rdtsc()+100;
-
-		while (rte_rdtsc() < t)
-			rte_pause();
-	}
-
 	/*
-	 * OK, if we've got here, then the scheduler has just cleared the
-	 * handshake bits. Populate the retptrs with returning packets.
+	 * The request itself is signalled by the GET_BUF flag set on the
+	 * bufptrs in rte_distributor_poll_pkt(), only the returned packets
+	 * are passed here.
 	 */
-
-	for (i = count; i < RTE_DIST_BURST_SIZE; i++)
-		buf->retptr64[i] = 0;
-
-	/* Set Return bit for each packet returned */
-	for (i = count; i-- > 0; )
-		buf->retptr64[i] =
-			(((int64_t)(uintptr_t)(oldpkt[i])) <<
-			RTE_DISTRIB_FLAG_BITS) | RTE_DISTRIB_RETURN_BUF;
-
-	/*
-	 * Finally, set the GET_BUF  to signal to distributor that cache
-	 * line is ready for processing
-	 * Sync with distributor to release retptrs
-	 */
-	__atomic_store_n(retptr64, *retptr64 | RTE_DISTRIB_GET_BUF,
-			__ATOMIC_RELEASE);
+	enqueue_returns(&d->bufs[worker_id], oldpkt, count);
 }
 
 int
@@ -159,7 +164,6 @@ rte_distributor_return_pkt(struct rte_distributor *d,
 		unsigned int worker_id, struct rte_mbuf **oldpkt, int num)
 {
 	struct rte_distributor_buffer *buf = &d->bufs[worker_id];
-	unsigned int i;
 
 	if (unlikely(d->alg_type == RTE_DIST_ALG_SINGLE)) {
 		if (num == 1)
@@ -169,21 +173,10 @@ rte_distributor_return_pkt(struct rte_distributor *d,
 			return -EINVAL;
 	}
 
-	/* Sync with distributor to acquire retptrs */
-	__atomic_thread_fence(__ATOMIC_ACQUIRE);
-	for (i = 0; i < RTE_DIST_BURST_SIZE; i++)
-		/* Switch off the return bit first */
-		buf->retptr64[i] &= ~RTE_DISTRIB_RETURN_BUF;
-
-	for (i = num; i-- > 0; )
-		buf->retptr64[i] = (((int64_t)(uintptr_t)oldpkt[i]) <<
-			RTE_DISTRIB_FLAG_BITS) | RTE_DISTRIB_RETURN_BUF;
+	if (num < 0)
+		return -EINVAL;
 
-	/* set the GET_BUF but even if we got no returns.
-	 * Sync with distributor on GET_BUF flag. Release retptrs.
-	 */
-	__atomic_store_n(&(buf->retptr64[0]),
-		buf->retptr64[0] | RTE_DISTRIB_GET_BUF, __ATOMIC_RELEASE);
+	enqueue_returns(buf, oldpkt, num);
 
 	return 0;
 }
@@ -255,9 +248,8 @@ find_match_scalar(struct rte_distributor *d,
 
 
 /*
- * When the handshake bits indicate that there are packets coming
- * back from the worker, this function is called to copy and store
- * the valid returned pointers (store_return).
+ * Drain the packets queued by a worker in its return queue, and
+ * copy and store the returned pointers (store_return).
  */
 static unsigned int
 handle_returns(struct rte_distributor *d, unsigned int wkr)
@@ -266,29 +258,29 @@ handle_returns(struct rte_distributor *d, unsigned int wkr)
 	uintptr_t oldbuf;
 	unsigned int ret_start = d->returns.start,
 			ret_count = d->returns.count;
-	unsigned int count = 0;
-	unsigned int i;
+	uint32_t head, tail = buf->ret_tail;
+	unsigned int count;
 
-	/* Sync on GET_BUF flag. Acquire retptrs. */
-	if (__atomic_load_n(&(buf->retptr64[0]), __ATOMIC_ACQUIRE)
-		& RTE_DISTRIB_GET_BUF) {
-		for (i = 0; i < RTE_DIST_BURST_SIZE; i++) {
-			if (buf->retptr64[i] & RTE_DISTRIB_RETURN_BUF) {
-				oldbuf = ((uintptr_t)(buf->retptr64[i] >>
-					RTE_DISTRIB_FLAG_BITS));
-				/* store returns in a circular buffer */
-				store_return(oldbuf, d, &ret_start, &ret_count);
-				count++;
-				buf->retptr64[i] &= ~RTE_DISTRIB_RETURN_BUF;
-			}
-		}
-		d->returns.start = ret_start;
-		d->returns.count = ret_count;
-		/* Clear for the worker to populate with more returns.
-		 * Sync with distributor on GET_BUF flag. Release retptrs.
-		 */
-		__atomic_store_n(&(buf->retptr64[0]), 0, __ATOMIC_RELEASE);
+	/* Sync with worker. Acquire the returned mbufs. */
+	head = __atomic_load_n(&buf->ret_head, __ATOMIC_ACQUIRE);
+	count = head - tail;
+	if (count == 0)
+		return 0;
+
+	for (; tail != head; tail++) {
+		oldbuf = (uintptr_t)buf->ret_mbufs[tail &
+				RTE_DIST_RETURN_QUEUE_MASK];
+		/* store returns in a circular buffer */
+		store_return(oldbuf, d, &ret_start, &ret_count);
 	}
+	d->returns.start = ret_start;
+	d->returns.count = ret_count;
+
+	/* Free the entries for the worker to queue more returns.
+	 * Sync with worker. Release the drained entries.
+	 */
+	__atomic_store_n(&buf->ret_tail, tail, __ATOMIC_RELEASE);
+
 	return count;
 }
 
@@ -307,10 +299,14 @@ release(struct rte_distributor *d, unsigned int wkr)
 	struct rte_distributor_buffer *buf = &(d->bufs[wkr]);
 	unsigned int i;
 
-	/* Sync with worker on GET_BUF flag */
+	/* Sync with worker on GET_BUF flag. Keep draining the returns
+	 * while waiting, in case the worker waits for room to queue more.
+	 */
 	while (!(__atomic_load_n(&(d->bufs[wkr].bufptr64[0]), __ATOMIC_ACQUIRE)
-		& RTE_DISTRIB_GET_BUF))
+		& RTE_DISTRIB_GET_BUF)) {
+		handle_returns(d, wkr);
 		rte_pause();
+	}
 
 	handle_returns(d, wkr);
 
@@ -339,6 +335,29 @@ release(struct rte_distributor *d, unsigned int wkr)
 }
 
 
+/*
+ * Find a worker for the flows which are not pinned yet, starting from the
+ * next one in round-robin order: a worker whose backlog has room, or which
+ * is ready to take its backlog, so that release() does not wait for it.
+ * If all of them are busy with a full backlog, the next one is used.
+ */
+static unsigned int
+find_free_worker(struct rte_distributor *d, unsigned int wkr)
+{
+	unsigned int i, w = wkr;
+
+	for (i = 0; i < d->num_workers; i++) {
+		/* Sync with worker on GET_BUF flag. */
+		if (d->backlog[w].count < RTE_DIST_BURST_SIZE ||
+				(__atomic_load_n(&(d->bufs[w].bufptr64[0]),
+				__ATOMIC_ACQUIRE) & RTE_DISTRIB_GET_BUF))
+			return w;
+		if (++w >= d->num_workers)
+			w = 0;
+	}
+	return wkr;
+}
+
 /* process a set of packets to distribute them to workers */
 int
 rte_distributor_process(struct rte_distributor *d,
@@ -349,8 +368,11 @@ rte_distributor_process(struct rte_distributor *d,
 	struct rte_mbuf *next_mb = NULL;
 	int64_t next_value = 0;
 	uint16_t new_tag = 0;
-	uint16_t flows[RTE_DIST_BURST_SIZE] __rte_cache_aligned;
-	unsigned int i, j, w, wid;
+	uint16_t flows[RTE_DIST_BURST_SIZE * RTE_DIST_MATCH_BURSTS]
+			__rte_cache_aligned;
+	uint16_t matches[RTE_DIST_BURST_SIZE * RTE_DIST_MATCH_BURSTS]
+			__rte_cache_aligned;
+	unsigned int i, j, w, wid, free_wkr = 0;
 
 	if (d->alg_type == RTE_DIST_ALG_SINGLE) {
 		/* Call the old API */
@@ -371,19 +393,20 @@ rte_distributor_process(struct rte_distributor *d,
 		return 0;
 	}
 
+	if (wkr >= d->num_workers)
+		wkr = 0;
+
 	while (next_idx < num_mbufs) {
-		uint16_t matches[RTE_DIST_BURST_SIZE];
 		unsigned int pkts;
 
-		/* Sync with worker on GET_BUF flag. */
-		if (__atomic_load_n(&(d->bufs[wkr].bufptr64[0]),
-			__ATOMIC_ACQUIRE) & RTE_DISTRIB_GET_BUF)
-			d->bufs[wkr].count = 0;
-
-		if ((num_mbufs - next_idx) < RTE_DIST_BURST_SIZE)
-			pkts = num_mbufs - next_idx;
-		else
-			pkts = RTE_DIST_BURST_SIZE;
+		/*
+		 * Match up to RTE_DIST_MATCH_BURSTS bursts against the
+		 * inflights and backlogs before assigning any of them, so
+		 * that the match functions run back to back.
+		 */
+		pkts = RTE_MIN(num_mbufs - next_idx,
+				(unsigned int)(RTE_DIST_BURST_SIZE *
+				RTE_DIST_MATCH_BURSTS));
 
 		for (i = 0; i < pkts; i++) {
 			if (mbufs[next_idx + i]) {
@@ -392,15 +415,22 @@ rte_distributor_process(struct rte_distributor *d,
 			} else
 				flows[i] = 0;
 		}
-		for (; i < RTE_DIST_BURST_SIZE; i++)
+		for (; i & (RTE_DIST_BURST_SIZE - 1); i++)
 			flows[i] = 0;
 
-		switch (d->dist_match_fn) {
-		case RTE_DIST_MATCH_VECTOR:
-			find_match_vec(d, &flows[0], &matches[0]);
-			break;
-		default:
-			find_match_scalar(d, &flows[0], &matches[0]);
+		for (j = 0; j < i; j += RTE_DIST_BURST_SIZE) {
+			switch (d->dist_match_fn) {
+#ifdef CC_AVX512_SUPPORT
+			case RTE_DIST_MATCH_AVX512:
+				find_match_avx512(d, &flows[j], &matches[j]);
+				break;
+#endif
+			case RTE_DIST_MATCH_VECTOR:
+				find_match_vec(d, &flows[j], &matches[j]);
+				break;
+			default:
+				find_match_scalar(d, &flows[j], &matches[j]);
+			}
 		}
 
 		/*
@@ -410,6 +440,12 @@ rte_distributor_process(struct rte_distributor *d,
 		 */
 
 		for (j = 0; j < pkts; j++) {
+			struct rte_distributor_backlog *bl;
+			unsigned int idx;
+
+			/* Unpinned flows of each burst go to one worker */
+			if ((j & (RTE_DIST_BURST_SIZE - 1)) == 0)
+				free_wkr = find_free_worker(d, wkr);
 
 			next_mb = mbufs[next_idx++];
 			next_value = (((int64_t)(uintptr_t)next_mb) <<
@@ -431,46 +467,41 @@ rte_distributor_process(struct rte_distributor *d,
 			/* matches[j] = 0; */
 
 			if (matches[j]) {
-				struct rte_distributor_backlog *bl =
-						&d->backlog[matches[j]-1];
+				/* Add to worker that already has flow */
+				bl = &d->backlog[matches[j]-1];
 				if (unlikely(bl->count ==
 						RTE_DIST_BURST_SIZE)) {
 					release(d, matches[j]-1);
 				}
-
-				/* Add to worker that already has flow */
-				unsigned int idx = bl->count++;
-
-				bl->tags[idx] = new_tag;
-				bl->pkts[idx] = next_value;
-
 			} else {
-				struct rte_distributor_backlog *bl =
-						&d->backlog[wkr];
+				/* Add to current worker worker */
+				bl = &d->backlog[free_wkr];
 				if (unlikely(bl->count ==
 						RTE_DIST_BURST_SIZE)) {
-					release(d, wkr);
+					release(d, free_wkr);
 				}
-
-				/* Add to current worker worker */
-				unsigned int idx = bl->count++;
-
-				bl->tags[idx] = new_tag;
-				bl->pkts[idx] = next_value;
 				/*
 				 * Now that we've just added an unpinned flow
 				 * to a worker, we need to ensure that all
 				 * other packets with that same flow will go
-				 * to the same worker in this burst.
+				 * to the same worker in this window.
 				 */
 				for (w = j; w < pkts; w++)
 					if (flows[w] == new_tag)
-						matches[w] = wkr+1;
+						matches[w] = free_wkr+1;
+			}
+
+			idx = bl->count++;
+			bl->tags[idx] = new_tag;
+			bl->pkts[idx] = next_value;
+
+			/* Move to the next worker after each burst */
+			if (((j + 1) & (RTE_DIST_BURST_SIZE - 1)) == 0 ||
+					j + 1 == pkts) {
+				if (++wkr >= d->num_workers)
+					wkr = 0;
 			}
 		}
-		wkr++;
-		if (wkr >= d->num_workers)
-			wkr = 0;
 	}
 
 	/* Flush out all non-full cache-lines to workers. */
@@ -575,9 +606,10 @@ rte_distributor_clear_returns(struct rte_distributor *d)
 
 	/* throw away returns, so workers can exit */
 	for (wkr = 0; wkr < d->num_workers; wkr++)
-		/* Sync with worker. Release retptrs. */
-		__atomic_store_n(&(d->bufs[wkr].retptr64[0]), 0,
-				__ATOMIC_RELEASE);
+		/* Sync with worker. Release the queued entries. */
+		__atomic_store_n(&(d->bufs[wkr].ret_tail),
+				__atomic_load_n(&(d->bufs[wkr].ret_head),
+				__ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
 }
 
 /* creates a distributor instance */
@@ -637,6 +669,11 @@ rte_distributor_create(const char *name,
 	d->dist_match_fn = RTE_DIST_MATCH_SCALAR;
 #if defined(RTE_ARCH_X86)
 	d->dist_match_fn = RTE_DIST_MATCH_VECTOR;
+#ifdef CC_AVX512_SUPPORT
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) &&
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512BW))
+		d->dist_match_fn = RTE_DIST_MATCH_AVX512;
+#endif
 #endif
 
 	/*
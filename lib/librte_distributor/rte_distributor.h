@@ -171,6 +171,9 @@ rte_distributor_get_pkt(struct rte_distributor *d,
  * API called by a worker to return a completed packet without requesting a
  * new packet, for example, because a worker thread is shutting down
  *
+ * In burst mode, the packets are queued for the distributor, this only
+ * waits for the distributor when the queue of the worker is full.
+ *
  * @param d
  *   The distributor instance to be used
  * @param worker_id
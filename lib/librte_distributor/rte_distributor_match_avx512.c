@@ -0,0 +1,64 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#include <rte_mbuf.h>
+#include "rte_distributor.h"
+#include "distributor_private.h"
+#include <immintrin.h>
+
+/* Tags of two workers, inflights and backlog, fill one 64-byte register */
+#define WORKERS_PER_VEC 2
+#define TAGS_PER_WORKER (RTE_DIST_BURST_SIZE * 2)
+
+void
+find_match_avx512(struct rte_distributor *d,
+			uint16_t *data_ptr,
+			uint16_t *output_ptr)
+{
+	__m512i incoming_fids[RTE_DIST_BURST_SIZE];
+	__m512i worker_fids;
+	__mmask32 valid, mask;
+	unsigned int i, j;
+
+	/*
+	 * Function overview:
+	 * 1. Broadcast each incoming flow id into its own zmm register
+	 * 2. Loop through the workers two at a time
+	 *  2a. Load the inflights and backlog of both workers (one cache
+	 *      line) into a zmm register
+	 *  2b. Compare it with each incoming flow id, the low 16 bits of
+	 *      the mask are the first worker, the high 16 bits the second
+	 *  2c. Store the matching worker id (+1), the last match wins as
+	 *      in the scalar version
+	 */
+
+	for (j = 0; j < RTE_DIST_BURST_SIZE; j++) {
+		output_ptr[j] = 0;
+		incoming_fids[j] = _mm512_set1_epi16(data_ptr[j]);
+	}
+
+	for (i = 0; i < d->num_workers; i += WORKERS_PER_VEC) {
+		worker_fids = _mm512_load_si512(
+				(const void *)&d->in_flight_tags[i][0]);
+
+		/* The tags past the last worker are not in use */
+		valid = (i + 1 < d->num_workers) ? UINT32_MAX :
+				(1U << TAGS_PER_WORKER) - 1;
+
+		for (j = 0; j < RTE_DIST_BURST_SIZE; j++) {
+			mask = _mm512_mask_cmpeq_epi16_mask(valid,
+					worker_fids, incoming_fids[j]);
+			if (mask == 0)
+				continue;
+			output_ptr[j] = i + 1 +
+					((mask >> TAGS_PER_WORKER) != 0);
+		}
+	}
+
+	/*
+	 * At this stage, the output contains 8 16-bit values, with
+	 * each non-zero value containing the worker ID on which the
+	 * corresponding flow is pinned to.
+	 */
+}
@@ -6,6 +6,8 @@
 #include <limits.h>
 #include <string.h>
 
+#include <rte_branch_prediction.h>
+#include <rte_cycles.h>
 #include <rte_errno.h>
 #include <rte_log.h>
 #include <rte_eal.h>
@@ -209,3 +211,96 @@ rte_socket_id_by_idx(unsigned int idx)
 	}
 	return config->numa_nodes[idx];
 }
+
+struct lcore_busyness {
+	uint64_t last_tsc;
+	uint64_t period_start;
+	uint64_t period_busy;
+	struct rte_lcore_busyness_stats stats;
+	int busy;
+	int percent;
+} __rte_cache_aligned;
+
+static struct lcore_busyness lcore_busyness[RTE_MAX_LCORE];
+static int busyness_enabled = 1;
+/* reports older than this are from before the accounting was enabled */
+static uint64_t busyness_enable_tsc;
+static uint64_t busyness_period;
+
+void
+rte_lcore_busyness_update(uint16_t nb_work)
+{
+	unsigned int lcore_id = rte_lcore_id();
+	struct lcore_busyness *lb;
+	uint64_t now, cycles;
+
+	if (unlikely(!busyness_enabled || lcore_id >= RTE_MAX_LCORE))
+		return;
+
+	lb = &lcore_busyness[lcore_id];
+	now = rte_rdtsc();
+	if (unlikely(lb->last_tsc <= busyness_enable_tsc)) {
+		if (busyness_period == 0)
+			busyness_period = rte_get_tsc_hz() / MS_PER_S *
+				RTE_LCORE_BUSYNESS_PERIOD_MS;
+		lb->period_start = now;
+		lb->period_busy = 0;
+		lb->percent = -1;
+	} else {
+		cycles = now - lb->last_tsc;
+		if (lb->busy) {
+			lb->stats.busy_cycles += cycles;
+			lb->period_busy += cycles;
+		} else
+			lb->stats.idle_cycles += cycles;
+	}
+
+	if (now - lb->period_start >= busyness_period) {
+		lb->percent = lb->period_busy * 100 / (now - lb->period_start);
+		lb->period_start = now;
+		lb->period_busy = 0;
+	}
+
+	lb->busy = nb_work != 0;
+	lb->stats.polls++;
+	lb->stats.busy_polls += lb->busy;
+	lb->last_tsc = now;
+}
+
+void
+rte_lcore_busyness_enable(int enable)
+{
+	if (enable && !busyness_enabled)
+		busyness_enable_tsc = rte_rdtsc();
+	busyness_enabled = enable != 0;
+}
+
+int
+rte_lcore_busyness(unsigned int lcore_id)
+{
+	const struct lcore_busyness *lb;
+
+	if (rte_eal_lcore_role(lcore_id) == ROLE_OFF)
+		return -EINVAL;
+	if (!busyness_enabled)
+		return -ENOTSUP;
+
+	lb = &lcore_busyness[lcore_id];
+	if (lb->last_tsc <= busyness_enable_tsc || lb->percent < 0 ||
+			rte_rdtsc() - lb->last_tsc > 2 * busyness_period)
+		return -ENODATA;
+
+	return lb->percent;
+}
+
+int
+rte_lcore_busyness_stats_get(unsigned int lcore_id,
+		struct rte_lcore_busyness_stats *stats)
+{
+	if (rte_eal_lcore_role(lcore_id) == ROLE_OFF || stats == NULL)
+		return -EINVAL;
+
+	*stats = lcore_busyness[lcore_id].stats;
+
+	return 0;
+}
@@ -2,7 +2,9 @@
  * Copyright(c) 2019 Intel Corporation
  */
 
+#include <rte_eal.h>
 #include <rte_eal_memconfig.h>
+#include <rte_log.h>
 #include <rte_version.h>
 
 #include "eal_internal_cfg.h"
@@ -60,10 +62,74 @@ eal_mcfg_update_from_internal(void)
 
 	mcfg->legacy_mem = internal_config.legacy_mem;
 	mcfg->single_file_segments = internal_config.single_file_segments;
+	mcfg->warm_restart = internal_config.warm_restart;
+	mcfg->code_addr = (uintptr_t)rte_eal_init;
 	/* record current DPDK version */
 	mcfg->version = RTE_VERSION;
 }
 
+int
+eal_mcfg_check_warm_restart(const struct rte_mem_config *mcfg)
+{
+	unsigned int i;
+
+	/* the previous process may have stopped in the middle of its init */
+	if (mcfg->magic != RTE_MAGIC) {
+		RTE_LOG(INFO, EAL, "Previous memory config is incomplete\n");
+		return -1;
+	}
+	if (mcfg->version != RTE_VERSION) {
+		RTE_LOG(INFO, EAL, "Previous memory config is from another DPDK version\n");
+		return -1;
+	}
+	if (!mcfg->warm_restart) {
+		RTE_LOG(INFO, EAL, "Previous memory config was not kept for a warm restart\n");
+		return -1;
+	}
+	if (mcfg->legacy_mem || mcfg->single_file_segments !=
+			internal_config.single_file_segments) {
+		RTE_LOG(INFO, EAL, "Previous memory config used other memory options\n");
+		return -1;
+	}
+	for (i = 0; i < RTE_MAX_MEMSEG_LISTS; i++) {
+		if (mcfg->memsegs[i].external &&
+				mcfg->memsegs[i].base_va != NULL) {
+			RTE_LOG(INFO, EAL, "Previous memory config has external memory\n");
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+void
+eal_mcfg_warm_restart(void)
+{
+	struct rte_mem_config *mcfg = rte_eal_get_configuration()->mem_config;
+	unsigned int i;
+
+	/* secondary processes wait for the init to complete again */
+	mcfg->magic = 0;
+
+	/* the previous process may have died holding any of the locks */
+	rte_rwlock_init(&mcfg->mlock);
+	rte_rwlock_init(&mcfg->qlock);
+	rte_rwlock_init(&mcfg->mplock);
+	rte_spinlock_init(&mcfg->tlock);
+	rte_rwlock_init(&mcfg->memory_hotplug_lock);
+	rte_rwlock_init(&mcfg->memzones.rwlock);
+	for (i = 0; i < RTE_MAX_MEMSEG_LISTS; i++)
+		rte_rwlock_init(&mcfg->memsegs[i].memseg_arr.rwlock);
+	for (i = 0; i < RTE_MAX_HEAPS; i++)
+		rte_spinlock_init(&mcfg->malloc_heaps[i].lock);
+
+	/* objects holding function pointers, such as hash tables, are only
+	 * usable if the code is mapped at the same address as before
+	 */
+	if (mcfg->code_addr != (uintptr_t)rte_eal_init)
+		RTE_LOG(WARNING, EAL, "EAL code moved since the previous run, restored objects holding function pointers cannot be used\n");
+}
+
 void
 rte_mcfg_mem_read_lock(void)
 {
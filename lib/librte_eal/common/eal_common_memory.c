@@ -888,11 +888,34 @@ rte_extmem_detach(void *va_addr, size_t len)
 	return sync_memory(va_addr, len, false);
 }
 
+struct rte_eal_init_stats eal_init_stats;
+
+int
+rte_eal_init_stats_get(struct rte_eal_init_stats *stats)
+{
+	if (stats == NULL)
+		return -EINVAL;
+
+	*stats = eal_init_stats;
+	return 0;
+}
+
+static int
+count_seg(const struct rte_memseg_list *msl __rte_unused,
+		const struct rte_memseg *ms __rte_unused, void *arg)
+{
+	uint64_t *n_segs = arg;
+
+	(*n_segs)++;
+	return 0;
+}
+
 /* init memory subsystem */
 int
 rte_eal_memory_init(void)
 {
 	struct rte_mem_config *mcfg = rte_eal_get_configuration()->mem_config;
+	uint64_t start = eal_get_time_us();
 	int retval;
 	RTE_LOG(DEBUG, EAL, "Setting up physically contiguous memory...\n");
 
@@ -917,6 +940,12 @@ rte_eal_memory_init(void)
 	if (internal_config.no_shconf == 0 && rte_eal_memdevice_init() < 0)
 		goto fail;
 
+	rte_memseg_walk_thread_unsafe(count_seg, &eal_init_stats.mem_init_pages);
+	eal_init_stats.mem_init_time_us = eal_get_time_us() - start;
+	RTE_LOG(DEBUG, EAL, "Mapped %" PRIu64 " pages in %" PRIu64 " us\n",
+		eal_init_stats.mem_init_pages,
+		eal_init_stats.mem_init_time_us);
+
 	return 0;
 fail:
 	rte_mcfg_mem_read_unlock();
@@ -22,6 +22,7 @@
 
 #include "malloc_heap.h"
 #include "malloc_elem.h"
+#include "eal_internal_cfg.h"
 #include "eal_private.h"
 #include "eal_memcfg.h"
 
@@ -374,12 +375,15 @@ rte_eal_memzone_init(void)
 
 	rte_rwlock_write_lock(&mcfg->mlock);
 
+	/* after a warm restart, the memzones of the previous run are kept */
 	if (rte_eal_process_type() == RTE_PROC_PRIMARY &&
+			!internal_config.warm_restarted &&
 			rte_fbarray_init(&mcfg->memzones, "memzone",
 			RTE_MAX_MEMZONE, sizeof(struct rte_memzone))) {
 		RTE_LOG(ERR, EAL, "Cannot allocate memzone list\n");
 		ret = -1;
-	} else if (rte_eal_process_type() == RTE_PROC_SECONDARY &&
+	} else if ((rte_eal_process_type() == RTE_PROC_SECONDARY ||
+			internal_config.warm_restarted) &&
 			rte_fbarray_attach(&mcfg->memzones)) {
 		RTE_LOG(ERR, EAL, "Cannot attach to memzone list\n");
 		ret = -1;
@@ -86,6 +86,8 @@ eal_long_options[] = {
 	{OPT_LEGACY_MEM,        0, NULL, OPT_LEGACY_MEM_NUM       },
 	{OPT_SINGLE_FILE_SEGMENTS, 0, NULL, OPT_SINGLE_FILE_SEGMENTS_NUM},
 	{OPT_MATCH_ALLOCATIONS, 0, NULL, OPT_MATCH_ALLOCATIONS_NUM},
+	{OPT_HUGE_INIT_THREADS, 1, NULL, OPT_HUGE_INIT_THREADS_NUM},
+	{OPT_WARM_RESTART,      0, NULL, OPT_WARM_RESTART_NUM     },
 	{0,                     0, NULL, 0                        }
 };
 
@@ -208,6 +210,10 @@ eal_reset_internal_config(struct internal_config *internal_cfg)
 		internal_cfg->hugepage_info[i].lock_descriptor = -1;
 	}
 	internal_cfg->base_virtaddr = 0;
+	internal_cfg->warm_restart = 0;
+	internal_cfg->warm_restarted = 0;
+	/* number of threads mapping hugepages at init is automatic */
+	internal_cfg->huge_init_threads = 0;
 
 #ifdef LOG_DAEMON
 	internal_cfg->syslog_facility = LOG_DAEMON;
@@ -1638,6 +1644,16 @@ eal_check_common_options(struct internal_config *internal_cfg)
 				"with --"OPT_MATCH_ALLOCATIONS"\n");
 		return -1;
 	}
+	if (internal_cfg->warm_restart && (internal_cfg->no_hugetlbfs ||
+			internal_cfg->legacy_mem ||
+			internal_cfg->hugepage_unlink ||
+			internal_cfg->no_shconf)) {
+		RTE_LOG(ERR, EAL, "Option --"OPT_WARM_RESTART" is not compatible "
+				"with --"OPT_NO_HUGE", --"OPT_LEGACY_MEM", --"
+				OPT_HUGE_UNLINK", --"OPT_IN_MEMORY" and --"
+				OPT_NO_SHCONF"\n");
+		return -1;
+	}
 	if (internal_cfg->legacy_mem && internal_cfg->memory == 0) {
 		RTE_LOG(NOTICE, EAL, "Static memory layout is selected, "
 			"amount of reserved memory can be adjusted with "
@@ -23,6 +23,7 @@
 #include <rte_debug.h>
 
 #include "eal_private.h"
+#include "eal_internal_cfg.h"
 #include "eal_memcfg.h"
 
 TAILQ_HEAD(rte_tailq_elem_head, rte_tailq_elem);
@@ -109,8 +110,12 @@ static void
 rte_eal_tailq_update(struct rte_tailq_elem *t)
 {
 	if (rte_eal_process_type() == RTE_PROC_PRIMARY) {
+		/* a warm restarted primary finds the lists it had created */
+		t->head = internal_config.warm_restarted ?
+				rte_eal_tailq_lookup(t->name) : NULL;
 		/* primary process is the only one that creates */
-		t->head = rte_eal_tailq_create(t->name);
+		if (t->head == NULL)
+			t->head = rte_eal_tailq_create(t->name);
 	} else {
 		t->head = rte_eal_tailq_lookup(t->name);
 	}
@@ -151,6 +156,17 @@ rte_eal_tailqs_init(void)
 
 	rte_tailqs_count = 0;
 
+	/* keep the lists created by the previous primary process */
+	if (internal_config.warm_restarted) {
+		struct rte_mem_config *mcfg =
+			rte_eal_get_configuration()->mem_config;
+		struct rte_tailq_head *head = mcfg->tailq_head;
+
+		while (rte_tailqs_count < RTE_MAX_TAILQ &&
+				head[rte_tailqs_count].name[0] != '\0')
+			rte_tailqs_count++;
+	}
+
 	TAILQ_FOREACH(t, &rte_tailq_elem_head, next) {
 		/* second part of register job for "early" tailqs, see
 		 * rte_eal_tailq_register and EAL_REGISTER_TAILQ */
@@ -26,6 +26,16 @@ static uint64_t eal_tsc_resolution_hz;
 /* Pointer to user delay function */
 void (*rte_delay_us)(unsigned int) = NULL;
 
+uint64_t
+eal_get_time_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * US_PER_S +
+			ts.tv_nsec / (NS_PER_S / US_PER_S);
+}
+
 void
 rte_delay_us_block(unsigned int us)
 {
@@ -69,6 +69,14 @@ struct internal_config {
 	/**< true if storing all pages within single files (per-page-size,
 	 * per-node) non-legacy mode only.
 	 */
+	volatile unsigned int warm_restart;
+	/**< true to keep the memory for the next primary process */
+	volatile unsigned int warm_restarted;
+	/**< true if the memory of the previous primary process was restored */
+	volatile unsigned int huge_init_threads;
+	/**< number of threads mapping the hugepages of a socket at init,
+	 * 0 to use the CPUs of the socket.
+	 */
 	volatile int syslog_facility;	  /**< facility passed to openlog() */
 	/** default interrupt mode for VFIO */
 	volatile enum rte_intr_mode vfio_intr_mode;
@@ -28,6 +28,24 @@ int
 eal_memalloc_alloc_seg_bulk(struct rte_memseg **ms, int n_segs, size_t page_sz,
 		int socket, bool exact);
 
+/*
+ * Allocate up to `n_segs` segments at init, best effort.
+ *
+ * Same as eal_memalloc_alloc_seg_bulk(), except that the pages may be mapped
+ * and faulted in by several threads running on the CPUs of `socket`, as set
+ * by the --huge-init-threads option.
+ */
+int
+eal_memalloc_prealloc_seg_bulk(struct rte_memseg **ms, int n_segs,
+		size_t page_sz, int socket);
+
+/*
+ * Map again, at the same addresses, the segments used by the previous primary
+ * process, after a warm restart.
+ */
+int
+eal_memalloc_restore(void);
+
 /*
  * Deallocate segment
  */
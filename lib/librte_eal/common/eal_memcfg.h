@@ -73,6 +73,11 @@ struct rte_mem_config {
 	/**< TSC rate */
 
 	uint8_t dma_maskbits; /**< Keeps the more restricted dma mask. */
+
+	uint32_t warm_restart;
+	/**< memory kept for the next primary process, see --warm-restart. */
+	uint64_t code_addr;
+	/**< address of the EAL code, to detect function pointers moving. */
 };
 
 /* update internal config from shared mem config */
@@ -95,4 +100,12 @@ eal_mcfg_check_version(void);
 void
 eal_mcfg_complete(void);
 
+/* check if a mem config left by a previous primary process can be reused */
+int
+eal_mcfg_check_warm_restart(const struct rte_mem_config *mcfg);
+
+/* prepare the mem config of a previous primary process for reuse */
+void
+eal_mcfg_warm_restart(void);
+
 #endif /* EAL_MEMCFG_H */
@@ -69,6 +69,10 @@ enum {
 	OPT_IOVA_MODE_NUM,
 #define OPT_MATCH_ALLOCATIONS  "match-allocations"
 	OPT_MATCH_ALLOCATIONS_NUM,
+#define OPT_HUGE_INIT_THREADS  "huge-init-threads"
+	OPT_HUGE_INIT_THREADS_NUM,
+#define OPT_WARM_RESTART       "warm-restart"
+	OPT_WARM_RESTART_NUM,
 	OPT_LONG_MAX_NUM
 };
 
@@ -126,6 +126,18 @@ int rte_eal_memseg_init(void);
  */
 int rte_eal_memory_init(void);
 
+/**
+ * Statistics of the EAL initialization, see rte_eal_init_stats_get().
+ */
+extern struct rte_eal_init_stats eal_init_stats;
+
+/**
+ * Get a monotonic time in microseconds, usable before the timer init.
+ *
+ * This function is private to EAL.
+ */
+uint64_t eal_get_time_us(void);
+
 /**
  * Configure timers
  *
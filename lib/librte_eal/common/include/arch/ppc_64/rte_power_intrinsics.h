@@ -0,0 +1,43 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#ifndef _RTE_POWER_INTRINSIC_PPC64_H_
+#define _RTE_POWER_INTRINSIC_PPC64_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <errno.h>
+
+#include <rte_common.h>
+
+#include "generic/rte_power_intrinsics.h"
+
+/* This architecture has no equivalent of these instructions */
+__rte_experimental
+static inline int
+rte_power_monitor(const struct rte_power_monitor_cond *pmc,
+		uint64_t tsc_timestamp)
+{
+	RTE_SET_USED(pmc);
+	RTE_SET_USED(tsc_timestamp);
+
+	return -ENOTSUP;
+}
+
+__rte_experimental
+static inline int
+rte_power_pause(uint64_t tsc_timestamp)
+{
+	RTE_SET_USED(tsc_timestamp);
+
+	return -ENOTSUP;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_POWER_INTRINSIC_PPC64_H_ */
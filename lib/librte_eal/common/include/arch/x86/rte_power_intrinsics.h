@@ -0,0 +1,96 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#ifndef _RTE_POWER_INTRINSIC_X86_H_
+#define _RTE_POWER_INTRINSIC_X86_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <errno.h>
+
+#include <rte_common.h>
+
+#include "generic/rte_power_intrinsics.h"
+
+static inline uint64_t
+__rte_power_get_umwait_val(const volatile void *p, const uint8_t sz)
+{
+	switch (sz) {
+	case sizeof(uint8_t):
+		return *(const volatile uint8_t *)p;
+	case sizeof(uint16_t):
+		return *(const volatile uint16_t *)p;
+	case sizeof(uint32_t):
+		return *(const volatile uint32_t *)p;
+	case sizeof(uint64_t):
+		return *(const volatile uint64_t *)p;
+	default:
+		/* the size was checked by the caller */
+		return 0;
+	}
+}
+
+/*
+ * The instructions are emitted as bytes, as not all assemblers know
+ * them. The state requested is C0.2, the deepest one, which the operating
+ * system may restrict to C0.1.
+ */
+__rte_experimental
+static inline int
+rte_power_monitor(const struct rte_power_monitor_cond *pmc,
+		uint64_t tsc_timestamp)
+{
+	const uint32_t tsc_l = (uint32_t)tsc_timestamp;
+	const uint32_t tsc_h = (uint32_t)(tsc_timestamp >> 32);
+
+	if (pmc == NULL || pmc->addr == NULL ||
+			(pmc->size != sizeof(uint8_t) &&
+			 pmc->size != sizeof(uint16_t) &&
+			 pmc->size != sizeof(uint32_t) &&
+			 pmc->size != sizeof(uint64_t)))
+		return -EINVAL;
+
+	/* umonitor %rdi */
+	asm volatile(".byte 0xf3, 0x0f, 0xae, 0xf7;"
+			:
+			: "D"(pmc->addr));
+
+	/* the event may have happened before the monitor was armed */
+	if (pmc->mask != 0 &&
+			(__rte_power_get_umwait_val(pmc->addr, pmc->size) &
+			 pmc->mask) == pmc->val)
+		return 0;
+
+	/* umwait %edi */
+	asm volatile(".byte 0xf2, 0x0f, 0xae, 0xf7;"
+			: /* ignore rflags */
+			: "D"(0), /* enter C0.2 */
+			  "a"(tsc_l), "d"(tsc_h));
+
+	return 0;
+}
+
+__rte_experimental
+static inline int
+rte_power_pause(uint64_t tsc_timestamp)
+{
+	const uint32_t tsc_l = (uint32_t)tsc_timestamp;
+	const uint32_t tsc_h = (uint32_t)(tsc_timestamp >> 32);
+
+	/* tpause %edi */
+	asm volatile(".byte 0x66, 0x0f, 0xae, 0xf7;"
+			: /* ignore rflags */
+			: "D"(0), /* enter C0.2 */
+			  "a"(tsc_l), "d"(tsc_h));
+
+	return 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_POWER_INTRINSIC_X86_H_ */
@@ -0,0 +1,83 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#ifndef _RTE_POWER_INTRINSIC_H_
+#define _RTE_POWER_INTRINSIC_H_
+
+#include <inttypes.h>
+
+#include <rte_compat.h>
+
+/**
+ * @file
+ * Advanced power management operations.
+ *
+ * This file defines APIs for advanced power management,
+ * which are architecture-dependent.
+ */
+
+/**
+ * Condition to wait for in rte_power_monitor().
+ */
+struct rte_power_monitor_cond {
+	volatile void *addr;  /**< Address to monitor for changes */
+	uint64_t val;         /**< If the value at *addr*, masked by *mask*,
+			       *   is equal to this, the event has already
+			       *   happened and the wait is not started.
+			       */
+	uint64_t mask;        /**< Mask applied to the value at *addr*,
+			       *   0 to skip the check.
+			       */
+	uint8_t size;         /**< Size of the value at *addr* in bytes,
+			       *   1, 2, 4 or 8.
+			       */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Monitor a memory address for changes, entering a light power-optimized
+ * state until the address is written to, the TSC reaches *tsc_timestamp*
+ * or an interrupt occurs. The operating system may also cap the wait.
+ *
+ * On x86, this uses the UMONITOR and UMWAIT instructions, and the caller
+ * must check that RTE_CPUFLAG_WAITPKG is set before calling it.
+ *
+ * @param pmc
+ *   The address to monitor and the condition telling that the event it
+ *   signals has already happened.
+ * @param tsc_timestamp
+ *   Maximum TSC value until which to wait.
+ *
+ * @return
+ *   0 on wake up or if the condition was already met,
+ *   -EINVAL if the condition is invalid,
+ *   -ENOTSUP if not supported on this architecture.
+ */
+__rte_experimental
+static inline int rte_power_monitor(const struct rte_power_monitor_cond *pmc,
+		uint64_t tsc_timestamp);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Enter a light power-optimized state until the TSC reaches
+ * *tsc_timestamp* or an interrupt occurs.
+ *
+ * On x86, this uses the TPAUSE instruction, and the caller must check
+ * that RTE_CPUFLAG_WAITPKG is set before calling it.
+ *
+ * @param tsc_timestamp
+ *   Maximum TSC value until which to wait.
+ *
+ * @return
+ *   0 on wake up,
+ *   -ENOTSUP if not supported on this architecture.
+ */
+__rte_experimental
+static inline int rte_power_pause(uint64_t tsc_timestamp);
+
+#endif /* _RTE_POWER_INTRINSIC_H_ */
@@ -143,6 +143,36 @@ int rte_eal_init(int argc, char **argv);
  */
 int rte_eal_cleanup(void);
 
+/**
+ * Statistics of the EAL initialization.
+ */
+struct rte_eal_init_stats {
+	uint64_t init_time_us; /**< Time spent in rte_eal_init() */
+	uint64_t mem_init_time_us; /**< Time spent mapping the memory */
+	uint64_t mem_init_pages; /**< Memory pages mapped at init */
+	uint64_t mem_init_threads;
+	/**< Maximum number of threads mapping the pages of a socket */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Get statistics of the EAL initialization, such as the time spent
+ * mapping and clearing the hugepages reserved at startup.
+ *
+ * The total initialization time is only set once rte_eal_init() has
+ * returned.
+ *
+ * @param stats
+ *   A structure filled with the statistics.
+ * @return
+ *   - 0 on success.
+ *   - -EINVAL if stats is NULL.
+ */
+__rte_experimental
+int rte_eal_init_stats_get(struct rte_eal_init_stats *stats);
+
 /**
  * Check if a primary process is currently alive
  *
@@ -412,6 +442,23 @@ rte_set_application_usage_hook(rte_usage_hook_t usage_func);
  */
 int rte_eal_has_hugepages(void);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Whether the memory of the previous primary process was restored by the
+ * --warm-restart option.
+ *
+ * After a warm restart, the memzones, rings, mempools and other objects
+ * created by the previous run are still there, at the same addresses, and
+ * are retrieved with their lookup functions instead of being created again.
+ *
+ * @return
+ *   Nonzero if the memory of the previous run was restored.
+ */
+__rte_experimental
+int rte_eal_warm_restarted(void);
+
 /**
  * Whether EAL is using PCI bus.
  * Disabled by --no-pci option.
@@ -281,6 +281,107 @@ rte_ctrl_thread_create(pthread_t *thread, const char *name,
 int
 rte_lcore_has_role(unsigned int lcore_id, enum rte_lcore_role_t role);
 
+/**
+ * Busyness statistics of an lcore.
+ *
+ * The time between two reports of an lcore is busy when the first report
+ * found work, idle otherwise.
+ */
+struct rte_lcore_busyness_stats {
+	uint64_t busy_cycles; /**< TSC cycles after a report of work */
+	uint64_t idle_cycles; /**< TSC cycles after a report of no work */
+	uint64_t polls;       /**< Number of reports */
+	uint64_t busy_polls;  /**< Number of reports of work */
+};
+
+/**
+ * Period in milliseconds over which rte_lcore_busyness() is computed.
+ */
+#define RTE_LCORE_BUSYNESS_PERIOD_MS 100
+
+/**
+ * Report the work found by a poll of the calling lcore, from a fast path.
+ *
+ * It is called by rte_eth_rx_burst() and rte_event_dequeue_burst() when DPDK
+ * is built with RTE_LCORE_BUSYNESS, and does nothing otherwise, or when the
+ * application does not allow the experimental API. The service cores always
+ * report their runs.
+ */
+#if defined(RTE_LCORE_BUSYNESS) && defined(ALLOW_EXPERIMENTAL_API)
+#define RTE_LCORE_BUSYNESS_UPDATE(nb_work) rte_lcore_busyness_update(nb_work)
+#else
+#define RTE_LCORE_BUSYNESS_UPDATE(nb_work) RTE_SET_USED(nb_work)
+#endif
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Report the work found by a poll of the calling lcore.
+ *
+ * The time until the next report of the lcore is accounted as busy if
+ * nb_work is not 0, idle otherwise. It does nothing on non-EAL threads,
+ * and when the busyness accounting is disabled.
+ *
+ * @param nb_work
+ *   The number of packets, events or work items found by the poll.
+ */
+__rte_experimental
+void
+rte_lcore_busyness_update(uint16_t nb_work);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enable or disable the busyness accounting of all the lcores.
+ * It is enabled by default.
+ *
+ * @param enable
+ *   0 to disable the accounting, any other value to enable it.
+ */
+__rte_experimental
+void
+rte_lcore_busyness_enable(int enable);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the busyness of an lcore over the last period.
+ *
+ * @param lcore_id
+ *   The identifier of the lcore.
+ * @return
+ *   - The percentage of busy cycles over the last complete period of
+ *     RTE_LCORE_BUSYNESS_PERIOD_MS.
+ *   - -EINVAL if the lcore has no role.
+ *   - -ENOTSUP if the busyness accounting is disabled.
+ *   - -ENODATA if the lcore did not report for two periods.
+ */
+__rte_experimental
+int
+rte_lcore_busyness(unsigned int lcore_id);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the busyness statistics of an lcore, accumulated while the
+ * accounting is enabled.
+ *
+ * @param lcore_id
+ *   The identifier of the lcore.
+ * @param stats
+ *   The statistics to fill.
+ * @return
+ *   0 on success, -EINVAL if the lcore has no role or stats is NULL.
+ */
+__rte_experimental
+int
+rte_lcore_busyness_stats_get(unsigned int lcore_id,
+		struct rte_lcore_busyness_stats *stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -523,6 +523,71 @@ __rte_experimental
 void
 rte_malloc_dump_heaps(FILE *f);
 
+/** Maximum number of elements held by a per-lcore cache for one size class. */
+#define RTE_MALLOC_CACHE_MAX_SIZE 64
+
+/** Largest allocation served by the per-lcore caches, in bytes. */
+#define RTE_MALLOC_CACHE_MAX_ELEM_SIZE 4096
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Enable the per-lcore malloc caches.
+ *
+ * Once enabled, each EAL lcore keeps, for each power-of-two size class up
+ * to RTE_MALLOC_CACHE_MAX_ELEM_SIZE bytes, a small cache of elements of its
+ * local heap. Allocations on the local socket (or SOCKET_ID_ANY) with an
+ * alignment of at most a cache line, and frees of elements of the local
+ * heap, are served by the cache without taking the heap lock. A cache is
+ * refilled from and flushed to the heap by half of its size at once.
+ *
+ * The cached elements are counted as allocated in the heap statistics, and
+ * the memory holding them cannot be returned to the system until they are
+ * flushed. Allocations from non-EAL threads are not cached.
+ *
+ * This function may be called again to change the cache size.
+ *
+ * @param size
+ *   Number of elements kept per lcore and size class, between 1 and
+ *   RTE_MALLOC_CACHE_MAX_SIZE.
+ * @return
+ *   - 0 on success
+ *   - -1 in case of error, with rte_errno set to EINVAL if *size* is out
+ *     of range
+ */
+__rte_experimental
+int
+rte_malloc_cache_enable(unsigned int size);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Disable the per-lcore malloc caches and return their elements to the
+ * heaps.
+ *
+ * @note This function is not thread-safe with respect to allocations and
+ *    frees on other lcores, it must be called when no other lcore uses
+ *    the rte_malloc API.
+ */
+__rte_experimental
+void
+rte_malloc_cache_disable(void);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Return the elements held by the cache of the calling lcore to the heap.
+ *
+ * It may be called by an lcore which stops allocating memory for a while,
+ * so that this memory can be used by others.
+ */
+__rte_experimental
+void
+rte_malloc_cache_flush(void);
+
 /**
  * Set the maximum amount of allocated memory for this type.
  *
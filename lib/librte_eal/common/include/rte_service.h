@@ -32,6 +32,7 @@ extern "C" {
 #include <sys/queue.h>
 
 #include <rte_config.h>
+#include <rte_compat.h>
 #include <rte_lcore.h>
 
 #define RTE_SERVICE_NAME_MAX 32
@@ -410,6 +411,41 @@ rte_service_lcore_attr_get(uint32_t lcore, uint32_t attr_id,
 int32_t
 rte_service_lcore_attr_reset_all(uint32_t lcore);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Migrate a service from the most loaded running service core to the least
+ * loaded one.
+ *
+ * The load of a service core is the number of cycles its services spent in
+ * calls which did not return -EAGAIN, since the previous call of this
+ * function. Only the services with statistics enabled are accounted, see
+ * *rte_service_set_stats_enable*, and only those mapped to a single service
+ * core are migrated. The service migrated is the one which balances the
+ * load of the two cores best.
+ *
+ * A service which is not MT safe is unmapped from its service core, which
+ * is then waited for to complete its current loop, before the service is
+ * mapped to the other core: it is never run by both cores at once.
+ *
+ * The application calls this function periodically, for instance every
+ * 100 ms from the master lcore, to adapt the mapping of the services to the
+ * load. It must not be called concurrently with other functions changing
+ * the mapping of services to service cores.
+ *
+ * @param threshold Minimum difference of load between the two service
+ *   cores, in percent of the time elapsed since the previous call, for a
+ *   service to be migrated.
+ * @retval 1 A service has been migrated.
+ * @retval 0 No service has been migrated, or this is the first call.
+ * @retval -EINVAL The threshold is greater than 100.
+ * @retval -ENOTSUP Less than two service cores are running.
+ */
+__rte_experimental
+int32_t
+rte_service_lcore_rebalance(uint32_t threshold);
+
 #ifdef __cplusplus
 }
 #endif
@@ -14,6 +14,9 @@
 
 /**
  * Signature of callback function to run a service.
+ *
+ * The callback returns -EAGAIN when it found no work to do, so that the
+ * busyness of the lcore running it is accounted as idle.
  */
 typedef int32_t (*rte_service_func)(void *args);
 
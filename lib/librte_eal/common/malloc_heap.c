@@ -732,6 +732,52 @@ malloc_heap_alloc(const char *type, size_t size, int socket_arg,
 	return NULL;
 }
 
+/*
+ * Allocate up to n elements of the same size from the free memory of a heap,
+ * taking its lock only once. The heap is not expanded.
+ */
+unsigned int
+malloc_heap_alloc_bulk(struct malloc_heap *heap, size_t size, void **objs,
+		unsigned int n)
+{
+	unsigned int i;
+
+	rte_spinlock_lock(&(heap->lock));
+
+	for (i = 0; i < n; i++) {
+		objs[i] = heap_alloc(heap, NULL, size, 0, RTE_CACHE_LINE_SIZE,
+				0, false);
+		if (objs[i] == NULL)
+			break;
+	}
+
+	rte_spinlock_unlock(&(heap->lock));
+
+	return i;
+}
+
+/*
+ * Free n elements of a heap, taking its lock only once. The memory stays in
+ * the heap, even where the freed elements coalesce into whole pages.
+ */
+void
+malloc_heap_free_bulk(struct malloc_heap *heap, void * const *objs,
+		unsigned int n)
+{
+	struct malloc_elem *elem;
+	unsigned int i;
+
+	rte_spinlock_lock(&(heap->lock));
+
+	for (i = 0; i < n; i++) {
+		elem = malloc_elem_from_data(objs[i]);
+		elem->state = ELEM_FREE;
+		malloc_elem_free(elem);
+	}
+
+	rte_spinlock_unlock(&(heap->lock));
+}
+
 static void *
 heap_alloc_biggest_on_heap_id(const char *type, unsigned int heap_id,
 		unsigned int flags, size_t align, bool contig)
@@ -1315,6 +1361,84 @@ malloc_heap_destroy(struct malloc_heap *heap)
 	return 0;
 }
 
+/* check that the element list of a heap left by a previous primary is sane */
+static int
+malloc_heap_check(struct malloc_heap *heap)
+{
+	struct rte_mem_config *mcfg = rte_eal_get_configuration()->mem_config;
+	struct malloc_elem *elem, *prev = NULL;
+	struct rte_memseg_list *msl;
+	int idx;
+
+	for (elem = heap->first; elem != NULL; elem = elem->next) {
+		if (elem->heap != heap || elem->prev != prev ||
+				(prev != NULL && (uintptr_t)elem <=
+					(uintptr_t)prev))
+			return -1;
+		if (elem->state != ELEM_FREE && elem->state != ELEM_BUSY &&
+				elem->state != ELEM_CACHED)
+			return -1;
+
+		/* the header must be in a page mapped again */
+		msl = elem->msl;
+		if (msl < &mcfg->memsegs[0] ||
+				msl >= &mcfg->memsegs[RTE_MAX_MEMSEG_LISTS] ||
+				RTE_PTR_DIFF(elem, msl->base_va) >= msl->len)
+			return -1;
+		idx = RTE_PTR_DIFF(elem, msl->base_va) / msl->page_sz;
+		if (!rte_fbarray_is_used(&msl->memseg_arr, idx))
+			return -1;
+
+		prev = elem;
+	}
+	if (heap->last != prev)
+		return -1;
+
+	return 0;
+}
+
+/*
+ * Take over the heaps of the previous primary process on a warm restart.
+ * Elements which were held by the per-lcore caches of that process have
+ * no owner anymore and are given back.
+ */
+static int
+malloc_heap_restore(void)
+{
+	struct rte_mem_config *mcfg = rte_eal_get_configuration()->mem_config;
+	struct malloc_heap *heap;
+	struct malloc_elem *elem;
+	unsigned int i, n;
+
+	for (i = 0; i < RTE_MAX_HEAPS; i++) {
+		heap = &mcfg->malloc_heaps[i];
+		if (malloc_heap_check(heap) < 0) {
+			RTE_LOG(ERR, EAL, "Heap %s of the previous primary process is corrupt\n",
+				heap->name);
+			return -1;
+		}
+
+		n = 0;
+		elem = heap->first;
+		while (elem != NULL) {
+			if (elem->state != ELEM_CACHED) {
+				elem = elem->next;
+				continue;
+			}
+			elem->state = ELEM_BUSY;
+			malloc_heap_free(elem);
+			n++;
+			/* the list may have changed, start over */
+			elem = heap->first;
+		}
+		if (n != 0)
+			RTE_LOG(DEBUG, EAL, "Released %u cached elements of heap %s\n",
+				n, heap->name);
+	}
+
+	return 0;
+}
+
 int
 rte_eal_malloc_heap_init(void)
 {
@@ -1325,7 +1449,8 @@ rte_eal_malloc_heap_init(void)
 		RTE_LOG(DEBUG, EAL, "Hugepages will be freed exactly as allocated.\n");
 	}
 
-	if (rte_eal_process_type() == RTE_PROC_PRIMARY) {
+	if (rte_eal_process_type() == RTE_PROC_PRIMARY &&
+			!internal_config.warm_restarted) {
 		/* assign min socket ID to external heaps */
 		mcfg->next_socket_id = EXTERNAL_HEAP_MIN_SOCKET_ID;
 
@@ -1359,6 +1484,10 @@ rte_eal_malloc_heap_init(void)
 	if (rte_eal_process_type() != RTE_PROC_PRIMARY)
 		return 0;
 
+	/* the heaps of a warm restart already hold all the memory */
+	if (internal_config.warm_restarted)
+		return malloc_heap_restore();
+
 	/* add all IOVA-contiguous areas to the heap */
 	return rte_memseg_contig_walk(malloc_add_seg, NULL);
 }
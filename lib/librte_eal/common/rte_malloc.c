@@ -28,12 +28,180 @@
 #include "eal_memcfg.h"
 #include "eal_private.h"
 
+/*
+ * Per-lcore caches of small elements, in front of the heaps. Each EAL
+ * lcore keeps busy elements of its local heap in one stack per power-of-2
+ * size class, from RTE_CACHE_LINE_SIZE to RTE_MALLOC_CACHE_MAX_ELEM_SIZE.
+ * A cached element holds poisoned memory, as a free one does, so that
+ * zmalloc does not need to clear it.
+ */
+#define MALLOC_CACHE_NB_CLASSES 7
+
+struct malloc_lcore_cache {
+	struct malloc_heap *heap; /**< Heap of the lcore socket. */
+	unsigned int len[MALLOC_CACHE_NB_CLASSES];
+	void *objs[MALLOC_CACHE_NB_CLASSES][RTE_MALLOC_CACHE_MAX_SIZE];
+} __rte_cache_aligned;
+
+static struct malloc_lcore_cache malloc_caches[RTE_MAX_LCORE];
+
+/* Elements per lcore and class, 0 if the caches are disabled */
+static unsigned int malloc_cache_size;
+
+static struct malloc_lcore_cache *
+malloc_cache_get_lcore(void)
+{
+	struct rte_mem_config *mcfg = rte_eal_get_configuration()->mem_config;
+	unsigned int lcore_id = rte_lcore_id();
+	struct malloc_lcore_cache *c;
+	int heap_id;
+
+	if (lcore_id >= RTE_MAX_LCORE)
+		return NULL;
+
+	c = &malloc_caches[lcore_id];
+	if (unlikely(c->heap == NULL)) {
+		heap_id = malloc_socket_to_heap_id(malloc_get_numa_socket());
+		if (heap_id < 0)
+			return NULL;
+		c->heap = &mcfg->malloc_heaps[heap_id];
+	}
+
+	return c;
+}
+
+/* Give back the n oldest elements of a class to the heap */
+static void
+malloc_cache_flush_class(struct malloc_lcore_cache *c, unsigned int cls,
+		unsigned int n)
+{
+	if (n == 0)
+		return;
+
+	malloc_heap_free_bulk(c->heap, c->objs[cls], n);
+
+	c->len[cls] -= n;
+	memmove(&c->objs[cls][0], &c->objs[cls][n],
+			c->len[cls] * sizeof(c->objs[cls][0]));
+}
+
+static void
+malloc_cache_flush_lcore(struct malloc_lcore_cache *c)
+{
+	unsigned int cls;
+
+	for (cls = 0; cls < MALLOC_CACHE_NB_CLASSES; cls++)
+		malloc_cache_flush_class(c, cls, c->len[cls]);
+}
+
+static void *
+malloc_cache_get(size_t size, int socket_arg)
+{
+	struct malloc_lcore_cache *c = malloc_cache_get_lcore();
+	unsigned int cls, n, i;
+	void *ptr;
+
+	/* Only serve the socket of the heap the cache was filled from */
+	if (c == NULL || (socket_arg != SOCKET_ID_ANY &&
+			socket_arg != (int)c->heap->socket_id))
+		return NULL;
+
+	cls = size <= RTE_CACHE_LINE_SIZE ? 0 :
+		rte_log2_u32(size) - rte_log2_u32(RTE_CACHE_LINE_SIZE);
+
+	if (c->len[cls] == 0) {
+		n = RTE_MAX(malloc_cache_size / 2, 1U);
+		n = malloc_heap_alloc_bulk(c->heap, RTE_CACHE_LINE_SIZE << cls,
+				c->objs[cls], n);
+		if (n == 0)
+			return NULL;
+		for (i = 0; i < n; i++)
+			malloc_elem_from_data(c->objs[cls][i])->state =
+				ELEM_CACHED;
+		c->len[cls] = n;
+	}
+
+	ptr = c->objs[cls][--c->len[cls]];
+	malloc_elem_from_data(ptr)->state = ELEM_BUSY;
+
+	return ptr;
+}
+
+static int
+malloc_cache_put(struct malloc_elem *elem)
+{
+	struct malloc_lcore_cache *c = malloc_cache_get_lcore();
+	unsigned int cls;
+	size_t data_len;
+	void *ptr;
+
+	if (c == NULL || elem == NULL || elem->heap != c->heap ||
+			elem->state != ELEM_BUSY || elem->pad != 0)
+		return -1;
+
+	data_len = elem->size - MALLOC_ELEM_OVERHEAD;
+	if (data_len < RTE_CACHE_LINE_SIZE ||
+			data_len >= 2 * RTE_MALLOC_CACHE_MAX_ELEM_SIZE)
+		return -1;
+
+	/* biggest class the element can hold */
+	cls = rte_fls_u32(data_len) - 1 - rte_log2_u32(RTE_CACHE_LINE_SIZE);
+
+	if (c->len[cls] >= malloc_cache_size)
+		malloc_cache_flush_class(c, cls,
+				c->len[cls] - malloc_cache_size / 2);
+
+	ptr = RTE_PTR_ADD(elem, MALLOC_ELEM_HEADER_LEN);
+	memset(ptr, MALLOC_POISON, data_len);
+	elem->state = ELEM_CACHED;
+	c->objs[cls][c->len[cls]++] = ptr;
+
+	return 0;
+}
+
+int
+rte_malloc_cache_enable(unsigned int size)
+{
+	if (size == 0 || size > RTE_MALLOC_CACHE_MAX_SIZE) {
+		rte_errno = EINVAL;
+		return -1;
+	}
+
+	malloc_cache_size = size;
+
+	return 0;
+}
+
+void
+rte_malloc_cache_disable(void)
+{
+	unsigned int lcore_id;
+
+	malloc_cache_size = 0;
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+		malloc_cache_flush_lcore(&malloc_caches[lcore_id]);
+}
+
+void
+rte_malloc_cache_flush(void)
+{
+	struct malloc_lcore_cache *c = malloc_cache_get_lcore();
+
+	if (c != NULL)
+		malloc_cache_flush_lcore(c);
+}
 
 /* Free the memory space back to heap */
 void rte_free(void *addr)
 {
+	struct malloc_elem *elem;
+
 	if (addr == NULL) return;
-	if (malloc_heap_free(malloc_elem_from_data(addr)) < 0)
+	elem = malloc_elem_from_data(addr);
+	if (malloc_cache_size != 0 && malloc_cache_put(elem) == 0)
+		return;
+	if (malloc_heap_free(elem) < 0)
 		RTE_LOG(ERR, EAL, "Error: Invalid memory\n");
 }
 
@@ -57,6 +225,14 @@ rte_malloc_socket(const char *type, size_t size, unsigned int align,
 				!rte_eal_has_hugepages())
 		socket_arg = SOCKET_ID_ANY;
 
+	if (malloc_cache_size != 0 && size <= RTE_MALLOC_CACHE_MAX_ELEM_SIZE &&
+			align <= RTE_CACHE_LINE_SIZE) {
+		void *ptr = malloc_cache_get(size, socket_arg);
+
+		if (ptr != NULL)
+			return ptr;
+	}
+
 	return malloc_heap_alloc(type, size, socket_arg, 0,
 			align == 0 ? 1 : align, 0, false);
 }
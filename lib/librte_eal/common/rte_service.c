@@ -20,6 +20,7 @@
 #include <rte_atomic.h>
 #include <rte_memory.h>
 #include <rte_malloc.h>
+#include <rte_pause.h>
 
 #include "eal_private.h"
 
@@ -64,12 +65,17 @@ struct core_state {
 	uint8_t service_active_on_lcore[RTE_SERVICE_NUM_MAX];
 	uint64_t loops;
 	uint64_t calls_per_service[RTE_SERVICE_NUM_MAX];
+	/* cycles of the calls which found work, used to rebalance */
+	uint64_t busy_cycles_per_service[RTE_SERVICE_NUM_MAX];
+	uint64_t rebalance_cycles[RTE_SERVICE_NUM_MAX];
 } __rte_cache_aligned;
 
 static uint32_t rte_service_count;
 static struct rte_service_spec_impl *rte_services;
 static struct core_state *lcore_states;
 static uint32_t rte_service_library_initialized;
+/* TSC of the previous rebalance, 0 before the first one */
+static uint64_t rebalance_tsc;
 
 int32_t
 rte_service_init(void)
@@ -337,16 +343,22 @@ rte_service_runner_do_callback(struct rte_service_spec_impl *s,
 			       struct core_state *cs, uint32_t service_idx)
 {
 	void *userdata = s->spec.callback_userdata;
+	int32_t ret;
 
 	if (service_stats_enabled(s)) {
 		uint64_t start = rte_rdtsc();
-		s->spec.callback(userdata);
+		ret = s->spec.callback(userdata);
 		uint64_t end = rte_rdtsc();
 		s->cycles_spent += end - start;
+		if (ret != -EAGAIN)
+			cs->busy_cycles_per_service[service_idx] += end - start;
 		cs->calls_per_service[service_idx]++;
 		s->calls++;
 	} else
-		s->spec.callback(userdata);
+		ret = s->spec.callback(userdata);
+
+	/* not a per packet path, always accounted */
+	rte_lcore_busyness_update(ret != -EAGAIN);
 }
 
 
@@ -641,6 +653,7 @@ rte_service_lcore_reset_all(void)
 	}
 	for (i = 0; i < RTE_SERVICE_NUM_MAX; i++)
 		rte_atomic32_set(&rte_services[i].num_mapped_cores, 0);
+	rebalance_tsc = 0;
 
 	rte_smp_wmb();
 
@@ -781,6 +794,140 @@ rte_service_lcore_attr_get(uint32_t lcore, uint32_t attr_id,
 	}
 }
 
+/* Move a service mapped to a single service core to another one. */
+static void
+service_migrate(uint32_t id, uint32_t from, uint32_t to)
+{
+	struct rte_service_spec_impl *s = &rte_services[id];
+	struct core_state *cs = &lcore_states[from];
+	uint32_t on = 1;
+	uint32_t off = 0;
+	uint64_t loops;
+
+	if (service_mt_safe(s)) {
+		service_update(&s->spec, to, &on, 0);
+		service_update(&s->spec, from, &off, 0);
+		return;
+	}
+
+	/* the service must not run on both cores: unmap it first, then wait
+	 * for the old core to complete the loop which may still run it.
+	 */
+	service_update(&s->spec, from, &off, 0);
+	rte_smp_mb();
+	loops = cs->loops;
+	while (cs->loops == loops && lcore_config[from].state == RUNNING) {
+		rte_pause();
+		rte_smp_rmb();
+	}
+
+	service_update(&s->spec, to, &on, 0);
+}
+
+/* Busy cycles of a service on a service core since the last rebalance. */
+static inline uint64_t
+service_rebalance_cycles(struct core_state *cs, uint32_t id)
+{
+	return cs->busy_cycles_per_service[id] - cs->rebalance_cycles[id];
+}
+
+/* Pick the service of the max core leaving the smallest load gap with the
+ * min core once migrated, or return -1 if none reduces the gap.
+ */
+static int32_t
+service_rebalance_pick(uint32_t max_lcore, uint64_t max_load,
+		uint64_t min_load)
+{
+	struct core_state *cs = &lcore_states[max_lcore];
+	uint64_t best_gap = max_load - min_load;
+	uint64_t cycles, gap;
+	int32_t best = -1;
+	uint32_t i;
+
+	for (i = 0; i < RTE_SERVICE_NUM_MAX; i++) {
+		struct rte_service_spec_impl *s = &rte_services[i];
+
+		if (!service_valid(i) || !service_stats_enabled(s) ||
+				!(cs->service_mask & (UINT64_C(1) << i)) ||
+				rte_atomic32_read(&s->num_mapped_cores) != 1)
+			continue;
+
+		cycles = service_rebalance_cycles(cs, i);
+		if (cycles == 0 || cycles >= max_load - min_load)
+			continue;
+
+		gap = RTE_MAX(max_load - cycles, min_load + cycles) -
+			RTE_MIN(max_load - cycles, min_load + cycles);
+		if (gap < best_gap) {
+			best_gap = gap;
+			best = i;
+		}
+	}
+
+	return best;
+}
+
+int32_t
+rte_service_lcore_rebalance(uint32_t threshold)
+{
+	uint64_t load[RTE_MAX_LCORE];
+	uint64_t now = rte_rdtsc();
+	uint64_t elapsed = now - rebalance_tsc;
+	uint32_t lcore_count = 0;
+	uint32_t max_lcore = 0;
+	uint32_t min_lcore = 0;
+	int32_t id = -1;
+	uint32_t i, j;
+
+	if (threshold > 100)
+		return -EINVAL;
+
+	for (i = 0; i < RTE_MAX_LCORE; i++) {
+		struct core_state *cs = &lcore_states[i];
+
+		if (!cs->is_service_core || cs->runstate != RUNSTATE_RUNNING)
+			continue;
+
+		load[i] = 0;
+		for (j = 0; j < RTE_SERVICE_NUM_MAX; j++)
+			if (cs->service_mask & (UINT64_C(1) << j))
+				load[i] += service_rebalance_cycles(cs, j);
+
+		if (lcore_count == 0 || load[i] > load[max_lcore])
+			max_lcore = i;
+		if (lcore_count == 0 || load[i] < load[min_lcore])
+			min_lcore = i;
+		lcore_count++;
+	}
+
+	if (lcore_count < 2)
+		return -ENOTSUP;
+
+	/* the first call only starts the accounting */
+	if (rebalance_tsc != 0 && (load[max_lcore] - load[min_lcore]) * 100 >
+			elapsed * threshold)
+		id = service_rebalance_pick(max_lcore, load[max_lcore],
+				load[min_lcore]);
+
+	/* start a new period on all the service cores */
+	for (i = 0; i < RTE_MAX_LCORE; i++) {
+		struct core_state *cs = &lcore_states[i];
+
+		if (cs->is_service_core)
+			memcpy(cs->rebalance_cycles,
+				cs->busy_cycles_per_service,
+				sizeof(cs->rebalance_cycles));
+	}
+	rebalance_tsc = now;
+
+	if (id < 0)
+		return 0;
+
+	service_migrate(id, max_lcore, min_lcore);
+
+	return 1;
+}
+
 static void
 rte_service_dump_one(FILE *f, struct rte_service_spec_impl *s,
 		     uint64_t all_cycles, uint32_t reset)
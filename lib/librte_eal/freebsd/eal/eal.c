@@ -706,6 +706,7 @@ rte_eal_init(int argc, char **argv)
 	static rte_atomic32_t run_once = RTE_ATOMIC32_INIT(0);
 	char cpuset[RTE_CPU_AFFINITY_STR_LEN];
 	char thread_name[RTE_MAX_THREAD_NAME_LEN];
+	uint64_t start = eal_get_time_us();
 
 	/* checks if the machine is adequate */
 	if (!rte_cpu_is_supported()) {
@@ -958,6 +959,8 @@ rte_eal_init(int argc, char **argv)
 	/* Call each registered callback, if enabled */
 	rte_option_init();
 
+	eal_init_stats.init_time_us = eal_get_time_us() - start;
+
 	return fctret;
 }
 
@@ -976,6 +979,11 @@ rte_eal_process_type(void)
 	return rte_config.process_type;
 }
 
+int rte_eal_warm_restarted(void)
+{
+	return internal_config.warm_restarted;
+}
+
 int rte_eal_has_pci(void)
 {
 	return !internal_config.no_pci;
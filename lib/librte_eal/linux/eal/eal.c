@@ -298,6 +298,53 @@ eal_parse_sysfs_value(const char *filename, unsigned long *val)
 }
 
 
+/* map the shared config left by a previous primary process, at the same
+ * address, if it can be reused for a warm restart
+ */
+static int
+rte_eal_config_restore(size_t cfg_len)
+{
+	size_t page_sz = sysconf(_SC_PAGE_SIZE);
+	size_t cfg_len_aligned = RTE_ALIGN(cfg_len, page_sz);
+	struct rte_mem_config *mem_config;
+	void *rte_mem_cfg_addr;
+	struct stat st;
+
+	/* a new file has no content yet */
+	if (fstat(mem_cfg_fd, &st) < 0 || (size_t)st.st_size != cfg_len)
+		return -1;
+
+	mem_config = mmap(NULL, cfg_len, PROT_READ, MAP_SHARED, mem_cfg_fd, 0);
+	if (mem_config == MAP_FAILED)
+		return -1;
+
+	if (eal_mcfg_check_warm_restart(mem_config) < 0) {
+		munmap(mem_config, cfg_len);
+		return -1;
+	}
+	rte_mem_cfg_addr = (void *)(uintptr_t)mem_config->mem_cfg_addr;
+	munmap(mem_config, cfg_len);
+
+	if (eal_get_virtual_area(rte_mem_cfg_addr, &cfg_len_aligned, page_sz,
+			0, 0) == NULL) {
+		RTE_LOG(INFO, EAL, "Cannot map previous memory config at [%p]\n",
+			rte_mem_cfg_addr);
+		return -1;
+	}
+
+	mem_config = mmap(rte_mem_cfg_addr, cfg_len_aligned,
+			PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED,
+			mem_cfg_fd, 0);
+	if (mem_config == MAP_FAILED) {
+		munmap(rte_mem_cfg_addr, cfg_len_aligned);
+		return -1;
+	}
+
+	rte_config.mem_config = mem_config;
+
+	return 0;
+}
+
 /* create memory configuration in shared/mmap memory. Take out
  * a write lock on the memsegs, so we can auto-detect primary/secondary.
  * This means we never close the file while running (auto-close on exit).
@@ -318,11 +365,17 @@ rte_eal_config_create(void)
 	if (internal_config.no_shconf)
 		return 0;
 
-	/* map the config before hugepage address so that we don't waste a page */
+	/* map the config before hugepage address so that we don't waste a page,
+	 * the config of a warm restart is mapped at a stable address.
+	 */
 	if (internal_config.base_virtaddr != 0)
 		rte_mem_cfg_addr = (void *)
 			RTE_ALIGN_FLOOR(internal_config.base_virtaddr -
 			sizeof(struct rte_mem_config), page_sz);
+	else if (internal_config.warm_restart)
+		rte_mem_cfg_addr = (void *)
+			RTE_ALIGN_FLOOR(eal_get_baseaddr() -
+			sizeof(struct rte_mem_config), page_sz);
 	else
 		rte_mem_cfg_addr = NULL;
 
@@ -335,21 +388,31 @@ rte_eal_config_create(void)
 		}
 	}
 
-	retval = ftruncate(mem_cfg_fd, cfg_len);
+	retval = fcntl(mem_cfg_fd, F_SETLK, &wr_lock);
 	if (retval < 0){
 		close(mem_cfg_fd);
 		mem_cfg_fd = -1;
-		RTE_LOG(ERR, EAL, "Cannot resize '%s' for rte_mem_config\n",
-			pathname);
+		RTE_LOG(ERR, EAL, "Cannot create lock on '%s'. Is another primary "
+			"process running?\n", pathname);
 		return -1;
 	}
 
-	retval = fcntl(mem_cfg_fd, F_SETLK, &wr_lock);
+	if (internal_config.warm_restart &&
+			rte_eal_config_restore(cfg_len) == 0) {
+		RTE_LOG(INFO, EAL, "Restoring memory of the previous primary process\n");
+		internal_config.warm_restarted = 1;
+		return 0;
+	}
+
+	/* resized only once a warm restart is ruled out, the restore
+	 * checks the size left by the previous primary process
+	 */
+	retval = ftruncate(mem_cfg_fd, cfg_len);
 	if (retval < 0){
 		close(mem_cfg_fd);
 		mem_cfg_fd = -1;
-		RTE_LOG(ERR, EAL, "Cannot create lock on '%s'. Is another primary "
-			"process running?\n", pathname);
+		RTE_LOG(ERR, EAL, "Cannot resize '%s' for rte_mem_config\n",
+			pathname);
 		return -1;
 	}
 
@@ -501,6 +564,8 @@ rte_config_init(void)
 	case RTE_PROC_PRIMARY:
 		if (rte_eal_config_create() < 0)
 			return -1;
+		if (internal_config.warm_restarted)
+			eal_mcfg_warm_restart();
 		eal_mcfg_update_from_internal();
 		break;
 	case RTE_PROC_SECONDARY:
@@ -560,6 +625,8 @@ eal_usage(const char *prgname)
 	       "  --"OPT_LEGACY_MEM"        Legacy memory mode (no dynamic allocation, contiguous segments)\n"
 	       "  --"OPT_SINGLE_FILE_SEGMENTS" Put all hugepage memory in single files\n"
 	       "  --"OPT_MATCH_ALLOCATIONS" Free hugepages exactly as allocated\n"
+	       "  --"OPT_HUGE_INIT_THREADS" Threads mapping hugepages of a socket at init (0: auto)\n"
+	       "  --"OPT_WARM_RESTART"      Keep memory across restarts of the primary process\n"
 	       "\n");
 	/* Allow the application to print its usage message too if hook is set */
 	if ( rte_application_usage_hook ) {
@@ -648,6 +715,22 @@ eal_parse_vfio_intr(const char *mode)
 	return -1;
 }
 
+static int
+eal_parse_huge_init_threads(const char *arg)
+{
+	unsigned long threads;
+	char *end;
+
+	errno = 0;
+	threads = strtoul(arg, &end, 10);
+	if (errno != 0 || arg[0] == '\0' || *end != '\0' ||
+			threads > RTE_MAX_LCORE)
+		return -1;
+
+	internal_config.huge_init_threads = threads;
+	return 0;
+}
+
 /* Parse the arguments for --log-level only */
 static void
 eal_log_level_parse(int argc, char **argv)
@@ -818,6 +901,20 @@ eal_parse_args(int argc, char **argv)
 			internal_config.match_allocations = 1;
 			break;
 
+		case OPT_WARM_RESTART_NUM:
+			internal_config.warm_restart = 1;
+			break;
+
+		case OPT_HUGE_INIT_THREADS_NUM:
+			if (eal_parse_huge_init_threads(optarg) < 0) {
+				RTE_LOG(ERR, EAL, "invalid parameters for --"
+						OPT_HUGE_INIT_THREADS "\n");
+				eal_usage(prgname);
+				ret = -1;
+				goto out;
+			}
+			break;
+
 		default:
 			if (opt < OPT_LONG_MIN_NUM && isprint(opt)) {
 				RTE_LOG(ERR, EAL, "Option %c is not supported "
@@ -968,6 +1065,7 @@ rte_eal_init(int argc, char **argv)
 	char cpuset[RTE_CPU_AFFINITY_STR_LEN];
 	char thread_name[RTE_MAX_THREAD_NAME_LEN];
 	bool phys_addrs;
+	uint64_t start = eal_get_time_us();
 
 	/* checks if the machine is adequate */
 	if (!rte_cpu_is_supported()) {
@@ -1297,6 +1395,8 @@ rte_eal_init(int argc, char **argv)
 	/* Call each registered callback, if enabled */
 	rte_option_init();
 
+	eal_init_stats.init_time_us = eal_get_time_us() - start;
+
 	return fctret;
 }
 
@@ -1342,6 +1442,11 @@ int rte_eal_has_hugepages(void)
 	return ! internal_config.no_hugetlbfs;
 }
 
+int rte_eal_warm_restarted(void)
+{
+	return internal_config.warm_restarted;
+}
+
 int rte_eal_has_pci(void)
 {
 	return !internal_config.no_pci;
@@ -272,6 +272,7 @@ clear_hugedir(const char * hugedir)
 	struct dirent *dirent;
 	int dir_fd, fd, lck_result;
 	const char filter[] = "*map_*"; /* matches hugepage files */
+	char own_filter[PATH_MAX]; /* matches our files, kept on warm restart */
 
 	/* open directory */
 	dir = opendir(hugedir);
@@ -282,6 +283,9 @@ clear_hugedir(const char * hugedir)
 	}
 	dir_fd = dirfd(dir);
 
+	snprintf(own_filter, sizeof(own_filter), "%smap_*",
+			eal_get_hugefile_prefix());
+
 	dirent = readdir(dir);
 	if (!dirent) {
 		RTE_LOG(ERR, EAL, "Unable to read hugepage directory %s\n",
@@ -296,6 +300,13 @@ clear_hugedir(const char * hugedir)
 			continue;
 		}
 
+		/* the pages of the previous primary process are reused */
+		if (internal_config.warm_restarted &&
+				fnmatch(own_filter, dirent->d_name, 0) == 0) {
+			dirent = readdir(dir);
+			continue;
+		}
+
 		/* try and lock the file */
 		fd = openat(dir_fd, dirent->d_name, O_RDONLY);
 
@@ -18,6 +18,7 @@
 #include <unistd.h>
 #include <limits.h>
 #include <fcntl.h>
+#include <pthread.h>
 #include <sys/ioctl.h>
 #include <sys/time.h>
 #include <signal.h>
@@ -38,6 +39,7 @@
 #include <rte_eal.h>
 #include <rte_errno.h>
 #include <rte_memory.h>
+#include <rte_per_lcore.h>
 #include <rte_spinlock.h>
 
 #include "eal_filesystem.h"
@@ -45,6 +47,7 @@
 #include "eal_memalloc.h"
 #include "eal_memcfg.h"
 #include "eal_private.h"
+#include "eal_thread.h"
 
 const int anonymous_hugepages_supported =
 #ifdef MAP_HUGE_SHIFT
@@ -105,11 +108,12 @@ static struct {
 /** local copy of a memory map, used to synchronize memory hotplug in MP */
 static struct rte_memseg_list local_memsegs[RTE_MAX_MEMSEG_LISTS];
 
-static sigjmp_buf huge_jmpenv;
+/* pages may be allocated by several threads at init, see alloc_segs() */
+static RTE_DEFINE_PER_LCORE(sigjmp_buf, huge_jmpenv);
 
 static void __rte_unused huge_sigbus_handler(int signo __rte_unused)
 {
-	siglongjmp(huge_jmpenv, 1);
+	siglongjmp(RTE_PER_LCORE(huge_jmpenv), 1);
 }
 
 /* Put setjmp into a wrap method to avoid compiling error. Any non-volatile,
@@ -118,7 +122,7 @@ static void __rte_unused huge_sigbus_handler(int signo __rte_unused)
  */
 static int __rte_unused huge_wrap_sigsetjmp(void)
 {
-	return sigsetjmp(huge_jmpenv, 1);
+	return sigsetjmp(RTE_PER_LCORE(huge_jmpenv), 1);
 }
 
 static struct sigaction huge_action_old;
@@ -675,10 +679,15 @@ free_seg(struct rte_memseg *ms, struct hugepage_info *hi,
 	uint64_t map_offset;
 	char path[PATH_MAX];
 	int fd, ret = 0;
-	bool exit_early;
+	bool exit_early, anonymous;
 
-	/* erase page data */
-	memset(ms->addr, 0, ms->len);
+	anonymous = internal_config.in_memory && !memfd_create_supported;
+
+	/* erase page data, unless the page goes back to the kernel on unmap
+	 * and will be cleared by it if it is ever faulted in again.
+	 */
+	if (!anonymous)
+		memset(ms->addr, 0, ms->len);
 
 	if (mmap(ms->addr, ms->len, PROT_READ,
 			MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) ==
@@ -690,7 +699,7 @@ free_seg(struct rte_memseg *ms, struct hugepage_info *hi,
 	exit_early = false;
 
 	/* if we're using anonymous hugepages, nothing to be done */
-	if (internal_config.in_memory && !memfd_create_supported)
+	if (anonymous)
 		exit_early = true;
 
 	/* if we've already unlinked the page, nothing needs to be done */
@@ -741,12 +750,168 @@ free_seg(struct rte_memseg *ms, struct hugepage_info *hi,
 	return ret < 0 ? -1 : 0;
 }
 
+/* Threads used by default to map the pages of a socket at init */
+#define ALLOC_THREADS_AUTO_MAX 8U
+/* Minimum number of pages mapped by each of these threads */
+#define ALLOC_THREAD_MIN_SEGS 2
+
+/* A run of pages of a memseg list, mapped by one thread */
+struct alloc_seg_job {
+	pthread_t thread;
+	bool started;
+	struct rte_memseg_list *msl;
+	struct hugepage_info *hi;
+	unsigned int msl_idx;
+	int socket;
+	int start_idx;
+	unsigned int n_segs;
+	unsigned int segs_allocated;
+};
+
+static void *
+alloc_seg_job_run(void *arg)
+{
+	struct alloc_seg_job *job = arg;
+	struct rte_memseg_list *msl = job->msl;
+	unsigned int i;
+	int idx;
+
+	for (i = 0; i < job->n_segs; i++) {
+		idx = job->start_idx + i;
+		if (alloc_seg(rte_fbarray_get(&msl->memseg_arr, idx),
+				RTE_PTR_ADD(msl->base_va, idx * msl->page_sz),
+				job->socket, job->hi, job->msl_idx, idx))
+			break;
+	}
+	job->segs_allocated = i;
+
+	return NULL;
+}
+
+/* Get the CPUs of a socket, return their number */
+static unsigned int
+socket_cpuset(int socket, rte_cpuset_t *cpuset)
+{
+	unsigned int cpu, n = 0;
+
+	CPU_ZERO(cpuset);
+	for (cpu = 0; cpu < RTE_MAX_LCORE; cpu++) {
+		if (eal_cpu_detected(cpu) &&
+				eal_cpu_socket_id(cpu) == (unsigned int)socket) {
+			CPU_SET(cpu, cpuset);
+			n++;
+		}
+	}
+
+	return n;
+}
+
+/*
+ * Allocate the pages [start_idx, start_idx + n_segs) of a memseg list.
+ *
+ * Most of the time spent allocating a page is the kernel clearing it when
+ * it is faulted in, so with n_threads other than 1 the pages are split in
+ * runs mapped in parallel by threads running on the CPUs of the socket,
+ * up to n_threads of them, or up to one per CPU if n_threads is 0.
+ *
+ * Return the number of pages allocated from start_idx. The pages
+ * allocated past the first failure are freed.
+ */
+static unsigned int
+alloc_segs(struct rte_memseg_list *msl, unsigned int msl_idx,
+		struct hugepage_info *hi, int socket, int start_idx,
+		unsigned int n_segs, unsigned int n_threads)
+{
+	struct alloc_seg_job job, *jobs = &job;
+	unsigned int i, j, n_jobs, n_cpus = 0, done;
+	rte_cpuset_t cpuset;
+	pthread_attr_t attr;
+	bool hole;
+	int idx;
+
+	/* the reference count of single files is not thread safe */
+	n_jobs = 1;
+	if (n_threads != 1 && !internal_config.single_file_segments) {
+		n_cpus = socket_cpuset(socket, &cpuset);
+		if (n_threads == 0)
+			n_threads = RTE_MIN(RTE_MAX(n_cpus, 1U),
+					ALLOC_THREADS_AUTO_MAX);
+		n_jobs = RTE_MIN(n_threads, n_segs / ALLOC_THREAD_MIN_SEGS);
+	}
+	if (n_jobs > 1) {
+		jobs = calloc(n_jobs, sizeof(*jobs));
+		if (jobs == NULL) {
+			jobs = &job;
+			n_jobs = 1;
+		}
+	}
+
+	if (n_jobs > 1 && pthread_attr_init(&attr) != 0)
+		n_jobs = 1;
+	if (n_jobs > 1 && n_cpus > 0)
+		pthread_attr_setaffinity_np(&attr, sizeof(cpuset), &cpuset);
+
+	for (i = 0, idx = start_idx; i < n_jobs; i++) {
+		jobs[i].started = false;
+		jobs[i].msl = msl;
+		jobs[i].hi = hi;
+		jobs[i].msl_idx = msl_idx;
+		jobs[i].socket = socket;
+		jobs[i].start_idx = idx;
+		jobs[i].n_segs = n_segs / n_jobs + (i < n_segs % n_jobs);
+		jobs[i].segs_allocated = 0;
+		idx += jobs[i].n_segs;
+
+		if (n_jobs > 1)
+			jobs[i].started = pthread_create(&jobs[i].thread,
+					&attr, alloc_seg_job_run,
+					&jobs[i]) == 0;
+	}
+
+	/* the jobs whose thread could not be started are run here */
+	for (i = 0; i < n_jobs; i++) {
+		if (jobs[i].started)
+			pthread_join(jobs[i].thread, NULL);
+		else
+			alloc_seg_job_run(&jobs[i]);
+	}
+	if (n_jobs > 1)
+		pthread_attr_destroy(&attr);
+
+	/* keep the pages allocated up to the first failure */
+	done = 0;
+	hole = false;
+	for (i = 0; i < n_jobs; i++) {
+		if (!hole) {
+			done += jobs[i].segs_allocated;
+			hole = jobs[i].segs_allocated < jobs[i].n_segs;
+			continue;
+		}
+		for (j = 0; j < jobs[i].segs_allocated; j++) {
+			idx = jobs[i].start_idx + j;
+			if (free_seg(rte_fbarray_get(&msl->memseg_arr, idx),
+					hi, msl_idx, idx))
+				RTE_LOG(DEBUG, EAL, "Cannot free page\n");
+		}
+	}
+
+	if (!internal_config.init_complete)
+		eal_init_stats.mem_init_threads = RTE_MAX(
+				eal_init_stats.mem_init_threads, n_jobs);
+
+	if (jobs != &job)
+		free(jobs);
+
+	return done;
+}
+
 struct alloc_walk_param {
 	struct hugepage_info *hi;
 	struct rte_memseg **ms;
 	size_t page_sz;
 	unsigned int segs_allocated;
 	unsigned int n_segs;
+	unsigned int n_threads;
 	int socket;
 	bool exact;
 };
@@ -756,17 +921,14 @@ alloc_seg_walk(const struct rte_memseg_list *msl, void *arg)
 	struct rte_mem_config *mcfg = rte_eal_get_configuration()->mem_config;
 	struct alloc_walk_param *wa = arg;
 	struct rte_memseg_list *cur_msl;
-	size_t page_sz;
 	int cur_idx, start_idx, j, dir_fd = -1;
-	unsigned int msl_idx, need, i;
+	unsigned int msl_idx, need, i, n;
 
 	if (msl->page_sz != wa->page_sz)
 		return 0;
 	if (msl->socket_id != wa->socket)
 		return 0;
 
-	page_sz = (size_t)msl->page_sz;
-
 	msl_idx = msl - mcfg->memsegs;
 	cur_msl = &mcfg->memsegs[msl_idx];
 
@@ -824,31 +986,18 @@ alloc_seg_walk(const struct rte_memseg_list *msl, void *arg)
 		}
 	}
 
-	for (i = 0; i < need; i++, cur_idx++) {
-		struct rte_memseg *cur;
-		void *map_addr;
-
-		cur = rte_fbarray_get(&cur_msl->memseg_arr, cur_idx);
-		map_addr = RTE_PTR_ADD(cur_msl->base_va,
-				cur_idx * page_sz);
+	n = alloc_segs(cur_msl, msl_idx, wa->hi, wa->socket, start_idx, need,
+			wa->n_threads);
+	if (n < need) {
+		RTE_LOG(DEBUG, EAL, "attempted to allocate %i segments, but only %i were allocated\n",
+			need, n);
 
-		if (alloc_seg(cur, map_addr, wa->socket, wa->hi,
-				msl_idx, cur_idx)) {
-			RTE_LOG(DEBUG, EAL, "attempted to allocate %i segments, but only %i were allocated\n",
-				need, i);
-
-			/* if exact number wasn't requested, stop */
-			if (!wa->exact)
-				goto out;
-
-			/* clean up */
-			for (j = start_idx; j < cur_idx; j++) {
+		/* if exact number was requested, clean up */
+		if (wa->exact) {
+			for (j = start_idx; j < start_idx + (int)n; j++) {
 				struct rte_memseg *tmp;
-				struct rte_fbarray *arr =
-						&cur_msl->memseg_arr;
 
-				tmp = rte_fbarray_get(arr, j);
-				rte_fbarray_set_free(arr, j);
+				tmp = rte_fbarray_get(&cur_msl->memseg_arr, j);
 
 				/* free_seg may attempt to create a file, which
 				 * may fail.
@@ -864,12 +1013,16 @@ alloc_seg_walk(const struct rte_memseg_list *msl, void *arg)
 				close(dir_fd);
 			return -1;
 		}
+	}
+
+	for (i = 0; i < n; i++, cur_idx++) {
 		if (wa->ms)
-			wa->ms[i] = cur;
+			wa->ms[i] = rte_fbarray_get(&cur_msl->memseg_arr,
+					cur_idx);
 
 		rte_fbarray_set_used(&cur_msl->memseg_arr, cur_idx);
 	}
-out:
+
 	wa->segs_allocated = i;
 	if (i > 0)
 		cur_msl->version++;
@@ -944,9 +1097,9 @@ free_seg_walk(const struct rte_memseg_list *msl, void *arg)
 	return 1;
 }
 
-int
-eal_memalloc_alloc_seg_bulk(struct rte_memseg **ms, int n_segs, size_t page_sz,
-		int socket, bool exact)
+static int
+alloc_seg_bulk(struct rte_memseg **ms, int n_segs, size_t page_sz,
+		int socket, bool exact, unsigned int n_threads)
 {
 	int i, ret = -1;
 #ifdef RTE_EAL_NUMA_AWARE_HUGEPAGES
@@ -991,6 +1144,7 @@ eal_memalloc_alloc_seg_bulk(struct rte_memseg **ms, int n_segs, size_t page_sz,
 	wa.page_sz = page_sz;
 	wa.socket = socket;
 	wa.segs_allocated = 0;
+	wa.n_threads = n_threads;
 
 	/* memalloc is locked, so it's safe to use thread-unsafe version */
 	ret = rte_memseg_list_walk_thread_unsafe(alloc_seg_walk, &wa);
@@ -1009,6 +1163,21 @@ eal_memalloc_alloc_seg_bulk(struct rte_memseg **ms, int n_segs, size_t page_sz,
 	return ret;
 }
 
+int
+eal_memalloc_alloc_seg_bulk(struct rte_memseg **ms, int n_segs, size_t page_sz,
+		int socket, bool exact)
+{
+	return alloc_seg_bulk(ms, n_segs, page_sz, socket, exact, 1);
+}
+
+int
+eal_memalloc_prealloc_seg_bulk(struct rte_memseg **ms, int n_segs,
+		size_t page_sz, int socket)
+{
+	return alloc_seg_bulk(ms, n_segs, page_sz, socket, false,
+			internal_config.huge_init_threads);
+}
+
 struct rte_memseg *
 eal_memalloc_alloc_seg(size_t page_sz, int socket)
 {
@@ -1357,6 +1526,75 @@ eal_memalloc_sync_with_primary(void)
 	return 0;
 }
 
+static int
+restore_walk(const struct rte_memseg_list *msl, void *arg __rte_unused)
+{
+	struct rte_mem_config *mcfg = rte_eal_get_configuration()->mem_config;
+	struct rte_memseg_list *cur_msl;
+	struct hugepage_info *hi = NULL;
+	struct rte_memseg *ms;
+	char path[PATH_MAX];
+	unsigned int i, msl_idx;
+	uint32_t flags;
+	int seg_idx;
+
+	if (msl->external)
+		return 0;
+
+	msl_idx = msl - mcfg->memsegs;
+	cur_msl = &mcfg->memsegs[msl_idx];
+
+	for (i = 0; i < RTE_DIM(internal_config.hugepage_info); i++) {
+		if (msl->page_sz ==
+				internal_config.hugepage_info[i].hugepage_sz) {
+			hi = &internal_config.hugepage_info[i];
+			break;
+		}
+	}
+	if (!hi) {
+		RTE_LOG(ERR, EAL, "Can't find relevant hugepage_info entry\n");
+		return -1;
+	}
+
+	seg_idx = rte_fbarray_find_next_used(&cur_msl->memseg_arr, 0);
+	while (seg_idx >= 0) {
+		ms = rte_fbarray_get(&cur_msl->memseg_arr, seg_idx);
+
+		/* the page must be the one of the previous run, not a new one */
+		eal_get_hugefile_path(path, sizeof(path), hi->hugedir,
+				internal_config.single_file_segments ? msl_idx :
+				msl_idx * RTE_MAX_MEMSEG_PER_LIST + seg_idx);
+		if (access(path, F_OK) < 0) {
+			RTE_LOG(ERR, EAL, "%s(): hugepage file %s is gone\n",
+				__func__, path);
+			return -1;
+		}
+
+		flags = ms->flags;
+		if (alloc_seg(ms, RTE_PTR_ADD(cur_msl->base_va,
+				(size_t)seg_idx * cur_msl->page_sz),
+				cur_msl->socket_id, hi, msl_idx, seg_idx)) {
+			RTE_LOG(ERR, EAL, "%s(): cannot map again segment %i of list %u\n",
+				__func__, seg_idx, msl_idx);
+			return -1;
+		}
+		ms->flags = flags;
+
+		seg_idx = rte_fbarray_find_next_used(&cur_msl->memseg_arr,
+				seg_idx + 1);
+	}
+	return 0;
+}
+
+int
+eal_memalloc_restore(void)
+{
+	/* memory is locked, so it's safe to call thread-unsafe version */
+	if (rte_memseg_list_walk_thread_unsafe(restore_walk, NULL))
+		return -1;
+	return 0;
+}
+
 static int
 secondary_msl_create_walk(const struct rte_memseg_list *msl,
 		void *arg __rte_unused)
@@ -1804,9 +1804,9 @@ eal_hugepage_init(void)
 				pages = malloc(sizeof(*pages) * needed);
 
 				/* do not request exact number of pages */
-				cur_pages = eal_memalloc_alloc_seg_bulk(pages,
+				cur_pages = eal_memalloc_prealloc_seg_bulk(pages,
 						needed, hpi->hugepage_sz,
-						socket_id, false);
+						socket_id);
 				if (cur_pages <= 0) {
 					free(pages);
 					return -1;
@@ -1994,6 +1994,8 @@ eal_hugepage_attach(void)
 int
 rte_eal_hugepage_init(void)
 {
+	if (internal_config.warm_restarted)
+		return eal_memalloc_restore();
 	return internal_config.legacy_mem ?
 			eal_legacy_hugepage_init() :
 			eal_hugepage_init();
@@ -2455,7 +2457,9 @@ rte_eal_memseg_init(void)
 	}
 #endif
 
-	return rte_eal_process_type() == RTE_PROC_PRIMARY ?
+	/* a warm restart attaches the lists of the previous run */
+	return rte_eal_process_type() == RTE_PROC_PRIMARY &&
+			!internal_config.warm_restarted ?
 #ifndef RTE_ARCH_64
 			memseg_primary_init_32() :
 #else
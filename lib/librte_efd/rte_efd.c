@@ -77,6 +77,7 @@ allocated memory
 enum efd_lookup_internal_function {
 	EFD_LOOKUP_SCALAR = 0,
 	EFD_LOOKUP_AVX2,
+	EFD_LOOKUP_AVX512,
 	EFD_LOOKUP_NEON,
 	EFD_LOOKUP_NUM
 };
@@ -640,7 +641,17 @@ rte_efd_create(const char *name, uint32_t max_num_rules, uint32_t key_len,
 		}
 	}
 
-#if defined(RTE_ARCH_X86)
+#if defined(RTE_ARCH_X86) && defined(RTE_MACHINE_CPUFLAG_AVX512F)
+	/*
+	 * Bulk lookups of values of up to 8 bits do two keys per vector,
+	 * larger values do 16 bits per vector
+	 */
+	if (RTE_EFD_VALUE_NUM_BITS > 3 &&
+	    rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F))
+		table->lookup_fn = EFD_LOOKUP_AVX512;
+	else
+#endif
+#if defined(RTE_ARCH_X86) && defined(RTE_MACHINE_CPUFLAG_AVX2)
 	/*
 	 * For less than 4 bits, scalar function performs better
 	 * than vectorised version
@@ -1029,7 +1040,8 @@ efd_compute_update(struct rte_efd_table * const table,
 			status = RTE_EFD_UPDATE_WARN_GROUP_FULL;
 		}
 
-		if (rte_ring_sc_dequeue(table->free_slots, &slot_id) != 0)
+		/* Shards of a bulk update may dequeue slots concurrently */
+		if (rte_ring_dequeue(table->free_slots, &slot_id) != 0)
 			return RTE_EFD_UPDATE_FAILED;
 
 		new_k = RTE_PTR_ADD(table->keys, (uintptr_t) slot_id *
@@ -1042,7 +1054,7 @@ efd_compute_update(struct rte_efd_table * const table,
 		current_group->value[current_group->num_rules] = value;
 		current_group->bin_id[current_group->num_rules] = *bin_id;
 		current_group->num_rules++;
-		table->num_rules++;
+		__atomic_fetch_add(&table->num_rules, 1, __ATOMIC_RELAXED);
 		bin_size++;
 	} else {
 		uint32_t last = current_group->num_rules - 1;
@@ -1147,7 +1159,7 @@ efd_compute_update(struct rte_efd_table * const table,
 
 	if (!found) {
 		current_group->num_rules--;
-		table->num_rules--;
+		__atomic_fetch_sub(&table->num_rules, 1, __ATOMIC_RELAXED);
 	} else
 		current_group->value[current_group->num_rules - 1] =
 			key_changed_previous_value;
@@ -1177,6 +1189,422 @@ rte_efd_update(struct rte_efd_table * const table, const unsigned int socket_id,
 	return status;
 }
 
+/** Working space of a bulk update, reused for each chunk updated */
+struct efd_bulk_scratch {
+	struct efd_offline_chunk_rules offline;
+	/**< Copy of the offline chunk, to roll back a failed update. */
+	struct efd_online_chunk online;
+	/**< New online chunk, with the bin choices of the staged keys. */
+	uint32_t *start;
+	/**< Index in key_ids of the keys of each chunk of the shard. */
+	uint32_t *key_ids;
+	/**< Keys of the shard, sorted by chunk. */
+	uint32_t *hashes;
+	/**< EFD_HASH of each key of key_ids. */
+	uint32_t *slots;
+	/**< Key slots taken by the new keys of the chunk being updated. */
+};
+
+static inline uint8_t
+efd_get_staged_choice(const uint8_t * const bin_choice_list,
+		const uint32_t bin_id)
+{
+	return (bin_choice_list[bin_id / EFD_CHUNK_NUM_BIN_TO_GROUP_SETS] >>
+			((bin_id & 0x3) * 2)) & 0x3;
+}
+
+static inline void
+efd_set_staged_choice(uint8_t * const bin_choice_list, const uint32_t bin_id,
+		const uint8_t choice)
+{
+	uint8_t bin_index = bin_id / EFD_CHUNK_NUM_BIN_TO_GROUP_SETS;
+	int offset = (bin_id & 0x3) * 2;
+
+	bin_choice_list[bin_index] =
+			(bin_choice_list[bin_index] & (~(0x03 << offset))) |
+			((choice & 0x03) << offset);
+}
+
+/**
+ * Inserts or updates a key in the offline table, and rebalances its bin as
+ * efd_compute_update does, but does not search the perfect hash of the
+ * modified group: it is only marked in dirty, to be searched once
+ * all the keys of the chunk have been staged.
+ *
+ * @param table
+ *   EFD table to reference
+ * @param chunk
+ *   Offline chunk of the key
+ * @param bin_choice_list
+ *   Bin choices of the chunk, read and updated instead of the online ones
+ * @param key
+ *   Key to insert
+ * @param value
+ *   Value to associate with key
+ * @param bin_id
+ *   Bin ID of the key
+ * @param dirty
+ *   Bitmask of the groups of the chunk whose hash must be searched again
+ * @param moved_from
+ *   Bitmask of the groups of the chunk a bin was moved from
+ * @param scratch
+ *   Working space, the slot of a new key is added to its slots
+ * @param num_slots
+ *   Number of slots taken in the chunk, incremented for a new key
+ *
+ * @return
+ *   Same as efd_compute_update
+ */
+static inline int
+efd_stage_update(struct rte_efd_table * const table,
+		struct efd_offline_chunk_rules * const chunk,
+		uint8_t * const bin_choice_list, const void *key,
+		const efd_value_t value, const uint32_t bin_id,
+		uint64_t * const dirty, uint64_t * const moved_from,
+		struct efd_bulk_scratch * const scratch,
+		uint32_t * const num_slots)
+{
+	uint8_t choice = efd_get_staged_choice(bin_choice_list, bin_id);
+	uint32_t group_id = efd_bin_to_group[choice][bin_id];
+	struct efd_offline_group_rules *group = &chunk->group_rules[group_id];
+	uint8_t bin_size = 0;
+	unsigned int i, found = 0;
+	int status = 0;
+	void *slot_id;
+
+	for (i = 0; i < group->num_rules; i++) {
+		if (group->bin_id[i] != bin_id)
+			continue;
+		bin_size++;
+
+		if (found == 0 && memcmp(EFD_KEY(group->key_idx[i], table),
+				key, table->key_len) == 0) {
+			if (group->value[i] == value)
+				return RTE_EFD_UPDATE_NO_CHANGE;
+			group->value[i] = value;
+			found = 1;
+		}
+	}
+
+	if (found == 0) {
+		if (unlikely(group->num_rules >= EFD_MAX_GROUP_NUM_RULES))
+			return RTE_EFD_UPDATE_FAILED;
+		if (unlikely(group->num_rules == EFD_MAX_GROUP_NUM_RULES - 1))
+			status = RTE_EFD_UPDATE_WARN_GROUP_FULL;
+
+		if (rte_ring_dequeue(table->free_slots, &slot_id) != 0)
+			return RTE_EFD_UPDATE_FAILED;
+		scratch->slots[(*num_slots)++] = (uintptr_t) slot_id;
+
+		rte_memcpy(EFD_KEY((uintptr_t) slot_id, table), key,
+				table->key_len);
+		group->key_idx[group->num_rules] = (uintptr_t) slot_id;
+		group->value[group->num_rules] = value;
+		group->bin_id[group->num_rules] = bin_id;
+		group->num_rules++;
+		bin_size++;
+	}
+
+	/*
+	 * Move the bin to the smallest of its groups. The group it leaves
+	 * must still resolve the keys of the bin until the new bin choice
+	 * is published, see efd_update_chunk.
+	 */
+	if (group->num_rules > EFD_MIN_BALANCED_NUM_RULES) {
+		uint32_t smallest_size = group->num_rules - bin_size;
+		uint32_t smallest_group_id = group_id;
+		uint8_t smallest_choice = choice;
+
+		for (choice = 0; choice < EFD_CHUNK_NUM_BIN_TO_GROUP_SETS;
+				choice++) {
+			uint32_t test_group_id =
+					efd_bin_to_group[choice][bin_id];
+			uint32_t num_rules =
+					chunk->group_rules[test_group_id].num_rules;
+			if (num_rules < smallest_size) {
+				smallest_choice = choice;
+				smallest_size = num_rules;
+				smallest_group_id = test_group_id;
+			}
+		}
+
+		if (smallest_group_id != group_id) {
+			move_groups(bin_id, bin_size,
+					&chunk->group_rules[smallest_group_id],
+					group);
+			efd_set_staged_choice(bin_choice_list, bin_id,
+					smallest_choice);
+			*moved_from |= 1ULL << group_id;
+			group_id = smallest_group_id;
+		}
+	}
+
+	*dirty |= 1ULL << group_id;
+	return status;
+}
+
+/*
+ * Adds to a group the rules it had before a bulk update in the bins that
+ * moved to another group, so that its hash still resolves them.
+ */
+static inline int
+efd_add_departed_rules(struct efd_offline_group_rules * const superset,
+		const struct efd_offline_group_rules * const previous,
+		const uint8_t * const bin_choice_list, const uint32_t group_id)
+{
+	uint32_t i, bin_id;
+
+	for (i = 0; i < previous->num_rules; i++) {
+		bin_id = previous->bin_id[i];
+		if (efd_bin_to_group[efd_get_staged_choice(bin_choice_list,
+				bin_id)][bin_id] == group_id)
+			continue;
+		if (superset->num_rules == EFD_MAX_GROUP_NUM_RULES)
+			return -ENOSPC;
+		superset->key_idx[superset->num_rules] = previous->key_idx[i];
+		superset->value[superset->num_rules] = previous->value[i];
+		superset->bin_id[superset->num_rules] = bin_id;
+		superset->num_rules++;
+	}
+	return 0;
+}
+
+/**
+ * Applies the keys of a bulk update that belong to one chunk. All the keys
+ * are staged in the offline chunk first, then the hash of each modified
+ * group is searched once, and the online chunks are updated.
+ * Lookups stay consistent while the online chunks are updated: the groups
+ * are written before the bin choices, and the hash of a group bins moved
+ * from is searched for its previous keys too, so that every key is found
+ * with either its previous or its new bin choice.
+ * If a hash cannot be found, the chunk is rolled back and the keys are
+ * applied one at a time, as rte_efd_update does, which can try other
+ * bin choices.
+ *
+ * @param key_ids
+ *   Indexes in key_list of the num_keys keys of the chunk
+ * @param hashes
+ *   EFD_HASH of each key of key_ids
+ *
+ * @return
+ *   Number of keys that could not be applied
+ */
+static int
+efd_update_chunk(struct rte_efd_table * const table,
+		const unsigned int socket_id, uint32_t chunk_id,
+		const uint32_t num_keys, const uint32_t * const key_ids,
+		const uint32_t * const hashes, const void **key_list,
+		const efd_value_t *value_list, int *status_list,
+		struct efd_bulk_scratch * const scratch)
+{
+	struct efd_offline_chunk_rules * const chunk =
+			&table->offline_chunks[chunk_id];
+	struct efd_online_group_entry entry;
+	uint32_t i, k, group_id, bin_id, num_slots = 0;
+	struct efd_offline_group_rules superset;
+	uint64_t dirty = 0, moved_from = 0, pending;
+	uint8_t new_bin_choice;
+	int status, num_failed = 0;
+
+	memcpy(&scratch->offline, chunk, sizeof(scratch->offline));
+	memcpy(&scratch->online, &table->chunks[socket_id][chunk_id],
+			sizeof(scratch->online));
+
+	for (i = 0; i < num_keys; i++) {
+		k = key_ids[i];
+		status = efd_stage_update(table, chunk,
+				scratch->online.bin_choice_list, key_list[k],
+				value_list[k], efd_get_bin_id(table, hashes[i]),
+				&dirty, &moved_from, scratch, &num_slots);
+		if (status == RTE_EFD_UPDATE_FAILED)
+			break;
+		if (status_list != NULL)
+			status_list[k] = status == RTE_EFD_UPDATE_NO_CHANGE ?
+					0 : status;
+	}
+
+	for (pending = dirty; i == num_keys && pending != 0;
+			pending &= pending - 1) {
+		group_id = __builtin_ctzll(pending);
+		if ((moved_from & (1ULL << group_id)) == 0) {
+			if (efd_search_hash(table,
+					&chunk->group_rules[group_id],
+					&scratch->online.groups[group_id]) != 0)
+				break;
+			continue;
+		}
+		memcpy(&superset, &chunk->group_rules[group_id],
+				sizeof(superset));
+		if (efd_add_departed_rules(&superset,
+				&scratch->offline.group_rules[group_id],
+				scratch->online.bin_choice_list,
+				group_id) != 0 ||
+				efd_search_hash(table, &superset,
+					&scratch->online.groups[group_id]) != 0)
+			break;
+	}
+
+	if (i == num_keys && pending == 0) {
+		/* Groups first, so moved bins never use a stale group */
+		for (i = 0; i < RTE_MAX_NUMA_NODES; i++) {
+			struct efd_online_chunk *online;
+
+			if (table->chunks[i] == NULL)
+				continue;
+			online = &table->chunks[i][chunk_id];
+			for (pending = dirty; pending != 0;
+					pending &= pending - 1) {
+				group_id = __builtin_ctzll(pending);
+				memcpy(&online->groups[group_id],
+					&scratch->online.groups[group_id],
+					sizeof(struct efd_online_group_entry));
+			}
+			rte_smp_wmb();
+			memcpy(online->bin_choice_list,
+					scratch->online.bin_choice_list,
+					sizeof(online->bin_choice_list));
+		}
+		__atomic_fetch_add(&table->num_rules, num_slots,
+				__ATOMIC_RELAXED);
+		return 0;
+	}
+
+	RTE_LOG(DEBUG, EFD, "Bulk update of chunk %u failed, "
+			"applying its %u keys one at a time\n",
+			chunk_id, num_keys);
+	memcpy(chunk, &scratch->offline, sizeof(*chunk));
+	for (i = 0; i < num_slots; i++)
+		rte_ring_enqueue(table->free_slots,
+				(void *) ((uintptr_t) scratch->slots[i]));
+
+	for (i = 0; i < num_keys; i++) {
+		k = key_ids[i];
+		status = efd_compute_update(table, socket_id, key_list[k],
+				value_list[k], &chunk_id, &group_id, &bin_id,
+				&new_bin_choice, &entry);
+		if (status == RTE_EFD_UPDATE_NO_CHANGE)
+			status = 0;
+		else if (status == RTE_EFD_UPDATE_FAILED)
+			num_failed++;
+		else
+			efd_apply_update(table, socket_id, chunk_id, group_id,
+					bin_id, new_bin_choice, &entry);
+		if (status_list != NULL)
+			status_list[k] = status;
+	}
+	return num_failed;
+}
+
+static int
+efd_update_bulk(struct rte_efd_table * const table,
+		const unsigned int socket_id, const uint32_t num_keys,
+		const void **key_list, const efd_value_t *value_list,
+		int *status_list, const unsigned int shard_id,
+		const unsigned int num_shards)
+{
+	struct efd_bulk_scratch *scratch;
+	uint32_t i, chunk_id, idx, h, first, num_shard_chunks;
+	uint32_t num_shard_keys = 0, max_chunk_keys = 0;
+	int num_failed = 0;
+
+	RTE_BUILD_BUG_ON(EFD_CHUNK_NUM_GROUPS > 64);
+
+	if (table == NULL || (num_keys != 0 &&
+			(key_list == NULL || value_list == NULL)) ||
+			num_shards == 0 || shard_id >= num_shards ||
+			socket_id >= RTE_MAX_NUMA_NODES ||
+			table->chunks[socket_id] == NULL)
+		return -EINVAL;
+
+	/* The shard gets the chunks whose ID modulo num_shards is shard_id */
+	num_shard_chunks = (table->num_chunks + num_shards - shard_id - 1) /
+			num_shards;
+	scratch = rte_zmalloc(NULL, sizeof(*scratch) +
+			(num_shard_chunks + 1) * sizeof(uint32_t),
+			RTE_CACHE_LINE_SIZE);
+	if (scratch == NULL)
+		return -ENOMEM;
+	scratch->start = (uint32_t *) (scratch + 1);
+
+	/* Count the keys of each chunk of the shard */
+	for (i = 0; i < num_keys; i++) {
+		chunk_id = efd_get_chunk_id(table,
+				EFD_HASH(key_list[i], table));
+		if (chunk_id % num_shards != shard_id)
+			continue;
+		scratch->start[chunk_id / num_shards + 1]++;
+		num_shard_keys++;
+	}
+	for (idx = 0; idx < num_shard_chunks; idx++) {
+		max_chunk_keys = RTE_MAX(max_chunk_keys,
+				scratch->start[idx + 1]);
+		scratch->start[idx + 1] += scratch->start[idx];
+	}
+
+	if (num_shard_keys == 0) {
+		rte_free(scratch);
+		return 0;
+	}
+
+	scratch->key_ids = rte_malloc(NULL, (2 * num_shard_keys +
+			max_chunk_keys) * sizeof(uint32_t), 0);
+	if (scratch->key_ids == NULL) {
+		rte_free(scratch);
+		return -ENOMEM;
+	}
+	scratch->hashes = scratch->key_ids + num_shard_keys;
+	scratch->slots = scratch->hashes + num_shard_keys;
+
+	/* Sort the keys by chunk, keeping their order within a chunk */
+	for (i = 0; i < num_keys; i++) {
+		h = EFD_HASH(key_list[i], table);
+		chunk_id = efd_get_chunk_id(table, h);
+		if (chunk_id % num_shards != shard_id)
+			continue;
+		idx = scratch->start[chunk_id / num_shards]++;
+		scratch->key_ids[idx] = i;
+		scratch->hashes[idx] = h;
+	}
+
+	/* start[idx] is now the end of the keys of chunk idx */
+	for (idx = 0, first = 0; idx < num_shard_chunks; idx++) {
+		if (scratch->start[idx] == first)
+			continue;
+		num_failed += efd_update_chunk(table, socket_id,
+				idx * num_shards + shard_id,
+				scratch->start[idx] - first,
+				&scratch->key_ids[first],
+				&scratch->hashes[first], key_list, value_list,
+				status_list, scratch);
+		first = scratch->start[idx];
+	}
+
+	rte_free(scratch->key_ids);
+	rte_free(scratch);
+	return num_failed;
+}
+
+int
+rte_efd_update_bulk(struct rte_efd_table * const table,
+		const unsigned int socket_id, const uint32_t num_keys,
+		const void **key_list, const efd_value_t *value_list,
+		int *status_list)
+{
+	return efd_update_bulk(table, socket_id, num_keys, key_list,
+			value_list, status_list, 0, 1);
+}
+
+int
+rte_efd_update_bulk_shard(struct rte_efd_table * const table,
+		const unsigned int socket_id, const uint32_t num_keys,
+		const void **key_list, const efd_value_t *value_list,
+		int *status_list, const unsigned int shard_id,
+		const unsigned int num_shards)
+{
+	return efd_update_bulk(table, socket_id, num_keys, key_list,
+			value_list, status_list, shard_id, num_shards);
+}
+
 int
 rte_efd_delete(struct rte_efd_table * const table, const unsigned int socket_id,
 		const void *key, efd_value_t * const prev_value)
@@ -1265,7 +1693,20 @@ efd_lookup_internal(const struct efd_online_group_entry * const group,
 
 	switch (lookup_fn) {
 
-#if defined(RTE_ARCH_X86) && defined(CC_SUPPORT_AVX2)
+#if defined(RTE_ARCH_X86) && defined(RTE_MACHINE_CPUFLAG_AVX512F)
+	case EFD_LOOKUP_AVX512:
+		if (RTE_EFD_VALUE_NUM_BITS > 8)
+			return efd_lookup_internal_avx512(group->hash_idx,
+					group->lookup_table,
+					hash_val_a,
+					hash_val_b);
+		/* A single group of up to 8 bits fits in an AVX2 vector */
+		return efd_lookup_internal_avx2(group->hash_idx,
+					group->lookup_table,
+					hash_val_a,
+					hash_val_b);
+#endif
+#if defined(RTE_ARCH_X86) && defined(RTE_MACHINE_CPUFLAG_AVX2)
 	case EFD_LOOKUP_AVX2:
 		return efd_lookup_internal_avx2(group->hash_idx,
 					group->lookup_table,
@@ -1342,7 +1783,33 @@ void rte_efd_lookup_bulk(const struct rte_efd_table * const table,
 		rte_prefetch0(group);
 	}
 
-	for (i = 0; i < num_keys; i++) {
+	i = 0;
+#if defined(RTE_ARCH_X86) && defined(RTE_MACHINE_CPUFLAG_AVX512F)
+	if (RTE_EFD_VALUE_NUM_BITS <= 8 &&
+			table->lookup_fn == EFD_LOOKUP_AVX512) {
+		const efd_hashfunc_t *hash_idx[2];
+		const efd_lookuptbl_t *lookup_table[2];
+		uint32_t hash_val_a[2], hash_val_b[2];
+		int j;
+
+		for (; i + 1 < num_keys; i += 2) {
+			for (j = 0; j < 2; j++) {
+				group = &chunks[chunk_id_list[i + j]]
+					.groups[group_id_list[i + j]];
+				hash_idx[j] = group->hash_idx;
+				lookup_table[j] = group->lookup_table;
+				hash_val_a[j] = EFD_HASHFUNCA(key_list[i + j],
+						table);
+				hash_val_b[j] = EFD_HASHFUNCB(key_list[i + j],
+						table);
+			}
+			efd_lookup_internal_avx512_x2(hash_idx, lookup_table,
+					hash_val_a, hash_val_b, &value_list[i]);
+		}
+	}
+#endif
+
+	for (; i < num_keys; i++) {
 		group = &chunks[chunk_id_list[i]].groups[group_id_list[i]];
 		value_list[i] = efd_lookup_internal(group,
 				EFD_HASHFUNCA(key_list[i], table),
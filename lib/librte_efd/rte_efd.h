@@ -13,6 +13,8 @@
 
 #include <stdint.h>
 
+#include <rte_compat.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -200,6 +202,93 @@ int
 rte_efd_update(struct rte_efd_table *table, unsigned int socket_id,
 	const void *key, efd_value_t value);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Inserts or updates several key/value pairs at once.
+ * The keys are applied chunk by chunk: all the keys of a chunk are added to
+ * the offline table first, then the perfect hash of each group modified is
+ * searched only once, instead of once per key as with rte_efd_update().
+ * The online table is updated when the hashes of a chunk have been found.
+ * If a hash cannot be found for a group, the keys of its chunk are applied
+ * one at a time, as by rte_efd_update().
+ * Keys of the same chunk are applied in the order of key_list, so the last
+ * value given for a key is kept.
+ * Lookups running concurrently return the previous or the new value of the
+ * keys of key_list, and the value of the other keys, as long as a lookup
+ * does not span two updates.
+ * Temporary arrays of up to 12 bytes per key are allocated.
+ * This operation is not multi-thread safe
+ * and should only be called from one thread.
+ *
+ * @param table
+ *   EFD table to reference
+ * @param socket_id
+ *   Socket ID to use to lookup existing values (ideally caller's socket id)
+ * @param num_keys
+ *   Number of keys in the key_list array
+ * @param key_list
+ *   Array of num_keys pointers which point to the keys to insert or update
+ * @param value_list
+ *   Array of num_keys values to associate with the keys
+ * @param status_list
+ *   If not NULL, array of num_keys where the status of each key is stored,
+ *   as returned by rte_efd_update()
+ * @return
+ *   Number of keys that could not be inserted (RTE_EFD_UPDATE_FAILED status),
+ *   0 if all the keys were inserted,
+ *   -EINVAL if the parameters are invalid,
+ *   -ENOMEM if the temporary arrays could not be allocated
+ */
+__rte_experimental
+int
+rte_efd_update_bulk(struct rte_efd_table *table, unsigned int socket_id,
+	uint32_t num_keys, const void **key_list, const efd_value_t *value_list,
+	int *status_list);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Same as rte_efd_update_bulk(), for the keys of one shard of the table.
+ * A shard is the set of chunks whose index modulo num_shards is shard_id.
+ * Shards are independent, so a large table can be built in parallel by
+ * calling this function from num_shards lcores at the same time, each one
+ * with a different shard_id and the same keys and values.
+ * Keys of other shards are skipped, and their status is not stored.
+ * Calls for different shards may run concurrently with each other,
+ * but not with other updates or deletions.
+ *
+ * @param table
+ *   EFD table to reference
+ * @param socket_id
+ *   Socket ID to use to lookup existing values (ideally caller's socket id)
+ * @param num_keys
+ *   Number of keys in the key_list array
+ * @param key_list
+ *   Array of num_keys pointers which point to the keys to insert or update
+ * @param value_list
+ *   Array of num_keys values to associate with the keys
+ * @param status_list
+ *   If not NULL, array of num_keys where the status of each key of the shard
+ *   is stored, as returned by rte_efd_update()
+ * @param shard_id
+ *   Shard to update, lower than num_shards
+ * @param num_shards
+ *   Number of shards the table is split into
+ * @return
+ *   Number of keys of the shard that could not be inserted,
+ *   0 if all the keys of the shard were inserted,
+ *   -EINVAL if the parameters are invalid,
+ *   -ENOMEM if the temporary arrays could not be allocated
+ */
+__rte_experimental
+int
+rte_efd_update_bulk_shard(struct rte_efd_table *table, unsigned int socket_id,
+	uint32_t num_keys, const void **key_list, const efd_value_t *value_list,
+	int *status_list, unsigned int shard_id, unsigned int num_shards);
+
 /**
  * Removes any value currently associated with the specified key from the table
  * This operation is not multi-thread safe
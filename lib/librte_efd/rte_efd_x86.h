@@ -26,12 +26,24 @@ efd_lookup_internal_avx2(const efd_hashfunc_t *group_hash_idx,
 	__m256i vhash_val_b = _mm256_set1_epi32(hash_val_b);
 
 	for (; i < RTE_EFD_VALUE_NUM_BITS; i += 8) {
+#if RTE_EFD_VALUE_NUM_BITS == 8
+		/* Load the group at once, as efd_lookup_internal_avx512_x2 */
+		__m256i group = _mm256_loadu_si256(
+				(__m256i const *) group_hash_idx);
+		__m256i vhash_idx = _mm256_cvtepu16_epi32(
+				_mm256_castsi256_si128(group));
+		__m256i vlookup_table = _mm256_cvtepu16_epi32(
+				_mm256_extracti128_si256(group, 1));
+
+		RTE_SET_USED(group_lookup_table);
+#else
 		__m256i vhash_idx =
 				_mm256_cvtepu16_epi32(EFD_LOAD_SI128(
 				(__m128i const *) &group_hash_idx[i]));
 		__m256i vlookup_table = _mm256_cvtepu16_epi32(
 				EFD_LOAD_SI128((__m128i const *)
 				&group_lookup_table[i]));
+#endif
 		__m256i vhash = _mm256_add_epi32(vhash_val_a,
 				_mm256_mullo_epi32(vhash_idx, vhash_val_b));
 		__m256i vbucket_idx = _mm256_srli_epi32(vhash,
@@ -55,3 +67,110 @@ efd_lookup_internal_avx2(const efd_hashfunc_t *group_hash_idx,
 #endif
 
 }
+
+/*
+ * Looks up the values of two keys at once, for values of up to 8 bits:
+ * the bits of both groups fill the 16 lanes of an AVX-512 vector.
+ */
+static inline void
+efd_lookup_internal_avx512_x2(const efd_hashfunc_t * const group_hash_idx[2],
+		const efd_lookuptbl_t * const group_lookup_table[2],
+		const uint32_t hash_val_a[2], const uint32_t hash_val_b[2],
+		efd_value_t value[2])
+{
+#ifdef RTE_MACHINE_CPUFLAG_AVX512F
+	const uint32_t value_mask = (1 << RTE_EFD_VALUE_NUM_BITS) - 1;
+	__m512i vhash_val_a = _mm512_inserti64x4(
+			_mm512_set1_epi32(hash_val_a[0]),
+			_mm256_set1_epi32(hash_val_a[1]), 1);
+	__m512i vhash_val_b = _mm512_inserti64x4(
+			_mm512_set1_epi32(hash_val_b[0]),
+			_mm256_set1_epi32(hash_val_b[1]), 1);
+#if RTE_EFD_VALUE_NUM_BITS == 8
+	/*
+	 * The lookup table of a group follows its hash indexes: load each
+	 * group at once, so that a group being updated is not seen half
+	 * written.
+	 */
+	__m256i group0 = _mm256_loadu_si256(
+			(__m256i const *) group_hash_idx[0]);
+	__m256i group1 = _mm256_loadu_si256(
+			(__m256i const *) group_hash_idx[1]);
+	__m512i vhash_idx = _mm512_cvtepu16_epi32(
+			_mm256_permute2x128_si256(group0, group1, 0x20));
+	__m512i vlookup_table = _mm512_cvtepu16_epi32(
+			_mm256_permute2x128_si256(group0, group1, 0x31));
+
+	RTE_SET_USED(group_lookup_table);
+#else
+	__m512i vhash_idx = _mm512_cvtepu16_epi32(_mm256_inserti128_si256(
+			_mm256_castsi128_si256(EFD_LOAD_SI128(
+			(__m128i const *) group_hash_idx[0])),
+			EFD_LOAD_SI128((__m128i const *) group_hash_idx[1]),
+			1));
+	__m512i vlookup_table = _mm512_cvtepu16_epi32(_mm256_inserti128_si256(
+			_mm256_castsi128_si256(EFD_LOAD_SI128(
+			(__m128i const *) group_lookup_table[0])),
+			EFD_LOAD_SI128((__m128i const *) group_lookup_table[1]),
+			1));
+#endif
+	__m512i vhash = _mm512_add_epi32(vhash_val_a,
+			_mm512_mullo_epi32(vhash_idx, vhash_val_b));
+	__m512i vbucket_idx = _mm512_srli_epi32(vhash, EFD_LOOKUPTBL_SHIFT);
+	__m512i vresult = _mm512_srlv_epi32(vlookup_table, vbucket_idx);
+	__mmask16 bits = _mm512_test_epi32_mask(vresult,
+			_mm512_set1_epi32(1));
+
+	value[0] = bits & value_mask;
+	value[1] = (bits >> 8) & value_mask;
+#else
+	RTE_SET_USED(group_hash_idx);
+	RTE_SET_USED(group_lookup_table);
+	RTE_SET_USED(hash_val_a);
+	RTE_SET_USED(hash_val_b);
+	/* Return dummy values, only to avoid compilation breakage */
+	value[0] = 0;
+	value[1] = 0;
+#endif
+}
+
+static inline efd_value_t
+efd_lookup_internal_avx512(const efd_hashfunc_t *group_hash_idx,
+		const efd_lookuptbl_t *group_lookup_table,
+		const uint32_t hash_val_a, const uint32_t hash_val_b)
+{
+#ifdef RTE_MACHINE_CPUFLAG_AVX512F
+	efd_value_t value = 0;
+	uint32_t i = 0;
+	__m512i vhash_val_a = _mm512_set1_epi32(hash_val_a);
+	__m512i vhash_val_b = _mm512_set1_epi32(hash_val_b);
+
+	for (; i < RTE_EFD_VALUE_NUM_BITS; i += 16) {
+		__m512i vhash_idx = _mm512_cvtepu16_epi32(_mm256_loadu_si256(
+				(__m256i const *) &group_hash_idx[i]));
+		__m512i vlookup_table = _mm512_cvtepu16_epi32(
+				_mm256_loadu_si256((__m256i const *)
+				&group_lookup_table[i]));
+		__m512i vhash = _mm512_add_epi32(vhash_val_a,
+				_mm512_mullo_epi32(vhash_idx, vhash_val_b));
+		__m512i vbucket_idx = _mm512_srli_epi32(vhash,
+				EFD_LOOKUPTBL_SHIFT);
+		__m512i vresult = _mm512_srlv_epi32(vlookup_table,
+				vbucket_idx);
+		uint64_t bits = _mm512_test_epi32_mask(vresult,
+				_mm512_set1_epi32(1));
+
+		value |= (efd_value_t)((bits &
+			((1ULL << (RTE_EFD_VALUE_NUM_BITS - i)) - 1)) << i);
+	}
+
+	return value;
+#else
+	RTE_SET_USED(group_hash_idx);
+	RTE_SET_USED(group_lookup_table);
+	RTE_SET_USED(hash_val_a);
+	RTE_SET_USED(hash_val_b);
+	/* Return dummy value, only to avoid compilation breakage */
+	return 0;
+#endif
+}
@@ -370,6 +370,7 @@ rte_eth_dev_shared_data_prepare(void)
 {
 	const unsigned flags = 0;
 	const struct rte_memzone *mz;
+	bool restored = false;
 
 	rte_spinlock_lock(&rte_eth_shared_data_lock);
 
@@ -379,6 +380,11 @@ rte_eth_dev_shared_data_prepare(void)
 			mz = rte_memzone_reserve(MZ_RTE_ETH_DEV_DATA,
 					sizeof(*rte_eth_dev_shared_data),
 					rte_socket_id(), flags);
+			/* a warm restarted primary takes over the old one */
+			if (mz == NULL && rte_eal_warm_restarted()) {
+				mz = rte_memzone_lookup(MZ_RTE_ETH_DEV_DATA);
+				restored = true;
+			}
 		} else
 			mz = rte_memzone_lookup(MZ_RTE_ETH_DEV_DATA);
 		if (mz == NULL)
@@ -386,11 +392,16 @@ rte_eth_dev_shared_data_prepare(void)
 
 		rte_eth_dev_shared_data = mz->addr;
 		if (rte_eal_process_type() == RTE_PROC_PRIMARY) {
-			rte_eth_dev_shared_data->next_owner_id =
-					RTE_ETH_DEV_NO_OWNER + 1;
+			/* the port data of a warm restart is kept, only the
+			 * lock the previous process may have held is reset
+			 */
 			rte_spinlock_init(&rte_eth_dev_shared_data->ownership_lock);
-			memset(rte_eth_dev_shared_data->data, 0,
-			       sizeof(rte_eth_dev_shared_data->data));
+			if (!restored) {
+				rte_eth_dev_shared_data->next_owner_id =
+						RTE_ETH_DEV_NO_OWNER + 1;
+				memset(rte_eth_dev_shared_data->data, 0,
+				       sizeof(rte_eth_dev_shared_data->data));
+			}
 		}
 	}
 
@@ -448,6 +459,20 @@ rte_eth_dev_find_free_port(void)
 	return RTE_MAX_ETHPORTS;
 }
 
+/* Find a port of the previous primary process kept by a warm restart */
+static uint16_t
+rte_eth_dev_find_kept_port(const char *name)
+{
+	unsigned i;
+
+	for (i = 0; i < RTE_MAX_ETHPORTS; i++) {
+		if (rte_eth_devices[i].state == RTE_ETH_DEV_UNUSED &&
+		    strcmp(rte_eth_dev_shared_data->data[i].name, name) == 0)
+			return i;
+	}
+	return RTE_MAX_ETHPORTS;
+}
+
 static struct rte_eth_dev *
 eth_dev_get(uint16_t port_id)
 {
@@ -488,11 +513,20 @@ rte_eth_dev_allocate(const char *name)
 		goto unlock;
 	}
 
-	port_id = rte_eth_dev_find_free_port();
-	if (port_id == RTE_MAX_ETHPORTS) {
-		RTE_ETHDEV_LOG(ERR,
-			"Reached maximum number of Ethernet ports\n");
-		goto unlock;
+	/* a port kept by a warm restart gets its id back, reset */
+	port_id = RTE_MAX_ETHPORTS;
+	if (rte_eal_warm_restarted())
+		port_id = rte_eth_dev_find_kept_port(name);
+	if (port_id != RTE_MAX_ETHPORTS) {
+		memset(&rte_eth_dev_shared_data->data[port_id], 0,
+		       sizeof(struct rte_eth_dev_data));
+	} else {
+		port_id = rte_eth_dev_find_free_port();
+		if (port_id == RTE_MAX_ETHPORTS) {
+			RTE_ETHDEV_LOG(ERR,
+				"Reached maximum number of Ethernet ports\n");
+			goto unlock;
+		}
 	}
 
 	eth_dev = eth_dev_get(port_id);
@@ -4691,6 +4725,36 @@ rte_eth_tx_burst_mode_get(uint16_t port_id, uint16_t queue_id,
 		       dev->dev_ops->tx_burst_mode_get(dev, queue_id, mode));
 }
 
+int
+rte_eth_get_monitor_addr(uint16_t port_id, uint16_t queue_id,
+		struct rte_power_monitor_cond *pmc)
+{
+	struct rte_eth_dev *dev;
+
+	RTE_ETH_VALID_PORTID_OR_ERR_RET(port_id, -ENODEV);
+
+	if (pmc == NULL)
+		return -EINVAL;
+
+	dev = &rte_eth_devices[port_id];
+
+	if (queue_id >= dev->data->nb_rx_queues) {
+		RTE_ETHDEV_LOG(ERR, "Invalid RX queue_id=%u\n", queue_id);
+		return -EINVAL;
+	}
+
+	/* the drivers read the ring of the queue */
+	if (dev->data->rx_queues[queue_id] == NULL) {
+		RTE_ETHDEV_LOG(ERR, "RX queue_id=%u is not setup\n", queue_id);
+		return -EINVAL;
+	}
+
+	RTE_FUNC_PTR_OR_ERR_RET(*dev->dev_ops->get_monitor_addr, -ENOTSUP);
+	return eth_err(port_id,
+		dev->dev_ops->get_monitor_addr(dev->data->rx_queues[queue_id],
+			pmc));
+}
+
 int
 rte_eth_dev_set_mc_addr_list(uint16_t port_id,
 			     struct rte_ether_addr *mc_addr_set,
@@ -621,10 +621,12 @@ eca_crypto_adapter_deq_run(struct rte_event_crypto_adapter *adapter,
 	return nb_deq;
 }
 
-static void
+static unsigned int
 eca_crypto_adapter_run(struct rte_event_crypto_adapter *adapter,
 			unsigned int max_ops)
 {
+	unsigned int nb_ops = max_ops;
+
 	while (max_ops) {
 		unsigned int e_cnt, d_cnt;
 
@@ -638,19 +640,22 @@ eca_crypto_adapter_run(struct rte_event_crypto_adapter *adapter,
 			break;
 
 	}
+
+	return nb_ops - max_ops;
 }
 
 static int
 eca_service_func(void *args)
 {
 	struct rte_event_crypto_adapter *adapter = args;
+	unsigned int nb_ops;
 
 	if (rte_spinlock_trylock(&adapter->lock) == 0)
-		return 0;
-	eca_crypto_adapter_run(adapter, adapter->max_nb);
+		return -EAGAIN;
+	nb_ops = eca_crypto_adapter_run(adapter, adapter->max_nb);
 	rte_spinlock_unlock(&adapter->lock);
 
-	return 0;
+	return nb_ops == 0 ? -EAGAIN : 0;
 }
 
 static int
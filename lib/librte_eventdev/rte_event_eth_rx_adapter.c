@@ -15,6 +15,7 @@
 #include <rte_log.h>
 #include <rte_malloc.h>
 #include <rte_service_component.h>
+#include <rte_tailq.h>
 #include <rte_thash.h>
 #include <rte_interrupts.h>
 
@@ -35,6 +36,13 @@
 /* Sentinel value to detect initialized file handle */
 #define INIT_FD		-1
 
+/* Open event vectors per Rx queue, indexed by flow id, a power of 2 */
+#define RXA_NB_VECTOR_SLOTS	64
+#define RXA_MIN_VECTOR_SZ	4
+#define RXA_MAX_VECTOR_SZ	1024
+#define RXA_MIN_VECTOR_NS	1E4
+#define RXA_MAX_VECTOR_NS	1E9
+
 /*
  * Used to store port and queue ID of interrupting Rx queue
  */
@@ -58,6 +66,21 @@ struct eth_rx_poll_entry {
 	uint16_t eth_rx_qid;
 };
 
+/*
+ * Event vector being filled with the mbufs of a flow of an Rx queue
+ */
+struct eth_rx_vector_data {
+	TAILQ_ENTRY(eth_rx_vector_data) next;
+	/* Vector being filled, NULL if none is open */
+	struct rte_event_vector *vector;
+	/* Event enqueued with the vector */
+	uint64_t event;
+	/* Timestamp at which the vector is enqueued even if not full */
+	uint64_t expiry_ts;
+};
+
+TAILQ_HEAD(eth_rx_vector_list, eth_rx_vector_data);
+
 /* Instance per adapter */
 struct rte_eth_event_enqueue_buffer {
 	/* Count of events in this buffer */
@@ -93,6 +116,12 @@ struct rte_event_eth_rx_adapter {
 	struct rte_eth_event_enqueue_buffer event_enqueue_buffer;
 	/* Per adapter stats */
 	struct rte_event_eth_rx_adapter_stats stats;
+	/* Open event vectors, in the order they were opened */
+	struct eth_rx_vector_list vector_list;
+	/* Interval at which the open vectors are checked for expiry */
+	uint64_t vector_tmo_ticks;
+	/* Timestamp of the last check for expired vectors */
+	uint64_t prev_expiry_ts;
 	/* Block count, counts up to BLOCK_CNT_THRESHOLD */
 	uint16_t enq_block_count;
 	/* Block start ts */
@@ -200,6 +229,16 @@ struct eth_rx_queue_info {
 	uint16_t wt;		/* Polling weight */
 	uint32_t flow_id_mask;	/* Set to ~0 if app provides flow id else 0 */
 	uint64_t event;
+	/* Set if the mbufs are aggregated into event vectors */
+	int ena_vector;
+	/* Maximum number of mbufs of a vector */
+	uint16_t vector_sz;
+	/* Time a vector waits for mbufs, in TSC cycles */
+	uint64_t vector_tmo_ticks;
+	/* Mempool of the vectors */
+	struct rte_mempool *vector_mp;
+	/* Open vectors, indexed by flow id */
+	struct eth_rx_vector_data *vector_data;
 };
 
 static struct rte_event_eth_rx_adapter **event_eth_rx_adapter;
@@ -741,6 +780,90 @@ rxa_flush_event_buffer(struct rte_event_eth_rx_adapter *rx_adapter)
 	return n;
 }
 
+/* Move an open vector to the event buffer */
+static inline void
+rxa_vector_buffer(struct rte_event_eth_rx_adapter *rx_adapter,
+		struct eth_rx_vector_data *vd)
+{
+	struct rte_eth_event_enqueue_buffer *buf =
+					&rx_adapter->event_enqueue_buffer;
+	struct rte_event *ev = &buf->events[buf->count++];
+
+	ev->event = vd->event;
+	ev->vec = vd->vector;
+	TAILQ_REMOVE(&rx_adapter->vector_list, vd, next);
+	vd->vector = NULL;
+}
+
+/* Aggregate mbufs into the open vectors of their flows, enqueueing to the
+ * event buffer the vectors filled up or displaced by another flow. Every
+ * mbuf adds at most one event to the buffer since a vector holds more than
+ * one mbuf.
+ */
+static inline void
+rxa_vector_mbufs(struct rte_event_eth_rx_adapter *rx_adapter,
+		struct eth_rx_queue_info *queue_info,
+		uint16_t eth_dev_id,
+		uint16_t rx_queue_id,
+		struct rte_mbuf **mbufs,
+		uint16_t num,
+		int do_rss)
+{
+	struct eth_rx_vector_data *vd;
+	struct rte_event_vector *vec;
+	struct rte_event ev;
+	uint32_t flow_id_mask = queue_info->flow_id_mask;
+	uint32_t flow_id = ((struct rte_event *)&queue_info->event)->flow_id;
+	struct rte_mbuf *m;
+	uint64_t ts = rte_get_tsc_cycles();
+	uint32_t rss;
+	uint16_t dropped = 0;
+	uint16_t i;
+
+	ev.event = queue_info->event;
+	ev.event_type = RTE_EVENT_TYPE_ETH_RX_ADAPTER_VECTOR;
+
+	for (i = 0; i < num; i++) {
+		m = mbufs[i];
+
+		rss = do_rss ?
+			rxa_do_softrss(m, rx_adapter->rss_key_be) :
+			m->hash.rss;
+		ev.flow_id = (rss & ~flow_id_mask) | (flow_id & flow_id_mask);
+		vd = &queue_info->vector_data[ev.flow_id &
+					(RXA_NB_VECTOR_SLOTS - 1)];
+
+		if (vd->vector != NULL && vd->event != ev.event)
+			rxa_vector_buffer(rx_adapter, vd);
+
+		if (vd->vector == NULL) {
+			if (unlikely(rte_mempool_get(queue_info->vector_mp,
+						(void **)&vd->vector) < 0)) {
+				vd->vector = NULL;
+				rte_pktmbuf_free(m);
+				dropped++;
+				continue;
+			}
+			vec = vd->vector;
+			vec->nb_elem = 0;
+			vec->rsvd = 0;
+			vec->attr_valid = 1;
+			vec->port = eth_dev_id;
+			vec->queue = rx_queue_id;
+			vd->event = ev.event;
+			vd->expiry_ts = ts + queue_info->vector_tmo_ticks;
+			TAILQ_INSERT_TAIL(&rx_adapter->vector_list, vd, next);
+		}
+
+		vec = vd->vector;
+		vec->mbufs[vec->nb_elem++] = m;
+		if (vec->nb_elem >= queue_info->vector_sz)
+			rxa_vector_buffer(rx_adapter, vd);
+	}
+
+	rx_adapter->stats.rx_dropped += dropped;
+}
+
 static inline void
 rxa_buffer_mbufs(struct rte_event_eth_rx_adapter *rx_adapter,
 		uint16_t eth_dev_id,
@@ -780,6 +903,12 @@ rxa_buffer_mbufs(struct rte_event_eth_rx_adapter *rx_adapter,
 		}
 	}
 
+	if (eth_rx_queue_info->ena_vector) {
+		rxa_vector_mbufs(rx_adapter, eth_rx_queue_info, eth_dev_id,
+				rx_queue_id, mbufs, num, do_rss);
+		return;
+	}
+
 	for (i = 0; i < num; i++) {
 		m = mbufs[i];
 
@@ -1134,24 +1263,59 @@ rxa_poll(struct rte_event_eth_rx_adapter *rx_adapter)
 	return nb_rx;
 }
 
+/* Enqueue the vectors which have waited for their timeout */
+static void
+rxa_vector_expire(struct rte_event_eth_rx_adapter *rx_adapter)
+{
+	struct rte_eth_event_enqueue_buffer *buf =
+					&rx_adapter->event_enqueue_buffer;
+	struct eth_rx_vector_data *vd;
+	struct eth_rx_vector_data *tvd;
+	uint64_t ts;
+
+	ts = rte_get_tsc_cycles();
+	if (ts - rx_adapter->prev_expiry_ts < rx_adapter->vector_tmo_ticks)
+		return;
+	rx_adapter->prev_expiry_ts = ts;
+
+	/* The Rx queues may have different timeouts, so the vectors of the
+	 * list are not ordered by expiry.
+	 */
+	TAILQ_FOREACH_SAFE(vd, &rx_adapter->vector_list, next, tvd) {
+		if ((int64_t)(vd->expiry_ts - ts) > 0)
+			continue;
+		if (buf->count == ETH_EVENT_BUFFER_SIZE &&
+				rxa_flush_event_buffer(rx_adapter) == 0)
+			break;
+		rxa_vector_buffer(rx_adapter, vd);
+	}
+
+	if (buf->count > 0)
+		rxa_flush_event_buffer(rx_adapter);
+}
+
 static int
 rxa_service_func(void *args)
 {
 	struct rte_event_eth_rx_adapter *rx_adapter = args;
 	struct rte_event_eth_rx_adapter_stats *stats;
+	uint32_t nb_rx;
 
 	if (rte_spinlock_trylock(&rx_adapter->rx_lock) == 0)
-		return 0;
+		return -EAGAIN;
 	if (!rx_adapter->rxa_started) {
 		rte_spinlock_unlock(&rx_adapter->rx_lock);
-		return 0;
+		return -EAGAIN;
 	}
 
 	stats = &rx_adapter->stats;
-	stats->rx_packets += rxa_intr_ring_dequeue(rx_adapter);
-	stats->rx_packets += rxa_poll(rx_adapter);
+	nb_rx = rxa_intr_ring_dequeue(rx_adapter);
+	nb_rx += rxa_poll(rx_adapter);
+	if (!TAILQ_EMPTY(&rx_adapter->vector_list))
+		rxa_vector_expire(rx_adapter);
+	stats->rx_packets += nb_rx;
 	rte_spinlock_unlock(&rx_adapter->rx_lock);
-	return 0;
+	return nb_rx == 0 ? -EAGAIN : 0;
 }
 
 static int
@@ -1650,6 +1814,93 @@ rxa_update_queue(struct rte_event_eth_rx_adapter *rx_adapter,
 	}
 }
 
+/* Check for expired vectors twice per timeout of the queues with vectors */
+static void
+rxa_vector_tmo_update(struct rte_event_eth_rx_adapter *rx_adapter)
+{
+	struct eth_device_info *dev_info;
+	struct eth_rx_queue_info *queue_info;
+	uint64_t tmo_ticks = 0;
+	uint16_t nb_rx_queues;
+	uint16_t d;
+	uint16_t q;
+
+	RTE_ETH_FOREACH_DEV(d) {
+		dev_info = &rx_adapter->eth_devices[d];
+		if (dev_info->rx_queue == NULL)
+			continue;
+		nb_rx_queues = dev_info->dev->data->nb_rx_queues;
+		for (q = 0; q < nb_rx_queues; q++) {
+			queue_info = &dev_info->rx_queue[q];
+			if (!queue_info->ena_vector)
+				continue;
+			if (tmo_ticks == 0 ||
+					queue_info->vector_tmo_ticks < tmo_ticks)
+				tmo_ticks = queue_info->vector_tmo_ticks;
+		}
+	}
+
+	rx_adapter->vector_tmo_ticks = tmo_ticks / 2;
+}
+
+/* Stop aggregating the mbufs of an Rx queue, dropping the open vectors */
+static void
+rxa_vector_disable(struct rte_event_eth_rx_adapter *rx_adapter,
+		struct eth_rx_queue_info *queue_info)
+{
+	struct eth_rx_vector_data *vd;
+	struct rte_event_vector *vec;
+	uint16_t i;
+
+	if (queue_info->vector_data == NULL)
+		return;
+
+	for (i = 0; i < RXA_NB_VECTOR_SLOTS; i++) {
+		vd = &queue_info->vector_data[i];
+		vec = vd->vector;
+		if (vec == NULL)
+			continue;
+		rx_adapter->stats.rx_dropped += vec->nb_elem;
+		rte_pktmbuf_free_bulk(vec->mbufs, vec->nb_elem);
+		rte_mempool_put(rte_mempool_from_obj(vec), vec);
+		TAILQ_REMOVE(&rx_adapter->vector_list, vd, next);
+	}
+
+	rte_free(queue_info->vector_data);
+	queue_info->vector_data = NULL;
+	queue_info->ena_vector = 0;
+	rxa_vector_tmo_update(rx_adapter);
+}
+
+static int
+rxa_vector_config(struct rte_event_eth_rx_adapter *rx_adapter,
+		struct eth_rx_queue_info *queue_info,
+	const struct rte_event_eth_rx_adapter_event_vector_config *config)
+{
+	uint64_t tmo_ticks;
+
+	/* The open vectors may not hold the new vector size */
+	rxa_vector_disable(rx_adapter, queue_info);
+	if (config->vector_sz == 0)
+		return 0;
+
+	queue_info->vector_data = rte_zmalloc_socket(rx_adapter->mem_name,
+				RXA_NB_VECTOR_SLOTS *
+				sizeof(struct eth_rx_vector_data),
+				RTE_CACHE_LINE_SIZE, rx_adapter->socket_id);
+	if (queue_info->vector_data == NULL)
+		return -ENOMEM;
+
+	tmo_ticks = config->vector_timeout_ns * rte_get_tsc_hz() / 1E9;
+	queue_info->vector_sz = config->vector_sz;
+	queue_info->vector_tmo_ticks = tmo_ticks;
+	queue_info->vector_mp = config->vector_mp;
+	queue_info->ena_vector = 1;
+	rxa_vector_tmo_update(rx_adapter);
+
+	return 0;
+}
+
 static void
 rxa_sw_del(struct rte_event_eth_rx_adapter *rx_adapter,
 	struct eth_device_info *dev_info,
@@ -1676,6 +1927,7 @@ rxa_sw_del(struct rte_event_eth_rx_adapter *rx_adapter,
 	pollq = rxa_polled_queue(dev_info, rx_queue_id);
 	intrq = rxa_intr_queue(dev_info, rx_queue_id);
 	sintrq = rxa_shared_intr(dev_info, rx_queue_id);
+	rxa_vector_disable(rx_adapter, &dev_info->rx_queue[rx_queue_id]);
 	rxa_update_queue(rx_adapter, dev_info, rx_queue_id, 0);
 	rx_adapter->num_rx_polled -= pollq;
 	dev_info->nb_rx_poll -= pollq;
@@ -1992,6 +2244,7 @@ rte_event_eth_rx_adapter_create_ext(uint8_t id, uint8_t dev_id,
 		return -ENOMEM;
 	}
 	rte_spinlock_init(&rx_adapter->rx_lock);
+	TAILQ_INIT(&rx_adapter->vector_list);
 	for (i = 0; i < RTE_MAX_ETHPORTS; i++)
 		rx_adapter->eth_devices[i].dev = &rte_eth_devices[i];
 
@@ -2409,3 +2662,125 @@ rte_event_eth_rx_adapter_cb_register(uint8_t id,
 
 	return 0;
 }
+
+static void
+rxa_sw_vector_limits(struct rte_event_eth_rx_adapter_vector_limits *limits)
+{
+	limits->min_sz = RXA_MIN_VECTOR_SZ;
+	limits->max_sz = RXA_MAX_VECTOR_SZ;
+	limits->min_timeout_ns = RXA_MIN_VECTOR_NS;
+	limits->max_timeout_ns = RXA_MAX_VECTOR_NS;
+}
+
+static int
+rxa_vector_caps_check(uint8_t dev_id, uint16_t eth_dev_id)
+{
+	uint32_t cap;
+	int ret;
+
+	ret = rte_event_eth_rx_adapter_caps_get(dev_id, eth_dev_id, &cap);
+	if (ret) {
+		RTE_EDEV_LOG_ERR("Failed to get adapter caps edev %" PRIu8
+			"eth port %" PRIu16, dev_id, eth_dev_id);
+		return ret;
+	}
+
+	if ((cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_EVENT_VECTOR) == 0 ||
+			(cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_INTERNAL_PORT)) {
+		RTE_EDEV_LOG_ERR("Event vectors are not supported,"
+				" eth port: %" PRIu16, eth_dev_id);
+		return -ENOTSUP;
+	}
+
+	return 0;
+}
+
+int
+rte_event_eth_rx_adapter_vector_limits_get(uint8_t dev_id,
+	uint16_t eth_port_id,
+	struct rte_event_eth_rx_adapter_vector_limits *limits)
+{
+	int ret;
+
+	RTE_EVENTDEV_VALID_DEVID_OR_ERR_RET(dev_id, -EINVAL);
+	RTE_ETH_VALID_PORTID_OR_ERR_RET(eth_port_id, -EINVAL);
+
+	if (limits == NULL)
+		return -EINVAL;
+
+	ret = rxa_vector_caps_check(dev_id, eth_port_id);
+	if (ret)
+		return ret;
+
+	rxa_sw_vector_limits(limits);
+	return 0;
+}
+
+int
+rte_event_eth_rx_adapter_queue_event_vector_config(uint8_t id,
+	uint16_t eth_dev_id, int32_t rx_queue_id,
+	const struct rte_event_eth_rx_adapter_event_vector_config *config)
+{
+	struct rte_event_eth_rx_adapter_vector_limits limits;
+	struct rte_event_eth_rx_adapter *rx_adapter;
+	struct eth_device_info *dev_info;
+	struct eth_rx_queue_info *queue_info;
+	uint16_t nb_rx_queues;
+	uint16_t i;
+	int ret;
+
+	RTE_EVENT_ETH_RX_ADAPTER_ID_VALID_OR_ERR_RET(id, -EINVAL);
+	RTE_ETH_VALID_PORTID_OR_ERR_RET(eth_dev_id, -EINVAL);
+
+	rx_adapter = rxa_id_to_adapter(id);
+	if (rx_adapter == NULL || config == NULL)
+		return -EINVAL;
+
+	ret = rxa_vector_caps_check(rx_adapter->eventdev_id, eth_dev_id);
+	if (ret)
+		return ret;
+
+	if (config->vector_sz != 0) {
+		rxa_sw_vector_limits(&limits);
+		if (config->vector_sz < limits.min_sz ||
+				config->vector_sz > limits.max_sz ||
+				config->vector_timeout_ns <
+				limits.min_timeout_ns ||
+				config->vector_timeout_ns >
+				limits.max_timeout_ns) {
+			RTE_EDEV_LOG_ERR("Invalid vector size %" PRIu16
+				" or timeout %" PRIu64,
+				config->vector_sz, config->vector_timeout_ns);
+			return -EINVAL;
+		}
+		if (config->vector_mp == NULL ||
+				config->vector_mp->elt_size <
+				sizeof(struct rte_event_vector) +
+				config->vector_sz * sizeof(uintptr_t)) {
+			RTE_EDEV_LOG_ERR("Invalid vector mempool");
+			return -EINVAL;
+		}
+	}
+
+	dev_info = &rx_adapter->eth_devices[eth_dev_id];
+	nb_rx_queues = dev_info->dev->data->nb_rx_queues;
+	if (dev_info->rx_queue == NULL || (rx_queue_id != -1 &&
+			((uint16_t)rx_queue_id >= nb_rx_queues ||
+			!dev_info->rx_queue[rx_queue_id].queue_enabled))) {
+		RTE_EDEV_LOG_ERR("Rx queue %" PRId32 " of eth port %" PRIu16
+			" is not added", rx_queue_id, eth_dev_id);
+		return -EINVAL;
+	}
+
+	rte_spinlock_lock(&rx_adapter->rx_lock);
+	for (i = 0; i < nb_rx_queues && ret == 0; i++) {
+		if (rx_queue_id != -1 && i != rx_queue_id)
+			continue;
+		queue_info = &dev_info->rx_queue[i];
+		if (queue_info->queue_enabled)
+			ret = rxa_vector_config(rx_adapter, queue_info, config);
+	}
+	rte_spinlock_unlock(&rx_adapter->rx_lock);
+
+	return ret;
+}
@@ -37,6 +37,8 @@
  *  - rte_event_eth_rx_adapter_stop()
  *  - rte_event_eth_rx_adapter_stats_get()
  *  - rte_event_eth_rx_adapter_stats_reset()
+ *  - rte_event_eth_rx_adapter_queue_event_vector_config()
+ *  - rte_event_eth_rx_adapter_vector_limits_get()
  *
  * The application creates an ethernet to event adapter using
  * rte_event_eth_rx_adapter_create_ext() or rte_event_eth_rx_adapter_create()
@@ -77,6 +79,13 @@
  * allows the application to register a callback that selects which packets are
  * enqueued to the event device by the SW adapter. The callback interface is
  * event based so the callback can also modify the event data if it needs to.
+ *
+ * To reduce the per packet scheduling cost, the application can configure
+ * an Rx queue with rte_event_eth_rx_adapter_queue_event_vector_config() so
+ * that the adapter aggregates the mbufs of a flow into event vectors, of
+ * type RTE_EVENT_TYPE_ETH_RX_ADAPTER_VECTOR. A vector is enqueued once it
+ * holds the configured number of mbufs, or when its oldest mbuf has waited
+ * for the configured timeout.
  */
 
 #ifdef __cplusplus
@@ -203,6 +212,42 @@ struct rte_event_eth_rx_adapter_stats {
 	/**< Received packet count for interrupt mode Rx queues */
 };
 
+/**
+ * Event vector configuration of an Rx queue.
+ * @see rte_event_eth_rx_adapter_queue_event_vector_config()
+ */
+struct rte_event_eth_rx_adapter_event_vector_config {
+	uint16_t vector_sz;
+	/**< Maximum number of mbufs of an event vector, 0 to disable the
+	 * aggregation. It must be within the limits returned by
+	 * rte_event_eth_rx_adapter_vector_limits_get().
+	 */
+	uint64_t vector_timeout_ns;
+	/**< Maximum time in nanoseconds a vector waits to be filled, from the
+	 * reception of its first mbuf, before being enqueued.
+	 */
+	struct rte_mempool *vector_mp;
+	/**< Mempool the vectors are allocated from, its elements must hold at
+	 * least vector_sz mbufs.
+	 * @see rte_event_vector_pool_create()
+	 */
+};
+
+/**
+ * Event vector limits of an Rx adapter.
+ * @see rte_event_eth_rx_adapter_vector_limits_get()
+ */
+struct rte_event_eth_rx_adapter_vector_limits {
+	uint16_t min_sz;
+	/**< Minimum vector size */
+	uint16_t max_sz;
+	/**< Maximum vector size */
+	uint64_t min_timeout_ns;
+	/**< Minimum vector timeout in nanoseconds */
+	uint64_t max_timeout_ns;
+	/**< Maximum vector timeout in nanoseconds */
+};
+
 /**
  *
  * Callback function invoked by the SW adapter before it continues
@@ -214,6 +259,8 @@ struct rte_event_eth_rx_adapter_stats {
  * adapter populates the event information based on the Rx queue
  * configuration in the adapter. The callback can modify the this event
  * information for the events to be enqueued by the SW adapter.
+ * The callback is not invoked for the Rx queues aggregating mbufs into
+ * event vectors.
  *
  * The callback return value is the number of events from the
  * beginning of the event array that are to be enqueued by
@@ -471,6 +518,66 @@ int rte_event_eth_rx_adapter_cb_register(uint8_t id, uint16_t eth_dev_id,
 					 rte_event_eth_rx_adapter_cb_fn cb_fn,
 					 void *cb_arg);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Configure the aggregation of the mbufs received on an Rx queue into event
+ * vectors. This is supported when the adapter capabilities of the event and
+ * the ethernet devices have RTE_EVENT_ETH_RX_ADAPTER_CAP_EVENT_VECTOR set,
+ * and the adapter uses a service function.
+ *
+ * The adapter keeps a vector open per flow identifier of the queue; the
+ * flow identifier, event queue, priority and scheduling type of a vector
+ * event are those of the mbuf events it replaces. The vectors have
+ * attr_valid set, with the ethernet port and Rx queue of the mbufs.
+ * The mbufs of the vectors open when the aggregation is reconfigured or
+ * disabled, or when the queue is deleted, are freed and accounted as
+ * dropped.
+ *
+ * @param id
+ *  Adapter identifier.
+ * @param eth_dev_id
+ *  Port identifier of Ethernet device.
+ * @param rx_queue_id
+ *  Ethernet device receive queue index, the queue must have been added to
+ *  the adapter. If rx_queue_id is -1, then all the added Rx queues of the
+ *  device are configured.
+ * @param config
+ *  Event vector configuration.
+ * @return
+ *  - 0: Success
+ *  - -EINVAL: Invalid parameters, or the queue is not added to the adapter.
+ *  - -ENOTSUP: Event vectors are not supported for this ethernet device.
+ */
+__rte_experimental
+int rte_event_eth_rx_adapter_queue_event_vector_config(uint8_t id,
+	uint16_t eth_dev_id, int32_t rx_queue_id,
+	const struct rte_event_eth_rx_adapter_event_vector_config *config);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Retrieve the event vector limits of an Rx adapter of an event device for
+ * an ethernet device.
+ *
+ * @param dev_id
+ *  Event device identifier.
+ * @param eth_port_id
+ *  Port identifier of Ethernet device.
+ * @param[out] limits
+ *  A pointer to the structure to fill with the limits.
+ * @return
+ *  - 0: Success
+ *  - -EINVAL: Invalid parameters.
+ *  - -ENOTSUP: Event vectors are not supported for this ethernet device.
+ */
+__rte_experimental
+int rte_event_eth_rx_adapter_vector_limits_get(uint8_t dev_id,
+	uint16_t eth_port_id,
+	struct rte_event_eth_rx_adapter_vector_limits *limits);
+
 #ifdef __cplusplus
 }
 #endif
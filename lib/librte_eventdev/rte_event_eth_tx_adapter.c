@@ -509,12 +509,53 @@ txa_service_buffer_retry(struct rte_mbuf **pkts, uint16_t unsent,
 	stats->tx_dropped += unsent - sent;
 }
 
+static inline uint16_t
+txa_service_tx_mbuf(struct txa_service_data *txa, struct rte_mbuf *m,
+	uint16_t port, uint16_t queue)
+{
+	struct txa_service_queue_info *tqi;
+
+	tqi = txa_service_queue(txa, port, queue);
+	if (unlikely(tqi == NULL || !tqi->added)) {
+		rte_pktmbuf_free(m);
+		return 0;
+	}
+
+	return rte_eth_tx_buffer(port, queue, tqi->tx_buf, m);
+}
+
+/* Transmit the mbufs of a vector event, to the port and queue of the vector
+ * if it has valid attributes, else to those of each mbuf, and free it.
+ */
+static inline uint16_t
+txa_service_tx_vector(struct txa_service_data *txa,
+	struct rte_event_vector *vec)
+{
+	struct rte_mbuf **mbufs = vec->mbufs;
+	uint16_t nb_tx = 0;
+	uint16_t i;
+
+	if (vec->attr_valid) {
+		for (i = 0; i < vec->nb_elem; i++)
+			nb_tx += txa_service_tx_mbuf(txa, mbufs[i], vec->port,
+					vec->queue);
+	} else {
+		for (i = 0; i < vec->nb_elem; i++)
+			nb_tx += txa_service_tx_mbuf(txa, mbufs[i],
+				mbufs[i]->port,
+				rte_event_eth_tx_adapter_txq_get(mbufs[i]));
+	}
+
+	rte_mempool_put(rte_mempool_from_obj(vec), vec);
+	return nb_tx;
+}
+
 static void
 txa_service_tx(struct txa_service_data *txa, struct rte_event *ev,
 	uint32_t n)
 {
 	uint32_t i;
-	uint16_t nb_tx;
+	uint32_t nb_tx;
 	struct rte_event_eth_tx_adapter_stats *stats;
 
 	stats = &txa->stats;
@@ -522,21 +563,15 @@ txa_service_tx(struct txa_service_data *txa, struct rte_event *ev,
 	nb_tx = 0;
 	for (i = 0; i < n; i++) {
 		struct rte_mbuf *m;
-		uint16_t port;
-		uint16_t queue;
-		struct txa_service_queue_info *tqi;
-
-		m = ev[i].mbuf;
-		port = m->port;
-		queue = rte_event_eth_tx_adapter_txq_get(m);
 
-		tqi = txa_service_queue(txa, port, queue);
-		if (unlikely(tqi == NULL || !tqi->added)) {
-			rte_pktmbuf_free(m);
+		if (ev[i].event_type & RTE_EVENT_TYPE_VECTOR) {
+			nb_tx += txa_service_tx_vector(txa, ev[i].vec);
 			continue;
 		}
 
-		nb_tx += rte_eth_tx_buffer(port, queue, tqi->tx_buf, m);
+		m = ev[i].mbuf;
+		nb_tx += txa_service_tx_mbuf(txa, m, m->port,
+				rte_event_eth_tx_adapter_txq_get(m));
 	}
 
 	stats->tx_packets += nb_tx;
@@ -549,7 +584,7 @@ txa_service_func(void *args)
 	uint8_t dev_id;
 	uint8_t port;
 	uint16_t n;
-	uint32_t nb_tx, max_nb_tx;
+	uint32_t nb_tx, nb_ev, max_nb_tx;
 	struct rte_event ev[TXA_BATCH_SIZE];
 
 	dev_id = txa->eventdev_id;
@@ -557,10 +592,10 @@ txa_service_func(void *args)
 	port = txa->port_id;
 
 	if (txa->nb_queues == 0)
-		return 0;
+		return -EAGAIN;
 
 	if (!rte_spinlock_trylock(&txa->tx_lock))
-		return 0;
+		return -EAGAIN;
 
 	for (nb_tx = 0; nb_tx < max_nb_tx; nb_tx += n) {
 
@@ -569,6 +604,7 @@ txa_service_func(void *args)
 			break;
 		txa_service_tx(txa, ev, n);
 	}
+	nb_ev = nb_tx;
 
 	if ((txa->loop_cnt++ & (TXA_FLUSH_THRESHOLD - 1)) == 0) {
 
@@ -601,9 +637,10 @@ txa_service_func(void *args)
 		}
 
 		txa->stats.tx_packets += nb_tx;
+		nb_ev += nb_tx;
 	}
 	rte_spinlock_unlock(&txa->tx_lock);
-	return 0;
+	return nb_ev == 0 ? -EAGAIN : 0;
 }
 
 static int
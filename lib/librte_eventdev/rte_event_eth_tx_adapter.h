@@ -68,6 +68,13 @@
  * and rte_event_eth_tx_adapter_txq_get() functions to access the transmit
  * queue index, using these macros will help with minimizing application
  * impact due to a change in how the transmit queue index is specified.
+ *
+ * An event with the RTE_EVENT_TYPE_VECTOR bit set in its type carries a
+ * vector of mbufs, they are transmitted on the port and queue of the
+ * vector if its attr_valid bit is set, else on those of each mbuf. The
+ * vector is then returned to its mempool. The adapter service function
+ * always supports vector events, an adapter using an internal port does if
+ * the #RTE_EVENT_ETH_TX_ADAPTER_CAP_EVENT_VECTOR capability is set.
  */
 
 #ifdef __cplusplus
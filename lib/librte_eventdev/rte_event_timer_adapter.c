@@ -741,9 +741,10 @@ swtim_service_func(void *arg)
 		sw->stats.ev_enq_count += nb_evs_flushed;
 		sw->stats.ev_inv_count += nb_evs_invalid;
 		sw->stats.adapter_tick_count++;
+		return 0;
 	}
 
-	return 0;
+	return -EAGAIN;
 }
 
 /* The adapter initialization function rounds the mempool size up to the next
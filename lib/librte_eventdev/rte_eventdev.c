@@ -32,6 +32,8 @@
 #include <rte_ethdev.h>
 #include <rte_cryptodev.h>
 #include <rte_cryptodev_pmd.h>
+#include <rte_mempool.h>
+#include <rte_mbuf_pool_ops.h>
 
 #include "rte_eventdev.h"
 #include "rte_eventdev_pmd.h"
@@ -1278,6 +1280,46 @@ rte_event_dev_close(uint8_t dev_id)
 	return (*dev->dev_ops->dev_close)(dev);
 }
 
+struct rte_mempool *
+rte_event_vector_pool_create(const char *name, unsigned int n,
+			     unsigned int cache_size, uint16_t nb_elem,
+			     int socket_id)
+{
+	struct rte_mempool *mp;
+	unsigned int elt_sz;
+	int ret;
+
+	if (nb_elem == 0) {
+		RTE_EDEV_LOG_ERR("Invalid number of elements=%u", nb_elem);
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	elt_sz = sizeof(struct rte_event_vector) +
+		(nb_elem * sizeof(uintptr_t));
+	mp = rte_mempool_create_empty(name, n, elt_sz, cache_size, 0,
+				      socket_id, 0);
+	if (mp == NULL)
+		return NULL;
+
+	ret = rte_mempool_set_ops_byname(mp, rte_mbuf_best_mempool_ops(),
+					 NULL);
+	if (ret != 0) {
+		RTE_EDEV_LOG_ERR("error setting mempool handler");
+		goto err;
+	}
+
+	ret = rte_mempool_populate_default(mp);
+	if (ret < 0)
+		goto err;
+
+	return mp;
+err:
+	rte_mempool_free(mp);
+	rte_errno = -ret;
+	return NULL;
+}
+
 static inline int
 rte_eventdev_data_alloc(uint8_t dev_id, struct rte_eventdev_data **data,
 		int socket_id)
@@ -1295,6 +1337,9 @@ rte_eventdev_data_alloc(uint8_t dev_id, struct rte_eventdev_data **data,
 		mz = rte_memzone_reserve(mz_name,
 				sizeof(struct rte_eventdev_data),
 				socket_id, 0);
+		/* a warm restarted primary takes over the previous one */
+		if (mz == NULL && rte_eal_warm_restarted())
+			mz = rte_memzone_lookup(mz_name);
 	} else
 		mz = rte_memzone_lookup(mz_name);
 
@@ -211,9 +211,11 @@ extern "C" {
 #endif
 
 #include <rte_common.h>
+#include <rte_compat.h>
 #include <rte_config.h>
 #include <rte_memory.h>
 #include <rte_errno.h>
+#include <rte_lcore.h>
 
 struct rte_mbuf; /* we just use mbuf pointers; no need to include rte_mbuf.h */
 struct rte_event;
@@ -949,6 +951,26 @@ rte_event_dev_close(uint8_t dev_id);
  */
 #define RTE_EVENT_TYPE_ETH_RX_ADAPTER   0x4
 /**< The event generated from event eth Rx adapter */
+#define RTE_EVENT_TYPE_VECTOR           0x8
+/**< Indicates that event is a vector.
+ * All vector event types should be a logical OR of EVENT_TYPE_VECTOR.
+ * This simplifies the pipeline design as one can split processing the events
+ * between vector events and normal event across event types.
+ * Example:
+ *	if (ev.event_type & RTE_EVENT_TYPE_VECTOR) {
+ *		// Classify and handle vector event.
+ *	} else {
+ *		// Classify and handle event.
+ *	}
+ */
+#define RTE_EVENT_TYPE_ETHDEV_VECTOR                                          \
+	(RTE_EVENT_TYPE_VECTOR | RTE_EVENT_TYPE_ETHDEV)
+/**< The event vector generated from ethdev subsystem */
+#define RTE_EVENT_TYPE_CPU_VECTOR (RTE_EVENT_TYPE_VECTOR | RTE_EVENT_TYPE_CPU)
+/**< The event vector generated from cpu for pipelining. */
+#define RTE_EVENT_TYPE_ETH_RX_ADAPTER_VECTOR                                  \
+	(RTE_EVENT_TYPE_VECTOR | RTE_EVENT_TYPE_ETH_RX_ADAPTER)
+/**< The event vector generated from eth Rx adapter. */
 #define RTE_EVENT_TYPE_MAX              0x10
 /**< Maximum number of event types */
 
@@ -998,6 +1020,54 @@ rte_event_dev_close(uint8_t dev_id);
  *
  */
 
+/**
+ * Event vector structure.
+ *
+ * A vector event carries an array of objects, e.g. mbufs sharing a flow,
+ * so that they are scheduled and processed with a single event. It is
+ * allocated from a mempool created with rte_event_vector_pool_create(),
+ * and must be returned to it once the objects have been consumed.
+ */
+struct rte_event_vector {
+	uint16_t nb_elem;
+	/**< Number of elements in this event vector. */
+	uint16_t rsvd : 15;
+	/**< Reserved for future use */
+	uint16_t attr_valid : 1;
+	/**< Indicates that the below union attributes have valid information.
+	 */
+	RTE_STD_C11
+	union {
+		/* Used by Rx/Tx adapter.
+		 * Indicates that all the elements in this vector belong to the
+		 * same port and queue pair when originating from the Rx
+		 * adapter, valid only when the event type is
+		 * RTE_EVENT_TYPE_ETH_RX_ADAPTER_VECTOR or
+		 * RTE_EVENT_TYPE_ETHDEV_VECTOR.
+		 * Can also be used to tell the Tx adapter the destination
+		 * port and queue of all the mbufs of the vector.
+		 */
+		struct {
+			uint16_t port;
+			/**< Ethernet device port identifier */
+			uint16_t queue;
+			/**< Ethernet device queue identifier */
+		};
+	};
+	uint64_t impl_opaque;
+	/**< Implementation specific opaque value. */
+	RTE_STD_C11
+	union {
+		struct rte_mbuf *mbufs[0];
+		void *ptrs[0];
+		uint64_t u64s[0];
+	} __rte_aligned(16);
+	/**< Start of the vector array union. Depending upon the event type the
+	 * vector array can be an array of mbufs or pointers or opaque u64
+	 * values.
+	 */
+} __rte_aligned(16);
+
 /**
  * The generic *rte_event* structure to hold the event attributes
  * for dequeue and enqueue operation
@@ -1071,9 +1141,49 @@ struct rte_event {
 		/**< Opaque event pointer */
 		struct rte_mbuf *mbuf;
 		/**< mbuf pointer if dequeued event is associated with mbuf */
+		struct rte_event_vector *vec;
+		/**< Event vector pointer, valid when the event type is a
+		 * vector event type.
+		 * @see RTE_EVENT_TYPE_VECTOR
+		 */
 	};
 };
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Create a mempool of event vectors.
+ *
+ * The objects of the mempool are *rte_event_vector* structures followed by
+ * room for *nb_elem* elements, they are not initialized. The mempool uses
+ * the same handler as the mbuf pools, as vectors are allocated and freed
+ * at the packet rate.
+ *
+ * @param name
+ *   The name of the mempool.
+ * @param n
+ *   The number of event vectors in the mempool.
+ * @param cache_size
+ *   Size of the per-lcore object cache, see rte_mempool_create().
+ * @param nb_elem
+ *   The maximum number of elements of an event vector.
+ * @param socket_id
+ *   The socket identifier where the memory should be allocated, or
+ *   SOCKET_ID_ANY.
+ * @return
+ *   The pointer to the new mempool, or NULL on error with rte_errno set:
+ *    - EINVAL: nb_elem is 0.
+ *    - ENOSPC: the maximum number of memzones has already been allocated.
+ *    - EEXIST: a memzone with the same name already exists.
+ *    - ENOMEM: no appropriate memory area found.
+ */
+__rte_experimental
+struct rte_mempool *
+rte_event_vector_pool_create(const char *name, unsigned int n,
+			     unsigned int cache_size, uint16_t nb_elem,
+			     int socket_id);
+
 /* Ethdev Rx adapter capability bitmap flags */
 #define RTE_EVENT_ETH_RX_ADAPTER_CAP_INTERNAL_PORT	0x1
 /**< This flag is sent when the packet transfer mechanism is in HW.
@@ -1090,6 +1200,11 @@ struct rte_event {
  * @see struct rte_event_eth_rx_adapter_queue_conf::ev
  * @see struct rte_event_eth_rx_adapter_queue_conf::rx_queue_flags
  */
+#define RTE_EVENT_ETH_RX_ADAPTER_CAP_EVENT_VECTOR	0x8
+/**< The adapter can aggregate the mbufs of a flow received on an ethdev
+ * Rx queue into event vectors.
+ * @see rte_event_eth_rx_adapter_queue_event_vector_config()
+ */
 
 /**
  * Retrieve the event device's ethdev Rx adapter capabilities for the
@@ -1186,6 +1301,10 @@ rte_event_crypto_adapter_caps_get(uint8_t dev_id, uint8_t cdev_id,
 #define RTE_EVENT_ETH_TX_ADAPTER_CAP_INTERNAL_PORT	0x1
 /**< This flag is sent when the PMD supports a packet transmit callback
  */
+#define RTE_EVENT_ETH_TX_ADAPTER_CAP_EVENT_VECTOR	0x2
+/**< This flag is sent when the PMD packet transmit callback supports vector
+ * events. The adapter service function always supports them.
+ */
 
 /**
  * Retrieve the event device's eth Tx adapter capabilities
@@ -1608,6 +1727,7 @@ rte_event_dequeue_burst(uint8_t dev_id, uint8_t port_id, struct rte_event ev[],
 			uint16_t nb_events, uint64_t timeout_ticks)
 {
 	struct rte_eventdev *dev = &rte_eventdevs[dev_id];
+	uint16_t nb_rx;
 
 #ifdef RTE_LIBRTE_EVENTDEV_DEBUG
 	if (dev_id >= RTE_EVENT_MAX_DEVS || !rte_eventdevs[dev_id].attached) {
@@ -1626,12 +1746,16 @@ rte_event_dequeue_burst(uint8_t dev_id, uint8_t port_id, struct rte_event ev[],
 	 * requests nb_events as const one
 	 */
 	if (nb_events == 1)
-		return (*dev->dequeue)(
+		nb_rx = (*dev->dequeue)(
 			dev->data->ports[port_id], ev, timeout_ticks);
 	else
-		return (*dev->dequeue_burst)(
+		nb_rx = (*dev->dequeue_burst)(
 			dev->data->ports[port_id], ev, nb_events,
 				timeout_ticks);
+
+	RTE_LCORE_BUSYNESS_UPDATE(nb_rx);
+
+	return nb_rx;
 }
 
 /**
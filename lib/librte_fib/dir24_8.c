@@ -15,6 +15,8 @@
 #include <rte_errno.h>
 #include <rte_memory.h>
 #include <rte_branch_prediction.h>
+#include <rte_cpuflags.h>
+#include <rte_vect.h>
 
 #include <rte_fib.h>
 #include <rte_rib.h>
@@ -26,6 +28,11 @@
 #define DIR24_8_TBL8_GRP_NUM_ENT	256U
 #define DIR24_8_EXT_ENT			1
 #define DIR24_8_TBL24_MASK		0xffffff00
+/*
+ * Vector lookup gathers 32 bit words for 1 and 2 byte entries,
+ * so the tables are padded to not read past their end.
+ */
+#define DIR24_8_TBL_PAD			sizeof(uint32_t)
 
 #define BITMAP_SLAB_BIT_SIZE_LOG2	6
 #define BITMAP_SLAB_BIT_SIZE		(1 << BITMAP_SLAB_BIT_SIZE_LOG2)
@@ -45,12 +52,13 @@ struct dir24_8_tbl {
 
 #define ROUNDUP(x, y)	 RTE_ALIGN_CEIL(x, (1 << (32 - y)))
 
-enum lookup_type {
-	MACRO,
-	INLINE,
-	UNI
+/* Counters saved with the tables by dir24_8_save() */
+struct dir24_8_snapshot {
+	uint32_t	number_tbl8s;
+	uint32_t	rsvd_tbl8s;
+	uint32_t	cur_tbl8s;
+	uint32_t	nh_sz;
 };
-enum lookup_type test_lookup = MACRO;
 
 static inline void *
 get_tbl24_p(struct dir24_8_tbl *dp, uint32_t ip, uint8_t nh_sz)
@@ -252,36 +260,228 @@ dir24_8_lookup_bulk_uni(void *p, const uint32_t *ips,
 	}
 }
 
+#if defined(RTE_MACHINE_CPUFLAG_AVX512F)
+/*
+ * Lookup 16 addresses at once with 1, 2 or 4 byte entries. The tbl24
+ * entries are gathered for all of them and a second masked gather
+ * resolves the ones pointing to a tbl8 group.
+ */
+static __rte_always_inline void
+dir24_8_vec_lookup_x16(struct dir24_8_tbl *dp, const uint32_t *ips,
+	uint64_t *next_hops, int size)
+{
+	const __m512i zero = _mm512_setzero_si512();
+	const __m512i lsb = _mm512_set1_epi32(1);
+	const __m512i lsbyte_msk = _mm512_set1_epi32(UINT8_MAX);
+	__m512i ip_vec, idxes, res, res_msk = zero;
+	__mmask16 msk_ext;
+
+	if (size == sizeof(uint8_t))
+		res_msk = _mm512_set1_epi32(UINT8_MAX);
+	else if (size == sizeof(uint16_t))
+		res_msk = _mm512_set1_epi32(UINT16_MAX);
+
+	ip_vec = _mm512_loadu_si512(ips);
+	idxes = _mm512_srli_epi32(ip_vec, 8);
+
+	/* scale has to be a constant, so each size has its own gather */
+	if (size == sizeof(uint8_t))
+		res = _mm512_i32gather_epi32(idxes, (const void *)dp->tbl24, 1);
+	else if (size == sizeof(uint16_t))
+		res = _mm512_i32gather_epi32(idxes, (const void *)dp->tbl24, 2);
+	else
+		res = _mm512_i32gather_epi32(idxes, (const void *)dp->tbl24, 4);
+	if (size != sizeof(uint32_t))
+		res = _mm512_and_epi32(res, res_msk);
+
+	msk_ext = _mm512_test_epi32_mask(res, lsb);
+	if (msk_ext != 0) {
+		idxes = _mm512_srli_epi32(res, 1);
+		idxes = _mm512_slli_epi32(idxes, 8);
+		idxes = _mm512_add_epi32(idxes,
+			_mm512_and_epi32(ip_vec, lsbyte_msk));
+		if (size == sizeof(uint8_t))
+			res = _mm512_mask_i32gather_epi32(res, msk_ext, idxes,
+				(const void *)dp->tbl8, 1);
+		else if (size == sizeof(uint16_t))
+			res = _mm512_mask_i32gather_epi32(res, msk_ext, idxes,
+				(const void *)dp->tbl8, 2);
+		else
+			res = _mm512_mask_i32gather_epi32(res, msk_ext, idxes,
+				(const void *)dp->tbl8, 4);
+		if (size != sizeof(uint32_t))
+			res = _mm512_and_epi32(res, res_msk);
+	}
+
+	res = _mm512_srli_epi32(res, 1);
+	_mm512_storeu_si512(next_hops,
+		_mm512_cvtepu32_epi64(_mm512_castsi512_si256(res)));
+	_mm512_storeu_si512(next_hops + 8,
+		_mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(res, 1)));
+}
+
+/* Lookup 8 addresses at once with 8 byte entries. */
+static __rte_always_inline void
+dir24_8_vec_lookup_x8_8b(struct dir24_8_tbl *dp, const uint32_t *ips,
+	uint64_t *next_hops)
+{
+	const __m512i lsb = _mm512_set1_epi64(1);
+	const __m512i lsbyte_msk = _mm512_set1_epi64(UINT8_MAX);
+	__m256i ip_vec;
+	__m512i idxes, res;
+	__mmask8 msk_ext;
+
+	ip_vec = _mm256_loadu_si256((const void *)ips);
+	res = _mm512_i32gather_epi64(_mm256_srli_epi32(ip_vec, 8),
+		(const void *)dp->tbl24, 8);
+
+	msk_ext = _mm512_test_epi64_mask(res, lsb);
+	if (msk_ext != 0) {
+		idxes = _mm512_srli_epi64(res, 1);
+		idxes = _mm512_slli_epi64(idxes, 8);
+		idxes = _mm512_add_epi64(idxes, _mm512_and_epi64(
+			_mm512_cvtepu32_epi64(ip_vec), lsbyte_msk));
+		res = _mm512_mask_i64gather_epi64(res, msk_ext, idxes,
+			(const void *)dp->tbl8, 8);
+	}
+
+	_mm512_storeu_si512(next_hops, _mm512_srli_epi64(res, 1));
+}
+
+static void
+dir24_8_vec_lookup_bulk_1b(void *p, const uint32_t *ips,
+	uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+
+	for (i = 0; i < (n / 16); i++)
+		dir24_8_vec_lookup_x16(p, ips + i * 16, next_hops + i * 16,
+			sizeof(uint8_t));
+	dir24_8_lookup_bulk_1b(p, ips + i * 16, next_hops + i * 16,
+		n - i * 16);
+}
+
+static void
+dir24_8_vec_lookup_bulk_2b(void *p, const uint32_t *ips,
+	uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+
+	for (i = 0; i < (n / 16); i++)
+		dir24_8_vec_lookup_x16(p, ips + i * 16, next_hops + i * 16,
+			sizeof(uint16_t));
+	dir24_8_lookup_bulk_2b(p, ips + i * 16, next_hops + i * 16,
+		n - i * 16);
+}
+
+static void
+dir24_8_vec_lookup_bulk_4b(void *p, const uint32_t *ips,
+	uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+
+	for (i = 0; i < (n / 16); i++)
+		dir24_8_vec_lookup_x16(p, ips + i * 16, next_hops + i * 16,
+			sizeof(uint32_t));
+	dir24_8_lookup_bulk_4b(p, ips + i * 16, next_hops + i * 16,
+		n - i * 16);
+}
+
+static void
+dir24_8_vec_lookup_bulk_8b(void *p, const uint32_t *ips,
+	uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+
+	for (i = 0; i < (n / 8); i++)
+		dir24_8_vec_lookup_x8_8b(p, ips + i * 8, next_hops + i * 8);
+	dir24_8_lookup_bulk_8b(p, ips + i * 8, next_hops + i * 8, n - i * 8);
+}
+
+static rte_fib_lookup_fn_t
+get_vector_fn(struct dir24_8_tbl *dp)
+{
+	if (!rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F))
+		return NULL;
+	/* tbl8 indexes of 4 byte entries are gathered as signed 32 bit */
+	if ((dp->nh_sz == RTE_FIB_DIR24_8_4B) &&
+			(dp->number_tbl8s >= (1U << 23)))
+		return NULL;
+
+	switch (dp->nh_sz) {
+	case RTE_FIB_DIR24_8_1B:
+		return dir24_8_vec_lookup_bulk_1b;
+	case RTE_FIB_DIR24_8_2B:
+		return dir24_8_vec_lookup_bulk_2b;
+	case RTE_FIB_DIR24_8_4B:
+		return dir24_8_vec_lookup_bulk_4b;
+	case RTE_FIB_DIR24_8_8B:
+		return dir24_8_vec_lookup_bulk_8b;
+	}
+	return NULL;
+}
+#else
+static rte_fib_lookup_fn_t
+get_vector_fn(__rte_unused struct dir24_8_tbl *dp)
+{
+	return NULL;
+}
+#endif
+
+static rte_fib_lookup_fn_t
+get_scalar_fn(enum rte_fib_dir24_8_nh_sz nh_sz)
+{
+	switch (nh_sz) {
+	case RTE_FIB_DIR24_8_1B:
+		return dir24_8_lookup_bulk_1b;
+	case RTE_FIB_DIR24_8_2B:
+		return dir24_8_lookup_bulk_2b;
+	case RTE_FIB_DIR24_8_4B:
+		return dir24_8_lookup_bulk_4b;
+	case RTE_FIB_DIR24_8_8B:
+		return dir24_8_lookup_bulk_8b;
+	}
+	return NULL;
+}
+
+static rte_fib_lookup_fn_t
+get_scalar_fn_inlined(enum rte_fib_dir24_8_nh_sz nh_sz)
+{
+	switch (nh_sz) {
+	case RTE_FIB_DIR24_8_1B:
+		return dir24_8_lookup_bulk_0;
+	case RTE_FIB_DIR24_8_2B:
+		return dir24_8_lookup_bulk_1;
+	case RTE_FIB_DIR24_8_4B:
+		return dir24_8_lookup_bulk_2;
+	case RTE_FIB_DIR24_8_8B:
+		return dir24_8_lookup_bulk_3;
+	}
+	return NULL;
+}
+
 rte_fib_lookup_fn_t
-dir24_8_get_lookup_fn(struct rte_fib_conf *fib_conf)
-{
-	enum rte_fib_dir24_8_nh_sz nh_sz = fib_conf->dir24_8.nh_sz;
-
-	if (test_lookup == MACRO) {
-		switch (nh_sz) {
-		case RTE_FIB_DIR24_8_1B:
-			return dir24_8_lookup_bulk_1b;
-		case RTE_FIB_DIR24_8_2B:
-			return dir24_8_lookup_bulk_2b;
-		case RTE_FIB_DIR24_8_4B:
-			return dir24_8_lookup_bulk_4b;
-		case RTE_FIB_DIR24_8_8B:
-			return dir24_8_lookup_bulk_8b;
-		}
-	} else if (test_lookup == INLINE) {
-		switch (nh_sz) {
-		case RTE_FIB_DIR24_8_1B:
-			return dir24_8_lookup_bulk_0;
-		case RTE_FIB_DIR24_8_2B:
-			return dir24_8_lookup_bulk_1;
-		case RTE_FIB_DIR24_8_4B:
-			return dir24_8_lookup_bulk_2;
-		case RTE_FIB_DIR24_8_8B:
-			return dir24_8_lookup_bulk_3;
-		}
-	} else
+dir24_8_get_lookup_fn(void *p, enum rte_fib_lookup_type type)
+{
+	struct dir24_8_tbl *dp = (struct dir24_8_tbl *)p;
+	enum rte_fib_dir24_8_nh_sz nh_sz = dp->nh_sz;
+	rte_fib_lookup_fn_t ret_fn;
+
+	switch (type) {
+	case RTE_FIB_LOOKUP_DEFAULT:
+		ret_fn = get_vector_fn(dp);
+		return (ret_fn != NULL) ? ret_fn : get_scalar_fn(nh_sz);
+	case RTE_FIB_LOOKUP_DIR24_8_SCALAR_MACRO:
+		return get_scalar_fn(nh_sz);
+	case RTE_FIB_LOOKUP_DIR24_8_SCALAR_INLINE:
+		return get_scalar_fn_inlined(nh_sz);
+	case RTE_FIB_LOOKUP_DIR24_8_SCALAR_UNI:
 		return dir24_8_lookup_bulk_uni;
-	return NULL;
+	case RTE_FIB_LOOKUP_DIR24_8_VECTOR_AVX512:
+		return get_vector_fn(dp);
+	default:
+		return NULL;
+	}
 }
 
 static void
@@ -688,7 +888,8 @@ dir24_8_create(const char *name, int socket_id, struct rte_fib_conf *fib_conf)
 
 	snprintf(mem_name, sizeof(mem_name), "DP_%s", name);
 	dp = rte_zmalloc_socket(name, sizeof(struct dir24_8_tbl) +
-		DIR24_8_TBL24_NUM_ENT * (1 << nh_sz), RTE_CACHE_LINE_SIZE,
+		DIR24_8_TBL24_NUM_ENT * (1 << nh_sz) + DIR24_8_TBL_PAD,
+		RTE_CACHE_LINE_SIZE,
 		socket_id);
 	if (dp == NULL) {
 		rte_errno = ENOMEM;
@@ -735,3 +936,51 @@ dir24_8_free(void *p)
 	rte_free(dp->tbl8);
 	rte_free(dp);
 }
+
+int
+dir24_8_save(void *p, FILE *f)
+{
+	struct dir24_8_tbl *dp = (struct dir24_8_tbl *)p;
+	struct dir24_8_snapshot snap;
+
+	snap.number_tbl8s = dp->number_tbl8s;
+	snap.rsvd_tbl8s = dp->rsvd_tbl8s;
+	snap.cur_tbl8s = dp->cur_tbl8s;
+	snap.nh_sz = dp->nh_sz;
+
+	/* the tables link by index, they are written as they are */
+	if ((fwrite(&snap, sizeof(snap), 1, f) != 1) ||
+			(fwrite(dp->tbl24, DIR24_8_TBL24_NUM_ENT <<
+			dp->nh_sz, 1, f) != 1) ||
+			(fwrite(dp->tbl8, (DIR24_8_TBL8_GRP_NUM_ENT <<
+			dp->nh_sz) * (dp->number_tbl8s + 1), 1, f) != 1) ||
+			(fwrite(dp->tbl8_idxes, RTE_ALIGN_CEIL(dp->number_tbl8s,
+			64) >> 3, 1, f) != 1))
+		return -EIO;
+	return 0;
+}
+
+int
+dir24_8_restore(void *p, FILE *f)
+{
+	struct dir24_8_tbl *dp = (struct dir24_8_tbl *)p;
+	struct dir24_8_snapshot snap;
+
+	if (fread(&snap, sizeof(snap), 1, f) != 1)
+		return -EIO;
+	if ((snap.number_tbl8s != dp->number_tbl8s) ||
+			(snap.nh_sz != (uint32_t)dp->nh_sz) ||
+			(snap.cur_tbl8s > dp->number_tbl8s))
+		return -EINVAL;
+
+	if ((fread(dp->tbl24, DIR24_8_TBL24_NUM_ENT << dp->nh_sz, 1,
+			f) != 1) ||
+			(fread(dp->tbl8, (DIR24_8_TBL8_GRP_NUM_ENT <<
+			dp->nh_sz) * (dp->number_tbl8s + 1), 1, f) != 1) ||
+			(fread(dp->tbl8_idxes, RTE_ALIGN_CEIL(dp->number_tbl8s,
+			64) >> 3, 1, f) != 1))
+		return -EIO;
+	dp->rsvd_tbl8s = snap.rsvd_tbl8s;
+	dp->cur_tbl8s = snap.cur_tbl8s;
+	return 0;
+}
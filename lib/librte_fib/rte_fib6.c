@@ -4,6 +4,7 @@
  */
 
 #include <stdint.h>
+#include <stdio.h>
 #include <string.h>
 
 #include <rte_eal.h>
@@ -45,6 +46,24 @@ struct rte_fib6 {
 	rte_fib6_lookup_fn_t	lookup;	/**< fib lookup function */
 	rte_fib6_modify_fn_t	modify; /**< modify fib datastruct */
 	uint64_t		def_nh;
+	struct rte_fib6_conf	conf;	/**< configuration, to save the FIB */
+};
+
+/* "FIB6" */
+#define FIB6_SNAPSHOT_MAGIC	0x36424946
+#define FIB6_SNAPSHOT_VERSION	1
+/* Number of routes saved at once */
+#define FIB6_SNAPSHOT_BURST	256
+
+/*
+ * A saved FIB is this header, the routes of the RIB, written by bursts
+ * preceded by their number and ended by an empty burst, then the
+ * dataplane tables.
+ */
+struct fib6_snapshot_hdr {
+	uint32_t		magic;
+	uint32_t		version;
+	struct rte_fib6_conf	conf;
 };
 
 static void
@@ -107,7 +126,8 @@ init_dataplane(struct rte_fib6 *fib, __rte_unused int socket_id,
 		fib->dp = trie_create(dp_name, socket_id, conf);
 		if (fib->dp == NULL)
 			return -rte_errno;
-		fib->lookup = rte_trie_get_lookup_fn(conf);
+		fib->lookup = rte_trie_get_lookup_fn(fib->dp,
+			RTE_FIB6_LOOKUP_DEFAULT);
 		fib->modify = trie_modify;
 		return 0;
 	default:
@@ -214,6 +234,7 @@ rte_fib6_create(const char *name, int socket_id, struct rte_fib6_conf *conf)
 	fib->rib = rib;
 	fib->type = conf->type;
 	fib->def_nh = conf->default_nh;
+	fib->conf = *conf;
 	ret = init_dataplane(fib, socket_id, conf);
 	if (ret < 0) {
 		RTE_LOG(ERR, LPM,
@@ -319,3 +340,140 @@ rte_fib6_get_rib(struct rte_fib6 *fib)
 {
 	return (fib == NULL) ? NULL : fib->rib;
 }
+
+int
+rte_fib6_select_lookup(struct rte_fib6 *fib, enum rte_fib6_lookup_type type)
+{
+	rte_fib6_lookup_fn_t fn;
+
+	if (fib == NULL)
+		return -EINVAL;
+
+	switch (fib->type) {
+	case RTE_FIB6_TRIE:
+		fn = rte_trie_get_lookup_fn(fib->dp, type);
+		if (fn == NULL)
+			return -EINVAL;
+		fib->lookup = fn;
+		return 0;
+	default:
+		return -EINVAL;
+	}
+}
+
+int
+rte_fib6_save(struct rte_fib6 *fib, FILE *f)
+{
+	struct fib6_snapshot_hdr hdr;
+	struct rte_rib6_walk walk;
+	uint8_t ips[FIB6_SNAPSHOT_BURST][RTE_FIB6_IPV6_ADDR_SIZE];
+	uint8_t depths[FIB6_SNAPSHOT_BURST];
+	uint64_t nhs[FIB6_SNAPSHOT_BURST];
+	uint8_t zero_ip[RTE_FIB6_IPV6_ADDR_SIZE] = {0};
+	uint32_t n;
+
+	if ((fib == NULL) || (f == NULL))
+		return -EINVAL;
+
+	memset(&hdr, 0, sizeof(hdr));
+	hdr.magic = FIB6_SNAPSHOT_MAGIC;
+	hdr.version = FIB6_SNAPSHOT_VERSION;
+	hdr.conf = fib->conf;
+	if (fwrite(&hdr, sizeof(hdr), 1, f) != 1)
+		return -EIO;
+
+	rte_rib6_walk_init(fib->rib, &walk, zero_ip, 0);
+	do {
+		n = rte_rib6_walk_bulk(fib->rib, &walk, ips, depths, nhs,
+			FIB6_SNAPSHOT_BURST);
+		if (fwrite(&n, sizeof(n), 1, f) != 1)
+			return -EIO;
+		if (n == 0)
+			break;
+		if ((fwrite(ips, sizeof(ips[0]), n, f) != n) ||
+				(fwrite(depths, sizeof(depths[0]), n, f) != n) ||
+				(fwrite(nhs, sizeof(nhs[0]), n, f) != n))
+			return -EIO;
+	} while (n != 0);
+
+	switch (fib->type) {
+	case RTE_FIB6_TRIE:
+		return trie_save(fib->dp, f);
+	default:
+		return 0;
+	}
+}
+
+struct rte_fib6 *
+rte_fib6_restore(const char *name, int socket_id, FILE *f)
+{
+	struct fib6_snapshot_hdr hdr;
+	struct rte_fib6 *fib;
+	uint8_t ips[FIB6_SNAPSHOT_BURST][RTE_FIB6_IPV6_ADDR_SIZE];
+	uint8_t depths[FIB6_SNAPSHOT_BURST];
+	uint64_t nhs[FIB6_SNAPSHOT_BURST];
+	uint32_t n;
+	int ret = 0;
+
+	if ((name == NULL) || (f == NULL)) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	if (fread(&hdr, sizeof(hdr), 1, f) != 1) {
+		rte_errno = EIO;
+		return NULL;
+	}
+	if ((hdr.magic != FIB6_SNAPSHOT_MAGIC) ||
+			(hdr.version != FIB6_SNAPSHOT_VERSION)) {
+		RTE_LOG(ERR, LPM, "FIB6 %s snapshot format is not supported\n",
+			name);
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	fib = rte_fib6_create(name, socket_id, &hdr.conf);
+	if (fib == NULL)
+		return NULL;
+
+	/* the dataplane is restored as is, only the RIB is rebuilt */
+	do {
+		if (fread(&n, sizeof(n), 1, f) != 1) {
+			ret = -EIO;
+			goto error;
+		}
+		if (n > FIB6_SNAPSHOT_BURST) {
+			ret = -EINVAL;
+			goto error;
+		}
+		if ((n != 0) && ((fread(ips, sizeof(ips[0]), n, f) != n) ||
+				(fread(depths, sizeof(depths[0]), n, f) != n) ||
+				(fread(nhs, sizeof(nhs[0]), n, f) != n))) {
+			ret = -EIO;
+			goto error;
+		}
+		if (rte_rib6_insert_bulk(fib->rib,
+				(const uint8_t (*)[RTE_FIB6_IPV6_ADDR_SIZE])ips,
+				depths, nhs, n) != (int)n) {
+			ret = -rte_errno;
+			goto error;
+		}
+	} while (n != 0);
+
+	switch (fib->type) {
+	case RTE_FIB6_TRIE:
+		ret = trie_restore(fib->dp, f);
+		break;
+	default:
+		break;
+	}
+	if (ret == 0)
+		return fib;
+
+error:
+	RTE_LOG(ERR, LPM, "Can not restore FIB6 %s: %s\n", name,
+		rte_strerror(-ret));
+	rte_fib6_free(fib);
+	rte_errno = -ret;
+	return NULL;
+}
@@ -12,6 +12,8 @@
  * for IPv6 Longest Prefix Match
  */
 
+#include <stdio.h>
+
 #include <rte_compat.h>
 
 #define RTE_FIB6_IPV6_ADDR_SIZE		16
@@ -48,6 +50,16 @@ enum rte_fib_trie_nh_sz {
 	RTE_FIB6_TRIE_8B
 };
 
+/** Type of lookup function implementation */
+enum rte_fib6_lookup_type {
+	RTE_FIB6_LOOKUP_DEFAULT,
+	/**< Selects the fastest implementation supported by the CPU */
+	RTE_FIB6_LOOKUP_TRIE_SCALAR,
+	/**< Scalar lookup function implementation */
+	RTE_FIB6_LOOKUP_TRIE_VECTOR_AVX512
+	/**< Vector implementation using AVX512 gathers */
+};
+
 /** FIB configuration structure */
 struct rte_fib6_conf {
 	enum rte_fib6_type type; /**< Type of FIB struct */
@@ -190,4 +202,63 @@ __rte_experimental
 struct rte_rib6 *
 rte_fib6_get_rib(struct rte_fib6 *fib);
 
+/**
+ * Set lookup function based on type
+ *
+ * The FIB is created with RTE_FIB6_LOOKUP_DEFAULT, which picks the vector
+ * implementation if the CPU supports it.
+ *
+ * @param fib
+ *   FIB object handle
+ * @param type
+ *   type of lookup function
+ *
+ * @return
+ *   0 on success
+ *   -EINVAL if the lookup function is not supported by the FIB type or CPU
+ */
+__rte_experimental
+int
+rte_fib6_select_lookup(struct rte_fib6 *fib, enum rte_fib6_lookup_type type);
+
+/**
+ * Save the FIB to a file, to restore it with rte_fib6_restore() after a
+ * restart. The routes and the lookup tables are written in a format
+ * specific to this DPDK build and CPU architecture.
+ * The FIB must not be modified while it is saved.
+ *
+ * @param fib
+ *   FIB object handle
+ * @param f
+ *   File opened for writing
+ * @return
+ *   0 on success
+ *   -EINVAL for incorrect arguments
+ *   -EIO if the file can not be written
+ */
+__rte_experimental
+int
+rte_fib6_save(struct rte_fib6 *fib, FILE *f);
+
+/**
+ * Create a FIB from a file written by rte_fib6_save().
+ *
+ * The lookup tables are read as they were saved, without adding the
+ * routes again, so a full table is ready to forward much faster than
+ * with rte_fib6_add().
+ *
+ * @param name
+ *  FIB name
+ * @param socket_id
+ *  NUMA socket ID for FIB table memory allocation
+ * @param f
+ *   File opened for reading, positioned at the start of the saved FIB
+ * @return
+ *  Handle to the FIB object on success
+ *  NULL otherwise with rte_errno set to an appropriate values.
+ */
+__rte_experimental
+struct rte_fib6 *
+rte_fib6_restore(const char *name, int socket_id, FILE *f);
+
 #endif /* _RTE_FIB6_H_ */
@@ -15,6 +15,8 @@
 #include <rte_errno.h>
 #include <rte_memory.h>
 #include <rte_branch_prediction.h>
+#include <rte_cpuflags.h>
+#include <rte_vect.h>
 
 #include <rte_rib6.h>
 #include <rte_fib6.h>
@@ -37,6 +39,12 @@
 
 #define TRIE_NAMESIZE		64
 
+/*
+ * Vector lookup gathers 64 bit words for 2 and 4 byte entries,
+ * so the tables are padded to not read past their end.
+ */
+#define TRIE_TBL_PAD		sizeof(uint64_t)
+
 #define BITMAP_SLAB_BIT_SIZE_LOG2	6
 #define BITMAP_SLAB_BIT_SIZE		(1ULL << BITMAP_SLAB_BIT_SIZE_LOG2)
 #define BITMAP_SLAB_BITMASK		(BITMAP_SLAB_BIT_SIZE - 1)
@@ -54,18 +62,20 @@ struct rte_trie_tbl {
 	__extension__ uint64_t	tbl24[0] __rte_cache_aligned;
 };
 
+/* Counters saved with the tables by trie_save() */
+struct trie_snapshot {
+	uint32_t	number_tbl8s;
+	uint32_t	rsvd_tbl8s;
+	uint32_t	cur_tbl8s;
+	uint32_t	tbl8_pool_pos;
+	uint32_t	nh_sz;
+};
+
 enum edge {
 	LEDGE,
 	REDGE
 };
 
-enum lookup_type {
-	MACRO,
-	INLINE,
-	UNI
-};
-static enum lookup_type test_lookup = MACRO;
-
 static inline uint32_t
 get_tbl24_idx(const uint8_t *ip)
 {
@@ -153,25 +163,172 @@ LOOKUP_FUNC(2b, uint16_t, 1)
 LOOKUP_FUNC(4b, uint32_t, 2)
 LOOKUP_FUNC(8b, uint64_t, 3)
 
-rte_fib6_lookup_fn_t
-rte_trie_get_lookup_fn(struct rte_fib6_conf *conf)
-{
-	enum rte_fib_trie_nh_sz nh_sz = conf->trie.nh_sz;
-
-	if (test_lookup == MACRO) {
-		switch (nh_sz) {
-		case RTE_FIB6_TRIE_2B:
-			return rte_trie_lookup_bulk_2b;
-		case RTE_FIB6_TRIE_4B:
-			return rte_trie_lookup_bulk_4b;
-		case RTE_FIB6_TRIE_8B:
-			return rte_trie_lookup_bulk_8b;
-		}
+#if defined(RTE_MACHINE_CPUFLAG_AVX512F)
+/*
+ * Lookup 8 addresses at once. Every step gathers the entries of the
+ * next trie level for the addresses whose entry is still extended,
+ * so the number of steps is the depth of the longest walk.
+ */
+static __rte_always_inline void
+trie_vec_lookup_x8(struct rte_trie_tbl *dp,
+	uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE], uint64_t *next_hops,
+	int size)
+{
+	const __m512i lsb = _mm512_set1_epi64(1);
+	const __m512i lsbyte_msk = _mm512_set1_epi64(UINT8_MAX);
+	const __m512i hi_perm = _mm512_set_epi64(14, 12, 10, 8, 6, 4, 2, 0);
+	const __m512i lo_perm = _mm512_set_epi64(15, 13, 11, 9, 7, 5, 3, 1);
+	__m512i first, second, hi, lo, bytes, idxes, res, res_msk;
+	__mmask8 msk_ext;
+	unsigned int j;
+
+	res_msk = _mm512_set1_epi64((size == sizeof(uint16_t)) ? UINT16_MAX :
+		UINT32_MAX);
+
+	/* first and last 8 bytes of the addresses, little endian */
+	first = _mm512_loadu_si512(ips[0]);
+	second = _mm512_loadu_si512(ips[4]);
+	hi = _mm512_permutex2var_epi64(first, hi_perm, second);
+	lo = _mm512_permutex2var_epi64(first, lo_perm, second);
+
+	/* tbl24 index is the first 3 bytes in network order */
+	idxes = _mm512_slli_epi64(_mm512_and_epi64(hi, lsbyte_msk), 16);
+	idxes = _mm512_or_epi64(idxes, _mm512_and_epi64(hi,
+		_mm512_set1_epi64(UINT8_MAX << 8)));
+	idxes = _mm512_or_epi64(idxes, _mm512_and_epi64(
+		_mm512_srli_epi64(hi, 16), lsbyte_msk));
+
+	if (size == sizeof(uint16_t))
+		res = _mm512_i64gather_epi64(idxes, (const void *)dp->tbl24, 2);
+	else if (size == sizeof(uint32_t))
+		res = _mm512_i64gather_epi64(idxes, (const void *)dp->tbl24, 4);
+	else
+		res = _mm512_i64gather_epi64(idxes, (const void *)dp->tbl24, 8);
+	if (size != sizeof(uint64_t))
+		res = _mm512_and_epi64(res, res_msk);
+
+	msk_ext = _mm512_test_epi64_mask(res, lsb);
+	for (j = 3; msk_ext != 0; j++) {
+		bytes = _mm512_srl_epi64((j < 8) ? hi : lo,
+			_mm_cvtsi32_si128((j % 8) * 8));
+		bytes = _mm512_and_epi64(bytes, lsbyte_msk);
+		idxes = _mm512_srli_epi64(res, 1);
+		idxes = _mm512_slli_epi64(idxes, 8);
+		idxes = _mm512_add_epi64(idxes, bytes);
+		if (size == sizeof(uint16_t))
+			res = _mm512_mask_i64gather_epi64(res, msk_ext, idxes,
+				(const void *)dp->tbl8, 2);
+		else if (size == sizeof(uint32_t))
+			res = _mm512_mask_i64gather_epi64(res, msk_ext, idxes,
+				(const void *)dp->tbl8, 4);
+		else
+			res = _mm512_mask_i64gather_epi64(res, msk_ext, idxes,
+				(const void *)dp->tbl8, 8);
+		if (size != sizeof(uint64_t))
+			res = _mm512_and_epi64(res, res_msk);
+		msk_ext = _mm512_mask_test_epi64_mask(msk_ext, res, lsb);
+	}
+
+	_mm512_storeu_si512(next_hops, _mm512_srli_epi64(res, 1));
+}
+
+static void
+rte_trie_vec_lookup_bulk_2b(void *p, uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
+	uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+
+	for (i = 0; i < (n / 8); i++)
+		trie_vec_lookup_x8(p, &ips[i * 8], next_hops + i * 8,
+			sizeof(uint16_t));
+	rte_trie_lookup_bulk_2b(p, &ips[i * 8], next_hops + i * 8,
+		n - i * 8);
+}
+
+static void
+rte_trie_vec_lookup_bulk_4b(void *p, uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
+	uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+
+	for (i = 0; i < (n / 8); i++)
+		trie_vec_lookup_x8(p, &ips[i * 8], next_hops + i * 8,
+			sizeof(uint32_t));
+	rte_trie_lookup_bulk_4b(p, &ips[i * 8], next_hops + i * 8,
+		n - i * 8);
+}
+
+static void
+rte_trie_vec_lookup_bulk_8b(void *p, uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
+	uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+
+	for (i = 0; i < (n / 8); i++)
+		trie_vec_lookup_x8(p, &ips[i * 8], next_hops + i * 8,
+			sizeof(uint64_t));
+	rte_trie_lookup_bulk_8b(p, &ips[i * 8], next_hops + i * 8,
+		n - i * 8);
+}
+
+static rte_fib6_lookup_fn_t
+get_vector_fn(enum rte_fib_trie_nh_sz nh_sz)
+{
+	if (!rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F))
+		return NULL;
+
+	switch (nh_sz) {
+	case RTE_FIB6_TRIE_2B:
+		return rte_trie_vec_lookup_bulk_2b;
+	case RTE_FIB6_TRIE_4B:
+		return rte_trie_vec_lookup_bulk_4b;
+	case RTE_FIB6_TRIE_8B:
+		return rte_trie_vec_lookup_bulk_8b;
 	}
+	return NULL;
+}
+#else
+static rte_fib6_lookup_fn_t
+get_vector_fn(__rte_unused enum rte_fib_trie_nh_sz nh_sz)
+{
+	return NULL;
+}
+#endif
 
+static rte_fib6_lookup_fn_t
+get_scalar_fn(enum rte_fib_trie_nh_sz nh_sz)
+{
+	switch (nh_sz) {
+	case RTE_FIB6_TRIE_2B:
+		return rte_trie_lookup_bulk_2b;
+	case RTE_FIB6_TRIE_4B:
+		return rte_trie_lookup_bulk_4b;
+	case RTE_FIB6_TRIE_8B:
+		return rte_trie_lookup_bulk_8b;
+	}
 	return NULL;
 }
 
+rte_fib6_lookup_fn_t
+rte_trie_get_lookup_fn(void *p, enum rte_fib6_lookup_type type)
+{
+	struct rte_trie_tbl *dp = (struct rte_trie_tbl *)p;
+	enum rte_fib_trie_nh_sz nh_sz = dp->nh_sz;
+	rte_fib6_lookup_fn_t ret_fn;
+
+	switch (type) {
+	case RTE_FIB6_LOOKUP_DEFAULT:
+		ret_fn = get_vector_fn(nh_sz);
+		return (ret_fn != NULL) ? ret_fn : get_scalar_fn(nh_sz);
+	case RTE_FIB6_LOOKUP_TRIE_SCALAR:
+		return get_scalar_fn(nh_sz);
+	case RTE_FIB6_LOOKUP_TRIE_VECTOR_AVX512:
+		return get_vector_fn(nh_sz);
+	default:
+		return NULL;
+	}
+}
+
 static void
 write_to_dp(void *ptr, uint64_t val, enum rte_fib_trie_nh_sz size, int n)
 {
@@ -710,8 +867,8 @@ trie_create(const char *name, int socket_id,
 
 	snprintf(mem_name, sizeof(mem_name), "DP_%s", name);
 	dp = rte_zmalloc_socket(name, sizeof(struct rte_trie_tbl) +
-		TRIE_TBL24_NUM_ENT * (1 << nh_sz), RTE_CACHE_LINE_SIZE,
-		socket_id);
+		TRIE_TBL24_NUM_ENT * (1 << nh_sz) + TRIE_TBL_PAD,
+		RTE_CACHE_LINE_SIZE, socket_id);
 	if (dp == NULL) {
 		rte_errno = ENOMEM;
 		return dp;
@@ -721,7 +878,7 @@ trie_create(const char *name, int socket_id,
 
 	snprintf(mem_name, sizeof(mem_name), "TBL8_%p", dp);
 	dp->tbl8 = rte_zmalloc_socket(mem_name, TRIE_TBL8_GRP_NUM_ENT *
-			(1ll << nh_sz) * (num_tbl8 + 1),
+			(1ll << nh_sz) * (num_tbl8 + 1) + TRIE_TBL_PAD,
 			RTE_CACHE_LINE_SIZE, socket_id);
 	if (dp->tbl8 == NULL) {
 		rte_errno = ENOMEM;
@@ -757,3 +914,53 @@ trie_free(void *p)
 	rte_free(dp->tbl8);
 	rte_free(dp);
 }
+
+int
+trie_save(void *p, FILE *f)
+{
+	struct rte_trie_tbl *dp = (struct rte_trie_tbl *)p;
+	struct trie_snapshot snap;
+
+	snap.number_tbl8s = dp->number_tbl8s;
+	snap.rsvd_tbl8s = dp->rsvd_tbl8s;
+	snap.cur_tbl8s = dp->cur_tbl8s;
+	snap.tbl8_pool_pos = dp->tbl8_pool_pos;
+	snap.nh_sz = dp->nh_sz;
+
+	/* the tables link by index, they are written as they are */
+	if ((fwrite(&snap, sizeof(snap), 1, f) != 1) ||
+			(fwrite(dp->tbl24, TRIE_TBL24_NUM_ENT << dp->nh_sz, 1,
+			f) != 1) ||
+			(fwrite(dp->tbl8, (TRIE_TBL8_GRP_NUM_ENT << dp->nh_sz) *
+			(dp->number_tbl8s + 1), 1, f) != 1) ||
+			(fwrite(dp->tbl8_pool, sizeof(uint32_t) *
+			dp->number_tbl8s, 1, f) != 1))
+		return -EIO;
+	return 0;
+}
+
+int
+trie_restore(void *p, FILE *f)
+{
+	struct rte_trie_tbl *dp = (struct rte_trie_tbl *)p;
+	struct trie_snapshot snap;
+
+	if (fread(&snap, sizeof(snap), 1, f) != 1)
+		return -EIO;
+	if ((snap.number_tbl8s != dp->number_tbl8s) ||
+			(snap.nh_sz != (uint32_t)dp->nh_sz) ||
+			(snap.tbl8_pool_pos > dp->number_tbl8s))
+		return -EINVAL;
+
+	if ((fread(dp->tbl24, TRIE_TBL24_NUM_ENT << dp->nh_sz, 1,
+			f) != 1) ||
+			(fread(dp->tbl8, (TRIE_TBL8_GRP_NUM_ENT << dp->nh_sz) *
+			(dp->number_tbl8s + 1), 1, f) != 1) ||
+			(fread(dp->tbl8_pool, sizeof(uint32_t) *
+			dp->number_tbl8s, 1, f) != 1))
+		return -EIO;
+	dp->rsvd_tbl8s = snap.rsvd_tbl8s;
+	dp->cur_tbl8s = snap.cur_tbl8s;
+	dp->tbl8_pool_pos = snap.tbl8_pool_pos;
+	return 0;
+}
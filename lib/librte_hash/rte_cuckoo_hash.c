@@ -5,6 +5,7 @@
 
 #include <string.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <errno.h>
 #include <stdio.h>
 #include <stdarg.h>
@@ -121,6 +122,47 @@ get_alt_bucket_index(const struct rte_hash *h,
 	return (cur_bkt_idx ^ sig) & h->bucket_bitmask;
 }
 
+/*
+ * Load the bucket array and bitmask of a bucket table that a resize can
+ * replace while lock free readers are using it. The writer publishes the
+ * array and the bitmask separately, in an order that depends on whether
+ * the table grows or shrinks (see store_buckets()). Taking the smaller of
+ * the bitmasks loaded before and after the array keeps the bucket index
+ * within the loaded array in both cases. A mismatched pair can only cause
+ * a miss, which the caller catches through tbl_chng_cnt.
+ */
+static inline struct rte_hash_bucket *
+load_buckets_lf(struct rte_hash_bucket * const *buckets,
+		const uint32_t *bitmask, uint32_t *mask)
+{
+	struct rte_hash_bucket *bkts;
+	uint32_t mask_b, mask_a;
+
+	mask_b = __atomic_load_n(bitmask, __ATOMIC_ACQUIRE);
+	bkts = __atomic_load_n(buckets, __ATOMIC_ACQUIRE);
+	mask_a = __atomic_load_n(bitmask, __ATOMIC_RELAXED);
+	*mask = RTE_MIN(mask_b, mask_a);
+
+	return bkts;
+}
+
+/* Publish a new bucket array and bitmask to the readers. The larger of the
+ * two arrays is published first, so that a reader never combines a bitmask
+ * with an array that is smaller than the bitmask allows.
+ */
+static inline void
+store_buckets(struct rte_hash_bucket **buckets, uint32_t *bitmask,
+		struct rte_hash_bucket *new_buckets, uint32_t new_bitmask)
+{
+	if (new_bitmask > *bitmask) {
+		__atomic_store_n(buckets, new_buckets, __ATOMIC_RELEASE);
+		__atomic_store_n(bitmask, new_bitmask, __ATOMIC_RELEASE);
+	} else {
+		__atomic_store_n(bitmask, new_bitmask, __ATOMIC_RELEASE);
+		__atomic_store_n(buckets, new_buckets, __ATOMIC_RELEASE);
+	}
+}
+
 struct rte_hash *
 rte_hash_create(const struct rte_hash_parameters *params)
 {
@@ -144,6 +186,8 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	uint32_t *ext_bkt_to_free = NULL;
 	uint32_t *tbl_chng_cnt = NULL;
 	unsigned int readwrite_concur_lf_support = 0;
+	unsigned int resizable = 0;
+	uint32_t *key_age = NULL;
 	uint32_t i;
 
 	rte_hash_function default_hash_func = (rte_hash_function)rte_jhash;
@@ -173,6 +217,25 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		return NULL;
 	}
 
+	/* Resizing relies on a single writer and on a fixed bucket layout */
+	if ((params->extra_flag & RTE_HASH_EXTRA_FLAGS_RESIZABLE) &&
+	    (params->extra_flag & (RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD |
+				   RTE_HASH_EXTRA_FLAGS_EXT_TABLE))) {
+		rte_errno = EINVAL;
+		RTE_LOG(ERR, HASH, "rte_hash_create: resizable table does not "
+			"support multi writer add or extendable bucket table\n");
+		return NULL;
+	}
+
+	/* The key age array is sized once, for the key slots of the table */
+	if ((params->extra_flag & RTE_HASH_EXTRA_FLAGS_AGING) &&
+	    (params->extra_flag & RTE_HASH_EXTRA_FLAGS_RESIZABLE)) {
+		rte_errno = EINVAL;
+		RTE_LOG(ERR, HASH, "rte_hash_create: aging is not supported "
+			"by resizable table\n");
+		return NULL;
+	}
+
 	/* Check extra flags field to check extra options. */
 	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_TRANS_MEM_SUPPORT)
 		hw_trans_mem_support = 1;
@@ -199,6 +262,9 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		no_free_on_del = 1;
 	}
 
+	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_RESIZABLE)
+		resizable = 1;
+
 	/* Store all keys and leave the first entry as a dummy entry for lookup_bulk */
 	if (use_local_cache)
 		/*
@@ -329,6 +395,17 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		goto err_unlock;
 	}
 
+	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_AGING) {
+		key_age = rte_zmalloc_socket(NULL,
+				sizeof(uint32_t) * num_key_slots,
+				RTE_CACHE_LINE_SIZE, params->socket_id);
+		if (key_age == NULL) {
+			RTE_LOG(ERR, HASH, "key age memory allocation "
+						"failed\n");
+			goto err_unlock;
+		}
+	}
+
 /*
  * If x86 architecture is used, select appropriate compare function,
  * which may use x86 intrinsics, otherwise use memcmp
@@ -407,8 +484,20 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	h->writer_takes_lock = writer_takes_lock;
 	h->no_free_on_del = no_free_on_del;
 	h->readwrite_concur_lf_support = readwrite_concur_lf_support;
+	h->resizable = resizable;
+	h->aging = key_age != NULL;
+	h->key_age = key_age;
+	/* Age tick 0 marks key slots without access time */
+	h->age_now = 1;
+	h->socket_id = params->socket_id;
 
 #if defined(RTE_ARCH_X86)
+#ifdef CC_AVX512_SUPPORT
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) &&
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512BW))
+		h->sig_cmp_fn = RTE_HASH_COMPARE_AVX512;
+	else
+#endif
 	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_SSE2))
 		h->sig_cmp_fn = RTE_HASH_COMPARE_SSE;
 	else
@@ -453,6 +542,7 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	rte_free(k);
 	rte_free(tbl_chng_cnt);
 	rte_free(ext_bkt_to_free);
+	rte_free(key_age);
 	return NULL;
 }
 
@@ -495,6 +585,10 @@ rte_hash_free(struct rte_hash *h)
 	rte_free(h->buckets_ext);
 	rte_free(h->tbl_chng_cnt);
 	rte_free(h->ext_bkt_to_free);
+	rte_free(h->old_buckets);
+	rte_free(h->retired_key_store);
+	rte_free(h->retired_buckets);
+	rte_free(h->key_age);
 	rte_free(h);
 	rte_free(te);
 }
@@ -594,6 +688,9 @@ rte_hash_reset(struct rte_hash *h)
 	memset(h->buckets, 0, h->num_buckets * sizeof(struct rte_hash_bucket));
 	memset(h->key_store, 0, h->key_entry_size * (h->entries + 1));
 	*h->tbl_chng_cnt = 0;
+	if (h->aging)
+		memset(h->key_age, 0, sizeof(uint32_t) *
+				(rte_hash_max_key_id(h) + 1));
 
 	/* reset the free ring */
 	rte_ring_reset(h->free_slots);
@@ -627,6 +724,16 @@ rte_hash_reset(struct rte_hash *h)
 		for (i = 0; i < RTE_MAX_LCORE; i++)
 			h->local_free_slots[i].len = 0;
 	}
+
+	/* Drop the bucket table being resized and any memory left from
+	 * previous resizes, as no reader is referencing the table.
+	 */
+	rte_free(h->old_buckets);
+	h->old_buckets = NULL;
+	rte_free(h->retired_key_store);
+	h->retired_key_store = NULL;
+	rte_free(h->retired_buckets);
+	h->retired_buckets = NULL;
 	__hash_rw_writer_unlock(h);
 }
 
@@ -648,6 +755,20 @@ enqueue_slot_back(const struct rte_hash *h,
 						sizeof(uint32_t));
 }
 
+/* Record an access to the key stored in key slot @slot_id. The age is
+ * only written when it changes, to keep the cache line of hot keys shared
+ * between the readers. A stale store racing with the removal of the key
+ * is harmless, rte_hash_age_expire verifies the keys it reports.
+ */
+static inline void
+hash_age_touch(const struct rte_hash *h, uint32_t slot_id)
+{
+	uint32_t now = __atomic_load_n(&h->age_now, __ATOMIC_RELAXED);
+
+	if (__atomic_load_n(&h->key_age[slot_id], __ATOMIC_RELAXED) != now)
+		__atomic_store_n(&h->key_age[slot_id], now, __ATOMIC_RELAXED);
+}
+
 /* Search a key from bucket and update its data.
  * Writer holds the lock before calling this.
  */
@@ -672,6 +793,8 @@ search_and_update(const struct rte_hash *h, void *data, const void *key,
 				__atomic_store_n(&k->pdata,
 					data,
 					__ATOMIC_RELEASE);
+				if (h->aging)
+					hash_age_touch(h, bkt->key_idx[i]);
 				/*
 				 * Return index where key is stored,
 				 * subtracting the first dummy index
@@ -683,6 +806,30 @@ search_and_update(const struct rte_hash *h, void *data, const void *key,
 	return -1;
 }
 
+/* Search a key from the bucket table being resized and update its data.
+ * Writer holds the lock before calling this.
+ */
+static inline int32_t
+search_and_update_old_buckets(const struct rte_hash *h, void *data,
+				const void *key, hash_sig_t sig)
+{
+	uint32_t prim_bucket_idx, sec_bucket_idx;
+	uint16_t short_sig;
+	int32_t ret;
+
+	short_sig = get_short_sig(sig);
+	prim_bucket_idx = sig & h->old_bucket_bitmask;
+	sec_bucket_idx = (prim_bucket_idx ^ short_sig) & h->old_bucket_bitmask;
+
+	ret = search_and_update(h, data, key,
+				&h->old_buckets[prim_bucket_idx], short_sig);
+	if (ret != -1)
+		return ret;
+
+	return search_and_update(h, data, key,
+				&h->old_buckets[sec_bucket_idx], short_sig);
+}
+
 /* Only tries to insert at one bucket (@prim_bkt) without trying to push
  * buckets around.
  * return 1 if matching existing key, return 0 if succeeds, return -1 for no
@@ -751,9 +898,10 @@ rte_hash_cuckoo_insert_mw(const struct rte_hash *h,
  * the path head with new entry (sig, alt_hash, new_idx)
  * return 1 if matched key found, return -1 if cuckoo path invalided and fail,
  * return 0 if succeeds.
+ * Writer holds the lock before calling this.
  */
 static inline int
-rte_hash_cuckoo_move_insert_mw(const struct rte_hash *h,
+rte_hash_cuckoo_move_insert(const struct rte_hash *h,
 			struct rte_hash_bucket *bkt,
 			struct rte_hash_bucket *alt_bkt,
 			const struct rte_hash_key *key, void *data,
@@ -768,20 +916,15 @@ rte_hash_cuckoo_move_insert_mw(const struct rte_hash *h,
 	uint32_t prev_slot, curr_slot = leaf_slot;
 	int32_t ret;
 
-	__hash_rw_writer_lock(h);
-
 	/* In case empty slot was gone before entering protected region */
-	if (curr_bkt->key_idx[curr_slot] != EMPTY_SLOT) {
-		__hash_rw_writer_unlock(h);
+	if (curr_bkt->key_idx[curr_slot] != EMPTY_SLOT)
 		return -1;
-	}
 
 	/* Check if key was inserted after last check but before this
 	 * protected region.
 	 */
 	ret = search_and_update(h, data, key, bkt, sig);
 	if (ret != -1) {
-		__hash_rw_writer_unlock(h);
 		*ret_val = ret;
 		return 1;
 	}
@@ -789,7 +932,6 @@ rte_hash_cuckoo_move_insert_mw(const struct rte_hash *h,
 	FOR_EACH_BUCKET(cur_bkt, alt_bkt) {
 		ret = search_and_update(h, data, key, cur_bkt, sig);
 		if (ret != -1) {
-			__hash_rw_writer_unlock(h);
 			*ret_val = ret;
 			return 1;
 		}
@@ -810,7 +952,6 @@ rte_hash_cuckoo_move_insert_mw(const struct rte_hash *h,
 			__atomic_store_n(&curr_bkt->key_idx[curr_slot],
 				EMPTY_SLOT,
 				__ATOMIC_RELEASE);
-			__hash_rw_writer_unlock(h);
 			return -1;
 		}
 
@@ -868,15 +1009,33 @@ rte_hash_cuckoo_move_insert_mw(const struct rte_hash *h,
 			 new_idx,
 			 __ATOMIC_RELEASE);
 
-	__hash_rw_writer_unlock(h);
-
 	return 0;
 
 }
 
+static inline int
+rte_hash_cuckoo_move_insert_mw(const struct rte_hash *h,
+			struct rte_hash_bucket *bkt,
+			struct rte_hash_bucket *alt_bkt,
+			const struct rte_hash_key *key, void *data,
+			struct queue_node *leaf, uint32_t leaf_slot,
+			uint16_t sig, uint32_t new_idx,
+			int32_t *ret_val)
+{
+	int ret;
+
+	__hash_rw_writer_lock(h);
+	ret = rte_hash_cuckoo_move_insert(h, bkt, alt_bkt, key, data,
+					leaf, leaf_slot, sig, new_idx, ret_val);
+	__hash_rw_writer_unlock(h);
+
+	return ret;
+}
+
 /*
  * Make space for new key, using bfs Cuckoo Search and Multi-Writer safe
- * Cuckoo
+ * Cuckoo. If @writer_locked is set, the caller already holds the writer
+ * lock and the cuckoo path is moved without taking it again.
  */
 static inline int
 rte_hash_cuckoo_make_space_mw(const struct rte_hash *h,
@@ -884,7 +1043,8 @@ rte_hash_cuckoo_make_space_mw(const struct rte_hash *h,
 			struct rte_hash_bucket *sec_bkt,
 			const struct rte_hash_key *key, void *data,
 			uint16_t sig, uint32_t bucket_idx,
-			uint32_t new_idx, int32_t *ret_val)
+			uint32_t new_idx, int32_t *ret_val,
+			const int writer_locked)
 {
 	unsigned int i;
 	struct queue_node queue[RTE_HASH_BFS_QUEUE_MAX_LEN];
@@ -907,7 +1067,15 @@ rte_hash_cuckoo_make_space_mw(const struct rte_hash *h,
 		cur_idx = tail->cur_bkt_idx;
 		for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
 			if (curr_bkt->key_idx[i] == EMPTY_SLOT) {
-				int32_t ret = rte_hash_cuckoo_move_insert_mw(h,
+				int32_t ret;
+
+				if (writer_locked)
+					ret = rte_hash_cuckoo_move_insert(h,
+						bkt, sec_bkt, key, data,
+						tail, i, sig,
+						new_idx, ret_val);
+				else
+					ret = rte_hash_cuckoo_move_insert_mw(h,
 						bkt, sec_bkt, key, data,
 						tail, i, sig,
 						new_idx, ret_val);
@@ -974,6 +1142,15 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 		}
 	}
 
+	/* Check if key is still in the bucket table being resized */
+	if (unlikely(h->old_buckets != NULL)) {
+		ret = search_and_update_old_buckets(h, data, key, sig);
+		if (ret != -1) {
+			__hash_rw_writer_unlock(h);
+			return ret;
+		}
+	}
+
 	__hash_rw_writer_unlock(h);
 
 	/* Did not find a match, so get a new slot for storing the new key */
@@ -1014,6 +1191,8 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 		__ATOMIC_RELEASE);
 	/* Copy key */
 	memcpy(new_k->key, key, h->key_len);
+	if (h->aging)
+		hash_age_touch(h, slot_id);
 
 	/* Find an empty slot and insert */
 	ret = rte_hash_cuckoo_insert_mw(h, prim_bkt, sec_bkt, key, data,
@@ -1027,7 +1206,8 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 
 	/* Primary bucket full, need to make space for new entry */
 	ret = rte_hash_cuckoo_make_space_mw(h, prim_bkt, sec_bkt, key, data,
-				short_sig, prim_bucket_idx, slot_id, &ret_val);
+				short_sig, prim_bucket_idx, slot_id, &ret_val,
+				0);
 	if (ret == 0)
 		return slot_id - 1;
 	else if (ret == 1) {
@@ -1037,7 +1217,8 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 
 	/* Also search secondary bucket to get better occupancy */
 	ret = rte_hash_cuckoo_make_space_mw(h, sec_bkt, prim_bkt, key, data,
-				short_sig, sec_bucket_idx, slot_id, &ret_val);
+				short_sig, sec_bucket_idx, slot_id, &ret_val,
+				0);
 
 	if (ret == 0)
 		return slot_id - 1;
@@ -1164,6 +1345,257 @@ rte_hash_add_key_data(const struct rte_hash *h, const void *key, void *data)
 		return ret;
 }
 
+/*
+ * Take up to @n free key slots for a burst of additions, from the local
+ * cache first if enabled. Returns the number of slots taken.
+ */
+static inline unsigned int
+alloc_slots_bulk(const struct rte_hash *h,
+		struct lcore_cache *cached_free_slots,
+		uint32_t *slots, unsigned int n)
+{
+	unsigned int n_slots;
+
+	if (h->use_local_cache) {
+		n_slots = RTE_MIN(n, cached_free_slots->len);
+		cached_free_slots->len -= n_slots;
+		memcpy(slots, &cached_free_slots->objs[cached_free_slots->len],
+				n_slots * sizeof(uint32_t));
+		/* Get the rest of the burst from the global ring */
+		if (n_slots < n)
+			n_slots += rte_ring_mc_dequeue_burst_elem(h->free_slots,
+					&slots[n_slots], sizeof(uint32_t),
+					n - n_slots, NULL);
+	} else
+		n_slots = rte_ring_sc_dequeue_burst_elem(h->free_slots, slots,
+					sizeof(uint32_t), n, NULL);
+
+	return n_slots;
+}
+
+/* Give back the free key slots left unused by a burst of additions. */
+static inline void
+free_slots_bulk(const struct rte_hash *h,
+		struct lcore_cache *cached_free_slots,
+		const uint32_t *slots, unsigned int n)
+{
+	unsigned int n_cache;
+
+	if (n == 0)
+		return;
+
+	if (h->use_local_cache) {
+		n_cache = RTE_MIN(n, LCORE_CACHE_SIZE - cached_free_slots->len);
+		memcpy(&cached_free_slots->objs[cached_free_slots->len], slots,
+				n_cache * sizeof(uint32_t));
+		cached_free_slots->len += n_cache;
+		/* Cache full, put the rest in the global ring */
+		if (n_cache < n)
+			rte_ring_mp_enqueue_bulk_elem(h->free_slots,
+					&slots[n_cache], sizeof(uint32_t),
+					n - n_cache, NULL);
+	} else
+		rte_ring_sp_enqueue_bulk_elem(h->free_slots, slots,
+					sizeof(uint32_t), n, NULL);
+}
+
+/* Compute the signatures of a burst of keys and prefetch their buckets. */
+static inline void
+hash_and_prefetch_bulk(const struct rte_hash *h, const void **keys,
+			uint32_t num_keys, hash_sig_t *sig)
+{
+	uint32_t prim_bucket_idx, sec_bucket_idx;
+	uint32_t i;
+
+	for (i = 0; i < num_keys; i++) {
+		sig[i] = rte_hash_hash(h, keys[i]);
+		prim_bucket_idx = get_prim_bucket_index(h, sig[i]);
+		sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx,
+						get_short_sig(sig[i]));
+		rte_prefetch0(&h->buckets[prim_bucket_idx]);
+		rte_prefetch0(&h->buckets[sec_bucket_idx]);
+	}
+}
+
+/* Add a key using the free key slot @slot_id taken by the caller.
+ * *slot_id is set to EMPTY_SLOT if the slot was used for the new key,
+ * and is left untouched if the key was already present or on failure.
+ * Writer holds the lock before calling this.
+ */
+static inline int32_t
+__rte_hash_add_key_with_hash_locked(const struct rte_hash *h, const void *key,
+				hash_sig_t sig, void *data, uint32_t *slot_id)
+{
+	uint16_t short_sig;
+	uint32_t prim_bucket_idx, sec_bucket_idx;
+	struct rte_hash_bucket *prim_bkt, *sec_bkt, *cur_bkt, *last;
+	struct rte_hash_key *new_k;
+	uint32_t ext_bkt_id;
+	int32_t ret_val;
+	unsigned int i;
+	int32_t ret;
+
+	short_sig = get_short_sig(sig);
+	prim_bucket_idx = get_prim_bucket_index(h, sig);
+	sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx, short_sig);
+	prim_bkt = &h->buckets[prim_bucket_idx];
+	sec_bkt = &h->buckets[sec_bucket_idx];
+
+	/* Check if key is already inserted in primary location */
+	ret = search_and_update(h, data, key, prim_bkt, short_sig);
+	if (ret != -1)
+		return ret;
+
+	/* Check if key is already inserted in secondary location */
+	FOR_EACH_BUCKET(cur_bkt, sec_bkt) {
+		ret = search_and_update(h, data, key, cur_bkt, short_sig);
+		if (ret != -1)
+			return ret;
+	}
+
+	/* Check if key is still in the bucket table being resized */
+	if (unlikely(h->old_buckets != NULL)) {
+		ret = search_and_update_old_buckets(h, data, key, sig);
+		if (ret != -1)
+			return ret;
+	}
+
+	if (*slot_id == EMPTY_SLOT)
+		return -ENOSPC;
+
+	new_k = RTE_PTR_ADD(h->key_store, *slot_id * h->key_entry_size);
+	/* The store to application data (by the application) at *data should
+	 * not leak after the store of pdata in the key store. i.e. pdata is
+	 * the guard variable. Release the application data to the readers.
+	 */
+	__atomic_store_n(&new_k->pdata,
+		data,
+		__ATOMIC_RELEASE);
+	/* Copy key */
+	memcpy(new_k->key, key, h->key_len);
+	if (h->aging)
+		hash_age_touch(h, *slot_id);
+
+	/* Insert new entry if there is room in the primary bucket */
+	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+		/* Check if slot is available */
+		if (likely(prim_bkt->key_idx[i] == EMPTY_SLOT)) {
+			prim_bkt->sig_current[i] = short_sig;
+			/* Store to signature and key should not
+			 * leak after the store to key_idx. i.e.
+			 * key_idx is the guard variable for signature
+			 * and key.
+			 */
+			__atomic_store_n(&prim_bkt->key_idx[i],
+					 *slot_id,
+					 __ATOMIC_RELEASE);
+			goto success;
+		}
+	}
+
+	/* Primary bucket full, need to make space for new entry */
+	ret = rte_hash_cuckoo_make_space_mw(h, prim_bkt, sec_bkt, key, data,
+				short_sig, prim_bucket_idx, *slot_id, &ret_val,
+				1);
+	if (ret == 0)
+		goto success;
+	else if (ret == 1)
+		return ret_val;
+
+	/* Also search secondary bucket to get better occupancy */
+	ret = rte_hash_cuckoo_make_space_mw(h, sec_bkt, prim_bkt, key, data,
+				short_sig, sec_bucket_idx, *slot_id, &ret_val,
+				1);
+	if (ret == 0)
+		goto success;
+	else if (ret == 1)
+		return ret_val;
+
+	/* if ext table not enabled, we failed the insertion */
+	if (!h->ext_table_support)
+		return ret;
+
+	/* Search sec and ext buckets to find an empty entry to insert. */
+	FOR_EACH_BUCKET(cur_bkt, sec_bkt) {
+		for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+			/* Check if slot is available */
+			if (likely(cur_bkt->key_idx[i] == EMPTY_SLOT)) {
+				cur_bkt->sig_current[i] = short_sig;
+				__atomic_store_n(&cur_bkt->key_idx[i],
+						 *slot_id,
+						 __ATOMIC_RELEASE);
+				goto success;
+			}
+		}
+	}
+
+	/* Failed to get an empty entry from extendable buckets. Link a new
+	 * extendable bucket. We first get a free bucket from ring.
+	 */
+	if (rte_ring_sc_dequeue_elem(h->free_ext_bkts, &ext_bkt_id,
+						sizeof(uint32_t)) != 0)
+		return -ENOSPC;
+
+	/* Use the first location of the new bucket */
+	(h->buckets_ext[ext_bkt_id - 1]).sig_current[0] = short_sig;
+	__atomic_store_n(&(h->buckets_ext[ext_bkt_id - 1]).key_idx[0],
+			 *slot_id,
+			 __ATOMIC_RELEASE);
+	/* Link the new bucket to sec bucket linked list */
+	last = rte_hash_get_last_bkt(sec_bkt);
+	last->next = &h->buckets_ext[ext_bkt_id - 1];
+
+success:
+	ret = *slot_id - 1;
+	*slot_id = EMPTY_SLOT;
+	return ret;
+}
+
+int
+rte_hash_add_key_bulk_data(const struct rte_hash *h, const void **keys,
+			uint32_t num_keys, void *data[], int32_t *positions)
+{
+	hash_sig_t sig[RTE_HASH_LOOKUP_BULK_MAX];
+	uint32_t slots[RTE_HASH_LOOKUP_BULK_MAX];
+	struct lcore_cache *cached_free_slots = NULL;
+	unsigned int n_slots, next_slot = 0;
+	uint32_t slot_id;
+	uint32_t i;
+	int num_added = 0;
+
+	RETURN_IF_TRUE(((h == NULL) || (keys == NULL) || (num_keys == 0) ||
+			(num_keys > RTE_HASH_LOOKUP_BULK_MAX) ||
+			(data == NULL) || (positions == NULL)), -EINVAL);
+
+	hash_and_prefetch_bulk(h, keys, num_keys, sig);
+
+	/* Get the free slots for the whole burst at once */
+	if (h->use_local_cache)
+		cached_free_slots = &h->local_free_slots[rte_lcore_id()];
+	n_slots = alloc_slots_bulk(h, cached_free_slots, slots, num_keys);
+	for (i = 0; i < n_slots; i++)
+		rte_prefetch0(RTE_PTR_ADD(h->key_store,
+					slots[i] * h->key_entry_size));
+
+	__hash_rw_writer_lock(h);
+	for (i = 0; i < num_keys; i++) {
+		slot_id = next_slot < n_slots ? slots[next_slot] : EMPTY_SLOT;
+		positions[i] = __rte_hash_add_key_with_hash_locked(h, keys[i],
+						sig[i], data[i], &slot_id);
+		if (positions[i] >= 0)
+			num_added++;
+		/* Move to the next free slot once this one is used */
+		if (slot_id == EMPTY_SLOT && next_slot < n_slots)
+			next_slot++;
+	}
+	__hash_rw_writer_unlock(h);
+
+	free_slots_bulk(h, cached_free_slots, &slots[next_slot],
+			n_slots - next_slot);
+
+	return num_added;
+}
+
 /* Search one bucket to find the match key - uses rw lock */
 static inline int32_t
 search_one_bucket_l(const struct rte_hash *h, const void *key,
@@ -1200,7 +1632,7 @@ search_one_bucket_lf(const struct rte_hash *h, const void *key, uint16_t sig,
 {
 	int i;
 	uint32_t key_idx;
-	struct rte_hash_key *k, *keys = h->key_store;
+	struct rte_hash_key *k, *keys;
 
 	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
 		/* Signature comparison is done before the acquire-load
@@ -1214,6 +1646,12 @@ search_one_bucket_lf(const struct rte_hash *h, const void *key, uint16_t sig,
 			key_idx = __atomic_load_n(&bkt->key_idx[i],
 					  __ATOMIC_ACQUIRE);
 			if (key_idx != EMPTY_SLOT) {
+				/* The key store is loaded after the key
+				 * index, as a resize publishes a new key
+				 * store before handing out its new indexes.
+				 */
+				keys = __atomic_load_n(&h->key_store,
+						__ATOMIC_RELAXED);
 				k = (struct rte_hash_key *) ((char *)keys +
 						key_idx * h->key_entry_size);
 
@@ -1235,29 +1673,79 @@ search_one_bucket_lf(const struct rte_hash *h, const void *key, uint16_t sig,
 	return -1;
 }
 
+/* Search the bucket table being resized - uses rw lock */
 static inline int32_t
-__rte_hash_lookup_with_hash_l(const struct rte_hash *h, const void *key,
-				hash_sig_t sig, void **data)
+search_old_buckets_l(const struct rte_hash *h, const void *key,
+			hash_sig_t sig, void **data)
 {
 	uint32_t prim_bucket_idx, sec_bucket_idx;
-	struct rte_hash_bucket *bkt, *cur_bkt;
-	int ret;
 	uint16_t short_sig;
+	int32_t ret;
 
 	short_sig = get_short_sig(sig);
-	prim_bucket_idx = get_prim_bucket_index(h, sig);
-	sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx, short_sig);
+	prim_bucket_idx = sig & h->old_bucket_bitmask;
+	sec_bucket_idx = (prim_bucket_idx ^ short_sig) & h->old_bucket_bitmask;
 
-	bkt = &h->buckets[prim_bucket_idx];
+	ret = search_one_bucket_l(h, key, short_sig, data,
+				&h->old_buckets[prim_bucket_idx]);
+	if (ret != -1)
+		return ret;
 
-	__hash_rw_reader_lock(h);
+	return search_one_bucket_l(h, key, short_sig, data,
+				&h->old_buckets[sec_bucket_idx]);
+}
 
-	/* Check if key is in primary location */
-	ret = search_one_bucket_l(h, key, short_sig, data, bkt);
-	if (ret != -1) {
-		__hash_rw_reader_unlock(h);
-		return ret;
-	}
+/* Search the bucket table being resized */
+static inline int32_t
+search_old_buckets_lf(const struct rte_hash *h, const void *key,
+			hash_sig_t sig, void **data)
+{
+	uint32_t prim_bucket_idx, sec_bucket_idx, bitmask;
+	const struct rte_hash_bucket *buckets;
+	uint16_t short_sig;
+	int32_t ret;
+
+	buckets = load_buckets_lf(&h->old_buckets, &h->old_bucket_bitmask,
+				&bitmask);
+	if (buckets == NULL)
+		return -1;
+
+	short_sig = get_short_sig(sig);
+	prim_bucket_idx = sig & bitmask;
+	sec_bucket_idx = (prim_bucket_idx ^ short_sig) & bitmask;
+
+	ret = search_one_bucket_lf(h, key, short_sig, data,
+				&buckets[prim_bucket_idx]);
+	if (ret != -1)
+		return ret;
+
+	return search_one_bucket_lf(h, key, short_sig, data,
+				&buckets[sec_bucket_idx]);
+}
+
+static inline int32_t
+__rte_hash_lookup_with_hash_l(const struct rte_hash *h, const void *key,
+				hash_sig_t sig, void **data)
+{
+	uint32_t prim_bucket_idx, sec_bucket_idx;
+	struct rte_hash_bucket *bkt, *cur_bkt;
+	int ret;
+	uint16_t short_sig;
+
+	short_sig = get_short_sig(sig);
+	prim_bucket_idx = get_prim_bucket_index(h, sig);
+	sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx, short_sig);
+
+	bkt = &h->buckets[prim_bucket_idx];
+
+	__hash_rw_reader_lock(h);
+
+	/* Check if key is in primary location */
+	ret = search_one_bucket_l(h, key, short_sig, data, bkt);
+	if (ret != -1) {
+		__hash_rw_reader_unlock(h);
+		return ret;
+	}
 	/* Calculate secondary hash */
 	bkt = &h->buckets[sec_bucket_idx];
 
@@ -1271,6 +1759,15 @@ __rte_hash_lookup_with_hash_l(const struct rte_hash *h, const void *key,
 		}
 	}
 
+	/* Check if key is still in the bucket table being resized */
+	if (unlikely(h->old_buckets != NULL)) {
+		ret = search_old_buckets_l(h, key, sig, data);
+		if (ret != -1) {
+			__hash_rw_reader_unlock(h);
+			return ret;
+		}
+	}
+
 	__hash_rw_reader_unlock(h);
 
 	return -ENOENT;
@@ -1280,8 +1777,8 @@ static inline int32_t
 __rte_hash_lookup_with_hash_lf(const struct rte_hash *h, const void *key,
 					hash_sig_t sig, void **data)
 {
-	uint32_t prim_bucket_idx, sec_bucket_idx;
-	struct rte_hash_bucket *bkt, *cur_bkt;
+	uint32_t prim_bucket_idx, sec_bucket_idx, bitmask;
+	struct rte_hash_bucket *buckets, *bkt, *cur_bkt;
 	uint32_t cnt_b, cnt_a;
 	int ret;
 	uint16_t short_sig;
@@ -1289,6 +1786,7 @@ __rte_hash_lookup_with_hash_lf(const struct rte_hash *h, const void *key,
 	short_sig = get_short_sig(sig);
 	prim_bucket_idx = get_prim_bucket_index(h, sig);
 	sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx, short_sig);
+	buckets = h->buckets;
 
 	do {
 		/* Load the table change counter before the lookup
@@ -1298,13 +1796,22 @@ __rte_hash_lookup_with_hash_lf(const struct rte_hash *h, const void *key,
 		cnt_b = __atomic_load_n(h->tbl_chng_cnt,
 				__ATOMIC_ACQUIRE);
 
+		/* The bucket table can be replaced by a resize */
+		if (unlikely(h->resizable)) {
+			buckets = load_buckets_lf(&h->buckets,
+					&h->bucket_bitmask, &bitmask);
+			prim_bucket_idx = sig & bitmask;
+			sec_bucket_idx = (prim_bucket_idx ^ short_sig) &
+						bitmask;
+		}
+
 		/* Check if key is in primary location */
-		bkt = &h->buckets[prim_bucket_idx];
+		bkt = &buckets[prim_bucket_idx];
 		ret = search_one_bucket_lf(h, key, short_sig, data, bkt);
 		if (ret != -1)
 			return ret;
 		/* Calculate secondary hash */
-		bkt = &h->buckets[sec_bucket_idx];
+		bkt = &buckets[sec_bucket_idx];
 
 		/* Check if key is in secondary location */
 		FOR_EACH_BUCKET(cur_bkt, bkt) {
@@ -1314,6 +1821,13 @@ __rte_hash_lookup_with_hash_lf(const struct rte_hash *h, const void *key,
 				return ret;
 		}
 
+		/* Check if key is still in the bucket table being resized */
+		if (unlikely(h->resizable)) {
+			ret = search_old_buckets_lf(h, key, sig, data);
+			if (ret != -1)
+				return ret;
+		}
+
 		/* The loads of sig_current in search_one_bucket
 		 * should not move below the load from tbl_chng_cnt.
 		 */
@@ -1337,10 +1851,17 @@ static inline int32_t
 __rte_hash_lookup_with_hash(const struct rte_hash *h, const void *key,
 					hash_sig_t sig, void **data)
 {
+	int32_t ret;
+
 	if (h->readwrite_concur_lf_support)
-		return __rte_hash_lookup_with_hash_lf(h, key, sig, data);
+		ret = __rte_hash_lookup_with_hash_lf(h, key, sig, data);
 	else
-		return __rte_hash_lookup_with_hash_l(h, key, sig, data);
+		ret = __rte_hash_lookup_with_hash_l(h, key, sig, data);
+
+	if (unlikely(h->aging) && ret >= 0)
+		hash_age_touch(h, ret + 1);
+
+	return ret;
 }
 
 int32_t
@@ -1467,6 +1988,9 @@ search_and_remove(const struct rte_hash *h, const void *key,
 					key_idx * h->key_entry_size);
 			if (rte_hash_cmp_eq(key, k->key, h) == 0) {
 				bkt->sig_current[i] = NULL_SIGNATURE;
+				if (h->aging)
+					__atomic_store_n(&h->key_age[key_idx],
+						0, __ATOMIC_RELAXED);
 				/* Free the key store index if
 				 * no_free_on_del is disabled.
 				 */
@@ -1489,9 +2013,36 @@ search_and_remove(const struct rte_hash *h, const void *key,
 	return -1;
 }
 
+/* Search the bucket table being resized and remove the matched key.
+ * Writer is expected to hold the lock while calling this
+ * function.
+ */
 static inline int32_t
-__rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
-						hash_sig_t sig)
+search_and_remove_old_buckets(const struct rte_hash *h, const void *key,
+				hash_sig_t sig)
+{
+	uint32_t prim_bucket_idx, sec_bucket_idx;
+	uint16_t short_sig;
+	int32_t ret;
+	int pos;
+
+	short_sig = get_short_sig(sig);
+	prim_bucket_idx = sig & h->old_bucket_bitmask;
+	sec_bucket_idx = (prim_bucket_idx ^ short_sig) & h->old_bucket_bitmask;
+
+	ret = search_and_remove(h, key, &h->old_buckets[prim_bucket_idx],
+				short_sig, &pos);
+	if (ret != -1)
+		return ret;
+
+	return search_and_remove(h, key, &h->old_buckets[sec_bucket_idx],
+				short_sig, &pos);
+}
+
+/* Writer holds the lock before calling this. */
+static inline int32_t
+__rte_hash_del_key_with_hash_locked(const struct rte_hash *h,
+					const void *key, hash_sig_t sig)
 {
 	uint32_t prim_bucket_idx, sec_bucket_idx;
 	struct rte_hash_bucket *prim_bkt, *sec_bkt, *prev_bkt, *last_bkt;
@@ -1505,7 +2056,6 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 	sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx, short_sig);
 	prim_bkt = &h->buckets[prim_bucket_idx];
 
-	__hash_rw_writer_lock(h);
 	/* look for key in primary bucket */
 	ret = search_and_remove(h, key, prim_bkt, short_sig, &pos);
 	if (ret != -1) {
@@ -1528,15 +2078,19 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 		}
 	}
 
-	__hash_rw_writer_unlock(h);
+	/* Check if key is still in the bucket table being resized */
+	if (unlikely(h->old_buckets != NULL)) {
+		ret = search_and_remove_old_buckets(h, key, sig);
+		if (ret != -1)
+			return ret;
+	}
+
 	return -ENOENT;
 
 /* Search last bucket to see if empty to be recycled */
 return_bkt:
-	if (!last_bkt) {
-		__hash_rw_writer_unlock(h);
+	if (!last_bkt)
 		return ret;
-	}
 	while (last_bkt->next) {
 		prev_bkt = last_bkt;
 		last_bkt = last_bkt->next;
@@ -1567,7 +2121,19 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 			rte_ring_sp_enqueue_elem(h->free_ext_bkts, &index,
 							sizeof(uint32_t));
 	}
+	return ret;
+}
+
+static inline int32_t
+__rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
+						hash_sig_t sig)
+{
+	int32_t ret;
+
+	__hash_rw_writer_lock(h);
+	ret = __rte_hash_del_key_with_hash_locked(h, key, sig);
 	__hash_rw_writer_unlock(h);
+
 	return ret;
 }
 
@@ -1586,6 +2152,32 @@ rte_hash_del_key(const struct rte_hash *h, const void *key)
 	return __rte_hash_del_key_with_hash(h, key, rte_hash_hash(h, key));
 }
 
+int
+rte_hash_del_key_bulk(const struct rte_hash *h, const void **keys,
+			uint32_t num_keys, int32_t *positions)
+{
+	hash_sig_t sig[RTE_HASH_LOOKUP_BULK_MAX];
+	uint32_t i;
+	int num_deleted = 0;
+
+	RETURN_IF_TRUE(((h == NULL) || (keys == NULL) || (num_keys == 0) ||
+			(num_keys > RTE_HASH_LOOKUP_BULK_MAX) ||
+			(positions == NULL)), -EINVAL);
+
+	hash_and_prefetch_bulk(h, keys, num_keys, sig);
+
+	__hash_rw_writer_lock(h);
+	for (i = 0; i < num_keys; i++) {
+		positions[i] = __rte_hash_del_key_with_hash_locked(h, keys[i],
+								sig[i]);
+		if (positions[i] >= 0)
+			num_deleted++;
+	}
+	__hash_rw_writer_unlock(h);
+
+	return num_deleted;
+}
+
 int
 rte_hash_get_key_with_position(const struct rte_hash *h, const int32_t position,
 			       void **key)
@@ -1658,6 +2250,290 @@ rte_hash_free_key_with_position(const struct rte_hash *h,
 	return 0;
 }
 
+/* Inform the lock free readers that the table is about to change.
+ * Since there is one writer, load acquire on tbl_chng_cnt is not required.
+ */
+static inline void
+inc_tbl_chng_cnt(const struct rte_hash *h)
+{
+	if (h->readwrite_concur_lf_support) {
+		__atomic_store_n(h->tbl_chng_cnt,
+				 *h->tbl_chng_cnt + 1,
+				 __ATOMIC_RELEASE);
+		/* The stores to the table should not move above the store
+		 * to tbl_chng_cnt.
+		 */
+		__atomic_thread_fence(__ATOMIC_RELEASE);
+	}
+}
+
+int
+rte_hash_resize_start(struct rte_hash *h, uint32_t entries)
+{
+	struct rte_hash_bucket *buckets = NULL;
+	struct rte_ring *r = NULL, *old_r;
+	char ring_name[RTE_RING_NAMESIZE];
+	uint32_t num_buckets, num_key_slots, old_num_key_slots;
+	uint32_t *free_ids = NULL;
+	uint32_t n_free, n_removed, i;
+	void *k = NULL, *old_k;
+	int ret = -ENOMEM;
+
+	if (h == NULL || entries > RTE_HASH_ENTRIES_MAX ||
+			entries < RTE_HASH_BUCKET_ENTRIES)
+		return -EINVAL;
+
+	if (!h->resizable)
+		return -ENOTSUP;
+
+	/* Readers might still reference memory of the previous resize */
+	if (h->old_buckets != NULL || h->retired_key_store != NULL ||
+			h->retired_buckets != NULL)
+		return -EBUSY;
+
+	if (entries == h->entries)
+		return 0;
+
+	if ((uint32_t)rte_hash_count(h) > entries)
+		return -ENOSPC;
+
+	num_buckets = rte_align32pow2(entries) / RTE_HASH_BUCKET_ENTRIES;
+	/* Leave the first entry as a dummy entry for lookup_bulk */
+	num_key_slots = entries + 1;
+	old_num_key_slots = h->entries + 1;
+
+	if (num_buckets != h->num_buckets) {
+		buckets = rte_zmalloc_socket(NULL,
+				num_buckets * sizeof(struct rte_hash_bucket),
+				RTE_CACHE_LINE_SIZE, h->socket_id);
+		if (buckets == NULL) {
+			RTE_LOG(ERR, HASH, "buckets memory allocation failed\n");
+			goto err;
+		}
+	}
+
+	k = rte_zmalloc_socket(NULL,
+			(uint64_t)h->key_entry_size * num_key_slots,
+			RTE_CACHE_LINE_SIZE, h->socket_id);
+	free_ids = rte_malloc(NULL, sizeof(uint32_t) * old_num_key_slots, 0);
+	if (k == NULL || free_ids == NULL) {
+		RTE_LOG(ERR, HASH, "memory allocation failed\n");
+		goto err;
+	}
+
+	/* Both free slots rings exist until the new one is in use */
+	if (h->resize_gen & 1)
+		snprintf(ring_name, sizeof(ring_name), "HT_%s", h->name);
+	else
+		snprintf(ring_name, sizeof(ring_name), "HTR_%s", h->name);
+	r = rte_ring_create_elem(ring_name, sizeof(uint32_t),
+			rte_align32pow2(num_key_slots), h->socket_id, 0);
+	if (r == NULL) {
+		RTE_LOG(ERR, HASH, "memory allocation failed\n");
+		goto err;
+	}
+
+	__hash_rw_writer_lock(h);
+
+	/* When shrinking, all the key slots being removed must be free */
+	n_free = rte_ring_dequeue_burst_elem(h->free_slots, free_ids,
+			sizeof(uint32_t), old_num_key_slots, NULL);
+	for (i = 0, n_removed = 0; i < n_free; i++)
+		if (free_ids[i] >= num_key_slots)
+			n_removed++;
+	if (num_key_slots < old_num_key_slots &&
+			n_removed != old_num_key_slots - num_key_slots) {
+		rte_ring_enqueue_bulk_elem(h->free_slots, free_ids,
+				sizeof(uint32_t), n_free, NULL);
+		__hash_rw_writer_unlock(h);
+		ret = -EBUSY;
+		goto err;
+	}
+
+	/* Populate the new free slots ring, keeping the indexes in use */
+	for (i = 0; i < n_free; i++)
+		if (free_ids[i] < num_key_slots)
+			rte_ring_sp_enqueue_elem(r, &free_ids[i],
+						sizeof(uint32_t));
+	for (i = old_num_key_slots; i < num_key_slots; i++)
+		rte_ring_sp_enqueue_elem(r, &i, sizeof(uint32_t));
+
+	/* Keys keep their index, hence their position, in the new store */
+	memcpy(k, h->key_store, (uint64_t)h->key_entry_size *
+			RTE_MIN(num_key_slots, old_num_key_slots));
+
+	if (buckets != NULL) {
+		/* The current bucket table becomes the one keys are migrated
+		 * from. It is published before the new bucket table, so
+		 * that readers finding the new table empty look into it.
+		 */
+		h->old_num_buckets = h->num_buckets;
+		h->resize_cursor = 0;
+		store_buckets(&h->old_buckets, &h->old_bucket_bitmask,
+				h->buckets, h->bucket_bitmask);
+		inc_tbl_chng_cnt(h);
+		store_buckets(&h->buckets, &h->bucket_bitmask,
+				buckets, num_buckets - 1);
+		h->num_buckets = num_buckets;
+	}
+
+	/* Readers load the key store after the key index, the new store must
+	 * be visible before any new index is.
+	 */
+	old_k = h->key_store;
+	__atomic_store_n(&h->key_store, k, __ATOMIC_RELEASE);
+	old_r = h->free_slots;
+	h->free_slots = r;
+	h->entries = entries;
+	h->resize_gen++;
+
+	__hash_rw_writer_unlock(h);
+
+	rte_ring_free(old_r);
+	rte_free(free_ids);
+	if (h->readwrite_concur_lf_support)
+		h->retired_key_store = old_k;
+	else
+		rte_free(old_k);
+
+	return 0;
+err:
+	rte_ring_free(r);
+	rte_free(free_ids);
+	rte_free(k);
+	rte_free(buckets);
+	return ret;
+}
+
+/* Move the keys of one bucket of the bucket table being resized to the
+ * new bucket table. The key slots, hence the positions, are kept.
+ */
+static int
+rte_hash_resize_migrate_bucket(struct rte_hash *h,
+			struct rte_hash_bucket *old_bkt)
+{
+	uint32_t prim_bucket_idx, sec_bucket_idx, slot_id;
+	struct rte_hash_bucket *prim_bkt, *sec_bkt;
+	struct rte_hash_key *k;
+	uint32_t moved = 0;
+	uint16_t short_sig;
+	hash_sig_t sig;
+	int32_t ret_val;
+	unsigned int i;
+	int ret = 0;
+
+	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+		slot_id = old_bkt->key_idx[i];
+		if (slot_id == EMPTY_SLOT)
+			continue;
+
+		/* Only the short signature is stored, rehash the key */
+		k = RTE_PTR_ADD(h->key_store, slot_id * h->key_entry_size);
+		sig = rte_hash_hash(h, k->key);
+		short_sig = get_short_sig(sig);
+		prim_bucket_idx = get_prim_bucket_index(h, sig);
+		sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx,
+							short_sig);
+		prim_bkt = &h->buckets[prim_bucket_idx];
+		sec_bkt = &h->buckets[sec_bucket_idx];
+
+		ret = rte_hash_cuckoo_insert_mw(h, prim_bkt, sec_bkt,
+				(const struct rte_hash_key *)k->key, k->pdata,
+				short_sig, slot_id, &ret_val);
+		if (ret == -1)
+			ret = rte_hash_cuckoo_make_space_mw(h, prim_bkt,
+				sec_bkt, (const struct rte_hash_key *)k->key,
+				k->pdata, short_sig, prim_bucket_idx, slot_id,
+				&ret_val, 0);
+		if (ret < 0)
+			ret = rte_hash_cuckoo_make_space_mw(h, sec_bkt,
+				prim_bkt, (const struct rte_hash_key *)k->key,
+				k->pdata, short_sig, sec_bucket_idx, slot_id,
+				&ret_val, 0);
+		if (ret < 0) {
+			ret = -ENOSPC;
+			break;
+		}
+		moved |= 1 << i;
+	}
+
+	if (moved == 0)
+		return ret;
+
+	/* Remove the moved keys from the old bucket, once they can be found
+	 * in the new bucket table. Readers that missed them in the new table
+	 * before this point are informed through tbl_chng_cnt.
+	 */
+	__hash_rw_writer_lock(h);
+	inc_tbl_chng_cnt(h);
+	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+		if ((moved & (1 << i)) == 0)
+			continue;
+		old_bkt->sig_current[i] = NULL_SIGNATURE;
+		__atomic_store_n(&old_bkt->key_idx[i], EMPTY_SLOT,
+				__ATOMIC_RELEASE);
+	}
+	__hash_rw_writer_unlock(h);
+
+	return ret;
+}
+
+int
+rte_hash_resize_step(struct rte_hash *h, uint32_t num_buckets)
+{
+	struct rte_hash_bucket *old_buckets;
+	uint32_t n;
+	int ret;
+
+	if (h == NULL || num_buckets == 0)
+		return -EINVAL;
+
+	if (h->old_buckets == NULL)
+		return 0;
+
+	for (n = 0; n < num_buckets &&
+			h->resize_cursor < h->old_num_buckets; n++) {
+		ret = rte_hash_resize_migrate_bucket(h,
+				&h->old_buckets[h->resize_cursor]);
+		if (ret < 0)
+			return ret;
+		h->resize_cursor++;
+	}
+
+	if (h->resize_cursor < h->old_num_buckets)
+		return h->old_num_buckets - h->resize_cursor;
+
+	/* All the keys are in the new bucket table */
+	__hash_rw_writer_lock(h);
+	old_buckets = h->old_buckets;
+	__atomic_store_n(&h->old_buckets, NULL, __ATOMIC_RELEASE);
+	__hash_rw_writer_unlock(h);
+
+	if (h->readwrite_concur_lf_support)
+		h->retired_buckets = old_buckets;
+	else
+		rte_free(old_buckets);
+
+	return 0;
+}
+
+int
+rte_hash_resize_reclaim(struct rte_hash *h)
+{
+	if (h == NULL)
+		return -EINVAL;
+
+	if (h->old_buckets != NULL)
+		return -EBUSY;
+
+	rte_free(h->retired_key_store);
+	h->retired_key_store = NULL;
+	rte_free(h->retired_buckets);
+	h->retired_buckets = NULL;
+
+	return 0;
+}
+
 static inline void
 compare_signatures(uint32_t *prim_hash_matches, uint32_t *sec_hash_matches,
 			const struct rte_hash_bucket *prim_bkt,
@@ -1670,6 +2546,9 @@ compare_signatures(uint32_t *prim_hash_matches, uint32_t *sec_hash_matches,
 	/* For match mask the first bit of every two bits indicates the match */
 	switch (sig_cmp_fn) {
 #if defined(RTE_MACHINE_CPUFLAG_SSE2)
+#ifdef CC_AVX512_SUPPORT
+	case RTE_HASH_COMPARE_AVX512:
+#endif
 	case RTE_HASH_COMPARE_SSE:
 		/* Compare all signatures in the bucket */
 		*prim_hash_matches = _mm_movemask_epi8(_mm_cmpeq_epi16(
@@ -1711,6 +2590,32 @@ compare_signatures(uint32_t *prim_hash_matches, uint32_t *sec_hash_matches,
 	}
 }
 
+/*
+ * Compare the signatures of a burst of keys. With AVX512, the signatures of
+ * the primary and secondary buckets of two keys are compared with a single
+ * instruction.
+ */
+static inline void
+compare_signatures_bulk(uint32_t *prim_hash_matches,
+			uint32_t *sec_hash_matches,
+			const struct rte_hash_bucket **prim_bkt,
+			const struct rte_hash_bucket **sec_bkt,
+			const uint16_t *sig, int32_t num_keys,
+			enum rte_hash_sig_compare_function sig_cmp_fn)
+{
+	int32_t i = 0;
+
+#ifdef CC_AVX512_SUPPORT
+	if (sig_cmp_fn == RTE_HASH_COMPARE_AVX512)
+		i = compare_signatures_avx512(prim_hash_matches,
+				sec_hash_matches, prim_bkt, sec_bkt, sig,
+				num_keys);
+#endif
+	for (; i < num_keys; i++)
+		compare_signatures(&prim_hash_matches[i], &sec_hash_matches[i],
+				prim_bkt[i], sec_bkt[i], sig[i], sig_cmp_fn);
+}
+
 #define PREFETCH_OFFSET 4
 static inline void
 __rte_hash_lookup_bulk_l(const struct rte_hash *h, const void **keys,
@@ -1723,7 +2628,7 @@ __rte_hash_lookup_bulk_l(const struct rte_hash *h, const void **keys,
 	uint32_t prim_hash[RTE_HASH_LOOKUP_BULK_MAX];
 	uint32_t prim_index[RTE_HASH_LOOKUP_BULK_MAX];
 	uint32_t sec_index[RTE_HASH_LOOKUP_BULK_MAX];
-	uint16_t sig[RTE_HASH_LOOKUP_BULK_MAX];
+	uint16_t sig[RTE_HASH_LOOKUP_BULK_MAX] = {0};
 	const struct rte_hash_bucket *primary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
 	const struct rte_hash_bucket *secondary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
 	uint32_t prim_hitmask[RTE_HASH_LOOKUP_BULK_MAX] = {0};
@@ -1771,12 +2676,13 @@ __rte_hash_lookup_bulk_l(const struct rte_hash *h, const void **keys,
 
 	__hash_rw_reader_lock(h);
 
-	/* Compare signatures and prefetch key slot of first hit */
-	for (i = 0; i < num_keys; i++) {
-		compare_signatures(&prim_hitmask[i], &sec_hitmask[i],
-			primary_bkt[i], secondary_bkt[i],
-			sig[i], h->sig_cmp_fn);
+	/* Compare signatures of all keys */
+	compare_signatures_bulk(prim_hitmask, sec_hitmask,
+			primary_bkt, secondary_bkt, sig, num_keys,
+			h->sig_cmp_fn);
 
+	/* Prefetch key slot of first hit */
+	for (i = 0; i < num_keys; i++) {
 		if (prim_hitmask[i]) {
 			uint32_t first_hit =
 					__builtin_ctzl(prim_hitmask[i])
@@ -1868,8 +2774,9 @@ __rte_hash_lookup_bulk_l(const struct rte_hash *h, const void **keys,
 		continue;
 	}
 
-	/* all found, do not need to go through ext bkt */
-	if ((hits == ((1ULL << num_keys) - 1)) || !h->ext_table_support) {
+	/* all found, do not need to go through ext bkt or old buckets */
+	if ((hits == RTE_LEN2MASK(num_keys, uint64_t)) ||
+			(!h->ext_table_support && h->old_buckets == NULL)) {
 		if (hit_mask != NULL)
 			*hit_mask = hits;
 		__hash_rw_reader_unlock(h);
@@ -1877,7 +2784,7 @@ __rte_hash_lookup_bulk_l(const struct rte_hash *h, const void **keys,
 	}
 
 	/* need to check ext buckets for match */
-	for (i = 0; i < num_keys; i++) {
+	for (i = 0; i < num_keys && h->ext_table_support; i++) {
 		if ((hits & (1ULL << i)) != 0)
 			continue;
 		next_bkt = secondary_bkt[i]->next;
@@ -1896,6 +2803,18 @@ __rte_hash_lookup_bulk_l(const struct rte_hash *h, const void **keys,
 		}
 	}
 
+	/* need to check the bucket table being resized for match */
+	for (i = 0; i < num_keys && h->old_buckets != NULL; i++) {
+		if ((hits & (1ULL << i)) != 0)
+			continue;
+		ret = search_old_buckets_l(h, keys[i], prim_hash[i],
+				data != NULL ? &data[i] : NULL);
+		if (ret != -1) {
+			positions[i] = ret;
+			hits |= 1ULL << i;
+		}
+	}
+
 	__hash_rw_reader_unlock(h);
 
 	if (hit_mask != NULL)
@@ -1913,7 +2832,7 @@ __rte_hash_lookup_bulk_lf(const struct rte_hash *h, const void **keys,
 	uint32_t prim_hash[RTE_HASH_LOOKUP_BULK_MAX];
 	uint32_t prim_index[RTE_HASH_LOOKUP_BULK_MAX];
 	uint32_t sec_index[RTE_HASH_LOOKUP_BULK_MAX];
-	uint16_t sig[RTE_HASH_LOOKUP_BULK_MAX];
+	uint16_t sig[RTE_HASH_LOOKUP_BULK_MAX] = {0};
 	const struct rte_hash_bucket *primary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
 	const struct rte_hash_bucket *secondary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
 	uint32_t prim_hitmask[RTE_HASH_LOOKUP_BULK_MAX] = {0};
@@ -1971,12 +2890,31 @@ __rte_hash_lookup_bulk_lf(const struct rte_hash *h, const void **keys,
 		cnt_b = __atomic_load_n(h->tbl_chng_cnt,
 					__ATOMIC_ACQUIRE);
 
-		/* Compare signatures and prefetch key slot of first hit */
-		for (i = 0; i < num_keys; i++) {
-			compare_signatures(&prim_hitmask[i], &sec_hitmask[i],
-				primary_bkt[i], secondary_bkt[i],
-				sig[i], h->sig_cmp_fn);
+		/* The bucket table can be replaced by a resize, the
+		 * buckets located above are only used for prefetching.
+		 */
+		if (unlikely(h->resizable)) {
+			struct rte_hash_bucket *buckets;
+			uint32_t bitmask;
+
+			buckets = load_buckets_lf(&h->buckets,
+					&h->bucket_bitmask, &bitmask);
+			for (i = 0; i < num_keys; i++) {
+				prim_index[i] = prim_hash[i] & bitmask;
+				sec_index[i] = (prim_index[i] ^ sig[i]) &
+						bitmask;
+				primary_bkt[i] = &buckets[prim_index[i]];
+				secondary_bkt[i] = &buckets[sec_index[i]];
+			}
+		}
 
+		/* Compare signatures of all keys */
+		compare_signatures_bulk(prim_hitmask, sec_hitmask,
+				primary_bkt, secondary_bkt, sig, num_keys,
+				h->sig_cmp_fn);
+
+		/* Prefetch key slot of first hit */
+		for (i = 0; i < num_keys; i++) {
 			if (prim_hitmask[i]) {
 				uint32_t first_hit =
 						__builtin_ctzl(prim_hitmask[i])
@@ -2017,7 +2955,9 @@ __rte_hash_lookup_bulk_lf(const struct rte_hash *h, const void **keys,
 					__ATOMIC_ACQUIRE);
 				const struct rte_hash_key *key_slot =
 					(const struct rte_hash_key *)(
-					(const char *)h->key_store +
+					(const char *)__atomic_load_n(
+						&h->key_store,
+						__ATOMIC_RELAXED) +
 					key_idx * h->key_entry_size);
 
 				/*
@@ -2049,7 +2989,9 @@ __rte_hash_lookup_bulk_lf(const struct rte_hash *h, const void **keys,
 					__ATOMIC_ACQUIRE);
 				const struct rte_hash_key *key_slot =
 					(const struct rte_hash_key *)(
-					(const char *)h->key_store +
+					(const char *)__atomic_load_n(
+						&h->key_store,
+						__ATOMIC_RELAXED) +
 					key_idx * h->key_entry_size);
 
 				/*
@@ -2076,7 +3018,7 @@ __rte_hash_lookup_bulk_lf(const struct rte_hash *h, const void **keys,
 		}
 
 		/* all found, do not need to go through ext bkt */
-		if (hits == ((1ULL << num_keys) - 1)) {
+		if (hits == RTE_LEN2MASK(num_keys, uint64_t)) {
 			if (hit_mask != NULL)
 				*hit_mask = hits;
 			return;
@@ -2104,6 +3046,20 @@ __rte_hash_lookup_bulk_lf(const struct rte_hash *h, const void **keys,
 				}
 			}
 		}
+		/* need to check the bucket table being resized for match */
+		if (unlikely(h->resizable)) {
+			for (i = 0; i < num_keys; i++) {
+				if ((hits & (1ULL << i)) != 0)
+					continue;
+				ret = search_old_buckets_lf(h, keys[i],
+						prim_hash[i],
+						data != NULL ? &data[i] : NULL);
+				if (ret != -1) {
+					positions[i] = ret;
+					hits |= 1ULL << i;
+				}
+			}
+		}
 		/* The loads of sig_current in compare_signatures
 		 * should not move below the load from tbl_chng_cnt.
 		 */
@@ -2135,6 +3091,14 @@ __rte_hash_lookup_bulk(const struct rte_hash *h, const void **keys,
 	else
 		__rte_hash_lookup_bulk_l(h, keys, num_keys, positions,
 					 hit_mask, data);
+
+	if (unlikely(h->aging)) {
+		int32_t i;
+
+		for (i = 0; i < num_keys; i++)
+			if (positions[i] >= 0)
+				hash_age_touch(h, positions[i] + 1);
+	}
 }
 
 int
@@ -2165,6 +3129,138 @@ rte_hash_lookup_bulk_data(const struct rte_hash *h, const void **keys,
 	return __builtin_popcountl(*hit_mask);
 }
 
+int
+rte_hash_age_tick(struct rte_hash *h)
+{
+	uint32_t now;
+
+	if (h == NULL)
+		return -EINVAL;
+
+	if (!h->aging)
+		return -ENOTSUP;
+
+	/* Age tick 0 marks key slots without access time, skip it on wrap */
+	now = h->age_now + 1;
+	if (now == 0)
+		now = 1;
+	__atomic_store_n(&h->age_now, now, __ATOMIC_RELAXED);
+
+	return 0;
+}
+
+int
+rte_hash_age_expire(const struct rte_hash *h, uint32_t max_age,
+		const void **keys, void **data, int32_t *positions,
+		uint32_t max_keys, uint32_t max_scan, uint32_t *next)
+{
+	struct rte_hash_key *k;
+	uint32_t num_key_slots, slot_id, age, now, n;
+	uint32_t num_expired = 0;
+	void *d;
+	int32_t ret;
+
+	if (h == NULL || keys == NULL || data == NULL || positions == NULL ||
+			next == NULL)
+		return -EINVAL;
+
+	if (!h->aging)
+		return -ENOTSUP;
+
+	num_key_slots = rte_hash_max_key_id(h) + 1;
+	now = __atomic_load_n(&h->age_now, __ATOMIC_RELAXED);
+	/* Slot 0 is the dummy entry for lookup_bulk */
+	slot_id = *next + 1;
+
+	for (n = 0; n < max_scan && num_expired < max_keys; n++) {
+		if (slot_id >= num_key_slots) {
+			/* Wrap around, so that the scan can run forever */
+			slot_id = 1;
+			if (n != 0)
+				break;
+		}
+
+		age = __atomic_load_n(&h->key_age[slot_id], __ATOMIC_RELAXED);
+		if (age == 0 || (uint32_t)(now - age) < max_age) {
+			slot_id++;
+			continue;
+		}
+
+		/* The slot might have been freed or reused since the age was
+		 * stored. Report the key only if a lookup still finds it at
+		 * this position. The lookup does not record an access.
+		 */
+		k = RTE_PTR_ADD(h->key_store, slot_id * h->key_entry_size);
+		if (h->readwrite_concur_lf_support)
+			ret = __rte_hash_lookup_with_hash_lf(h, k->key,
+					rte_hash_hash(h, k->key), &d);
+		else
+			ret = __rte_hash_lookup_with_hash_l(h, k->key,
+					rte_hash_hash(h, k->key), &d);
+
+		if (ret == (int32_t)(slot_id - 1)) {
+			keys[num_expired] = k->key;
+			data[num_expired] = d;
+			positions[num_expired] = ret;
+			num_expired++;
+		} else {
+			/* Stale age of a free slot, unless the slot was
+			 * accessed again meanwhile.
+			 */
+			__atomic_compare_exchange_n(&h->key_age[slot_id],
+					&age, 0, 0, __ATOMIC_RELAXED,
+					__ATOMIC_RELAXED);
+		}
+		slot_id++;
+	}
+
+	*next = slot_id >= num_key_slots ? 0 : slot_id - 1;
+
+	return num_expired;
+}
+
+/* Iterate the bucket table being resized. In the iterator space of a
+ * resizable table it follows the current bucket table, in place of the
+ * extendable buckets.
+ */
+static int32_t
+rte_hash_iterate_old_buckets(const struct rte_hash *h, const void **key,
+		void **data, uint32_t *next, uint32_t total_entries_main)
+{
+	uint32_t bucket_idx, idx, position;
+	struct rte_hash_key *next_key;
+	const uint32_t total_entries = total_entries_main +
+			h->old_num_buckets * RTE_HASH_BUCKET_ENTRIES;
+
+	if (*next >= total_entries)
+		return -ENOENT;
+
+	bucket_idx = (*next - total_entries_main) / RTE_HASH_BUCKET_ENTRIES;
+	idx = (*next - total_entries_main) % RTE_HASH_BUCKET_ENTRIES;
+
+	while ((position = h->old_buckets[bucket_idx].key_idx[idx]) ==
+			EMPTY_SLOT) {
+		(*next)++;
+		if (*next == total_entries)
+			return -ENOENT;
+		bucket_idx = (*next - total_entries_main) /
+						RTE_HASH_BUCKET_ENTRIES;
+		idx = (*next - total_entries_main) % RTE_HASH_BUCKET_ENTRIES;
+	}
+	__hash_rw_reader_lock(h);
+	next_key = (struct rte_hash_key *) ((char *)h->key_store +
+				position * h->key_entry_size);
+	/* Return key and data */
+	*key = next_key->key;
+	*data = next_key->pdata;
+
+	__hash_rw_reader_unlock(h);
+
+	/* Increment iterator */
+	(*next)++;
+	return position - 1;
+}
+
 int32_t
 rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32_t *next)
 {
@@ -2212,6 +3308,10 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 
 /* Begin to iterate extendable buckets */
 extend_table:
+	if (h->old_buckets != NULL)
+		return rte_hash_iterate_old_buckets(h, key, data, next,
+						total_entries_main);
+
 	/* Out of total bound or if ext bucket feature is not enabled */
 	if (*next >= total_entries || !h->ext_table_support)
 		return -ENOENT;
@@ -2240,3 +3340,296 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 	(*next)++;
 	return position - 1;
 }
+
+/* "HASH" */
+#define HASH_SNAPSHOT_MAGIC	0x48534148
+#define HASH_SNAPSHOT_VERSION	1
+
+/*
+ * A saved hash table is this header followed by the buckets, the key
+ * store, the extendable buckets and the key ages, if the table has them.
+ * The pointers to the next extendable bucket are saved as the index of
+ * the bucket plus one, as in the free extendable buckets ring.
+ */
+struct hash_snapshot_hdr {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t entries;
+	uint32_t key_len;
+	uint32_t num_buckets;
+	uint32_t num_key_slots;
+	uint32_t probe_hash;
+	/**< Hash of a fixed key, to check the hash function is the same */
+	uint32_t age_now;
+	uint8_t ext_table_support;
+	uint8_t use_local_cache;
+	uint8_t aging;
+	uint8_t rsvd[5];
+};
+
+static uint32_t
+hash_num_key_slots(const struct rte_hash *h)
+{
+	if (h->use_local_cache)
+		return h->entries + (RTE_MAX_LCORE - 1) *
+			(LCORE_CACHE_SIZE - 1) + 1;
+	return h->entries + 1;
+}
+
+static int
+hash_probe(const struct rte_hash *h, uint32_t *sig)
+{
+	uint8_t *key;
+	uint32_t i;
+
+	key = malloc(h->key_len);
+	if (key == NULL)
+		return -ENOMEM;
+	for (i = 0; i < h->key_len; i++)
+		key[i] = i * 37 + 1;
+	*sig = rte_hash_hash(h, key);
+	free(key);
+	return 0;
+}
+
+static int
+hash_save_buckets(const struct rte_hash *h,
+		const struct rte_hash_bucket *buckets, FILE *f)
+{
+	struct rte_hash_bucket bkt, *next;
+	uint32_t i;
+
+	if (!h->ext_table_support)
+		return (fwrite(buckets, sizeof(*buckets), h->num_buckets, f) ==
+			h->num_buckets) ? 0 : -EIO;
+
+	for (i = 0; i < h->num_buckets; i++) {
+		bkt = buckets[i];
+		if (bkt.next != NULL) {
+			next = bkt.next;
+			bkt.next = (void *)(uintptr_t)
+				(next - h->buckets_ext + 1);
+		}
+		if (fwrite(&bkt, sizeof(bkt), 1, f) != 1)
+			return -EIO;
+	}
+	return 0;
+}
+
+static int
+hash_restore_buckets(const struct rte_hash *h,
+		struct rte_hash_bucket *buckets, FILE *f)
+{
+	uintptr_t next;
+	uint32_t i;
+
+	if (fread(buckets, sizeof(*buckets), h->num_buckets, f) !=
+			h->num_buckets)
+		return -EIO;
+
+	for (i = 0; i < h->num_buckets; i++) {
+		next = (uintptr_t)buckets[i].next;
+		if (next == 0)
+			continue;
+		if (!h->ext_table_support || next > h->num_buckets)
+			return -EINVAL;
+		buckets[i].next = &h->buckets_ext[next - 1];
+	}
+	return 0;
+}
+
+/* Fill the free key slots and extendable buckets rings */
+static int
+hash_restore_free_lists(struct rte_hash *h)
+{
+	const uint32_t num_key_slots = hash_num_key_slots(h);
+	struct rte_hash_bucket *bkt;
+	uint8_t *used_slots, *used_ext;
+	uint32_t i, j, key_idx;
+	int ret = 0;
+
+	used_slots = calloc(num_key_slots + h->num_buckets + 1, 1);
+	if (used_slots == NULL)
+		return -ENOMEM;
+	used_ext = used_slots + num_key_slots;
+
+	for (i = 0; i < h->num_buckets && ret == 0; i++) {
+		for (bkt = &h->buckets[i]; bkt != NULL; bkt = bkt->next) {
+			if (bkt != &h->buckets[i]) {
+				/* an extendable bucket is in a single chain */
+				j = bkt - h->buckets_ext + 1;
+				if (used_ext[j]) {
+					ret = -EINVAL;
+					break;
+				}
+				used_ext[j] = 1;
+			}
+			for (j = 0; j < RTE_HASH_BUCKET_ENTRIES; j++) {
+				key_idx = bkt->key_idx[j];
+				if (key_idx >= num_key_slots) {
+					ret = -EINVAL;
+					break;
+				}
+				used_slots[key_idx] = 1;
+			}
+		}
+	}
+
+	if (ret == 0) {
+		rte_ring_reset(h->free_slots);
+		for (i = 1; i < num_key_slots; i++)
+			if (!used_slots[i])
+				rte_ring_sp_enqueue_elem(h->free_slots, &i,
+					sizeof(uint32_t));
+		if (h->ext_table_support) {
+			rte_ring_reset(h->free_ext_bkts);
+			for (i = 1; i <= h->num_buckets; i++)
+				if (!used_ext[i])
+					rte_ring_sp_enqueue_elem(
+						h->free_ext_bkts, &i,
+						sizeof(uint32_t));
+		}
+	}
+
+	free(used_slots);
+	return ret;
+}
+
+int
+rte_hash_save(const struct rte_hash *h, FILE *f)
+{
+	struct hash_snapshot_hdr hdr;
+	uint32_t num_key_slots;
+	int ret;
+
+	if (h == NULL || f == NULL)
+		return -EINVAL;
+
+	__hash_rw_reader_lock(h);
+	if (h->old_buckets != NULL) {
+		ret = -EBUSY;
+		goto exit;
+	}
+
+	num_key_slots = hash_num_key_slots(h);
+	memset(&hdr, 0, sizeof(hdr));
+	hdr.magic = HASH_SNAPSHOT_MAGIC;
+	hdr.version = HASH_SNAPSHOT_VERSION;
+	hdr.entries = h->entries;
+	hdr.key_len = h->key_len;
+	hdr.num_buckets = h->num_buckets;
+	hdr.num_key_slots = num_key_slots;
+	hdr.age_now = h->age_now;
+	hdr.ext_table_support = h->ext_table_support;
+	hdr.use_local_cache = h->use_local_cache;
+	hdr.aging = h->aging;
+	ret = hash_probe(h, &hdr.probe_hash);
+	if (ret != 0)
+		goto exit;
+
+	if (fwrite(&hdr, sizeof(hdr), 1, f) != 1) {
+		ret = -EIO;
+		goto exit;
+	}
+	ret = hash_save_buckets(h, h->buckets, f);
+	if (ret != 0)
+		goto exit;
+	if (fwrite(h->key_store, h->key_entry_size, num_key_slots, f) !=
+			num_key_slots) {
+		ret = -EIO;
+		goto exit;
+	}
+	if (h->ext_table_support) {
+		ret = hash_save_buckets(h, h->buckets_ext, f);
+		if (ret != 0)
+			goto exit;
+	}
+	if (h->aging && fwrite(h->key_age, sizeof(uint32_t), num_key_slots,
+			f) != num_key_slots)
+		ret = -EIO;
+
+exit:
+	__hash_rw_reader_unlock(h);
+	return ret;
+}
+
+struct rte_hash *
+rte_hash_restore(const struct rte_hash_parameters *params, FILE *f)
+{
+	struct rte_hash_parameters hash_params;
+	struct hash_snapshot_hdr hdr;
+	struct rte_hash *h;
+	uint32_t num_key_slots, probe_hash;
+	int ret;
+
+	if (params == NULL || f == NULL) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	if (fread(&hdr, sizeof(hdr), 1, f) != 1) {
+		rte_errno = EIO;
+		return NULL;
+	}
+	if (hdr.magic != HASH_SNAPSHOT_MAGIC ||
+			hdr.version != HASH_SNAPSHOT_VERSION) {
+		RTE_LOG(ERR, HASH, "hash %s snapshot format is not supported\n",
+			params->name);
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	/* The table may have been resized since it was created */
+	hash_params = *params;
+	hash_params.entries = hdr.entries;
+	h = rte_hash_create(&hash_params);
+	if (h == NULL)
+		return NULL;
+
+	num_key_slots = hash_num_key_slots(h);
+	ret = hash_probe(h, &probe_hash);
+	if (ret != 0)
+		goto err;
+	if (h->key_len != hdr.key_len || h->num_buckets != hdr.num_buckets ||
+			num_key_slots != hdr.num_key_slots ||
+			h->ext_table_support != hdr.ext_table_support ||
+			h->use_local_cache != hdr.use_local_cache ||
+			h->aging != hdr.aging || probe_hash != hdr.probe_hash) {
+		RTE_LOG(ERR, HASH, "hash %s parameters do not match the saved "
+			"table\n", params->name);
+		ret = -EINVAL;
+		goto err;
+	}
+
+	ret = hash_restore_buckets(h, h->buckets, f);
+	if (ret != 0)
+		goto err;
+	if (fread(h->key_store, h->key_entry_size, num_key_slots, f) !=
+			num_key_slots) {
+		ret = -EIO;
+		goto err;
+	}
+	if (h->ext_table_support) {
+		ret = hash_restore_buckets(h, h->buckets_ext, f);
+		if (ret != 0)
+			goto err;
+	}
+	if (h->aging) {
+		if (fread(h->key_age, sizeof(uint32_t), num_key_slots, f) !=
+				num_key_slots) {
+			ret = -EIO;
+			goto err;
+		}
+		h->age_now = hdr.age_now;
+	}
+
+	ret = hash_restore_free_lists(h);
+	if (ret != 0)
+		goto err;
+
+	return h;
+err:
+	rte_hash_free(h);
+	rte_errno = -ret;
+	return NULL;
+}
@@ -66,7 +66,7 @@ enum cmp_jump_table_case {
  * Table storing all different key compare functions
  * (multi-process supported)
  */
-const rte_hash_cmp_eq_t cmp_jump_table[NUM_KEY_CMP_CASES] = {
+static const rte_hash_cmp_eq_t cmp_jump_table[NUM_KEY_CMP_CASES] = {
 	NULL,
 	rte_hash_k16_cmp_eq,
 	rte_hash_k32_cmp_eq,
@@ -93,7 +93,7 @@ enum cmp_jump_table_case {
  * Table storing all different key compare functions
  * (multi-process supported)
  */
-const rte_hash_cmp_eq_t cmp_jump_table[NUM_KEY_CMP_CASES] = {
+static const rte_hash_cmp_eq_t cmp_jump_table[NUM_KEY_CMP_CASES] = {
 	NULL,
 	memcmp
 };
@@ -142,6 +142,7 @@ enum rte_hash_sig_compare_function {
 	RTE_HASH_COMPARE_SCALAR = 0,
 	RTE_HASH_COMPARE_SSE,
 	RTE_HASH_COMPARE_NEON,
+	RTE_HASH_COMPARE_AVX512,
 	RTE_HASH_COMPARE_NUM
 };
 
@@ -191,6 +192,10 @@ struct rte_hash {
 	/**< If read-write concurrency lock free support is enabled */
 	uint8_t writer_takes_lock;
 	/**< Indicates if the writer threads need to take lock */
+	uint8_t resizable;
+	/**< If the table can be resized with rte_hash_resize_xxx APIs */
+	uint8_t aging;
+	/**< If the last access time of the keys is kept */
 	rte_hash_function hash_func;    /**< Function used to calculate hash. */
 	uint32_t hash_func_init_val;    /**< Init value used by hash_func. */
 	rte_hash_cmp_eq_t rte_hash_custom_cmp_eq;
@@ -208,6 +213,9 @@ struct rte_hash {
 	/**< Table with buckets storing all the	hash values and key indexes
 	 * to the key table.
 	 */
+	uint32_t *key_age;
+	/**< Age tick of the last access of each key slot, 0 for none. */
+	uint32_t age_now;               /**< Current age tick of the table. */
 	rte_rwlock_t *readwrite_lock; /**< Read-write lock thread-safety. */
 	struct rte_hash_bucket *buckets_ext; /**< Extra buckets array */
 	struct rte_ring *free_ext_bkts; /**< Ring of indexes of free buckets */
@@ -220,6 +228,25 @@ struct rte_hash {
 	uint32_t *ext_bkt_to_free;
 	uint32_t *tbl_chng_cnt;
 	/**< Indicates if the hash table changed from last read. */
+	struct rte_hash_bucket *old_buckets;
+	/**< Bucket table keys are migrated from while a resize is in
+	 * progress, NULL otherwise.
+	 */
+	uint32_t old_num_buckets;
+	/**< Number of buckets in the old bucket table. */
+	uint32_t old_bucket_bitmask;
+	/**< Bitmask for getting bucket index in the old bucket table. */
+	uint32_t resize_cursor;
+	/**< Next bucket of the old bucket table to migrate. */
+	uint32_t resize_gen;
+	/**< Number of resizes started, used to name the free slots ring. */
+	int socket_id;                  /**< NUMA socket ID for memory. */
+	/* Memory replaced by a resize. When lock free read-write concurrency
+	 * is enabled, it cannot be freed immediately (as readers might be
+	 * using it still) and is freed by rte_hash_resize_reclaim.
+	 */
+	void *retired_key_store;
+	struct rte_hash_bucket *retired_buckets;
 } __rte_cache_aligned;
 
 struct queue_node {
@@ -230,4 +257,16 @@ struct queue_node {
 	int prev_slot;               /* Parent(slot) in search path */
 };
 
+/*
+ * Compare the signatures of the keys of a burst two at a time with AVX512.
+ * Return the number of keys compared, the last key of an odd burst is left
+ * to the caller.
+ */
+int32_t
+compare_signatures_avx512(uint32_t *prim_hash_matches,
+			uint32_t *sec_hash_matches,
+			const struct rte_hash_bucket **prim_bkt,
+			const struct rte_hash_bucket **sec_bkt,
+			const uint16_t *sig, int32_t num_keys);
+
 #endif
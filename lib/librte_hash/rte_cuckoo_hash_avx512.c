@@ -0,0 +1,53 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#include <rte_common.h>
+#include <rte_rwlock.h>
+#include <rte_vect.h>
+#include "rte_hash.h"
+#include "rte_cuckoo_hash.h"
+#include <immintrin.h>
+
+int32_t
+compare_signatures_avx512(uint32_t *prim_hash_matches,
+			uint32_t *sec_hash_matches,
+			const struct rte_hash_bucket **prim_bkt,
+			const struct rte_hash_bucket **sec_bkt,
+			const uint16_t *sig, int32_t num_keys)
+{
+	int32_t i;
+
+	/*
+	 * The eight signatures of the primary and secondary buckets of two
+	 * keys fill one 64-byte register, so they are all compared with
+	 * the signatures of both keys in a single instruction.
+	 */
+	for (i = 0; i + 1 < num_keys; i += 2) {
+		__m512i sigs, cmp_sigs;
+		uint64_t matches;
+
+		sigs = _mm512_castsi128_si512(_mm_load_si128(
+			(__m128i const *)prim_bkt[i]->sig_current));
+		sigs = _mm512_inserti32x4(sigs, _mm_load_si128(
+			(__m128i const *)sec_bkt[i]->sig_current), 1);
+		sigs = _mm512_inserti32x4(sigs, _mm_load_si128(
+			(__m128i const *)prim_bkt[i + 1]->sig_current), 2);
+		sigs = _mm512_inserti32x4(sigs, _mm_load_si128(
+			(__m128i const *)sec_bkt[i + 1]->sig_current), 3);
+		cmp_sigs = _mm512_inserti64x4(_mm512_set1_epi16(sig[i]),
+			_mm256_set1_epi16(sig[i + 1]), 1);
+
+		/* Expand the match of each entry to two bits,
+		 * as the SSE compare does
+		 */
+		matches = _mm512_movepi8_mask(_mm512_movm_epi16(
+			_mm512_cmpeq_epi16_mask(sigs, cmp_sigs)));
+		prim_hash_matches[i] = (uint16_t)matches;
+		sec_hash_matches[i] = (uint16_t)(matches >> 16);
+		prim_hash_matches[i + 1] = (uint16_t)(matches >> 32);
+		sec_hash_matches[i + 1] = (uint16_t)(matches >> 48);
+	}
+
+	return i;
+}
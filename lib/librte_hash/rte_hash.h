@@ -13,6 +13,7 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include <stdio.h>
 
 #include <rte_compat.h>
 
@@ -54,6 +55,18 @@ extern "C" {
  */
 #define RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF 0x20
 
+/** Flag to allow the table to be resized online using the
+ * rte_hash_resize_xxx APIs. Cannot be combined with
+ * RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD or RTE_HASH_EXTRA_FLAGS_EXT_TABLE.
+ */
+#define RTE_HASH_EXTRA_FLAGS_RESIZABLE 0x40
+
+/** Flag to keep the time of the last access of each key, so that idle keys
+ * can be found with rte_hash_age_expire(). Cannot be combined with
+ * RTE_HASH_EXTRA_FLAGS_RESIZABLE.
+ */
+#define RTE_HASH_EXTRA_FLAGS_AGING 0x80
+
 /**
  * The type of hash value of a key.
  * It should be a value of at least 32bit with fully random pattern.
@@ -280,6 +293,41 @@ rte_hash_add_key(const struct rte_hash *h, const void *key);
 int32_t
 rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key, hash_sig_t sig);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Add multiple key-value pairs to an existing hash table.
+ * The signatures of all keys are computed and their buckets prefetched
+ * before the keys are added, and the writer lock is taken once
+ * for the whole burst.
+ * If a key already exists in the table, its data is updated.
+ * This operation is not multi-thread safe
+ * and should only be called from one thread by default.
+ * Thread safety can be enabled by setting flag during
+ * table creation.
+ *
+ * @param h
+ *   Hash table to add the keys to.
+ * @param keys
+ *   A pointer to a list of keys to add to the hash table.
+ * @param num_keys
+ *   How many keys are in the keys list (less than RTE_HASH_LOOKUP_BULK_MAX).
+ * @param data
+ *   Data to add to the hash table for each key.
+ * @param positions
+ *   Output containing, for each key, either the position of the key
+ *   in the table (the same value rte_hash_add_key would return),
+ *   or -ENOSPC if there is no space in the hash for this key.
+ * @return
+ *   - -EINVAL if the parameters are invalid.
+ *   - Number of keys added or updated.
+ */
+__rte_experimental
+int
+rte_hash_add_key_bulk_data(const struct rte_hash *h, const void **keys,
+			uint32_t num_keys, void *data[], int32_t *positions);
+
 /**
  * Remove a key from an existing hash table.
  * This operation is not multi-thread safe
@@ -340,6 +388,41 @@ rte_hash_del_key(const struct rte_hash *h, const void *key);
 int32_t
 rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key, hash_sig_t sig);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Remove multiple keys from an existing hash table.
+ * The signatures of all keys are computed and their buckets prefetched
+ * before the keys are removed, and the writer lock is taken once
+ * for the whole burst.
+ * This operation is not multi-thread safe
+ * and should only be called from one thread by default.
+ * Thread safety can be enabled by setting flag during
+ * table creation.
+ * As with rte_hash_del_key, if RTE_HASH_EXTRA_FLAGS_NO_FREE_ON_DEL or
+ * RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF is enabled, the returned
+ * positions must be freed with rte_hash_free_key_with_position.
+ *
+ * @param h
+ *   Hash table to remove the keys from.
+ * @param keys
+ *   A pointer to a list of keys to remove from the hash table.
+ * @param num_keys
+ *   How many keys are in the keys list (less than RTE_HASH_LOOKUP_BULK_MAX).
+ * @param positions
+ *   Output containing, for each key, either the position the key was
+ *   stored at (the same value that was returned when it was added),
+ *   or -ENOENT if the key is not found.
+ * @return
+ *   - -EINVAL if the parameters are invalid.
+ *   - Number of keys removed.
+ */
+__rte_experimental
+int
+rte_hash_del_key_bulk(const struct rte_hash *h, const void **keys,
+			uint32_t num_keys, int32_t *positions);
+
 /**
  * Find a key in the hash table given the position.
  * This operation is multi-thread safe with regarding to other lookup threads.
@@ -390,6 +473,169 @@ int
 rte_hash_free_key_with_position(const struct rte_hash *h,
 				const int32_t position);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Start resizing the hash table to hold 'entries' keys.
+ * The table must have been created with RTE_HASH_EXTRA_FLAGS_RESIZABLE.
+ * This allocates the new bucket table, key store and free slot ring and
+ * makes new insertions go to the new bucket table. Existing keys are
+ * migrated incrementally by rte_hash_resize_step(). Lookups, adds and
+ * deletes keep working while the migration is in progress, and the
+ * position returned for a key does not change.
+ *
+ * This is a writer operation. It must not be called concurrently with
+ * other writers of the table.
+ *
+ * When shrinking, all positions larger than or equal to the new number of
+ * entries must be free, including positions of deleted keys that were not
+ * yet freed with rte_hash_free_key_with_position().
+ *
+ * When RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF is enabled, the memory
+ * replaced by a resize is not freed immediately, as readers might still be
+ * referencing it. rte_hash_resize_reclaim() must be called once all the
+ * readers have stopped referencing the table, before the next resize can
+ * be started.
+ *
+ * @param h
+ *   Hash table to resize.
+ * @param entries
+ *   New total number of entries of the table.
+ * @return
+ *   - 0 if the resize was started (or the table already has this size)
+ *   - -EINVAL if the parameters are invalid
+ *   - -ENOTSUP if the table was not created with
+ *     RTE_HASH_EXTRA_FLAGS_RESIZABLE
+ *   - -EBUSY if a resize is in progress, memory of a previous resize was
+ *     not reclaimed yet, or a position that would be removed is in use
+ *   - -ENOSPC if the table holds more keys than 'entries'
+ *   - -ENOMEM if the memory allocation failed
+ */
+__rte_experimental
+int
+rte_hash_resize_start(struct rte_hash *h, uint32_t entries);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Migrate keys of a resize started with rte_hash_resize_start() to the new
+ * bucket table. At most 'num_buckets' buckets of the old bucket table are
+ * migrated per call, which bounds the time spent in the call. The resize
+ * completes when all the buckets have been migrated.
+ *
+ * This is a writer operation. It must not be called concurrently with
+ * other writers of the table.
+ *
+ * @param h
+ *   Hash table to resize.
+ * @param num_buckets
+ *   Maximum number of old buckets to migrate.
+ * @return
+ *   - 0 if the resize is complete (or no resize is in progress)
+ *   - A positive value giving the number of old buckets still to migrate
+ *   - -EINVAL if the parameters are invalid
+ *   - -ENOSPC if a key could not be placed in the new bucket table. The
+ *     resize stays in progress and the call can be retried, for example
+ *     after deleting keys.
+ */
+__rte_experimental
+int
+rte_hash_resize_step(struct rte_hash *h, uint32_t num_buckets);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Free the memory replaced by the last resize of a hash table created with
+ * RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF. This API should be called after
+ * all the readers have stopped referencing the old bucket table and key
+ * store, i.e. after the resize completed and the readers went through a
+ * quiescent state.
+ *
+ * @param h
+ *   Hash table to reclaim memory from.
+ * @return
+ *   - 0 if the memory was freed (or there was nothing to free)
+ *   - -EINVAL if the parameters are invalid
+ *   - -EBUSY if a resize is still in progress
+ */
+__rte_experimental
+int
+rte_hash_resize_reclaim(struct rte_hash *h);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Advance the age clock of a hash table created with
+ * RTE_HASH_EXTRA_FLAGS_AGING. Adds, updates and lookups of a key record
+ * the current age tick of the table in the key slot. The application
+ * chooses the period of the clock, for example by calling this API from
+ * a timer. It can be called concurrently with readers and writers of the
+ * table, but not with itself.
+ *
+ * @param h
+ *   Hash table to advance the age clock of.
+ * @return
+ *   - 0 on success
+ *   - -EINVAL if the parameters are invalid
+ *   - -ENOTSUP if the table was not created with RTE_HASH_EXTRA_FLAGS_AGING
+ */
+__rte_experimental
+int
+rte_hash_age_tick(struct rte_hash *h);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Find keys of a hash table created with RTE_HASH_EXTRA_FLAGS_AGING that
+ * were not accessed during the last 'max_age' ticks of the age clock.
+ * The key slots are scanned from the cursor 'next', and the scan stops
+ * after 'max_scan' key slots, after 'max_keys' expired keys were found or
+ * at the end of the key slots. This bounds the time spent in each call,
+ * so that the whole table can be scanned incrementally, for example from
+ * a control core. The expired keys are not deleted, the application
+ * deletes them, for example with rte_hash_del_key_bulk().
+ *
+ * The scan does not take the writer lock. Each expired key is confirmed
+ * by a lookup which does not record an access, so with
+ * RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF the scan runs concurrently with
+ * readers and with a writer, and reports a key only while the table
+ * holds it. Otherwise, the same thread safety rules as for lookups apply.
+ *
+ * @param h
+ *   Hash table to scan.
+ * @param max_age
+ *   Number of age ticks without access after which a key is expired.
+ * @param keys
+ *   Output containing pointers to the expired keys. The pointers remain
+ *   valid until the key is deleted.
+ * @param data
+ *   Output containing the data of the expired keys.
+ * @param positions
+ *   Output containing the positions of the expired keys, as returned when
+ *   they were added.
+ * @param max_keys
+ *   Size of the keys, data and positions arrays.
+ * @param max_scan
+ *   Maximum number of key slots to scan.
+ * @param next
+ *   Pointer to the scan cursor. Must point to 0 to start a scan, and is
+ *   set back to 0 when the end of the key slots is reached.
+ * @return
+ *   - Number of expired keys returned
+ *   - -EINVAL if the parameters are invalid
+ *   - -ENOTSUP if the table was not created with RTE_HASH_EXTRA_FLAGS_AGING
+ */
+__rte_experimental
+int
+rte_hash_age_expire(const struct rte_hash *h, uint32_t max_age,
+		const void **keys, void **data, int32_t *positions,
+		uint32_t max_keys, uint32_t max_scan, uint32_t *next);
+
 /**
  * Find a key-value pair in the hash table.
  * This operation is multi-thread safe with regarding to other lookup threads.
@@ -564,6 +810,62 @@ rte_hash_lookup_bulk(const struct rte_hash *h, const void **keys,
  */
 int32_t
 rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32_t *next);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Save a hash table to a file, to restore it with rte_hash_restore()
+ * after a restart. The buckets, keys and data are written in a format
+ * specific to this DPDK build and CPU architecture. The data are saved
+ * as they are, so they must not be pointers to memory which is not
+ * restored at the same address, indexes into an application table are
+ * fine.
+ *
+ * The table must not be modified while it is saved, nor be resized.
+ *
+ * @param h
+ *   Hash table to save.
+ * @param f
+ *   File opened for writing
+ * @return
+ *   - 0 on success
+ *   - -EINVAL if the parameters are invalid
+ *   - -EBUSY if the table is being resized
+ *   - -EIO if the file can not be written
+ */
+__rte_experimental
+int
+rte_hash_save(const struct rte_hash *h, FILE *f);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Create a hash table from a file written by rte_hash_save().
+ *
+ * The parameters must be the ones the saved table was created with,
+ * except for the number of entries, which is read from the file. The
+ * keys are not hashed again, the buckets and key slots are read as they
+ * were saved. The key positions are the same as in the saved table,
+ * positions deleted but not freed with rte_hash_free_key_with_position()
+ * are free in the restored table.
+ *
+ * @param params
+ *   Parameters used to create the saved hash table.
+ * @param f
+ *   File opened for reading, positioned at the start of the saved table
+ * @return
+ *   Pointer to hash table structure on success,
+ *   NULL otherwise with rte_errno set to an appropriate value:
+ *    - EINVAL - the parameters or the hash function do not match the
+ *      saved table, or the file does not hold a saved table
+ *    - EIO - the file can not be read
+ *    - ENOMEM - no appropriate memory area found in which to create memzone
+ */
+__rte_experimental
+struct rte_hash *
+rte_hash_restore(const struct rte_hash_parameters *params, FILE *f);
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,343 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#include <string.h>
+#include <errno.h>
+
+#include <rte_common.h>
+#include <rte_cpuflags.h>
+#include <rte_random.h>
+#include <rte_vect.h>
+
+#include "rte_thash.h"
+
+enum rte_thash_alg {
+	RTE_THASH_ALG_SCALAR,
+	RTE_THASH_ALG_AVX512,
+	RTE_THASH_ALG_GFNI,
+};
+
+/* Bit 'bit' of the key, counting from the most significant bit of the
+ * first byte. The key is padded with zeros.
+ */
+static inline uint32_t
+thash_key_bit(const uint8_t *rss_key, uint32_t key_len, uint32_t bit)
+{
+	if (bit >= key_len * CHAR_BIT)
+		return 0;
+	return (rss_key[bit / CHAR_BIT] >> (7 - bit % CHAR_BIT)) & 1;
+}
+
+int
+rte_thash_key_init(struct rte_thash_key *key, const uint8_t *rss_key,
+		uint32_t key_len)
+{
+	uint32_t i, j, bit, c, w;
+	uint8_t row;
+
+	if (key == NULL || rss_key == NULL || key_len < 8 ||
+			key_len > RTE_THASH_KEY_MAX_LEN)
+		return -EINVAL;
+
+	memset(key, 0, sizeof(*key));
+	key->key_len = key_len;
+
+	/* A set input bit at offset i xors the 32 bit key window at i */
+	for (i = 0; i <= (key_len - 4) * CHAR_BIT; i++) {
+		for (bit = 0, w = 0; bit < 32; bit++)
+			w = (w << 1) | thash_key_bit(rss_key, key_len, i + bit);
+		key->windows[i] = w;
+	}
+
+	/* Matrix m maps an input byte to its contribution to the output
+	 * byte k of the hash, for the input byte at offset m - k. Bit c of
+	 * row 7 - j is the key bit xored into output bit j by input bit c,
+	 * as expected by the GF2P8AFFINEQB instruction.
+	 */
+	for (i = 0; i < RTE_THASH_KEY_MAX_LEN; i++) {
+		for (j = 0; j < CHAR_BIT; j++) {
+			for (c = 0, row = 0; c < CHAR_BIT; c++)
+				row |= thash_key_bit(rss_key, key_len,
+					i * CHAR_BIT + 14 - c - j) << c;
+			key->matrices[i] |= (uint64_t)row << ((7 - j) * 8);
+		}
+	}
+
+	key->alg = RTE_THASH_ALG_SCALAR;
+#if defined(RTE_MACHINE_CPUFLAG_GFNI) && \
+	defined(RTE_MACHINE_CPUFLAG_AVX512VBMI) && \
+	defined(RTE_MACHINE_CPUFLAG_AVX512BW)
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_GFNI) &&
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512VBMI) &&
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512BW))
+		key->alg = RTE_THASH_ALG_GFNI;
+	else
+#endif
+#if defined(RTE_MACHINE_CPUFLAG_AVX512F)
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F))
+		key->alg = RTE_THASH_ALG_AVX512;
+#endif
+
+	return 0;
+}
+
+static inline uint32_t
+thash_scalar(const struct rte_thash_key *key, const uint32_t *input_tuple,
+		uint32_t input_len)
+{
+	uint32_t i, j, map, ret = 0;
+
+	for (j = 0; j < input_len; j++) {
+		for (map = input_tuple[j]; map; map &= (map - 1)) {
+			i = rte_bsf32(map);
+			ret ^= key->windows[j * 32 + 31 - i];
+		}
+	}
+	return ret;
+}
+
+#if defined(RTE_MACHINE_CPUFLAG_AVX512F)
+/* Hash 16 tuples, one per 32 bit lane, one input bit at a time */
+static inline void
+thash_avx512_x16(const struct rte_thash_key *key, uint32_t *input_tuples[],
+		uint32_t input_len, uint32_t *hashes)
+{
+	__m512i ptrs_lo, ptrs_hi, tuple, acc;
+	__mmask16 bits;
+	uint32_t i, j;
+
+	ptrs_lo = _mm512_loadu_si512((const void *)&input_tuples[0]);
+	ptrs_hi = _mm512_loadu_si512((const void *)&input_tuples[8]);
+	acc = _mm512_setzero_si512();
+
+	for (j = 0; j < input_len; j++) {
+		tuple = _mm512_inserti64x4(_mm512_castsi256_si512(
+				_mm512_i64gather_epi32(ptrs_lo, NULL, 1)),
+				_mm512_i64gather_epi32(ptrs_hi, NULL, 1), 1);
+		for (i = 0; i < 32; i++) {
+			bits = _mm512_test_epi32_mask(tuple,
+					_mm512_set1_epi32(1U << (31 - i)));
+			acc = _mm512_mask_xor_epi32(acc, bits, acc,
+					_mm512_set1_epi32(
+						key->windows[j * 32 + i]));
+		}
+		ptrs_lo = _mm512_add_epi64(ptrs_lo,
+				_mm512_set1_epi64(sizeof(uint32_t)));
+		ptrs_hi = _mm512_add_epi64(ptrs_hi,
+				_mm512_set1_epi64(sizeof(uint32_t)));
+	}
+
+	_mm512_storeu_si512((void *)hashes, acc);
+}
+#endif
+
+#if defined(RTE_MACHINE_CPUFLAG_GFNI) && \
+	defined(RTE_MACHINE_CPUFLAG_AVX512VBMI) && \
+	defined(RTE_MACHINE_CPUFLAG_AVX512BW)
+/* Offset in the tuple of the input byte multiplied by matrix m to get
+ * the output byte k of the hash, for lane m of the first chunk. Byte k of
+ * the low half of the lane is in the first tuple and byte k of the high
+ * half in the second tuple. Offsets out of the tuple are masked out.
+ */
+static const int8_t thash_gfni_pos[64] __rte_aligned(64) = {
+	-3, -2, -1, 0, -3, -2, -1, 0,
+	-2, -1, 0, 1, -2, -1, 0, 1,
+	-1, 0, 1, 2, -1, 0, 1, 2,
+	0, 1, 2, 3, 0, 1, 2, 3,
+	1, 2, 3, 4, 1, 2, 3, 4,
+	2, 3, 4, 5, 2, 3, 4, 5,
+	3, 4, 5, 6, 3, 4, 5, 6,
+	4, 5, 6, 7, 4, 5, 6, 7,
+};
+
+/* Hash two tuples. Lane m of a chunk multiplies the input bytes m - 3 to m
+ * of each tuple with matrix m, which gives directly their contribution to
+ * the 32 bit hash of the tuple.
+ */
+static inline void
+thash_gfni_x2(const __m512i *matrices, const __m512i *idx,
+		const __mmask64 *masks, uint32_t num_chunks,
+		const uint32_t *tuple_a, const uint32_t *tuple_b,
+		__mmask16 load_mask, uint32_t *hashes)
+{
+	__m512i a, b, bytes, acc;
+	__m256i acc_256;
+	__m128i acc_128;
+	uint64_t h;
+	uint32_t c;
+
+	a = _mm512_maskz_loadu_epi32(load_mask, tuple_a);
+	b = _mm512_maskz_loadu_epi32(load_mask, tuple_b);
+	acc = _mm512_setzero_si512();
+
+	for (c = 0; c < num_chunks; c++) {
+		bytes = _mm512_maskz_permutex2var_epi8(masks[c], a, idx[c], b);
+		acc = _mm512_xor_si512(acc,
+			_mm512_gf2p8affine_epi64_epi8(bytes, matrices[c], 0));
+	}
+
+	acc_256 = _mm256_xor_si256(_mm512_castsi512_si256(acc),
+			_mm512_extracti64x4_epi64(acc, 1));
+	acc_128 = _mm_xor_si128(_mm256_castsi256_si128(acc_256),
+			_mm256_extracti128_si256(acc_256, 1));
+	h = _mm_cvtsi128_si64(acc_128) ^ _mm_extract_epi64(acc_128, 1);
+	hashes[0] = (uint32_t)h;
+	hashes[1] = (uint32_t)(h >> 32);
+}
+
+static inline void
+thash_gfni_bulk(const struct rte_thash_key *key, uint32_t *input_tuples[],
+		uint32_t input_len, uint32_t *hashes, uint32_t num)
+{
+	__m512i matrices[RTE_THASH_KEY_MAX_LEN / 8];
+	__m512i idx[RTE_THASH_KEY_MAX_LEN / 8];
+	__mmask64 masks[RTE_THASH_KEY_MAX_LEN / 8];
+	const __mmask16 load_mask = RTE_LEN2MASK(input_len, uint16_t);
+	/* Tuples are made of 4-bytes chunks in CPU order, and the high half
+	 * of the lanes reads the second tuple.
+	 */
+	const __m512i swap = _mm512_set1_epi64(0x4343434303030303ULL);
+	const int8_t len = input_len * sizeof(uint32_t);
+	uint32_t hash_pair[2];
+	uint32_t num_chunks, c, i;
+	__m512i pos;
+
+	/* Output bytes also depend on the 3 preceding input bytes */
+	num_chunks = (len + 3 + 7) / 8;
+	pos = _mm512_load_si512((const void *)thash_gfni_pos);
+	for (c = 0; c < num_chunks; c++) {
+		matrices[c] = _mm512_load_si512(
+				(const void *)&key->matrices[c * 8]);
+		idx[c] = _mm512_xor_si512(pos, swap);
+		masks[c] = _mm512_cmpge_epi8_mask(pos,
+					_mm512_setzero_si512()) &
+				_mm512_cmplt_epi8_mask(pos,
+					_mm512_set1_epi8(len));
+		pos = _mm512_add_epi8(pos, _mm512_set1_epi8(8));
+	}
+
+	for (i = 0; i + 1 < num; i += 2)
+		thash_gfni_x2(matrices, idx, masks, num_chunks,
+				input_tuples[i], input_tuples[i + 1],
+				load_mask, &hashes[i]);
+	if (i < num) {
+		thash_gfni_x2(matrices, idx, masks, num_chunks,
+				input_tuples[i], input_tuples[i],
+				load_mask, hash_pair);
+		hashes[i] = hash_pair[0];
+	}
+}
+#endif
+
+void
+rte_softrss_bulk(const struct rte_thash_key *key, uint32_t *input_tuples[],
+		uint32_t input_len, uint32_t *hashes, uint32_t num)
+{
+	uint32_t i = 0;
+
+	switch (key->alg) {
+#if defined(RTE_MACHINE_CPUFLAG_GFNI) && \
+	defined(RTE_MACHINE_CPUFLAG_AVX512VBMI) && \
+	defined(RTE_MACHINE_CPUFLAG_AVX512BW)
+	case RTE_THASH_ALG_GFNI:
+		thash_gfni_bulk(key, input_tuples, input_len, hashes, num);
+		return;
+#endif
+#if defined(RTE_MACHINE_CPUFLAG_AVX512F)
+	case RTE_THASH_ALG_AVX512:
+		for (; i + 16 <= num; i += 16)
+			thash_avx512_x16(key, &input_tuples[i], input_len,
+					&hashes[i]);
+		break;
+#endif
+	default:
+		break;
+	}
+
+	for (; i < num; i++)
+		hashes[i] = thash_scalar(key, input_tuples[i], input_len);
+}
+
+int
+rte_thash_adjust_tuple(const struct rte_thash_key *key,
+		uint32_t *input_tuple, uint32_t input_len, uint32_t offset,
+		uint32_t len, uint32_t reta_bits, uint32_t reta_idx)
+{
+	/* Basis of the hash changes reachable by flipping bits of the field,
+	 * indexed by their most significant bit, with the field bits to flip
+	 * to get each of them.
+	 */
+	uint32_t basis[32], flips[32];
+	uint32_t mask, vec, flip, msb, bit, i;
+
+	if (key == NULL || input_tuple == NULL || len == 0 || len > 32 ||
+			reta_bits == 0 || reta_bits > 32 ||
+			offset + len > input_len * 32 ||
+			input_len > key->key_len / sizeof(uint32_t) - 1)
+		return -EINVAL;
+
+	mask = RTE_LEN2MASK(reta_bits, uint32_t);
+	memset(basis, 0, sizeof(basis));
+	memset(flips, 0, sizeof(flips));
+
+	/* Gaussian elimination over GF(2) of the changes of each field bit */
+	for (i = 0; i < len; i++) {
+		vec = key->windows[offset + i] & mask;
+		flip = 1U << i;
+		while (vec != 0) {
+			msb = 31 - __builtin_clz(vec);
+			if (basis[msb] == 0) {
+				basis[msb] = vec;
+				flips[msb] = flip;
+				break;
+			}
+			vec ^= basis[msb];
+			flip ^= flips[msb];
+		}
+	}
+
+	vec = (thash_scalar(key, input_tuple, input_len) ^ reta_idx) & mask;
+	flip = 0;
+	while (vec != 0) {
+		msb = 31 - __builtin_clz(vec);
+		if (basis[msb] == 0)
+			return -ENOSPC;
+		vec ^= basis[msb];
+		flip ^= flips[msb];
+	}
+
+	for (i = 0; i < len; i++) {
+		if ((flip & (1U << i)) == 0)
+			continue;
+		bit = offset + i;
+		input_tuple[bit / 32] ^= 1U << (31 - bit % 32);
+	}
+
+	return 0;
+}
+
+int
+rte_thash_gen_sym_key(uint8_t *rss_key, uint32_t key_len)
+{
+	uint16_t pattern;
+	uint32_t i;
+
+	if (rss_key == NULL || key_len == 0 || (key_len & 1) != 0)
+		return -EINVAL;
+
+	/* The 32 bit windows of the key are the same for input bits 16 bits
+	 * apart, so swapping the addresses (16 bits multiples) or the ports
+	 * does not change the hash.
+	 */
+	do {
+		pattern = (uint16_t)rte_rand();
+	} while (pattern == 0 || pattern == UINT16_MAX);
+
+	for (i = 0; i < key_len; i += 2) {
+		rss_key[i] = pattern >> 8;
+		rss_key[i + 1] = pattern & 0xff;
+	}
+
+	return 0;
+}
@@ -27,6 +27,7 @@ extern "C" {
 #include <rte_config.h>
 #include <rte_ip.h>
 #include <rte_common.h>
+#include <rte_compat.h>
 
 #if defined(RTE_ARCH_X86) || defined(RTE_MACHINE_CPUFLAG_NEON)
 #include <rte_vect.h>
@@ -222,6 +223,130 @@ rte_softrss_be(uint32_t *input_tuple, uint32_t input_len,
 	return ret;
 }
 
+/** Maximum length of an RSS key prepared by rte_thash_key_init() */
+#define RTE_THASH_KEY_MAX_LEN	64
+
+/**
+ * RSS key prepared for the bulk computation of the Toeplitz hash.
+ * It must be filled by rte_thash_key_init(), its content is private.
+ */
+struct rte_thash_key {
+	uint64_t matrices[RTE_THASH_KEY_MAX_LEN];
+	/**< 8x8 bit matrix of each key byte, for the GFNI implementation */
+	uint32_t windows[RTE_THASH_KEY_MAX_LEN * CHAR_BIT];
+	/**< 32 bit window of the key starting at each bit */
+	uint32_t key_len;	/**< Length of the RSS key in bytes */
+	uint32_t alg;		/**< Implementation used by rte_softrss_bulk */
+} __rte_cache_aligned;
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Prepare an RSS key for rte_softrss_bulk() and rte_thash_adjust_tuple().
+ * This also selects the fastest implementation supported by the CPU.
+ *
+ * @param key
+ *   Pointer to the prepared key to fill.
+ * @param rss_key
+ *   Pointer to the original RSS key, as programmed into the NIC.
+ * @param key_len
+ *   RSS key length in bytes, from 8 to RTE_THASH_KEY_MAX_LEN.
+ * @return
+ *   0 on success, -EINVAL if the parameters are invalid.
+ */
+__rte_experimental
+int
+rte_thash_key_init(struct rte_thash_key *key, const uint8_t *rss_key,
+		uint32_t key_len);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Compute the Toeplitz hash of several tuples at once. The result is the
+ * same as rte_softrss() with the original RSS key. Depending on the CPU,
+ * GFNI or AVX512 instructions are used to hash several tuples in
+ * parallel.
+ *
+ * @param key
+ *   RSS key prepared by rte_thash_key_init().
+ * @param input_tuples
+ *   Array of pointers to the input tuples, in the format of rte_softrss().
+ * @param input_len
+ *   Length of each input tuple in 4-bytes chunks. It must be at most the
+ *   RSS key length in 4-bytes chunks minus one.
+ * @param hashes
+ *   Output containing the hash of each tuple.
+ * @param num
+ *   Number of tuples.
+ */
+__rte_experimental
+void
+rte_softrss_bulk(const struct rte_thash_key *key, uint32_t *input_tuples[],
+		uint32_t input_len, uint32_t *hashes, uint32_t num);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Change a field of a tuple, for example the source port, so that the
+ * Toeplitz hash of the tuple selects a given entry of the redirection
+ * table of the NIC. As the Toeplitz hash is linear, only some bits of the
+ * field are flipped, the rest of the tuple is kept. This allows choosing,
+ * for example, the source port of a connection so that its return traffic
+ * lands in the queue of the lcore owning the connection.
+ *
+ * The bits of the tuple are numbered from the most significant bit of the
+ * first 4-bytes chunk, as in the hash computation. For example the source
+ * port of a struct rte_ipv4_tuple starts at bit 64 and is 16 bits long.
+ *
+ * @param key
+ *   RSS key prepared by rte_thash_key_init().
+ * @param input_tuple
+ *   Pointer to the tuple to adjust, in the format of rte_softrss().
+ * @param input_len
+ *   Length of the input tuple in 4-bytes chunks.
+ * @param offset
+ *   Offset in bits of the field to change in the tuple.
+ * @param len
+ *   Length in bits of the field to change, at most 32.
+ * @param reta_bits
+ *   Number of least significant bits of the hash used to index the
+ *   redirection table, at most 32.
+ * @param reta_idx
+ *   Desired redirection table index.
+ * @return
+ *   - 0 if the tuple was adjusted (or already had the desired index)
+ *   - -EINVAL if the parameters are invalid
+ *   - -ENOSPC if no value of the field gives the desired index
+ */
+__rte_experimental
+int
+rte_thash_adjust_tuple(const struct rte_thash_key *key,
+		uint32_t *input_tuple, uint32_t input_len, uint32_t offset,
+		uint32_t len, uint32_t reta_bits, uint32_t reta_idx);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Generate a random RSS key giving the same hash when the source and
+ * destination addresses and ports of an IPv4 or IPv6 tuple are swapped.
+ * Both directions of a connection are then distributed to the same queue.
+ * The key repeats a random 16 bit pattern.
+ *
+ * @param rss_key
+ *   Pointer to the RSS key to fill.
+ * @param key_len
+ *   RSS key length in bytes, must be even.
+ * @return
+ *   0 on success, -EINVAL if the parameters are invalid.
+ */
+__rte_experimental
+int
+rte_thash_gen_sym_key(uint8_t *rss_key, uint32_t key_len);
+
 #ifdef __cplusplus
 }
 #endif
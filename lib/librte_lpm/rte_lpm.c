@@ -39,6 +39,21 @@ enum valid_flag {
 	VALID
 };
 
+/* "LPM4" */
+#define LPM_SNAPSHOT_MAGIC	0x344d504c
+#define LPM_SNAPSHOT_VERSION	1
+
+/*
+ * A saved LPM object is this header followed by the rule info, tbl24,
+ * tbl8 and rules tables.
+ */
+struct lpm_snapshot_hdr {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t max_rules;
+	uint32_t number_tbl8s;
+};
+
 /* Macro to enable/disable run-time checks. */
 #if defined(RTE_LIBRTE_LPM_DEBUG)
 #include <rte_debug.h>
@@ -1064,3 +1079,80 @@ rte_lpm_delete_all(struct rte_lpm *lpm)
 	/* Delete all rules form the rules table. */
 	memset(lpm->rules_tbl, 0, sizeof(lpm->rules_tbl[0]) * lpm->max_rules);
 }
+
+int
+rte_lpm_save(const struct rte_lpm *lpm, FILE *f)
+{
+	struct lpm_snapshot_hdr hdr;
+
+	if ((lpm == NULL) || (f == NULL))
+		return -EINVAL;
+
+	hdr.magic = LPM_SNAPSHOT_MAGIC;
+	hdr.version = LPM_SNAPSHOT_VERSION;
+	hdr.max_rules = lpm->max_rules;
+	hdr.number_tbl8s = lpm->number_tbl8s;
+
+	/* the tables link by index, they are written as they are */
+	if ((fwrite(&hdr, sizeof(hdr), 1, f) != 1) ||
+			(fwrite(lpm->rule_info, sizeof(lpm->rule_info), 1,
+			f) != 1) ||
+			(fwrite(lpm->tbl24, sizeof(lpm->tbl24), 1, f) != 1) ||
+			(fwrite(lpm->tbl8, sizeof(lpm->tbl8[0]),
+			RTE_LPM_TBL8_GROUP_NUM_ENTRIES * lpm->number_tbl8s,
+			f) != RTE_LPM_TBL8_GROUP_NUM_ENTRIES *
+			lpm->number_tbl8s) ||
+			(fwrite(lpm->rules_tbl, sizeof(lpm->rules_tbl[0]),
+			lpm->max_rules, f) != lpm->max_rules))
+		return -EIO;
+
+	return 0;
+}
+
+struct rte_lpm *
+rte_lpm_restore(const char *name, int socket_id, FILE *f)
+{
+	struct lpm_snapshot_hdr hdr;
+	struct rte_lpm_config config;
+	struct rte_lpm *lpm;
+
+	if ((name == NULL) || (f == NULL)) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	if (fread(&hdr, sizeof(hdr), 1, f) != 1) {
+		rte_errno = EIO;
+		return NULL;
+	}
+	if ((hdr.magic != LPM_SNAPSHOT_MAGIC) ||
+			(hdr.version != LPM_SNAPSHOT_VERSION)) {
+		RTE_LOG(ERR, LPM, "LPM %s snapshot format is not supported\n",
+			name);
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	config.max_rules = hdr.max_rules;
+	config.number_tbl8s = hdr.number_tbl8s;
+	config.flags = 0;
+	lpm = rte_lpm_create(name, socket_id, &config);
+	if (lpm == NULL)
+		return NULL;
+
+	if ((fread(lpm->rule_info, sizeof(lpm->rule_info), 1, f) != 1) ||
+			(fread(lpm->tbl24, sizeof(lpm->tbl24), 1, f) != 1) ||
+			(fread(lpm->tbl8, sizeof(lpm->tbl8[0]),
+			RTE_LPM_TBL8_GROUP_NUM_ENTRIES * lpm->number_tbl8s,
+			f) != RTE_LPM_TBL8_GROUP_NUM_ENTRIES *
+			lpm->number_tbl8s) ||
+			(fread(lpm->rules_tbl, sizeof(lpm->rules_tbl[0]),
+			lpm->max_rules, f) != lpm->max_rules)) {
+		RTE_LOG(ERR, LPM, "Can not read LPM %s tables\n", name);
+		rte_lpm_free(lpm);
+		rte_errno = EIO;
+		return NULL;
+	}
+
+	return lpm;
+}
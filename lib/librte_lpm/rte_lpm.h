@@ -13,12 +13,14 @@
 #include <errno.h>
 #include <sys/queue.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <rte_branch_prediction.h>
 #include <rte_byteorder.h>
 #include <rte_config.h>
 #include <rte_memory.h>
 #include <rte_common.h>
+#include <rte_compat.h>
 #include <rte_vect.h>
 
 #ifdef __cplusplus
@@ -239,6 +241,53 @@ rte_lpm_delete(struct rte_lpm *lpm, uint32_t ip, uint8_t depth);
 void
 rte_lpm_delete_all(struct rte_lpm *lpm);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Save an LPM object to a file, to restore it with rte_lpm_restore()
+ * after a restart. The rules and the tables are written in a format
+ * specific to this DPDK build and CPU architecture.
+ * The LPM object must not be modified while it is saved.
+ *
+ * @param lpm
+ *   LPM object handle
+ * @param f
+ *   File opened for writing
+ * @return
+ *   0 on success
+ *   -EINVAL for incorrect arguments
+ *   -EIO if the file can not be written
+ */
+__rte_experimental
+int
+rte_lpm_save(const struct rte_lpm *lpm, FILE *f);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Create an LPM object from a file written by rte_lpm_save().
+ * The tables are read as they were saved, without adding the rules again.
+ *
+ * @param name
+ *   LPM object name
+ * @param socket_id
+ *   NUMA socket ID for LPM table memory allocation
+ * @param f
+ *   File opened for reading, positioned at the start of the saved object
+ * @return
+ *   Handle to LPM object on success, NULL otherwise with rte_errno set
+ *   to an appropriate values. Possible rte_errno values include:
+ *    - EINVAL - the file does not hold a saved LPM object
+ *    - EIO - the file can not be read
+ *    - EEXIST - a memzone with the same name already exists
+ *    - ENOMEM - no appropriate memory area found in which to create memzone
+ */
+__rte_experimental
+struct rte_lpm *
+rte_lpm_restore(const char *name, int socket_id, FILE *f);
+
 /**
  * Lookup an IP into the LPM table.
  *
@@ -27,6 +27,7 @@
 #include <rte_tailq.h>
 
 #include "rte_lpm6.h"
+#include "rte_lpm6_ct.h"
 
 #define RTE_LPM6_TBL24_NUM_ENTRIES        (1 << 24)
 #define RTE_LPM6_TBL8_GROUP_NUM_ENTRIES         256
@@ -104,14 +105,17 @@ struct rte_lpm6 {
 
 	/* LPM Tables. */
 	struct rte_hash *rules_tbl; /**< LPM rules. */
-	struct rte_lpm6_tbl_entry tbl24[RTE_LPM6_TBL24_NUM_ENTRIES]
-			__rte_cache_aligned; /**< LPM tbl24 table. */
+	struct lpm6_ct *ct; /**< compact trie, replacing tbl24 and tbl8 */
 
 	uint32_t *tbl8_pool; /**< pool of indexes of free tbl8s */
 	uint32_t tbl8_pool_pos; /**< current position in the tbl8 pool */
 
 	struct rte_lpm_tbl8_hdr *tbl8_hdrs; /* array of tbl8 headers */
 
+	/* Tables not allocated for a compact trie */
+	struct rte_lpm6_tbl_entry tbl24[RTE_LPM6_TBL24_NUM_ENTRIES]
+			__rte_cache_aligned; /**< LPM tbl24 table. */
+
 	struct rte_lpm6_tbl_entry tbl8[0]
 			__rte_cache_aligned; /**< LPM tbl8 table. */
 };
@@ -255,6 +259,7 @@ rte_lpm6_create(const char *name, int socket_id,
 	struct rte_hash *rules_tbl = NULL;
 	uint32_t *tbl8_pool = NULL;
 	struct rte_lpm_tbl8_hdr *tbl8_hdrs = NULL;
+	struct lpm6_ct *ct = NULL;
 
 	lpm_list = RTE_TAILQ_CAST(rte_lpm6_tailq.head, rte_lpm6_list);
 
@@ -289,6 +294,20 @@ rte_lpm6_create(const char *name, int socket_id,
 		goto fail_wo_unlock;
 	}
 
+	if (config->flags & RTE_LPM6_F_COMPACT) {
+		snprintf(mem_name, sizeof(mem_name), "LCT_%s", name);
+		ct = lpm6_ct_create(mem_name, socket_id, config->number_tbl8s);
+		if (ct == NULL) {
+			RTE_LOG(ERR, LPM, "LPM compact trie allocation failed\n");
+			rte_errno = ENOMEM;
+			goto fail_wo_unlock;
+		}
+
+		snprintf(mem_name, sizeof(mem_name), "LPM_%s", name);
+		mem_size = offsetof(struct rte_lpm6, tbl24);
+		goto alloc_lpm;
+	}
+
 	/* allocate tbl8 indexes pool */
 	tbl8_pool = rte_malloc(NULL,
 			sizeof(uint32_t) * config->number_tbl8s,
@@ -317,6 +336,7 @@ rte_lpm6_create(const char *name, int socket_id,
 	mem_size = sizeof(*lpm) + (sizeof(lpm->tbl8[0]) *
 			RTE_LPM6_TBL8_GROUP_NUM_ENTRIES * config->number_tbl8s);
 
+alloc_lpm:
 	rte_mcfg_tailq_write_lock();
 
 	/* Guarantee there's no existing */
@@ -357,9 +377,11 @@ rte_lpm6_create(const char *name, int socket_id,
 	lpm->rules_tbl = rules_tbl;
 	lpm->tbl8_pool = tbl8_pool;
 	lpm->tbl8_hdrs = tbl8_hdrs;
+	lpm->ct = ct;
 
 	/* init the stack */
-	tbl8_pool_init(lpm);
+	if (ct == NULL)
+		tbl8_pool_init(lpm);
 
 	te->data = (void *) lpm;
 
@@ -371,6 +393,7 @@ rte_lpm6_create(const char *name, int socket_id,
 	rte_mcfg_tailq_write_unlock();
 
 fail_wo_unlock:
+	lpm6_ct_free(ct);
 	rte_free(tbl8_hdrs);
 	rte_free(tbl8_pool);
 	rte_hash_free(rules_tbl);
@@ -434,6 +457,7 @@ rte_lpm6_free(struct rte_lpm6 *lpm)
 
 	rte_mcfg_tailq_write_unlock();
 
+	lpm6_ct_free(lpm->ct);
 	rte_free(lpm->tbl8_hdrs);
 	rte_free(lpm->tbl8_pool);
 	rte_hash_free(lpm->rules_tbl);
@@ -849,6 +873,28 @@ simulate_add(struct rte_lpm6 *lpm, const uint8_t *masked_ip, uint8_t depth)
 	return 0;
 }
 
+/*
+ * Add a route to the compact trie, the trie is checked before the rule
+ * table is changed so that the add cannot fail halfway.
+ */
+static int
+compact_add(struct rte_lpm6 *lpm, uint8_t *masked_ip, uint8_t depth,
+	uint32_t next_hop)
+{
+	int ret;
+
+	ret = lpm6_ct_reserve(lpm->ct, masked_ip, depth);
+	if (ret < 0)
+		return ret;
+
+	ret = rule_add(lpm, masked_ip, depth, next_hop);
+	if (ret < 0)
+		return ret;
+
+	lpm6_ct_add(lpm->ct, masked_ip, depth, next_hop);
+	return 0;
+}
+
 /*
  * Add a route
  */
@@ -872,6 +918,9 @@ rte_lpm6_add(struct rte_lpm6 *lpm, const uint8_t *ip, uint8_t depth,
 	ip6_copy_addr(masked_ip, ip);
 	ip6_mask_addr(masked_ip, depth);
 
+	if (lpm->ct != NULL)
+		return compact_add(lpm, masked_ip, depth, next_hop);
+
 	/* Simulate adding a new route */
 	int ret = simulate_add(lpm, masked_ip, depth);
 	if (ret < 0)
@@ -955,6 +1004,9 @@ rte_lpm6_lookup(const struct rte_lpm6 *lpm, const uint8_t *ip,
 	if ((lpm == NULL) || (ip == NULL) || (next_hop == NULL))
 		return -EINVAL;
 
+	if (lpm->ct != NULL)
+		return lpm6_ct_lookup(lpm->ct, ip, next_hop);
+
 	first_byte = LOOKUP_FIRST_BYTE;
 	tbl24_index = (ip[0] << BYTES2_SIZE) | (ip[1] << BYTE_SIZE) | ip[2];
 
@@ -989,6 +1041,11 @@ rte_lpm6_lookup_bulk_func(const struct rte_lpm6 *lpm,
 	if ((lpm == NULL) || (ips == NULL) || (next_hops == NULL))
 		return -EINVAL;
 
+	if (lpm->ct != NULL) {
+		lpm6_ct_lookup_bulk(lpm->ct, ips, next_hops, n);
+		return 0;
+	}
+
 	for (i = 0; i < n; i++) {
 		first_byte = LOOKUP_FIRST_BYTE;
 		tbl24_index = (ips[i][0] << BYTES2_SIZE) |
@@ -1079,6 +1136,13 @@ rte_lpm6_delete_bulk_func(struct rte_lpm6 *lpm,
 	if ((lpm == NULL) || (ips == NULL) || (depths == NULL))
 		return -EINVAL;
 
+	/* the compact trie is updated incrementally */
+	if (lpm->ct != NULL) {
+		for (i = 0; i < n; i++)
+			rte_lpm6_delete(lpm, ips[i], depths[i]);
+		return 0;
+	}
+
 	for (i = 0; i < n; i++) {
 		ip6_copy_addr(masked_ip, ips[i]);
 		ip6_mask_addr(masked_ip, depths[i]);
@@ -1112,6 +1176,12 @@ rte_lpm6_delete_all(struct rte_lpm6 *lpm)
 	/* Zero used rules counter. */
 	lpm->used_rules = 0;
 
+	if (lpm->ct != NULL) {
+		lpm6_ct_reset(lpm->ct);
+		rte_hash_reset(lpm->rules_tbl);
+		return;
+	}
+
 	/* Zero tbl24. */
 	memset(lpm->tbl24, 0, sizeof(lpm->tbl24));
 
@@ -1286,6 +1356,36 @@ remove_tbl(struct rte_lpm6 *lpm, struct rte_lpm_tbl8_hdr *tbl_hdr,
 	tbl8_put(lpm, tbl_ind);
 }
 
+/*
+ * Delete a route from the compact trie
+ */
+static int
+compact_delete(struct rte_lpm6 *lpm, uint8_t *masked_ip, uint8_t depth)
+{
+	struct rte_lpm6_rule lsp_rule;
+	uint32_t next_hop;
+	int ret;
+
+	if (rule_find(lpm, masked_ip, depth, &next_hop) == 0)
+		return -ENOENT;
+
+	ret = lpm6_ct_reserve(lpm->ct, masked_ip, depth);
+	if (ret < 0)
+		return ret;
+
+	rule_delete(lpm, masked_ip, depth);
+
+	ip6_copy_addr(lsp_rule.ip, masked_ip);
+	if (rule_find_less_specific(lpm, lsp_rule.ip, depth, &lsp_rule) == 0) {
+		lsp_rule.depth = 0;
+		lsp_rule.next_hop = 0;
+	}
+	lpm6_ct_delete(lpm->ct, masked_ip, depth, lsp_rule.depth,
+		lsp_rule.next_hop);
+
+	return 0;
+}
+
 /*
  * Deletes a rule
  */
@@ -1307,6 +1407,9 @@ rte_lpm6_delete(struct rte_lpm6 *lpm, uint8_t *ip, uint8_t depth)
 	ip6_copy_addr(masked_ip, ip);
 	ip6_mask_addr(masked_ip, depth);
 
+	if (lpm->ct != NULL)
+		return compact_delete(lpm, masked_ip, depth);
+
 	/* Delete the rule from the rule table. */
 	ret = rule_delete(lpm, masked_ip, depth);
 	if (ret < 0)
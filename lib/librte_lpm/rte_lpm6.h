@@ -22,14 +22,26 @@ extern "C" {
 /** Max number of characters in LPM name. */
 #define RTE_LPM6_NAMESIZE                 32
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this flag may change without prior notice
+ *
+ * Use a compact multibit trie instead of the tbl24/tbl8 tables. The trie
+ * has up to number_tbl8s trie nodes of 32 bytes, which are allocated with
+ * their leaves at creation, instead of the 64MB tbl24 and the tbl8s.
+ */
+#define RTE_LPM6_F_COMPACT               0x1
+
 /** LPM structure. */
 struct rte_lpm6;
 
 /** LPM configuration structure. */
 struct rte_lpm6_config {
 	uint32_t max_rules;      /**< Max number of rules. */
-	uint32_t number_tbl8s;   /**< Number of tbl8s to allocate. */
-	int flags;               /**< This field is currently unused. */
+	uint32_t number_tbl8s;
+	/**< Number of tbl8s to allocate, or max number of trie nodes. */
+	int flags;
+	/**< RTE_LPM6_F_* flags, 0 by default. The other bits are ignored. */
 };
 
 /**
@@ -0,0 +1,921 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+
+#include <rte_common.h>
+#include <rte_malloc.h>
+#include <rte_pause.h>
+#include <rte_cpuflags.h>
+#include <rte_vect.h>
+
+#include "rte_lpm6_ct.h"
+
+/*
+ * The first 16 bits of the address index a direct table, whose entries
+ * hold either a leaf or a trie node. Each trie node consumes the next 6
+ * bits: it has a bitmap of its 64 slots leading to a child node and a
+ * bitmap of the slots starting a run of equal leaves. The children and
+ * the leaves of a node are kept in contiguous blocks, so the position of
+ * a slot in its block is the popcount of the bitmap below the slot.
+ *
+ * A leaf of 0 stands for the next hop the node inherits from its parent,
+ * which is stored in the node. This way a rule only changes the leaves of
+ * the node it belongs to.
+ *
+ * The node and leaf arrays are allocated when the trie is created and are
+ * never moved, and every index stored in a node or in the direct table is
+ * within them. A lookup overlapping an update may thus read a mix of the
+ * old and new trie, but only within the arrays, and it is retried when the
+ * change counter shows an update happened meanwhile, the same way as the
+ * lock-free readers of the cuckoo hash.
+ */
+
+#define CT_DIR_BITS		16
+#define CT_DIR_NUM_ENT		(1 << CT_DIR_BITS)
+#define CT_STRIDE		6
+#define CT_NUM_SLOTS		(1 << CT_STRIDE)
+#define CT_MAX_DEPTH		128
+#define CT_NUM_LEVELS		\
+	((CT_MAX_DEPTH - CT_DIR_BITS + CT_STRIDE - 1) / CT_STRIDE)
+
+/* Direct table entry holding a node index instead of a leaf */
+#define CT_DIR_NODE		(1U << 31)
+/* Leaf holding a next hop, 0 is inherited from the parent */
+#define CT_LEAF_VALID		(1U << 30)
+/* Next hops are 21 bits as with the tbl8 based tables */
+#define CT_NH_MASK		0x001FFFFF
+
+/* Number of pool elements a single update may take */
+#define CT_POOL_RESERVE		(CT_NUM_LEVELS * CT_NUM_SLOTS)
+#define CT_POOL_END		UINT32_MAX
+/*
+ * Children blocks are rounded up to a power of 2, so the node pool has
+ * twice the maximum number of nodes, and as many leaves per node as the
+ * average number of next hop runs expected in a node.
+ */
+#define CT_POOL_NODES_PER_NODE	2
+#define CT_POOL_LEAVES_PER_NODE	8
+
+/* Addresses of a bulk lookup retried together */
+#define CT_LOOKUP_BURST		64
+
+/* Pool of blocks of 1 to CT_NUM_SLOTS elements, sized in powers of 2 */
+struct ct_pool {
+	uint32_t size;			/**< Number of allocated elements */
+	uint32_t used;			/**< Number of elements handed out */
+	uint32_t free[CT_STRIDE + 1];	/**< Free blocks of each size */
+};
+
+struct ct_node {
+	uint64_t vector;	/**< Slots leading to a child node */
+	uint64_t leafvec;	/**< Slots starting a run of leaves */
+	uint32_t base0;		/**< Index of the leaves block */
+	uint32_t base1;		/**< Index of the children block */
+	uint32_t def;		/**< Leaf inherited from the parent */
+	uint32_t next_free;	/**< Next free block of the node pool */
+};
+
+struct lpm6_ct {
+	uint32_t dir[CT_DIR_NUM_ENT];	/**< Direct table of the first 16 bits */
+	struct ct_node *nodes;		/**< Trie nodes */
+	uint32_t *leaves;		/**< Leaves of the trie nodes */
+	int vector;			/**< Use the vector bulk lookup */
+	uint32_t chg_cnt;		/**< Odd while an update is running */
+
+	/* Fields only used on update */
+	uint64_t *node_rules;		/**< Rules of each node */
+	struct ct_pool node_pool;
+	struct ct_pool leaf_pool;
+	uint32_t nb_nodes;		/**< Number of nodes in use */
+	uint32_t max_nodes;		/**< Maximum number of nodes in use */
+	int socket_id;
+	uint32_t dir_leaf[CT_DIR_NUM_ENT];	/**< Leaf of the rules up to /16 */
+	uint8_t dir_depth[CT_DIR_NUM_ENT];	/**< Depth of these rules */
+};
+
+static inline uint32_t
+dir_idx(const uint8_t *ip)
+{
+	return (uint32_t)ip[0] << 8 | ip[1];
+}
+
+/* Slot of the address in a node of the given level */
+static inline unsigned int
+ct_slot(const uint8_t *ip, unsigned int level)
+{
+	unsigned int off = CT_DIR_BITS + level * CT_STRIDE;
+	unsigned int byte = off / 8;
+	uint32_t v;
+
+	v = (uint32_t)ip[byte] << 8;
+	if (byte + 1 < CT_MAX_DEPTH / 8)
+		v |= ip[byte + 1];
+	return (v >> (16 - CT_STRIDE - off % 8)) & (CT_NUM_SLOTS - 1);
+}
+
+static inline unsigned int
+depth_level(uint8_t depth)
+{
+	return (depth - CT_DIR_BITS - 1) / CT_STRIDE;
+}
+
+static inline unsigned int
+blk_order(uint32_t n)
+{
+	return (n <= 1) ? 0 : 32 - __builtin_clz(n - 1);
+}
+
+/*
+ * Block pools. lpm6_ct_reserve() checks there is room for CT_POOL_RESERVE
+ * elements, which an update cannot exceed, so getting a block cannot fail.
+ * The free list of the nodes is not linked through base0 or base1, which
+ * a lookup overlapping the update may still use as indexes.
+ */
+static uint32_t *
+node_link(struct lpm6_ct *ct, uint32_t idx)
+{
+	return &ct->nodes[idx].next_free;
+}
+
+static uint32_t *
+leaf_link(struct lpm6_ct *ct, uint32_t idx)
+{
+	return &ct->leaves[idx];
+}
+
+/*
+ * Take a free block, splitting a larger one if there is no free block of
+ * the order, so that the end of the pool is used last.
+ */
+static inline uint32_t
+blk_get(struct lpm6_ct *ct, struct ct_pool *pool, uint32_t n,
+	uint32_t *(*link)(struct lpm6_ct *, uint32_t))
+{
+	unsigned int order = blk_order(n);
+	unsigned int o;
+	uint32_t idx;
+
+	for (o = order; o < RTE_DIM(pool->free); o++)
+		if (pool->free[o] != CT_POOL_END)
+			break;
+
+	if (o == RTE_DIM(pool->free)) {
+		idx = pool->used;
+		pool->used += 1 << order;
+		return idx;
+	}
+
+	idx = pool->free[o];
+	pool->free[o] = *link(ct, idx);
+	while (o-- > order) {
+		*link(ct, idx + (1 << o)) = pool->free[o];
+		pool->free[o] = idx + (1 << o);
+	}
+	return idx;
+}
+
+static inline void
+blk_put(struct lpm6_ct *ct, struct ct_pool *pool, uint32_t idx, uint32_t n,
+	uint32_t *(*link)(struct lpm6_ct *, uint32_t))
+{
+	unsigned int order = blk_order(n);
+
+	*link(ct, idx) = pool->free[order];
+	pool->free[order] = idx;
+}
+
+static uint32_t
+node_blk_get(struct lpm6_ct *ct, uint32_t n)
+{
+	return blk_get(ct, &ct->node_pool, n, node_link);
+}
+
+static void
+node_blk_put(struct lpm6_ct *ct, uint32_t idx, uint32_t n)
+{
+	blk_put(ct, &ct->node_pool, idx, n, node_link);
+}
+
+static uint32_t
+leaf_blk_get(struct lpm6_ct *ct, uint32_t n)
+{
+	return blk_get(ct, &ct->leaf_pool, n, leaf_link);
+}
+
+static void
+leaf_blk_put(struct lpm6_ct *ct, uint32_t idx, uint32_t n)
+{
+	blk_put(ct, &ct->leaf_pool, idx, n, leaf_link);
+}
+
+static int
+ct_pools_room(const struct lpm6_ct *ct)
+{
+	if (ct->node_pool.size - ct->node_pool.used < CT_POOL_RESERVE ||
+			ct->leaf_pool.size - ct->leaf_pool.used <
+			CT_POOL_RESERVE)
+		return -ENOSPC;
+	return 0;
+}
+
+static void
+ct_pools_init(struct lpm6_ct *ct)
+{
+	unsigned int i;
+
+	ct->node_pool.used = 0;
+	ct->leaf_pool.used = 0;
+	for (i = 0; i < RTE_DIM(ct->node_pool.free); i++) {
+		ct->node_pool.free[i] = CT_POOL_END;
+		ct->leaf_pool.free[i] = CT_POOL_END;
+	}
+	ct->nb_nodes = 0;
+}
+
+struct lpm6_ct *
+lpm6_ct_create(const char *name, int socket_id, uint32_t max_nodes)
+{
+	uint64_t nb_nodes, nb_leaves;
+	struct lpm6_ct *ct;
+
+	ct = rte_zmalloc_socket(name, sizeof(*ct), RTE_CACHE_LINE_SIZE,
+		socket_id);
+	if (ct == NULL)
+		return NULL;
+
+	ct->socket_id = socket_id;
+	ct->max_nodes = max_nodes;
+	ct_pools_init(ct);
+
+	/*
+	 * Lookups may read up to CT_NUM_SLOTS elements past a block index,
+	 * when they overlap an update.
+	 */
+	nb_nodes = (uint64_t)max_nodes * CT_POOL_NODES_PER_NODE +
+		CT_POOL_RESERVE;
+	nb_leaves = nb_nodes * CT_POOL_LEAVES_PER_NODE;
+	if (nb_leaves > UINT32_MAX - CT_NUM_SLOTS) {
+		lpm6_ct_free(ct);
+		return NULL;
+	}
+	ct->node_pool.size = nb_nodes;
+	ct->leaf_pool.size = nb_leaves;
+	ct->nodes = rte_zmalloc_socket(name,
+		(nb_nodes + CT_NUM_SLOTS) * sizeof(ct->nodes[0]),
+		RTE_CACHE_LINE_SIZE, socket_id);
+	ct->node_rules = rte_zmalloc_socket(name,
+		nb_nodes * 2 * sizeof(ct->node_rules[0]),
+		RTE_CACHE_LINE_SIZE, socket_id);
+	ct->leaves = rte_zmalloc_socket(name,
+		(nb_leaves + CT_NUM_SLOTS) * sizeof(ct->leaves[0]),
+		RTE_CACHE_LINE_SIZE, socket_id);
+	if (ct->nodes == NULL || ct->node_rules == NULL ||
+			ct->leaves == NULL) {
+		lpm6_ct_free(ct);
+		return NULL;
+	}
+
+#if defined(RTE_MACHINE_CPUFLAG_AVX512F) && \
+	defined(RTE_MACHINE_CPUFLAG_AVX512BW)
+	ct->vector = rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) > 0 &&
+		rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512BW) > 0;
+#endif
+
+	return ct;
+}
+
+void
+lpm6_ct_free(struct lpm6_ct *ct)
+{
+	if (ct == NULL)
+		return;
+
+	rte_free(ct->nodes);
+	rte_free(ct->node_rules);
+	rte_free(ct->leaves);
+	rte_free(ct);
+}
+
+/*
+ * An update makes the change counter odd while it runs, so that the
+ * lookups overlapping it are retried.
+ */
+static inline void
+ct_update_begin(struct lpm6_ct *ct)
+{
+	__atomic_store_n(&ct->chg_cnt, ct->chg_cnt + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static inline void
+ct_update_end(struct lpm6_ct *ct)
+{
+	__atomic_store_n(&ct->chg_cnt, ct->chg_cnt + 1, __ATOMIC_RELEASE);
+}
+
+static inline uint32_t
+ct_read_begin(const struct lpm6_ct *ct)
+{
+	uint32_t cnt;
+
+	while ((cnt = __atomic_load_n(&ct->chg_cnt, __ATOMIC_ACQUIRE)) & 1)
+		rte_pause();
+	return cnt;
+}
+
+static inline int
+ct_read_retry(const struct lpm6_ct *ct, uint32_t cnt)
+{
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	return __atomic_load_n(&ct->chg_cnt, __ATOMIC_RELAXED) != cnt;
+}
+
+void
+lpm6_ct_reset(struct lpm6_ct *ct)
+{
+	unsigned int i;
+
+	ct_update_begin(ct);
+	for (i = 0; i < CT_DIR_NUM_ENT; i++)
+		__atomic_store_n(&ct->dir[i], 0, __ATOMIC_RELAXED);
+	memset(ct->dir_leaf, 0, sizeof(ct->dir_leaf));
+	memset(ct->dir_depth, 0, sizeof(ct->dir_depth));
+	ct_pools_init(ct);
+	ct_update_end(ct);
+}
+
+static inline uint32_t
+node_leaf(const struct lpm6_ct *ct, const struct ct_node *node,
+	unsigned int slot)
+{
+	uint64_t msk = (2ULL << slot) - 1;
+
+	return ct->leaves[node->base0 +
+		__builtin_popcountll(node->leafvec & msk) - 1];
+}
+
+static inline uint32_t
+node_child(const struct ct_node *node, unsigned int slot)
+{
+	return node->base1 +
+		__builtin_popcountll(node->vector & ((1ULL << slot) - 1));
+}
+
+/* Leaf used for a slot of the node */
+static inline uint32_t
+node_resolve(const struct ct_node *node, uint32_t leaf)
+{
+	return (leaf != 0) ? leaf : node->def;
+}
+
+static void
+node_get_leaves(const struct lpm6_ct *ct, uint32_t idx, uint32_t *vals)
+{
+	const struct ct_node *node = &ct->nodes[idx];
+	const uint32_t *leaf = &ct->leaves[node->base0];
+	unsigned int i;
+	int j = -1;
+
+	for (i = 0; i < CT_NUM_SLOTS; i++) {
+		if (node->leafvec & (1ULL << i))
+			j++;
+		vals[i] = leaf[j];
+	}
+}
+
+/* Compress the leaves of the node into a new block */
+static void
+node_set_leaves(struct lpm6_ct *ct, uint32_t idx, const uint32_t *vals)
+{
+	struct ct_node *node = &ct->nodes[idx];
+	uint64_t leafvec = 1;
+	uint32_t blk, old, n = 1;
+	unsigned int i;
+
+	for (i = 1; i < CT_NUM_SLOTS; i++) {
+		if (vals[i] != vals[i - 1]) {
+			leafvec |= 1ULL << i;
+			n++;
+		}
+	}
+
+	blk = leaf_blk_get(ct, n);
+	for (i = 0, n = 0; i < CT_NUM_SLOTS; i++)
+		if (leafvec & (1ULL << i))
+			ct->leaves[blk + n++] = vals[i];
+
+	old = node->base0;
+	n = __builtin_popcountll(node->leafvec);
+	node->base0 = blk;
+	node->leafvec = leafvec;
+	leaf_blk_put(ct, old, n);
+}
+
+static void
+node_init(struct lpm6_ct *ct, uint32_t idx, uint32_t def)
+{
+	struct ct_node *node = &ct->nodes[idx];
+
+	node->vector = 0;
+	node->leafvec = 1;
+	node->base0 = leaf_blk_get(ct, 1);
+	node->base1 = 0;
+	node->def = def;
+	node->next_free = 0;
+	ct->leaves[node->base0] = 0;
+	ct->node_rules[idx * 2] = 0;
+	ct->node_rules[idx * 2 + 1] = 0;
+	ct->nb_nodes++;
+}
+
+static void
+node_move(struct lpm6_ct *ct, uint32_t dst, uint32_t src, uint32_t n)
+{
+	memcpy(&ct->nodes[dst], &ct->nodes[src], n * sizeof(ct->nodes[0]));
+	memcpy(&ct->node_rules[dst * 2], &ct->node_rules[src * 2],
+		n * 2 * sizeof(ct->node_rules[0]));
+}
+
+/* Insert a child in the children block of a node */
+static uint32_t
+node_add_child(struct lpm6_ct *ct, uint32_t idx, unsigned int slot,
+	uint32_t def)
+{
+	struct ct_node *node = &ct->nodes[idx];
+	uint32_t n = __builtin_popcountll(node->vector);
+	uint32_t rank = __builtin_popcountll(node->vector &
+		((1ULL << slot) - 1));
+	uint32_t blk = node_blk_get(ct, n + 1);
+
+	node_move(ct, blk, node->base1, rank);
+	node_move(ct, blk + rank + 1, node->base1 + rank, n - rank);
+	node_init(ct, blk + rank, def);
+	if (n != 0)
+		node_blk_put(ct, node->base1, n);
+	node->base1 = blk;
+	node->vector |= 1ULL << slot;
+
+	return blk + rank;
+}
+
+/* Remove a child, which has no children itself */
+static void
+node_del_child(struct lpm6_ct *ct, uint32_t idx, unsigned int slot)
+{
+	struct ct_node *node = &ct->nodes[idx];
+	uint32_t n = __builtin_popcountll(node->vector);
+	uint32_t rank = __builtin_popcountll(node->vector &
+		((1ULL << slot) - 1));
+	uint32_t child = node->base1 + rank;
+	uint32_t old, blk = 0;
+
+	leaf_blk_put(ct, ct->nodes[child].base0,
+		__builtin_popcountll(ct->nodes[child].leafvec));
+	ct->nb_nodes--;
+
+	if (n > 1) {
+		blk = node_blk_get(ct, n - 1);
+		node_move(ct, blk, node->base1, rank);
+		node_move(ct, blk + rank, child + 1, n - rank - 1);
+	}
+	old = node->base1;
+	node->vector &= ~(1ULL << slot);
+	node->base1 = blk;
+	node_blk_put(ct, old, n);
+}
+
+/* Change the leaf a node inherits, and so do its inheriting children */
+static void
+node_set_def(struct lpm6_ct *ct, uint32_t idx, uint32_t def)
+{
+	struct ct_node *node = &ct->nodes[idx];
+	uint64_t vector;
+	unsigned int slot;
+
+	if (node->def == def)
+		return;
+
+	node->def = def;
+	for (vector = node->vector; vector != 0; vector &= vector - 1) {
+		slot = __builtin_ctzll(vector);
+		if (node_leaf(ct, node, slot) == 0)
+			node_set_def(ct, node_child(node, slot), def);
+	}
+}
+
+/* Rules of a node are indexed by their length and prefix in the node */
+static inline unsigned int
+rule_bit(unsigned int len, unsigned int pfx)
+{
+	return (1 << len) - 2 + pfx;
+}
+
+static inline int
+rule_test(const struct lpm6_ct *ct, uint32_t idx, unsigned int bit)
+{
+	return (ct->node_rules[idx * 2 + bit / 64] >> (bit % 64)) & 1;
+}
+
+/* Check if a slot is covered by a rule of the node longer than len */
+static int
+rule_covered(const struct lpm6_ct *ct, uint32_t idx, unsigned int slot,
+	unsigned int len)
+{
+	unsigned int l;
+
+	for (l = len + 1; l <= CT_STRIDE; l++)
+		if (rule_test(ct, idx, rule_bit(l, slot >> (CT_STRIDE - l))))
+			return 1;
+	return 0;
+}
+
+/* Set the leaf of the slots of a rule that no longer rule covers */
+static void
+node_update_rule(struct lpm6_ct *ct, uint32_t idx, unsigned int len,
+	unsigned int pfx, uint32_t leaf)
+{
+	uint32_t vals[CT_NUM_SLOTS];
+	unsigned int slot, first, last;
+	struct ct_node *node;
+
+	first = pfx << (CT_STRIDE - len);
+	last = first + (1 << (CT_STRIDE - len));
+
+	node_get_leaves(ct, idx, vals);
+	for (slot = first; slot < last; slot++)
+		if (!rule_covered(ct, idx, slot, len))
+			vals[slot] = leaf;
+	node_set_leaves(ct, idx, vals);
+
+	node = &ct->nodes[idx];
+	for (slot = first; slot < last; slot++)
+		if (node->vector & (1ULL << slot))
+			node_set_def(ct, node_child(node, slot),
+				node_resolve(node, vals[slot]));
+}
+
+static void
+dir_set(struct lpm6_ct *ct, uint32_t i, uint32_t leaf, uint8_t depth)
+{
+	ct->dir_leaf[i] = leaf;
+	ct->dir_depth[i] = depth;
+	if (ct->dir[i] & CT_DIR_NODE)
+		node_set_def(ct, ct->dir[i] & ~CT_DIR_NODE, leaf);
+	else
+		ct->dir[i] = leaf;
+}
+
+int
+lpm6_ct_reserve(struct lpm6_ct *ct, const uint8_t *ip, uint8_t depth)
+{
+	const struct ct_node *node;
+	uint32_t i = dir_idx(ip);
+	uint32_t idx, needed = 0;
+	unsigned int lvl, level, slot;
+
+	if (depth > CT_DIR_BITS) {
+		level = depth_level(depth);
+		if (!(ct->dir[i] & CT_DIR_NODE))
+			needed = level + 1;
+		else {
+			idx = ct->dir[i] & ~CT_DIR_NODE;
+			for (lvl = 0; lvl < level; lvl++) {
+				node = &ct->nodes[idx];
+				slot = ct_slot(ip, lvl);
+				if (!(node->vector & (1ULL << slot))) {
+					needed = level - lvl;
+					break;
+				}
+				idx = node_child(node, slot);
+			}
+		}
+	}
+
+	if (ct->nb_nodes + needed > ct->max_nodes)
+		return -ENOSPC;
+
+	return ct_pools_room(ct);
+}
+
+void
+lpm6_ct_add(struct lpm6_ct *ct, const uint8_t *ip, uint8_t depth,
+	uint32_t next_hop)
+{
+	uint32_t leaf = CT_LEAF_VALID | (next_hop & CT_NH_MASK);
+	uint32_t i = dir_idx(ip);
+	uint32_t idx, last;
+	unsigned int lvl, level, len, pfx, slot;
+	struct ct_node *node;
+	uint64_t *rules;
+
+	ct_update_begin(ct);
+
+	if (depth <= CT_DIR_BITS) {
+		last = i + (1 << (CT_DIR_BITS - depth));
+		for (; i < last; i++)
+			if (ct->dir_depth[i] <= depth)
+				dir_set(ct, i, leaf, depth);
+		ct_update_end(ct);
+		return;
+	}
+
+	if (!(ct->dir[i] & CT_DIR_NODE)) {
+		idx = node_blk_get(ct, 1);
+		node_init(ct, idx, ct->dir_leaf[i]);
+		ct->dir[i] = CT_DIR_NODE | idx;
+	}
+	idx = ct->dir[i] & ~CT_DIR_NODE;
+
+	level = depth_level(depth);
+	for (lvl = 0; lvl < level; lvl++) {
+		node = &ct->nodes[idx];
+		slot = ct_slot(ip, lvl);
+		if (node->vector & (1ULL << slot))
+			idx = node_child(node, slot);
+		else
+			idx = node_add_child(ct, idx, slot,
+				node_resolve(node, node_leaf(ct, node, slot)));
+	}
+
+	len = depth - CT_DIR_BITS - level * CT_STRIDE;
+	pfx = ct_slot(ip, level) >> (CT_STRIDE - len);
+	rules = &ct->node_rules[idx * 2];
+	rules[rule_bit(len, pfx) / 64] |= 1ULL << (rule_bit(len, pfx) % 64);
+	node_update_rule(ct, idx, len, pfx, leaf);
+
+	ct_update_end(ct);
+}
+
+void
+lpm6_ct_delete(struct lpm6_ct *ct, const uint8_t *ip, uint8_t depth,
+	uint8_t lsp_depth, uint32_t lsp_next_hop)
+{
+	uint32_t lsp_leaf = 0;
+	uint32_t path[CT_NUM_LEVELS];
+	uint32_t i = dir_idx(ip);
+	uint32_t idx, last;
+	unsigned int lvl, level, len, pfx, slot;
+	const struct ct_node *node;
+	uint64_t *rules;
+
+	if (lsp_depth != 0)
+		lsp_leaf = CT_LEAF_VALID | (lsp_next_hop & CT_NH_MASK);
+
+	ct_update_begin(ct);
+
+	if (depth <= CT_DIR_BITS) {
+		last = i + (1 << (CT_DIR_BITS - depth));
+		for (; i < last; i++)
+			if (ct->dir_depth[i] == depth)
+				dir_set(ct, i, lsp_leaf, lsp_depth);
+		goto end;
+	}
+
+	if (!(ct->dir[i] & CT_DIR_NODE))
+		goto end;
+	idx = ct->dir[i] & ~CT_DIR_NODE;
+
+	level = depth_level(depth);
+	for (lvl = 0; lvl < level; lvl++) {
+		path[lvl] = idx;
+		node = &ct->nodes[idx];
+		slot = ct_slot(ip, lvl);
+		if (!(node->vector & (1ULL << slot)))
+			goto end;
+		idx = node_child(node, slot);
+	}
+	path[level] = idx;
+
+	len = depth - CT_DIR_BITS - level * CT_STRIDE;
+	pfx = ct_slot(ip, level) >> (CT_STRIDE - len);
+	rules = &ct->node_rules[idx * 2];
+	rules[rule_bit(len, pfx) / 64] &= ~(1ULL << (rule_bit(len, pfx) % 64));
+
+	/* the covering rule only gives a leaf if it belongs to this node */
+	if (lsp_depth <= CT_DIR_BITS + level * CT_STRIDE)
+		lsp_leaf = 0;
+	node_update_rule(ct, idx, len, pfx, lsp_leaf);
+
+	/* remove the nodes left without rules nor children */
+	for (lvl = level; ; lvl--) {
+		idx = path[lvl];
+		node = &ct->nodes[idx];
+		if (node->vector != 0 || ct->node_rules[idx * 2] != 0 ||
+				ct->node_rules[idx * 2 + 1] != 0)
+			break;
+		if (lvl == 0) {
+			ct->dir[i] = ct->dir_leaf[i];
+			leaf_blk_put(ct, node->base0,
+				__builtin_popcountll(node->leafvec));
+			node_blk_put(ct, idx, 1);
+			ct->nb_nodes--;
+			break;
+		}
+		node_del_child(ct, path[lvl - 1], ct_slot(ip, lvl - 1));
+	}
+
+end:
+	ct_update_end(ct);
+}
+
+static inline uint32_t
+ct_lookup(const struct lpm6_ct *ct, const uint8_t *ip)
+{
+	const struct ct_node *node;
+	uint32_t ent, leaf;
+	unsigned int lvl;
+	uint64_t bit;
+
+	ent = ct->dir[dir_idx(ip)];
+	if (!(ent & CT_DIR_NODE))
+		return ent;
+
+	node = &ct->nodes[ent & ~CT_DIR_NODE];
+	for (lvl = 0; ; lvl++) {
+		bit = 1ULL << ct_slot(ip, lvl);
+		/* a lookup overlapping an update may see a deeper trie */
+		if (!(node->vector & bit) || lvl == CT_NUM_LEVELS - 1)
+			break;
+		node = &ct->nodes[node->base1 +
+			__builtin_popcountll(node->vector & (bit - 1))];
+	}
+
+	leaf = ct->leaves[node->base0 +
+		__builtin_popcountll(node->leafvec & ((bit << 1) - 1)) - 1];
+	return node_resolve(node, leaf);
+}
+
+int
+lpm6_ct_lookup(const struct lpm6_ct *ct, const uint8_t *ip,
+	uint32_t *next_hop)
+{
+	uint32_t leaf, cnt;
+
+	do {
+		cnt = ct_read_begin(ct);
+		leaf = ct_lookup(ct, ip);
+	} while (ct_read_retry(ct, cnt));
+
+	*next_hop = leaf & CT_NH_MASK;
+	return (leaf & CT_LEAF_VALID) ? 0 : -ENOENT;
+}
+
+#if defined(RTE_MACHINE_CPUFLAG_AVX512F) && \
+	defined(RTE_MACHINE_CPUFLAG_AVX512BW)
+
+/* Popcount of each 64 bit lane, as there is no AVX512 VPOPCNTDQ */
+static __rte_always_inline __m512i
+popcnt64_x8(__m512i v)
+{
+	const __m512i lut = _mm512_set4_epi32(0x04030302, 0x03020201,
+		0x03020201, 0x02010100);
+	const __m512i low = _mm512_set1_epi8(0x0F);
+	__m512i lo, hi;
+
+	lo = _mm512_shuffle_epi8(lut, _mm512_and_si512(v, low));
+	hi = _mm512_shuffle_epi8(lut,
+		_mm512_and_si512(_mm512_srli_epi64(v, 4), low));
+	return _mm512_sad_epu8(_mm512_add_epi8(lo, hi),
+		_mm512_setzero_si512());
+}
+
+static __rte_always_inline __m512i
+slot_x8(__m512i hi, __m512i lo, unsigned int level)
+{
+	unsigned int off = CT_DIR_BITS + level * CT_STRIDE;
+	__m512i v;
+
+	if (off + CT_STRIDE <= 64)
+		v = _mm512_srl_epi64(hi,
+			_mm_cvtsi32_si128(64 - CT_STRIDE - off));
+	else if (off + CT_STRIDE > CT_MAX_DEPTH)
+		v = _mm512_sll_epi64(lo,
+			_mm_cvtsi32_si128(off + CT_STRIDE - CT_MAX_DEPTH));
+	else if (off >= 64)
+		v = _mm512_srl_epi64(lo,
+			_mm_cvtsi32_si128(CT_MAX_DEPTH - CT_STRIDE - off));
+	else
+		v = _mm512_or_si512(
+			_mm512_sll_epi64(hi,
+				_mm_cvtsi32_si128(off + CT_STRIDE - 64)),
+			_mm512_srl_epi64(lo,
+				_mm_cvtsi32_si128(CT_MAX_DEPTH - CT_STRIDE - off)));
+
+	return _mm512_and_si512(v, _mm512_set1_epi64(CT_NUM_SLOTS - 1));
+}
+
+static void
+ct_lookup_x8(const struct lpm6_ct *ct, uint8_t ips[][16],
+	int32_t *next_hops)
+{
+	const __m512i bswap = _mm512_broadcast_i32x4(_mm_set_epi8(8, 9, 10,
+		11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7));
+	const __m512i hi_perm = _mm512_set_epi64(14, 12, 10, 8, 6, 4, 2, 0);
+	const __m512i lo_perm = _mm512_set_epi64(15, 13, 11, 9, 7, 5, 3, 1);
+	const __m512i u32_msk = _mm512_set1_epi64(UINT32_MAX);
+	const __m512i one = _mm512_set1_epi64(1);
+	const __m512i zero = _mm512_setzero_si512();
+	const __m512i node_flag = _mm512_set1_epi64(CT_DIR_NODE);
+	const struct ct_node *nodes = ct->nodes;
+	__m512i first, second, hi, lo, res, idx;
+	__m512i vector, leafvec, bases, def, bit, lidx, leaf;
+	__mmask8 active, internal, done;
+	unsigned int lvl;
+
+	first = _mm512_shuffle_epi8(_mm512_loadu_si512(ips[0]), bswap);
+	second = _mm512_shuffle_epi8(_mm512_loadu_si512(ips[4]), bswap);
+	hi = _mm512_permutex2var_epi64(first, hi_perm, second);
+	lo = _mm512_permutex2var_epi64(first, lo_perm, second);
+
+	res = _mm512_cvtepu32_epi64(_mm512_i64gather_epi32(
+		_mm512_srli_epi64(hi, 64 - CT_DIR_BITS), ct->dir, 4));
+	active = _mm512_test_epi64_mask(res, node_flag);
+	idx = _mm512_andnot_si512(node_flag, res);
+
+	for (lvl = 0; active != 0; lvl++) {
+		/* nodes are 4 quadwords */
+		idx = _mm512_slli_epi64(idx, 2);
+		vector = _mm512_mask_i64gather_epi64(zero, active, idx,
+			&nodes->vector, 8);
+		leafvec = _mm512_mask_i64gather_epi64(zero, active, idx,
+			&nodes->leafvec, 8);
+		bases = _mm512_mask_i64gather_epi64(zero, active, idx,
+			&nodes->base0, 8);
+		def = _mm512_mask_i64gather_epi64(zero, active, idx,
+			&nodes->def, 8);
+
+		bit = _mm512_sllv_epi64(one, slot_x8(hi, lo, lvl));
+		internal = (lvl == CT_NUM_LEVELS - 1) ? 0 :
+			_mm512_mask_test_epi64_mask(active, vector, bit);
+		done = active & ~internal;
+
+		if (done != 0) {
+			lidx = _mm512_add_epi64(_mm512_and_si512(bases, u32_msk),
+				popcnt64_x8(_mm512_and_si512(leafvec,
+				_mm512_or_si512(bit, _mm512_sub_epi64(bit, one)))));
+			lidx = _mm512_sub_epi64(lidx, one);
+			leaf = _mm512_cvtepu32_epi64(_mm512_mask_i64gather_epi32(
+				_mm256_setzero_si256(), done, lidx,
+				ct->leaves, 4));
+			leaf = _mm512_mask_blend_epi64(
+				_mm512_test_epi64_mask(leaf, leaf),
+				_mm512_and_si512(def, u32_msk), leaf);
+			res = _mm512_mask_mov_epi64(res, done, leaf);
+		}
+
+		idx = _mm512_add_epi64(_mm512_srli_epi64(bases, 32),
+			popcnt64_x8(_mm512_and_si512(vector,
+			_mm512_sub_epi64(bit, one))));
+		active = internal;
+	}
+
+	res = _mm512_mask_blend_epi64(
+		_mm512_test_epi64_mask(res, _mm512_set1_epi64(CT_LEAF_VALID)),
+		_mm512_set1_epi64(-1),
+		_mm512_and_si512(res, _mm512_set1_epi64(CT_NH_MASK)));
+	_mm256_storeu_si256((void *)next_hops, _mm512_cvtepi64_epi32(res));
+}
+
+#endif
+
+static void
+ct_lookup_bulk(const struct lpm6_ct *ct, uint8_t ips[][16],
+	int32_t *next_hops, unsigned int n)
+{
+	unsigned int i = 0;
+	uint32_t leaf;
+
+#if defined(RTE_MACHINE_CPUFLAG_AVX512F) && \
+	defined(RTE_MACHINE_CPUFLAG_AVX512BW)
+	if (ct->vector)
+		for (; i + 8 <= n; i += 8)
+			ct_lookup_x8(ct, &ips[i], &next_hops[i]);
+#endif
+
+	for (; i < n; i++) {
+		leaf = ct_lookup(ct, ips[i]);
+		next_hops[i] = (leaf & CT_LEAF_VALID) ?
+			(int32_t)(leaf & CT_NH_MASK) : -1;
+	}
+}
+
+void
+lpm6_ct_lookup_bulk(const struct lpm6_ct *ct, uint8_t ips[][16],
+	int32_t *next_hops, unsigned int n)
+{
+	unsigned int i, num;
+	uint32_t cnt;
+
+	/* retry short bursts, not the whole array, on an update */
+	for (i = 0; i < n; i += num) {
+		num = RTE_MIN(n - i, (unsigned int)CT_LOOKUP_BURST);
+		do {
+			cnt = ct_read_begin(ct);
+			ct_lookup_bulk(ct, &ips[i], &next_hops[i], num);
+		} while (ct_read_retry(ct, cnt));
+	}
+}
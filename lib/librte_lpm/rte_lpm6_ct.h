@@ -0,0 +1,72 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#ifndef _RTE_LPM6_CT_H_
+#define _RTE_LPM6_CT_H_
+
+/**
+ * @file
+ * Compact multibit trie backend of the IPv6 LPM library (internal)
+ *
+ * The lookups can run concurrently with an update, the updates must be
+ * serialized by the caller.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct lpm6_ct;
+
+/*
+ * Create the trie. Up to max_nodes trie nodes can be used, their memory
+ * is allocated at creation.
+ */
+struct lpm6_ct *
+lpm6_ct_create(const char *name, int socket_id, uint32_t max_nodes);
+
+void
+lpm6_ct_free(struct lpm6_ct *ct);
+
+/*
+ * Check that a rule can be added or deleted, and that the pools have room
+ * for the update, so that lpm6_ct_add() and lpm6_ct_delete() cannot fail.
+ * Returns 0, or -ENOSPC if there are not enough trie nodes or pool room.
+ */
+int
+lpm6_ct_reserve(struct lpm6_ct *ct, const uint8_t *ip, uint8_t depth);
+
+/* Add or update a rule, the ip must be masked to the depth. */
+void
+lpm6_ct_add(struct lpm6_ct *ct, const uint8_t *ip, uint8_t depth,
+	uint32_t next_hop);
+
+/*
+ * Delete a rule, the ip must be masked to the depth. The longest rule
+ * covering it, if any, is given by lsp_depth and lsp_next_hop,
+ * lsp_depth is 0 otherwise.
+ */
+void
+lpm6_ct_delete(struct lpm6_ct *ct, const uint8_t *ip, uint8_t depth,
+	uint8_t lsp_depth, uint32_t lsp_next_hop);
+
+/* Delete all the rules. */
+void
+lpm6_ct_reset(struct lpm6_ct *ct);
+
+int
+lpm6_ct_lookup(const struct lpm6_ct *ct, const uint8_t *ip,
+	uint32_t *next_hop);
+
+void
+lpm6_ct_lookup_bulk(const struct lpm6_ct *ct, uint8_t ips[][16],
+	int32_t *next_hops, unsigned int n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_LPM6_CT_H_ */
@@ -3,6 +3,7 @@
  */
 
 #include <sys/queue.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <limits.h>
 
@@ -100,6 +101,7 @@ static int
 init_shared_mem(void)
 {
 	const struct rte_memzone *mz;
+	bool restored = false;
 	uint64_t mask;
 
 	if (rte_eal_process_type() == RTE_PROC_PRIMARY) {
@@ -107,6 +109,11 @@ init_shared_mem(void)
 						sizeof(struct mbuf_dyn_shm),
 						SOCKET_ID_ANY, 0,
 						RTE_CACHE_LINE_SIZE);
+		/* the mbufs kept by a warm restart still use these fields */
+		if (mz == NULL && rte_eal_warm_restarted()) {
+			mz = rte_memzone_lookup(RTE_MBUF_DYN_MZNAME);
+			restored = true;
+		}
 	} else {
 		mz = rte_memzone_lookup(RTE_MBUF_DYN_MZNAME);
 	}
@@ -115,7 +122,7 @@ init_shared_mem(void)
 
 	shm = mz->addr;
 
-	if (rte_eal_process_type() == RTE_PROC_PRIMARY) {
+	if (rte_eal_process_type() == RTE_PROC_PRIMARY && !restored) {
 		/* init free_space, keep it sync'd with
 		 * rte_mbuf_dynfield_copy().
 		 */
@@ -10,11 +10,13 @@
  * The Membership Library is an extension and generalization of a traditional
  * filter (for example Bloom Filter and cuckoo filter) structure that has
  * multiple usages in a variety of workloads and applications. The library is
- * used to test if a key belongs to certain sets. Two types of such
- * "set-summary" structures are implemented: hash-table based (HT) and vector
- * bloom filter (vBF). For HT setsummary, two subtypes or modes are available,
- * cache and non-cache modes. The table below summarize some properties of
- * the different implementations.
+ * used to test if a key belongs to certain sets. Three types of such
+ * "set-summary" structures are implemented: hash-table based (HT), vector
+ * bloom filter (vBF) and cuckoo filter (CF). For HT setsummary, two subtypes
+ * or modes are available, cache and non-cache modes. The table below
+ * summarize some properties of the different implementations.
+ * A count-min sketch type is also provided, which estimates how often each
+ * key was seen and tracks the most frequent keys (heavy hitters).
  *
  * @warning
  * @b EXPERIMENTAL: this API may change without prior notice
@@ -39,6 +41,18 @@
  * |          |                     | not overwrite  |                         |
  * |          |                     | existing key.  |                         |
  * +----------+---------------------+----------------+-------------------------+
+ *
+ * +==========+================================================================+
+ * |   type   |      cf                                                        |
+ * +==========+================================================================+
+ * |structure |  cuckoo filter, fingerprint and set id packed in 16 or 32 bits |
+ * +----------+----------------------------------------------------------------+
+ * |set id    |  [1, num_set], num_set up to 0x7fff                            |
+ * +----------+----------------------------------------------------------------+
+ * |usages &  |  can delete, user-specified false-positive rate, one probe of  |
+ * |properties|  two buckets whatever the number of sets, no false-negative,   |
+ * |          |  the table can become full.                                    |
+ * +----------+----------------------------------------------------------------+
  * -->
  */
 
@@ -52,6 +66,7 @@ extern "C" {
 #include <stdint.h>
 
 #include <rte_common.h>
+#include <rte_compat.h>
 #include <rte_config.h>
 
 /** The set ID type that stored internally in hash table based set summary. */
@@ -66,6 +81,8 @@ typedef uint16_t member_set_t;
 #define RTE_MEMBER_BUCKET_ENTRIES 16
 /** Maximum number of characters in setsum name. */
 #define RTE_MEMBER_NAMESIZE 32
+/** Maximum number of heavy hitters tracked by a sketch. */
+#define RTE_MEMBER_SKETCH_TOPK_MAX 128
 
 /** @internal Hash function used by membership library. */
 #if defined(RTE_ARCH_X86) || defined(RTE_MACHINE_CPUFLAG_CRC32)
@@ -105,6 +122,8 @@ struct rte_member_parameters;
 enum rte_member_setsum_type {
 	RTE_MEMBER_TYPE_HT = 0,  /**< Hash table based set summary. */
 	RTE_MEMBER_TYPE_VBF,     /**< Vector of bloom filters. */
+	RTE_MEMBER_TYPE_CF,      /**< Cuckoo filter. */
+	RTE_MEMBER_TYPE_SKETCH,  /**< Count-min sketch with heavy hitters. */
 	RTE_MEMBER_NUM_TYPE
 };
 
@@ -142,6 +161,17 @@ struct rte_member_setsum {
 
 
 	/* Second cache line should start here. */
+	/* Cuckoo filter, bucket_cnt and bucket_mask are also used. */
+	uint32_t cf_entries;	/* Number of entries per bucket. */
+	uint32_t fp_bits;	/* Number of bits of the fingerprint. */
+	uint32_t set_bits;	/* Number of bits of the set id. */
+
+	/* Count-min sketch. */
+	uint32_t num_row;	/* Number of counter rows. */
+	uint32_t num_col;	/* Number of counters per row. */
+	uint32_t col_mask;	/* Bit mask to get counter index in a row. */
+	uint32_t top_k;		/* Number of heavy hitters tracked. */
+
 	uint32_t socket_id;          /* NUMA Socket ID for memory. */
 	char name[RTE_MEMBER_NAMESIZE]; /* Name of this set summary. */
 } __rte_cache_aligned;
@@ -216,13 +246,17 @@ struct rte_member_parameters {
 	uint32_t key_len;
 
 	/**
-	 * num_set is only used for vBF, but not used for HT setsummary.
+	 * num_set is only used for vBF and CF, but not used for HT setsummary.
 	 *
 	 * num_set is equal to the number of BFs in vBF. For current
 	 * implementation, it only supports 1,2,4,8,16,32 BFs in one vBF set
 	 * summary. If other number of sets are needed, for example 5, the user
 	 * should allocate the minimum available value that larger than 5,
 	 * which is 8.
+	 *
+	 * For CF, num_set is the largest set id, up to 0x7fff. It does not
+	 * need to be a power of 2. The fewer bits the set ids need, the more
+	 * are left for the fingerprint in each entry.
 	 */
 	uint32_t num_set;
 
@@ -236,6 +270,15 @@ struct rte_member_parameters {
 	 * hash values used during lookup and insertion. For details please
 	 * refer to vBF implementation and membership library documentation.
 	 *
+	 * For CF, the fingerprint is sized so that a lookup of a key which was
+	 * not added matches with about this probability, whatever the number
+	 * of keys. Entries are 16-bit when the fingerprint and the set id fit,
+	 * 32-bit otherwise.
+	 *
+	 * For sketch, it is the probability that the count of a key is
+	 * over-estimated by more than error_rate times the total count, it
+	 * sets the number of counter rows.
+	 *
 	 * For HT, This parameter is not directly set by users.
 	 * HT setsummary's false positive rate is in the order of:
 	 * false_pos = (1/bucket_count)*(1/2^16), since we use 16-bit signature.
@@ -263,6 +306,24 @@ struct rte_member_parameters {
 	uint32_t sec_hash_seed;
 
 	int socket_id;			/**< NUMA Socket ID for memory. */
+
+	/**
+	 * top_k is only used for sketch.
+	 *
+	 * Number of heavy hitters, the keys with the largest counts, that are
+	 * tracked, up to RTE_MEMBER_SKETCH_TOPK_MAX. 0 disables the tracking.
+	 */
+	uint32_t top_k;
+
+	/**
+	 * error_rate is only used for sketch.
+	 *
+	 * The count of a key is over-estimated by at most error_rate times
+	 * the total count (with probability 1 - false_positive_rate). It sets
+	 * the number of counters per row. The sketch does not depend on
+	 * num_keys.
+	 */
+	float error_rate;
 };
 
 /**
@@ -302,6 +363,8 @@ rte_member_create(const struct rte_member_parameters *params);
  *
  * Lookup key in set-summary (SS).
  * Single key lookup and return as soon as the first match found
+ * For sketch, a key matches with set id 1 if it is one of the tracked heavy
+ * hitters.
  *
  * @param setsum
  *   Pointer of a setsummary.
@@ -418,8 +481,10 @@ rte_member_lookup_multi_bulk(const struct rte_member_setsum *setsum,
  *   supports different set_id ranges. 0 cannot be used as set_id since
  *   RTE_MEMBER_NO_MATCH by default is set as 0.
  *   For HT mode, the set_id has range as [1, 0x7FFF], MSB is reserved.
- *   For vBF mode the set id is limited by the num_set parameter when create
- *   the set-summary.
+ *   For vBF and CF mode the set id is limited by the num_set parameter when
+ *   create the set-summary.
+ *   For sketch, the count of the key is incremented by one and set_id is
+ *   ignored.
  * @return
  *   HT (cache mode) and vBF should never fail unless the set_id is not in the
  *   valid range. In such case -EINVAL is returned.
@@ -428,9 +493,9 @@ rte_member_lookup_multi_bulk(const struct rte_member_setsum *setsum,
  *   For success it returns different values for different modes to provide
  *   extra information for users.
  *   Return 0 for HT (cache mode) if the add does not cause
- *   eviction, return 1 otherwise. Return 0 for non-cache mode if success,
- *   -ENOSPC for full, and 1 if cuckoo eviction happens.
- *   Always returns 0 for vBF mode.
+ *   eviction, return 1 otherwise. Return 0 for non-cache mode and CF if
+ *   success, -ENOSPC for full, and 1 if cuckoo eviction happens.
+ *   Always returns 0 for vBF mode and sketch.
  */
 int
 rte_member_add(const struct rte_member_setsum *setsum, const void *key,
@@ -465,15 +530,16 @@ rte_member_reset(const struct rte_member_setsum *setsum);
  * @warning
  * @b EXPERIMENTAL: this API may change without prior notice
  *
- * Delete items from the set-summary. Note that vBF does not support deletion
- * in current implementation. For vBF, error code of -EINVAL will be returned.
+ * Delete items from the set-summary. Note that vBF and sketch do not support
+ * deletion in current implementation. For vBF and sketch, error code of
+ * -EINVAL will be returned.
  *
  * @param setsum
  *   Pointer to the set-summary.
  * @param key
  *   Pointer of the key to be deleted.
  * @param set_id
- *   For HT mode, we need both key and its corresponding set_id to
+ *   For HT and CF mode, we need both key and its corresponding set_id to
  *   properly delete the key. Without set_id, we may delete other keys with the
  *   same signature.
  * @return
@@ -483,6 +549,95 @@ int
 rte_member_delete(const struct rte_member_setsum *setsum, const void *key,
 			member_set_t set_id);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Add to the count of a key in a sketch, for example the length of a packet
+ * to count bytes instead of packets. The heavy hitters are updated.
+ *
+ * @param setsum
+ *   Pointer to the sketch.
+ * @param key
+ *   Pointer of the key to be counted.
+ * @param count
+ *   Value added to the count of the key.
+ * @return
+ *   0 on success, -EINVAL if the set-summary is not a sketch.
+ */
+__rte_experimental
+int
+rte_member_add_count(const struct rte_member_setsum *setsum, const void *key,
+			uint32_t count);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Estimate the count of a key in a sketch. The estimate is never lower than
+ * the real count.
+ *
+ * @param setsum
+ *   Pointer to the sketch.
+ * @param key
+ *   Pointer of the key to be looked up.
+ * @param count
+ *   Output the estimated count of the key.
+ * @return
+ *   0 on success, -EINVAL if the set-summary is not a sketch.
+ */
+__rte_experimental
+int
+rte_member_query_count(const struct rte_member_setsum *setsum,
+			const void *key, uint64_t *count);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Estimate the counts of a bulk of keys in a sketch. The counters of all the
+ * keys are prefetched before they are read.
+ *
+ * @param setsum
+ *   Pointer to the sketch.
+ * @param keys
+ *   Pointer of the bulk of keys to be looked up.
+ * @param num_keys
+ *   Number of keys that will be lookup.
+ * @param counts
+ *   Output the estimated counts of the keys to this array.
+ * @return
+ *   0 on success, -EINVAL if the set-summary is not a sketch.
+ */
+__rte_experimental
+int
+rte_member_query_count_bulk(const struct rte_member_setsum *setsum,
+			const void **keys, uint32_t num_keys,
+			uint64_t *counts);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Report the heavy hitters of a sketch, by decreasing count.
+ *
+ * @param setsum
+ *   Pointer to the sketch.
+ * @param keys
+ *   Output pointers to the keys of the heavy hitters. They point into the
+ *   sketch and are valid until it is next updated. User should preallocate
+ *   an array of top_k pointers.
+ * @param counts
+ *   Output the estimated counts of the heavy hitters. User should preallocate
+ *   an array of top_k counts.
+ * @return
+ *   The number of heavy hitters, -EINVAL if the set-summary is not a sketch.
+ */
+__rte_experimental
+int
+rte_member_report_heavyhitter(const struct rte_member_setsum *setsum,
+			void **keys, uint64_t *counts);
+
 #ifdef __cplusplus
 }
 #endif
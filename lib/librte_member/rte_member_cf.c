@@ -0,0 +1,436 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include <rte_errno.h>
+#include <rte_malloc.h>
+#include <rte_prefetch.h>
+#include <rte_random.h>
+#include <rte_log.h>
+
+#include "rte_member.h"
+#include "rte_member_cf.h"
+
+#if defined(RTE_ARCH_X86) && defined(RTE_MACHINE_CPUFLAG_AVX2)
+#include <x86intrin.h>
+#endif
+
+/*
+ * The cuckoo filter is an array of 32-byte buckets. Each entry of a bucket
+ * holds the fingerprint of a key in its upper bits and the set id of the key
+ * in its lower bits, 0 is an empty entry. Entries are 16-bit (16 entries per
+ * bucket) when the fingerprint and the set id fit, 32-bit (8 entries per
+ * bucket) otherwise.
+ *
+ * As for the HT non-cache mode, a key can be in its primary bucket or in an
+ * alternative bucket derived from the primary one and the fingerprint, so
+ * that entries can be moved without the key. Unlike HT, the whole entry
+ * width is used for the fingerprint and the set id, and the fingerprint
+ * width is chosen from the user false positive rate.
+ *
+ * A lookup compares the fingerprint with all the entries of a bucket at
+ * once with AVX2 when it is available.
+ */
+
+static inline uint32_t
+cf_entry_bytes(const struct rte_member_setsum *ss)
+{
+	return RTE_MEMBER_CF_BUCKET_SIZE / ss->cf_entries;
+}
+
+static inline void *
+cf_bucket(const struct rte_member_setsum *ss, uint32_t bkt)
+{
+	return (uint8_t *)ss->table + (size_t)bkt * RTE_MEMBER_CF_BUCKET_SIZE;
+}
+
+static inline uint32_t
+cf_get_entry(const struct rte_member_setsum *ss, uint32_t bkt, uint32_t i)
+{
+	if (ss->cf_entries == 16)
+		return ((const uint16_t *)cf_bucket(ss, bkt))[i];
+	return ((const uint32_t *)cf_bucket(ss, bkt))[i];
+}
+
+static inline void
+cf_set_entry(const struct rte_member_setsum *ss, uint32_t bkt, uint32_t i,
+		uint32_t entry)
+{
+	if (ss->cf_entries == 16)
+		((uint16_t *)cf_bucket(ss, bkt))[i] = entry;
+	else
+		((uint32_t *)cf_bucket(ss, bkt))[i] = entry;
+}
+
+static inline void
+get_cf_index(const struct rte_member_setsum *ss, const void *key,
+		uint32_t *prim_bkt, uint32_t *fp)
+{
+	uint32_t first_hash = MEMBER_HASH_FUNC(key, ss->key_len,
+						ss->prim_hash_seed);
+	uint32_t sec_hash = MEMBER_HASH_FUNC(&first_hash, sizeof(uint32_t),
+						ss->sec_hash_seed);
+
+	*prim_bkt = first_hash & ss->bucket_mask;
+	/* Fingerprint 0 is reserved for empty entries */
+	*fp = sec_hash >> (32 - ss->fp_bits);
+	if (*fp == 0)
+		*fp = 1;
+}
+
+/*
+ * The alternative bucket only depends on the current bucket and the
+ * fingerprint, and going twice through it gives the current bucket back.
+ * The fingerprint is scrambled so that keys of a bucket do not all move
+ * to neighbouring buckets.
+ */
+static inline uint32_t
+cf_alt_bucket(const struct rte_member_setsum *ss, uint32_t bkt, uint32_t fp)
+{
+	return (bkt ^ (fp * 0x5bd1e995)) & ss->bucket_mask;
+}
+
+/*
+ * Return a mask of the entries of the bucket matching the fingerprint,
+ * with the lowest bit of the bytes of each matching entry set.
+ */
+static inline uint32_t
+cf_bucket_match(const struct rte_member_setsum *ss, uint32_t bkt,
+		uint32_t fp)
+{
+	uint32_t i, hitmask = 0;
+	uint32_t entry_bytes = cf_entry_bytes(ss);
+
+	switch (ss->sig_cmp_fn) {
+#if defined(RTE_ARCH_X86) && defined(RTE_MACHINE_CPUFLAG_AVX2)
+	case RTE_MEMBER_COMPARE_AVX2: {
+		__m256i v = _mm256_load_si256(
+			(__m256i const *)cf_bucket(ss, bkt));
+		__m128i shift = _mm_cvtsi32_si128(ss->set_bits);
+
+		if (ss->cf_entries == 16)
+			return (uint32_t)_mm256_movemask_epi8(
+				_mm256_cmpeq_epi16(_mm256_srl_epi16(v, shift),
+					_mm256_set1_epi16(fp))) & 0x55555555;
+		return (uint32_t)_mm256_movemask_epi8(
+			_mm256_cmpeq_epi32(_mm256_srl_epi32(v, shift),
+				_mm256_set1_epi32(fp))) & 0x11111111;
+	}
+#endif
+	default:
+		for (i = 0; i < ss->cf_entries; i++) {
+			if ((cf_get_entry(ss, bkt, i) >> ss->set_bits) == fp)
+				hitmask |= 1U << (i * entry_bytes);
+		}
+		return hitmask;
+	}
+}
+
+static inline int
+search_cf_single(const struct rte_member_setsum *ss, uint32_t bkt,
+		uint32_t fp, member_set_t *set_id)
+{
+	uint32_t hitmask = cf_bucket_match(ss, bkt, fp);
+	uint32_t hit_idx;
+
+	if (hitmask == 0)
+		return 0;
+	hit_idx = __builtin_ctz(hitmask) / cf_entry_bytes(ss);
+	*set_id = cf_get_entry(ss, bkt, hit_idx) &
+		((1U << ss->set_bits) - 1);
+	return 1;
+}
+
+static inline void
+search_cf_multi(const struct rte_member_setsum *ss, uint32_t bkt,
+		uint32_t fp, uint32_t *counter, uint32_t match_per_key,
+		member_set_t *set_id)
+{
+	uint32_t hitmask = cf_bucket_match(ss, bkt, fp);
+	uint32_t hit_idx;
+
+	while (hitmask != 0 && *counter < match_per_key) {
+		hit_idx = __builtin_ctz(hitmask) / cf_entry_bytes(ss);
+		set_id[*counter] = cf_get_entry(ss, bkt, hit_idx) &
+			((1U << ss->set_bits) - 1);
+		(*counter)++;
+		hitmask &= hitmask - 1;
+	}
+}
+
+int
+rte_member_create_cf(struct rte_member_setsum *ss,
+		const struct rte_member_parameters *params)
+{
+	uint32_t num_buckets, entries, fp_bits, set_bits;
+	uint64_t min_buckets;
+	double new_fp;
+
+	if (params->num_keys == 0 ||
+			params->num_keys > RTE_MEMBER_ENTRIES_MAX ||
+			params->num_set == 0 ||
+			params->num_set > RTE_MEMBER_CF_MAX_SET ||
+			params->false_positive_rate <= 0 ||
+			params->false_positive_rate > 1) {
+		rte_errno = EINVAL;
+		RTE_MEMBER_LOG(ERR,
+			"Membership CF create with invalid parameters\n");
+		return -EINVAL;
+	}
+
+	set_bits = 32 - __builtin_clz(params->num_set);
+
+	/*
+	 * A lookup compares the fingerprint with the entries of two buckets,
+	 * so the false positive rate is about 2 * entries / 2^fp_bits.
+	 */
+	entries = RTE_MEMBER_CF_BUCKET_SIZE / sizeof(uint16_t);
+	fp_bits = ceil(log2(2.0 * entries / params->false_positive_rate));
+	if (fp_bits + set_bits > 16) {
+		entries = RTE_MEMBER_CF_BUCKET_SIZE / sizeof(uint32_t);
+		fp_bits = ceil(log2(2.0 * entries /
+				params->false_positive_rate));
+		if (fp_bits + set_bits > 32)
+			fp_bits = 32 - set_bits;
+	}
+
+	/* Size the table for 95% load, cuckoo moves work up to about 98% */
+	min_buckets = ((uint64_t)params->num_keys * 100 + entries * 95 - 1) /
+			(entries * 95);
+	num_buckets = rte_align32pow2(min_buckets);
+
+	ss->table = rte_zmalloc_socket(NULL,
+			(size_t)num_buckets * RTE_MEMBER_CF_BUCKET_SIZE,
+			RTE_CACHE_LINE_SIZE, ss->socket_id);
+	if (ss->table == NULL) {
+		RTE_MEMBER_LOG(ERR, "memory allocation failed for CF "
+						"setsummary\n");
+		return -ENOMEM;
+	}
+
+	ss->bucket_cnt = num_buckets;
+	ss->bucket_mask = num_buckets - 1;
+	ss->cf_entries = entries;
+	ss->fp_bits = fp_bits;
+	ss->set_bits = set_bits;
+#if defined(RTE_ARCH_X86)
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2))
+		ss->sig_cmp_fn = RTE_MEMBER_COMPARE_AVX2;
+	else
+#endif
+		ss->sig_cmp_fn = RTE_MEMBER_COMPARE_SCALAR;
+
+	new_fp = 1 - pow(1 - pow(2.0, -(double)fp_bits), 2.0 * entries);
+	RTE_MEMBER_LOG(DEBUG, "Cuckoo filter created, "
+		"the table has %u buckets of %u %u-bit entries, "
+		"%u-bit fingerprints, false positive rate %.5f\n",
+		num_buckets, entries, RTE_MEMBER_CF_BUCKET_SIZE * 8 / entries,
+		fp_bits, new_fp);
+	return 0;
+}
+
+int
+rte_member_lookup_cf(const struct rte_member_setsum *ss,
+		const void *key, member_set_t *set_id)
+{
+	uint32_t prim_bucket, fp;
+
+	get_cf_index(ss, key, &prim_bucket, &fp);
+
+	if (search_cf_single(ss, prim_bucket, fp, set_id) ||
+			search_cf_single(ss, cf_alt_bucket(ss, prim_bucket, fp),
+				fp, set_id))
+		return 1;
+
+	*set_id = RTE_MEMBER_NO_MATCH;
+	return 0;
+}
+
+uint32_t
+rte_member_lookup_bulk_cf(const struct rte_member_setsum *ss,
+		const void **keys, uint32_t num_keys, member_set_t *set_ids)
+{
+	uint32_t i;
+	uint32_t num_matches = 0;
+	uint32_t fps[RTE_MEMBER_LOOKUP_BULK_MAX];
+	uint32_t prim_buckets[RTE_MEMBER_LOOKUP_BULK_MAX];
+	uint32_t sec_buckets[RTE_MEMBER_LOOKUP_BULK_MAX];
+
+	for (i = 0; i < num_keys; i++) {
+		get_cf_index(ss, keys[i], &prim_buckets[i], &fps[i]);
+		sec_buckets[i] = cf_alt_bucket(ss, prim_buckets[i], fps[i]);
+		rte_prefetch0(cf_bucket(ss, prim_buckets[i]));
+		rte_prefetch0(cf_bucket(ss, sec_buckets[i]));
+	}
+
+	for (i = 0; i < num_keys; i++) {
+		if (search_cf_single(ss, prim_buckets[i], fps[i],
+				&set_ids[i]) ||
+				search_cf_single(ss, sec_buckets[i], fps[i],
+					&set_ids[i]))
+			num_matches++;
+		else
+			set_ids[i] = RTE_MEMBER_NO_MATCH;
+	}
+	return num_matches;
+}
+
+uint32_t
+rte_member_lookup_multi_cf(const struct rte_member_setsum *ss,
+		const void *key, uint32_t match_per_key,
+		member_set_t *set_id)
+{
+	uint32_t num_matches = 0;
+	uint32_t prim_bucket, sec_bucket, fp;
+
+	get_cf_index(ss, key, &prim_bucket, &fp);
+	sec_bucket = cf_alt_bucket(ss, prim_bucket, fp);
+
+	search_cf_multi(ss, prim_bucket, fp, &num_matches, match_per_key,
+			set_id);
+	if (sec_bucket != prim_bucket)
+		search_cf_multi(ss, sec_bucket, fp, &num_matches,
+				match_per_key, set_id);
+	return num_matches;
+}
+
+uint32_t
+rte_member_lookup_multi_bulk_cf(const struct rte_member_setsum *ss,
+		const void **keys, uint32_t num_keys, uint32_t match_per_key,
+		uint32_t *match_count,
+		member_set_t *set_ids)
+{
+	uint32_t i;
+	uint32_t num_matches = 0;
+	uint32_t match_cnt_tmp;
+	uint32_t fps[RTE_MEMBER_LOOKUP_BULK_MAX];
+	uint32_t prim_buckets[RTE_MEMBER_LOOKUP_BULK_MAX];
+	uint32_t sec_buckets[RTE_MEMBER_LOOKUP_BULK_MAX];
+
+	for (i = 0; i < num_keys; i++) {
+		get_cf_index(ss, keys[i], &prim_buckets[i], &fps[i]);
+		sec_buckets[i] = cf_alt_bucket(ss, prim_buckets[i], fps[i]);
+		rte_prefetch0(cf_bucket(ss, prim_buckets[i]));
+		rte_prefetch0(cf_bucket(ss, sec_buckets[i]));
+	}
+
+	for (i = 0; i < num_keys; i++) {
+		match_cnt_tmp = 0;
+		search_cf_multi(ss, prim_buckets[i], fps[i], &match_cnt_tmp,
+				match_per_key, &set_ids[i * match_per_key]);
+		if (sec_buckets[i] != prim_buckets[i])
+			search_cf_multi(ss, sec_buckets[i], fps[i],
+					&match_cnt_tmp, match_per_key,
+					&set_ids[i * match_per_key]);
+		match_count[i] = match_cnt_tmp;
+		if (match_cnt_tmp != 0)
+			num_matches++;
+	}
+	return num_matches;
+}
+
+static inline int
+cf_try_insert(const struct rte_member_setsum *ss, uint32_t bkt,
+		uint32_t entry)
+{
+	uint32_t i;
+
+	for (i = 0; i < ss->cf_entries; i++) {
+		if (cf_get_entry(ss, bkt, i) == 0) {
+			cf_set_entry(ss, bkt, i, entry);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+int
+rte_member_add_cf(const struct rte_member_setsum *ss,
+		const void *key, member_set_t set_id)
+{
+	uint32_t bkt_path[RTE_MEMBER_CF_MAX_KICKS];
+	uint8_t slot_path[RTE_MEMBER_CF_MAX_KICKS];
+	uint32_t prim_bucket, sec_bucket, fp;
+	uint32_t entry, victim, bkt, slot;
+	int i;
+
+	if (set_id == RTE_MEMBER_NO_MATCH || set_id > ss->num_set)
+		return -EINVAL;
+
+	get_cf_index(ss, key, &prim_bucket, &fp);
+	sec_bucket = cf_alt_bucket(ss, prim_bucket, fp);
+	entry = (fp << ss->set_bits) | set_id;
+
+	if (cf_try_insert(ss, prim_bucket, entry) ||
+			cf_try_insert(ss, sec_bucket, entry))
+		return 0;
+
+	/*
+	 * Both buckets are full: put the entry in place of a random one and
+	 * move that one to its alternative bucket, until a bucket with room
+	 * is found. The moves are recorded so that they can be undone if the
+	 * table is too full, no entry is lost then.
+	 */
+	bkt = (rte_rand() & 1) ? prim_bucket : sec_bucket;
+	for (i = 0; i < RTE_MEMBER_CF_MAX_KICKS; i++) {
+		slot = rte_rand() & (ss->cf_entries - 1);
+		victim = cf_get_entry(ss, bkt, slot);
+		cf_set_entry(ss, bkt, slot, entry);
+		bkt_path[i] = bkt;
+		slot_path[i] = slot;
+
+		entry = victim;
+		bkt = cf_alt_bucket(ss, bkt, entry >> ss->set_bits);
+		if (cf_try_insert(ss, bkt, entry))
+			return 1;
+	}
+
+	while (--i >= 0) {
+		victim = cf_get_entry(ss, bkt_path[i], slot_path[i]);
+		cf_set_entry(ss, bkt_path[i], slot_path[i], entry);
+		entry = victim;
+	}
+	return -ENOSPC;
+}
+
+void
+rte_member_free_cf(struct rte_member_setsum *ss)
+{
+	rte_free(ss->table);
+}
+
+int
+rte_member_delete_cf(const struct rte_member_setsum *ss, const void *key,
+		member_set_t set_id)
+{
+	uint32_t prim_bucket, fp, entry, bkt;
+	uint32_t hitmask, hit_idx;
+	int i;
+
+	get_cf_index(ss, key, &prim_bucket, &fp);
+	entry = (fp << ss->set_bits) | set_id;
+
+	for (i = 0, bkt = prim_bucket; i < 2;
+			i++, bkt = cf_alt_bucket(ss, prim_bucket, fp)) {
+		hitmask = cf_bucket_match(ss, bkt, fp);
+		while (hitmask != 0) {
+			hit_idx = __builtin_ctz(hitmask) / cf_entry_bytes(ss);
+			if (cf_get_entry(ss, bkt, hit_idx) == entry) {
+				cf_set_entry(ss, bkt, hit_idx, 0);
+				return 0;
+			}
+			hitmask &= hitmask - 1;
+		}
+	}
+	return -ENOENT;
+}
+
+void
+rte_member_reset_cf(const struct rte_member_setsum *ss)
+{
+	memset(ss->table, 0, (size_t)ss->bucket_cnt *
+			RTE_MEMBER_CF_BUCKET_SIZE);
+}
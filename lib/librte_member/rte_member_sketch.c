@@ -0,0 +1,332 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include <rte_errno.h>
+#include <rte_malloc.h>
+#include <rte_prefetch.h>
+#include <rte_log.h>
+
+#include "rte_member.h"
+#include "rte_member_sketch.h"
+
+/*
+ * Count-min sketch: num_row rows of num_col counters. A key is counted in
+ * one counter of each row, its count is estimated by the smallest of them,
+ * which can only be too high because of other keys counted in the same
+ * counters.
+ *
+ * The top_k keys with the largest estimated counts (heavy hitters) are kept
+ * with their keys in a small table. It is only searched when the count of
+ * a key reaches the smallest count of the table, so the keys of the many
+ * small flows are not compared.
+ */
+struct member_sketch {
+	uint32_t num_hh;	/* Number of tracked heavy hitters. */
+	uint32_t min_idx;	/* Heavy hitter with the smallest count. */
+	uint32_t *hh_sig;	/* Hash of the key of each heavy hitter. */
+	uint64_t *hh_count;	/* Estimated count of each heavy hitter. */
+	uint8_t *hh_keys;	/* Key of each heavy hitter. */
+	uint64_t *counters;	/* Rows of counters. */
+};
+
+static inline void
+get_sketch_hash(const struct rte_member_setsum *ss, const void *key,
+		uint32_t *hash, uint32_t *step)
+{
+	*hash = MEMBER_HASH_FUNC(key, ss->key_len, ss->prim_hash_seed);
+	/* An odd step gives a different counter in each row */
+	*step = MEMBER_HASH_FUNC(hash, sizeof(uint32_t),
+				ss->sec_hash_seed) | 1;
+}
+
+static inline uint64_t *
+sketch_counter(const struct rte_member_setsum *ss, uint32_t row,
+		uint32_t hash, uint32_t step)
+{
+	const struct member_sketch *sk = ss->table;
+
+	return &sk->counters[(size_t)row * ss->num_col +
+			((hash + row * step) & ss->col_mask)];
+}
+
+static inline uint64_t
+sketch_estimate(const struct rte_member_setsum *ss, uint32_t hash,
+		uint32_t step)
+{
+	uint64_t count = UINT64_MAX;
+	uint32_t row;
+
+	for (row = 0; row < ss->num_row; row++)
+		count = RTE_MIN(count, *sketch_counter(ss, row, hash, step));
+	return count;
+}
+
+static inline uint32_t
+sketch_find_heavyhitter(const struct rte_member_setsum *ss,
+		const void *key, uint32_t hash)
+{
+	const struct member_sketch *sk = ss->table;
+	uint32_t i;
+
+	for (i = 0; i < sk->num_hh; i++) {
+		if (sk->hh_sig[i] == hash &&
+				memcmp(&sk->hh_keys[(size_t)i * ss->key_len],
+					key, ss->key_len) == 0)
+			break;
+	}
+	return i;
+}
+
+static void
+sketch_update_heavyhitter(const struct rte_member_setsum *ss,
+		const void *key, uint32_t hash, uint64_t count)
+{
+	struct member_sketch *sk = ss->table;
+	uint32_t i;
+
+	/*
+	 * The count of a tracked key was at least the smallest one when it
+	 * was last updated, and it has just increased, so a key whose count
+	 * is not above the smallest one is not tracked.
+	 */
+	if (sk->num_hh == ss->top_k && count <= sk->hh_count[sk->min_idx])
+		return;
+
+	i = sketch_find_heavyhitter(ss, key, hash);
+	if (i == sk->num_hh) {
+		/* Replace the smallest heavy hitter when the table is full */
+		if (sk->num_hh < ss->top_k)
+			sk->num_hh++;
+		else
+			i = sk->min_idx;
+		sk->hh_sig[i] = hash;
+		memcpy(&sk->hh_keys[(size_t)i * ss->key_len], key,
+			ss->key_len);
+	}
+	sk->hh_count[i] = count;
+
+	if (i == sk->min_idx) {
+		for (i = 0; i < sk->num_hh; i++) {
+			if (sk->hh_count[i] < sk->hh_count[sk->min_idx])
+				sk->min_idx = i;
+		}
+	} else if (count < sk->hh_count[sk->min_idx])
+		sk->min_idx = i;
+}
+
+int
+rte_member_create_sketch(struct rte_member_setsum *ss,
+		const struct rte_member_parameters *params)
+{
+	struct member_sketch *sk;
+	uint32_t num_row, num_col;
+	size_t counters_sz, hh_sz;
+
+	if (params->error_rate <= 0 || params->error_rate >= 1 ||
+			params->false_positive_rate <= 0 ||
+			params->false_positive_rate >= 1 ||
+			params->top_k > RTE_MEMBER_SKETCH_TOPK_MAX) {
+		rte_errno = EINVAL;
+		RTE_MEMBER_LOG(ERR,
+			"Membership sketch create with invalid parameters\n");
+		return -EINVAL;
+	}
+
+	/*
+	 * With w = e / error_rate counters per row and
+	 * d = ln(1 / false_positive_rate) rows, the count of a key is
+	 * over-estimated by more than error_rate times the total count with
+	 * probability at most false_positive_rate.
+	 */
+	if (ceil(M_E / params->error_rate) > RTE_MEMBER_SKETCH_MAX_COL) {
+		rte_errno = EINVAL;
+		RTE_MEMBER_LOG(ERR, "Membership sketch error rate is too small\n");
+		return -EINVAL;
+	}
+	num_col = rte_align32pow2(ceil(M_E / params->error_rate));
+	num_row = ceil(log(1.0 / params->false_positive_rate));
+	num_row = RTE_MAX(num_row, 1U);
+	num_row = RTE_MIN(num_row, (uint32_t)RTE_MEMBER_SKETCH_MAX_ROW);
+
+	counters_sz = (size_t)num_row * num_col * sizeof(uint64_t);
+	hh_sz = (size_t)params->top_k * (sizeof(uint64_t) + sizeof(uint32_t) +
+			params->key_len);
+	sk = rte_zmalloc_socket(NULL, RTE_CACHE_LINE_ROUNDUP(sizeof(*sk)) +
+			counters_sz + hh_sz, RTE_CACHE_LINE_SIZE,
+			ss->socket_id);
+	if (sk == NULL) {
+		RTE_MEMBER_LOG(ERR, "memory allocation failed for sketch "
+						"setsummary\n");
+		return -ENOMEM;
+	}
+	sk->counters = (uint64_t *)((uint8_t *)sk +
+			RTE_CACHE_LINE_ROUNDUP(sizeof(*sk)));
+	sk->hh_count = (uint64_t *)((uint8_t *)sk->counters + counters_sz);
+	sk->hh_sig = (uint32_t *)(sk->hh_count + params->top_k);
+	sk->hh_keys = (uint8_t *)(sk->hh_sig + params->top_k);
+
+	ss->table = sk;
+	ss->num_row = num_row;
+	ss->num_col = num_col;
+	ss->col_mask = num_col - 1;
+	ss->top_k = params->top_k;
+
+	RTE_MEMBER_LOG(DEBUG, "Count-min sketch created, "
+		"%u rows of %u counters, tracking %u heavy hitters\n",
+		num_row, num_col, ss->top_k);
+	return 0;
+}
+
+int
+rte_member_lookup_sketch(const struct rte_member_setsum *ss,
+		const void *key, member_set_t *set_id)
+{
+	const struct member_sketch *sk = ss->table;
+	uint32_t hash = MEMBER_HASH_FUNC(key, ss->key_len, ss->prim_hash_seed);
+
+	if (sketch_find_heavyhitter(ss, key, hash) != sk->num_hh) {
+		*set_id = 1;
+		return 1;
+	}
+	*set_id = RTE_MEMBER_NO_MATCH;
+	return 0;
+}
+
+uint32_t
+rte_member_lookup_bulk_sketch(const struct rte_member_setsum *ss,
+		const void **keys, uint32_t num_keys, member_set_t *set_ids)
+{
+	uint32_t i;
+	uint32_t num_matches = 0;
+
+	for (i = 0; i < num_keys; i++)
+		num_matches += rte_member_lookup_sketch(ss, keys[i],
+					&set_ids[i]);
+	return num_matches;
+}
+
+uint32_t
+rte_member_lookup_multi_sketch(const struct rte_member_setsum *ss,
+		const void *key, uint32_t match_per_key,
+		member_set_t *set_id)
+{
+	if (match_per_key == 0)
+		return 0;
+	return rte_member_lookup_sketch(ss, key, set_id);
+}
+
+uint32_t
+rte_member_lookup_multi_bulk_sketch(const struct rte_member_setsum *ss,
+		const void **keys, uint32_t num_keys, uint32_t match_per_key,
+		uint32_t *match_count,
+		member_set_t *set_ids)
+{
+	uint32_t i;
+	uint32_t num_matches = 0;
+
+	for (i = 0; i < num_keys; i++) {
+		match_count[i] = rte_member_lookup_multi_sketch(ss, keys[i],
+				match_per_key, &set_ids[i * match_per_key]);
+		if (match_count[i] != 0)
+			num_matches++;
+	}
+	return num_matches;
+}
+
+int
+rte_member_add_sketch(const struct rte_member_setsum *ss,
+		const void *key, uint32_t count)
+{
+	uint32_t hash, step, row;
+	uint64_t *counter, estimate = UINT64_MAX;
+
+	get_sketch_hash(ss, key, &hash, &step);
+	for (row = 0; row < ss->num_row; row++) {
+		counter = sketch_counter(ss, row, hash, step);
+		*counter += count;
+		estimate = RTE_MIN(estimate, *counter);
+	}
+
+	if (ss->top_k != 0)
+		sketch_update_heavyhitter(ss, key, hash, estimate);
+	return 0;
+}
+
+int
+rte_member_query_sketch(const struct rte_member_setsum *ss,
+		const void *key, uint64_t *count)
+{
+	uint32_t hash, step;
+
+	get_sketch_hash(ss, key, &hash, &step);
+	*count = sketch_estimate(ss, hash, step);
+	return 0;
+}
+
+void
+rte_member_query_bulk_sketch(const struct rte_member_setsum *ss,
+		const void **keys, uint32_t num_keys, uint64_t *counts)
+{
+	uint32_t hashes[RTE_MEMBER_LOOKUP_BULK_MAX];
+	uint32_t steps[RTE_MEMBER_LOOKUP_BULK_MAX];
+	uint32_t i, n, row;
+
+	for (; num_keys != 0; num_keys -= n, keys += n, counts += n) {
+		n = RTE_MIN(num_keys, (uint32_t)RTE_MEMBER_LOOKUP_BULK_MAX);
+		for (i = 0; i < n; i++) {
+			get_sketch_hash(ss, keys[i], &hashes[i], &steps[i]);
+			for (row = 0; row < ss->num_row; row++)
+				rte_prefetch0(sketch_counter(ss, row,
+						hashes[i], steps[i]));
+		}
+		for (i = 0; i < n; i++)
+			counts[i] = sketch_estimate(ss, hashes[i], steps[i]);
+	}
+}
+
+int
+rte_member_report_heavyhitter_sketch(const struct rte_member_setsum *ss,
+		void **keys, uint64_t *counts)
+{
+	const struct member_sketch *sk = ss->table;
+	uint32_t i, j, hash, step;
+	uint64_t count;
+	void *key;
+
+	/* The counts are estimated again, they may have grown since saved */
+	for (i = 0; i < sk->num_hh; i++) {
+		key = &sk->hh_keys[(size_t)i * ss->key_len];
+		get_sketch_hash(ss, key, &hash, &step);
+		count = sketch_estimate(ss, hash, step);
+
+		/* Insertion sort by decreasing count */
+		for (j = i; j > 0 && counts[j - 1] < count; j--) {
+			counts[j] = counts[j - 1];
+			keys[j] = keys[j - 1];
+		}
+		counts[j] = count;
+		keys[j] = key;
+	}
+	return sk->num_hh;
+}
+
+void
+rte_member_free_sketch(struct rte_member_setsum *ss)
+{
+	rte_free(ss->table);
+}
+
+void
+rte_member_reset_sketch(const struct rte_member_setsum *ss)
+{
+	struct member_sketch *sk = ss->table;
+
+	memset(sk->counters, 0, (size_t)ss->num_row * ss->num_col *
+			sizeof(uint64_t));
+	sk->num_hh = 0;
+	sk->min_idx = 0;
+}
@@ -0,0 +1,68 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#ifndef _RTE_MEMBER_SKETCH_H_
+#define _RTE_MEMBER_SKETCH_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Maximum number of counter rows of a sketch. */
+#define RTE_MEMBER_SKETCH_MAX_ROW 16
+
+/* Maximum number of counters per row of a sketch. */
+#define RTE_MEMBER_SKETCH_MAX_COL (1 << 26)
+
+int
+rte_member_create_sketch(struct rte_member_setsum *ss,
+		const struct rte_member_parameters *params);
+
+int
+rte_member_lookup_sketch(const struct rte_member_setsum *setsum,
+		const void *key, member_set_t *set_id);
+
+uint32_t
+rte_member_lookup_bulk_sketch(const struct rte_member_setsum *setsum,
+		const void **keys, uint32_t num_keys,
+		member_set_t *set_ids);
+
+uint32_t
+rte_member_lookup_multi_sketch(const struct rte_member_setsum *setsum,
+		const void *key, uint32_t match_per_key,
+		member_set_t *set_id);
+
+uint32_t
+rte_member_lookup_multi_bulk_sketch(const struct rte_member_setsum *setsum,
+		const void **keys, uint32_t num_keys, uint32_t match_per_key,
+		uint32_t *match_count,
+		member_set_t *set_ids);
+
+int
+rte_member_add_sketch(const struct rte_member_setsum *setsum,
+		const void *key, uint32_t count);
+
+int
+rte_member_query_sketch(const struct rte_member_setsum *setsum,
+		const void *key, uint64_t *count);
+
+void
+rte_member_query_bulk_sketch(const struct rte_member_setsum *setsum,
+		const void **keys, uint32_t num_keys, uint64_t *counts);
+
+int
+rte_member_report_heavyhitter_sketch(const struct rte_member_setsum *setsum,
+		void **keys, uint64_t *counts);
+
+void
+rte_member_free_sketch(struct rte_member_setsum *setsum);
+
+void
+rte_member_reset_sketch(const struct rte_member_setsum *setsum);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_MEMBER_SKETCH_H_ */
@@ -784,6 +784,58 @@ rte_mempool_cache_free(struct rte_mempool_cache *cache)
 	rte_free(cache);
 }
 
+int
+rte_mempool_cache_stats_get(const struct rte_mempool *mp,
+		unsigned int lcore_id, struct rte_mempool_cache_stats *stats)
+{
+	const struct rte_mempool_cache_counters *counters;
+	const struct rte_mempool_cache *cache;
+
+	if (mp == NULL || stats == NULL || lcore_id >= RTE_MAX_LCORE ||
+			mp->cache_size == 0)
+		return -EINVAL;
+
+	cache = &mp->local_cache[lcore_id];
+	counters = &__mempool_cache_stats_table(mp)->lcore[lcore_id];
+	stats->get_hits = counters->get_hits;
+	stats->get_misses = counters->get_misses;
+	stats->put_hits = counters->put_hits;
+	stats->put_misses = counters->put_misses;
+	stats->size = cache->size;
+	stats->len = cache->len;
+
+	return 0;
+}
+
+void
+rte_mempool_cache_stats_reset(struct rte_mempool *mp)
+{
+	struct rte_mempool_cache_stats_table *table;
+
+	if (mp == NULL || mp->cache_size == 0)
+		return;
+
+	table = __mempool_cache_stats_table(mp);
+	memset(table->lcore, 0, sizeof(table->lcore));
+}
+
+int
+rte_mempool_cache_adaptive_enable(struct rte_mempool *mp, size_t max_mem)
+{
+	struct rte_mempool_cache_stats_table *table;
+	size_t obj_size;
+
+	if (mp == NULL || mp->cache_size == 0)
+		return -EINVAL;
+
+	table = __mempool_cache_stats_table(mp);
+	obj_size = mp->header_size + mp->elt_size + mp->trailer_size;
+	table->adapt_avail = RTE_MIN(max_mem / obj_size, (size_t)mp->size);
+	table->adaptive = 1;
+
+	return 0;
+}
+
 /* create an empty mempool */
 struct rte_mempool *
 rte_mempool_create_empty(const char *name, unsigned n, unsigned elt_size,
@@ -857,6 +909,9 @@ rte_mempool_create_empty(const char *name, unsigned n, unsigned elt_size,
 
 	mempool_size = MEMPOOL_HEADER_SIZE(mp, cache_size);
 	mempool_size += private_data_size;
+	/* the statistics of the default caches follow the private data */
+	if (cache_size != 0)
+		mempool_size += sizeof(struct rte_mempool_cache_stats_table);
 	mempool_size = RTE_ALIGN_CEIL(mempool_size, RTE_MEMPOOL_ALIGN);
 
 	ret = snprintf(mz_name, sizeof(mz_name), RTE_MEMPOOL_MZ_FORMAT, name);
@@ -902,6 +957,8 @@ rte_mempool_create_empty(const char *name, unsigned n, unsigned elt_size,
 		for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
 			mempool_cache_init(&mp->local_cache[lcore_id],
 					   cache_size);
+		memset(__mempool_cache_stats_table(mp), 0,
+			sizeof(struct rte_mempool_cache_stats_table));
 	}
 
 	te->data = mp;
@@ -1005,6 +1062,8 @@ rte_mempool_in_use_count(const struct rte_mempool *mp)
 static unsigned
 rte_mempool_dump_cache(FILE *f, const struct rte_mempool *mp)
 {
+	const struct rte_mempool_cache_counters *counters;
+	const struct rte_mempool_cache *cache;
 	unsigned lcore_id;
 	unsigned count = 0;
 	unsigned cache_count;
@@ -1016,10 +1075,21 @@ rte_mempool_dump_cache(FILE *f, const struct rte_mempool *mp)
 		return count;
 
 	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
-		cache_count = mp->local_cache[lcore_id].len;
+		cache = &mp->local_cache[lcore_id];
+		cache_count = cache->len;
 		fprintf(f, "    cache_count[%u]=%"PRIu32"\n",
 			lcore_id, cache_count);
 		count += cache_count;
+		counters = &__mempool_cache_stats_table(mp)->lcore[lcore_id];
+		if (counters->get_hits + counters->get_misses +
+				counters->put_hits + counters->put_misses == 0)
+			continue;
+		fprintf(f, "    cache_stats[%u]: size=%"PRIu32
+			" get_hits=%"PRIu64" get_misses=%"PRIu64
+			" put_hits=%"PRIu64" put_misses=%"PRIu64"\n",
+			lcore_id, cache->size, counters->get_hits,
+			counters->get_misses, counters->put_hits,
+			counters->put_misses);
 	}
 	fprintf(f, "    total_cache_count=%u\n", count);
 	return count;
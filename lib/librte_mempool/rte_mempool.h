@@ -91,6 +91,52 @@ struct rte_mempool_cache {
 	void *objs[RTE_MEMPOOL_CACHE_MAX_SIZE * 3]; /**< Cache objects */
 } __rte_cache_aligned;
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Statistics of a mempool cache, see rte_mempool_cache_stats_get().
+ */
+struct rte_mempool_cache_stats {
+	uint64_t get_hits;   /**< Gets served from the cache */
+	uint64_t get_misses; /**< Gets which dequeued from the mempool ops */
+	uint64_t put_hits;   /**< Puts kept in the cache */
+	uint64_t put_misses; /**< Puts which enqueued to the mempool ops */
+	uint32_t size;       /**< Current size of the cache */
+	uint32_t len;        /**< Current number of objects in the cache */
+};
+
+/**
+ * @internal Counters of the default cache of an lcore. A get or put call
+ * is a hit when it is served by the cache alone, a miss when it goes to
+ * the mempool ops.
+ */
+struct rte_mempool_cache_counters {
+	uint64_t get_hits;     /**< Gets served from the cache */
+	uint64_t get_misses;   /**< Gets which dequeued from the mempool ops */
+	uint64_t put_hits;     /**< Puts kept in the cache */
+	uint64_t put_misses;   /**< Puts which enqueued to the mempool ops */
+	/* Adaptive cache size, counters at the last size check */
+	uint64_t adapt_calls;  /**< Get and put calls */
+	uint64_t adapt_misses; /**< Get and put misses */
+} __rte_cache_aligned;
+
+/**
+ * @internal Statistics and adaptive size of the default caches, stored in
+ * the mempool memzone after the private data, so that the cache and
+ * mempool structures are unchanged.
+ */
+struct rte_mempool_cache_stats_table {
+	/**
+	 * Number of objects the adaptive caches of the mempool may still grow
+	 * by, above their default size.
+	 */
+	uint32_t adapt_avail;
+	uint32_t adaptive; /**< Non-zero if the size of the caches adapts */
+	/** Counters of the default cache of each lcore */
+	struct rte_mempool_cache_counters lcore[RTE_MAX_LCORE];
+} __rte_cache_aligned;
+
 /**
  * A structure that stores the size of mempool elements.
  */
@@ -269,6 +315,18 @@ struct rte_mempool {
 #define MEMPOOL_F_NO_IOVA_CONTIG 0x0020 /**< Don't need IOVA contiguous objs. */
 #define MEMPOOL_F_NO_PHYS_CONTIG MEMPOOL_F_NO_IOVA_CONTIG /* deprecated */
 
+/**
+ * Number of get and put calls on a cache between two checks of the miss
+ * rate by the adaptive mode.
+ */
+#define RTE_MEMPOOL_CACHE_ADAPT_PERIOD 1024
+/** An adaptive cache grows when more than 1 call in this value misses. */
+#define RTE_MEMPOOL_CACHE_ADAPT_GROW_RATIO 16
+/** An adaptive cache shrinks when less than 1 call in this value misses. */
+#define RTE_MEMPOOL_CACHE_ADAPT_SHRINK_RATIO 256
+/** An adaptive cache does not shrink below this size, or its default one. */
+#define RTE_MEMPOOL_CACHE_ADAPT_MIN_SIZE 32
+
 /**
  * @internal When debug is enabled, store some statistics.
  *
@@ -311,6 +369,55 @@ struct rte_mempool {
 	(sizeof(*(mp)) + (((cs) == 0) ? 0 : \
 	(sizeof(struct rte_mempool_cache) * RTE_MAX_LCORE)))
 
+/**
+ * @internal Return the cache statistics table of a mempool, which only
+ * exists if the mempool has default caches.
+ *
+ * @param mp
+ *   Pointer to the memory pool.
+ */
+static inline struct rte_mempool_cache_stats_table *
+__mempool_cache_stats_table(const struct rte_mempool *mp)
+{
+	return (struct rte_mempool_cache_stats_table *)RTE_PTR_ADD(mp,
+		MEMPOOL_HEADER_SIZE(mp, mp->cache_size) +
+		mp->private_data_size);
+}
+
+/**
+ * @internal Return the counters of a cache, NULL if it is not a default
+ * cache of the mempool.
+ *
+ * @param mp
+ *   Pointer to the memory pool.
+ * @param cache
+ *   Pointer to the mempool cache.
+ */
+static __rte_always_inline struct rte_mempool_cache_counters *
+__mempool_cache_counters(const struct rte_mempool *mp,
+		const struct rte_mempool_cache *cache)
+{
+	uintptr_t offset = (uintptr_t)cache - (uintptr_t)mp->local_cache;
+
+	if (offset >= sizeof(*cache) * RTE_MAX_LCORE)
+		return NULL;
+	return &__mempool_cache_stats_table(mp)->lcore[offset /
+		sizeof(*cache)];
+}
+
+/**
+ * @internal Count the hits and misses of a default cache.
+ *
+ * @param counters
+ *   Pointer to the counters of the cache, may be NULL.
+ * @param name
+ *   Name of the counter to increment.
+ */
+#define __MEMPOOL_CACHE_STAT_INC(counters, name) do {           \
+		if ((counters) != NULL)                         \
+			(counters)->name++;                     \
+	} while (0)
+
 /* return the header of a mempool object (internal) */
 static inline struct rte_mempool_objhdr *__mempool_get_header(void *obj)
 {
@@ -1287,6 +1394,157 @@ rte_mempool_cache_flush(struct rte_mempool_cache *cache,
 	cache->len = 0;
 }
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the statistics of the default cache of an lcore.
+ *
+ * The counters are updated by the lcore without synchronization, so they may be
+ * slightly behind when read from another lcore.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param lcore_id
+ *   The logical core id.
+ * @param stats
+ *   A pointer to the structure filled with the statistics.
+ * @return
+ *   - 0: Success.
+ *   - -EINVAL: Invalid parameter, or the mempool has no cache.
+ */
+__rte_experimental
+int
+rte_mempool_cache_stats_get(const struct rte_mempool *mp,
+		unsigned int lcore_id, struct rte_mempool_cache_stats *stats);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Reset the statistics of the default caches of all lcores.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ */
+__rte_experimental
+void
+rte_mempool_cache_stats_reset(struct rte_mempool *mp);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Let the size of the caches of a mempool adapt to their use.
+ *
+ * Every RTE_MEMPOOL_CACHE_ADAPT_PERIOD get and put calls, on its next miss,
+ * a cache doubles its size, up to RTE_MEMPOOL_CACHE_MAX_SIZE, if more than
+ * 1 in RTE_MEMPOOL_CACHE_ADAPT_GROW_RATIO calls missed, or halves it, down
+ * to RTE_MEMPOOL_CACHE_ADAPT_MIN_SIZE, if less than 1 in
+ * RTE_MEMPOOL_CACHE_ADAPT_SHRINK_RATIO calls missed. The checks are only
+ * done on misses, which already go to the mempool ops, so the hits are not
+ * slowed down.
+ *
+ * The objects held by the caches above their default size are bounded by
+ * a memory cap, so that they do not starve the mempool. Only the default
+ * caches of the lcores adapt, and the miss rate comes from the cache
+ * statistics.
+ *
+ * This function must be called before the mempool is used by the lcores.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param max_mem
+ *   The maximum memory, in bytes, of the objects the caches of all lcores
+ *   may hold above their default size.
+ * @return
+ *   - 0: Success.
+ *   - -EINVAL: Invalid parameter, or the mempool has no cache.
+ */
+__rte_experimental
+int
+rte_mempool_cache_adaptive_enable(struct rte_mempool *mp, size_t max_mem);
+
+/**
+ * @internal Grow or shrink an adaptive cache depending on its miss rate;
+ * used internally on cache misses.
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param cache
+ *   A pointer to a mempool cache structure.
+ * @param counters
+ *   A pointer to the counters of the cache, NULL if it is not a default
+ *   cache.
+ */
+static inline void
+__mempool_cache_adapt(struct rte_mempool *mp, struct rte_mempool_cache *cache,
+		struct rte_mempool_cache_counters *counters)
+{
+	struct rte_mempool_cache_stats_table *table;
+	uint64_t calls, misses;
+	uint32_t size, new_size, charge, avail;
+
+	if (counters == NULL)
+		return;
+	table = __mempool_cache_stats_table(mp);
+	if (!table->adaptive)
+		return;
+
+	calls = counters->get_hits + counters->get_misses +
+		counters->put_hits + counters->put_misses -
+		counters->adapt_calls;
+	if (calls < RTE_MEMPOOL_CACHE_ADAPT_PERIOD)
+		return;
+	misses = counters->get_misses + counters->put_misses -
+		counters->adapt_misses;
+	counters->adapt_calls += calls;
+	counters->adapt_misses += misses;
+
+	size = cache->size;
+	if (misses * RTE_MEMPOOL_CACHE_ADAPT_GROW_RATIO > calls) {
+		new_size = RTE_MIN(2 * size,
+				(uint32_t)RTE_MEMPOOL_CACHE_MAX_SIZE);
+		/* Only the objects above the default size are accounted */
+		charge = RTE_MAX(new_size, mp->cache_size) -
+			RTE_MAX(size, mp->cache_size);
+		avail = __atomic_load_n(&table->adapt_avail, __ATOMIC_RELAXED);
+		do {
+			if (charge > avail) {
+				new_size -= charge - avail;
+				charge = avail;
+			}
+			if (charge == 0)
+				break;
+		} while (!__atomic_compare_exchange_n(&table->adapt_avail,
+				&avail, avail - charge, 1, __ATOMIC_RELAXED,
+				__ATOMIC_RELAXED));
+	} else if (misses * RTE_MEMPOOL_CACHE_ADAPT_SHRINK_RATIO < calls) {
+		new_size = RTE_MAX(size / 2, RTE_MIN(mp->cache_size,
+				(uint32_t)RTE_MEMPOOL_CACHE_ADAPT_MIN_SIZE));
+		/* bounded as the cache size, for the spill below */
+		new_size = RTE_MIN(new_size,
+				(uint32_t)RTE_MEMPOOL_CACHE_MAX_SIZE);
+		if (new_size >= size)
+			return;
+		if (cache->len > new_size) {
+			rte_mempool_ops_enqueue_bulk(mp,
+					&cache->objs[new_size],
+					cache->len - new_size);
+			cache->len = new_size;
+		}
+		charge = RTE_MAX(size, mp->cache_size) -
+			RTE_MAX(new_size, mp->cache_size);
+		if (charge != 0)
+			__atomic_fetch_add(&table->adapt_avail, charge,
+					__ATOMIC_RELAXED);
+	} else {
+		return;
+	}
+
+	cache->size = new_size;
+	cache->flushthresh = new_size + new_size / 2;
+}
+
 /**
  * @internal Put several objects back in the mempool; used internally.
  * @param mp
@@ -1303,15 +1561,24 @@ static __rte_always_inline void
 __mempool_generic_put(struct rte_mempool *mp, void * const *obj_table,
 		      unsigned int n, struct rte_mempool_cache *cache)
 {
+	struct rte_mempool_cache_counters *counters;
 	void **cache_objs;
 
 	/* increment stat now, adding in mempool always success */
 	__MEMPOOL_STAT_ADD(mp, put, n);
 
-	/* No cache provided or if put would overflow mem allocated for cache */
-	if (unlikely(cache == NULL || n > RTE_MEMPOOL_CACHE_MAX_SIZE))
+	/* No cache provided */
+	if (unlikely(cache == NULL))
 		goto ring_enqueue;
 
+	counters = __mempool_cache_counters(mp, cache);
+
+	/* Put would overflow mem allocated for cache */
+	if (unlikely(n > RTE_MEMPOOL_CACHE_MAX_SIZE)) {
+		__MEMPOOL_CACHE_STAT_INC(counters, put_misses);
+		goto ring_enqueue;
+	}
+
 	cache_objs = &cache->objs[cache->len];
 
 	/*
@@ -1330,6 +1597,10 @@ __mempool_generic_put(struct rte_mempool *mp, void * const *obj_table,
 		rte_mempool_ops_enqueue_bulk(mp, &cache->objs[cache->size],
 				cache->len - cache->size);
 		cache->len = cache->size;
+		__MEMPOOL_CACHE_STAT_INC(counters, put_misses);
+		__mempool_cache_adapt(mp, cache, counters);
+	} else {
+		__MEMPOOL_CACHE_STAT_INC(counters, put_hits);
 	}
 
 	return;
@@ -1425,20 +1696,32 @@ static __rte_always_inline int
 __mempool_generic_get(struct rte_mempool *mp, void **obj_table,
 		      unsigned int n, struct rte_mempool_cache *cache)
 {
+	struct rte_mempool_cache_counters *counters;
 	int ret;
 	uint32_t index, len;
 	void **cache_objs;
 
-	/* No cache provided or cannot be satisfied from cache */
-	if (unlikely(cache == NULL || n >= cache->size))
+	/* No cache provided */
+	if (unlikely(cache == NULL))
 		goto ring_dequeue;
 
+	counters = __mempool_cache_counters(mp, cache);
+
+	/* Cannot be satisfied from cache */
+	if (unlikely(n >= cache->size))
+		goto cache_miss;
+
 	cache_objs = cache->objs;
 
 	/* Can this be satisfied from the cache? */
 	if (cache->len < n) {
+		uint32_t req;
+
+		__MEMPOOL_CACHE_STAT_INC(counters, get_misses);
+		__mempool_cache_adapt(mp, cache, counters);
+
 		/* No. Backfill the cache first, and then fill from it */
-		uint32_t req = n + (cache->size - cache->len);
+		req = n + (cache->size - cache->len);
 
 		/* How many do we require i.e. number to fill the cache + the request */
 		ret = rte_mempool_ops_dequeue_bulk(mp,
@@ -1454,6 +1737,8 @@ __mempool_generic_get(struct rte_mempool *mp, void **obj_table,
 		}
 
 		cache->len += req;
+	} else {
+		__MEMPOOL_CACHE_STAT_INC(counters, get_hits);
 	}
 
 	/* Now fill in the response ... */
@@ -1466,6 +1751,10 @@ __mempool_generic_get(struct rte_mempool *mp, void **obj_table,
 
 	return 0;
 
+cache_miss:
+	__MEMPOOL_CACHE_STAT_INC(counters, get_misses);
+	__mempool_cache_adapt(mp, cache, counters);
+
 ring_dequeue:
 
 	/* get remaining objects from ring */
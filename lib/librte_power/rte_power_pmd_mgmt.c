@@ -0,0 +1,288 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include <rte_lcore.h>
+#include <rte_cycles.h>
+#include <rte_cpuflags.h>
+#include <rte_malloc.h>
+#include <rte_ethdev.h>
+#include <rte_pause.h>
+#include <rte_power_intrinsics.h>
+
+#include "rte_power_pmd_mgmt.h"
+
+/* Longest wait for the next descriptor, in case the write is missed */
+#define MONITOR_TIMEOUT_US 100
+/* Length of a wait in the pause mode */
+#define PAUSE_US 1
+/* Pause loops used to calibrate the pause mode without TPAUSE */
+#define PAUSE_CALIBRATION_LOOPS 1000
+
+enum pmd_mgmt_state {
+	PMD_MGMT_DISABLED = 0,
+	PMD_MGMT_ENABLED,
+};
+
+struct pmd_queue_cfg {
+	/* consecutive empty polls */
+	uint64_t empty_polls;
+	struct rte_power_pmd_mgmt_stats stats;
+	const struct rte_eth_rxtx_callback *cb;
+	enum pmd_mgmt_state state;
+	enum rte_power_pmd_mgmt_type mode;
+	unsigned int lcore_id;
+} __rte_cache_aligned;
+
+static struct pmd_queue_cfg port_cfg[RTE_MAX_ETHPORTS][RTE_MAX_QUEUES_PER_PORT];
+
+/* queues monitored by each lcore, UMONITOR can only watch one address */
+static uint16_t lcore_monitored[RTE_MAX_LCORE];
+
+static uint64_t emptypoll_max = RTE_POWER_PMD_MGMT_EMPTYPOLL_MAX;
+static uint64_t monitor_cycles;
+static uint64_t pause_cycles;
+static unsigned int pause_per_us;
+static int waitpkg_supported = -1;
+
+static void
+calibrate(void)
+{
+	uint64_t start, cycles;
+	unsigned int i;
+
+	if (waitpkg_supported >= 0)
+		return;
+
+	waitpkg_supported = rte_cpu_get_flag_enabled(RTE_CPUFLAG_WAITPKG) > 0;
+	monitor_cycles = rte_get_tsc_hz() / US_PER_S * MONITOR_TIMEOUT_US;
+	pause_cycles = rte_get_tsc_hz() / US_PER_S * PAUSE_US;
+
+	start = rte_rdtsc();
+	for (i = 0; i < PAUSE_CALIBRATION_LOOPS; i++)
+		rte_pause();
+	cycles = RTE_MAX(rte_rdtsc() - start, UINT64_C(1));
+	pause_per_us = RTE_MAX(PAUSE_CALIBRATION_LOOPS * rte_get_tsc_hz() /
+			US_PER_S / cycles, UINT64_C(1)) * PAUSE_US;
+}
+
+static inline void
+account_sleep(struct pmd_queue_cfg *q_conf, uint64_t start)
+{
+	q_conf->stats.sleeps++;
+	q_conf->stats.sleep_cycles += rte_rdtsc() - start;
+}
+
+static uint16_t
+clb_umwait(uint16_t port_id, uint16_t qidx, struct rte_mbuf **pkts __rte_unused,
+		uint16_t nb_rx, uint16_t max_pkts __rte_unused,
+		void *arg __rte_unused)
+{
+	struct pmd_queue_cfg *q_conf = &port_cfg[port_id][qidx];
+	struct rte_power_monitor_cond pmc;
+	uint64_t start;
+
+	if (likely(nb_rx != 0)) {
+		q_conf->empty_polls = 0;
+		return nb_rx;
+	}
+
+	q_conf->stats.empty_polls++;
+	if (unlikely(++q_conf->empty_polls > emptypoll_max)) {
+		/* wait for the next descriptor to be written back */
+		if (rte_eth_get_monitor_addr(port_id, qidx, &pmc) == 0) {
+			start = rte_rdtsc();
+			rte_power_monitor(&pmc, start + monitor_cycles);
+			account_sleep(q_conf, start);
+		}
+	}
+
+	return nb_rx;
+}
+
+static uint16_t
+clb_pause(uint16_t port_id, uint16_t qidx, struct rte_mbuf **pkts __rte_unused,
+		uint16_t nb_rx, uint16_t max_pkts __rte_unused,
+		void *arg __rte_unused)
+{
+	struct pmd_queue_cfg *q_conf = &port_cfg[port_id][qidx];
+	uint64_t start;
+	unsigned int i;
+
+	if (likely(nb_rx != 0)) {
+		q_conf->empty_polls = 0;
+		return nb_rx;
+	}
+
+	q_conf->stats.empty_polls++;
+	if (unlikely(++q_conf->empty_polls > emptypoll_max)) {
+		start = rte_rdtsc();
+		if (waitpkg_supported)
+			rte_power_pause(start + pause_cycles);
+		else
+			for (i = 0; i < pause_per_us; i++)
+				rte_pause();
+		account_sleep(q_conf, start);
+	}
+
+	return nb_rx;
+}
+
+static int
+check_queue(uint16_t port_id, uint16_t queue_id)
+{
+	struct rte_eth_dev_info info;
+	int ret;
+
+	ret = rte_eth_dev_info_get(port_id, &info);
+	if (ret < 0)
+		return ret;
+	if (queue_id >= RTE_MAX_QUEUES_PER_PORT ||
+			queue_id >= info.nb_rx_queues)
+		return -EINVAL;
+
+	return 0;
+}
+
+/* Whether the next descriptor of the queue can be monitored by the lcore */
+static bool
+monitor_supported(unsigned int lcore_id, uint16_t port_id,
+		uint16_t queue_id)
+{
+	struct rte_power_monitor_cond pmc;
+
+	if (!waitpkg_supported) {
+		RTE_LOG(INFO, POWER, "UMWAIT is not supported by the CPU\n");
+		return false;
+	}
+	if (rte_eth_get_monitor_addr(port_id, queue_id, &pmc) < 0) {
+		RTE_LOG(INFO, POWER, "Port %u cannot be monitored\n", port_id);
+		return false;
+	}
+	if (lcore_monitored[lcore_id] != 0) {
+		RTE_LOG(INFO, POWER, "Lcore %u already monitors a queue\n",
+			lcore_id);
+		return false;
+	}
+
+	return true;
+}
+
+int
+rte_power_pmd_mgmt_queue_enable(unsigned int lcore_id, uint16_t port_id,
+		uint16_t queue_id, enum rte_power_pmd_mgmt_type mode)
+{
+	struct pmd_queue_cfg *q_conf;
+	rte_rx_callback_fn clb;
+	int ret;
+
+	if (lcore_id >= RTE_MAX_LCORE)
+		return -EINVAL;
+
+	ret = check_queue(port_id, queue_id);
+	if (ret < 0)
+		return ret;
+
+	q_conf = &port_cfg[port_id][queue_id];
+	if (q_conf->state != PMD_MGMT_DISABLED)
+		return -EBUSY;
+
+	calibrate();
+
+	switch (mode) {
+	case RTE_POWER_MGMT_TYPE_MONITOR:
+		if (monitor_supported(lcore_id, port_id, queue_id)) {
+			clb = clb_umwait;
+			break;
+		}
+		RTE_LOG(INFO, POWER, "Using pause mode for port %u queue %u\n",
+			port_id, queue_id);
+		mode = RTE_POWER_MGMT_TYPE_PAUSE;
+		/* fall-through */
+	case RTE_POWER_MGMT_TYPE_PAUSE:
+		clb = clb_pause;
+		break;
+	default:
+		RTE_LOG(DEBUG, POWER, "Invalid power management type\n");
+		return -EINVAL;
+	}
+
+	memset(q_conf, 0, sizeof(*q_conf));
+	q_conf->cb = rte_eth_add_rx_callback(port_id, queue_id, clb, NULL);
+	if (q_conf->cb == NULL)
+		return -rte_errno;
+
+	q_conf->mode = mode;
+	q_conf->lcore_id = lcore_id;
+	q_conf->state = PMD_MGMT_ENABLED;
+	if (mode == RTE_POWER_MGMT_TYPE_MONITOR)
+		lcore_monitored[lcore_id]++;
+
+	return 0;
+}
+
+int
+rte_power_pmd_mgmt_queue_disable(unsigned int lcore_id, uint16_t port_id,
+		uint16_t queue_id)
+{
+	struct pmd_queue_cfg *q_conf;
+	int ret;
+
+	if (lcore_id >= RTE_MAX_LCORE)
+		return -EINVAL;
+
+	ret = check_queue(port_id, queue_id);
+	if (ret < 0)
+		return ret;
+
+	q_conf = &port_cfg[port_id][queue_id];
+	if (q_conf->state != PMD_MGMT_ENABLED ||
+			q_conf->lcore_id != lcore_id)
+		return -EINVAL;
+
+	ret = rte_eth_remove_rx_callback(port_id, queue_id, q_conf->cb);
+	if (ret < 0)
+		return ret;
+
+	/* the queue is not polled, so the callback is not in use anymore */
+	rte_free((void *)(uintptr_t)q_conf->cb);
+	q_conf->cb = NULL;
+
+	if (q_conf->mode == RTE_POWER_MGMT_TYPE_MONITOR)
+		lcore_monitored[lcore_id]--;
+	q_conf->state = PMD_MGMT_DISABLED;
+
+	return 0;
+}
+
+void
+rte_power_pmd_mgmt_set_emptypoll_max(unsigned int max)
+{
+	emptypoll_max = max;
+}
+
+int
+rte_power_pmd_mgmt_queue_stats_get(uint16_t port_id, uint16_t queue_id,
+		struct rte_power_pmd_mgmt_stats *stats)
+{
+	struct pmd_queue_cfg *q_conf;
+	int ret;
+
+	if (stats == NULL)
+		return -EINVAL;
+
+	ret = check_queue(port_id, queue_id);
+	if (ret < 0)
+		return ret;
+
+	q_conf = &port_cfg[port_id][queue_id];
+	if (q_conf->state != PMD_MGMT_ENABLED)
+		return -EINVAL;
+
+	*stats = q_conf->stats;
+
+	return 0;
+}
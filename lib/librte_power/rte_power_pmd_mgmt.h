@@ -0,0 +1,144 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#ifndef _RTE_POWER_PMD_MGMT_H
+#define _RTE_POWER_PMD_MGMT_H
+
+/**
+ * @file
+ * RTE PMD Power Management
+ *
+ * Put the lcore polling an Ethernet RX queue in a power-optimized state
+ * when the queue has been empty for a number of polls, from a callback
+ * installed on the queue. Unlike the frequency scaling of rte_power.h,
+ * the lcore stops executing instructions while waiting, and resumes
+ * within microseconds.
+ */
+#include <stdint.h>
+
+#include <rte_common.h>
+#include <rte_compat.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * PMD power management modes.
+ */
+enum rte_power_pmd_mgmt_type {
+	/**
+	 * Wait with UMWAIT for the device to write the next RX descriptor.
+	 * The PAUSE mode is used instead when the CPU or the driver do not
+	 * support it, or when the lcore already monitors another queue.
+	 */
+	RTE_POWER_MGMT_TYPE_MONITOR = 1,
+	/** Wait for a microsecond with TPAUSE, or with pause loops. */
+	RTE_POWER_MGMT_TYPE_PAUSE,
+};
+
+/**
+ * Power management statistics of a RX queue.
+ */
+struct rte_power_pmd_mgmt_stats {
+	uint64_t empty_polls;  /**< Polls which returned no packet */
+	uint64_t sleeps;       /**< Waits in a power-optimized state */
+	uint64_t sleep_cycles; /**< TSC cycles spent waiting */
+};
+
+/**
+ * Default number of consecutive empty polls before a wait.
+ */
+#define RTE_POWER_PMD_MGMT_EMPTYPOLL_MAX 512
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice
+ *
+ * Enable power management on a RX queue.
+ *
+ * @note The port must be configured, and the queue must not be polled
+ *   while calling this function.
+ *
+ * @param lcore_id
+ *   The lcore polling the RX queue.
+ * @param port_id
+ *   The port identifier of the Ethernet device.
+ * @param queue_id
+ *   The RX queue identifier of the Ethernet device.
+ * @param mode
+ *   The power management mode to use.
+ * @return
+ *   0 on success
+ *   <0 on error
+ */
+__rte_experimental
+int
+rte_power_pmd_mgmt_queue_enable(unsigned int lcore_id, uint16_t port_id,
+		uint16_t queue_id, enum rte_power_pmd_mgmt_type mode);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice
+ *
+ * Disable power management on a RX queue.
+ *
+ * @note The queue must not be polled while calling this function.
+ *
+ * @param lcore_id
+ *   The lcore polling the RX queue.
+ * @param port_id
+ *   The port identifier of the Ethernet device.
+ * @param queue_id
+ *   The RX queue identifier of the Ethernet device.
+ * @return
+ *   0 on success
+ *   <0 on error
+ */
+__rte_experimental
+int
+rte_power_pmd_mgmt_queue_disable(unsigned int lcore_id, uint16_t port_id,
+		uint16_t queue_id);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice
+ *
+ * Set the number of consecutive empty polls of a RX queue after which its
+ * lcore waits in a power-optimized state, for all the queues.
+ *
+ * @param max
+ *   The number of empty polls, RTE_POWER_PMD_MGMT_EMPTYPOLL_MAX by default.
+ */
+__rte_experimental
+void
+rte_power_pmd_mgmt_set_emptypoll_max(unsigned int max);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice
+ *
+ * Get the power management statistics of a RX queue, accumulated since
+ * power management was enabled on it.
+ *
+ * @param port_id
+ *   The port identifier of the Ethernet device.
+ * @param queue_id
+ *   The RX queue identifier of the Ethernet device.
+ * @param stats
+ *   The statistics to fill.
+ * @return
+ *   0 on success
+ *   <0 on error
+ */
+__rte_experimental
+int
+rte_power_pmd_mgmt_queue_stats_get(uint16_t port_id, uint16_t queue_id,
+		struct rte_power_pmd_mgmt_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
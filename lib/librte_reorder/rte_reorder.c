@@ -11,6 +11,7 @@
 #include <rte_eal_memconfig.h>
 #include <rte_errno.h>
 #include <rte_malloc.h>
+#include <rte_pause.h>
 #include <rte_tailq.h>
 
 #include "rte_reorder.h"
@@ -29,6 +30,18 @@ EAL_REGISTER_TAILQ(rte_reorder_tailq)
 /* Macros for printing using RTE_LOG */
 #define RTE_LOGTYPE_REORDER	RTE_LOGTYPE_USER1
 
+/* is_initialized while the first multi-producer insert sets min_seqn */
+#define REORDER_MP_INIT_BUSY 2
+
+/*
+ * Value of an empty order_buf slot with multi-producer insert: the sequence
+ * number of the packet the slot is waiting for. It is odd, so it cannot be
+ * an mbuf pointer. rte_reorder_drain_mp() moves it a window further when it
+ * drains or skips the slot, so a late packet never matches it.
+ */
+#define REORDER_FREE(seqn) \
+	((struct rte_mbuf *)(((uintptr_t)(seqn) << 1) | 1))
+
 /* A generic circular buffer */
 struct cir_buffer {
 	unsigned int size;   /**< Number of entries that can be stored */
@@ -46,8 +59,16 @@ struct rte_reorder_buffer {
 	struct cir_buffer ready_buf; /**< temp buffer for dequeued entries */
 	struct cir_buffer order_buf; /**< buffer used to reorder entries */
 	int is_initialized;
+	uint32_t skip_seqn; /**< min_seqn needed by early packets, MP insert */
 } __rte_cache_aligned;
 
+/* Check if an order_buf entry is a packet, not empty */
+static inline int
+reorder_entry_is_mbuf(const struct rte_mbuf *entry)
+{
+	return entry != NULL && !((uintptr_t)entry & 1);
+}
+
 static void
 rte_reorder_free_mbufs(struct rte_reorder_buffer *b);
 
@@ -175,7 +196,7 @@ rte_reorder_free_mbufs(struct rte_reorder_buffer *b)
 
 	/* Free up the mbufs of order buffer & ready buffer */
 	for (i = 0; i < b->order_buf.size; i++) {
-		if (b->order_buf.entries[i])
+		if (reorder_entry_is_mbuf(b->order_buf.entries[i]))
 			rte_pktmbuf_free(b->order_buf.entries[i]);
 		if (b->ready_buf.entries[i])
 			rte_pktmbuf_free(b->ready_buf.entries[i]);
@@ -375,6 +396,7 @@ rte_reorder_drain(struct rte_reorder_buffer *b, struct rte_mbuf **mbufs,
 	/* Try to fetch requested number of mbufs from ready buffer */
 	while ((drain_cnt < max_mbufs) && (ready_buf->tail != ready_buf->head)) {
 		mbufs[drain_cnt++] = ready_buf->entries[ready_buf->tail];
+		ready_buf->entries[ready_buf->tail] = NULL;
 		ready_buf->tail = (ready_buf->tail + 1) & ready_buf->mask;
 	}
 
@@ -392,3 +414,183 @@ rte_reorder_drain(struct rte_reorder_buffer *b, struct rte_mbuf **mbufs,
 
 	return drain_cnt;
 }
+
+/*
+ * Set the start of the sequence window from the first packet inserted by
+ * any of the producers, the others wait for it.
+ */
+static inline void
+reorder_mp_init(struct rte_reorder_buffer *b, uint32_t seqn)
+{
+	unsigned int i;
+	int state = 0;
+
+	if (likely(__atomic_load_n(&b->is_initialized, __ATOMIC_ACQUIRE) == 1))
+		return;
+
+	if (__atomic_compare_exchange_n(&b->is_initialized, &state,
+			REORDER_MP_INIT_BUSY, 0, __ATOMIC_ACQUIRE,
+			__ATOMIC_ACQUIRE)) {
+		b->min_seqn = seqn;
+		b->skip_seqn = seqn;
+		/* The slot of a packet only depends on its sequence number */
+		b->order_buf.head = seqn & b->order_buf.mask;
+		for (i = 0; i < b->order_buf.size; i++)
+			b->order_buf.entries[(seqn + i) & b->order_buf.mask] =
+				REORDER_FREE(seqn + i);
+		__atomic_store_n(&b->is_initialized, 1, __ATOMIC_RELEASE);
+		return;
+	}
+
+	while (__atomic_load_n(&b->is_initialized, __ATOMIC_ACQUIRE) != 1)
+		rte_pause();
+}
+
+static int
+reorder_insert_mp(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf,
+		uint32_t *min_seqn)
+{
+	struct cir_buffer *order_buf = &b->order_buf;
+	const uint32_t seqn = mbuf->seqn;
+	struct rte_mbuf **slot, *entry;
+	uint32_t offset, skip_seqn, need_seqn;
+
+	offset = seqn - *min_seqn;
+	if (offset >= order_buf->size) {
+		/* The window may have moved since min_seqn was read.
+		 * Sync with drain. Acquire the freed slots.
+		 */
+		*min_seqn = __atomic_load_n(&b->min_seqn, __ATOMIC_ACQUIRE);
+		offset = seqn - *min_seqn;
+	}
+
+	if (offset >= 2 * order_buf->size) {
+		rte_errno = ERANGE;
+		return -1;
+	}
+
+	if (offset >= order_buf->size) {
+		/*
+		 * Early packet: ask rte_reorder_drain_mp() to move the window,
+		 * skipping missing packets, until the packet fits in it.
+		 */
+		need_seqn = seqn - order_buf->size + 1;
+		skip_seqn = __atomic_load_n(&b->skip_seqn, __ATOMIC_RELAXED);
+		while ((int32_t)(need_seqn - skip_seqn) > 0 &&
+				!__atomic_compare_exchange_n(&b->skip_seqn,
+					&skip_seqn, need_seqn, 1,
+					__ATOMIC_RELAXED, __ATOMIC_RELAXED))
+			;
+		rte_errno = ENOSPC;
+		return -1;
+	}
+
+	/*
+	 * The slot only takes the packet it waits for: if the window has
+	 * moved past the packet since min_seqn was read, the slot has been
+	 * drained or skipped and waits for a later one.
+	 */
+	slot = &order_buf->entries[seqn & order_buf->mask];
+	entry = REORDER_FREE(seqn);
+	/* Sync with drain. Release the mbuf. */
+	if (likely(__atomic_compare_exchange_n(slot, &entry, mbuf, 0,
+			__ATOMIC_RELEASE, __ATOMIC_RELAXED)))
+		return 0;
+
+	if (reorder_entry_is_mbuf(entry)) {
+		/* The packet a window earlier is not drained yet */
+		rte_errno = ENOSPC;
+	} else {
+		/* Too late, the drain has already moved past the packet */
+		rte_errno = ERANGE;
+	}
+	return -1;
+}
+
+int
+rte_reorder_insert_mp(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf)
+{
+	uint32_t min_seqn;
+
+	if (b == NULL || mbuf == NULL) {
+		rte_errno = EINVAL;
+		return -1;
+	}
+
+	reorder_mp_init(b, mbuf->seqn);
+	min_seqn = __atomic_load_n(&b->min_seqn, __ATOMIC_ACQUIRE);
+
+	return reorder_insert_mp(b, mbuf, &min_seqn);
+}
+
+unsigned int
+rte_reorder_insert_bulk_mp(struct rte_reorder_buffer *b,
+		struct rte_mbuf **mbufs, unsigned int nb_mbufs)
+{
+	uint32_t min_seqn;
+	unsigned int i;
+
+	if (b == NULL || mbufs == NULL) {
+		rte_errno = EINVAL;
+		return 0;
+	}
+	if (nb_mbufs == 0)
+		return 0;
+
+	reorder_mp_init(b, mbufs[0]->seqn);
+	min_seqn = __atomic_load_n(&b->min_seqn, __ATOMIC_ACQUIRE);
+
+	for (i = 0; i < nb_mbufs; i++) {
+		if (reorder_insert_mp(b, mbufs[i], &min_seqn) != 0)
+			break;
+	}
+	return i;
+}
+
+unsigned int
+rte_reorder_drain_mp(struct rte_reorder_buffer *b, struct rte_mbuf **mbufs,
+		unsigned int max_mbufs)
+{
+	struct cir_buffer *order_buf = &b->order_buf;
+	struct rte_mbuf **slot, *entry;
+	uint32_t min_seqn, skip_seqn;
+	unsigned int drain_cnt = 0;
+
+	/* Sync with insert on the first packet */
+	if (__atomic_load_n(&b->is_initialized, __ATOMIC_ACQUIRE) != 1)
+		return 0;
+
+	min_seqn = b->min_seqn;
+	skip_seqn = __atomic_load_n(&b->skip_seqn, __ATOMIC_RELAXED);
+
+	while (drain_cnt < max_mbufs) {
+		slot = &order_buf->entries[min_seqn & order_buf->mask];
+		/* Sync with insert. Acquire the mbuf. */
+		entry = __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+
+		if (reorder_entry_is_mbuf(entry)) {
+			/* The slot only takes the packet at min_seqn */
+			RTE_ASSERT(entry->seqn == min_seqn);
+			mbufs[drain_cnt++] = entry;
+			/* Sync with insert. Release the moved window. */
+			__atomic_store_n(slot,
+				REORDER_FREE(min_seqn + order_buf->size),
+				__ATOMIC_RELEASE);
+		} else if ((int32_t)(skip_seqn - min_seqn) > 0) {
+			/* Skip the missing packet to make room for early ones */
+			if (!__atomic_compare_exchange_n(slot, &entry,
+					REORDER_FREE(min_seqn + order_buf->size),
+					0, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+				continue;
+		} else {
+			break;
+		}
+		min_seqn++;
+	}
+
+	order_buf->head = min_seqn & order_buf->mask;
+	/* Sync with insert. Release the freed slots. */
+	__atomic_store_n(&b->min_seqn, min_seqn, __ATOMIC_RELEASE);
+
+	return drain_cnt;
+}
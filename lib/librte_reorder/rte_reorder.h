@@ -15,6 +15,7 @@
  *
  */
 
+#include <rte_compat.h>
 #include <rte_mbuf.h>
 
 #ifdef __cplusplus
@@ -146,6 +147,93 @@ unsigned int
 rte_reorder_drain(struct rte_reorder_buffer *b, struct rte_mbuf **mbufs,
 		unsigned max_mbufs);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Insert given mbuf in reorder buffer in its correct position, from any
+ * number of lcores at the same time
+ *
+ * Unlike rte_reorder_insert(), this function is multi-thread safe: the slot
+ * of the mbuf in the sequence window is claimed with an atomic operation,
+ * and it never moves the window. Early mbufs ask rte_reorder_drain_mp() to
+ * move it instead, skipping missing packets if needed. A reorder buffer
+ * filled with this function must only be drained with
+ * rte_reorder_drain_mp(), called on a single lcore, and must not be
+ * used with rte_reorder_insert() or rte_reorder_drain() until it is reset.
+ *
+ * @param b
+ *   Reorder buffer where the mbuf has to be inserted.
+ * @param mbuf
+ *   mbuf of packet that needs to be inserted in reorder buffer.
+ * @return
+ *   0 on success
+ *   -1 on error
+ *   On error case, rte_errno will be set appropriately:
+ *    - ENOSPC - The mbuf is early for the current window, or its slot is
+ *      still used by an mbuf which is not drained yet. It can be inserted
+ *      again after rte_reorder_drain_mp() has moved the window.
+ *    - ERANGE - Too early or late mbuf which is vastly out of range of
+ *      expected window, or whose slot has been skipped already, should be
+ *      ignored without any handling.
+ *    - EINVAL - invalid parameters
+ */
+__rte_experimental
+int
+rte_reorder_insert_mp(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Insert a burst of mbufs in reorder buffer, from any number of lcores at
+ * the same time
+ *
+ * The mbufs are inserted as with rte_reorder_insert_mp(), stopping at the
+ * first one which cannot be inserted.
+ *
+ * @param b
+ *   Reorder buffer where the mbufs have to be inserted.
+ * @param mbufs
+ *   Array of mbufs of packets that need to be inserted in reorder buffer.
+ * @param nb_mbufs
+ *   The number of mbufs in the array.
+ * @return
+ *   The number of mbufs inserted, from the start of the array. If it is less
+ *   than nb_mbufs, rte_errno is set as by rte_reorder_insert_mp() for the
+ *   next mbuf.
+ */
+__rte_experimental
+unsigned int
+rte_reorder_insert_bulk_mp(struct rte_reorder_buffer *b,
+		struct rte_mbuf **mbufs, unsigned int nb_mbufs);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Fetch reordered buffers inserted with rte_reorder_insert_mp()
+ *
+ * Returns the in-order mbufs at the start of the sequence window, stopping
+ * at the first missing one, unless an early mbuf could not be inserted: the
+ * window is then moved past the missing mbufs until the early one fits.
+ * This function is not multi-thread safe, it may only be called on one lcore
+ * at a time, but it is safe against concurrent rte_reorder_insert_mp() calls.
+ *
+ * @param b
+ *   Reorder buffer instance from which packets are to be drained
+ * @param mbufs
+ *   array of mbufs where reordered packets will be inserted from reorder buffer
+ * @param max_mbufs
+ *   the number of elements in the mbufs array.
+ * @return
+ *   number of mbuf pointers written to mbufs. 0 <= N <= max_mbufs.
+ */
+__rte_experimental
+unsigned int
+rte_reorder_drain_mp(struct rte_reorder_buffer *b, struct rte_mbuf **mbufs,
+		unsigned int max_mbufs);
+
 #ifdef __cplusplus
 }
 #endif
@@ -10,7 +10,6 @@
 #include <rte_eal_memconfig.h>
 #include <rte_errno.h>
 #include <rte_malloc.h>
-#include <rte_mempool.h>
 #include <rte_rwlock.h>
 #include <rte_string_fns.h>
 #include <rte_tailq.h>
@@ -28,11 +27,17 @@ EAL_REGISTER_TAILQ(rte_rib_tailq)
 #define RIB_MAXDEPTH		32
 /* Maximum length of a RIB name. */
 #define RTE_RIB_NAMESIZE	64
+/* Node index meaning no node, the first node of the arena is not used */
+#define RIB_NODE_NONE		0
 
+/*
+ * Nodes live in a single arena and link to their children by index,
+ * the parent pointer lets rte_rib_lookup_parent() work without the RIB.
+ */
 struct rte_rib_node {
-	struct rte_rib_node	*left;
-	struct rte_rib_node	*right;
 	struct rte_rib_node	*parent;
+	uint32_t	left;
+	uint32_t	right;
 	uint32_t	ip;
 	uint8_t		depth;
 	uint8_t		flag;
@@ -42,13 +47,24 @@ struct rte_rib_node {
 
 struct rte_rib {
 	char		name[RTE_RIB_NAMESIZE];
-	struct rte_rib_node	*tree;
-	struct rte_mempool	*node_pool;
+	uint32_t	tree;		/* index of the root node */
+	uint8_t		*nodes;		/* node arena */
+	size_t		node_sz;	/* size of a node and its extension */
+	uint32_t	free_head;	/* free nodes, linked by left */
+	uint32_t	next_new;	/* first node never allocated */
 	uint32_t		cur_nodes;
 	uint32_t		cur_routes;
 	uint32_t		max_nodes;
 };
 
+static inline struct rte_rib_node *
+get_node(const struct rte_rib *rib, uint32_t idx)
+{
+	if (idx == RIB_NODE_NONE)
+		return NULL;
+	return (struct rte_rib_node *)(rib->nodes + (size_t)idx * rib->node_sz);
+}
+
 static inline bool
 is_valid_node(struct rte_rib_node *node)
 {
@@ -56,9 +72,9 @@ is_valid_node(struct rte_rib_node *node)
 }
 
 static inline bool
-is_right_node(struct rte_rib_node *node)
+is_right_node(const struct rte_rib *rib, struct rte_rib_node *node)
 {
-	return node->parent->right == node;
+	return get_node(rib, node->parent->right) == node;
 }
 
 /*
@@ -70,30 +86,51 @@ is_covered(uint32_t ip1, uint32_t ip2, uint8_t depth)
 	return ((ip1 ^ ip2) & rte_rib_depth_to_mask(depth)) == 0;
 }
 
-static inline struct rte_rib_node *
-get_nxt_node(struct rte_rib_node *node, uint32_t ip)
+static inline uint32_t
+get_nxt_idx(struct rte_rib_node *node, uint32_t ip)
 {
 	return (ip & (1 << (31 - node->depth))) ? node->right : node->left;
 }
 
-static struct rte_rib_node *
-node_alloc(struct rte_rib *rib)
+static inline struct rte_rib_node *
+get_nxt_node(const struct rte_rib *rib, struct rte_rib_node *node,
+	uint32_t ip)
 {
-	struct rte_rib_node *ent;
-	int ret;
+	return get_node(rib, get_nxt_idx(node, ip));
+}
 
-	ret = rte_mempool_get(rib->node_pool, (void *)&ent);
-	if (unlikely(ret != 0))
-		return NULL;
+static uint32_t
+node_alloc(struct rte_rib *rib)
+{
+	uint32_t idx;
+
+	if (rib->free_head != RIB_NODE_NONE) {
+		idx = rib->free_head;
+		rib->free_head = get_node(rib, idx)->left;
+	} else if (rib->next_new <= rib->max_nodes)
+		idx = rib->next_new++;
+	else
+		return RIB_NODE_NONE;
 	++rib->cur_nodes;
-	return ent;
+	return idx;
 }
 
 static void
-node_free(struct rte_rib *rib, struct rte_rib_node *ent)
+node_free(struct rte_rib *rib, uint32_t idx)
 {
 	--rib->cur_nodes;
-	rte_mempool_put(rib->node_pool, ent);
+	get_node(rib, idx)->left = rib->free_head;
+	rib->free_head = idx;
+}
+
+/* Index of a node linked in the tree */
+static inline uint32_t
+node_idx(const struct rte_rib *rib, struct rte_rib_node *node)
+{
+	if (node->parent == NULL)
+		return rib->tree;
+	return is_right_node(rib, node) ? node->parent->right :
+		node->parent->left;
 }
 
 struct rte_rib_node *
@@ -106,11 +143,11 @@ rte_rib_lookup(struct rte_rib *rib, uint32_t ip)
 		return NULL;
 	}
 
-	cur = rib->tree;
+	cur = get_node(rib, rib->tree);
 	while ((cur != NULL) && is_covered(ip, cur->ip, cur->depth)) {
 		if (is_valid_node(cur))
 			prev = cur;
-		cur = get_nxt_node(cur, ip);
+		cur = get_nxt_node(rib, cur, ip);
 	}
 	return prev;
 }
@@ -133,7 +170,7 @@ __rib_lookup_exact(struct rte_rib *rib, uint32_t ip, uint8_t depth)
 {
 	struct rte_rib_node *cur;
 
-	cur = rib->tree;
+	cur = get_node(rib, rib->tree);
 	while (cur != NULL) {
 		if ((cur->ip == ip) && (cur->depth == depth) &&
 				is_valid_node(cur))
@@ -141,7 +178,7 @@ __rib_lookup_exact(struct rte_rib *rib, uint32_t ip, uint8_t depth)
 		if ((cur->depth > depth) ||
 				!is_covered(ip, cur->ip, cur->depth))
 			break;
-		cur = get_nxt_node(cur, ip);
+		cur = get_nxt_node(rib, cur, ip);
 	}
 	return NULL;
 }
@@ -175,20 +212,20 @@ rte_rib_get_nxt(struct rte_rib *rib, uint32_t ip,
 	}
 
 	if (last == NULL) {
-		tmp = rib->tree;
+		tmp = get_node(rib, rib->tree);
 		while ((tmp) && (tmp->depth < depth))
-			tmp = get_nxt_node(tmp, ip);
+			tmp = get_nxt_node(rib, tmp, ip);
 	} else {
 		tmp = last;
-		while ((tmp->parent != NULL) && (is_right_node(tmp) ||
-				(tmp->parent->right == NULL))) {
+		while ((tmp->parent != NULL) && (is_right_node(rib, tmp) ||
+				(tmp->parent->right == RIB_NODE_NONE))) {
 			tmp = tmp->parent;
 			if (is_valid_node(tmp) &&
 					(is_covered(tmp->ip, ip, depth) &&
 					(tmp->depth > depth)))
 				return tmp;
 		}
-		tmp = (tmp->parent) ? tmp->parent->right : NULL;
+		tmp = (tmp->parent) ? get_node(rib, tmp->parent->right) : NULL;
 	}
 	while (tmp) {
 		if (is_valid_node(tmp) &&
@@ -198,7 +235,8 @@ rte_rib_get_nxt(struct rte_rib *rib, uint32_t ip,
 			if (flag == RTE_RIB_GET_NXT_COVER)
 				return prev;
 		}
-		tmp = (tmp->left) ? tmp->left : tmp->right;
+		tmp = get_node(rib, (tmp->left != RIB_NODE_NONE) ?
+			tmp->left : tmp->right);
 	}
 	return prev;
 }
@@ -206,7 +244,8 @@ rte_rib_get_nxt(struct rte_rib *rib, uint32_t ip,
 void
 rte_rib_remove(struct rte_rib *rib, uint32_t ip, uint8_t depth)
 {
-	struct rte_rib_node *cur, *prev, *child;
+	struct rte_rib_node *cur, *child;
+	uint32_t cur_idx, child_idx;
 
 	cur = rte_rib_lookup_exact(rib, ip, depth);
 	if (cur == NULL)
@@ -215,132 +254,281 @@ rte_rib_remove(struct rte_rib *rib, uint32_t ip, uint8_t depth)
 	--rib->cur_routes;
 	cur->flag &= ~RTE_RIB_VALID_NODE;
 	while (!is_valid_node(cur)) {
-		if ((cur->left != NULL) && (cur->right != NULL))
+		if ((cur->left != RIB_NODE_NONE) &&
+				(cur->right != RIB_NODE_NONE))
 			return;
-		child = (cur->left == NULL) ? cur->right : cur->left;
+		cur_idx = node_idx(rib, cur);
+		child_idx = (cur->left == RIB_NODE_NONE) ? cur->right :
+			cur->left;
+		child = get_node(rib, child_idx);
 		if (child != NULL)
 			child->parent = cur->parent;
 		if (cur->parent == NULL) {
-			rib->tree = child;
-			node_free(rib, cur);
+			rib->tree = child_idx;
+			node_free(rib, cur_idx);
 			return;
 		}
-		if (cur->parent->left == cur)
-			cur->parent->left = child;
+		if (cur->parent->left == cur_idx)
+			cur->parent->left = child_idx;
 		else
-			cur->parent->right = child;
-		prev = cur;
+			cur->parent->right = child_idx;
 		cur = cur->parent;
-		node_free(rib, prev);
+		node_free(rib, cur_idx);
 	}
 }
 
-struct rte_rib_node *
-rte_rib_insert(struct rte_rib *rib, uint32_t ip, uint8_t depth)
+/*
+ * Insert a masked prefix, searching from the start node which covers it
+ * with a shorter depth, or from the root if start is NULL.
+ * If the route already exists, it is returned and *exist is set.
+ */
+static struct rte_rib_node *
+rib_insert(struct rte_rib *rib, struct rte_rib_node *start, uint32_t ip,
+	uint8_t depth, bool *exist)
 {
-	struct rte_rib_node **tmp;
-	struct rte_rib_node *prev = NULL;
+	uint32_t *tmp;
+	struct rte_rib_node *cur;
+	struct rte_rib_node *prev = start;
 	struct rte_rib_node *new_node = NULL;
 	struct rte_rib_node *common_node = NULL;
+	uint32_t new_idx, common_idx;
 	int d = 0;
 	uint32_t common_prefix;
 	uint8_t common_depth;
 
-	if ((rib == NULL) || (depth > RIB_MAXDEPTH)) {
-		rte_errno = EINVAL;
-		return NULL;
-	}
+	*exist = false;
+	if (start == NULL)
+		tmp = &rib->tree;
+	else
+		tmp = (ip & (1 << (31 - start->depth))) ? &start->right :
+			&start->left;
 
-	tmp = &rib->tree;
-	ip &= rte_rib_depth_to_mask(depth);
-	new_node = __rib_lookup_exact(rib, ip, depth);
-	if (new_node != NULL) {
-		rte_errno = EEXIST;
-		return NULL;
+	/* traverse down the tree to find matching node or closest matching */
+	while (1) {
+		cur = get_node(rib, *tmp);
+		/* insert as the last node in the branch */
+		if (cur == NULL)
+			break;
+		/*
+		 * Node with proper search criteria is found. Either it is
+		 * the route, or an intermediate node to validate.
+		 */
+		if ((ip == cur->ip) && (depth == cur->depth)) {
+			if (is_valid_node(cur)) {
+				*exist = true;
+				return cur;
+			}
+			cur->flag |= RTE_RIB_VALID_NODE;
+			++rib->cur_routes;
+			return cur;
+		}
+		d = cur->depth;
+		if ((d >= depth) || !is_covered(ip, cur->ip, d))
+			break;
+		prev = cur;
+		tmp = (ip & (1 << (31 - d))) ? &cur->right : &cur->left;
 	}
 
-	new_node = node_alloc(rib);
-	if (new_node == NULL) {
+	new_idx = node_alloc(rib);
+	if (new_idx == RIB_NODE_NONE) {
 		rte_errno = ENOMEM;
 		return NULL;
 	}
-	new_node->left = NULL;
-	new_node->right = NULL;
+	new_node = get_node(rib, new_idx);
+	new_node->left = RIB_NODE_NONE;
+	new_node->right = RIB_NODE_NONE;
 	new_node->parent = NULL;
 	new_node->ip = ip;
 	new_node->depth = depth;
 	new_node->flag = RTE_RIB_VALID_NODE;
 
-	/* traverse down the tree to find matching node or closest matching */
-	while (1) {
-		/* insert as the last node in the branch */
-		if (*tmp == NULL) {
-			*tmp = new_node;
-			new_node->parent = prev;
-			++rib->cur_routes;
-			return *tmp;
-		}
-		/*
-		 * Intermediate node found.
-		 * Previous rte_rib_lookup_exact() returned NULL
-		 * but node with proper search criteria is found.
-		 * Validate intermediate node and return.
-		 */
-		if ((ip == (*tmp)->ip) && (depth == (*tmp)->depth)) {
-			node_free(rib, new_node);
-			(*tmp)->flag |= RTE_RIB_VALID_NODE;
-			++rib->cur_routes;
-			return *tmp;
-		}
-		d = (*tmp)->depth;
-		if ((d >= depth) || !is_covered(ip, (*tmp)->ip, d))
-			break;
-		prev = *tmp;
-		tmp = (ip & (1 << (31 - d))) ? &(*tmp)->right : &(*tmp)->left;
+	if (cur == NULL) {
+		*tmp = new_idx;
+		new_node->parent = prev;
+		++rib->cur_routes;
+		return new_node;
 	}
+
 	/* closest node found, new_node should be inserted in the middle */
-	common_depth = RTE_MIN(depth, (*tmp)->depth);
-	common_prefix = ip ^ (*tmp)->ip;
-	d = __builtin_clz(common_prefix);
+	common_depth = RTE_MIN(depth, cur->depth);
+	common_prefix = ip ^ cur->ip;
+	d = (common_prefix == 0) ? RIB_MAXDEPTH : __builtin_clz(common_prefix);
 
 	common_depth = RTE_MIN(d, common_depth);
 	common_prefix = ip & rte_rib_depth_to_mask(common_depth);
 	if ((common_prefix == ip) && (common_depth == depth)) {
 		/* insert as a parent */
-		if ((*tmp)->ip & (1 << (31 - depth)))
+		if (cur->ip & (1 << (31 - depth)))
 			new_node->right = *tmp;
 		else
 			new_node->left = *tmp;
-		new_node->parent = (*tmp)->parent;
-		(*tmp)->parent = new_node;
-		*tmp = new_node;
+		new_node->parent = cur->parent;
+		cur->parent = new_node;
+		*tmp = new_idx;
 	} else {
 		/* create intermediate node */
-		common_node = node_alloc(rib);
-		if (common_node == NULL) {
-			node_free(rib, new_node);
+		common_idx = node_alloc(rib);
+		if (common_idx == RIB_NODE_NONE) {
+			node_free(rib, new_idx);
 			rte_errno = ENOMEM;
 			return NULL;
 		}
+		common_node = get_node(rib, common_idx);
 		common_node->ip = common_prefix;
 		common_node->depth = common_depth;
 		common_node->flag = 0;
-		common_node->parent = (*tmp)->parent;
+		common_node->parent = cur->parent;
 		new_node->parent = common_node;
-		(*tmp)->parent = common_node;
+		cur->parent = common_node;
 		if ((new_node->ip & (1 << (31 - common_depth))) == 0) {
-			common_node->left = new_node;
+			common_node->left = new_idx;
 			common_node->right = *tmp;
 		} else {
 			common_node->left = *tmp;
-			common_node->right = new_node;
+			common_node->right = new_idx;
 		}
-		*tmp = common_node;
+		*tmp = common_idx;
 	}
 	++rib->cur_routes;
 	return new_node;
 }
 
+struct rte_rib_node *
+rte_rib_insert(struct rte_rib *rib, uint32_t ip, uint8_t depth)
+{
+	struct rte_rib_node *node;
+	bool exist;
+
+	if ((rib == NULL) || (depth > RIB_MAXDEPTH)) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	ip &= rte_rib_depth_to_mask(depth);
+	node = rib_insert(rib, NULL, ip, depth, &exist);
+	if (exist) {
+		rte_errno = EEXIST;
+		return NULL;
+	}
+	return node;
+}
+
+int
+rte_rib_insert_bulk(struct rte_rib *rib, const uint32_t *ips,
+	const uint8_t *depths, const uint64_t *nhs, unsigned int n)
+{
+	struct rte_rib_node *start, *node = NULL;
+	unsigned int i;
+	uint32_t ip;
+	bool exist;
+
+	if ((rib == NULL) || (ips == NULL) || (depths == NULL) ||
+			(nhs == NULL)) {
+		rte_errno = EINVAL;
+		return -EINVAL;
+	}
+
+	for (i = 0; i < n; i++) {
+		if (depths[i] > RIB_MAXDEPTH) {
+			rte_errno = EINVAL;
+			return i;
+		}
+		ip = ips[i] & rte_rib_depth_to_mask(depths[i]);
+
+		/*
+		 * Sorted routes are close in the tree, so the search starts
+		 * from the closest ancestor of the previous route covering
+		 * this one.
+		 */
+		start = node;
+		while ((start != NULL) && ((start->depth >= depths[i]) ||
+				!is_covered(ip, start->ip, start->depth)))
+			start = start->parent;
+
+		node = rib_insert(rib, start, ip, depths[i], &exist);
+		if (node == NULL)
+			return i;
+		node->nh = nhs[i];
+	}
+	return n;
+}
+
+int
+rte_rib_walk_init(struct rte_rib *rib, struct rte_rib_walk *walk,
+	uint32_t ip, uint8_t depth)
+{
+	struct rte_rib_node *tmp;
+	uint32_t idx;
+
+	if ((rib == NULL) || (walk == NULL) || (depth > RIB_MAXDEPTH)) {
+		rte_errno = EINVAL;
+		return -1;
+	}
+
+	ip &= rte_rib_depth_to_mask(depth);
+	idx = rib->tree;
+	tmp = get_node(rib, idx);
+	while ((tmp != NULL) && (tmp->depth < depth)) {
+		idx = get_nxt_idx(tmp, ip);
+		tmp = get_node(rib, idx);
+	}
+	/* the subtree of the first node deep enough holds all the routes */
+	if ((tmp == NULL) || !is_covered(tmp->ip, ip, depth))
+		idx = RIB_NODE_NONE;
+
+	walk->ip = ip;
+	walk->depth = depth;
+	walk->root = idx;
+	walk->next = idx;
+	return 0;
+}
+
+int
+rte_rib_walk_bulk(struct rte_rib *rib, struct rte_rib_walk *walk,
+	uint32_t *ips, uint8_t *depths, uint64_t *nhs, unsigned int n)
+{
+	struct rte_rib_node *node, *root;
+	unsigned int i = 0;
+	uint32_t idx;
+
+	if ((rib == NULL) || (walk == NULL) || (ips == NULL) ||
+			(depths == NULL) || (nhs == NULL)) {
+		rte_errno = EINVAL;
+		return -1;
+	}
+
+	root = get_node(rib, walk->root);
+	idx = walk->next;
+	while ((idx != RIB_NODE_NONE) && (i < n)) {
+		node = get_node(rib, idx);
+		if (is_valid_node(node)) {
+			ips[i] = node->ip;
+			depths[i] = node->depth;
+			nhs[i] = node->nh;
+			i++;
+		}
+
+		/* next node in prefix order */
+		if (node->left != RIB_NODE_NONE)
+			idx = node->left;
+		else if (node->right != RIB_NODE_NONE)
+			idx = node->right;
+		else {
+			idx = RIB_NODE_NONE;
+			while (node != root) {
+				if ((node->parent->right != RIB_NODE_NONE) &&
+						!is_right_node(rib, node)) {
+					idx = node->parent->right;
+					break;
+				}
+				node = node->parent;
+			}
+		}
+	}
+	walk->next = idx;
+	return i;
+}
+
 int
 rte_rib_get_ip(struct rte_rib_node *node, uint32_t *ip)
 {
@@ -398,23 +586,27 @@ rte_rib_create(const char *name, int socket_id, struct rte_rib_conf *conf)
 	struct rte_rib *rib = NULL;
 	struct rte_tailq_entry *te;
 	struct rte_rib_list *rib_list;
-	struct rte_mempool *node_pool;
+	uint8_t *nodes;
+	size_t node_sz;
 
 	/* Check user arguments. */
 	if ((name == NULL) || (conf == NULL) ||
-			(conf->max_nodes == 0)) {
+			(socket_id < SOCKET_ID_ANY) || (conf->max_nodes <= 0)) {
 		rte_errno = EINVAL;
 		return NULL;
 	}
 
-	snprintf(mem_name, sizeof(mem_name), "MP_%s", name);
-	node_pool = rte_mempool_create(mem_name, conf->max_nodes,
-		sizeof(struct rte_rib_node) + conf->ext_sz, 0, 0,
-		NULL, NULL, NULL, NULL, socket_id, 0);
+	node_sz = RTE_ALIGN_CEIL(sizeof(struct rte_rib_node) + conf->ext_sz,
+		sizeof(uint64_t));
+	snprintf(mem_name, sizeof(mem_name), "RIBN_%s", name);
+	nodes = rte_malloc_socket(mem_name,
+		node_sz * ((size_t)conf->max_nodes + 1), RTE_CACHE_LINE_SIZE,
+		socket_id);
 
-	if (node_pool == NULL) {
+	if (nodes == NULL) {
 		RTE_LOG(ERR, LPM,
-			"Can not allocate mempool for RIB %s\n", name);
+			"Can not allocate nodes for RIB %s\n", name);
+		rte_errno = ENOMEM;
 		return NULL;
 	}
 
@@ -454,9 +646,12 @@ rte_rib_create(const char *name, int socket_id, struct rte_rib_conf *conf)
 	}
 
 	rte_strlcpy(rib->name, name, sizeof(rib->name));
-	rib->tree = NULL;
+	rib->tree = RIB_NODE_NONE;
 	rib->max_nodes = conf->max_nodes;
-	rib->node_pool = node_pool;
+	rib->nodes = nodes;
+	rib->node_sz = node_sz;
+	rib->free_head = RIB_NODE_NONE;
+	rib->next_new = 1;
 	te->data = (void *)rib;
 	TAILQ_INSERT_TAIL(rib_list, te, next);
 
@@ -468,7 +663,7 @@ rte_rib_create(const char *name, int socket_id, struct rte_rib_conf *conf)
 	rte_free(te);
 exit:
 	rte_mcfg_tailq_write_unlock();
-	rte_mempool_free(node_pool);
+	rte_free(nodes);
 
 	return NULL;
 }
@@ -503,7 +698,6 @@ rte_rib_free(struct rte_rib *rib)
 {
 	struct rte_tailq_entry *te;
 	struct rte_rib_list *rib_list;
-	struct rte_rib_node *tmp = NULL;
 
 	if (rib == NULL)
 		return;
@@ -522,11 +716,7 @@ rte_rib_free(struct rte_rib *rib)
 
 	rte_mcfg_tailq_write_unlock();
 
-	while ((tmp = rte_rib_get_nxt(rib, 0, 0, tmp,
-			RTE_RIB_GET_NXT_ALL)) != NULL)
-		rte_rib_remove(rib, tmp->ip, tmp->depth);
-
-	rte_mempool_free(rib->node_pool);
+	rte_free(rib->nodes);
 	rte_free(rib);
 	rte_free(te);
 }
@@ -38,6 +38,17 @@ struct rte_rib_conf {
 	int	max_nodes;
 };
 
+/**
+ * State of a walk over the routes of a subtree of the RIB,
+ * see rte_rib_walk_init(). Its fields are private.
+ */
+struct rte_rib_walk {
+	uint32_t	ip;	/**< Prefix covering the walked routes */
+	uint8_t		depth;	/**< Length of the covering prefix */
+	uint32_t	root;	/**< Subtree of the walk */
+	uint32_t	next;	/**< Next node to visit */
+};
+
 /**
  * Get an IPv4 mask from prefix length
  * It is caller responsibility to make sure depth is not bigger than 32
@@ -158,6 +169,78 @@ __rte_experimental
 struct rte_rib_node *
 rte_rib_insert(struct rte_rib *rib, uint32_t ip, uint8_t depth);
 
+/**
+ * Insert a list of routes into the RIB, or update the next hop of the
+ * routes already in it. The search for the position of a route starts
+ * from the previous one, so routes sorted by prefix are inserted faster.
+ *
+ * @param rib
+ *  RIB object handle
+ * @param ips
+ *  nets to be inserted to the RIB
+ * @param depths
+ *  prefix lengths
+ * @param nhs
+ *  next hops of the routes
+ * @param n
+ *  number of routes
+ * @return
+ *  number of routes inserted, if less than n, rte_errno indicates the
+ *  reason why the next one failed.
+ *  -EINVAL, with rte_errno set to EINVAL, if rib, ips, depths or nhs
+ *  is NULL.
+ */
+__rte_experimental
+int
+rte_rib_insert_bulk(struct rte_rib *rib, const uint32_t *ips,
+	const uint8_t *depths, const uint64_t *nhs, unsigned int n);
+
+/**
+ * Start a walk over the routes covered by a prefix, in prefix order.
+ * Unlike rte_rib_get_nxt(), the prefix itself is part of the walk.
+ * The RIB must not be modified until the walk is over.
+ *
+ * @param rib
+ *  RIB object handle
+ * @param walk
+ *  walk state to initialize
+ * @param ip
+ *  net address of the prefix covering the routes to walk
+ * @param depth
+ *  prefix length, 0 to walk the whole RIB
+ * @return
+ *  0 on success
+ *  -1 on failure with rte_errno indicating reason for failure.
+ */
+__rte_experimental
+int
+rte_rib_walk_init(struct rte_rib *rib, struct rte_rib_walk *walk,
+	uint32_t ip, uint8_t depth);
+
+/**
+ * Retrieve the next routes of a walk.
+ *
+ * @param rib
+ *  RIB object handle
+ * @param walk
+ *  walk state set by rte_rib_walk_init()
+ * @param ips
+ *  array to store the nets of the routes
+ * @param depths
+ *  array to store the prefix lengths of the routes
+ * @param nhs
+ *  array to store the next hops of the routes
+ * @param n
+ *  size of the arrays
+ * @return
+ *  number of routes retrieved, 0 when the walk is over
+ *  -1 on failure with rte_errno indicating reason for failure.
+ */
+__rte_experimental
+int
+rte_rib_walk_bulk(struct rte_rib *rib, struct rte_rib_walk *walk,
+	uint32_t *ips, uint8_t *depths, uint64_t *nhs, unsigned int n);
+
 /**
  * Get an ip from rte_rib_node
  *
@@ -10,7 +10,6 @@
 #include <rte_eal_memconfig.h>
 #include <rte_errno.h>
 #include <rte_malloc.h>
-#include <rte_mempool.h>
 #include <rte_rwlock.h>
 #include <rte_string_fns.h>
 #include <rte_tailq.h>
@@ -21,6 +20,8 @@
 #define RIB6_MAXDEPTH		128
 /* Maximum length of a RIB6 name. */
 #define RTE_RIB6_NAMESIZE	64
+/* Node index meaning no node, the first node of the arena is not used */
+#define RIB6_NODE_NONE		0
 
 TAILQ_HEAD(rte_rib6_list, rte_tailq_entry);
 static struct rte_tailq_elem rte_rib6_tailq = {
@@ -28,10 +29,14 @@ static struct rte_tailq_elem rte_rib6_tailq = {
 };
 EAL_REGISTER_TAILQ(rte_rib6_tailq)
 
+/*
+ * Nodes live in a single arena and link to their children by index,
+ * the parent pointer lets rte_rib6_lookup_parent() work without the RIB.
+ */
 struct rte_rib6_node {
-	struct rte_rib6_node	*left;
-	struct rte_rib6_node	*right;
 	struct rte_rib6_node	*parent;
+	uint32_t		left;
+	uint32_t		right;
 	uint64_t		nh;
 	uint8_t			ip[RTE_RIB6_IPV6_ADDR_SIZE];
 	uint8_t			depth;
@@ -41,13 +46,25 @@ struct rte_rib6_node {
 
 struct rte_rib6 {
 	char		name[RTE_RIB6_NAMESIZE];
-	struct rte_rib6_node	*tree;
-	struct rte_mempool	*node_pool;
+	uint32_t		tree;		/* index of the root node */
+	uint8_t			*nodes;		/* node arena */
+	size_t			node_sz;	/* size of a node */
+	uint32_t		free_head;	/* free nodes, linked by left */
+	uint32_t		next_new;	/* first node never allocated */
 	uint32_t		cur_nodes;
 	uint32_t		cur_routes;
 	int			max_nodes;
 };
 
+static inline struct rte_rib6_node *
+get_node(const struct rte_rib6 *rib, uint32_t idx)
+{
+	if (idx == RIB6_NODE_NONE)
+		return NULL;
+	return (struct rte_rib6_node *)(rib->nodes +
+		(size_t)idx * rib->node_sz);
+}
+
 static inline bool
 is_valid_node(struct rte_rib6_node *node)
 {
@@ -55,9 +72,9 @@ is_valid_node(struct rte_rib6_node *node)
 }
 
 static inline bool
-is_right_node(struct rte_rib6_node *node)
+is_right_node(const struct rte_rib6 *rib, struct rte_rib6_node *node)
 {
-	return node->parent->right == node;
+	return get_node(rib, node->parent->right) == node;
 }
 
 /*
@@ -89,31 +106,52 @@ get_dir(const uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE], uint8_t depth)
 	return (ip[i] & msk) != 0;
 }
 
-static inline struct rte_rib6_node *
-get_nxt_node(struct rte_rib6_node *node,
+static inline uint32_t
+get_nxt_idx(struct rte_rib6_node *node,
 	const uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE])
 {
 	return (get_dir(ip, node->depth)) ? node->right : node->left;
 }
 
-static struct rte_rib6_node *
-node_alloc(struct rte_rib6 *rib)
+static inline struct rte_rib6_node *
+get_nxt_node(const struct rte_rib6 *rib, struct rte_rib6_node *node,
+	const uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE])
 {
-	struct rte_rib6_node *ent;
-	int ret;
+	return get_node(rib, get_nxt_idx(node, ip));
+}
 
-	ret = rte_mempool_get(rib->node_pool, (void *)&ent);
-	if (unlikely(ret != 0))
-		return NULL;
+static uint32_t
+node_alloc(struct rte_rib6 *rib)
+{
+	uint32_t idx;
+
+	if (rib->free_head != RIB6_NODE_NONE) {
+		idx = rib->free_head;
+		rib->free_head = get_node(rib, idx)->left;
+	} else if (rib->next_new <= (uint32_t)rib->max_nodes)
+		idx = rib->next_new++;
+	else
+		return RIB6_NODE_NONE;
 	++rib->cur_nodes;
-	return ent;
+	return idx;
 }
 
 static void
-node_free(struct rte_rib6 *rib, struct rte_rib6_node *ent)
+node_free(struct rte_rib6 *rib, uint32_t idx)
 {
 	--rib->cur_nodes;
-	rte_mempool_put(rib->node_pool, ent);
+	get_node(rib, idx)->left = rib->free_head;
+	rib->free_head = idx;
+}
+
+/* Index of a node linked in the tree */
+static inline uint32_t
+node_idx(const struct rte_rib6 *rib, struct rte_rib6_node *node)
+{
+	if (node->parent == NULL)
+		return rib->tree;
+	return is_right_node(rib, node) ? node->parent->right :
+		node->parent->left;
 }
 
 struct rte_rib6_node *
@@ -127,12 +165,12 @@ rte_rib6_lookup(struct rte_rib6 *rib,
 		rte_errno = EINVAL;
 		return NULL;
 	}
-	cur = rib->tree;
+	cur = get_node(rib, rib->tree);
 
 	while ((cur != NULL) && is_covered(ip, cur->ip, cur->depth)) {
 		if (is_valid_node(cur))
 			prev = cur;
-		cur = get_nxt_node(cur, ip);
+		cur = get_nxt_node(rib, cur, ip);
 	}
 	return prev;
 }
@@ -164,7 +202,7 @@ rte_rib6_lookup_exact(struct rte_rib6 *rib,
 		rte_errno = EINVAL;
 		return NULL;
 	}
-	cur = rib->tree;
+	cur = get_node(rib, rib->tree);
 
 	for (i = 0; i < RTE_RIB6_IPV6_ADDR_SIZE; i++)
 		tmp_ip[i] = ip[i] & get_msk_part(depth, i);
@@ -179,7 +217,7 @@ rte_rib6_lookup_exact(struct rte_rib6 *rib,
 				(cur->depth >= depth))
 			break;
 
-		cur = get_nxt_node(cur, tmp_ip);
+		cur = get_nxt_node(rib, cur, tmp_ip);
 	}
 
 	return NULL;
@@ -208,20 +246,21 @@ rte_rib6_get_nxt(struct rte_rib6 *rib,
 		tmp_ip[i] = ip[i] & get_msk_part(depth, i);
 
 	if (last == NULL) {
-		tmp = rib->tree;
+		tmp = get_node(rib, rib->tree);
 		while ((tmp) && (tmp->depth < depth))
-			tmp = get_nxt_node(tmp, tmp_ip);
+			tmp = get_nxt_node(rib, tmp, tmp_ip);
 	} else {
 		tmp = last;
-		while ((tmp->parent != NULL) && (is_right_node(tmp) ||
-				(tmp->parent->right == NULL))) {
+		while ((tmp->parent != NULL) && (is_right_node(rib, tmp) ||
+				(tmp->parent->right == RIB6_NODE_NONE))) {
 			tmp = tmp->parent;
 			if (is_valid_node(tmp) &&
 					(is_covered(tmp->ip, tmp_ip, depth) &&
 					(tmp->depth > depth)))
 				return tmp;
 		}
-		tmp = (tmp->parent != NULL) ? tmp->parent->right : NULL;
+		tmp = (tmp->parent != NULL) ?
+			get_node(rib, tmp->parent->right) : NULL;
 	}
 	while (tmp) {
 		if (is_valid_node(tmp) &&
@@ -231,7 +270,8 @@ rte_rib6_get_nxt(struct rte_rib6 *rib,
 			if (flag == RTE_RIB6_GET_NXT_COVER)
 				return prev;
 		}
-		tmp = (tmp->left != NULL) ? tmp->left : tmp->right;
+		tmp = get_node(rib, (tmp->left != RIB6_NODE_NONE) ?
+			tmp->left : tmp->right);
 	}
 	return prev;
 }
@@ -240,7 +280,8 @@ void
 rte_rib6_remove(struct rte_rib6 *rib,
 	const uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE], uint8_t depth)
 {
-	struct rte_rib6_node *cur, *prev, *child;
+	struct rte_rib6_node *cur, *child;
+	uint32_t cur_idx, child_idx;
 
 	cur = rte_rib6_lookup_exact(rib, ip, depth);
 	if (cur == NULL)
@@ -249,105 +290,107 @@ rte_rib6_remove(struct rte_rib6 *rib,
 	--rib->cur_routes;
 	cur->flag &= ~RTE_RIB_VALID_NODE;
 	while (!is_valid_node(cur)) {
-		if ((cur->left != NULL) && (cur->right != NULL))
+		if ((cur->left != RIB6_NODE_NONE) &&
+				(cur->right != RIB6_NODE_NONE))
 			return;
-		child = (cur->left == NULL) ? cur->right : cur->left;
+		cur_idx = node_idx(rib, cur);
+		child_idx = (cur->left == RIB6_NODE_NONE) ? cur->right :
+			cur->left;
+		child = get_node(rib, child_idx);
 		if (child != NULL)
 			child->parent = cur->parent;
 		if (cur->parent == NULL) {
-			rib->tree = child;
-			node_free(rib, cur);
+			rib->tree = child_idx;
+			node_free(rib, cur_idx);
 			return;
 		}
-		if (cur->parent->left == cur)
-			cur->parent->left = child;
+		if (cur->parent->left == cur_idx)
+			cur->parent->left = child_idx;
 		else
-			cur->parent->right = child;
-		prev = cur;
+			cur->parent->right = child_idx;
 		cur = cur->parent;
-		node_free(rib, prev);
+		node_free(rib, cur_idx);
 	}
 }
 
-struct rte_rib6_node *
-rte_rib6_insert(struct rte_rib6 *rib,
-	const uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE], uint8_t depth)
+/*
+ * Insert a masked prefix, searching from the start node which covers it
+ * with a shorter depth, or from the root if start is NULL.
+ * If the route already exists, it is returned and *exist is set.
+ */
+static struct rte_rib6_node *
+rib6_insert(struct rte_rib6 *rib, struct rte_rib6_node *start,
+	uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE], uint8_t depth, bool *exist)
 {
-	struct rte_rib6_node **tmp;
-	struct rte_rib6_node *prev = NULL;
+	uint32_t *tmp;
+	struct rte_rib6_node *cur;
+	struct rte_rib6_node *prev = start;
 	struct rte_rib6_node *new_node = NULL;
 	struct rte_rib6_node *common_node = NULL;
 	uint8_t common_prefix[RTE_RIB6_IPV6_ADDR_SIZE];
-	uint8_t tmp_ip[RTE_RIB6_IPV6_ADDR_SIZE];
+	uint32_t new_idx, common_idx;
 	int i, d;
 	uint8_t common_depth, ip_xor;
 
-	if (unlikely((rib == NULL) || (ip == NULL) ||
-			(depth > RIB6_MAXDEPTH))) {
-		rte_errno = EINVAL;
-		return NULL;
-	}
+	*exist = false;
+	if (start == NULL)
+		tmp = &rib->tree;
+	else
+		tmp = (get_dir(ip, start->depth)) ? &start->right :
+			&start->left;
 
-	tmp = &rib->tree;
+	/* traverse down the tree to find matching node or closest matching */
+	while (1) {
+		cur = get_node(rib, *tmp);
+		/* insert as the last node in the branch */
+		if (cur == NULL)
+			break;
+		/*
+		 * Node with proper search criteria is found. Either it is
+		 * the route, or an intermediate node to validate.
+		 */
+		if (rte_rib6_is_equal(ip, cur->ip) && (depth == cur->depth)) {
+			if (is_valid_node(cur)) {
+				*exist = true;
+				return cur;
+			}
+			cur->flag |= RTE_RIB_VALID_NODE;
+			++rib->cur_routes;
+			return cur;
+		}
 
-	for (i = 0; i < RTE_RIB6_IPV6_ADDR_SIZE; i++)
-		tmp_ip[i] = ip[i] & get_msk_part(depth, i);
+		if (!is_covered(ip, cur->ip, cur->depth) ||
+				(cur->depth >= depth))
+			break;
+		prev = cur;
 
-	new_node = rte_rib6_lookup_exact(rib, tmp_ip, depth);
-	if (new_node != NULL) {
-		rte_errno = EEXIST;
-		return NULL;
+		tmp = (get_dir(ip, cur->depth)) ? &cur->right : &cur->left;
 	}
 
-	new_node = node_alloc(rib);
-	if (new_node == NULL) {
+	new_idx = node_alloc(rib);
+	if (new_idx == RIB6_NODE_NONE) {
 		rte_errno = ENOMEM;
 		return NULL;
 	}
-	new_node->left = NULL;
-	new_node->right = NULL;
+	new_node = get_node(rib, new_idx);
+	new_node->left = RIB6_NODE_NONE;
+	new_node->right = RIB6_NODE_NONE;
 	new_node->parent = NULL;
-	rte_rib6_copy_addr(new_node->ip, tmp_ip);
+	rte_rib6_copy_addr(new_node->ip, ip);
 	new_node->depth = depth;
 	new_node->flag = RTE_RIB_VALID_NODE;
 
-	/* traverse down the tree to find matching node or closest matching */
-	while (1) {
-		/* insert as the last node in the branch */
-		if (*tmp == NULL) {
-			*tmp = new_node;
-			new_node->parent = prev;
-			++rib->cur_routes;
-			return *tmp;
-		}
-		/*
-		 * Intermediate node found.
-		 * Previous rte_rib6_lookup_exact() returned NULL
-		 * but node with proper search criteria is found.
-		 * Validate intermediate node and return.
-		 */
-		if (rte_rib6_is_equal(tmp_ip, (*tmp)->ip) &&
-				(depth == (*tmp)->depth)) {
-			node_free(rib, new_node);
-			(*tmp)->flag |= RTE_RIB_VALID_NODE;
-			++rib->cur_routes;
-			return *tmp;
-		}
-
-		if (!is_covered(tmp_ip, (*tmp)->ip, (*tmp)->depth) ||
-				((*tmp)->depth >= depth)) {
-			break;
-		}
-		prev = *tmp;
-
-		tmp = (get_dir(tmp_ip, (*tmp)->depth)) ? &(*tmp)->right :
-				&(*tmp)->left;
+	if (cur == NULL) {
+		*tmp = new_idx;
+		new_node->parent = prev;
+		++rib->cur_routes;
+		return new_node;
 	}
 
 	/* closest node found, new_node should be inserted in the middle */
-	common_depth = RTE_MIN(depth, (*tmp)->depth);
+	common_depth = RTE_MIN(depth, cur->depth);
 	for (i = 0, d = 0; i < RTE_RIB6_IPV6_ADDR_SIZE; i++) {
-		ip_xor = tmp_ip[i] ^ (*tmp)->ip[i];
+		ip_xor = ip[i] ^ cur->ip[i];
 		if (ip_xor == 0)
 			d += 8;
 		else {
@@ -359,45 +402,195 @@ rte_rib6_insert(struct rte_rib6 *rib,
 	common_depth = RTE_MIN(d, common_depth);
 
 	for (i = 0; i < RTE_RIB6_IPV6_ADDR_SIZE; i++)
-		common_prefix[i] = tmp_ip[i] & get_msk_part(common_depth, i);
+		common_prefix[i] = ip[i] & get_msk_part(common_depth, i);
 
-	if (rte_rib6_is_equal(common_prefix, tmp_ip) &&
+	if (rte_rib6_is_equal(common_prefix, ip) &&
 			(common_depth == depth)) {
 		/* insert as a parent */
-		if (get_dir((*tmp)->ip, depth))
+		if (get_dir(cur->ip, depth))
 			new_node->right = *tmp;
 		else
 			new_node->left = *tmp;
-		new_node->parent = (*tmp)->parent;
-		(*tmp)->parent = new_node;
-		*tmp = new_node;
+		new_node->parent = cur->parent;
+		cur->parent = new_node;
+		*tmp = new_idx;
 	} else {
 		/* create intermediate node */
-		common_node = node_alloc(rib);
-		if (common_node == NULL) {
-			node_free(rib, new_node);
+		common_idx = node_alloc(rib);
+		if (common_idx == RIB6_NODE_NONE) {
+			node_free(rib, new_idx);
 			rte_errno = ENOMEM;
 			return NULL;
 		}
+		common_node = get_node(rib, common_idx);
 		rte_rib6_copy_addr(common_node->ip, common_prefix);
 		common_node->depth = common_depth;
 		common_node->flag = 0;
-		common_node->parent = (*tmp)->parent;
+		common_node->parent = cur->parent;
 		new_node->parent = common_node;
-		(*tmp)->parent = common_node;
-		if (get_dir((*tmp)->ip, common_depth) == 1) {
-			common_node->left = new_node;
+		cur->parent = common_node;
+		if (get_dir(cur->ip, common_depth) == 1) {
+			common_node->left = new_idx;
 			common_node->right = *tmp;
 		} else {
 			common_node->left = *tmp;
-			common_node->right = new_node;
+			common_node->right = new_idx;
 		}
-		*tmp = common_node;
+		*tmp = common_idx;
 	}
 	++rib->cur_routes;
 	return new_node;
 }
 
+struct rte_rib6_node *
+rte_rib6_insert(struct rte_rib6 *rib,
+	const uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE], uint8_t depth)
+{
+	struct rte_rib6_node *node;
+	uint8_t tmp_ip[RTE_RIB6_IPV6_ADDR_SIZE];
+	bool exist;
+	int i;
+
+	if (unlikely((rib == NULL) || (ip == NULL) ||
+			(depth > RIB6_MAXDEPTH))) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	for (i = 0; i < RTE_RIB6_IPV6_ADDR_SIZE; i++)
+		tmp_ip[i] = ip[i] & get_msk_part(depth, i);
+
+	node = rib6_insert(rib, NULL, tmp_ip, depth, &exist);
+	if (exist) {
+		rte_errno = EEXIST;
+		return NULL;
+	}
+	return node;
+}
+
+int
+rte_rib6_insert_bulk(struct rte_rib6 *rib,
+	const uint8_t ips[][RTE_RIB6_IPV6_ADDR_SIZE], const uint8_t *depths,
+	const uint64_t *nhs, unsigned int n)
+{
+	struct rte_rib6_node *start, *node = NULL;
+	uint8_t tmp_ip[RTE_RIB6_IPV6_ADDR_SIZE];
+	unsigned int i;
+	bool exist;
+	int j;
+
+	if ((rib == NULL) || (ips == NULL) || (depths == NULL) ||
+			(nhs == NULL)) {
+		rte_errno = EINVAL;
+		return -EINVAL;
+	}
+
+	for (i = 0; i < n; i++) {
+		if (depths[i] > RIB6_MAXDEPTH) {
+			rte_errno = EINVAL;
+			return i;
+		}
+		for (j = 0; j < RTE_RIB6_IPV6_ADDR_SIZE; j++)
+			tmp_ip[j] = ips[i][j] & get_msk_part(depths[i], j);
+
+		/*
+		 * Sorted routes are close in the tree, so the search starts
+		 * from the closest ancestor of the previous route covering
+		 * this one.
+		 */
+		start = node;
+		while ((start != NULL) && ((start->depth >= depths[i]) ||
+				!is_covered(tmp_ip, start->ip, start->depth)))
+			start = start->parent;
+
+		node = rib6_insert(rib, start, tmp_ip, depths[i], &exist);
+		if (node == NULL)
+			return i;
+		node->nh = nhs[i];
+	}
+	return n;
+}
+
+int
+rte_rib6_walk_init(struct rte_rib6 *rib, struct rte_rib6_walk *walk,
+	const uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE], uint8_t depth)
+{
+	struct rte_rib6_node *tmp;
+	uint32_t idx;
+	int i;
+
+	if ((rib == NULL) || (walk == NULL) || (ip == NULL) ||
+			(depth > RIB6_MAXDEPTH)) {
+		rte_errno = EINVAL;
+		return -1;
+	}
+
+	for (i = 0; i < RTE_RIB6_IPV6_ADDR_SIZE; i++)
+		walk->ip[i] = ip[i] & get_msk_part(depth, i);
+
+	idx = rib->tree;
+	tmp = get_node(rib, idx);
+	while ((tmp != NULL) && (tmp->depth < depth)) {
+		idx = get_nxt_idx(tmp, walk->ip);
+		tmp = get_node(rib, idx);
+	}
+	/* the subtree of the first node deep enough holds all the routes */
+	if ((tmp == NULL) || !is_covered(tmp->ip, walk->ip, depth))
+		idx = RIB6_NODE_NONE;
+
+	walk->depth = depth;
+	walk->root = idx;
+	walk->next = idx;
+	return 0;
+}
+
+int
+rte_rib6_walk_bulk(struct rte_rib6 *rib, struct rte_rib6_walk *walk,
+	uint8_t ips[][RTE_RIB6_IPV6_ADDR_SIZE], uint8_t *depths, uint64_t *nhs,
+	unsigned int n)
+{
+	struct rte_rib6_node *node, *root;
+	unsigned int i = 0;
+	uint32_t idx;
+
+	if ((rib == NULL) || (walk == NULL) || (ips == NULL) ||
+			(depths == NULL) || (nhs == NULL)) {
+		rte_errno = EINVAL;
+		return -1;
+	}
+
+	root = get_node(rib, walk->root);
+	idx = walk->next;
+	while ((idx != RIB6_NODE_NONE) && (i < n)) {
+		node = get_node(rib, idx);
+		if (is_valid_node(node)) {
+			rte_rib6_copy_addr(ips[i], node->ip);
+			depths[i] = node->depth;
+			nhs[i] = node->nh;
+			i++;
+		}
+
+		/* next node in prefix order */
+		if (node->left != RIB6_NODE_NONE)
+			idx = node->left;
+		else if (node->right != RIB6_NODE_NONE)
+			idx = node->right;
+		else {
+			idx = RIB6_NODE_NONE;
+			while (node != root) {
+				if ((node->parent->right != RIB6_NODE_NONE) &&
+						!is_right_node(rib, node)) {
+					idx = node->parent->right;
+					break;
+				}
+				node = node->parent;
+			}
+		}
+	}
+	walk->next = idx;
+	return i;
+}
+
 int
 rte_rib6_get_ip(struct rte_rib6_node *node, uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE])
 {
@@ -455,23 +648,27 @@ rte_rib6_create(const char *name, int socket_id, struct rte_rib6_conf *conf)
 	struct rte_rib6 *rib = NULL;
 	struct rte_tailq_entry *te;
 	struct rte_rib6_list *rib6_list;
-	struct rte_mempool *node_pool;
+	uint8_t *nodes;
+	size_t node_sz;
 
 	/* Check user arguments. */
 	if ((name == NULL) || (conf == NULL) ||
-			(conf->max_nodes == 0)) {
+			(socket_id < SOCKET_ID_ANY) || (conf->max_nodes <= 0)) {
 		rte_errno = EINVAL;
 		return NULL;
 	}
 
-	snprintf(mem_name, sizeof(mem_name), "MP_%s", name);
-	node_pool = rte_mempool_create(mem_name, conf->max_nodes,
-		sizeof(struct rte_rib6_node) + conf->ext_sz, 0, 0,
-		NULL, NULL, NULL, NULL, socket_id, 0);
+	node_sz = RTE_ALIGN_CEIL(sizeof(struct rte_rib6_node) + conf->ext_sz,
+		sizeof(uint64_t));
+	snprintf(mem_name, sizeof(mem_name), "RIB6N_%s", name);
+	nodes = rte_malloc_socket(mem_name,
+		node_sz * ((size_t)conf->max_nodes + 1), RTE_CACHE_LINE_SIZE,
+		socket_id);
 
-	if (node_pool == NULL) {
+	if (nodes == NULL) {
 		RTE_LOG(ERR, LPM,
-			"Can not allocate mempool for RIB6 %s\n", name);
+			"Can not allocate nodes for RIB6 %s\n", name);
+		rte_errno = ENOMEM;
 		return NULL;
 	}
 
@@ -511,9 +708,12 @@ rte_rib6_create(const char *name, int socket_id, struct rte_rib6_conf *conf)
 	}
 
 	rte_strlcpy(rib->name, name, sizeof(rib->name));
-	rib->tree = NULL;
+	rib->tree = RIB6_NODE_NONE;
 	rib->max_nodes = conf->max_nodes;
-	rib->node_pool = node_pool;
+	rib->nodes = nodes;
+	rib->node_sz = node_sz;
+	rib->free_head = RIB6_NODE_NONE;
+	rib->next_new = 1;
 
 	te->data = (void *)rib;
 	TAILQ_INSERT_TAIL(rib6_list, te, next);
@@ -526,7 +726,7 @@ rte_rib6_create(const char *name, int socket_id, struct rte_rib6_conf *conf)
 	rte_free(te);
 exit:
 	rte_mcfg_tailq_write_unlock();
-	rte_mempool_free(node_pool);
+	rte_free(nodes);
 
 	return NULL;
 }
@@ -566,7 +766,6 @@ rte_rib6_free(struct rte_rib6 *rib)
 {
 	struct rte_tailq_entry *te;
 	struct rte_rib6_list *rib6_list;
-	struct rte_rib6_node *tmp = NULL;
 
 	if (unlikely(rib == NULL)) {
 		rte_errno = EINVAL;
@@ -587,12 +786,7 @@ rte_rib6_free(struct rte_rib6 *rib)
 
 	rte_mcfg_tailq_write_unlock();
 
-	while ((tmp = rte_rib6_get_nxt(rib, 0, 0, tmp,
-			RTE_RIB6_GET_NXT_ALL)) != NULL)
-		rte_rib6_remove(rib, tmp->ip, tmp->depth);
-
-	rte_mempool_free(rib->node_pool);
-
+	rte_free(rib->nodes);
 	rte_free(rib);
 	rte_free(te);
 }
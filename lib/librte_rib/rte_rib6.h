@@ -41,6 +41,18 @@ struct rte_rib6_conf {
 	int	max_nodes;
 };
 
+/**
+ * State of a walk over the routes of a subtree of the RIB,
+ * see rte_rib6_walk_init(). Its fields are private.
+ */
+struct rte_rib6_walk {
+	uint8_t		ip[RTE_RIB6_IPV6_ADDR_SIZE];
+	/**< Prefix covering the walked routes */
+	uint8_t		depth;	/**< Length of the covering prefix */
+	uint32_t	root;	/**< Subtree of the walk */
+	uint32_t	next;	/**< Next node to visit */
+};
+
 /**
  * Copy IPv6 address from one location to another
  *
@@ -214,6 +226,80 @@ struct rte_rib6_node *
 rte_rib6_insert(struct rte_rib6 *rib,
 	const uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE], uint8_t depth);
 
+/**
+ * Insert a list of routes into the RIB, or update the next hop of the
+ * routes already in it. The search for the position of a route starts
+ * from the previous one, so routes sorted by prefix are inserted faster.
+ *
+ * @param rib
+ *  RIB object handle
+ * @param ips
+ *  nets to be inserted to the RIB
+ * @param depths
+ *  prefix lengths
+ * @param nhs
+ *  next hops of the routes
+ * @param n
+ *  number of routes
+ * @return
+ *  number of routes inserted, if less than n, rte_errno indicates the
+ *  reason why the next one failed.
+ *  -EINVAL, with rte_errno set to EINVAL, if rib, ips, depths or nhs
+ *  is NULL.
+ */
+__rte_experimental
+int
+rte_rib6_insert_bulk(struct rte_rib6 *rib,
+	const uint8_t ips[][RTE_RIB6_IPV6_ADDR_SIZE], const uint8_t *depths,
+	const uint64_t *nhs, unsigned int n);
+
+/**
+ * Start a walk over the routes covered by a prefix, in prefix order.
+ * Unlike rte_rib6_get_nxt(), the prefix itself is part of the walk.
+ * The RIB must not be modified until the walk is over.
+ *
+ * @param rib
+ *  RIB object handle
+ * @param walk
+ *  walk state to initialize
+ * @param ip
+ *  net address of the prefix covering the routes to walk
+ * @param depth
+ *  prefix length, 0 to walk the whole RIB
+ * @return
+ *  0 on success
+ *  -1 on failure with rte_errno indicating reason for failure.
+ */
+__rte_experimental
+int
+rte_rib6_walk_init(struct rte_rib6 *rib, struct rte_rib6_walk *walk,
+	const uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE], uint8_t depth);
+
+/**
+ * Retrieve the next routes of a walk.
+ *
+ * @param rib
+ *  RIB object handle
+ * @param walk
+ *  walk state set by rte_rib6_walk_init()
+ * @param ips
+ *  array to store the nets of the routes
+ * @param depths
+ *  array to store the prefix lengths of the routes
+ * @param nhs
+ *  array to store the next hops of the routes
+ * @param n
+ *  size of the arrays
+ * @return
+ *  number of routes retrieved, 0 when the walk is over
+ *  -1 on failure with rte_errno indicating reason for failure.
+ */
+__rte_experimental
+int
+rte_rib6_walk_bulk(struct rte_rib6 *rib, struct rte_rib6_walk *walk,
+	uint8_t ips[][RTE_RIB6_IPV6_ADDR_SIZE], uint8_t *depths, uint64_t *nhs,
+	unsigned int n);
+
 /**
  * Get an ip from rte_rib6_node
  *
@@ -11,8 +11,10 @@
 
 #include <rte_eal.h>
 #include <rte_ethdev.h>
+#include <rte_lcore.h>
 #include <rte_metrics.h>
 #include <rte_option.h>
+#include <rte_service.h>
 #include <rte_string_fns.h>
 
 #include "rte_telemetry.h"
@@ -581,6 +583,170 @@ rte_telemetry_send_global_stats_values(struct telemetry_encode_param *ep,
 	return -1;
 }
 
+static void
+rte_telemetry_mempool_cache_metrics(struct rte_mempool *mp, void *arg)
+{
+	static const char * const stat_names[] = {
+		"cache_get_hits", "cache_get_misses",
+		"cache_put_hits", "cache_put_misses"
+	};
+	struct telemetry_impl *telemetry = arg;
+	struct rte_mempool_cache_stats stats;
+	char names[RTE_DIM(stat_names)][RTE_METRICS_MAX_NAME_LEN];
+	const char *name_ptrs[RTE_DIM(stat_names)];
+	uint64_t values[RTE_DIM(stat_names)] = {0};
+	unsigned int lcore_id;
+	int i, reg_index = -1;
+
+	if (mp->cache_size == 0)
+		return;
+
+	RTE_LCORE_FOREACH(lcore_id) {
+		if (rte_mempool_cache_stats_get(mp, lcore_id, &stats) != 0)
+			continue;
+		values[0] += stats.get_hits;
+		values[1] += stats.get_misses;
+		values[2] += stats.put_hits;
+		values[3] += stats.put_misses;
+	}
+
+	for (i = 0; i < telemetry->nb_mempool_reg; i++) {
+		if (strcmp(telemetry->mempool_reg[i].name, mp->name) == 0) {
+			reg_index = telemetry->mempool_reg[i].reg_index;
+			break;
+		}
+	}
+
+	if (reg_index < 0) {
+		if (telemetry->nb_mempool_reg == MAX_MEMPOOLS)
+			return;
+		for (i = 0; i < (int)RTE_DIM(stat_names); i++) {
+			snprintf(names[i], sizeof(names[i]), "%s_%s",
+				mp->name, stat_names[i]);
+			name_ptrs[i] = names[i];
+		}
+		reg_index = rte_metrics_reg_names(name_ptrs,
+			RTE_DIM(stat_names));
+		if (reg_index < 0) {
+			TELEMETRY_LOG_ERR("Could not register %s cache metrics",
+				mp->name);
+			return;
+		}
+		i = telemetry->nb_mempool_reg++;
+		strlcpy(telemetry->mempool_reg[i].name, mp->name,
+			sizeof(telemetry->mempool_reg[i].name));
+		telemetry->mempool_reg[i].reg_index = reg_index;
+	}
+
+	if (rte_metrics_update_values(RTE_METRICS_GLOBAL, reg_index, values,
+			RTE_DIM(stat_names)) < 0)
+		TELEMETRY_LOG_ERR("Could not update %s cache metrics",
+			mp->name);
+}
+
+void
+rte_telemetry_update_metrics_mempool(struct telemetry_impl *telemetry)
+{
+	rte_mempool_walk(rte_telemetry_mempool_cache_metrics, telemetry);
+}
+
+void
+rte_telemetry_update_metrics_eal(struct telemetry_impl *telemetry)
+{
+	static const char * const stat_names[] = {
+		"eal_init_time_us", "eal_mem_init_time_us",
+		"eal_mem_init_pages", "eal_mem_init_threads"
+	};
+	struct rte_eal_init_stats stats;
+	uint64_t values[RTE_DIM(stat_names)];
+	int reg_index;
+
+	/* the statistics do not change once the init is complete */
+	if (telemetry->eal_metrics_done)
+		return;
+	if (rte_eal_init_stats_get(&stats) != 0 || stats.init_time_us == 0)
+		return;
+
+	reg_index = rte_metrics_reg_names(stat_names, RTE_DIM(stat_names));
+	if (reg_index < 0) {
+		TELEMETRY_LOG_ERR("Could not register EAL init metrics");
+		return;
+	}
+
+	values[0] = stats.init_time_us;
+	values[1] = stats.mem_init_time_us;
+	values[2] = stats.mem_init_pages;
+	values[3] = stats.mem_init_threads;
+	if (rte_metrics_update_values(RTE_METRICS_GLOBAL, reg_index, values,
+			RTE_DIM(stat_names)) < 0)
+		TELEMETRY_LOG_ERR("Could not update EAL init metrics");
+
+	telemetry->eal_metrics_done = 1;
+}
+
+void
+rte_telemetry_update_metrics_lcore(struct telemetry_impl *telemetry)
+{
+	/* aggregated, the metrics library only has room for 256 names */
+	static const char * const stat_names[] = {
+		"lcore_busy_percent_avg", "lcore_busy_percent_max",
+		"lcore_busy_cycles", "lcore_idle_cycles",
+		"service_calls", "service_cycles"
+	};
+	uint64_t values[RTE_DIM(stat_names)] = {0};
+	struct rte_lcore_busyness_stats stats;
+	unsigned int lcore_id, nb_lcores = 0;
+	uint32_t id, nb_services;
+	uint64_t calls, cycles;
+	int busy;
+
+	if (!telemetry->lcore_metrics_done) {
+		telemetry->lcore_reg_index = rte_metrics_reg_names(stat_names,
+			RTE_DIM(stat_names));
+		if (telemetry->lcore_reg_index < 0)
+			TELEMETRY_LOG_ERR("Could not register lcore metrics");
+		telemetry->lcore_metrics_done = 1;
+	}
+	if (telemetry->lcore_reg_index < 0)
+		return;
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		if (rte_eal_lcore_role(lcore_id) == ROLE_OFF)
+			continue;
+		memset(&stats, 0, sizeof(stats));
+		rte_lcore_busyness_stats_get(lcore_id, &stats);
+		busy = rte_lcore_busyness(lcore_id);
+		if (busy < 0)
+			busy = 0;
+		values[0] += busy;
+		values[1] = RTE_MAX(values[1], (uint64_t)busy);
+		values[2] += stats.busy_cycles;
+		values[3] += stats.idle_cycles;
+		nb_lcores++;
+	}
+	if (nb_lcores > 0)
+		values[0] /= nb_lcores;
+
+	nb_services = rte_service_get_count();
+	for (id = 0; id < MAX_SERVICES && nb_services > 0; id++) {
+		if (rte_service_get_name(id) == NULL)
+			continue;
+		nb_services--;
+		/* only counted when the statistics of the service are enabled */
+		calls = 0;
+		cycles = 0;
+		rte_service_attr_get(id, RTE_SERVICE_ATTR_CALL_COUNT, &calls);
+		rte_service_attr_get(id, RTE_SERVICE_ATTR_CYCLES, &cycles);
+		values[4] += calls;
+		values[5] += cycles;
+	}
+
+	if (rte_metrics_update_values(RTE_METRICS_GLOBAL,
+			telemetry->lcore_reg_index, values,
+			RTE_DIM(stat_names)) < 0)
+		TELEMETRY_LOG_ERR("Could not update lcore metrics");
+}
+
 int32_t
 rte_telemetry_send_ports_stats_values(struct telemetry_encode_param *ep,
 	struct telemetry_impl *telemetry)
@@ -3,6 +3,7 @@
  */
 
 #include <rte_log.h>
+#include <rte_mempool.h>
 #include <rte_tailq.h>
 
 #ifndef _RTE_TELEMETRY_INTERNAL_H_
@@ -25,6 +26,8 @@ extern int telemetry_log_level;
 	TELEMETRY_LOG(INFO, fmt, ## args)
 
 #define MAX_METRICS 256
+#define MAX_MEMPOOLS 32
+#define MAX_SERVICES 64
 
 typedef struct telemetry_client {
 	char *file_path;
@@ -40,6 +43,17 @@ typedef struct telemetry_impl {
 	uint32_t socket_id;
 	int reg_index[RTE_MAX_ETHPORTS];
 	int metrics_register_done;
+	/* Mempools with cache statistics registered as global metrics */
+	struct {
+		char name[RTE_MEMPOOL_NAMESIZE];
+		int reg_index;
+	} mempool_reg[MAX_MEMPOOLS];
+	int nb_mempool_reg;
+	/* EAL init statistics registered as global metrics */
+	int eal_metrics_done;
+	/* Lcore busyness and services registered as global metrics */
+	int lcore_metrics_done;
+	int lcore_reg_index;
 	TAILQ_HEAD(, telemetry_client) client_list_head;
 	struct telemetry_client *request_client;
 	int register_fail_count;
@@ -106,6 +120,28 @@ int32_t
 rte_telemetry_send_global_stats_values(struct telemetry_encode_param *ep,
 	struct telemetry_impl *telemetry);
 
+/**
+ * Update the global metrics with the cache statistics of the mempools,
+ * summed over the lcores, registering them on first use.
+ */
+void
+rte_telemetry_update_metrics_mempool(struct telemetry_impl *telemetry);
+
+/**
+ * Register the EAL init statistics as global metrics, once the EAL
+ * initialization is complete.
+ */
+void
+rte_telemetry_update_metrics_eal(struct telemetry_impl *telemetry);
+
+/**
+ * Update the global metrics with the busyness of the lcores and the
+ * statistics of the services, aggregated over all of them, registering
+ * them on first use.
+ */
+void
+rte_telemetry_update_metrics_lcore(struct telemetry_impl *telemetry);
+
 int32_t
 rte_telemetry_parser_test(struct telemetry_impl *telemetry);
 
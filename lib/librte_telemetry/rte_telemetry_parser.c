@@ -386,6 +386,10 @@ rte_telemetry_command_global_stat_values(struct telemetry_impl *telemetry,
 		return -1;
 	}
 
+	rte_telemetry_update_metrics_mempool(telemetry);
+	rte_telemetry_update_metrics_eal(telemetry);
+	rte_telemetry_update_metrics_lcore(telemetry);
+
 	num_metrics = rte_metrics_get_values(RTE_METRICS_GLOBAL, NULL, 0);
 	if (num_metrics < 0) {
 		TELEMETRY_LOG_ERR("Cannot get metrics count");
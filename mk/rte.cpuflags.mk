@@ -72,6 +72,15 @@ endif
 ifneq ($(filter $(AUTO_CPUFLAGS),__AVX512F__),)
 ifeq ($(CONFIG_RTE_ENABLE_AVX512),y)
 CPUFLAGS += AVX512F
+ifneq ($(filter $(AUTO_CPUFLAGS),__AVX512BW__),)
+CPUFLAGS += AVX512BW
+endif
+ifneq ($(filter $(AUTO_CPUFLAGS),__AVX512VBMI__),)
+CPUFLAGS += AVX512VBMI
+endif
+ifneq ($(filter $(AUTO_CPUFLAGS),__GFNI__),)
+CPUFLAGS += GFNI
+endif
 else
 # disable AVX512F support for GCC & binutils 2.30 as a workaround for Bug 97
 ifeq ($(FORCE_DISABLE_AVX512),y)